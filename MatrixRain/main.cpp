@@ -5,6 +5,7 @@
 #include "..\MatrixRainCore\WindowsRegistryProvider.h"
 #include "..\MatrixRainCore\WindowsFileSystemProvider.h"
 #include "..\MatrixRainCore\CommandLine.h"
+#include "..\MatrixRainCore\HeadlessRecorder.h"
 #include "..\MatrixRainCore\UsageText.h"
 #include "ConfigDialog.h"
 
@@ -117,6 +118,37 @@ int APIENTRY wWinMain(_In_     HINSTANCE hInstance,
         goto Error;
     }
 
+    // Handle headless recording — renders to a file without a window or GPU
+    if (context.m_mode == ScreenSaverMode::Record)
+    {
+        HeadlessRecordStats stats;
+
+        hr = HeadlessRecorder::Record (context.m_record, stats);
+
+        if (FAILED (hr))
+        {
+            context.m_errorMessage = std::format (L"Could not record to {} (0x{:08X})", context.m_record.outputPath, static_cast<uint32_t> (hr));
+            goto Error;
+        }
+
+        // Report to the console we were started from, if any
+        if (AttachConsole (ATTACH_PARENT_PROCESS))
+        {
+            std::wstring summary = std::format (L"\nRecorded {} frames to {}: {:.1f} fps rendering, {:.1f} fps end to end, {} stalled submits\n",
+                                                stats.framesWritten,
+                                                context.m_record.outputPath,
+                                                stats.framesWritten / std::max (stats.renderSeconds, 1e-9),
+                                                stats.framesWritten / std::max (stats.totalSeconds,  1e-9),
+                                                stats.stalledSubmits);
+            DWORD        cchWritten = 0;
+
+            WriteConsoleW (GetStdHandle (STD_OUTPUT_HANDLE), summary.c_str(), static_cast<DWORD> (summary.size()), &cchWritten, nullptr);
+            FreeConsole();
+        }
+
+        goto Error;
+    }
+
     // Handle help request — runs through Application in HelpRequested mode
     // (no longer uses UsageDialog — overlay renders via GPU pipeline)
 
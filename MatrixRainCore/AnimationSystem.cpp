@@ -1,7 +1,9 @@
 #include "pch.h"
 
 #include "AnimationSystem.h"
+#include "CharacterSet.h"
 #include "DensityController.h"
+#include "UniformRandom.h"
 
 
 
@@ -143,8 +145,6 @@ void AnimationSystem::SpawnStreak()
 
 
     // Random X position across viewport width, unless callback overrides
-    std::uniform_real_distribution<float> xDist (0.0f, viewportWidth);
-
     float x;
 
     if (m_spawnPositionCallback)
@@ -152,20 +152,18 @@ void AnimationSystem::SpawnStreak()
         SpawnRange range { 0.0f, viewportWidth, -200.0f, 0.0f };
         auto       result = m_spawnPositionCallback (range);
 
-        x = result.value_or (xDist (m_generator));
+        x = result.value_or (UniformReal (m_generator, 0.0f, viewportWidth));
     }
     else
     {
-        x = xDist (m_generator);
+        x = UniformReal (m_generator, 0.0f, viewportWidth);
     }
 
     // Random Y position above viewport (between -200 and 0)
-    std::uniform_real_distribution<float> yDist (-200.0f, 0.0f);
-    float y = yDist (m_generator);
+    float y = UniformReal (m_generator, -200.0f, 0.0f);
 
     // Random Z depth (0 = near, 100 = far)
-    std::uniform_real_distribution<float> zDist (0.0f, MAX_DEPTH);
-    float z = zDist (m_generator);
+    float z = UniformReal (m_generator, 0.0f, MAX_DEPTH);
 
     Vector3 position (x, y, z);
 
@@ -195,8 +193,6 @@ void AnimationSystem::SpawnStreakInView()
 
 
     // Random X position across viewport width, unless callback overrides
-    std::uniform_real_distribution<float> xDist (0.0f, viewportWidth);
-
     float x;
 
     if (m_spawnPositionCallback)
@@ -204,20 +200,18 @@ void AnimationSystem::SpawnStreakInView()
         SpawnRange range { 0.0f, viewportWidth, 0.0f, viewportHeight };
         auto       result = m_spawnPositionCallback (range);
 
-        x = result.value_or (xDist (m_generator));
+        x = result.value_or (UniformReal (m_generator, 0.0f, viewportWidth));
     }
     else
     {
-        x = xDist (m_generator);
+        x = UniformReal (m_generator, 0.0f, viewportWidth);
     }
 
     // Random Y position WITHIN viewport (0 to height) for immediate visibility
-    std::uniform_real_distribution<float> yDist (0.0f, viewportHeight);
-    float y = yDist (m_generator);
+    float y = UniformReal (m_generator, 0.0f, viewportHeight);
 
     // Random Z depth (0 = near, 100 = far)
-    std::uniform_real_distribution<float> zDist (0.0f, MAX_DEPTH);
-    float z = zDist (m_generator);
+    float z = UniformReal (m_generator, 0.0f, MAX_DEPTH);
 
     Vector3 position (x, y, z);
 
@@ -377,6 +371,15 @@ void AnimationSystem::ClearAllStreaks()
 
 
 
+void AnimationSystem::SwapStreaks (std::vector<CharacterStreak> & streaks)
+{
+    m_streaks.swap (streaks);
+}
+
+
+
+
+
 void AnimationSystem::SetAnimationSpeed (int speedPercent)
 {
     // Store for application to newly spawned streaks
@@ -476,6 +479,26 @@ void AnimationSystem::SetOverlayCharacters (std::vector<OverlayCharacter> overla
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+//
+//  AnimationSystem::Seed
+//
+//  The three generators get distinct seeds so they don't produce the same
+//  stream.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void AnimationSystem::Seed (uint32_t seed)
+{
+    m_generator.seed (seed);
+    CharacterStreak::SeedRandom (seed ^ 0x9E3779B9u);
+    CharacterSet::SeedRandom    (seed ^ 0x85EBCA6Bu);
+}
+
+
+
+
+
 float AnimationSystem::CalculateCharacterSpacing() const
 {
     constexpr float BASE_SPACING     = 24.0f;
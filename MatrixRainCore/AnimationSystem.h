@@ -131,6 +131,15 @@ public:
     /// </summary>
     void ClearAllStreaks();
     
+    /// <summary>
+    /// Replace the active streaks with `streaks` without simulating them.
+    /// The vectors are swapped, so the caller gets the previous set back and
+    /// can refill it next frame without reallocating.  Used by a context
+    /// that renders its region of a VirtualDesktopSimulation.
+    /// </summary>
+    /// <param name="streaks">This frame's streaks; receives the previous ones</param>
+    void SwapStreaks (std::vector<CharacterStreak> & streaks);
+
     /// <summary>
     /// Update animation speed for all active streaks.
     /// </summary>
@@ -168,6 +177,15 @@ public:
     /// <param name="overlays">Vector of overlay characters to render</param>
     void SetOverlayCharacters (std::vector<OverlayCharacter> overlays);
 
+    /// <summary>
+    /// Reseed every generator the simulation draws from: spawn placement
+    /// here, plus the calling thread's streak and glyph generators.  Call
+    /// before Initialize on the thread that will run Update; with a fixed
+    /// timestep the run then replays exactly.
+    /// </summary>
+    /// <param name="seed">Seed value</param>
+    void Seed (uint32_t seed);
+
     // Accessors
     const std::vector<CharacterStreak>  & GetStreaks()            const { return m_streaks;            }
     const std::vector<OverlayCharacter> & GetOverlayCharacters()  const { return m_overlayCharacters;  }
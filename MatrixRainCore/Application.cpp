@@ -13,18 +13,21 @@
 #include "DensityController.h"
 #include "InputSystem.h"
 #include "FPSCounter.h"
+#include "FrameTrace.h"
 #include "MonitorRenderContext.h"
 #include "MonitorInfo.h"
 #include "MonitorLayout.h"
 #include "MultiMonitorGate.h"
 #include "QualityPresets.h"
 #include "RenderThreadInputs.h"
+#include "SharedRenderWorker.h"
 #include "WindowsAdapterProvider.h"
 #include "WindowsMonitorProvider.h"
 #include "AdapterSelection.h"
 #include "ScreenSaverModeContext.h"
 #include "UnicodeSymbols.h"
 #include "Version.h"
+#include "VirtualDesktopSimulation.h"
 
 
 
@@ -144,6 +147,9 @@ HRESULT Application::Initialize (HINSTANCE hInstance, int nCmdShow, const Screen
     m_monitorProvider = std::make_unique<WindowsMonitorProvider>();
     m_inputSystem     = std::make_unique<InputSystem>();
 
+    // Overlay keys wake a paused render thread so they show at once
+    m_overlays.wake = &m_sharedState.wake;
+
     // Overlays are only used in Normal mode
     if (!pScreenSaverContext || pScreenSaverContext->m_mode == ScreenSaverMode::Normal)
     {
@@ -196,6 +202,14 @@ HRESULT Application::Initialize (HINSTANCE hInstance, int nCmdShow, const Screen
 
 
     InitializeApplicationState (pScreenSaverContext);
+
+    // Frame tracing (TraceFile setting): record from the first frame, and
+    // write the trace on T and at shutdown
+    if (!m_appState->GetSettings().m_traceFile.empty())
+    {
+        FrameTrace::SetThreadName ("UI");
+        FrameTrace::Enable();
+    }
     
     hr = CreateRenderContexts();
     CHR (hr);
@@ -282,13 +296,15 @@ void Application::InitializeApplicationState (const ScreenSaverModeContext * pSc
         // Also seed SharedState so the first frame renders at the chosen
         // preset's values (the snapshot path picks up subsequent changes).
         {
-            std::lock_guard<std::mutex> lock (m_sharedState.mutex);
+            SharedState::WriteLock lock (m_sharedState);
             const ScreenSaverSettings & s = m_appState->GetSettings();
 
             m_sharedState.glowIntensityPercent   = s.m_advancedValues.m_glowIntensityPercent;
             m_sharedState.blurPasses             = s.m_advancedValues.m_blurPasses;
             m_sharedState.bloomResolutionDivisor = s.m_advancedValues.m_bloomResolutionDivisor;
             m_sharedState.blurTaps               = s.m_advancedValues.m_blurTaps;
+            m_sharedState.bloomAlgorithm         = s.m_advancedValues.m_bloomAlgorithm;
+            m_sharedState.qualityTargetFrameUs   = s.m_adaptiveQualityTargetUs;
         }
     }
     else
@@ -296,50 +312,53 @@ void Application::InitializeApplicationState (const ScreenSaverModeContext * pSc
         // Existing install: seed SharedState from the loaded advanced
         // values so the render thread renders at whatever preset/custom
         // values the user previously saved.
-        std::lock_guard<std::mutex> lock (m_sharedState.mutex);
+        SharedState::WriteLock lock (m_sharedState);
         const ScreenSaverSettings & s = m_appState->GetSettings();
 
         m_sharedState.blurPasses             = s.m_advancedValues.m_blurPasses;
         m_sharedState.bloomResolutionDivisor = s.m_advancedValues.m_bloomResolutionDivisor;
         m_sharedState.blurTaps               = s.m_advancedValues.m_blurTaps;
+        m_sharedState.bloomAlgorithm         = s.m_advancedValues.m_bloomAlgorithm;
+        m_sharedState.qualityTargetFrameUs   = s.m_adaptiveQualityTargetUs;
     }
     
     // Register for settings change notifications — write to SharedState
     m_appState->RegisterDensityChangeCallback ([this](int densityPercent) {
-        std::lock_guard<std::mutex> lock (m_sharedState.mutex);
+        SharedState::WriteLock lock (m_sharedState);
         m_sharedState.densityPercent = densityPercent;
     });
 
     m_appState->RegisterAnimationSpeedCallback ([this](int speedPercent) {
-        std::lock_guard<std::mutex> lock (m_sharedState.mutex);
+        SharedState::WriteLock lock (m_sharedState);
         m_sharedState.animationSpeedPercent = speedPercent;
     });
     
     m_appState->RegisterGlowIntensityCallback ([this](int intensityPercent) {
-        std::lock_guard<std::mutex> lock (m_sharedState.mutex);
+        SharedState::WriteLock lock (m_sharedState);
         m_sharedState.glowIntensityPercent = intensityPercent;
     });
     
     m_appState->RegisterGlowSizeCallback ([this](int sizePercent) {
-        std::lock_guard<std::mutex> lock (m_sharedState.mutex);
+        SharedState::WriteLock lock (m_sharedState);
         m_sharedState.glowSizePercent = sizePercent;
     });
 
     m_appState->RegisterAdvancedGraphicsCallback ([this](const AdvancedGraphicsValues & values) {
-        std::lock_guard<std::mutex> lock (m_sharedState.mutex);
+        SharedState::WriteLock lock (m_sharedState);
         m_sharedState.glowIntensityPercent   = values.m_glowIntensityPercent;
         m_sharedState.blurPasses             = values.m_blurPasses;
         m_sharedState.bloomResolutionDivisor = values.m_bloomResolutionDivisor;
         m_sharedState.blurTaps               = values.m_blurTaps;
+        m_sharedState.bloomAlgorithm         = values.m_bloomAlgorithm;
     });
 
     m_appState->RegisterColorSchemeCallback ([this](ColorScheme scheme) {
-        std::lock_guard<std::mutex> lock (m_sharedState.mutex);
+        SharedState::WriteLock lock (m_sharedState);
         m_sharedState.colorScheme = scheme;
     });
 
     m_appState->RegisterShowStatisticsCallback ([this](bool show) {
-        std::lock_guard<std::mutex> lock (m_sharedState.mutex);
+        SharedState::WriteLock lock (m_sharedState);
         m_sharedState.showStatistics = show;
     });
 
@@ -353,11 +372,13 @@ void Application::InitializeApplicationState (const ScreenSaverModeContext * pSc
         m_sharedState.liveScanlinesIntensity.store (settings.m_scanlinesIntensity,                             std::memory_order_relaxed);
         m_sharedState.liveScanlinesStyle    .store (settings.m_scanlinesStyle,                                 std::memory_order_relaxed);
         m_sharedState.liveCustomColor       .store (static_cast<DWORD> (settings.m_customColor),               std::memory_order_relaxed);
+        m_sharedState.wake.Notify();
     });
 
     // Initialize SharedState from saved settings
     {
-        const auto & settings = m_appState->GetSettings();
+        SharedState::WriteLock lock (m_sharedState);
+        const auto &           settings = m_appState->GetSettings();
 
         m_sharedState.densityPercent        = settings.m_densityPercent;
         m_sharedState.colorScheme           = m_appState->GetColorScheme();
@@ -543,6 +564,10 @@ Error:
 //  skipped; the primary is the first monitor flagged primary (else the first).
 //  If no usable monitors are reported, falls back to a single primary window.
 //
+//  With the SharedSimulation setting and more than one monitor, the contexts
+//  all render their region of one VirtualDesktopSimulation over the union
+//  of the placements instead of simulating their monitors separately.
+//
 ////////////////////////////////////////////////////////////////////////////////
 
 HRESULT Application::CreateFullscreenContexts()
@@ -564,6 +589,19 @@ HRESULT Application::CreateFullscreenContexts()
             hr = AddContext (placement.position, placement.size, WS_POPUP | WS_VISIBLE, nullptr, placement.isPrimary);
             CHR (hr);
         }
+
+        if (m_appState->GetSettings().m_sharedSimulation && placements.size() > 1)
+        {
+            VirtualDesktopLayout layout = PlanVirtualDesktop (placements);
+
+            m_desktopSimulation = std::make_unique<VirtualDesktopSimulation> (layout, m_primary->GetDpiScale());
+
+            // m_contexts was empty on entry, so it is in placement order
+            for (size_t i = 0; i < placements.size(); i++)
+            {
+                m_contexts[i]->BindDesktopSimulation (*m_desktopSimulation, layout.regions[i]);
+            }
+        }
     }
 
 
@@ -598,7 +636,8 @@ HRESULT Application::AddContext (const POINT & position, const SIZE & size, DWOR
     hr = CreateWindowAtBounds (position, size, dwStyle, hwndParent, hwnd);
     CHR (hr);
 
-    context = std::make_unique<MonitorRenderContext> (isPrimary);
+    // Contexts are appended once initialized, so the count is this one's index
+    context = std::make_unique<MonitorRenderContext> (isPrimary, static_cast<int> (m_contexts.size()));
 
     hr = context->Initialize (hwnd, static_cast<UINT> (size.cx), static_cast<UINT> (size.cy), m_resolvedAdapter);
     CHR (hr);
@@ -724,10 +763,14 @@ void Application::WirePrimaryContext()
     m_primary->Renderer().SetGlowSize        (settings.m_glowSizePercent);
 
     // Propagate the initial DPI scale to overlay classes so layout computations
-    // use the correct scaling from the very first frame.
+    // use the correct scaling from the very first frame.  No render thread is
+    // running, so drain anything posted for the previous primary first and
+    // then touch the overlays directly.
     {
         float dpiScale = m_primary->GetDpiScale();
 
+        m_overlays.ApplyPendingCommands();
+
         if (m_overlays.helpOverlay)   m_overlays.helpOverlay->SetDpiScale (dpiScale);
         if (m_overlays.hotkeyOverlay) m_overlays.hotkeyOverlay->SetDpiScale (dpiScale);
     }
@@ -744,17 +787,31 @@ void Application::WirePrimaryContext()
 //  Application::InitializeContextResources
 //
 //  Builds the CharacterSet-dependent per-context resources (animation wiring +
-//  per-device glyph atlas).  Must run after CharacterSet::Initialize.
+//  per-device glyph atlas), and the shared simulation's first streaks when
+//  there is one.  With the SimulationThread setting (and no shared
+//  simulation) each context also gets its SimulationPipeline here.  Must
+//  run after CharacterSet::Initialize.
 //
 ////////////////////////////////////////////////////////////////////////////////
 
 HRESULT Application::InitializeContextResources()
 {
-    HRESULT hr = S_OK;
+    HRESULT hr                  = S_OK;
+    bool    useSimulationThread = m_appState->GetSettings().m_simulationThread && !m_desktopSimulation;
+
 
+    if (m_desktopSimulation)
+    {
+        m_desktopSimulation->Initialize();
+    }
 
     for (auto & context : m_contexts)
     {
+        if (useSimulationThread)
+        {
+            context->UseSimulationThread();
+        }
+
         context->InitializeAnimation();
 
         hr = context->BuildGlyphAtlas();
@@ -807,14 +864,22 @@ MonitorRenderContext * Application::ContextForHwnd (HWND hwnd) const
 //
 //  Application::StartRenderThreads
 //
-//  Starts one render thread per context.  Only the primary context renders
-//  overlays/statistics and advances the shared color-cycle clock; secondaries
-//  receive a null OverlayState and a null primary-clock pointer.
+//  Starts one render thread per context, or — with the RenderWorkers
+//  setting non-zero (RenderThreadModel::SharedWorker) — splits the contexts
+//  across that many SharedRenderWorkers.  Only the primary context renders
+//  overlays/statistics and advances the shared color-cycle clock;
+//  secondaries receive a null OverlayState and a null primary-clock pointer.
+//  Contexts with a SimulationPipeline start its thread alongside either.
 //
 ////////////////////////////////////////////////////////////////////////////////
 
 void Application::StartRenderThreads()
 {
+    int               renderWorkers = m_appState->GetSettings().m_renderWorkers;
+    RenderThreadModel model         = RenderThreadModelForWorkerCount (renderWorkers);
+
+
+
     for (auto & context : m_contexts)
     {
         RenderThreadInputs inputs = MakeRenderThreadInputs (context->IsPrimary(),
@@ -823,7 +888,34 @@ void Application::StartRenderThreads()
                                                             m_appState.get(),
                                                             &m_inDisplayModeTransition);
 
-        context->StartRenderThread (*inputs.sharedState, inputs.overlays, inputs.primaryClock, *inputs.inTransition);
+        if (model == RenderThreadModel::SharedWorker)
+        {
+            context->BindRenderInputs (*inputs.sharedState, inputs.overlays, inputs.primaryClock, *inputs.inTransition);
+        }
+        else
+        {
+            context->StartRenderThread (*inputs.sharedState, inputs.overlays, inputs.primaryClock, *inputs.inTransition);
+        }
+
+        context->StartSimulationThread();
+    }
+
+    if (model == RenderThreadModel::PerMonitor)
+    {
+        return;
+    }
+
+    for (const std::vector<size_t> & assigned : AssignContextsToWorkers (m_contexts.size(), renderWorkers))
+    {
+        std::vector<ScheduledRenderTarget> targets;
+
+        for (size_t index : assigned)
+        {
+            targets.push_back (m_contexts[index]->MakeScheduledTarget());
+        }
+
+        m_renderWorkers.push_back (std::make_unique<SharedRenderWorker> (std::move (targets), m_sharedState.wake, &m_inDisplayModeTransition));
+        m_renderWorkers.back()->Start();
     }
 }
 
@@ -835,8 +927,8 @@ void Application::StartRenderThreads()
 //
 //  Application::StopRenderThreads
 //
-//  Signals every render thread to stop, then joins them.  Stopping all before
-//  joining lets the threads quiesce in parallel.
+//  Signals every render thread (or shared worker) to stop, then joins them.
+//  Stopping all before joining lets the threads quiesce in parallel.
 //
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -847,10 +939,53 @@ void Application::StopRenderThreads()
         context->RequestStop();
     }
 
+    for (auto & worker : m_renderWorkers)
+    {
+        worker->RequestStop();
+    }
+
     for (auto & context : m_contexts)
     {
         context->Join();
     }
+
+    for (auto & worker : m_renderWorkers)
+    {
+        worker->Join();
+    }
+
+    for (auto & context : m_contexts)
+    {
+        context->DetachFromWorker();
+    }
+
+    m_renderWorkers.clear();
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  Application::WriteFrameTrace
+//
+//  Writes every thread's recent trace events to the TraceFile path as
+//  Chrome trace JSON, replacing the previous dump.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void Application::WriteFrameTrace()
+{
+    const std::wstring & path = m_appState->GetSettings().m_traceFile;
+    HRESULT              hr   = FrameTrace::WriteChromeJson (path);
+
+
+
+    if (FAILED (hr))
+    {
+        OutputDebugStringW (std::format (L"Frame trace: writing {} failed (0x{:08X})\n", path, static_cast<uint32_t> (hr)).c_str());
+    }
 }
 
 
@@ -988,6 +1123,7 @@ void Application::RebuildContextsForCurrentMode()
     HRESULT           hr            = S_OK;
     HWND              hConfigDialog = m_hConfigDialog;
     std::vector<HWND> hwnds;
+    TraceZone         zone ("RebuildContexts");
 
 
     // Keep the live config dialog alive across the primary-window rebuild.
@@ -1010,6 +1146,7 @@ void Application::RebuildContextsForCurrentMode()
     }
 
     m_contexts.clear();
+    m_desktopSimulation.reset();
     m_primary = nullptr;
     m_hwnd    = nullptr;
 
@@ -1053,6 +1190,7 @@ void Application::RebuildContextsForCurrentMode()
     }
 
     m_inDisplayModeTransition = false;
+    m_sharedState.wake.Notify();
 
     if (FAILED (hr))
     {
@@ -1107,6 +1245,14 @@ void Application::Shutdown()
     // resources BEFORE destroying the windows they observe.
     StopRenderThreads();
 
+    // With every render thread stopped the trace is complete; write it
+    // once (Shutdown also runs from the destructor)
+    if (FrameTrace::IsEnabled())
+    {
+        WriteFrameTrace();
+        FrameTrace::Disable();
+    }
+
     std::vector<HWND> hwnds;
 
     for (auto & context : m_contexts)
@@ -1116,6 +1262,7 @@ void Application::Shutdown()
 
     m_inputSystem.reset();
     m_contexts.clear();
+    m_desktopSimulation.reset();
     m_primary = nullptr;
 
     for (HWND hwnd : hwnds)
@@ -1318,7 +1465,7 @@ void Application::OnKeyDown (WPARAM wParam)
         case VK_SPACE:
             // Spacebar pressed — toggle pause for every monitor via shared state
             {
-                std::lock_guard<std::mutex> lock (m_sharedState.mutex);
+                SharedState::WriteLock lock (m_sharedState);
                 m_sharedState.isPaused = !m_sharedState.isPaused;
             }
             isRecognized = true;
@@ -1340,20 +1487,21 @@ void Application::OnKeyDown (WPARAM wParam)
                 isQuestionKey = true;
                 isRecognized  = true;
 
-                std::lock_guard<std::mutex> lock (m_overlays.mutex);
-
-                if (m_overlays.hotkeyOverlay->GetPhase() == OverlayPhase::Holding ||
-                    m_overlays.hotkeyOverlay->GetPhase() == OverlayPhase::Revealing)
-                {
-                    m_overlays.hotkeyOverlay->Dismiss();
-                }
-                else
-                {
-                    m_overlays.hotkeyOverlay->Show();
-                }
+                m_overlays.Post ({ .type = OverlayCommandType::Toggle, .target = OverlayTarget::Hotkey });
             }
             break;
 
+        case 'T':
+            // T key — write the frame trace so far (TraceFile setting);
+            // recording carries on.  Without tracing, T is just another key.
+            if (FrameTrace::IsEnabled())
+            {
+                WriteFrameTrace();
+                isRecognized = true;
+                break;
+            }
+            [[fallthrough]];
+
         default:
             // All other keys — delegate to InputSystem
             if (m_inputSystem)
@@ -1364,7 +1512,7 @@ void Application::OnKeyDown (WPARAM wParam)
                 // (e.g., CycleColorScheme, ToggleStatistics, density +/-)
                 if (isRecognized && m_appState)
                 {
-                    std::lock_guard<std::mutex> lock (m_sharedState.mutex);
+                    SharedState::WriteLock lock (m_sharedState);
 
                     m_sharedState.colorScheme      = m_appState->GetColorScheme();
                     m_sharedState.showStatistics   = m_appState->GetShowStatistics();
@@ -1376,6 +1524,8 @@ void Application::OnKeyDown (WPARAM wParam)
     //
     // Overlay management: dismiss active overlays on any non-modifier key,
     // or show the help hint if no overlay is active and the key is unrecognized.
+    // The render thread owns the overlays and decides from their phase on
+    // its next frame; nothing here waits for it.
     //
 
     // Ignore standalone modifier keys entirely
@@ -1389,24 +1539,15 @@ void Application::OnKeyDown (WPARAM wParam)
 
     if (m_overlays.helpOverlay)
     {
-        std::lock_guard<std::mutex> lock (m_overlays.mutex);
+        // Unrecognized key with overlay hidden or dissolving — (re)show
+        OverlayCommandType type = isRecognized ? OverlayCommandType::Dismiss : OverlayCommandType::Toggle;
 
-        if (m_overlays.helpOverlay->GetPhase() == OverlayPhase::Holding ||
-            m_overlays.helpOverlay->GetPhase() == OverlayPhase::Revealing)
-        {
-            m_overlays.helpOverlay->Dismiss();
-        }
-        else if (!isRecognized)
-        {
-            // Unrecognized key with overlay hidden or dissolving — (re)show
-            m_overlays.helpOverlay->Show();
-        }
+        m_overlays.Post ({ .type = type, .target = OverlayTarget::Help });
     }
 
-    if (m_overlays.hotkeyOverlay && m_overlays.hotkeyOverlay->IsActive() && !isQuestionKey)
+    if (m_overlays.hotkeyOverlay && !isQuestionKey)
     {
-        std::lock_guard<std::mutex> lock (m_overlays.mutex);
-        m_overlays.hotkeyOverlay->Dismiss();
+        m_overlays.Post ({ .type = OverlayCommandType::Dismiss, .target = OverlayTarget::Hotkey });
     }
 }
 
@@ -1447,19 +1588,8 @@ void Application::OnSysKeyDown (WPARAM wParam)
         }
 
         // Immediately hide overlays on Alt+Enter (no fade — viewport is changing)
-        {
-            std::lock_guard<std::mutex> lock (m_overlays.mutex);
-
-            if (m_overlays.helpOverlay && m_overlays.helpOverlay->IsActive())
-            {
-                m_overlays.helpOverlay->Hide();
-            }
-
-            if (m_overlays.hotkeyOverlay && m_overlays.hotkeyOverlay->IsActive())
-            {
-                m_overlays.hotkeyOverlay->Hide();
-            }
-        }
+        m_overlays.Post ({ .type = OverlayCommandType::Hide, .target = OverlayTarget::Help   });
+        m_overlays.Post ({ .type = OverlayCommandType::Hide, .target = OverlayTarget::Hotkey });
     }
 }
 
@@ -1574,15 +1704,8 @@ void Application::OnDpiChanged (HWND hwnd, WPARAM wParam, LPARAM lParam)
     // Overlays live only on the primary window
     if (hwnd == m_hwnd)
     {
-        if (m_overlays.helpOverlay)
-        {
-            m_overlays.helpOverlay->SetDpiScale (dpiScale);
-        }
-
-        if (m_overlays.hotkeyOverlay)
-        {
-            m_overlays.hotkeyOverlay->SetDpiScale (dpiScale);
-        }
+        m_overlays.Post ({ .type = OverlayCommandType::SetDpiScale, .target = OverlayTarget::Help,   .dpiScale = dpiScale });
+        m_overlays.Post ({ .type = OverlayCommandType::SetDpiScale, .target = OverlayTarget::Hotkey, .dpiScale = dpiScale });
     }
 }
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "OverlayState.h"
 #include "RebuildCoalescer.h"
 #include "RegistrySettingsProvider.h"
 #include "ScreenSaverModeContext.h"
@@ -17,29 +18,10 @@ class DensityController;
 class InputSystem;
 class ApplicationState;
 class FPSCounter;
-class Overlay;
 class MonitorRenderContext;
 class IMonitorProvider;
-
-
-
-////////////////////////////////////////////////////////////////////////////////
-//
-//  OverlayState — Thread-safe container for overlay objects
-//
-//  UI thread locks to call Show()/Dismiss()/Hide().
-//  Render thread locks to call Update() and read characters for rendering.
-//
-////////////////////////////////////////////////////////////////////////////////
-
-struct OverlayState
-{
-    mutable std::mutex mutex;
-
-    std::unique_ptr<Overlay> helpOverlay;
-    std::unique_ptr<Overlay> hotkeyOverlay;
-    std::unique_ptr<Overlay> usageOverlay;
-};
+class SharedRenderWorker;
+class VirtualDesktopSimulation;
 
 
 
@@ -93,7 +75,9 @@ private:
     // Core systems
     RegistrySettingsProvider                           m_settingsProvider;
     std::unique_ptr<IMonitorProvider>                  m_monitorProvider;
+    std::unique_ptr<VirtualDesktopSimulation>          m_desktopSimulation;    // Shared simulation only; outlives m_contexts
     std::vector<std::unique_ptr<MonitorRenderContext>> m_contexts;
+    std::vector<std::unique_ptr<SharedRenderWorker>>   m_renderWorkers;        // RenderThreadModel::SharedWorker only
     MonitorRenderContext *                             m_primary { nullptr };
     std::unique_ptr<InputSystem>                       m_inputSystem;
     std::unique_ptr<ApplicationState>                  m_appState;
@@ -129,6 +113,7 @@ private:
     void    RebuildContextsForCurrentMode();
     void    StartRenderThreads();
     void    StopRenderThreads();
+    void    WriteFrameTrace();
     MonitorRenderContext * ContextForHwnd (HWND hwnd) const;
     void    GetWindowSizeForCurrentMode   (POINT & position, SIZE & size);
     bool    ShouldExitScreenSaverOnKey    (WPARAM wParam);
@@ -22,6 +22,7 @@ public:
     bool    isHead             = false; // True if this is the current head character (white)
     float   lifetime           = 0.0f;  // Total time remaining (bright time + fade time)
     float   fadeTime           = 3.0f;  // Duration of fade phase (constant)
+    uint64_t sequence          = 0;     // Order of birth within the owning streak (stable render identity)
     
 #ifdef _DEBUG
     float   previousBrightness = 1.0f;  // Debug: track previous frame's brightness
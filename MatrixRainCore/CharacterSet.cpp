@@ -3,6 +3,7 @@
 #include "CharacterSet.h"
 #include "CharacterConstants.h"
 #include "GlyphAtlas.h"
+#include "UniformRandom.h"
 
 
 
@@ -115,8 +116,12 @@ bool CharacterSet::Initialize()
     // Calculate UV coordinates for 16x17 grid (272 rain glyphs)
     CalculateUVCoordinates();
 
-    // Measure proportional advance widths using Segoe UI (for overlay positioning)
-    MeasureProportionalAdvanceWidths (codepoints, overlayCodepoints);
+    // Measure proportional advance widths using Segoe UI (for overlay
+    // positioning), unless a current rain atlas cache already holds them
+    if (!TryOpenRainCache())
+    {
+        MeasureProportionalAdvanceWidths (codepoints, overlayCodepoints);
+    }
 
     m_initialized = true;
 
@@ -137,18 +142,12 @@ bool CharacterSet::Initialize()
 
 size_t CharacterSet::GetRandomGlyphIndex (size_t count) const
 {
-    static thread_local std::random_device s_rd;
-    static thread_local std::mt19937       s_gen (s_rd());
-
-
-
     if (count == 0)
     {
         return 0;
     }
 
-    std::uniform_int_distribution<size_t> dist (0, count - 1);
-    return dist (s_gen);
+    return UniformIndex (s_generator, 0, count - 1);
 }
 
 
@@ -325,6 +324,8 @@ Error:
 
 void CharacterSet::Shutdown()
 {
+    m_rainCache.Close();
+    m_overlayCache.Close();
     m_overlayUVs.clear();
     m_glyphs.clear();
     m_initialized = false;
@@ -363,20 +364,74 @@ HRESULT CharacterSet::RecreateOverlayAtlas (ID3D11Device * d3dDevice, float dpiS
 //  Creates the 2048x2048 rain glyph atlas and the DPI-aware overlay atlas.
 //  Both atlases share the same D3D11 device.
 //
+//  When the rain atlas cache is open its pixels are uploaded straight from
+//  the mapping; otherwise the glyphs are rasterized (and cached, so the
+//  next device, this run or the next, uploads instead).
+//
 ////////////////////////////////////////////////////////////////////////////////
 
 HRESULT CharacterSet::CreateTextureAtlas (ID3D11Device * d3dDevice, float dpiScale, GlyphAtlas & atlas)
+{
+    HRESULT hr = S_OK;
+
+
+
+    CBRAEx (d3dDevice != nullptr,    E_INVALIDARG);
+    CBRAEx (!atlas.m_rainTexture,    E_UNEXPECTED);
+
+    if (m_rainCache.IsOpen())
+    {
+        hr = CreateTextureFromPixels (d3dDevice,
+                                      m_rainCache.GetWidth(),
+                                      m_rainCache.GetHeight(),
+                                      m_rainCache.GetPixels(),
+                                      &atlas.m_rainTexture,
+                                      &atlas.m_rainSRV);
+        CHRA (hr);
+    }
+    else
+    {
+        hr = RasterizeRainAtlas (d3dDevice, atlas);
+        CHR (hr);
+    }
+
+    // Create overlay atlas (DPI-aware, sized for 1:1 texel-to-pixel mapping)
+    hr = CreateOverlayAtlas (d3dDevice, dpiScale, atlas);
+    CHR (hr);
+
+
+Error:
+    if (FAILED (hr))
+    {
+        m_overlayUVs.clear();
+        atlas.Reset();
+    }
+
+    return hr;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  CharacterSet::RasterizeRainAtlas
+//
+//  Draws every rain glyph into a new render-target texture through
+//  Direct2D, then saves the result to the rain atlas cache.  A cache that
+//  cannot be written only costs the next launch the same work again.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+HRESULT CharacterSet::RasterizeRainAtlas (ID3D11Device * d3dDevice, GlyphAtlas & atlas)
 {
     HRESULT                            hr          = S_OK;
     ID3D11Device                     * device      = d3dDevice;
     D3D11_TEXTURE2D_DESC               textureDesc = {};
     D3D11_SHADER_RESOURCE_VIEW_DESC    srvDesc     = {};
-    
 
 
-    CBRAEx (d3dDevice != nullptr,    E_INVALIDARG);
-    CBRAEx (!atlas.m_rainTexture,    E_UNEXPECTED);
-    
 
     // Create texture atlas: 2048x2048 RGBA texture
     textureDesc.Width              = 2048;
@@ -407,18 +462,11 @@ HRESULT CharacterSet::CreateTextureAtlas (ID3D11Device * d3dDevice, float dpiSca
     hr = RenderGlyphsToAtlas (device, atlas.m_rainTexture.Get());
     CHRA (hr);
 
-    // Create overlay atlas (DPI-aware, sized for 1:1 texel-to-pixel mapping)
-    hr = CreateOverlayAtlas (device, dpiScale, atlas);
-    CHR (hr);
+    hr = SaveAtlasToCache (device, atlas.m_rainTexture.Get(), L"RainAtlas", ComputeRainCacheKey(), false, m_rainCache);
+    IGNORE_RETURN_VALUE (hr, S_OK);
 
-    
-Error:
-    if (FAILED (hr))
-    {
-        m_overlayUVs.clear();
-        atlas.Reset();
-    }
 
+Error:
     return hr;
 }
 
@@ -435,6 +483,9 @@ Error:
 //  at the target font size fill each cell, eliminating the quality loss from
 //  downsampling a large atlas.  The atlas is recreated on DPI changes.
 //
+//  Each DPI scale has its own cache file; a scale seen before is uploaded
+//  from the mapping instead of being drawn again.
+//
 ////////////////////////////////////////////////////////////////////////////////
 
 HRESULT CharacterSet::CreateOverlayAtlas (ID3D11Device * d3dDevice, float dpiScale, GlyphAtlas & atlas)
@@ -446,6 +497,7 @@ HRESULT CharacterSet::CreateOverlayAtlas (ID3D11Device * d3dDevice, float dpiSca
     int                                fontSize    = 0;
     int                                gridCols    = 16;
     int                                gridRows    = 18;
+    uint64_t                           cacheKey    = 0;
 
 
 
@@ -470,34 +522,59 @@ HRESULT CharacterSet::CreateOverlayAtlas (ID3D11Device * d3dDevice, float dpiSca
     m_overlayAtlasWidth        = gridCols * (m_overlayCellContentWidth  + 2 * m_overlayPadding);
     m_overlayAtlasHeight       = gridRows * (m_overlayCellContentHeight + 2 * m_overlayPadding);
 
-    // Create overlay texture atlas at computed dimensions
-    textureDesc.Width              = static_cast<UINT> (m_overlayAtlasWidth);
-    textureDesc.Height             = static_cast<UINT> (m_overlayAtlasHeight);
-    textureDesc.MipLevels          = 1;
-    textureDesc.ArraySize          = 1;
-    textureDesc.Format             = DXGI_FORMAT_B8G8R8A8_UNORM;
-    textureDesc.SampleDesc.Count   = 1;
-    textureDesc.SampleDesc.Quality = 0;
-    textureDesc.Usage              = D3D11_USAGE_DEFAULT;
-    textureDesc.BindFlags          = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET;
-    textureDesc.CPUAccessFlags     = 0;
-    textureDesc.MiscFlags          = D3D11_RESOURCE_MISC_SHARED;
-
-    hr = device->CreateTexture2D (&textureDesc, nullptr, &atlas.m_overlayTexture);
-    CHRA (hr);
+    CalculateOverlayUVCoordinates();
 
-    srvDesc.Format                    = textureDesc.Format;
-    srvDesc.ViewDimension             = D3D11_SRV_DIMENSION_TEXTURE2D;
-    srvDesc.Texture2D.MipLevels       = 1;
-    srvDesc.Texture2D.MostDetailedMip = 0;
+    cacheKey = ComputeOverlayCacheKey (dpiScale);
 
-    hr = device->CreateShaderResourceView (atlas.m_overlayTexture.Get(), &srvDesc, &atlas.m_overlaySRV);
-    CHRA (hr);
+    if (!m_overlayCache.IsOpen() || m_overlayCache.GetKey() != cacheKey)
+    {
+        hr = m_overlayCache.Open (GlyphAtlasCache::GetDefaultPath (L"OverlayAtlas", cacheKey), cacheKey);
+        IGNORE_RETURN_VALUE (hr, S_OK);
+    }
 
-    hr = RenderOverlayGlyphsToAtlas (device, atlas.m_overlayTexture.Get());
-    CHRA (hr);
+    if (m_overlayCache.IsOpen())
+    {
+        hr = CreateTextureFromPixels (device,
+                                      m_overlayCache.GetWidth(),
+                                      m_overlayCache.GetHeight(),
+                                      m_overlayCache.GetPixels(),
+                                      &atlas.m_overlayTexture,
+                                      &atlas.m_overlaySRV);
+        CHRA (hr);
+    }
+    else
+    {
+        // Create overlay texture atlas at computed dimensions
+        textureDesc.Width              = static_cast<UINT> (m_overlayAtlasWidth);
+        textureDesc.Height             = static_cast<UINT> (m_overlayAtlasHeight);
+        textureDesc.MipLevels          = 1;
+        textureDesc.ArraySize          = 1;
+        textureDesc.Format             = DXGI_FORMAT_B8G8R8A8_UNORM;
+        textureDesc.SampleDesc.Count   = 1;
+        textureDesc.SampleDesc.Quality = 0;
+        textureDesc.Usage              = D3D11_USAGE_DEFAULT;
+        textureDesc.BindFlags          = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET;
+        textureDesc.CPUAccessFlags     = 0;
+        textureDesc.MiscFlags          = D3D11_RESOURCE_MISC_SHARED;
+
+        hr = device->CreateTexture2D (&textureDesc, nullptr, &atlas.m_overlayTexture);
+        CHRA (hr);
+
+        srvDesc.Format                    = textureDesc.Format;
+        srvDesc.ViewDimension             = D3D11_SRV_DIMENSION_TEXTURE2D;
+        srvDesc.Texture2D.MipLevels       = 1;
+        srvDesc.Texture2D.MostDetailedMip = 0;
+
+        hr = device->CreateShaderResourceView (atlas.m_overlayTexture.Get(), &srvDesc, &atlas.m_overlaySRV);
+        CHRA (hr);
+
+        hr = RenderOverlayGlyphsToAtlas (device, atlas.m_overlayTexture.Get());
+        CHRA (hr);
+
+        hr = SaveAtlasToCache (device, atlas.m_overlayTexture.Get(), L"OverlayAtlas", cacheKey, true, m_overlayCache);
+        IGNORE_RETURN_VALUE (hr, S_OK);
+    }
 
-    CalculateOverlayUVCoordinates();
 
 Error:
     if (FAILED (hr))
@@ -873,3 +950,258 @@ void CharacterSet::CalculateOverlayUVCoordinates()
         m_overlayUVs[i].uvMax.y = pixelMaxY / static_cast<float> (m_overlayAtlasHeight);
     }
 }
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  CharacterSet::BuildCachedGlyphTable
+//
+//  Flattens the glyph table into the cache file layout, with either the
+//  rain atlas UVs or the overlay atlas UVs.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<CachedGlyph> CharacterSet::BuildCachedGlyphTable (bool overlayUVs) const
+{
+    std::vector<CachedGlyph> table (m_glyphs.size());
+
+
+
+    for (size_t i = 0; i < m_glyphs.size(); i++)
+    {
+        const GlyphInfo & glyph = m_glyphs[i];
+        Vector2           uvMin = overlayUVs ? m_overlayUVs[i].uvMin : glyph.uvMin;
+        Vector2           uvMax = overlayUVs ? m_overlayUVs[i].uvMax : glyph.uvMax;
+
+        table[i].codepoint    = glyph.codepoint;
+        table[i].mirrored     = glyph.mirrored ? 1u : 0u;
+        table[i].uvMin[0]     = uvMin.x;
+        table[i].uvMin[1]     = uvMin.y;
+        table[i].uvMax[0]     = uvMax.x;
+        table[i].uvMax[1]     = uvMax.y;
+        table[i].advanceWidth = glyph.advanceWidth;
+    }
+
+    return table;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  CharacterSet::ComputeRainCacheKey
+//
+//  The rain atlas is drawn in Consolas at 80pt into a fixed 2048x2048
+//  texture, and its advance widths are measured in Segoe UI; DPI does
+//  not enter into it.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+uint64_t CharacterSet::ComputeRainCacheKey() const
+{
+    std::vector<CachedGlyph> table = BuildCachedGlyphTable (false);
+
+
+
+    return GlyphAtlasCache::ComputeKey (L"Consolas/Segoe UI", 80.0f, 1.0f, 2048, 2048, table);
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  CharacterSet::ComputeOverlayCacheKey
+//
+//  Requires the overlay layout (CreateOverlayAtlas) for dpiScale to be
+//  current.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+uint64_t CharacterSet::ComputeOverlayCacheKey (float dpiScale) const
+{
+    std::vector<CachedGlyph> table = BuildCachedGlyphTable (true);
+
+
+
+    return GlyphAtlasCache::ComputeKey (L"Segoe UI",
+                                        m_overlayFontSize,
+                                        dpiScale,
+                                        static_cast<UINT> (m_overlayAtlasWidth),
+                                        static_cast<UINT> (m_overlayAtlasHeight),
+                                        table);
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  CharacterSet::TryOpenRainCache
+//
+//  Maps the rain atlas cache for the current glyph layout, if one exists,
+//  and takes the advance widths from it so DirectWrite is not needed.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+bool CharacterSet::TryOpenRainCache()
+{
+    HRESULT  hr  = S_OK;
+    uint64_t key = ComputeRainCacheKey();
+
+
+
+    hr = m_rainCache.Open (GlyphAtlasCache::GetDefaultPath (L"RainAtlas", key), key);
+    CHR (hr);
+
+    // The key covers the glyph count and order, so the tables line up
+    for (size_t i = 0; i < m_glyphs.size(); i++)
+    {
+        m_glyphs[i].advanceWidth = m_rainCache.GetGlyphs()[i].advanceWidth;
+    }
+
+    m_spaceAdvanceWidth = m_rainCache.GetSpaceAdvanceWidth();
+
+
+Error:
+    return SUCCEEDED (hr);
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  CharacterSet::CreateTextureFromPixels
+//
+//  Creates an immutable shader-resource texture initialized from
+//  premultiplied BGRA pixels (typically a cache mapping).  The driver
+//  copies the pixels during creation; nothing is drawn.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+HRESULT CharacterSet::CreateTextureFromPixels (ID3D11Device              * d3dDevice,
+                                               UINT                        width,
+                                               UINT                        height,
+                                               std::span<const uint32_t>   pixels,
+                                               ID3D11Texture2D          ** ppTexture,
+                                               ID3D11ShaderResourceView ** ppSRV)
+{
+    HRESULT                            hr          = S_OK;
+    D3D11_TEXTURE2D_DESC               textureDesc = {};
+    D3D11_SUBRESOURCE_DATA             initialData = {};
+    D3D11_SHADER_RESOURCE_VIEW_DESC    srvDesc     = {};
+
+
+
+    CBRAEx (d3dDevice != nullptr && pixels.size() == size_t (width) * height, E_INVALIDARG);
+
+    textureDesc.Width              = width;
+    textureDesc.Height             = height;
+    textureDesc.MipLevels          = 1;
+    textureDesc.ArraySize          = 1;
+    textureDesc.Format             = DXGI_FORMAT_B8G8R8A8_UNORM;
+    textureDesc.SampleDesc.Count   = 1;
+    textureDesc.SampleDesc.Quality = 0;
+    textureDesc.Usage              = D3D11_USAGE_IMMUTABLE;
+    textureDesc.BindFlags          = D3D11_BIND_SHADER_RESOURCE;
+    textureDesc.CPUAccessFlags     = 0;
+    textureDesc.MiscFlags          = 0;
+
+    initialData.pSysMem     = pixels.data();
+    initialData.SysMemPitch = static_cast<UINT> (width * sizeof (uint32_t));
+
+    hr = d3dDevice->CreateTexture2D (&textureDesc, &initialData, ppTexture);
+    CHRA (hr);
+
+    srvDesc.Format                    = textureDesc.Format;
+    srvDesc.ViewDimension             = D3D11_SRV_DIMENSION_TEXTURE2D;
+    srvDesc.Texture2D.MipLevels       = 1;
+    srvDesc.Texture2D.MostDetailedMip = 0;
+
+    hr = d3dDevice->CreateShaderResourceView (*ppTexture, &srvDesc, ppSRV);
+    CHRA (hr);
+
+
+Error:
+    return hr;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  CharacterSet::SaveAtlasToCache
+//
+//  Reads a freshly drawn atlas back through a staging texture, writes it
+//  to the cache, and maps the written file into the given cache so later
+//  devices in this run upload from it too.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+HRESULT CharacterSet::SaveAtlasToCache (ID3D11Device      * d3dDevice,
+                                        ID3D11Texture2D   * texture,
+                                        std::wstring_view   name,
+                                        uint64_t            key,
+                                        bool                overlayUVs,
+                                        GlyphAtlasCache   & cache)
+{
+    HRESULT                     hr          = S_OK;
+    ComPtr<ID3D11DeviceContext> context;
+    ComPtr<ID3D11Texture2D>     staging;
+    D3D11_TEXTURE2D_DESC        stagingDesc = {};
+    D3D11_MAPPED_SUBRESOURCE    mapped      = {};
+    std::vector<uint32_t>       pixels;
+    std::filesystem::path       path        = GlyphAtlasCache::GetDefaultPath (name, key);
+
+
+
+    CBREx (!path.empty(), HRESULT_FROM_WIN32 (ERROR_PATH_NOT_FOUND));
+
+    texture->GetDesc (&stagingDesc);
+
+    stagingDesc.Usage          = D3D11_USAGE_STAGING;
+    stagingDesc.BindFlags      = 0;
+    stagingDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+    stagingDesc.MiscFlags      = 0;
+
+    hr = d3dDevice->CreateTexture2D (&stagingDesc, nullptr, &staging);
+    CHR (hr);
+
+    d3dDevice->GetImmediateContext (&context);
+    context->CopyResource (staging.Get(), texture);
+
+    hr = context->Map (staging.Get(), 0, D3D11_MAP_READ, 0, &mapped);
+    CHR (hr);
+
+    pixels.resize (size_t (stagingDesc.Width) * stagingDesc.Height);
+
+    for (UINT y = 0; y < stagingDesc.Height; y++)
+    {
+        memcpy (pixels.data() + size_t (y) * stagingDesc.Width,
+                static_cast<const uint8_t *> (mapped.pData) + size_t (y) * mapped.RowPitch,
+                stagingDesc.Width * sizeof (uint32_t));
+    }
+
+    context->Unmap (staging.Get(), 0);
+
+    hr = GlyphAtlasCache::Write (path, key, BuildCachedGlyphTable (overlayUVs), m_spaceAdvanceWidth, stagingDesc.Width, stagingDesc.Height, pixels);
+    CHR (hr);
+
+    hr = cache.Open (path, key);
+    CHR (hr);
+
+
+Error:
+    return hr;
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include "GlyphAtlasCache.h"
 #include "Math.h"
 
 
@@ -72,6 +73,9 @@ public:
     size_t  GetRandomGlyphIndex  (size_t count) const;
     size_t  FindGlyphByCodepoint (uint32_t codepoint) const;
 
+    // Reseed the calling thread's glyph picker
+    static void SeedRandom (uint32_t seed) { s_generator.seed (seed); }
+
     const GlyphInfo & GetGlyph             (size_t index) const { return m_glyphs[index]; }
     float             GetSpaceAdvanceWidth ()             const { return m_spaceAdvanceWidth; }
     size_t            GetGlyphCount        ()             const { return m_glyphs.size(); }
@@ -98,6 +102,7 @@ private:
 
     // Internal initialization helpers
     HRESULT CreateD2DRenderContext         (ID3D11Device * d3dDevice, ID3D11Texture2D * texture, ID2D1DeviceContext ** ppContext, IDWriteFactory ** ppDWriteFactory, ID2D1SolidColorBrush ** ppBrush);
+    HRESULT RasterizeRainAtlas                 (ID3D11Device * d3dDevice, GlyphAtlas & atlas);
     HRESULT RenderGlyphsToAtlas                (ID3D11Device * d3dDevice, ID3D11Texture2D * rainTexture);
     HRESULT CreateOverlayAtlas                 (ID3D11Device * d3dDevice, float dpiScale, GlyphAtlas & atlas);
     HRESULT RenderOverlayGlyphsToAtlas         (ID3D11Device * d3dDevice, ID3D11Texture2D * overlayTexture);
@@ -106,6 +111,14 @@ private:
     void    MeasureProportionalAdvanceWidths   (const std::vector<uint32_t> & rainCodepoints, const std::vector<uint32_t> & overlayCodepoints);
     float   MeasureCodepointAdvanceWidth       (IDWriteFactory * pFactory, IDWriteTextFormat * pFormat, uint32_t codepoint, float fontSize, bool includeTrailingWhitespace);
 
+    // On-disk atlas cache (see GlyphAtlasCache)
+    std::vector<CachedGlyph> BuildCachedGlyphTable   (bool overlayUVs) const;
+    uint64_t                 ComputeRainCacheKey     () const;
+    uint64_t                 ComputeOverlayCacheKey  (float dpiScale) const;
+    bool                     TryOpenRainCache        ();
+    HRESULT                  CreateTextureFromPixels (ID3D11Device * d3dDevice, UINT width, UINT height, std::span<const uint32_t> pixels, ID3D11Texture2D ** ppTexture, ID3D11ShaderResourceView ** ppSRV);
+    HRESULT                  SaveAtlasToCache        (ID3D11Device * d3dDevice, ID3D11Texture2D * texture, std::wstring_view name, uint64_t key, bool overlayUVs, GlyphAtlasCache & cache);
+
     // Member data
     std::vector<GlyphInfo>                       m_glyphs;                         // Array of all glyphs (rain + overlay)
     size_t                                       m_rainGlyphCount = 0;             // Count of rain-only glyphs (normal + mirrored)
@@ -123,6 +136,15 @@ private:
     float                                        m_overlayFontSize           = 0.0f;
     float                                        m_spaceAdvanceWidth         = 0.25f;  // Proportional space width (fraction of em-height)
     bool                                         m_initialized               = false;  // Initialization state
+
+    // Atlas caches stay mapped so every device this run uploads from the
+    // same pages; the overlay one is swapped when the DPI scale changes
+    GlyphAtlasCache                              m_rainCache;
+    GlyphAtlasCache                              m_overlayCache;
+
+    // Glyph picker (per-thread to avoid data races between render and UI threads)
+    static inline thread_local std::random_device s_randomDevice;
+    static inline thread_local std::mt19937       s_generator { s_randomDevice() };
 };
 
 
@@ -2,6 +2,7 @@
 
 #include "CharacterStreak.h"
 #include "CharacterSet.h"
+#include "UniformRandom.h"
 
 
 
@@ -24,14 +25,16 @@ float CharacterStreak::GetVelocityScale (float depth)
 
 void CharacterStreak::Spawn (const Vector3 & position)
 {
-    static uint64_t s_nextID = 1;
+    // IDs key InstanceStore slots, and every render and simulation thread
+    // spawns streaks, so each must be unique across threads
+    static std::atomic<uint64_t> s_nextID { 1 };
     
-    m_id       = s_nextID++;
-    m_position = position; // This is the head position where new characters spawn
+    m_id           = s_nextID.fetch_add (1, std::memory_order_relaxed);
+    m_position     = position; // This is the head position where new characters spawn
+    m_nextSequence = 0;
 
     // Random length between 5 and 30
-    std::uniform_int_distribution<size_t> lengthDist (MIN_LENGTH, MAX_LENGTH);
-    m_maxLength = lengthDist (s_generator);
+    m_maxLength = UniformIndex (s_generator, MIN_LENGTH, MAX_LENGTH);
 
     // Start with no characters - they'll be added as the streak "drops"
     m_characters.clear();
@@ -65,6 +68,7 @@ void CharacterStreak::Spawn (const Vector3 & position)
     character.isHead         = true;
     character.lifetime       = 0.0f; // Head has no lifetime (stays alive while isHead=true)
     character.fadeTime       = 3.0f;
+    character.sequence       = m_nextSequence++;
     
     m_characters.push_back (character);
 }
@@ -113,6 +117,7 @@ void CharacterStreak::Update (float deltaTime, float viewportHeight)
             character.isHead         = true;
             character.lifetime       = 0.0f; // Head has no lifetime (stays alive while isHead=true)
             character.fadeTime       = 3.0f;
+            character.sequence       = m_nextSequence++;
 
             m_characters.push_back (character);
             
@@ -163,13 +168,12 @@ void CharacterStreak::Update (float deltaTime, float viewportHeight)
     m_characters.erase (lastAlive.base(), m_characters.end());
 
     // Handle character mutation (5% probability per character per second)
-    std::uniform_real_distribution<float> mutationDist (0.0f, 1.0f);
     CharacterSet & charSet = CharacterSet::GetInstance();
 
     for (CharacterInstance & character : m_characters)
     {
         float mutationChance = MUTATION_PROBABILITY * deltaTime;
-        if (mutationDist (s_generator) < mutationChance)
+        if (UniformReal (s_generator, 0.0f, 1.0f) < mutationChance)
         {
             // Mutate to a new random glyph (keep existing fade state)
             character.glyphIndex = charSet.GetRandomGlyphIndex (charSet.GetGlyphCount());
@@ -213,8 +217,7 @@ void CharacterStreak::RescalePositions (float scaleX, float scaleY)
     m_position.y *= scaleY;
 
     // Add small random jitter to X to break up banding patterns from scaling
-    std::uniform_real_distribution<float> jitterDist (-16.0f, 16.0f);
-    m_position.x += jitterDist (s_generator);
+    m_position.x += UniformReal (s_generator, -16.0f, 16.0f);
 
     // Recalculate character positions based on fixed spacing from the new head position
     // Characters are stored back-to-front (tail at [0], head at [size-1])
@@ -254,6 +257,33 @@ void CharacterStreak::SetCharacterSpacing (float spacing)
 
 
 
+void CharacterStreak::AssignSlice (const CharacterStreak & source, size_t first, size_t last, float dx, float dy)
+{
+    m_position         = Vector3 (source.m_position.x + dx, source.m_position.y + dy, source.m_position.z);
+    m_velocity         = source.m_velocity;
+    m_mutationTimer    = source.m_mutationTimer;
+    m_dropTimer        = source.m_dropTimer;
+    m_dropInterval     = source.m_dropInterval;
+    m_baseDropInterval = source.m_baseDropInterval;
+    m_characterSpacing = source.m_characterSpacing;
+    m_maxLength        = source.m_maxLength;
+    m_isInFadingPhase  = source.m_isInFadingPhase;
+    m_id               = source.m_id;
+    m_nextSequence     = source.m_nextSequence;
+
+    m_characters.assign (source.m_characters.begin() + first, source.m_characters.begin() + last);
+
+    // A character's X offset is relative to the streak; its Y is absolute
+    for (CharacterInstance & character : m_characters)
+    {
+        character.positionOffset.y += dy;
+    }
+}
+
+
+
+
+
 void CharacterStreak::SetSpeedMultiplier (int speedPercent)
 {
     // Speed multiplier: 100 = normal, 50 = half speed, 200 = double speed
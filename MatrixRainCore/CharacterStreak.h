@@ -56,6 +56,13 @@ public:
     void RescalePositions    (float scaleX, float scaleY);
     void SetCharacterSpacing (float spacing);
 
+    /// <summary>
+    /// Become a copy of `source` holding only its characters [first, last),
+    /// moved by (dx, dy).  Hands one monitor its piece of a streak from a
+    /// VirtualDesktopSimulation; reuses this streak's character storage.
+    /// </summary>
+    void AssignSlice (const CharacterStreak & source, size_t first, size_t last, float dx, float dy);
+
     // Accessors
     const Vector3                        & GetPosition()       const { return m_position;          }
     const Vector3                        & GetVelocity()       const { return m_velocity;          }
@@ -67,6 +74,11 @@ public:
     void SetPosition        (const Vector3 & position) { m_position = position; }
     void SetSpeedMultiplier (int speedPercent);
 
+    /// <summary>
+    /// Reseed the calling thread's streak generator (lengths, mutation, jitter).
+    /// </summary>
+    static void SeedRandom (uint32_t seed) { s_generator.seed (seed); }
+
 private:
     Vector3                        m_position         {};       // Head position of the streak (in cells)
     Vector3                        m_velocity         {};       // Velocity in pixels/second (only for drift)
@@ -79,6 +91,7 @@ private:
     size_t                         m_maxLength        { 0 };    // Maximum number of characters in this streak
     bool                           m_isInFadingPhase  { false };// True when head has reached bottom and final fade has started
     uint64_t                       m_id               { 0 };    // Unique ID for debug tracking
+    uint64_t                       m_nextSequence     { 0 };    // Sequence number for the next character pushed
 
     // Random number generator (per-thread to avoid data races between render and UI threads)
     static inline thread_local std::random_device s_randomDevice;
@@ -112,6 +112,48 @@ Color4 GetColorRGB (ColorScheme scheme, float elapsedTime)
 
 
 
+Color4 ResolveSchemeColor (ColorScheme scheme, float elapsedTime, COLORREF customColor)
+{
+    // COLORREF is 0x00BBGGRR, normalise each channel to [0..1] for Color4
+    if (scheme == ColorScheme::Custom)
+    {
+        return Color4 (static_cast<float> (GetRValue (customColor)) / 255.0f,
+                       static_cast<float> (GetGValue (customColor)) / 255.0f,
+                       static_cast<float> (GetBValue (customColor)) / 255.0f);
+    }
+
+    return GetColorRGB (scheme, elapsedTime);
+}
+
+
+
+
+
+float GetColorCycleRedrawInterval (int maxLevelStep)
+{
+    float fastestRate = 0.0f;   // channel change per second
+
+
+
+    for (int i = 0; i < static_cast<int> (ColorScheme::__StaticColorCount); i++)
+    {
+        const Color4 & from = s_colorTable[i];
+        const Color4 & to   = s_colorTable[(i + 1) % static_cast<int> (ColorScheme::__StaticColorCount)];
+
+        for (float delta : { to.r - from.r, to.g - from.g, to.b - from.b })
+        {
+            fastestRate = std::max (fastestRate, fabsf (delta) / TIME_PER_COLOR);
+        }
+    }
+
+    return std::max (static_cast<float> (maxLevelStep) / 255.0f / fastestRate,
+                     COLOR_CYCLE_DURATION / COLOR_CYCLE_TABLE_SIZE);
+}
+
+
+
+
+
 ColorScheme ParseColorSchemeKey (const std::wstring & key)
 {
     if (key == L"green")      return ColorScheme::Green;
@@ -48,6 +48,26 @@ ColorScheme GetNextColorScheme (ColorScheme current);
 /// <returns>Color4 with RGB values (0-1 range)</returns>
 Color4 GetColorRGB (ColorScheme scheme, float elapsedTime = 0.0f);
 
+/// <summary>
+/// Get the rain tint for a color scheme, resolving ColorScheme::Custom
+/// from the user's persisted COLORREF instead of the static palette.
+/// </summary>
+/// <param name="scheme">Color scheme to query</param>
+/// <param name="elapsedTime">Elapsed time in seconds (used for ColorCycle mode)</param>
+/// <param name="customColor">User-picked color (0x00BBGGRR), used only for Custom</param>
+/// <returns>Color4 with RGB values (0-1 range)</returns>
+Color4 ResolveSchemeColor (ColorScheme scheme, float elapsedTime, COLORREF customColor);
+
+/// <summary>
+/// Longest interval between redraws that keeps ColorCycle moving smoothly:
+/// the time its fastest-changing channel takes to move maxLevelStep 8-bit
+/// levels, but never shorter than one step of the cycle's lookup table
+/// (redrawing faster than that repeats the same color).
+/// </summary>
+/// <param name="maxLevelStep">Largest per-redraw change allowed in any channel, in 1/255ths</param>
+/// <returns>Interval in seconds</returns>
+float GetColorCycleRedrawInterval (int maxLevelStep);
+
 /// <summary>
 /// Parse a color scheme key string to its enum value.
 /// Returns ColorScheme::Green for unrecognized keys.
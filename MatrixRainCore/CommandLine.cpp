@@ -2,6 +2,8 @@
 
 #include "CommandLine.h"
 
+#include "FrameExporter.h"
+
 
 
 
@@ -63,6 +65,7 @@ void CommandLine::SetContextFlagsFromMode (ScreenSaverModeContext & context)
         case ScreenSaverMode::HelpRequested:
         case ScreenSaverMode::Install:
         case ScreenSaverMode::Uninstall:
+        case ScreenSaverMode::Record:
             context.m_enableHotkeys = false;
             context.m_hideCursor    = false;
             context.m_exitOnInput   = false;
@@ -127,6 +130,10 @@ HRESULT CommandLine::TryParseMultiCharSwitch (LPCWSTR                  pszArg,
     {
         context.m_mode = ScreenSaverMode::Uninstall;
     }
+    else if (switchWord == L"record")
+    {
+        context.m_mode = ScreenSaverMode::Record;
+    }
     else if (switchWord == L"force")
     {
         // --force is only valid as a modifier for --install
@@ -156,8 +163,9 @@ Error:
 //  CommandLine::ValidateRemainingArgs
 //
 //  After parsing the primary switch, checks whether any trailing arguments
-//  remain.  Only /install (or --install) accepts a trailing modifier (/force).
-//  All other switches reject additional arguments.
+//  remain.  Only /install (or --install) accepts a trailing modifier (/force),
+//  and /record hands its arguments to ParseRecordArgs.  All other switches
+//  reject additional arguments.
 //
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -172,6 +180,13 @@ HRESULT CommandLine::ValidateRemainingArgs (LPCWSTR                & pszCommandL
 
 
     SkipWhitespace (pszCommandLine);
+
+    if (context.m_mode == ScreenSaverMode::Record)
+    {
+        hr = ParseRecordArgs (pszCommandLine, context);
+        goto Error;
+    }
+
     BAIL_OUT_IF (*pszCommandLine == L'\0', S_OK);
 
     // Only --install / /install accepts additional arguments (/force)
@@ -248,6 +263,180 @@ Error:
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+//
+//  CommandLine::ParseRecordArgs
+//
+//  /record <file> [/size <W>x<H>] [/frames <N>] [/fps <N>] [/seed <N>]
+//  [/density <0-100>] — headless export to a .y4m stream or .ppm sequence.
+//  The file may be quoted; options take either switch prefix, in any order.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+HRESULT CommandLine::ParseRecordArgs (LPCWSTR                & pszCommandLine,
+                                      ScreenSaverModeContext & context)
+{
+    HRESULT                 hr     = S_OK;
+    HeadlessRecordOptions & record = context.m_record;
+    FrameExportFormat       format = FrameExportFormat::Y4m;
+    std::wstring            option;
+    std::wstring            value;
+
+
+
+    record.outputPath = ReadToken (pszCommandLine);
+
+    if (FAILED (FrameExporter::FormatFromPath (record.outputPath, format)))
+    {
+        context.m_errorMessage = std::format (L"{}record needs an output file ending in .y4m or .ppm",
+                                              context.m_switchPrefix);
+        CHR (E_INVALIDARG);
+    }
+
+    for (SkipWhitespace (pszCommandLine); *pszCommandLine != L'\0'; SkipWhitespace (pszCommandLine))
+    {
+        UINT densityPercent = 0;
+        bool fValid         = false;
+
+        if (*pszCommandLine == L'/')
+        {
+            pszCommandLine++;
+        }
+        else if (*pszCommandLine == L'-' && *(pszCommandLine + 1) == L'-')
+        {
+            pszCommandLine += 2;
+        }
+
+        option = ReadToken (pszCommandLine);
+        SkipWhitespace (pszCommandLine);
+        value  = ReadToken (pszCommandLine);
+
+        for (auto & ch : option)
+        {
+            ch = towlower (ch);
+        }
+
+        if (option == L"size")
+        {
+            size_t separator = value.find_first_of (L"xX");
+
+            fValid = separator != std::wstring::npos                                                   &&
+                     ParseUnsigned (value.substr (0, separator),  1, s_kMaxRecordDimension, record.width)  &&
+                     ParseUnsigned (value.substr (separator + 1), 1, s_kMaxRecordDimension, record.height);
+        }
+        else if (option == L"frames")
+        {
+            fValid = ParseUnsigned (value, 1, UINT_MAX, record.frameCount);
+        }
+        else if (option == L"fps")
+        {
+            fValid = ParseUnsigned (value, 1, s_kMaxRecordFps, record.framesPerSecond);
+        }
+        else if (option == L"seed")
+        {
+            fValid = ParseUnsigned (value, 0, UINT_MAX, record.seed);
+        }
+        else if (option == L"density")
+        {
+            fValid = ParseUnsigned (value, 0, 100, densityPercent);
+            record.densityPercent = static_cast<int> (densityPercent);
+        }
+
+        if (!fValid)
+        {
+            context.m_errorMessage = std::format (L"Invalid {}record option: {}{} {}",
+                                                  context.m_switchPrefix,
+                                                  context.m_switchPrefix,
+                                                  option,
+                                                  value);
+            CHR (E_INVALIDARG);
+        }
+    }
+
+Error:
+    return hr;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  CommandLine::ReadToken
+//
+//  Returns the next whitespace-delimited word, or the contents of a
+//  double-quoted string, and advances past it.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+std::wstring CommandLine::ReadToken (LPCWSTR & psz)
+{
+    LPCWSTR pszStart = psz;
+    wchar_t chEnd    = L' ';
+
+
+
+    if (*psz == L'"')
+    {
+        chEnd    = L'"';
+        pszStart = ++psz;
+    }
+
+    while (*psz != L'\0' && *psz != chEnd && !(chEnd == L' ' && *psz == L'\t'))
+    {
+        psz++;
+    }
+
+    std::wstring token (pszStart, psz - pszStart);
+
+    if (chEnd == L'"' && *psz == L'"')
+    {
+        psz++;
+    }
+
+    return token;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  CommandLine::ParseUnsigned
+//
+//  Whole-string decimal parse, rejecting anything outside [minimum, maximum].
+//
+////////////////////////////////////////////////////////////////////////////////
+
+bool CommandLine::ParseUnsigned (const std::wstring & text, UINT minimum, UINT maximum, UINT & value)
+{
+    wchar_t          * pszEnd = nullptr;
+    unsigned long long parsed = 0;
+
+
+
+    if (text.empty() || !iswdigit (text[0]))
+    {
+        return false;
+    }
+
+    parsed = wcstoull (text.c_str(), &pszEnd, 10);
+
+    if (*pszEnd != L'\0' || parsed < minimum || parsed > maximum)
+    {
+        return false;
+    }
+
+    value = static_cast<UINT> (parsed);
+    return true;
+}
+
+
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 //  CommandLine::HandleScreenSaver
@@ -32,6 +32,7 @@ private:
 
     HRESULT TryParseMultiCharSwitch (LPCWSTR pszArg, ScreenSaverModeContext & context);
     HRESULT ValidateRemainingArgs    (LPCWSTR & pszCommandLine, ScreenSaverModeContext & context);
+    HRESULT ParseRecordArgs          (LPCWSTR & pszCommandLine, ScreenSaverModeContext & context);
 
     HRESULT HandleScreenSaver        (LPCWSTR & pszCommandLine, ScreenSaverModeContext & context);
     HRESULT HandleScreenSaverPreview (LPCWSTR & pszCommandLine, ScreenSaverModeContext & context);
@@ -48,6 +49,11 @@ private:
         { L'?', &CommandLine::HandleHelp               },
     };
 
-    static void SkipWhitespace          (LPCWSTR & psz);
-    static void SetContextFlagsFromMode (ScreenSaverModeContext & context);
+    static constexpr UINT s_kMaxRecordDimension = 16384;     // D3D11 texture limit
+    static constexpr UINT s_kMaxRecordFps       = 1000;
+
+    static void         SkipWhitespace          (LPCWSTR & psz);
+    static void         SetContextFlagsFromMode (ScreenSaverModeContext & context);
+    static std::wstring ReadToken               (LPCWSTR & psz);
+    static bool         ParseUnsigned           (const std::wstring & text, UINT minimum, UINT maximum, UINT & value);
 };
@@ -0,0 +1,200 @@
+#include "pch.h"
+
+#include "DamageTracker.h"
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  DamageTracker::Resize
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void DamageTracker::Resize (UINT width, UINT height)
+{
+    m_width  = width;
+    m_height = height;
+    m_tilesX = (width  + s_kTileSize - 1) / s_kTileSize;
+    m_tilesY = (height + s_kTileSize - 1) / s_kTileSize;
+
+    m_current.assign  (size_t (m_tilesX) * m_tilesY, 0);
+    m_previous.assign (size_t (m_tilesX) * m_tilesY, 0);
+    m_damaged.assign  (size_t (m_tilesX) * m_tilesY, 0);
+    m_dirtyRects.clear();
+
+    m_damagedTiles  = 0;
+    m_invalidateAll = true;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  DamageTracker::Update
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void DamageTracker::Update (std::span<const PixelRect> glyphRects, int reach)
+{
+    m_previous.swap (m_current);
+    std::ranges::fill (m_current, uint8_t (0));
+
+    for (const PixelRect & rect : glyphRects)
+    {
+        MarkRect (rect, reach);
+    }
+
+    m_damagedTiles = 0;
+
+    for (size_t tile = 0; tile < m_damaged.size(); tile++)
+    {
+        m_damaged[tile] = (m_invalidateAll || m_current[tile] || m_previous[tile]) ? 1 : 0;
+        m_damagedTiles += m_damaged[tile];
+    }
+
+    m_invalidateAll = false;
+
+    BuildDirtyRects();
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  DamageTracker::GetDamagedFraction
+//
+////////////////////////////////////////////////////////////////////////////////
+
+double DamageTracker::GetDamagedFraction() const
+{
+    uint64_t damagedPixels = 0;
+
+
+
+    if (m_width == 0 || m_height == 0)
+    {
+        return 0.0;
+    }
+
+    for (const PixelRect & rect : m_dirtyRects)
+    {
+        damagedPixels += uint64_t (rect.right - rect.left) * uint64_t (rect.bottom - rect.top);
+    }
+
+    return static_cast<double> (damagedPixels) / (static_cast<double> (m_width) * m_height);
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  DamageTracker::MarkRect
+//
+//  Grows the rectangle by reach on every side, clips it to the target and
+//  marks the tiles it overlaps.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void DamageTracker::MarkRect (const PixelRect & rect, int reach)
+{
+    int left   = std::max (rect.left   - reach, 0);
+    int top    = std::max (rect.top    - reach, 0);
+    int right  = std::min (rect.right  + reach, static_cast<int> (m_width));
+    int bottom = std::min (rect.bottom + reach, static_cast<int> (m_height));
+
+
+
+    if (left >= right || top >= bottom)
+    {
+        return;
+    }
+
+    for (int tileY = top / s_kTileSize; tileY <= (bottom - 1) / s_kTileSize; tileY++)
+    {
+        uint8_t * row = m_current.data() + size_t (tileY) * m_tilesX;
+
+        std::fill (row + left / s_kTileSize, row + (right - 1) / s_kTileSize + 1, uint8_t (1));
+    }
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  DamageTracker::BuildDirtyRects
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void DamageTracker::BuildDirtyRects()
+{
+    size_t previousRowStart = 0;     // First rectangle of the last row's runs
+
+
+
+    m_dirtyRects.clear();
+
+    for (UINT tileY = 0; tileY < m_tilesY; tileY++)
+    {
+        const uint8_t * row      = m_damaged.data() + size_t (tileY) * m_tilesX;
+        size_t          rowStart = m_dirtyRects.size();
+        int             top      = static_cast<int> (tileY) * s_kTileSize;
+        int             bottom   = std::min (top + s_kTileSize, static_cast<int> (m_height));
+
+        for (UINT tileX = 0; tileX < m_tilesX; )
+        {
+            if (!row[tileX])
+            {
+                tileX++;
+                continue;
+            }
+
+            UINT runEnd = tileX;
+
+            while (runEnd < m_tilesX && row[runEnd])
+            {
+                runEnd++;
+            }
+
+            m_dirtyRects.push_back ({ static_cast<int> (tileX) * s_kTileSize,
+                                      top,
+                                      std::min (static_cast<int> (runEnd) * s_kTileSize, static_cast<int> (m_width)),
+                                      bottom });
+            tileX = runEnd;
+        }
+
+        // Same runs as the row above: extend those rectangles down instead
+        size_t runCount = m_dirtyRects.size() - rowStart;
+        bool   sameRuns = runCount > 0 && rowStart - previousRowStart == runCount;
+
+        for (size_t i = 0; sameRuns && i < runCount; i++)
+        {
+            sameRuns = m_dirtyRects[previousRowStart + i].left   == m_dirtyRects[rowStart + i].left  &&
+                       m_dirtyRects[previousRowStart + i].right  == m_dirtyRects[rowStart + i].right &&
+                       m_dirtyRects[previousRowStart + i].bottom == top;
+        }
+
+        if (sameRuns)
+        {
+            for (size_t i = 0; i < runCount; i++)
+            {
+                m_dirtyRects[previousRowStart + i].bottom = bottom;
+            }
+
+            m_dirtyRects.resize (rowStart);
+        }
+        else
+        {
+            previousRowStart = rowStart;
+        }
+    }
+}
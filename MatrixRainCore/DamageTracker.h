@@ -0,0 +1,65 @@
+#pragma once
+
+#include "SoftwareRasterizer.h"
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  DamageTracker
+//
+//  Which 64x64 tiles of the render target can differ from the previous
+//  frame.  Everything outside the rain glyphs and their glow is opaque
+//  black whatever the settings, so a tile can only change when a glyph
+//  rectangle from this frame or the last one, grown by the glow's reach,
+//  touches it.
+//
+//  Update takes the frame's glyph rectangles and that reach in pixels,
+//  marks the tiles they touch, and ORs in the previous frame's marks so
+//  glyphs that moved away are repainted too.  GetDirtyRects merges the
+//  damaged tiles into rectangles suitable for a partial present.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class DamageTracker
+{
+public:
+    static constexpr int s_kTileSize = 64;
+
+    // Sizes the tile grid; the next frame is fully damaged
+    void Resize (UINT width, UINT height);
+
+    // Damage the whole target on the next Update (contents unknown)
+    void InvalidateAll() { m_invalidateAll = true; }
+
+    void Update (std::span<const PixelRect> glyphRects, int reach);
+
+    UINT GetTilesX()                              const { return m_tilesX;                              }
+    UINT GetTilesY()                              const { return m_tilesY;                              }
+    UINT GetDamagedTileCount()                    const { return m_damagedTiles;                        }
+    bool IsFullyDamaged()                         const { return m_damagedTiles == m_tilesX * m_tilesY; }
+    bool IsTileDamaged (UINT tileX, UINT tileY)   const { return m_damaged[tileY * m_tilesX + tileX] != 0; }
+
+    // Damaged pixels over all pixels (edge tiles count their clipped size)
+    double GetDamagedFraction() const;
+
+    // Damaged tiles as rectangles: runs along each tile row, merged with
+    // the row above when they span the same columns
+    std::span<const PixelRect> GetDirtyRects() const { return m_dirtyRects; }
+
+private:
+    void MarkRect (const PixelRect & rect, int reach);
+    void BuildDirtyRects();
+
+    UINT                   m_width         { 0 };
+    UINT                   m_height        { 0 };
+    UINT                   m_tilesX        { 0 };
+    UINT                   m_tilesY        { 0 };
+    UINT                   m_damagedTiles  { 0 };
+    bool                   m_invalidateAll { true };
+    std::vector<uint8_t>   m_current;        // Tiles this frame's glyphs touch
+    std::vector<uint8_t>   m_previous;       // The same for the last frame
+    std::vector<uint8_t>   m_damaged;        // m_current | m_previous
+    std::vector<PixelRect> m_dirtyRects;
+};
@@ -0,0 +1,82 @@
+#include "pch.h"
+
+#include "DeadlineTimer.h"
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  DeadlineTimer::DeadlineTimer
+//
+////////////////////////////////////////////////////////////////////////////////
+
+DeadlineTimer::DeadlineTimer() :
+    m_hTimer (CreateWaitableTimerExW (nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS))
+{
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  DeadlineTimer::~DeadlineTimer
+//
+////////////////////////////////////////////////////////////////////////////////
+
+DeadlineTimer::~DeadlineTimer()
+{
+    if (m_hTimer != nullptr)
+    {
+        CloseHandle (m_hTimer);
+    }
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  DeadlineTimer::Arm
+//
+//  Negative due times are relative, in 100 ns units.  Rounding up keeps the
+//  timer from firing before `deadline`; a deadline already past becomes the
+//  shortest relative wait.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+bool DeadlineTimer::Arm (FrameClock::time_point deadline)
+{
+    using namespace std::chrono;
+
+    using hundredNanoseconds = duration<int64_t, std::ratio<1, 10'000'000>>;
+
+
+    LARGE_INTEGER dueTime;
+
+
+
+    if (m_hTimer == nullptr)
+    {
+        return false;
+    }
+
+    dueTime.QuadPart = -std::max<int64_t> (1, ceil<hundredNanoseconds> (deadline - FrameClock::now()).count());
+
+    return SetWaitableTimer (m_hTimer, &dueTime, 0, nullptr, nullptr, FALSE) != FALSE;
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  DeadlineTimer::WaitUntil
+//
+////////////////////////////////////////////////////////////////////////////////
+
+bool DeadlineTimer::WaitUntil (FrameClock::time_point deadline)
+{
+    return Arm (deadline) && WaitForSingleObject (m_hTimer, INFINITE) == WAIT_OBJECT_0;
+}
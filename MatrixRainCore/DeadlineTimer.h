@@ -0,0 +1,46 @@
+#pragma once
+
+#include "FrameClock.h"
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  DeadlineTimer
+//
+//  Waitable timer that fires close to a FrameClock deadline.  On Windows,
+//  std::this_thread::sleep_until and std::condition_variable::wait_until
+//  wake on the system timer tick, 15.6 ms apart at the default period; a
+//  CREATE_WAITABLE_TIMER_HIGH_RESOLUTION timer fires within a fraction of
+//  a millisecond of its due time without raising the system-wide timer
+//  resolution.  Windows before 10 1803 rejects the flag: IsValid() is
+//  then false and callers keep their coarse wait.
+//
+//  GetHandle() can be waited on together with other handles, which is how
+//  RenderWakeSignal ends a deadline wait early on Notify.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class DeadlineTimer
+{
+public:
+    DeadlineTimer();
+    ~DeadlineTimer();
+
+    DeadlineTimer (const DeadlineTimer &)             = delete;
+    DeadlineTimer & operator= (const DeadlineTimer &) = delete;
+
+    bool   IsValid()   const { return m_hTimer != nullptr; }
+    HANDLE GetHandle() const { return m_hTimer;            }
+
+    // Arms the timer to signal at `deadline`, never before it; at once if
+    // it has passed
+    bool   Arm (FrameClock::time_point deadline);
+
+    // Arms the timer and blocks until it signals
+    bool   WaitUntil (FrameClock::time_point deadline);
+
+private:
+    HANDLE m_hTimer { nullptr };
+};
@@ -53,12 +53,21 @@ void DensityController::SetDpiScale (float dpiScale)
 
 
 
+void DensityController::SetColumnCoverage (float coverage)
+{
+    m_columnCoverage = std::max (coverage, 0.01f);
+}
+
+
+
+
+
 int DensityController::GetMaxPossibleStreaks() const
 {
     // Max streaks = viewport width / (character horizontal spacing / 2)
     // At 100%, streaks fill the screen with double density (overlapping allowed)
     float viewportWidth = m_viewport.GetWidth();
-    int maxStreaks      = static_cast<int> (viewportWidth / (m_characterWidth * m_dpiScale) * 2.4f);
+    int maxStreaks      = static_cast<int> (viewportWidth / (m_characterWidth * m_dpiScale) * 2.4f * m_columnCoverage);
     
     // Ensure at least minimum
     return std::max (maxStreaks, MIN_STREAKS);
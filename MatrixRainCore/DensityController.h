@@ -36,6 +36,10 @@ public:
     // Update the effective character spacing for the current monitor DPI.
     void SetDpiScale (float dpiScale);
 
+    // Scale the streak count for a viewport spanning several monitors
+    // (VirtualDesktopLayout::columnCoverage).  1 for a single monitor.
+    void SetColumnCoverage (float coverage);
+
     /// <summary>
     /// Get target number of streaks based on current percentage and viewport width.
     /// Formula: max(1, (viewportWidth / characterWidth / 2) * percentage / 100)
@@ -60,6 +64,7 @@ private:
     const Viewport & m_viewport;                                 // Reference to viewport for width calculations
     float            m_characterWidth;                           // Width of one character in pixels (horizontal spacing)
     float            m_dpiScale        { 1.0f };                 // Effective spacing = m_characterWidth * m_dpiScale
+    float            m_columnCoverage  { 1.0f };                 // Monitors stacked over each column, on average
     
     static constexpr int MIN_PERCENTAGE     = 0;
     static constexpr int MAX_PERCENTAGE     = 100;
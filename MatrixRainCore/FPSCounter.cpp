@@ -8,16 +8,25 @@
 
 void FPSCounter::Update(float deltaTime)
 {
-    m_frameTimeAccumulator += deltaTime;
+    Update (FromSeconds (deltaTime));
+}
+
+
+
+
+
+void FPSCounter::Update (FrameClock::duration frameTime)
+{
+    m_frameTimeAccumulator += frameTime;
     m_frameCount++;
 
     // Calculate FPS when we've accumulated 1 second worth of frames
     if (m_frameTimeAccumulator >= UPDATE_INTERVAL)
     {
-        m_currentFPS = static_cast<float> (m_frameCount) / m_frameTimeAccumulator;
+        m_currentFPS = static_cast<float> (m_frameCount / ToSeconds (m_frameTimeAccumulator));
         
         // Reset for next window
-        m_frameTimeAccumulator = 0.0f;
+        m_frameTimeAccumulator = FrameClock::duration::zero();
         m_frameCount           = 0;
     }
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "FrameClock.h"
+
 
 
 
@@ -17,6 +19,13 @@ public:
     /// <param name="deltaTime">Time elapsed since last frame in seconds</param>
     void Update (float deltaTime);
 
+    /// <summary>
+    /// Update the FPS counter with the current frame's FrameClock interval
+    /// (unclamped, so a stall lowers the average as it should).
+    /// </summary>
+    /// <param name="frameTime">Time elapsed since last frame</param>
+    void Update (FrameClock::duration frameTime);
+
     /// <summary>
     /// Get the current FPS value (rolling average over 1 second).
     /// </summary>
@@ -24,9 +33,9 @@ public:
     float GetFPS() const { return m_currentFPS; }
 
 private:
-    float m_currentFPS           { 0.0f };  // Current calculated FPS
-    float m_frameTimeAccumulator { 0.0f };  // Accumulated frame time
-    int   m_frameCount           { 0 };     // Frame count in current window
+    float                m_currentFPS           { 0.0f };  // Current calculated FPS
+    FrameClock::duration m_frameTimeAccumulator {};        // Accumulated frame time (integer ticks: no float drift)
+    int                  m_frameCount           { 0 };     // Frame count in current window
     
-    static constexpr float UPDATE_INTERVAL = 1.0f; // Update FPS every second
+    static constexpr FrameClock::duration UPDATE_INTERVAL = std::chrono::seconds (1); // Update FPS every second
 };
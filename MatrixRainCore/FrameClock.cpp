@@ -0,0 +1,215 @@
+#include "pch.h"
+
+#include "FrameClock.h"
+
+
+
+
+#if defined(_M_X64)
+#define MATRIXRAIN_HAS_TSC 1
+#else
+#define MATRIXRAIN_HAS_TSC 0
+#endif
+
+
+// Written only while switching sources (at startup); relaxed is enough
+static std::atomic<TimestampSource> s_source             { TimestampSource::SteadyClock };
+static std::atomic<double>          s_nanosecondsPerTick { 1.0 };
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  ReadSteadyTicks / ReadTsc
+//
+////////////////////////////////////////////////////////////////////////////////
+
+static uint64_t ReadSteadyTicks()
+{
+    return static_cast<uint64_t> (std::chrono::duration_cast<std::chrono::nanoseconds> (FrameClock::now().time_since_epoch()).count());
+}
+
+
+
+
+static uint64_t ReadTsc()
+{
+#if MATRIXRAIN_HAS_TSC
+    return __rdtsc();
+#else
+    return ReadSteadyTicks();
+#endif
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SampleTscAgainstClock
+//
+//  Brackets one TSC read between two clock reads and pairs it with their
+//  midpoint, so the pairing error is at most half the bracket.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+static void SampleTscAgainstClock (uint64_t & tsc, FrameClock::time_point & time)
+{
+    FrameClock::time_point before = FrameClock::now();
+
+    tsc = ReadTsc();
+
+    FrameClock::time_point after = FrameClock::now();
+
+    time = before + (after - before) / 2;
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  Timestamp::Read
+//
+////////////////////////////////////////////////////////////////////////////////
+
+uint64_t Timestamp::Read() noexcept
+{
+    if (s_source.load (std::memory_order_relaxed) == TimestampSource::Tsc)
+    {
+        return ReadTsc();
+    }
+
+    return ReadSteadyTicks();
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  Timestamp::ToDuration
+//
+////////////////////////////////////////////////////////////////////////////////
+
+FrameClock::duration Timestamp::ToDuration (uint64_t ticks) noexcept
+{
+    if (s_source.load (std::memory_order_relaxed) == TimestampSource::SteadyClock)
+    {
+        return std::chrono::duration_cast<FrameClock::duration> (std::chrono::nanoseconds (static_cast<int64_t> (ticks)));
+    }
+
+    double nanoseconds = static_cast<double> (ticks) * s_nanosecondsPerTick.load (std::memory_order_relaxed);
+
+    return std::chrono::duration_cast<FrameClock::duration> (std::chrono::nanoseconds (static_cast<int64_t> (nanoseconds)));
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  Timestamp::EnableTsc
+//
+////////////////////////////////////////////////////////////////////////////////
+
+bool Timestamp::EnableTsc (std::chrono::milliseconds calibrationWindow)
+{
+    uint64_t               startTsc  = 0;
+    uint64_t               endTsc    = 0;
+    FrameClock::time_point startTime;
+    FrameClock::time_point endTime;
+
+
+
+    if (!IsTscInvariant())
+    {
+        return false;
+    }
+
+    SampleTscAgainstClock (startTsc, startTime);
+    std::this_thread::sleep_for (calibrationWindow);
+    SampleTscAgainstClock (endTsc, endTime);
+
+    if (endTsc <= startTsc || endTime <= startTime)
+    {
+        return false;
+    }
+
+    s_nanosecondsPerTick.store (static_cast<double> (std::chrono::duration_cast<std::chrono::nanoseconds> (endTime - startTime).count()) /
+                                static_cast<double> (endTsc - startTsc),
+                                std::memory_order_relaxed);
+    s_source.store (TimestampSource::Tsc, std::memory_order_relaxed);
+
+    return true;
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  Timestamp::UseSteadyClock
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void Timestamp::UseSteadyClock()
+{
+    s_source.store             (TimestampSource::SteadyClock, std::memory_order_relaxed);
+    s_nanosecondsPerTick.store (1.0,                          std::memory_order_relaxed);
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  Timestamp::IsTscInvariant
+//
+//  CPUID leaf 0x80000007, EDX bit 8 ("invariant TSC") on both Intel and
+//  AMD.  Without it the counter may change rate or stop with the core.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+bool Timestamp::IsTscInvariant()
+{
+#if MATRIXRAIN_HAS_TSC
+    int registers[4] = {};
+
+    __cpuid (registers, static_cast<int> (0x80000000));
+
+    if (static_cast<unsigned> (registers[0]) < 0x80000007u)
+    {
+        return false;
+    }
+
+    __cpuid (registers, static_cast<int> (0x80000007));
+
+    return (registers[3] & (1 << 8)) != 0;
+#else
+    return false;
+#endif
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  Timestamp::GetSource / GetTicksPerSecond
+//
+////////////////////////////////////////////////////////////////////////////////
+
+TimestampSource Timestamp::GetSource()
+{
+    return s_source.load (std::memory_order_relaxed);
+}
+
+
+
+
+double Timestamp::GetTicksPerSecond()
+{
+    return 1'000'000'000.0 / s_nanosecondsPerTick.load (std::memory_order_relaxed);
+}
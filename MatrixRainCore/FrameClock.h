@@ -0,0 +1,135 @@
+#pragma once
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  FrameClock — The clock every timing path shares
+//
+//  A std::chrono clock whose time points are std::chrono::steady_clock's.
+//  Frame times, pacing deadlines, wake deadlines and the vblank times DXGI
+//  reports (QueryPerformanceCounter, which steady_clock wraps on Windows)
+//  therefore all live in one domain and compare directly, and anything
+//  written against FrameClock runs unchanged off Windows.
+//
+//  Use FrameClock for points in time that are scheduled against or handed
+//  to another thread.  For measuring how long something took, Timestamp
+//  is cheaper.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class FrameClock
+{
+public:
+    using base       = std::chrono::steady_clock;
+    using rep        = base::rep;
+    using period     = base::period;
+    using duration   = base::duration;
+    using time_point = base::time_point;
+
+    static constexpr bool is_steady = true;
+
+    static time_point now() noexcept { return base::now(); }
+};
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  Timestamp — Cheap monotonic tick count for measuring intervals
+//
+//  Read() returns ticks of the current source; only the difference of two
+//  reads means anything, and ToDuration turns it into time.
+//
+//  SteadyClock  The default: ticks are FrameClock nanoseconds.
+//
+//  Tsc          The x86 time-stamp counter, when the CPU reports it as
+//               invariant (constant rate in every P- and C-state).  A read
+//               is one RDTSC instruction with no call into the OS.  The
+//               rate is measured against FrameClock over the calibration
+//               window, to within the clock's resolution over that
+//               window; it scales intervals only, and never moves a
+//               FrameClock time point.
+//
+//  The product always runs on SteadyClock: nothing in the application
+//  calls EnableTsc.  Tsc is for benchmarks (FrameClockTests), which opt in
+//  before measuring.  Select the source before any thread reads: ticks
+//  taken from different sources do not mix.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+enum class TimestampSource
+{
+    SteadyClock,
+    Tsc
+};
+
+
+class Timestamp
+{
+public:
+    static uint64_t Read() noexcept;
+
+    static FrameClock::duration ToDuration (uint64_t ticks) noexcept;
+
+    // Switches to the TSC if this CPU has an invariant one, spending
+    // `calibrationWindow` measuring its rate.  Returns false (and leaves
+    // the source alone) otherwise.
+    static bool EnableTsc      (std::chrono::milliseconds calibrationWindow = std::chrono::milliseconds (20));
+    static void UseSteadyClock ();
+
+    static bool            IsTscInvariant();
+    static TimestampSource GetSource();
+    static double          GetTicksPerSecond();
+};
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  Conversion helpers
+//
+////////////////////////////////////////////////////////////////////////////////
+
+inline double ToSeconds (FrameClock::duration duration)
+{
+    return std::chrono::duration<double> (duration).count();
+}
+
+
+inline double ToMilliseconds (FrameClock::duration duration)
+{
+    return std::chrono::duration<double, std::milli> (duration).count();
+}
+
+
+// Truncated toward zero, the unit TimingHistogram records
+inline int64_t ToMicroseconds (FrameClock::duration duration)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds> (duration).count();
+}
+
+
+// Rounded to the nearest tick
+inline FrameClock::duration FromSeconds (double seconds)
+{
+    return std::chrono::round<FrameClock::duration> (std::chrono::duration<double> (seconds));
+}
+
+
+// One cycle at `hz` (a frame interval for a frame rate), or zero for 0 Hz
+inline FrameClock::duration PeriodForRate (unsigned hz)
+{
+    return hz == 0 ? FrameClock::duration::zero()
+                   : std::chrono::duration_cast<FrameClock::duration> (std::chrono::nanoseconds (1'000'000'000ull / hz));
+}
+
+
+// Time since an earlier Timestamp::Read
+inline FrameClock::duration ElapsedSince (uint64_t startTicks)
+{
+    return Timestamp::ToDuration (Timestamp::Read() - startTicks);
+}
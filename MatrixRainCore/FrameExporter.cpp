@@ -0,0 +1,423 @@
+#include "pch.h"
+
+#include "FrameExporter.h"
+
+
+
+
+
+FrameExporter::~FrameExporter()
+{
+    HRESULT hr = Close();
+    IGNORE_RETURN_VALUE (hr, S_OK);
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  FrameExporter::FormatFromPath
+//
+////////////////////////////////////////////////////////////////////////////////
+
+HRESULT FrameExporter::FormatFromPath (std::wstring_view path, FrameExportFormat & format)
+{
+    HRESULT      hr = S_OK;
+    std::wstring extension;
+
+
+
+    CBREx (path.size() > 4, E_INVALIDARG);
+
+    extension = path.substr (path.size() - 4);
+
+    for (auto & ch : extension)
+    {
+        ch = towlower (ch);
+    }
+
+    if (extension == L".y4m")
+    {
+        format = FrameExportFormat::Y4m;
+    }
+    else if (extension == L".ppm")
+    {
+        format = FrameExportFormat::PpmSequence;
+    }
+    else
+    {
+        CHR (E_INVALIDARG);
+    }
+
+Error:
+    return hr;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  FrameExporter::GetSequenceFramePath
+//
+//  "out.ppm", 12  ->  "out_000012.ppm"
+//
+////////////////////////////////////////////////////////////////////////////////
+
+std::wstring FrameExporter::GetSequenceFramePath (std::wstring_view path, uint64_t frameIndex)
+{
+    std::wstring_view stem = path.substr (0, path.size() - std::min<size_t> (path.size(), 4));
+
+
+
+    return std::format (L"{}_{:06}{}", stem, frameIndex, path.substr (stem.size()));
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  FrameExporter::Open
+//
+//  Each frame goes out in one write: m_encoded holds the per-frame header
+//  ("FRAME\n" for Y4M, the whole P6 header for a PPM) followed by room for
+//  the pixels, which the writer fills in place.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+HRESULT FrameExporter::Open (std::wstring_view  path,
+                             FrameExportFormat  format,
+                             UINT               width,
+                             UINT               height,
+                             UINT               framesPerSecond,
+                             size_t             queueDepth)
+{
+    HRESULT     hr         = S_OK;
+    size_t      pixelCount = size_t (width) * height;
+    std::string frameHeader;
+
+
+
+    CBREx (!m_writerThread.joinable(), E_UNEXPECTED);
+    CBREx (width > 0 && height > 0 && framesPerSecond > 0 && queueDepth > 0, E_INVALIDARG);
+
+    m_path           = path;
+    m_format         = format;
+    m_width          = width;
+    m_height         = height;
+    m_nextFill       = 0;
+    m_nextWrite      = 0;
+    m_queued         = 0;
+    m_closing        = false;
+    m_writeResult    = S_OK;
+    m_stalledSubmits = 0;
+    m_framesWritten.store (0);
+    m_slots.assign (queueDepth, std::vector<uint32_t> (pixelCount));
+
+    if (format == FrameExportFormat::Y4m)
+    {
+        std::string streamHeader = std::format ("YUV4MPEG2 W{} H{} F{}:1 Ip A1:1 C444 XCOLORRANGE=FULL\n", width, height, framesPerSecond);
+
+        m_hFile = CreateFileW (m_path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        CWR (m_hFile != INVALID_HANDLE_VALUE);
+
+        hr = WriteToFile (m_hFile, streamHeader.data(), streamHeader.size());
+        CHR (hr);
+
+        frameHeader = "FRAME\n";
+    }
+    else
+    {
+        frameHeader = std::format ("P6\n{} {}\n255\n", width, height);
+    }
+
+    m_payloadOffset = frameHeader.size();
+    m_encoded.assign (frameHeader.begin(), frameHeader.end());
+    m_encoded.resize (m_payloadOffset + 3 * pixelCount);
+
+    m_writerThread = std::thread (&FrameExporter::WriterThreadProc, this);
+
+
+Error:
+    if (FAILED (hr) && m_hFile != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle (m_hFile);
+        m_hFile = INVALID_HANDLE_VALUE;
+    }
+
+    return hr;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  FrameExporter::Submit
+//
+//  Only the copy into the slot happens on the caller's thread.  The slot is
+//  filled outside the lock: the writer never reads a slot until it has
+//  been counted as queued.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+HRESULT FrameExporter::Submit (const SoftwareSurface & frame)
+{
+    HRESULT hr   = S_OK;
+    size_t  slot = 0;
+
+
+
+    CBREx (m_writerThread.joinable(), E_UNEXPECTED);
+    CBREx (frame.GetWidth() == m_width && frame.GetHeight() == m_height, E_INVALIDARG);
+
+    {
+        std::unique_lock<std::mutex> lock (m_mutex);
+
+        if (m_queued == m_slots.size() && SUCCEEDED (m_writeResult))
+        {
+            m_stalledSubmits++;
+            m_slotFreed.wait (lock, [this] { return m_queued < m_slots.size() || FAILED (m_writeResult); });
+        }
+
+        CHR (m_writeResult);
+
+        slot = m_nextFill;
+    }
+
+    std::ranges::copy (frame.Pixels(), m_slots[slot].begin());
+
+    {
+        std::lock_guard<std::mutex> lock (m_mutex);
+
+        m_nextFill = (m_nextFill + 1) % m_slots.size();
+        m_queued++;
+    }
+
+    m_frameQueued.notify_one();
+
+Error:
+    return hr;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  FrameExporter::Close
+//
+////////////////////////////////////////////////////////////////////////////////
+
+HRESULT FrameExporter::Close()
+{
+    HRESULT hr = S_OK;
+
+
+
+    BAIL_OUT_IF (!m_writerThread.joinable(), S_OK);
+
+    {
+        std::lock_guard<std::mutex> lock (m_mutex);
+
+        m_closing = true;
+    }
+
+    m_frameQueued.notify_one();
+    m_writerThread.join();
+
+    hr = m_writeResult;
+
+
+Error:
+    if (m_hFile != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle (m_hFile);
+        m_hFile = INVALID_HANDLE_VALUE;
+    }
+
+    return hr;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  FrameExporter::ConvertToYuv444
+//
+//  JFIF coefficients in 8.8 fixed point.  The chroma offset carries the
+//  +128 bias plus rounding (128 * 256 + 128) so every intermediate stays
+//  non-negative; pure blue or red rounds to 256 and is clamped.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void FrameExporter::ConvertToYuv444 (std::span<const uint32_t> rgba, uint8_t * pY, uint8_t * pU, uint8_t * pV)
+{
+    for (size_t i = 0; i < rgba.size(); i++)
+    {
+        int r = static_cast<int> ( rgba[i]        & 0xFF);
+        int g = static_cast<int> ((rgba[i] >>  8) & 0xFF);
+        int b = static_cast<int> ((rgba[i] >> 16) & 0xFF);
+
+        pY[i] = static_cast<uint8_t> ((77 * r + 150 * g + 29 * b + 128) >> 8);
+        pU[i] = static_cast<uint8_t> (std::min ((-43 * r -  85 * g + 128 * b + 32896) >> 8, 255));
+        pV[i] = static_cast<uint8_t> (std::min ((128 * r - 107 * g -  21 * b + 32896) >> 8, 255));
+    }
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  FrameExporter::WriterThreadProc
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void FrameExporter::WriterThreadProc()
+{
+    for (;;)
+    {
+        HRESULT hr   = S_OK;
+        size_t  slot = 0;
+
+        {
+            std::unique_lock<std::mutex> lock (m_mutex);
+
+            m_frameQueued.wait (lock, [this] { return m_queued > 0 || m_closing; });
+
+            if (m_queued == 0)
+            {
+                return;
+            }
+
+            slot = m_nextWrite;
+        }
+
+        hr = WriteFrame (m_slots[slot]);
+
+        {
+            std::lock_guard<std::mutex> lock (m_mutex);
+
+            m_nextWrite = (m_nextWrite + 1) % m_slots.size();
+            m_queued--;
+
+            if (FAILED (hr))
+            {
+                m_writeResult = hr;
+            }
+        }
+
+        m_slotFreed.notify_one();
+
+        if (FAILED (hr))
+        {
+            return;
+        }
+    }
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  FrameExporter::WriteFrame
+//
+////////////////////////////////////////////////////////////////////////////////
+
+HRESULT FrameExporter::WriteFrame (const std::vector<uint32_t> & pixels)
+{
+    HRESULT   hr         = S_OK;
+    size_t    pixelCount = pixels.size();
+    uint8_t * pPayload   = m_encoded.data() + m_payloadOffset;
+    HANDLE    hFile      = m_hFile;
+
+
+
+    if (m_format == FrameExportFormat::Y4m)
+    {
+        ConvertToYuv444 (pixels, pPayload, pPayload + pixelCount, pPayload + 2 * pixelCount);
+    }
+    else
+    {
+        for (size_t i = 0; i < pixelCount; i++)
+        {
+            pPayload[3 * i + 0] = static_cast<uint8_t> ( pixels[i]        & 0xFF);
+            pPayload[3 * i + 1] = static_cast<uint8_t> ((pixels[i] >>  8) & 0xFF);
+            pPayload[3 * i + 2] = static_cast<uint8_t> ((pixels[i] >> 16) & 0xFF);
+        }
+
+        hFile = CreateFileW (GetSequenceFramePath (m_path, m_framesWritten.load()).c_str(),
+                             GENERIC_WRITE,
+                             0,
+                             nullptr,
+                             CREATE_ALWAYS,
+                             FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                             nullptr);
+        CWR (hFile != INVALID_HANDLE_VALUE);
+    }
+
+    hr = WriteToFile (hFile, m_encoded.data(), m_encoded.size());
+    CHR (hr);
+
+    m_framesWritten++;
+
+
+Error:
+    if (m_format == FrameExportFormat::PpmSequence && hFile != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle (hFile);
+    }
+
+    return hr;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  FrameExporter::WriteToFile
+//
+//  WriteFile takes a DWORD count; a 4K frame fits, but loop anyway.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+HRESULT FrameExporter::WriteToFile (HANDLE hFile, const void * pData, size_t cbData)
+{
+    HRESULT         hr        = S_OK;
+    const uint8_t * pBytes    = static_cast<const uint8_t *> (pData);
+    DWORD           cbChunk   = 0;
+    DWORD           cbWritten = 0;
+
+
+
+    while (cbData > 0)
+    {
+        BOOL fSuccess = FALSE;
+
+        cbChunk  = static_cast<DWORD> (std::min<size_t> (cbData, 1u << 30));
+        fSuccess = WriteFile (hFile, pBytes, cbChunk, &cbWritten, nullptr);
+        CWR (fSuccess);
+        CBREx (cbWritten == cbChunk, HRESULT_FROM_WIN32 (ERROR_WRITE_FAULT));
+
+        pBytes += cbWritten;
+        cbData -= cbWritten;
+    }
+
+Error:
+    return hr;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "SoftwareSurface.h"
+
+
+
+
+enum class FrameExportFormat
+{
+    Y4m,            // One YUV4MPEG2 stream, 4:4:4, full-range BT.601
+    PpmSequence     // One binary PPM (P6) per frame: <name>_000000.ppm, ...
+};
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  FrameExporter
+//
+//  Streams rendered frames to disk from a background writer thread.
+//  Submit copies the frame into one of queueDepth preallocated slots and
+//  returns; colour conversion and file writes happen on the writer.  The
+//  caller only waits when every slot is still queued, so a slow disk
+//  throttles the render loop instead of growing memory or dropping frames.
+//
+//  Frames are written in submission order.  The first write failure stops
+//  the writer; Submit and Close report it from then on.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class FrameExporter
+{
+public:
+    static constexpr size_t s_kDefaultQueueDepth = 4;
+
+    FrameExporter() = default;
+    ~FrameExporter();
+
+    FrameExporter (const FrameExporter &)             = delete;
+    FrameExporter & operator= (const FrameExporter &) = delete;
+
+    // .y4m selects Y4m, .ppm selects PpmSequence; anything else fails
+    static HRESULT FormatFromPath (std::wstring_view path, FrameExportFormat & format);
+
+    // For PpmSequence, path names the sequence: "out.ppm" writes
+    // out_000000.ppm, out_000001.ppm, ...
+    HRESULT Open   (std::wstring_view path, FrameExportFormat format, UINT width, UINT height, UINT framesPerSecond, size_t queueDepth = s_kDefaultQueueDepth);
+    HRESULT Submit (const SoftwareSurface & frame);
+
+    // Writes everything still queued, stops the writer and closes the file
+    HRESULT Close();
+
+    uint64_t GetFramesWritten()      const { return m_framesWritten.load(); }
+    uint64_t GetStalledSubmitCount() const { return m_stalledSubmits;       }
+
+    // Full-range BT.601 (JFIF) conversion into three planes
+    static void ConvertToYuv444 (std::span<const uint32_t> rgba, uint8_t * pY, uint8_t * pU, uint8_t * pV);
+
+    static std::wstring GetSequenceFramePath (std::wstring_view path, uint64_t frameIndex);
+
+private:
+    void           WriterThreadProc();
+    HRESULT        WriteFrame  (const std::vector<uint32_t> & pixels);
+    static HRESULT WriteToFile (HANDLE hFile, const void * pData, size_t cbData);
+
+    std::wstring                       m_path;
+    FrameExportFormat                  m_format          { FrameExportFormat::Y4m };
+    UINT                               m_width           { 0 };
+    UINT                               m_height          { 0 };
+    HANDLE                             m_hFile           { INVALID_HANDLE_VALUE };    // Y4m stream
+    std::vector<uint8_t>               m_encoded;                                     // Writer scratch: per-frame header, then pixels
+    size_t                             m_payloadOffset   { 0 };
+    std::thread                        m_writerThread;
+
+    // Ring of frame slots.  The submitter fills m_slots[m_nextFill] before
+    // counting it queued; the writer drains from m_nextWrite.
+    std::vector<std::vector<uint32_t>> m_slots;
+    size_t                             m_nextFill        { 0 };
+    size_t                             m_nextWrite       { 0 };
+    size_t                             m_queued          { 0 };
+    bool                               m_closing         { false };
+    HRESULT                            m_writeResult     { S_OK };
+    std::mutex                         m_mutex;
+    std::condition_variable            m_frameQueued;
+    std::condition_variable            m_slotFreed;
+
+    std::atomic<uint64_t>              m_framesWritten   { 0 };
+    uint64_t                           m_stalledSubmits  { 0 };
+};
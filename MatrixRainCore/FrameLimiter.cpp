@@ -25,9 +25,21 @@ bool ShouldEngageFrameLimiter (unsigned monitorRefreshHz)
 //
 ////////////////////////////////////////////////////////////////////////////////
 
-FrameLimiter::FrameLimiter (unsigned targetFps)
+FrameLimiter::FrameLimiter (unsigned targetFps, FramePacingMode mode) :
+    m_mode (mode)
 {
     TargetFps (targetFps);
+
+    if (m_mode == FramePacingMode::Precision)
+    {
+        m_timer.emplace();
+
+        if (!m_timer->IsValid())
+        {
+            m_timer.reset();
+            m_mode = FramePacingMode::Sleep;
+        }
+    }
 }
 
 
@@ -41,13 +53,32 @@ FrameLimiter::FrameLimiter (unsigned targetFps)
 
 void FrameLimiter::TargetFps (unsigned targetFps)
 {
-    if (targetFps == 0)
+    m_frameInterval = PeriodForRate (targetFps);
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  FrameLimiter::WaitForNextFrame
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void FrameLimiter::WaitForNextFrame()
+{
+    using clock = FrameClock;
+
+
+    clock::time_point now = clock::now();
+
+    if (m_mode == FramePacingMode::Precision)
     {
-        m_frameInterval = std::chrono::steady_clock::duration::zero();
+        WaitPrecision (now);
     }
     else
     {
-        m_frameInterval = std::chrono::nanoseconds (1'000'000'000ull / targetFps);
+        WaitSleep (now);
     }
 }
 
@@ -56,17 +87,15 @@ void FrameLimiter::TargetFps (unsigned targetFps)
 
 ////////////////////////////////////////////////////////////////////////////////
 //
-//  FrameLimiter::WaitForNextFrame
+//  FrameLimiter::WaitSleep
 //
 ////////////////////////////////////////////////////////////////////////////////
 
-void FrameLimiter::WaitForNextFrame()
+void FrameLimiter::WaitSleep (FrameClock::time_point now)
 {
-    using clock = std::chrono::steady_clock;
+    using clock = FrameClock;
 
 
-    clock::time_point now = clock::now();
-
     if (!m_lastFrameTime.has_value())
     {
         // First-ever call: no prior frame to pace against; render now.
@@ -80,7 +109,110 @@ void FrameLimiter::WaitForNextFrame()
     {
         std::this_thread::sleep_until (nextDeadline);
         now = clock::now();
+
+        m_pacingError.Record (ToMicroseconds (now - nextDeadline));
     }
 
     m_lastFrameTime = now;
 }
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  FrameLimiter::WaitPrecision
+//
+//  Deadlines advance by exactly one interval per frame, so a frame that
+//  returns late does not push every later frame back.  A frame that misses
+//  its deadline by more than a whole interval (a hitch, a debugger break)
+//  resynchronizes the schedule instead of releasing a burst of frames to
+//  catch up.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void FrameLimiter::WaitPrecision (FrameClock::time_point now)
+{
+    using clock = FrameClock;
+
+
+    if (!m_nextDeadline.has_value())
+    {
+        // First-ever call: no prior frame to pace against; render now.
+        m_nextDeadline = now + m_frameInterval;
+        return;
+    }
+
+    clock::time_point deadline = *m_nextDeadline;
+
+    if (now < deadline)
+    {
+        clock::time_point wake = deadline - m_sleepMargin;
+
+        if (now < wake)
+        {
+            // Should the timer fail, sleep instead: that frame spins
+            // longer, but is never early
+            if (!m_timer->WaitUntil (wake))
+            {
+                std::this_thread::sleep_until (wake);
+            }
+
+            now = clock::now();
+
+            CalibrateSleepMargin (now - wake);
+        }
+
+        while (now < deadline)
+        {
+            std::this_thread::yield();
+            now = clock::now();
+        }
+
+        m_pacingError.Record (ToMicroseconds (now - deadline));
+    }
+
+    m_nextDeadline = deadline + m_frameInterval;
+
+    if (now >= *m_nextDeadline)
+    {
+        m_nextDeadline = now + m_frameInterval;
+    }
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  FrameLimiter::CalibrateSleepMargin
+//
+//  An overshoot beyond the margin widens it at once (with 25% headroom) so
+//  the next frame is not late too; a smaller one narrows it by 1/16 of the
+//  difference per frame, so one lucky wake does not undo the calibration.
+//  The margin never exceeds s_kMaxSleepMargin (or half a frame at very
+//  high rates), which bounds the yield loop's CPU cost.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void FrameLimiter::CalibrateSleepMargin (FrameClock::duration overshoot)
+{
+    using namespace std::chrono;
+
+
+    static constexpr nanoseconds s_kMinSleepMargin { microseconds (50) };
+
+    nanoseconds observed = duration_cast<nanoseconds> (overshoot);
+    nanoseconds maximum  = std::max (s_kMinSleepMargin, std::min<nanoseconds> (s_kMaxSleepMargin, duration_cast<nanoseconds> (m_frameInterval) / 2));
+
+    if (observed > m_sleepMargin)
+    {
+        m_sleepMargin = observed + observed / 4;
+    }
+    else
+    {
+        m_sleepMargin -= (m_sleepMargin - observed) / 16;
+    }
+
+    m_sleepMargin = std::clamp (m_sleepMargin, s_kMinSleepMargin, maximum);
+}
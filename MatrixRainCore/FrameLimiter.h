@@ -2,6 +2,10 @@
 
 #include <chrono>
 
+#include "DeadlineTimer.h"
+#include "FrameClock.h"
+#include "TimingHistogram.h"
+
 
 // Pure predicate: should the frame limiter engage on a monitor whose
 // native refresh is the given integer Hz?  Engages only when refresh
@@ -10,24 +14,73 @@
 bool ShouldEngageFrameLimiter (unsigned monitorRefreshHz);
 
 
+// How FrameLimiter waits out the remainder of a frame.
+//
+//  Sleep      Sleeps until 1/targetFps after the previous frame.  Cheap,
+//             but each frame can land late by up to a scheduler quantum
+//             and the lateness carries into the next frame's deadline.
+//
+//  Precision  Deadlines sit on an absolute schedule (start + n/targetFps),
+//             so lateness never accumulates.  Waits on a DeadlineTimer
+//             (a high-resolution waitable timer) until a calibrated margin
+//             before the deadline, then yields in a loop until it passes.  The margin
+//             tracks the largest recent timer overshoot (a few hundred
+//             microseconds is typical) and is capped at
+//             s_kMaxSleepMargin, so the yield loop costs at most that
+//             much CPU per frame; a wake later than the cap shows up as
+//             pacing error rather than a longer spin.  Plain sleeps are
+//             never used here: at the default 15.6 ms Windows timer
+//             period they would push the margin, and the spin, to half a
+//             frame.  Where the high-resolution timer is unavailable
+//             (before Windows 10 1803) the limiter falls back to Sleep.
+
+
+enum class FramePacingMode
+{
+    Sleep,
+    Precision
+};
+
+
 // Wall-clock-based per-monitor frame pacer used when the monitor's
-// native refresh exceeds 60 Hz (see ShouldEngageFrameLimiter).  Sleeps
+// native refresh exceeds 60 Hz (see ShouldEngageFrameLimiter).  Waits
 // inside WaitForNextFrame to enforce a target frames-per-second cap.
 // The first call returns immediately (no prior frame timestamp); each
-// subsequent call sleeps until at least 1/targetFps seconds have elapsed
-// since the previous call.
+// subsequent call waits until the next frame deadline.
+//
+// Every call that has to wait records how late it returned relative to its
+// deadline, in microseconds, into GetPacingError(); frames that arrive
+// after their deadline are the renderer's lateness, not the pacer's, and
+// are not recorded.  The histogram belongs to the thread that calls
+// WaitForNextFrame.
 //
-// Uses std::chrono::steady_clock for monotonic timing.  Safe to be
+// Uses FrameClock for monotonic timing.  Safe to be
 // owned per-monitor (one instance per MonitorRenderContext).
 class FrameLimiter
 {
     public:
-        explicit FrameLimiter (unsigned targetFps);
+        static constexpr std::chrono::microseconds s_kMaxSleepMargin { 1000 };
+
+        explicit FrameLimiter (unsigned targetFps, FramePacingMode mode = FramePacingMode::Sleep);
 
         void TargetFps         (unsigned targetFps);
         void WaitForNextFrame  ();
 
+        FramePacingMode            GetMode()        const { return m_mode;        }
+        std::chrono::nanoseconds   GetSleepMargin() const { return m_sleepMargin; }
+        const TimingHistogram    & GetPacingError() const { return m_pacingError; }
+        void                       ResetPacingError()     { m_pacingError.Reset(); }
+
     private:
-        std::chrono::steady_clock::duration                m_frameInterval;
-        std::optional<std::chrono::steady_clock::time_point> m_lastFrameTime;
+        void WaitSleep            (FrameClock::time_point now);
+        void WaitPrecision        (FrameClock::time_point now);
+        void CalibrateSleepMargin (FrameClock::duration   overshoot);
+
+        FramePacingMode                       m_mode;
+        std::optional<DeadlineTimer>          m_timer;
+        FrameClock::duration                  m_frameInterval;
+        std::optional<FrameClock::time_point> m_lastFrameTime;
+        std::optional<FrameClock::time_point> m_nextDeadline;
+        std::chrono::nanoseconds              m_sleepMargin   { s_kMaxSleepMargin };
+        TimingHistogram                       m_pacingError;
 };
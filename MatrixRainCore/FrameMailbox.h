@@ -0,0 +1,74 @@
+#pragma once
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  FrameMailbox<T>
+//
+//  Single-producer, single-consumer triple buffer.  The producer fills
+//  Back() and Publish()es it; the consumer Acquire()s the newest published
+//  slot and reads it through Front().  Neither side ever waits for the
+//  other: a producer that publishes twice before the consumer looks
+//  simply replaces the unread slot, and a consumer that looks twice
+//  before the next publish keeps its current one.
+//
+//  Each side owns exactly one slot at a time and the third is parked in
+//  m_pending, so the consumer never sees a slot the producer is writing:
+//  frames cannot tear.  Slots are reused rather than reallocated, so a T
+//  whose assignment reuses its storage (a vector of streaks) costs no
+//  allocation per frame once warm.
+//
+//  The exchanges are acquire-release: a publish makes the slot's contents
+//  visible to the consumer that acquires it, and handing a slot back
+//  orders the consumer's last reads before the producer's next writes.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+class FrameMailbox
+{
+public:
+    FrameMailbox() = default;
+
+    FrameMailbox (const FrameMailbox &)             = delete;
+    FrameMailbox & operator= (const FrameMailbox &) = delete;
+
+    // Producer
+    T & Back() { return m_slots[m_back]; }
+
+    void Publish()
+    {
+        uint8_t previous = m_pending.exchange (static_cast<uint8_t> (m_back | s_kFresh), std::memory_order_acq_rel);
+
+        m_back = previous & s_kIndexMask;
+    }
+
+    // Consumer.  Returns false, keeping the current front, when nothing
+    // has been published since the last Acquire.
+    bool Acquire()
+    {
+        if ((m_pending.load (std::memory_order_relaxed) & s_kFresh) == 0)
+        {
+            return false;
+        }
+
+        uint8_t previous = m_pending.exchange (m_front, std::memory_order_acq_rel);
+
+        m_front = previous & s_kIndexMask;
+        return true;
+    }
+
+    T &       Front()       { return m_slots[m_front]; }
+    const T & Front() const { return m_slots[m_front]; }
+
+private:
+    static constexpr uint8_t s_kIndexMask = 0x03;
+    static constexpr uint8_t s_kFresh     = 0x04;
+
+    std::array<T, 3>     m_slots;
+    uint8_t              m_back    { 0 };       // Producer only
+    uint8_t              m_front   { 1 };       // Consumer only
+    std::atomic<uint8_t> m_pending { 2 };       // Slot index, plus s_kFresh once published and not yet acquired
+};
@@ -0,0 +1,69 @@
+#include "pch.h"
+
+#include "FrameTiming.h"
+
+
+
+
+
+FrameTimingPercentiles FrameTimingStats::Summarize (FrameTimingMetric metric) const
+{
+    const TimingHistogram & histogram = Get (metric);
+
+
+
+    return FrameTimingPercentiles
+    {
+        .p50Us = histogram.GetPercentile (50.0),
+        .p95Us = histogram.GetPercentile (95.0),
+        .p99Us = histogram.GetPercentile (99.0),
+        .maxUs = histogram.GetMax(),
+        .count = histogram.GetCount(),
+    };
+}
+
+
+
+
+
+void FrameTimingStats::Reset()
+{
+    *this = FrameTimingStats {};
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  FrameTimingRecorder::EndFrame
+//
+//  The first call only starts the window.  Returns true when this call
+//  closed a window and published it.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+bool FrameTimingRecorder::EndFrame (FrameClock::time_point now)
+{
+    if (!m_windowStart.has_value())
+    {
+        m_windowStart = now;
+        return false;
+    }
+
+    if (now - *m_windowStart < m_window)
+    {
+        return false;
+    }
+
+    m_current.windowSeconds = ToSeconds (now - *m_windowStart);
+    m_lastWindow            = m_current;
+
+    m_publisher.Publish (m_lastWindow);
+
+    m_current.Reset();
+    m_windowStart = now;
+
+    return true;
+}
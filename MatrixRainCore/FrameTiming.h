@@ -0,0 +1,170 @@
+#pragma once
+
+#include "FrameClock.h"
+#include "SeqLock.h"
+#include "TimingHistogram.h"
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  FrameTimingMetric — What a render thread times every frame
+//
+//  Frame          Start of one frame to the start of the next (what the
+//                 user sees as smoothness, including pacing and VSync)
+//  Simulation     MonitorRenderContext::Update (animation and overlays)
+//  InstanceBuild  Patching and uploading the rain instance buffers
+//  Present        Swap-chain Present, which absorbs the VSync wait
+//
+////////////////////////////////////////////////////////////////////////////////
+
+enum class FrameTimingMetric : uint32_t
+{
+    Frame,
+    Simulation,
+    InstanceBuild,
+    Present,
+    Count
+};
+
+
+
+struct FrameTimingPercentiles
+{
+    int64_t  p50Us = 0;
+    int64_t  p95Us = 0;
+    int64_t  p99Us = 0;
+    int64_t  maxUs = 0;
+    uint64_t count = 0;
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  FrameTimingStats — One window's histograms for every metric
+//
+//  Trivially copyable so a published window is a plain copy.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+struct FrameTimingStats
+{
+    static constexpr size_t s_kMetricCount = static_cast<size_t> (FrameTimingMetric::Count);
+
+    std::array<TimingHistogram, s_kMetricCount> histograms    {};
+    double                                      windowSeconds { 0.0 };
+    uint64_t                                    generation    { 0 };    // set by FrameTimingPublisher::Publish
+
+    void                    Record    (FrameTimingMetric metric, int64_t microseconds) { histograms[static_cast<size_t> (metric)].Record (microseconds); }
+    const TimingHistogram & Get       (FrameTimingMetric metric) const                 { return histograms[static_cast<size_t> (metric)];             }
+    FrameTimingPercentiles  Summarize (FrameTimingMetric metric) const;
+    void                    Reset();
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  FrameTimingPublisher — Lock-free double-buffered hand-off of windows
+//
+//  The render thread writes each new window into the buffer readers are
+//  not being pointed at, then advances the generation to flip them over,
+//  so a reader copying the front buffer never races the write in
+//  progress.  A reader can still be lapped (two publishes during one
+//  copy — at one window per second, a reader stalled for over a second):
+//  each buffer is a SeqLock, so it never returns a torn window, and each
+//  window carries its generation, so a reader that finds a newer window
+//  than the generation it started from retries rather than returning it
+//  ahead of the flip.  Successive reads therefore never go backwards.
+//
+//  Publish is single-writer; TryGetLatest may be called from any thread.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class FrameTimingPublisher
+{
+public:
+    void Publish (FrameTimingStats stats)
+    {
+        stats.generation = m_generation.load (std::memory_order_relaxed) + 1;
+
+        m_buffers[stats.generation & 1].Store (stats);
+        m_generation.store (stats.generation, std::memory_order_release);
+    }
+
+    // False until the first window has been published
+    bool TryGetLatest (FrameTimingStats & stats) const
+    {
+        for (;;)
+        {
+            uint64_t generation = m_generation.load (std::memory_order_acquire);
+
+            if (generation == 0)
+            {
+                return false;
+            }
+
+            stats = m_buffers[generation & 1].Load();
+
+            if (stats.generation == generation)
+            {
+                return true;
+            }
+        }
+    }
+
+    uint64_t GetGeneration() const { return m_generation.load (std::memory_order_acquire); }
+
+private:
+    std::array<SeqLock<FrameTimingStats>, 2> m_buffers;
+    std::atomic<uint64_t>                    m_generation { 0 };
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  FrameTimingRecorder — Per-context windowed recording and publication
+//
+//  The render thread records each metric as it goes and calls EndFrame
+//  once per frame; every window (one second by default, matching
+//  FPSCounter) the accumulated histograms are published and recording
+//  starts afresh, so the published percentiles describe recent frames
+//  rather than the whole session.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class FrameTimingRecorder
+{
+public:
+    explicit FrameTimingRecorder (FrameClock::duration window = std::chrono::seconds (1)) :
+        m_window (window)
+    {
+    }
+
+    // Render thread
+    void Record   (FrameTimingMetric metric, int64_t microseconds) { m_current.Record (metric, microseconds); }
+    bool EndFrame (FrameClock::time_point now);
+
+    // Render thread: the most recently completed window
+    const FrameTimingStats & GetLastWindow() const { return m_lastWindow; }
+
+    // Any thread
+    bool     TryGetPublished (FrameTimingStats & stats) const { return m_publisher.TryGetLatest (stats); }
+    uint64_t GetPublishedGeneration()                   const { return m_publisher.GetGeneration();     }
+
+private:
+    FrameClock::duration                  m_window;
+    std::optional<FrameClock::time_point> m_windowStart;
+    FrameTimingStats                      m_current;
+    FrameTimingStats                      m_lastWindow;
+    FrameTimingPublisher                  m_publisher;
+};
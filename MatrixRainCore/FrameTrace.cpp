@@ -0,0 +1,460 @@
+#include "pch.h"
+
+#include "FrameTrace.h"
+
+
+
+
+namespace
+{
+    // Rings are never freed: a ring outlives its thread so the events it
+    // holds can still be written, and is handed to the next new thread
+    struct TraceRegistry
+    {
+        std::mutex                              mutex;
+        std::vector<std::unique_ptr<TraceRing>> rings;
+        std::vector<TraceRing *>                idleRings;
+        std::map<uint32_t, std::string>         threadNames;
+        std::atomic<uint32_t>                   nextThreadId { 1 };
+        std::atomic<uint64_t>                   clearedTicks { 0 };     // Events starting earlier are dropped
+    };
+
+
+    // Deliberately leaked: threads release their rings from thread_local
+    // destructors, which can run after static destruction has begun
+    TraceRegistry & GetRegistry()
+    {
+        static TraceRegistry * s_registry = new TraceRegistry();
+
+        return *s_registry;
+    }
+
+
+    struct ThreadTraceState
+    {
+        TraceRing * ring     { nullptr };
+        uint32_t    threadId { 0 };
+        int         monitor  { -1 };
+
+        uint32_t GetThreadId()
+        {
+            if (threadId == 0)
+            {
+                threadId = GetRegistry().nextThreadId.fetch_add (1, std::memory_order_relaxed);
+            }
+
+            return threadId;
+        }
+
+        TraceRing & GetRing()
+        {
+            if (!ring)
+            {
+                TraceRegistry             & registry = GetRegistry();
+                std::lock_guard<std::mutex> lock (registry.mutex);
+
+                if (registry.idleRings.empty())
+                {
+                    registry.rings.push_back (std::make_unique<TraceRing> (FrameTrace::s_kEventsPerThread));
+                    ring = registry.rings.back().get();
+                }
+                else
+                {
+                    ring = registry.idleRings.back();
+                    registry.idleRings.pop_back();
+                }
+            }
+
+            return *ring;
+        }
+
+        ~ThreadTraceState()
+        {
+            if (ring)
+            {
+                TraceRegistry             & registry = GetRegistry();
+                std::lock_guard<std::mutex> lock (registry.mutex);
+
+                registry.idleRings.push_back (ring);
+            }
+        }
+    };
+
+
+    thread_local ThreadTraceState t_traceState;
+
+
+
+    // Microseconds from `baseTicks`, as Chrome's ts/dur fields expect
+    double TicksToMicroseconds (uint64_t ticks, uint64_t baseTicks)
+    {
+        return ToMilliseconds (Timestamp::ToDuration (ticks - baseTicks)) * 1000.0;
+    }
+
+
+    void AppendJsonString (std::string & json, std::string_view text)
+    {
+        json += '"';
+
+        for (char ch : text)
+        {
+            if (ch == '"' || ch == '\\')
+            {
+                json += '\\';
+                json += ch;
+            }
+            else if (static_cast<unsigned char> (ch) < 0x20)
+            {
+                json += std::format ("\\u{:04x}", static_cast<unsigned> (ch));
+            }
+            else
+            {
+                json += ch;
+            }
+        }
+
+        json += '"';
+    }
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  TraceRing::TraceRing
+//
+////////////////////////////////////////////////////////////////////////////////
+
+TraceRing::TraceRing (size_t capacity) :
+    m_capacity (capacity),
+    m_words    (std::make_unique<std::atomic<uint64_t>[]> (capacity * s_kWordsPerEvent))
+{
+    assert (capacity != 0 && (capacity & (capacity - 1)) == 0);
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  TraceRing::Push
+//
+//  The claim is ordered before the slot's words by the release fence, so a
+//  reader that sees any of the new words also sees the claim (Boehm, as in
+//  SeqLock).
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void TraceRing::Push (const TraceEvent & event)
+{
+    uint64_t                words[s_kWordsPerEvent] = {};
+    uint64_t                index                   = m_claimed.load (std::memory_order_relaxed);
+    std::atomic<uint64_t> * slot                    = &m_words[(index & (m_capacity - 1)) * s_kWordsPerEvent];
+
+
+
+    memcpy (words, &event, sizeof (TraceEvent));
+
+    m_claimed.store (index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence (std::memory_order_release);
+
+    for (size_t i = 0; i < s_kWordsPerEvent; i++)
+    {
+        slot[i].store (words[i], std::memory_order_relaxed);
+    }
+
+    m_committed.store (index + 1, std::memory_order_release);
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  TraceRing::CopyTo
+//
+//  Copies the last `capacity` committed events, then re-reads the claim
+//  count: any copied slot the writer has claimed again since may be torn,
+//  so the oldest events are dropped until the copy is clear of it.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void TraceRing::CopyTo (std::vector<TraceEvent> & events) const
+{
+    uint64_t end     = m_committed.load (std::memory_order_acquire);
+    uint64_t begin   = end > m_capacity ? end - m_capacity : 0;
+    size_t   first   = events.size();
+    uint64_t claimed = 0;
+    uint64_t valid   = 0;
+
+
+
+    for (uint64_t index = begin; index < end; index++)
+    {
+        const std::atomic<uint64_t> * slot                    = &m_words[(index & (m_capacity - 1)) * s_kWordsPerEvent];
+        uint64_t                      words[s_kWordsPerEvent] = {};
+        TraceEvent                    event;
+
+        for (size_t i = 0; i < s_kWordsPerEvent; i++)
+        {
+            words[i] = slot[i].load (std::memory_order_relaxed);
+        }
+
+        memcpy (&event, words, sizeof (TraceEvent));
+        events.push_back (event);
+    }
+
+    std::atomic_thread_fence (std::memory_order_acquire);
+    claimed = m_claimed.load (std::memory_order_relaxed);
+
+    // Indices below `valid` may have been overwritten during the copy
+    valid = claimed > m_capacity ? claimed - m_capacity : 0;
+
+    if (valid > begin)
+    {
+        size_t overwritten = static_cast<size_t> (std::min (valid, end) - begin);
+
+        events.erase (events.begin() + first, events.begin() + first + overwritten);
+    }
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  FrameTrace::Enable / Disable
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void FrameTrace::Enable()
+{
+    s_enabled.store (true, std::memory_order_relaxed);
+}
+
+
+
+
+void FrameTrace::Disable()
+{
+    s_enabled.store (false, std::memory_order_relaxed);
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  FrameTrace::SetThreadName
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void FrameTrace::SetThreadName (std::string name)
+{
+    uint32_t                    threadId = t_traceState.GetThreadId();
+    TraceRegistry             & registry = GetRegistry();
+    std::lock_guard<std::mutex> lock (registry.mutex);
+
+
+
+    registry.threadNames[threadId] = std::move (name);
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  FrameTrace::SetThreadMonitor
+//
+////////////////////////////////////////////////////////////////////////////////
+
+int FrameTrace::SetThreadMonitor (int monitor)
+{
+    int previous = t_traceState.monitor;
+
+
+
+    t_traceState.monitor = monitor;
+
+    return previous;
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  FrameTrace::Record
+//
+//  Takes the registry lock only for the thread's first event, to get its
+//  ring; after that a record is one ring push.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void FrameTrace::Record (const char * name, uint64_t startTicks, uint64_t endTicks)
+{
+    ThreadTraceState & state = t_traceState;
+
+
+
+    state.GetRing().Push (TraceEvent
+                          {
+                              .name       = name,
+                              .startTicks = startTicks,
+                              .endTicks   = endTicks,
+                              .threadId   = state.GetThreadId(),
+                              .monitor    = state.monitor,
+                          });
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  FrameTrace::CollectEvents
+//
+//  Every ring's events since the last Clear, in start order.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<TraceEvent> FrameTrace::CollectEvents()
+{
+    TraceRegistry         & registry     = GetRegistry();
+    uint64_t                clearedTicks = registry.clearedTicks.load (std::memory_order_relaxed);
+    std::vector<TraceEvent> events;
+
+
+
+    {
+        std::lock_guard<std::mutex> lock (registry.mutex);
+
+        for (const std::unique_ptr<TraceRing> & ring : registry.rings)
+        {
+            ring->CopyTo (events);
+        }
+    }
+
+    std::erase_if (events, [clearedTicks] (const TraceEvent & event) { return event.startTicks < clearedTicks; });
+
+    std::sort (events.begin(), events.end(), [] (const TraceEvent & a, const TraceEvent & b)
+    {
+        return a.startTicks < b.startTicks;
+    });
+
+    return events;
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  FrameTrace::FormatChromeJson
+//
+//  One complete ("X") event per zone, timed in microseconds from the
+//  earliest one, with the monitor in its args; then a thread_name
+//  metadata event for each named thread.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+std::string FrameTrace::FormatChromeJson (const std::vector<TraceEvent> & events)
+{
+    TraceRegistry & registry  = GetRegistry();
+    uint64_t        baseTicks = events.empty() ? 0 : events.front().startTicks;
+    std::string     json;
+
+
+
+    for (const TraceEvent & event : events)
+    {
+        baseTicks = std::min (baseTicks, event.startTicks);
+    }
+
+    json.reserve (128 * (events.size() + 16));
+    json += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    json += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"MatrixRain\"}}";
+
+    for (const TraceEvent & event : events)
+    {
+        json += ",\n{\"name\":";
+        AppendJsonString (json, event.name ? event.name : "");
+        json += std::format (",\"cat\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f},\"args\":{{\"monitor\":{}}}}}",
+                             event.threadId,
+                             TicksToMicroseconds (event.startTicks, baseTicks),
+                             TicksToMicroseconds (event.endTicks,   event.startTicks),
+                             event.monitor);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock (registry.mutex);
+
+        for (const auto & [threadId, name] : registry.threadNames)
+        {
+            json += std::format (",\n{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":", threadId);
+            AppendJsonString (json, name);
+            json += "}}";
+        }
+    }
+
+    json += "\n]}\n";
+
+    return json;
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  FrameTrace::WriteChromeJson
+//
+////////////////////////////////////////////////////////////////////////////////
+
+HRESULT FrameTrace::WriteChromeJson (const std::filesystem::path & path)
+{
+    HRESULT         hr   = S_OK;
+    std::string     json = FormatChromeJson (CollectEvents());
+    std::error_code ec;
+
+
+
+    if (path.has_parent_path())
+    {
+        std::filesystem::create_directories (path.parent_path(), ec);
+    }
+
+    {
+        std::ofstream file (path, std::ios::binary | std::ios::trunc);
+
+        CBREx (file.is_open(), HRESULT_FROM_WIN32 (ERROR_OPEN_FAILED));
+
+        file.write (json.data(), static_cast<std::streamsize> (json.size()));
+        file.close();
+
+        CBREx (!file.fail(), HRESULT_FROM_WIN32 (ERROR_WRITE_FAULT));
+    }
+
+
+Error:
+    return hr;
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  FrameTrace::Clear
+//
+//  Rings belong to their writers, so nothing is erased: events that
+//  started before now are just no longer collected.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void FrameTrace::Clear()
+{
+    GetRegistry().clearedTicks.store (Timestamp::Read(), std::memory_order_relaxed);
+}
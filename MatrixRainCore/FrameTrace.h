@@ -0,0 +1,178 @@
+#pragma once
+
+#include "FrameClock.h"
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  TraceEvent — One completed zone
+//
+//  `name` must outlive the trace: zones are named with string literals.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+struct TraceEvent
+{
+    const char * name       { nullptr };
+    uint64_t     startTicks { 0 };          // Timestamp::Read ticks
+    uint64_t     endTicks   { 0 };
+    uint32_t     threadId   { 0 };          // FrameTrace's id for the recording thread
+    int32_t      monitor    { -1 };         // Monitor index, or -1 for none
+};
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  TraceRing — A thread's flight recorder
+//
+//  Fixed-size ring of the most recent events.  Exactly one thread pushes
+//  (it never waits and never allocates); any thread may copy out what the
+//  ring holds at the same time.
+//
+//  Events live in relaxed atomic words, as in SeqLock.  The writer claims
+//  an index before writing a slot and commits it after; a reader copies
+//  the committed range and then drops every slot the writer may have
+//  claimed again meanwhile, so it never returns a half-overwritten event.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class TraceRing
+{
+public:
+    // `capacity` must be a power of two
+    explicit TraceRing (size_t capacity);
+
+    TraceRing (const TraceRing &)             = delete;
+    TraceRing & operator= (const TraceRing &) = delete;
+
+    // Writer only
+    void Push (const TraceEvent & event);
+
+    // Any thread: appends the events still held, oldest first
+    void CopyTo (std::vector<TraceEvent> & events) const;
+
+    size_t   GetCapacity()   const { return m_capacity;                                   }
+    uint64_t GetPushCount()  const { return m_committed.load (std::memory_order_acquire); }
+
+private:
+    static constexpr size_t s_kWordsPerEvent = (sizeof (TraceEvent) + sizeof (uint64_t) - 1) / sizeof (uint64_t);
+
+    size_t                                   m_capacity;
+    std::unique_ptr<std::atomic<uint64_t>[]> m_words;
+    std::atomic<uint64_t>                    m_claimed   { 0 };
+    std::atomic<uint64_t>                    m_committed { 0 };
+};
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  FrameTrace — Process-wide frame-loop tracing
+//
+//  TraceZones record into the calling thread's TraceRing, which FrameTrace
+//  hands out on the thread's first event and takes back when the thread
+//  exits (its events stay, tagged with their thread id).  Nothing is
+//  recorded until Enable.  While disabled, a zone costs the relaxed load
+//  and branch of IsEnabled: inlined, the compiler knows the zone holds no
+//  name on that path and drops the destructor's test.
+//
+//  WriteChromeJson snapshots every ring into Chrome trace-event JSON
+//  ("X" complete events plus thread names), which chrome://tracing and
+//  ui.perfetto.dev open directly.  It may run while threads are still
+//  recording.  Times are CPU times on the recording thread: a zone around
+//  a D3D call measures its submission, not the GPU's work.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class FrameTrace
+{
+public:
+    static constexpr size_t s_kEventsPerThread = 32768;
+
+    static bool IsEnabled() noexcept { return s_enabled.load (std::memory_order_relaxed); }
+
+    static void Enable  ();
+    static void Disable ();
+
+    // Names the calling thread in the trace ("Render (monitor 1)")
+    static void SetThreadName (std::string name);
+
+    // Monitor for zones on the calling thread that don't name one;
+    // returns the previous one
+    static int SetThreadMonitor (int monitor);
+
+    static void Record (const char * name, uint64_t startTicks, uint64_t endTicks);
+
+    static std::vector<TraceEvent> CollectEvents();
+    static std::string             FormatChromeJson (const std::vector<TraceEvent> & events);
+    static HRESULT                 WriteChromeJson  (const std::filesystem::path & path);
+
+    // Drops every recorded event (threads keep their names)
+    static void Clear();
+
+private:
+    inline static std::atomic<bool> s_enabled { false };
+};
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  TraceZone — Records the scope it lives in as one FrameTrace event
+//
+//  Naming a monitor makes it the thread's monitor for the zones nested
+//  inside, so a frame's zone tags everything under it.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class TraceZone
+{
+public:
+    explicit TraceZone (const char * name)
+    {
+        if (FrameTrace::IsEnabled())
+        {
+            m_name       = name;
+            m_startTicks = Timestamp::Read();
+        }
+    }
+
+    TraceZone (const char * name, int monitor)
+    {
+        if (FrameTrace::IsEnabled())
+        {
+            m_name            = name;
+            m_previousMonitor = FrameTrace::SetThreadMonitor (monitor);
+            m_restoreMonitor  = true;
+            m_startTicks      = Timestamp::Read();
+        }
+    }
+
+    ~TraceZone()
+    {
+        if (m_name)
+        {
+            FrameTrace::Record (m_name, m_startTicks, Timestamp::Read());
+
+            if (m_restoreMonitor)
+            {
+                FrameTrace::SetThreadMonitor (m_previousMonitor);
+            }
+        }
+    }
+
+    TraceZone (const TraceZone &)             = delete;
+    TraceZone & operator= (const TraceZone &) = delete;
+
+private:
+    const char * m_name            { nullptr };
+    uint64_t     m_startTicks      { 0 };
+    int          m_previousMonitor { -1 };
+    bool         m_restoreMonitor  { false };
+};
@@ -0,0 +1,289 @@
+#include "pch.h"
+
+#include "GlyphAtlasCache.h"
+
+
+
+
+
+namespace
+{
+    // On-disk header.  Offsets are from the start of the file; the pixel
+    // section is 64-byte aligned so the mapped pixels can be read as
+    // uint32_t (and streamed by SIMD loads) in place.
+    struct GlyphAtlasCacheHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t key;
+        uint32_t glyphCount;
+        uint32_t width;
+        uint32_t height;
+        float    spaceAdvanceWidth;
+        uint64_t glyphOffset;
+        uint64_t pixelOffset;
+        uint64_t fileSize;
+    };
+
+    static_assert (sizeof (GlyphAtlasCacheHeader) == 56, "GlyphAtlasCacheHeader layout is part of the file format");
+    static_assert (sizeof (CachedGlyph)           == 28, "CachedGlyph layout is part of the file format");
+
+    constexpr uint64_t s_kPixelAlignment = 64;
+    constexpr uint64_t s_kFnvOffsetBasis = 0xCBF29CE484222325ull;
+    constexpr uint64_t s_kFnvPrime       = 0x00000100000001B3ull;
+    constexpr char     s_kZeros[s_kPixelAlignment] = {};
+
+    // Makes temporary file names unique among this process's writers; the
+    // process ID separates them from other processes'
+    std::atomic<uint32_t> s_tempFileCounter { 0 };
+
+
+
+    template <typename T>
+    void HashValue (uint64_t & hash, const T & value)
+    {
+        uint8_t bytes[sizeof (T)];
+
+        memcpy (bytes, &value, sizeof (T));
+
+        for (uint8_t byte : bytes)
+        {
+            hash = (hash ^ byte) * s_kFnvPrime;
+        }
+    }
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  GlyphAtlasCache::ComputeKey
+//
+//  64-bit FNV-1a.  Characters are hashed as UTF-16 code units so the key
+//  does not depend on the size of wchar_t.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+uint64_t GlyphAtlasCache::ComputeKey (std::wstring_view            fontFamily,
+                                      float                        fontSize,
+                                      float                        dpiScale,
+                                      UINT                         width,
+                                      UINT                         height,
+                                      std::span<const CachedGlyph> glyphs)
+{
+    uint64_t hash = s_kFnvOffsetBasis;
+
+
+
+    HashValue (hash, s_kVersion);
+
+    for (wchar_t ch : fontFamily)
+    {
+        HashValue (hash, static_cast<uint16_t> (ch));
+    }
+
+    HashValue (hash, fontSize);
+    HashValue (hash, dpiScale);
+    HashValue (hash, static_cast<uint32_t> (width));
+    HashValue (hash, static_cast<uint32_t> (height));
+    HashValue (hash, static_cast<uint32_t> (glyphs.size()));
+
+    for (const CachedGlyph & glyph : glyphs)
+    {
+        HashValue (hash, glyph.codepoint);
+        HashValue (hash, glyph.mirrored);
+        HashValue (hash, glyph.uvMin);
+        HashValue (hash, glyph.uvMax);
+    }
+
+    return hash;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  GlyphAtlasCache::Write
+//
+////////////////////////////////////////////////////////////////////////////////
+
+HRESULT GlyphAtlasCache::Write (const std::filesystem::path & path,
+                                uint64_t                      key,
+                                std::span<const CachedGlyph>  glyphs,
+                                float                         spaceAdvanceWidth,
+                                UINT                          width,
+                                UINT                          height,
+                                std::span<const uint32_t>     pixels)
+{
+    HRESULT               hr       = S_OK;
+    GlyphAtlasCacheHeader header   = {};
+    std::filesystem::path tempPath = path;
+    std::error_code       ec;
+    uint64_t              cbGlyphs = glyphs.size_bytes();
+    uint64_t              padding  = 0;
+
+
+
+    CBREx (!path.empty() && width > 0 && height > 0 && pixels.size() == size_t (width) * height, E_INVALIDARG);
+
+    header.magic             = s_kMagic;
+    header.version           = s_kVersion;
+    header.key               = key;
+    header.glyphCount        = static_cast<uint32_t> (glyphs.size());
+    header.width             = width;
+    header.height            = height;
+    header.spaceAdvanceWidth = spaceAdvanceWidth;
+    header.glyphOffset       = sizeof (header);
+    header.pixelOffset       = (header.glyphOffset + cbGlyphs + s_kPixelAlignment - 1) & ~(s_kPixelAlignment - 1);
+    header.fileSize          = header.pixelOffset + pixels.size_bytes();
+    padding                  = header.pixelOffset - header.glyphOffset - cbGlyphs;
+
+    if (path.has_parent_path())
+    {
+        std::filesystem::create_directories (path.parent_path(), ec);
+    }
+
+    tempPath += std::format (L".{}-{}.tmp", GetCurrentProcessId(), s_tempFileCounter.fetch_add (1, std::memory_order_relaxed));
+
+    {
+        std::ofstream file (tempPath, std::ios::binary | std::ios::trunc);
+
+        CBREx (file.is_open(), HRESULT_FROM_WIN32 (ERROR_OPEN_FAILED));
+
+        file.write (reinterpret_cast<const char *> (&header),       sizeof (header));
+        file.write (reinterpret_cast<const char *> (glyphs.data()), static_cast<std::streamsize> (cbGlyphs));
+        file.write (s_kZeros,                                        static_cast<std::streamsize> (padding));
+        file.write (reinterpret_cast<const char *> (pixels.data()), static_cast<std::streamsize> (pixels.size_bytes()));
+        file.close();
+
+        CBREx (!file.fail(), HRESULT_FROM_WIN32 (ERROR_WRITE_FAULT));
+    }
+
+    std::filesystem::rename (tempPath, path, ec);
+    CBREx (!ec, HRESULT_FROM_WIN32 (ERROR_ACCESS_DENIED));
+
+
+Error:
+    if (FAILED (hr))
+    {
+        std::filesystem::remove (tempPath, ec);
+    }
+
+    return hr;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  GlyphAtlasCache::GetDefaultPath
+//
+//  Under %LOCALAPPDATA%.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+std::filesystem::path GlyphAtlasCache::GetDefaultPath (std::wstring_view name, uint64_t key)
+{
+    wchar_t szLocalAppData[MAX_PATH] = {};
+    DWORD   cch                      = GetEnvironmentVariableW (L"LOCALAPPDATA", szLocalAppData, MAX_PATH);
+
+
+
+    if (cch == 0 || cch >= MAX_PATH)
+    {
+        return {};
+    }
+
+    return std::filesystem::path (szLocalAppData) / L"MatrixRain" / std::format (L"{}-{:016x}.atlas", name, key);
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  GlyphAtlasCache::Open
+//
+//  Maps the file and points the glyph and pixel spans into the mapping.
+//  Nothing is copied; the spans live until Close.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+HRESULT GlyphAtlasCache::Open (const std::filesystem::path & path, uint64_t expectedKey)
+{
+    HRESULT                  hr       = S_OK;
+    GlyphAtlasCacheHeader    header   = {};
+    std::span<const uint8_t> bytes;
+    uint64_t                 cbGlyphs = 0;
+    uint64_t                 cbPixels = 0;
+
+
+
+    Close();
+
+    hr = m_file.Open (path);
+    CHR (hr);
+
+    bytes = m_file.Bytes();
+    CBREx (bytes.size() >= sizeof (header), HRESULT_FROM_WIN32 (ERROR_INVALID_DATA));
+
+    memcpy (&header, bytes.data(), sizeof (header));
+
+    cbGlyphs = uint64_t (header.glyphCount) * sizeof (CachedGlyph);
+    cbPixels = uint64_t (header.width) * header.height * sizeof (uint32_t);
+
+    CBREx (header.magic == s_kMagic && header.version == s_kVersion, HRESULT_FROM_WIN32 (ERROR_INVALID_DATA));
+    CBREx (header.key == expectedKey,                                HRESULT_FROM_WIN32 (ERROR_INVALID_DATA));
+    CBREx (header.fileSize == bytes.size(),                          HRESULT_FROM_WIN32 (ERROR_INVALID_DATA));
+    CBREx (header.glyphOffset % alignof (CachedGlyph) == 0 &&
+           header.glyphOffset <= bytes.size()                &&
+           cbGlyphs <= bytes.size() - header.glyphOffset,           HRESULT_FROM_WIN32 (ERROR_INVALID_DATA));
+    CBREx (header.pixelOffset % s_kPixelAlignment == 0 &&
+           header.pixelOffset <= bytes.size()           &&
+           cbPixels <= bytes.size() - header.pixelOffset,           HRESULT_FROM_WIN32 (ERROR_INVALID_DATA));
+
+    m_key               = header.key;
+    m_width             = header.width;
+    m_height            = header.height;
+    m_spaceAdvanceWidth = header.spaceAdvanceWidth;
+    m_glyphs            = { reinterpret_cast<const CachedGlyph *> (bytes.data() + header.glyphOffset), header.glyphCount };
+    m_pixels            = { reinterpret_cast<const uint32_t *>    (bytes.data() + header.pixelOffset), size_t (header.width) * header.height };
+
+
+Error:
+    if (FAILED (hr))
+    {
+        Close();
+    }
+
+    return hr;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  GlyphAtlasCache::Close
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void GlyphAtlasCache::Close()
+{
+    m_file.Close();
+
+    m_key               = 0;
+    m_width             = 0;
+    m_height            = 0;
+    m_spaceAdvanceWidth = 0.0f;
+    m_glyphs            = {};
+    m_pixels            = {};
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "MappedFile.h"
+
+
+
+
+// One glyph as stored in a cache file.  UVs are in the atlas stored with
+// it; advanceWidth is a fraction of em-height (see GlyphInfo).
+struct CachedGlyph
+{
+    uint32_t codepoint;
+    uint32_t mirrored;
+    float    uvMin[2];
+    float    uvMax[2];
+    float    advanceWidth;
+};
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  GlyphAtlasCache
+//
+//  A rasterized glyph atlas saved to disk so later launches map it instead
+//  of drawing every glyph through Direct2D and measuring it through
+//  DirectWrite.  One file holds a header, the glyph table (codepoint,
+//  mirroring, UVs, advance width) and the atlas pixels as premultiplied
+//  BGRA, ready to be handed to CreateTexture2D or to
+//  SoftwareGlyphAtlas::LoadPremultipliedBgra straight from the mapping.
+//
+//  Files are keyed by ComputeKey over everything that changes the pixels:
+//  font, size, DPI scale, atlas dimensions and the glyph layout.  Open
+//  rejects a file whose key, version, or section bounds do not match, so
+//  a stale or truncated file just means rasterizing again.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class GlyphAtlasCache
+{
+public:
+    static constexpr uint32_t s_kMagic   = 0x4341524D;     // "MRAC"
+    static constexpr uint32_t s_kVersion = 1;
+
+    // Advance widths are measured, not laid out, so they are not part of
+    // the key; everything else in the glyph table is
+    static uint64_t ComputeKey (std::wstring_view            fontFamily,
+                                float                        fontSize,
+                                float                        dpiScale,
+                                UINT                         width,
+                                UINT                         height,
+                                std::span<const CachedGlyph> glyphs);
+
+    // Writes to a temporary file and renames it over path, so a reader
+    // never sees a partial file.  Each call gets its own temporary file,
+    // so concurrent writers (preview and screensaver, two monitors) only
+    // race on the rename, and whichever lands last wins.
+    static HRESULT Write (const std::filesystem::path & path,
+                          uint64_t                      key,
+                          std::span<const CachedGlyph>  glyphs,
+                          float                         spaceAdvanceWidth,
+                          UINT                          width,
+                          UINT                          height,
+                          std::span<const uint32_t>     pixels);
+
+    // <per-user cache directory>\MatrixRain\<name>-<key>.atlas, or an
+    // empty path when there is no such directory
+    static std::filesystem::path GetDefaultPath (std::wstring_view name, uint64_t key);
+
+    HRESULT Open (const std::filesystem::path & path, uint64_t expectedKey);
+    void    Close();
+
+    bool                         IsOpen()               const { return m_file.IsOpen();    }
+    uint64_t                     GetKey()               const { return m_key;              }
+    UINT                         GetWidth()             const { return m_width;            }
+    UINT                         GetHeight()            const { return m_height;           }
+    float                        GetSpaceAdvanceWidth() const { return m_spaceAdvanceWidth; }
+    std::span<const CachedGlyph> GetGlyphs()            const { return m_glyphs;           }
+    std::span<const uint32_t>    GetPixels()            const { return m_pixels;           }
+
+private:
+    MappedFile                   m_file;
+    uint64_t                     m_key               { 0 };
+    UINT                         m_width             { 0 };
+    UINT                         m_height            { 0 };
+    float                        m_spaceAdvanceWidth { 0.0f };
+    std::span<const CachedGlyph> m_glyphs;
+    std::span<const uint32_t>    m_pixels;
+};
@@ -0,0 +1,633 @@
+#include "pch.h"
+
+#include "GlyphBlitter.h"
+#include "SimdFloat4.h"
+#include "SoftwareGlyphAtlas.h"
+#include "SoftwareSurface.h"
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  ShadePixel
+//
+//  Scalar form of the premultiplied blend for one pixel.  Used by the
+//  scalar path and for the sub-vector tails of the NEON path.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+static inline uint32_t ShadePixel (float coverage, uint32_t dst, const float shade[4], float overFactor, bool premultiply)
+{
+    float    src[4];
+    uint32_t result = 0;
+
+
+
+    for (int i = 0; i < 4; i++)
+    {
+        src[i] = std::clamp (shade[i] * coverage, 0.0f, 1.0f);
+    }
+
+    for (int i = 0; i < 4; i++)
+    {
+        float d   = static_cast<float> ((dst >> (i * 8)) & 0xFF) * (1.0f / 255.0f);
+        float out = 0.0f;
+
+        if (i < 3)
+        {
+            float p = premultiply ? src[i] * src[3] : src[i];
+
+            out = p + d * (1.0f - overFactor * src[3]);
+        }
+        else
+        {
+            out = src[3] + d * (1.0f - overFactor);
+        }
+
+        result |= static_cast<uint32_t> (std::clamp (out, 0.0f, 1.0f) * 255.0f + 0.5f) << (i * 8);
+    }
+
+    return result;
+}
+
+
+
+
+
+// floorf without the library call (no SSE4.1 round instruction in the
+// baseline x64 target); exact for the texel range an atlas can have
+static inline int FloorToInt (float value, float & whole)
+{
+    int truncated = static_cast<int> (value);
+
+
+
+    if (static_cast<float> (truncated) > value)
+    {
+        truncated--;
+    }
+
+    whole = static_cast<float> (truncated);
+    return truncated;
+}
+
+
+
+
+
+static inline float BilinearCoverage (const uint8_t * rowA, const uint8_t * rowB, int32_t texel, float fx, float fy)
+{
+    float c00    = rowA[texel];
+    float c10    = rowA[texel + 1];
+    float c01    = rowB[texel];
+    float c11    = rowB[texel + 1];
+    float top    = c00 + (c10 - c00) * fx;
+    float bottom = c01 + (c11 - c01) * fx;
+
+
+
+    return (top + (bottom - top) * fy) * (1.0f / 255.0f);
+}
+
+
+
+
+
+GlyphBlitter::GlyphBlitter() :
+    m_path (DetectBestPath())
+{
+}
+
+
+
+
+
+GlyphBlitter::GlyphBlitter (BlitPath path) :
+    m_path (IsPathSupported (path) ? path : BlitPath::Scalar)
+{
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  GlyphBlitter::DetectBestPath / IsPathSupported
+//
+//  AVX2 needs both the CPU feature bit and OS support for saving the YMM
+//  registers (OSXSAVE + XCR0 bits 1-2).
+//
+////////////////////////////////////////////////////////////////////////////////
+
+BlitPath GlyphBlitter::DetectBestPath()
+{
+    if (IsPathSupported (BlitPath::Neon))
+    {
+        return BlitPath::Neon;
+    }
+
+    if (IsPathSupported (BlitPath::Avx2))
+    {
+        return BlitPath::Avx2;
+    }
+
+    return BlitPath::Scalar;
+}
+
+
+
+
+
+bool GlyphBlitter::IsPathSupported (BlitPath path)
+{
+    switch (path)
+    {
+        case BlitPath::Neon:
+#if defined(MATRIXRAIN_SIMD_NEON)
+            return true;
+#else
+            return false;
+#endif
+
+        case BlitPath::Avx2:
+#if defined(MATRIXRAIN_SIMD_SSE2)
+        {
+            static const bool s_hasAvx2 = [] ()
+            {
+                int info[4] = {};
+
+                __cpuid (info, 0);
+                if (info[0] < 7)
+                {
+                    return false;
+                }
+
+                __cpuid (info, 1);
+                if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0)
+                {
+                    return false;
+                }
+
+                if ((_xgetbv (0) & 0x6) != 0x6)
+                {
+                    return false;
+                }
+
+                __cpuidex (info, 7, 0);
+                return (info[1] & (1 << 5)) != 0;
+            } ();
+
+            return s_hasAvx2;
+        }
+#else
+            return false;
+#endif
+
+        case BlitPath::Scalar:
+        default:
+            return true;
+    }
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  GlyphBlitter::Blit
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void GlyphBlitter::Blit (SoftwareSurface & target, const SoftwareGlyphAtlas & atlas, const GlyphQuad & quad, GlyphBlendMode mode)
+{
+    PixelRect fullTarget = { 0, 0, static_cast<int> (target.GetWidth()), static_cast<int> (target.GetHeight()) };
+
+
+
+    Blit (target, atlas, quad, mode, fullTarget);
+}
+
+
+
+
+
+void GlyphBlitter::Blit (SoftwareSurface & target, const SoftwareGlyphAtlas & atlas, const GlyphQuad & quad, GlyphBlendMode mode, const PixelRect & clip)
+{
+    BlitSetup setup;
+
+
+
+    if (!PrepareQuad (atlas, quad, mode, clip, setup))
+    {
+        return;
+    }
+
+    switch (m_path)
+    {
+        case BlitPath::Avx2:   BlitAvx2   (target, atlas, quad, setup); break;
+        case BlitPath::Neon:   BlitNeon   (target, atlas, quad, setup); break;
+        case BlitPath::Scalar:
+        default:               BlitScalar (target, atlas, quad, setup); break;
+    }
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  GlyphBlitter::PrepareQuad
+//
+//  Clips the quad (top-left rule, as in the reference), folds the blend
+//  mode into the premultiplied form and resolves the bilinear footprint of
+//  every covered column.  Column math is written exactly as the reference
+//  evaluates it so both produce the same texel and weight.
+//
+//  Clamp addressing is folded into the index: texels are clamped to
+//  [0, width - 2] and the weight set to 0 or 1 at the edges, so the kernel
+//  can always read texel and texel + 1 from one 32-bit load.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+bool GlyphBlitter::PrepareQuad (const SoftwareGlyphAtlas & atlas, const GlyphQuad & quad, GlyphBlendMode mode, const PixelRect & clip, BlitSetup & setup)
+{
+    float     quadWidth  = quad.x1 - quad.x0;
+    float     quadHeight = quad.y1 - quad.y0;
+    float     glowScale  = 1.0f + 0.3f * quad.brightness;
+    int       maxTexel   = static_cast<int> (atlas.GetWidth()) - 2;
+    int       columns    = 0;
+    PixelRect bounds;
+
+
+
+    if (!atlas.IsValid() || atlas.GetWidth() < 2 || atlas.GetHeight() < 2 || quadWidth <= 0.0f || quadHeight <= 0.0f)
+    {
+        return false;
+    }
+
+    if (!ComputeQuadPixelBounds (quad, clip, bounds))
+    {
+        return false;
+    }
+
+    setup.xStart = bounds.left;
+    setup.yStart = bounds.top;
+    setup.xEnd   = bounds.right;
+    setup.yEnd   = bounds.bottom;
+
+    setup.shade[0]    = quad.color[0] * quad.brightness * glowScale;
+    setup.shade[1]    = quad.color[1] * quad.brightness * glowScale;
+    setup.shade[2]    = quad.color[2] * quad.brightness * glowScale;
+    setup.shade[3]    = quad.color[3] * quad.brightness;
+    setup.overFactor  = (mode == GlyphBlendMode::Additive) ? 0.0f : 1.0f;
+    setup.premultiply = (mode == GlyphBlendMode::Alpha);
+
+    // Padded to a whole vector so the SIMD paths can load past the last column
+    columns = setup.xEnd - setup.xStart;
+    m_columnTexel.assign  (size_t (columns) + 8, 0);
+    m_columnWeight.assign (size_t (columns) + 8, 0.0f);
+
+    for (int i = 0; i < columns; i++)
+    {
+        float tx    = (static_cast<float> (setup.xStart + i) + 0.5f - quad.x0) / quadWidth;
+        float u     = quad.u0 + (quad.u1 - quad.u0) * tx;
+        float texX  = u * static_cast<float> (atlas.GetWidth()) - 0.5f;
+        float whole = 0.0f;
+        int   texel = FloorToInt (texX, whole);
+        float frac  = texX - whole;
+
+        if (texel < 0)
+        {
+            texel = 0;
+            frac  = 0.0f;
+        }
+        else if (texel > maxTexel)
+        {
+            texel = maxTexel;
+            frac  = 1.0f;
+        }
+
+        m_columnTexel[i]  = texel;
+        m_columnWeight[i] = frac;
+    }
+
+    return true;
+}
+
+
+
+
+
+void GlyphBlitter::ResolveRow (const SoftwareGlyphAtlas & atlas, const GlyphQuad & quad, int y, const uint8_t *& rowA, const uint8_t *& rowB, float & fy) const
+{
+    float ty     = (static_cast<float> (y) + 0.5f - quad.y0) / (quad.y1 - quad.y0);
+    float v      = quad.v0 + (quad.v1 - quad.v0) * ty;
+    float texY   = v * static_cast<float> (atlas.GetHeight()) - 0.5f;
+    float whole  = 0.0f;
+    int   texel  = FloorToInt (texY, whole);
+    int   maxRow = static_cast<int> (atlas.GetHeight()) - 2;
+
+
+
+    fy = texY - whole;
+
+    if (texel < 0)
+    {
+        texel = 0;
+        fy    = 0.0f;
+    }
+    else if (texel > maxRow)
+    {
+        texel = maxRow;
+        fy    = 1.0f;
+    }
+
+    rowA = atlas.Row (static_cast<UINT> (texel));
+    rowB = atlas.Row (static_cast<UINT> (texel + 1));
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  GlyphBlitter::BlitScalar
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void GlyphBlitter::BlitScalar (SoftwareSurface & target, const SoftwareGlyphAtlas & atlas, const GlyphQuad & quad, const BlitSetup & setup)
+{
+    for (int y = setup.yStart; y < setup.yEnd; y++)
+    {
+        uint32_t      * row  = target.Row (static_cast<UINT> (y));
+        const uint8_t * rowA = nullptr;
+        const uint8_t * rowB = nullptr;
+        float           fy   = 0.0f;
+
+
+
+        ResolveRow (atlas, quad, y, rowA, rowB, fy);
+
+        for (int x = setup.xStart; x < setup.xEnd; x++)
+        {
+            int   column   = x - setup.xStart;
+            float coverage = BilinearCoverage (rowA, rowB, m_columnTexel[column], m_columnWeight[column], fy);
+
+            if (coverage > 0.0f)
+            {
+                row[x] = ShadePixel (coverage, row[x], setup.shade, setup.overFactor, setup.premultiply);
+            }
+        }
+    }
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  AVX2 kernel
+//
+//  Eight pixels per step in SoA form: one 32-bit gather per atlas row
+//  fetches texel and texel + 1 for all eight columns, the destination is
+//  split into four channel vectors, and the result is merged back under a
+//  mask of (lane in range) & (coverage > 0) so untouched pixels keep their
+//  exact bytes, as in the reference.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#if defined(MATRIXRAIN_SIMD_SSE2)
+
+static void BlitRowAvx2 (uint32_t       * row,
+                         int              xStart,
+                         int              xEnd,
+                         const uint8_t  * rowA,
+                         const uint8_t  * rowB,
+                         float            fy,
+                         const int32_t  * columnTexel,
+                         const float    * columnWeight,
+                         const float      shade[4],
+                         float            overFactor,
+                         bool             premultiply)
+{
+    const __m256i byteMask   = _mm256_set1_epi32 (0xFF);
+    const __m256i laneIndex  = _mm256_setr_epi32 (0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256  zero       = _mm256_setzero_ps();
+    const __m256  one        = _mm256_set1_ps (1.0f);
+    const __m256  toUnit     = _mm256_set1_ps (1.0f / 255.0f);
+    const __m256  toByte     = _mm256_set1_ps (255.0f);
+    const __m256  half       = _mm256_set1_ps (0.5f);
+    const __m256  weightY    = _mm256_set1_ps (fy);
+    const __m256  shadeR     = _mm256_set1_ps (shade[0]);
+    const __m256  shadeG     = _mm256_set1_ps (shade[1]);
+    const __m256  shadeB     = _mm256_set1_ps (shade[2]);
+    const __m256  shadeA     = _mm256_set1_ps (shade[3]);
+    const __m256  over       = _mm256_set1_ps (overFactor);
+    const __m256  alphaKeep  = _mm256_set1_ps (1.0f - overFactor);
+
+
+
+    for (int x = xStart; x < xEnd; x += 8)
+    {
+        int     column   = x - xStart;
+        __m256i lanes    = _mm256_cmpgt_epi32 (_mm256_set1_epi32 (xEnd - x), laneIndex);
+        __m256i texel    = _mm256_loadu_si256 (reinterpret_cast<const __m256i *> (columnTexel + column));
+        __m256  fx       = _mm256_loadu_ps (columnWeight + column);
+        __m256i wordA    = _mm256_i32gather_epi32 (reinterpret_cast<const int *> (rowA), texel, 1);
+        __m256i wordB    = _mm256_i32gather_epi32 (reinterpret_cast<const int *> (rowB), texel, 1);
+        __m256  c00      = _mm256_cvtepi32_ps (_mm256_and_si256 (wordA, byteMask));
+        __m256  c10      = _mm256_cvtepi32_ps (_mm256_and_si256 (_mm256_srli_epi32 (wordA, 8), byteMask));
+        __m256  c01      = _mm256_cvtepi32_ps (_mm256_and_si256 (wordB, byteMask));
+        __m256  c11      = _mm256_cvtepi32_ps (_mm256_and_si256 (_mm256_srli_epi32 (wordB, 8), byteMask));
+        __m256  top      = _mm256_add_ps (c00, _mm256_mul_ps (_mm256_sub_ps (c10, c00), fx));
+        __m256  bottom   = _mm256_add_ps (c01, _mm256_mul_ps (_mm256_sub_ps (c11, c01), fx));
+        __m256  coverage = _mm256_mul_ps (_mm256_add_ps (top, _mm256_mul_ps (_mm256_sub_ps (bottom, top), weightY)), toUnit);
+        __m256i write    = _mm256_and_si256 (lanes, _mm256_castps_si256 (_mm256_cmp_ps (coverage, zero, _CMP_GT_OQ)));
+
+        if (_mm256_testz_si256 (write, write))
+        {
+            continue;
+        }
+
+        __m256i dst    = _mm256_maskload_epi32 (reinterpret_cast<const int *> (row + x), lanes);
+        __m256  dstR   = _mm256_mul_ps (_mm256_cvtepi32_ps (_mm256_and_si256 (dst, byteMask)),                           toUnit);
+        __m256  dstG   = _mm256_mul_ps (_mm256_cvtepi32_ps (_mm256_and_si256 (_mm256_srli_epi32 (dst, 8),  byteMask)),  toUnit);
+        __m256  dstB   = _mm256_mul_ps (_mm256_cvtepi32_ps (_mm256_and_si256 (_mm256_srli_epi32 (dst, 16), byteMask)),  toUnit);
+        __m256  dstA   = _mm256_mul_ps (_mm256_cvtepi32_ps (_mm256_srli_epi32 (dst, 24)),                                toUnit);
+        __m256  srcR   = _mm256_min_ps (_mm256_max_ps (_mm256_mul_ps (shadeR, coverage), zero), one);
+        __m256  srcG   = _mm256_min_ps (_mm256_max_ps (_mm256_mul_ps (shadeG, coverage), zero), one);
+        __m256  srcB   = _mm256_min_ps (_mm256_max_ps (_mm256_mul_ps (shadeB, coverage), zero), one);
+        __m256  srcA   = _mm256_min_ps (_mm256_max_ps (_mm256_mul_ps (shadeA, coverage), zero), one);
+        __m256  keep   = _mm256_sub_ps (one, _mm256_mul_ps (over, srcA));
+
+        if (premultiply)
+        {
+            srcR = _mm256_mul_ps (srcR, srcA);
+            srcG = _mm256_mul_ps (srcG, srcA);
+            srcB = _mm256_mul_ps (srcB, srcA);
+        }
+
+        __m256  outR   = _mm256_add_ps (srcR, _mm256_mul_ps (dstR, keep));
+        __m256  outG   = _mm256_add_ps (srcG, _mm256_mul_ps (dstG, keep));
+        __m256  outB   = _mm256_add_ps (srcB, _mm256_mul_ps (dstB, keep));
+        __m256  outA   = _mm256_add_ps (srcA, _mm256_mul_ps (dstA, alphaKeep));
+        __m256i byteR  = _mm256_cvttps_epi32 (_mm256_add_ps (_mm256_mul_ps (_mm256_min_ps (_mm256_max_ps (outR, zero), one), toByte), half));
+        __m256i byteG  = _mm256_cvttps_epi32 (_mm256_add_ps (_mm256_mul_ps (_mm256_min_ps (_mm256_max_ps (outG, zero), one), toByte), half));
+        __m256i byteB  = _mm256_cvttps_epi32 (_mm256_add_ps (_mm256_mul_ps (_mm256_min_ps (_mm256_max_ps (outB, zero), one), toByte), half));
+        __m256i byteA  = _mm256_cvttps_epi32 (_mm256_add_ps (_mm256_mul_ps (_mm256_min_ps (_mm256_max_ps (outA, zero), one), toByte), half));
+        __m256i packed = _mm256_or_si256 (_mm256_or_si256 (byteR, _mm256_slli_epi32 (byteG, 8)),
+                                          _mm256_or_si256 (_mm256_slli_epi32 (byteB, 16), _mm256_slli_epi32 (byteA, 24)));
+
+        _mm256_maskstore_epi32 (reinterpret_cast<int *> (row + x), write, packed);
+    }
+}
+
+#endif
+
+
+
+
+
+void GlyphBlitter::BlitAvx2 (SoftwareSurface & target, const SoftwareGlyphAtlas & atlas, const GlyphQuad & quad, const BlitSetup & setup)
+{
+#if defined(MATRIXRAIN_SIMD_SSE2)
+    for (int y = setup.yStart; y < setup.yEnd; y++)
+    {
+        const uint8_t * rowA = nullptr;
+        const uint8_t * rowB = nullptr;
+        float           fy   = 0.0f;
+
+
+
+        ResolveRow (atlas, quad, y, rowA, rowB, fy);
+
+        BlitRowAvx2 (target.Row (static_cast<UINT> (y)),
+                     setup.xStart,
+                     setup.xEnd,
+                     rowA,
+                     rowB,
+                     fy,
+                     m_columnTexel.data(),
+                     m_columnWeight.data(),
+                     setup.shade,
+                     setup.overFactor,
+                     setup.premultiply);
+    }
+
+    _mm256_zeroupper();
+#else
+    BlitScalar (target, atlas, quad, setup);
+#endif
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  GlyphBlitter::BlitNeon
+//
+//  Four pixels per step.  NEON has no gather, so the four bilinear
+//  footprints are fetched with scalar loads and the shading and blend run
+//  in AoS-to-SoA vectors; remaining columns use the scalar pixel.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void GlyphBlitter::BlitNeon (SoftwareSurface & target, const SoftwareGlyphAtlas & atlas, const GlyphQuad & quad, const BlitSetup & setup)
+{
+#if defined(MATRIXRAIN_SIMD_NEON)
+    const float32x4_t zero      = vdupq_n_f32 (0.0f);
+    const float32x4_t one       = vdupq_n_f32 (1.0f);
+    const float32x4_t over      = vdupq_n_f32 (setup.overFactor);
+    const float32x4_t alphaKeep = vdupq_n_f32 (1.0f - setup.overFactor);
+    const uint32x4_t  byteMask  = vdupq_n_u32 (0xFF);
+
+
+
+    for (int y = setup.yStart; y < setup.yEnd; y++)
+    {
+        uint32_t      * row  = target.Row (static_cast<UINT> (y));
+        const uint8_t * rowA = nullptr;
+        const uint8_t * rowB = nullptr;
+        float           fy   = 0.0f;
+        int             x    = setup.xStart;
+
+
+
+        ResolveRow (atlas, quad, y, rowA, rowB, fy);
+
+        for (; x + 4 <= setup.xEnd; x += 4)
+        {
+            int         column = x - setup.xStart;
+            float       coverageLanes[4];
+            float32x4_t coverage;
+
+            for (int lane = 0; lane < 4; lane++)
+            {
+                coverageLanes[lane] = BilinearCoverage (rowA, rowB, m_columnTexel[column + lane], m_columnWeight[column + lane], fy);
+            }
+
+            coverage = vld1q_f32 (coverageLanes);
+
+            uint32x4_t write = vcgtq_f32 (coverage, zero);
+
+            if (vmaxvq_u32 (write) == 0)
+            {
+                continue;
+            }
+
+            uint32x4_t  dst  = vld1q_u32 (row + x);
+            float32x4_t dstR = vmulq_n_f32 (vcvtq_f32_u32 (vandq_u32 (dst, byteMask)),                  1.0f / 255.0f);
+            float32x4_t dstG = vmulq_n_f32 (vcvtq_f32_u32 (vandq_u32 (vshrq_n_u32 (dst, 8),  byteMask)), 1.0f / 255.0f);
+            float32x4_t dstB = vmulq_n_f32 (vcvtq_f32_u32 (vandq_u32 (vshrq_n_u32 (dst, 16), byteMask)), 1.0f / 255.0f);
+            float32x4_t dstA = vmulq_n_f32 (vcvtq_f32_u32 (vshrq_n_u32 (dst, 24)),                       1.0f / 255.0f);
+            float32x4_t srcR = vminq_f32 (vmaxq_f32 (vmulq_n_f32 (coverage, setup.shade[0]), zero), one);
+            float32x4_t srcG = vminq_f32 (vmaxq_f32 (vmulq_n_f32 (coverage, setup.shade[1]), zero), one);
+            float32x4_t srcB = vminq_f32 (vmaxq_f32 (vmulq_n_f32 (coverage, setup.shade[2]), zero), one);
+            float32x4_t srcA = vminq_f32 (vmaxq_f32 (vmulq_n_f32 (coverage, setup.shade[3]), zero), one);
+            float32x4_t keep = vsubq_f32 (one, vmulq_f32 (over, srcA));
+
+            if (setup.premultiply)
+            {
+                srcR = vmulq_f32 (srcR, srcA);
+                srcG = vmulq_f32 (srcG, srcA);
+                srcB = vmulq_f32 (srcB, srcA);
+            }
+
+            auto toByte = [&] (float32x4_t value)
+            {
+                float32x4_t clamped = vminq_f32 (vmaxq_f32 (value, zero), one);
+
+                return vcvtq_u32_f32 (vaddq_f32 (vmulq_n_f32 (clamped, 255.0f), vdupq_n_f32 (0.5f)));
+            };
+
+            uint32x4_t packed = vorrq_u32 (vorrq_u32 (toByte (vaddq_f32 (srcR, vmulq_f32 (dstR, keep))),
+                                                      vshlq_n_u32 (toByte (vaddq_f32 (srcG, vmulq_f32 (dstG, keep))), 8)),
+                                           vorrq_u32 (vshlq_n_u32 (toByte (vaddq_f32 (srcB, vmulq_f32 (dstB, keep))), 16),
+                                                      vshlq_n_u32 (toByte (vaddq_f32 (srcA, vmulq_f32 (dstA, alphaKeep))), 24)));
+
+            vst1q_u32 (row + x, vbslq_u32 (write, packed, dst));
+        }
+
+        for (; x < setup.xEnd; x++)
+        {
+            int   column   = x - setup.xStart;
+            float coverage = BilinearCoverage (rowA, rowB, m_columnTexel[column], m_columnWeight[column], fy);
+
+            if (coverage > 0.0f)
+            {
+                row[x] = ShadePixel (coverage, row[x], setup.shade, setup.overFactor, setup.premultiply);
+            }
+        }
+    }
+#else
+    BlitScalar (target, atlas, quad, setup);
+#endif
+}
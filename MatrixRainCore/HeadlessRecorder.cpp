@@ -0,0 +1,99 @@
+#include "pch.h"
+
+#include "HeadlessRecorder.h"
+
+#include "AnimationSystem.h"
+#include "CharacterSet.h"
+#include "DensityController.h"
+#include "FrameClock.h"
+#include "FrameExporter.h"
+#include "SoftwareRenderSystem.h"
+#include "Viewport.h"
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  HeadlessRecorder::Record
+//
+//  CharacterSet::Initialize lays out the glyph UV grid the procedural atlas
+//  is drawn on, so neither a font stack nor a D3D device is needed.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+HRESULT HeadlessRecorder::Record (const HeadlessRecordOptions & options, HeadlessRecordStats & stats)
+{
+    using Clock = FrameClock;
+
+    HRESULT              hr            = S_OK;
+    FrameExportFormat    format        = FrameExportFormat::Y4m;
+    float                frameSeconds  = 1.0f / static_cast<float> (std::max (1u, options.framesPerSecond));
+    UINT                 threadCount   = options.rasterThreadCount ? options.rasterThreadCount : std::max (1u, std::thread::hardware_concurrency());
+    Clock::time_point    start         = Clock::now();
+    Clock::duration      renderTime    {};
+    Viewport             viewport;
+    DensityController    densityController (viewport, 16.0f);
+    AnimationSystem      animationSystem;
+    SoftwareRenderSystem renderSystem (options.width, options.height);
+    FrameExporter        exporter;
+    RenderParams         params;
+
+
+
+    CBREx (options.width > 0 && options.height > 0 && options.frameCount > 0 && options.framesPerSecond > 0, E_INVALIDARG);
+
+    hr = FrameExporter::FormatFromPath (options.outputPath, format);
+    CHR (hr);
+
+    CBREx (CharacterSet::GetInstance().Initialize(), E_FAIL);
+
+    viewport.Resize (static_cast<float> (options.width), static_cast<float> (options.height));
+    densityController.SetPercentage (options.densityPercent);
+
+    animationSystem.Seed              (options.seed);
+    animationSystem.Initialize        (viewport, densityController);
+    animationSystem.SetAnimationSpeed (options.animationSpeedPercent);
+
+    renderSystem.BuildGlyphAtlas();
+    renderSystem.SetRasterThreadCount (threadCount);
+
+    hr = exporter.Open (options.outputPath, format, options.width, options.height, options.framesPerSecond);
+    CHR (hr);
+
+    params.rainPercentage = options.densityPercent;
+
+    for (UINT frame = 0; frame < options.frameCount; frame++)
+    {
+        Clock::time_point frameStart = Clock::now();
+
+        animationSystem.Update (frameSeconds);
+
+        params.elapsedTime     = static_cast<float> (frame) * frameSeconds;
+        params.streakCount     = static_cast<int> (animationSystem.GetActiveStreakCount());
+        params.activeHeadCount = static_cast<int> (animationSystem.GetActiveHeadCount());
+
+        renderSystem.Render (animationSystem, viewport, params);
+
+        hr = renderSystem.Present();
+        CHR (hr);
+
+        renderTime += Clock::now() - frameStart;
+
+        hr = exporter.Submit (renderSystem.GetPresentedSurface());
+        CHR (hr);
+    }
+
+    hr = exporter.Close();
+    CHR (hr);
+
+
+Error:
+    stats.framesWritten  = exporter.GetFramesWritten();
+    stats.stalledSubmits = exporter.GetStalledSubmitCount();
+    stats.renderSeconds  = ToSeconds (renderTime);
+    stats.totalSeconds   = ToSeconds (Clock::now() - start);
+
+    return hr;
+}
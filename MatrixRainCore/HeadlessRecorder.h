@@ -0,0 +1,49 @@
+#pragma once
+
+
+
+
+struct HeadlessRecordOptions
+{
+    std::wstring outputPath;                    // .y4m stream or .ppm sequence name
+    UINT         width                 { 1920 };
+    UINT         height                { 1080 };
+    UINT         frameCount            { 600 };
+    UINT         framesPerSecond       { 60 };
+    uint32_t     seed                  { 1 };
+    int          densityPercent        { 50 };  // ScreenSaverSettings::DEFAULT_DENSITY_PERCENT
+    int          animationSpeedPercent { 75 };  // ScreenSaverSettings::DEFAULT_ANIMATION_SPEED_PERCENT
+    UINT         rasterThreadCount     { 0 };   // 0 = one per hardware thread
+};
+
+
+
+
+struct HeadlessRecordStats
+{
+    uint64_t framesWritten  { 0 };
+    uint64_t stalledSubmits { 0 };      // Frames that waited for a free export slot
+    double   renderSeconds  { 0.0 };    // Simulation + rendering only
+    double   totalSeconds   { 0.0 };    // Open to final flush
+};
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  HeadlessRecorder
+//
+//  Renders rain with no window or GPU: AnimationSystem stepped at a fixed
+//  1 / framesPerSecond, drawn by SoftwareRenderSystem, and streamed out by
+//  FrameExporter.  Every random source is seeded from options.seed, and
+//  the CPU renderer is bit-identical at any thread count, so a given set
+//  of options always produces the same file.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class HeadlessRecorder
+{
+public:
+    static HRESULT Record (const HeadlessRecordOptions & options, HeadlessRecordStats & stats);
+};
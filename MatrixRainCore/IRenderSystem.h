@@ -54,6 +54,7 @@ public:
     virtual void SetBlurPasses    (int passes)                  = 0;
     virtual void SetBloomResolution (int divisor)               = 0;
     virtual void SetBlurTaps      (int taps)                    = 0;
+    virtual void SetBloomAlgorithm (int algorithm)              = 0;
 
     // Fixed character scale that bypasses viewport-based scaling.
     virtual void SetCharacterScaleOverride (float scale) = 0;
@@ -0,0 +1,340 @@
+#include "pch.h"
+
+#include "InstanceStore.h"
+#include "AnimationSystem.h"
+#include "CharacterInstance.h"
+#include "CharacterSet.h"
+#include "CharacterStreak.h"
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  InstanceStore::BuildStaticRecord
+//
+//  White (lead) characters keep their own color; everything else is tinted
+//  with the scheme color from the shader constant.  Brightness travels in
+//  the per-frame stream and depth only affects stream order.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void InstanceStore::BuildStaticRecord (const CharacterInstance & character, const Vector3 & streakPos, RainInstanceStatic & record)
+{
+    const GlyphInfo & glyph   = CharacterSet::GetInstance().GetGlyph (character.glyphIndex);
+    bool              isWhite = (character.color.r > 0.9f && character.color.g > 0.9f && character.color.b > 0.9f);
+
+
+
+    record.position[0] = streakPos.x + character.positionOffset.x;
+    record.position[1] = character.positionOffset.y;
+    record.scale[0]    = character.scale;
+    record.scale[1]    = character.scale;
+    record.uvMin[0]    = glyph.uvMin.x;
+    record.uvMin[1]    = glyph.uvMin.y;
+    record.uvMax[0]    = glyph.uvMax.x;
+    record.uvMax[1]    = glyph.uvMax.y;
+
+    // Trail rgb is irrelevant once tinted; zero it so scheme changes in
+    // CharacterStreak never show up as a record difference
+    record.color[0]    = isWhite ? character.color.r : 0.0f;
+    record.color[1]    = isWhite ? character.color.g : 0.0f;
+    record.color[2]    = isWhite ? character.color.b : 0.0f;
+    record.color[3]    = character.color.a;
+    record.schemeTint  = isWhite ? 0.0f : 1.0f;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  InstanceStore::Update
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void InstanceStore::Update (const AnimationSystem & animationSystem)
+{
+    const auto & overlays = animationSystem.GetOverlayCharacters();
+
+
+
+    m_frame++;
+    m_stream.clear();
+
+    m_sortScratch.clear();
+
+    for (const CharacterStreak & streak : animationSystem.GetStreaks())
+    {
+        m_sortScratch.push_back (&streak);
+    }
+
+    // Back-to-front (far to near) for proper alpha blending
+    std::stable_sort (m_sortScratch.begin(), m_sortScratch.end(),
+        [](const CharacterStreak * a, const CharacterStreak * b)
+        {
+            return a->GetPosition().z > b->GetPosition().z;
+        });
+
+    for (const CharacterStreak * streak : m_sortScratch)
+    {
+        StreakSlots & slots     = m_streakSlots[streak->GetID()];
+        Vector3       streakPos = streak->GetPosition();
+
+
+
+        BeginStreak (slots);
+
+        for (const CharacterInstance & character : streak->GetCharacters())
+        {
+            PlaceCharacter (slots, character.sequence, character, streakPos);
+        }
+
+        EndStreak (slots);
+    }
+
+    // Overlay characters draw on top of every streak
+    if (!overlays.empty())
+    {
+        StreakSlots & slots = m_streakSlots[s_kOverlayStreakId];
+
+
+
+        BeginStreak (slots);
+
+        for (size_t i = 0; i < overlays.size(); i++)
+        {
+            PlaceCharacter (slots, i, overlays[i].character, overlays[i].position);
+        }
+
+        EndStreak (slots);
+    }
+
+    // Streaks that despawned since the last frame give their slots back
+    for (auto it = m_streakSlots.begin(); it != m_streakSlots.end(); )
+    {
+        if (it->second.lastSeenFrame == m_frame)
+        {
+            ++it;
+            continue;
+        }
+
+        for (const SlotEntry & entry : it->second.entries)
+        {
+            ReleaseSlot (entry.slot);
+        }
+
+        it = m_streakSlots.erase (it);
+    }
+
+    BuildDirtySpans();
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  InstanceStore::BeginStreak / PlaceCharacter / EndStreak
+//
+//  Merge-walks the streak's previous (sequence, slot) list against its
+//  current characters.  Both are ascending by sequence because characters
+//  are only ever appended at the head and erased from either end, so each
+//  character either finds its old slot at the cursor or is new.  Entries
+//  the cursor skips over belong to characters that were erased.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void InstanceStore::BeginStreak (StreakSlots & slots)
+{
+    slots.lastSeenFrame = m_frame;
+    m_entryCursor       = 0;
+    m_entryScratch.clear();
+}
+
+
+
+
+
+void InstanceStore::PlaceCharacter (StreakSlots & slots, uint64_t sequence, const CharacterInstance & character, const Vector3 & streakPos)
+{
+    RainInstanceStatic record;
+    uint32_t           slot    = 0;
+    bool               isFresh = true;
+
+
+
+    while (m_entryCursor < slots.entries.size() && slots.entries[m_entryCursor].sequence < sequence)
+    {
+        ReleaseSlot (slots.entries[m_entryCursor].slot);
+        m_entryCursor++;
+    }
+
+    if (m_entryCursor < slots.entries.size() && slots.entries[m_entryCursor].sequence == sequence)
+    {
+        slot    = slots.entries[m_entryCursor].slot;
+        isFresh = false;
+        m_entryCursor++;
+    }
+    else
+    {
+        slot = AllocateSlot();
+    }
+
+    BuildStaticRecord (character, streakPos, record);
+
+    if (isFresh || memcmp (&m_slots[slot], &record, sizeof (record)) != 0)
+    {
+        m_slots[slot] = record;
+        MarkDirty (slot);
+    }
+
+    m_entryScratch.push_back ({ sequence, slot });
+    m_stream.push_back ({ slot, character.brightness });
+}
+
+
+
+
+
+void InstanceStore::EndStreak (StreakSlots & slots)
+{
+    for (size_t i = m_entryCursor; i < slots.entries.size(); i++)
+    {
+        ReleaseSlot (slots.entries[i].slot);
+    }
+
+    slots.entries.swap (m_entryScratch);
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  InstanceStore::AllocateSlot
+//
+////////////////////////////////////////////////////////////////////////////////
+
+uint32_t InstanceStore::AllocateSlot()
+{
+    uint32_t slot = 0;
+
+
+
+    if (!m_freeSlots.empty())
+    {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+    else
+    {
+        slot = static_cast<uint32_t> (m_slots.size());
+
+        m_slots.emplace_back();
+        m_slotDirty.push_back (0);
+    }
+
+    return slot;
+}
+
+
+
+
+
+void InstanceStore::ReleaseSlot (uint32_t slot)
+{
+    // Nothing to upload: a released slot is simply no longer referenced by
+    // the stream.  Its next owner rewrites it and marks it dirty.
+    m_freeSlots.push_back (slot);
+}
+
+
+
+
+
+void InstanceStore::MarkDirty (uint32_t slot)
+{
+    if (!m_slotDirty[slot])
+    {
+        m_slotDirty[slot] = 1;
+        m_dirtySlots.push_back (slot);
+    }
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  InstanceStore::BuildDirtySpans
+//
+//  Sorts this frame's dirty slots and coalesces them into upload spans,
+//  bridging clean gaps of up to s_kSpanMergeGap slots.  Also fills in the
+//  upload statistics for the frame.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void InstanceStore::BuildDirtySpans()
+{
+    size_t coveredSlots = 0;
+
+
+
+    m_dirtySpans.clear();
+
+    std::sort (m_dirtySlots.begin(), m_dirtySlots.end());
+
+    for (uint32_t slot : m_dirtySlots)
+    {
+        m_slotDirty[slot] = 0;
+
+        if (!m_dirtySpans.empty())
+        {
+            InstanceSlotSpan & last = m_dirtySpans.back();
+
+            if (slot <= last.first + last.count + s_kSpanMergeGap)
+            {
+                last.count = slot - last.first + 1;
+                continue;
+            }
+        }
+
+        m_dirtySpans.push_back ({ slot, 1 });
+    }
+
+    for (const InstanceSlotSpan & span : m_dirtySpans)
+    {
+        coveredSlots += span.count;
+    }
+
+    m_uploadStats.instanceCount    = m_stream.size();
+    m_uploadStats.dirtySlotCount   = m_dirtySlots.size();
+    m_uploadStats.spanCount        = m_dirtySpans.size();
+    m_uploadStats.staticBytes      = coveredSlots * sizeof (RainInstanceStatic);
+    m_uploadStats.streamBytes      = m_stream.size() * sizeof (RainInstanceStream);
+    m_uploadStats.fullRebuildBytes = m_stream.size() * sizeof (RainInstanceStatic);
+
+    m_dirtySlots.clear();
+}
+
+
+
+
+
+void InstanceStore::Clear()
+{
+    m_slots.clear();
+    m_freeSlots.clear();
+    m_dirtySlots.clear();
+    m_slotDirty.clear();
+    m_dirtySpans.clear();
+    m_stream.clear();
+    m_streakSlots.clear();
+    m_uploadStats = {};
+}
@@ -0,0 +1,198 @@
+#pragma once
+
+
+
+
+
+#include "Math.h"
+
+
+
+
+
+class AnimationSystem;
+class CharacterInstance;
+class CharacterStreak;
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  RainInstanceStatic
+//
+//  Per-slot record that only changes when a character drops into a new cell,
+//  mutates to a different glyph, or turns from white (lead) to the scheme
+//  color.  Layout matches the RainInstance StructuredBuffer element in the
+//  rain vertex shader (64 bytes, 16-byte aligned).
+//
+//  Depth is deliberately absent: the projection has no depth test, so Z only
+//  decides draw order, and that order is carried by the per-frame stream.
+//  The scheme color is a shader constant; schemeTint selects between it and
+//  the stored color so a ColorCycle sweep never dirties a slot.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+struct alignas(16) RainInstanceStatic
+{
+    float position[2]  = {};       // Top-left of the quad (x from streak, absolute y)
+    float scale[2]     = {};       // Per-character X/Y scale
+    float uvMin[2]     = {};
+    float uvMax[2]     = {};
+    float color[4]     = {};       // Lead color; rgb ignored when schemeTint == 1
+    float schemeTint   = 0.0f;     // 1 = take rgb from the scheme color constant
+    float padding[3]   = {};
+};
+
+static_assert (sizeof (RainInstanceStatic) == 64, "RainInstanceStatic must match the HLSL RainInstance stride");
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  RainInstanceStream
+//
+//  Thin per-frame record: which slot to draw and how bright.  Issued in
+//  back-to-front order, so the stream itself is the depth sort.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+struct RainInstanceStream
+{
+    uint32_t slot       = 0;
+    float    brightness = 0.0f;
+};
+
+static_assert (sizeof (RainInstanceStream) == 8, "RainInstanceStream must match the rain input layout");
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  InstanceSlotSpan
+//
+//  Half-open range [first, first + count) of slots whose static record
+//  changed since the previous Update() and must be re-uploaded.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+struct InstanceSlotSpan
+{
+    uint32_t first = 0;
+    uint32_t count = 0;
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  InstanceUploadStats
+//
+//  Bytes the last Update() asks the GPU to receive, next to what the old
+//  rebuild-everything path would have uploaded for the same frame.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+struct InstanceUploadStats
+{
+    size_t instanceCount    = 0;
+    size_t dirtySlotCount   = 0;   // Slots whose record actually changed
+    size_t spanCount        = 0;   // UpdateSubresource calls needed
+    size_t staticBytes      = 0;   // Bytes covered by the dirty spans
+    size_t streamBytes      = 0;   // Thin per-frame stream
+    size_t fullRebuildBytes = 0;   // One 64-byte instance per character
+
+    size_t TotalBytes() const { return staticBytes + streamBytes; }
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  InstanceStore
+//
+//  Persistent, slot-stable mirror of the rain instance data.  Each character
+//  is identified by (streak ID, character sequence) and keeps the same slot
+//  for its whole lifetime, so a frame in which characters only fade touches
+//  nothing but the thin brightness stream.
+//
+//  Overlay characters (help-dialog tracers) have no stable identity; they
+//  are keyed by their index in AnimationSystem::GetOverlayCharacters() and
+//  the record compare keeps them clean while they sit still.
+//
+//  Not thread-safe; owned by one render system and used from its render
+//  thread.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class InstanceStore
+{
+public:
+    // Rebuilds the stream, reconciles slots against the current streaks and
+    // records which slots changed.
+    void Update (const AnimationSystem & animationSystem);
+
+    // Drops all slots and identity bookkeeping.
+    void Clear();
+
+    const std::vector<RainInstanceStatic> & GetSlots()       const { return m_slots;       }
+    const std::vector<RainInstanceStream> & GetStream()      const { return m_stream;      }
+    const std::vector<InstanceSlotSpan>   & GetDirtySpans()  const { return m_dirtySpans;  }
+    const InstanceUploadStats             & GetUploadStats() const { return m_uploadStats; }
+    size_t                                  GetSlotCount()   const { return m_slots.size(); }
+    size_t                                  GetFreeCount()   const { return m_freeSlots.size(); }
+
+    // Builds the static record for one character.  Exposed for tests.
+    static void BuildStaticRecord (const CharacterInstance & character, const Vector3 & streakPos, RainInstanceStatic & record);
+
+    // Clean gaps up to this many slots are folded into a neighbouring span;
+    // uploading a few unchanged records is cheaper than another
+    // UpdateSubresource call.
+    static constexpr uint32_t s_kSpanMergeGap = 4;
+
+    // Key used for overlay characters; streak IDs start at 1.
+    static constexpr uint64_t s_kOverlayStreakId = 0;
+
+private:
+    struct SlotEntry
+    {
+        uint64_t sequence = 0;
+        uint32_t slot     = 0;
+    };
+
+    struct StreakSlots
+    {
+        std::vector<SlotEntry> entries;        // Ascending by sequence
+        uint64_t               lastSeenFrame = 0;
+    };
+
+    void     BeginStreak (StreakSlots & slots);
+    void     PlaceCharacter (StreakSlots & slots, uint64_t sequence, const CharacterInstance & character, const Vector3 & streakPos);
+    void     EndStreak (StreakSlots & slots);
+    uint32_t AllocateSlot();
+    void     ReleaseSlot (uint32_t slot);
+    void     MarkDirty (uint32_t slot);
+    void     BuildDirtySpans();
+
+    std::vector<RainInstanceStatic>        m_slots;
+    std::vector<uint32_t>                  m_freeSlots;
+    std::vector<uint32_t>                  m_dirtySlots;
+    std::vector<uint8_t>                   m_slotDirty;
+    std::vector<InstanceSlotSpan>          m_dirtySpans;
+    std::vector<RainInstanceStream>        m_stream;
+    std::vector<const CharacterStreak *>   m_sortScratch;
+    std::vector<SlotEntry>                 m_entryScratch;
+    size_t                                 m_entryCursor = 0;
+    std::map<uint64_t, StreakSlots>        m_streakSlots;
+    InstanceUploadStats                    m_uploadStats;
+    uint64_t                               m_frame       = 0;
+};
@@ -0,0 +1,81 @@
+#include "pch.h"
+
+#include "MappedFile.h"
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  MappedFile::Open
+//
+////////////////////////////////////////////////////////////////////////////////
+
+HRESULT MappedFile::Open (const std::filesystem::path & path)
+{
+    HRESULT       hr       = S_OK;
+    LARGE_INTEGER cbFile   = {};
+    BOOL          fSuccess = FALSE;
+
+
+
+    Close();
+
+    m_hFile = CreateFileW (path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    CWR (m_hFile != INVALID_HANDLE_VALUE);
+
+    fSuccess = GetFileSizeEx (m_hFile, &cbFile);
+    CWR (fSuccess);
+    CBREx (cbFile.QuadPart > 0, HRESULT_FROM_WIN32 (ERROR_FILE_INVALID));
+
+    m_hMapping = CreateFileMappingW (m_hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CWR (m_hMapping != nullptr);
+
+    m_pData = static_cast<const uint8_t *> (MapViewOfFile (m_hMapping, FILE_MAP_READ, 0, 0, 0));
+    CWR (m_pData != nullptr);
+
+    m_cbData = static_cast<size_t> (cbFile.QuadPart);
+
+
+Error:
+    if (FAILED (hr))
+    {
+        Close();
+    }
+
+    return hr;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  MappedFile::Close
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void MappedFile::Close()
+{
+    if (m_pData != nullptr)
+    {
+        UnmapViewOfFile (m_pData);
+    }
+
+    if (m_hMapping != nullptr)
+    {
+        CloseHandle (m_hMapping);
+        m_hMapping = nullptr;
+    }
+
+    if (m_hFile != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle (m_hFile);
+        m_hFile = INVALID_HANDLE_VALUE;
+    }
+
+    m_pData  = nullptr;
+    m_cbData = 0;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  MappedFile
+//
+//  Read-only view of a whole file mapped into memory through a Win32 file
+//  mapping.  Pages are faulted in on first touch, so
+//  opening a large file costs a few system calls regardless of its size.
+//  The view stays valid until Close or destruction.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile() { Close(); }
+
+    MappedFile (const MappedFile &)             = delete;
+    MappedFile & operator= (const MappedFile &) = delete;
+
+    // Fails for missing and empty files
+    HRESULT Open (const std::filesystem::path & path);
+    void    Close();
+
+    bool                     IsOpen() const { return m_pData != nullptr;    }
+    std::span<const uint8_t> Bytes()  const { return { m_pData, m_cbData }; }
+
+private:
+    HANDLE          m_hFile    { INVALID_HANDLE_VALUE };
+    HANDLE          m_hMapping { nullptr };
+    const uint8_t * m_pData    { nullptr };
+    size_t          m_cbData   { 0 };
+};
@@ -63,3 +63,60 @@ std::vector<MonitorPlacement> PlanFullscreenPlacements (const std::vector<Monito
 
     return placements;
 }
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  PlanVirtualDesktop
+//
+//  Bounds the placements and re-expresses each one relative to the union's
+//  top-left.  Gaps between monitors of different sizes are part of the
+//  union and simulated, but no monitor ever shows them.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+VirtualDesktopLayout PlanVirtualDesktop (const std::vector<MonitorPlacement> & placements)
+{
+    VirtualDesktopLayout layout;
+    LONG                 right      = 0;
+    LONG                 bottom     = 0;
+    LONG                 totalWidth = 0;
+
+
+
+    if (placements.empty())
+    {
+        return layout;
+    }
+
+    layout.origin = placements[0].position;
+    right         = placements[0].position.x + placements[0].size.cx;
+    bottom        = placements[0].position.y + placements[0].size.cy;
+
+    for (const MonitorPlacement & placement : placements)
+    {
+        layout.origin.x = std::min (layout.origin.x, placement.position.x);
+        layout.origin.y = std::min (layout.origin.y, placement.position.y);
+        right           = std::max (right,  placement.position.x + placement.size.cx);
+        bottom          = std::max (bottom, placement.position.y + placement.size.cy);
+        totalWidth     += placement.size.cx;
+    }
+
+    layout.size           = { right - layout.origin.x, bottom - layout.origin.y };
+    layout.columnCoverage = static_cast<float> (totalWidth) / static_cast<float> (layout.size.cx);
+
+    for (const MonitorPlacement & placement : placements)
+    {
+        layout.regions.push_back (RainRegion
+                                  {
+                                      .left   = static_cast<float> (placement.position.x - layout.origin.x),
+                                      .top    = static_cast<float> (placement.position.y - layout.origin.y),
+                                      .width  = static_cast<float> (placement.size.cx),
+                                      .height = static_cast<float> (placement.size.cy),
+                                  });
+    }
+
+    return layout;
+}
@@ -26,4 +26,49 @@ struct MonitorPlacement
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+//
+//  RainRegion
+//
+//  One monitor's rectangle inside a VirtualDesktopLayout, in simulation
+//  pixels (origin at the top-left of the union rectangle).
+//
+////////////////////////////////////////////////////////////////////////////////
+
+struct RainRegion
+{
+    float left   = 0.0f;
+    float top    = 0.0f;
+    float width  = 0.0f;
+    float height = 0.0f;
+};
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  VirtualDesktopLayout
+//
+//  The union rectangle of a set of placements, which a shared simulation
+//  runs over, and where each placement sits inside it.  `columnCoverage`
+//  is the total width of the monitors over the union's width: 1 for a
+//  row of monitors, 2 for two stacked ones.  Streak density is a count
+//  per column of the viewport, so the simulation scales it by this to
+//  keep every monitor as dense as it would be on its own.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+struct VirtualDesktopLayout
+{
+    POINT                   origin         = { 0, 0 };    // Virtual-screen position of the union's top-left
+    SIZE                    size           = { 0, 0 };
+    std::vector<RainRegion> regions;                      // One per placement, in placement order
+    float                   columnCoverage = 1.0f;
+};
+
+
+
+
 std::vector<MonitorPlacement> PlanFullscreenPlacements (const std::vector<MonitorInfo> & monitors);
+VirtualDesktopLayout          PlanVirtualDesktop       (const std::vector<MonitorPlacement> & placements);
@@ -9,11 +9,15 @@
 #include "DensityController.h"
 #include "DeviceLost.h"
 #include "FPSCounter.h"
+#include "FrameTrace.h"
 #include "Overlay.h"
+#include "PausedRedraw.h"
 #include "RenderParams.h"
 #include "RenderSystem.h"
 #include "ScanlineStyleMapping.h"
+#include "SimulationPipeline.h"
 #include "Viewport.h"
+#include "VirtualDesktopSimulation.h"
 
 
 
@@ -24,14 +28,20 @@
 //
 ////////////////////////////////////////////////////////////////////////////////
 
-MonitorRenderContext::MonitorRenderContext (bool isPrimary) :
-    m_isPrimary (isPrimary)
+MonitorRenderContext::MonitorRenderContext (bool isPrimary, int monitorIndex) :
+    m_isPrimary    (isPrimary),
+    m_monitorIndex (monitorIndex)
 {
     m_viewport          = std::make_unique<Viewport>();
     m_densityController = std::make_unique<DensityController> (*m_viewport, 16.0f);  // Base spacing; scaled by monitor DPI
     m_animationSystem   = std::make_unique<AnimationSystem>();
     m_renderSystem      = std::make_unique<RenderSystem>();
     m_fpsCounter        = std::make_unique<FPSCounter>();
+
+    m_qualityGovernor.SetDecisionSink ([] (const QualityDecision & decision)
+    {
+        OutputDebugStringW (FormatQualityDecision (decision).c_str());
+    });
 }
 
 
@@ -103,9 +113,12 @@ HRESULT MonitorRenderContext::Initialize (HWND hwnd, UINT width, UINT height, st
         {
             unsigned refreshHz = static_cast<unsigned> (dm.dmDisplayFrequency);
 
+            // 0 and 1 both mean "the hardware default"
+            m_refreshHz = refreshHz > 1 ? refreshHz : 0;
+
             if (ShouldEngageFrameLimiter (refreshHz))
             {
-                m_frameLimiter.emplace (60);
+                m_frameLimiter.emplace (60, FramePacingMode::Precision);
             }
         }
     }
@@ -124,13 +137,31 @@ Error:
 //
 //  Wires the animation system to this context's viewport and density
 //  controller.  Must run after CharacterSet::Initialize so the glyph layout is
-//  available.
+//  available.  Under a shared simulation the streaks come from it instead,
+//  so the initial ones are dropped; the viewport wiring still serves the
+//  statistics line.  With a simulation thread (and no shared simulation)
+//  the render side starts out drawing a copy of the initial streaks.
 //
 ////////////////////////////////////////////////////////////////////////////////
 
 void MonitorRenderContext::InitializeAnimation()
 {
     m_animationSystem->Initialize (*m_viewport, *m_densityController);
+
+    if (m_desktopSimulation)
+    {
+        m_animationSystem->ClearAllStreaks();
+    }
+    else if (m_useSimulationThread)
+    {
+        std::vector<CharacterStreak> streaks = m_animationSystem->GetStreaks();
+
+        m_presentedAnimation = std::make_unique<AnimationSystem>();
+        m_presentedAnimation->Initialize  (*m_viewport, *m_densityController);
+        m_presentedAnimation->SwapStreaks (streaks);
+
+        m_pipeline = std::make_unique<SimulationPipeline> (*m_animationSystem, *m_densityController, m_monitorIndex);
+    }
 }
 
 
@@ -161,11 +192,7 @@ void MonitorRenderContext::StartRenderThread (SharedState      & sharedState,
                                               ApplicationState * primaryClock,
                                               std::atomic<bool> & inTransition)
 {
-    m_sharedState  = &sharedState;
-    m_overlays     = overlays;
-    m_primaryClock = primaryClock;
-    m_inTransition = &inTransition;
-    m_shouldStop   = false;
+    BindRenderInputs (sharedState, overlays, primaryClock, inTransition);
 
     m_renderThread = std::thread (&MonitorRenderContext::RenderThreadProc, this);
 }
@@ -173,6 +200,145 @@ void MonitorRenderContext::StartRenderThread (SharedState      & sharedState,
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+//
+//  MonitorRenderContext::BindRenderInputs
+//
+//  Wires the shared state a frame reads.  StartRenderThread does this for
+//  its own thread; under RenderThreadModel::SharedWorker it is called on
+//  its own before handing MakeScheduledTarget to a SharedRenderWorker.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void MonitorRenderContext::BindRenderInputs (SharedState      & sharedState,
+                                             OverlayState     * overlays,
+                                             ApplicationState * primaryClock,
+                                             std::atomic<bool> & inTransition)
+{
+    m_sharedState   = &sharedState;
+    m_overlays      = overlays;
+    m_primaryClock  = primaryClock;
+    m_inTransition  = &inTransition;
+    m_shouldStop    = false;
+    m_lastFrameTime = FrameClock::now();
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  MonitorRenderContext::GetFrameRate
+//
+//  Frames per second this display is owed: its refresh rate, or 60 when
+//  the frame limiter caps it (or the rate is unknown).
+//
+////////////////////////////////////////////////////////////////////////////////
+
+unsigned MonitorRenderContext::GetFrameRate() const
+{
+    return m_frameLimiter || m_refreshHz == 0 ? 60u : m_refreshHz;
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  MonitorRenderContext::MakeScheduledTarget
+//
+//  The worker owes this display a frame every refresh, or every 1/60 s
+//  when the frame limiter caps it (the worker's deadlines then do the
+//  limiter's job).  The target must not outlive this context.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+ScheduledRenderTarget MonitorRenderContext::MakeScheduledTarget()
+{
+    m_attachedToWorker = true;
+
+    return ScheduledRenderTarget
+    {
+        .period      = PeriodForRate (GetFrameRate()),
+        .renderFrame = [this] (FrameClock::time_point now) { return RenderFrame (now, true); },
+    };
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  MonitorRenderContext::DetachFromWorker
+//
+//  Only valid once the SharedRenderWorker holding this context's target
+//  has been joined; from here the UI thread may touch the subsystems again.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void MonitorRenderContext::DetachFromWorker()
+{
+    m_attachedToWorker = false;
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  MonitorRenderContext::BindDesktopSimulation
+//
+//  The simulation sizes characters for every monitor at once, so this
+//  context draws them at its scale rather than its own viewport's.  The
+//  simulation must outlive the render thread.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void MonitorRenderContext::BindDesktopSimulation (VirtualDesktopSimulation & simulation, const RainRegion & region)
+{
+    m_desktopSimulation = &simulation;
+    m_desktopRegion     = region;
+
+    m_renderSystem->SetCharacterScaleOverride (simulation.GetCharacterScale());
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  MonitorRenderContext::UseSimulationThread
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void MonitorRenderContext::UseSimulationThread()
+{
+    m_useSimulationThread = true;
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  MonitorRenderContext::StartSimulationThread
+//
+//  Steps at the rate frames are owed to this display, so every presented
+//  frame has a new step to show.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void MonitorRenderContext::StartSimulationThread()
+{
+    if (m_pipeline)
+    {
+        m_pipeline->Start (*m_sharedState, m_inTransition, GetFrameRate());
+    }
+}
+
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 //  MonitorRenderContext::RequestStop
@@ -182,6 +348,16 @@ void MonitorRenderContext::StartRenderThread (SharedState      & sharedState,
 void MonitorRenderContext::RequestStop()
 {
     m_shouldStop = true;
+
+    if (m_pipeline)
+    {
+        m_pipeline->RequestStop();
+    }
+
+    if (m_sharedState)
+    {
+        m_sharedState->wake.Notify();
+    }
 }
 
 
@@ -199,6 +375,11 @@ void MonitorRenderContext::Join()
     {
         m_renderThread.join();
     }
+
+    if (m_pipeline)
+    {
+        m_pipeline->Join();
+    }
 }
 
 
@@ -210,12 +391,22 @@ void MonitorRenderContext::Join()
 //
 //  Resizes the viewport and swap chain to new client dimensions.  Serialized
 //  against the render thread via the render mutex so swap-chain recreation
-//  never races an in-flight frame.
+//  never races an in-flight frame, and against a simulation thread via the
+//  pipeline's mutex (always taken first).  When streaks are rescaled, the
+//  frames that thread simulated before are dropped; until its first new
+//  one, the rescaled presented streaks are drawn.
 //
 ////////////////////////////////////////////////////////////////////////////////
 
 void MonitorRenderContext::Resize (UINT width, UINT height, bool rescaleStreaks)
 {
+    std::unique_lock<std::mutex> simulationLock;
+
+    if (m_pipeline)
+    {
+        simulationLock = std::unique_lock<std::mutex> (m_pipeline->GetMutex());
+    }
+
     std::lock_guard<std::mutex> lock (m_renderMutex);
 
     float oldWidth  = m_viewport->GetWidth();
@@ -232,6 +423,25 @@ void MonitorRenderContext::Resize (UINT width, UINT height, bool rescaleStreaks)
                                                       oldHeight,
                                                       static_cast<float> (width),
                                                       static_cast<float> (height));
+
+        if (m_presentedAnimation)
+        {
+            m_presentedAnimation->RescaleStreaksForViewport (oldWidth,
+                                                             oldHeight,
+                                                             static_cast<float> (width),
+                                                             static_cast<float> (height));
+        }
+
+        if (m_pipeline)
+        {
+            m_pipeline->InvalidateLayout();
+        }
+    }
+
+    // A paused thread idling in low-power mode must redraw at the new size
+    if (m_sharedState)
+    {
+        m_sharedState->wake.Notify();
     }
 }
 
@@ -244,12 +454,20 @@ void MonitorRenderContext::Resize (UINT width, UINT height, bool rescaleStreaks)
 //
 //  Propagates a new monitor DPI to the render system, animation system, and
 //  density controller.  Serialized against the render thread via the render
-//  mutex.
+//  mutex, and against a simulation thread the same way Resize is.  The
+//  streaks already on screen keep their places, so no frame is dropped.
 //
 ////////////////////////////////////////////////////////////////////////////////
 
 void MonitorRenderContext::OnDpiChanged (UINT dpi)
 {
+    std::unique_lock<std::mutex> simulationLock;
+
+    if (m_pipeline)
+    {
+        simulationLock = std::unique_lock<std::mutex> (m_pipeline->GetMutex());
+    }
+
     std::lock_guard<std::mutex> lock (m_renderMutex);
 
     float dpiScale = static_cast<float> (dpi) / 96.0f;
@@ -258,6 +476,11 @@ void MonitorRenderContext::OnDpiChanged (UINT dpi)
     m_renderSystem->OnDpiChanged     (dpi);
     m_animationSystem->SetDpiScale   (dpiScale);
     m_densityController->SetDpiScale (dpiScale);
+
+    if (m_sharedState)
+    {
+        m_sharedState->wake.Notify();
+    }
 }
 
 
@@ -271,7 +494,7 @@ void MonitorRenderContext::OnDpiChanged (UINT dpi)
 
 RenderSystem & MonitorRenderContext::Renderer()
 {
-    assert (!m_renderThread.joinable());
+    assert (!m_renderThread.joinable() && !m_attachedToWorker);
 
     return *m_renderSystem;
 }
@@ -287,7 +510,7 @@ RenderSystem & MonitorRenderContext::Renderer()
 
 AnimationSystem & MonitorRenderContext::Animation()
 {
-    assert (!m_renderThread.joinable());
+    assert (!m_renderThread.joinable() && !m_attachedToWorker);
 
     return *m_animationSystem;
 }
@@ -303,7 +526,7 @@ AnimationSystem & MonitorRenderContext::Animation()
 
 DensityController & MonitorRenderContext::Density()
 {
-    assert (!m_renderThread.joinable());
+    assert (!m_renderThread.joinable() && !m_attachedToWorker);
 
     return *m_densityController;
 }
@@ -319,7 +542,7 @@ DensityController & MonitorRenderContext::Density()
 
 Viewport & MonitorRenderContext::ViewportRef()
 {
-    assert (!m_renderThread.joinable());
+    assert (!m_renderThread.joinable() && !m_attachedToWorker);
 
     return *m_viewport;
 }
@@ -349,116 +572,227 @@ float MonitorRenderContext::GetDpiScale() const
 //  loop so animation stays smooth during modal operations (dialog drag, resize,
 //  menus).  Paced by Present() VSync on this monitor.
 //
+//  It never polls while idle.  During a display-mode transition it blocks
+//  on the shared wake signal until the transition ends; while paused it
+//  drops to PausedRedrawInterval's low-power redraw rate, waiting outside
+//  the render mutex so any state change wakes it at once.  The wake
+//  generation is read before the transition flag and the snapshot, so a
+//  Notify that lands in between ends the next wait immediately.
+//
 ////////////////////////////////////////////////////////////////////////////////
 
 void MonitorRenderContext::RenderThreadProc()
 {
-    using namespace std::chrono;
+    uint64_t                              wakeGeneration = 0;
+    std::optional<FrameClock::time_point> idleUntil;
 
-    auto                  lastFrameTime = steady_clock::now();
-    SharedState::Snapshot snapshot;
 
+    FrameTrace::SetThreadName (std::format ("Render (monitor {})", m_monitorIndex));
 
     while (!m_shouldStop)
     {
-        // High-refresh frame cap: when this monitor's native refresh is
-        // > 60 Hz the limiter throttles the loop to 60 fps.  At <=60 Hz
-        // m_frameLimiter is empty and this is a single nullopt check.
-        if (m_frameLimiter)
+        // Paused low-power mode: sleep until the next redraw is due or
+        // something changes, then start the loop over (the stop flag and
+        // the state may be different now)
+        if (idleUntil)
         {
-            m_frameLimiter->WaitForNextFrame();
+            m_sharedState->wake.WaitUntil (wakeGeneration, *idleUntil);
+            idleUntil.reset();
+            continue;
         }
 
-        auto  currentTime = steady_clock::now();
-        float deltaTime   = duration_cast<duration<float>> (currentTime - lastFrameTime).count();
-        lastFrameTime     = currentTime;
+        wakeGeneration = m_sharedState->wake.GetGeneration();
 
-        // Clamp large deltas (e.g. after a window resize stalls the loop) so the
-        // animation never jumps a long way in a single frame.
-        if (deltaTime > 0.1f)
+        // High-refresh frame cap: when this monitor's native refresh is
+        // > 60 Hz the limiter throttles the loop to 60 fps on an absolute
+        // schedule (sleep, then yield out the last stretch).  At <=60 Hz
+        // m_frameLimiter is empty and this is a single nullopt check.
+        if (m_frameLimiter)
         {
-            deltaTime = 0.1f;
+            TraceZone zone ("LimiterWait", m_monitorIndex);
+
+            m_frameLimiter->WaitForNextFrame();
         }
 
         // Skip rendering while a display-mode transition rebuilds the window
         if (m_inTransition && m_inTransition->load())
         {
-            std::this_thread::sleep_for (milliseconds (1));
+            m_sharedState->wake.Wait (wakeGeneration);
             continue;
         }
 
+        RenderStep step = RenderFrame (FrameClock::now(), false);
 
-        std::lock_guard<std::mutex> renderLock (m_renderMutex);
-
-        if (m_fpsCounter)
+        if (!step.keepRunning)
         {
-            m_fpsCounter->Update (deltaTime);
-
-            // T023 (US1, FR-010): publish to the lock-free pair consumed by the
-            // property-sheet 1 Hz title timer.  See contracts/fps-publisher.md.
-            PublishFps (m_fpsCounter->GetFPS());
+            break;
         }
 
-        // The primary context owns the shared color-cycle clock: advance it and
-        // publish elapsedTime BEFORE snapshotting so this frame — and, in
-        // multimon, every monitor — renders with the same elapsed time.
-        if (m_primaryClock)
-        {
-            m_primaryClock->Update (deltaTime);
+        idleUntil = step.idleUntil;
+    }
+}
 
-            std::lock_guard<std::mutex> lock (m_sharedState->mutex);
-            m_sharedState->elapsedTime = m_primaryClock->GetElapsedTime();
-        }
 
-        // Snapshot shared state under lock, then push to subsystems.  Keeps the
-        // lock hold time minimal while ensuring all subsystem writes happen on
-        // the render thread.
-        {
-            std::lock_guard<std::mutex> lock (m_sharedState->mutex);
-            snapshot = m_sharedState->GetSnapshot();
-        }
 
-        m_densityController->SetPercentage   (snapshot.densityPercent);
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  MonitorRenderContext::RenderFrame
+//
+//  One frame: snapshot shared state, simulate, render and present.  Called
+//  by this context's own render thread or by the SharedRenderWorker that
+//  drives it, never both.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+RenderStep MonitorRenderContext::RenderFrame (FrameClock::time_point currentTime, bool reportVBlank)
+{
+    FrameClock::duration  frameTime = currentTime - m_lastFrameTime;
+    float                 deltaTime = static_cast<float> (ToSeconds (frameTime));
+    RenderStep            step;
+    SharedState::Snapshot snapshot;
+    TraceZone             frameZone ("Frame", m_monitorIndex);
+
+
+    m_lastFrameTime = currentTime;
+
+    // Clamp large deltas (e.g. after a window resize stalls the loop) so the
+    // animation never jumps a long way in a single frame.
+    if (deltaTime > 0.1f)
+    {
+        deltaTime = 0.1f;
+    }
+
+    std::lock_guard<std::mutex> renderLock (m_renderMutex);
+
+    if (m_fpsCounter)
+    {
+        m_fpsCounter->Update (frameTime);
+
+        // T023 (US1, FR-010): publish to the lock-free pair consumed by the
+        // property-sheet 1 Hz title timer.  See contracts/fps-publisher.md.
+        PublishFps (m_fpsCounter->GetFPS());
+    }
+
+    // The primary context owns the shared color-cycle clock: advance it and
+    // publish elapsedTime BEFORE snapshotting so this frame — and, in
+    // multimon, every monitor — renders with the same elapsed time.
+    if (m_primaryClock)
+    {
+        m_primaryClock->Update (deltaTime);
+        m_sharedState->elapsedTime.store (m_primaryClock->GetElapsedTime(), std::memory_order_relaxed);
+    }
+
+    // Snapshot shared state (lock-free), then push to subsystems so all
+    // subsystem writes happen on the render thread.
+    {
+        TraceZone zone ("Snapshot");
+
+        snapshot = m_sharedState->GetSnapshot();
+    }
+
+    // The user's settings are the quality ceiling.  With a target frame
+    // cost set, the governor may be holding the blur, bloom resolution
+    // or density below it; with none, its level is the ceiling itself.
+    m_qualityGovernor.Configure (QualityLevel
+                                 {
+                                     .graphics       = { snapshot.glowIntensityPercent, snapshot.blurPasses, snapshot.bloomResolutionDivisor, snapshot.blurTaps, snapshot.bloomAlgorithm },
+                                     .densityPercent = snapshot.densityPercent,
+                                     .glowEnabled    = snapshot.glowEnabled,
+                                 },
+                                 snapshot.qualityTargetFrameUs);
+
+    const QualityLevel & quality = m_qualityGovernor.GetLevel();
+
+    // The simulation thread, if any, owns the animation and density; it
+    // reads the speed from the snapshot itself
+    if (m_pipeline)
+    {
+        m_pipeline->SetDensityPercent (quality.densityPercent);
+    }
+    else
+    {
+        m_densityController->SetPercentage   (quality.densityPercent);
         m_animationSystem->SetAnimationSpeed (snapshot.animationSpeedPercent);
-        m_renderSystem->SetGlowIntensity     (snapshot.glowIntensityPercent);
-        m_renderSystem->SetGlowSize          (snapshot.glowSizePercent);
-        m_renderSystem->SetBlurPasses        (snapshot.blurPasses);
-        m_renderSystem->SetBloomResolution   (static_cast<int> (snapshot.bloomResolutionDivisor));
-        m_renderSystem->SetBlurTaps          (static_cast<int> (snapshot.blurTaps));
-
-        // Update/Render hold the overlay lock (primary only); Present is kept
-        // OUTSIDE it so the UI thread's Show/Dismiss is never blocked by VSync.
-        {
-            std::unique_lock<std::mutex> overlayLock;
+    }
 
-            if (m_overlays)
-            {
-                overlayLock = std::unique_lock<std::mutex> (m_overlays->mutex);
-            }
+    m_renderSystem->SetGlowIntensity     (snapshot.glowIntensityPercent);
+    m_renderSystem->SetGlowSize          (snapshot.glowSizePercent);
+    m_renderSystem->SetBlurPasses        (quality.graphics.m_blurPasses);
+    m_renderSystem->SetBloomResolution   (static_cast<int> (quality.graphics.m_bloomResolutionDivisor));
+    m_renderSystem->SetBlurTaps          (static_cast<int> (quality.graphics.m_blurTaps));
+    m_renderSystem->SetBloomAlgorithm    (static_cast<int> (snapshot.bloomAlgorithm));
+    m_renderSystem->SetGpuTimingEnabled  (snapshot.qualityTargetFrameUs > 0);
+
+    // The primary render thread owns the overlays: apply whatever the UI
+    // thread has posted since last frame, then update and draw them with
+    // no lock held.
+    if (m_overlays)
+    {
+        m_overlays->ApplyPendingCommands();
+    }
 
-            Update (snapshot, deltaTime);
-            Render (snapshot);
-        }
+    uint64_t simStart = Timestamp::Read();
 
-        HRESULT presentHr = m_renderSystem->Present();
+    Update (snapshot, deltaTime);
 
-        if (IsDeviceLost (presentHr))
-        {
-            // GPU is gone (driver reset, removal, sleep/resume).  Stop this
-            // render thread immediately and ask the UI thread to rebuild
-            // every context on whatever adapter is currently available.
-            // Post WM_APP_DEVICE_LOST (not WM_APP_REBUILD_CONTEXTS directly)
-            // so Application::HandleMessage routes the request through the
-            // RebuildCoalescer — an N-monitor burst then collapses to a
-            // single rebuild instead of N back-to-back rebuilds.
-            if (m_hwnd)
-            {
-                PostMessageW (m_hwnd, Application::WM_APP_DEVICE_LOST, 0, 0);
-            }
+    int64_t simUs = ToMicroseconds (ElapsedSince (simStart));
 
-            break;
+    Render (snapshot);
+
+    FrameClock::time_point presentStart = FrameClock::now();
+    HRESULT                presentHr    = m_renderSystem->Present();
+    FrameClock::time_point presentEnd   = FrameClock::now();
+
+    // Per-frame timings; a window of them is published lock-free every
+    // second for the statistics line and the config dialog
+    m_frameTiming.Record   (FrameTimingMetric::Frame,         ToMicroseconds (frameTime));
+    m_frameTiming.Record   (FrameTimingMetric::Simulation,    simUs);
+    m_frameTiming.Record   (FrameTimingMetric::InstanceBuild, m_renderSystem->GetLastInstanceBuildMicroseconds());
+    m_frameTiming.Record   (FrameTimingMetric::Present,       ToMicroseconds (presentEnd - presentStart));
+    m_frameTiming.EndFrame (presentEnd);
+
+    // The governor's cost is whichever of the CPU's work up to Present
+    // (excluding the VSync wait Present absorbs) and the GPU's time for
+    // a recent frame is larger: either one can be the bottleneck
+    m_qualityGovernor.RecordFrame (std::max (ToMicroseconds (presentStart - currentTime),
+                                             m_renderSystem->GetLastGpuFrameMicroseconds()));
+
+    if (IsDeviceLost (presentHr))
+    {
+        TraceZone zone ("DeviceLost");
+
+        // GPU is gone (driver reset, removal, sleep/resume).  Stop driving
+        // this context immediately and ask the UI thread to rebuild every
+        // context on whatever adapter is currently available.  Post
+        // WM_APP_DEVICE_LOST (not WM_APP_REBUILD_CONTEXTS directly) so
+        // Application::HandleMessage routes the request through the
+        // RebuildCoalescer — an N-monitor burst then collapses to a single
+        // rebuild instead of N back-to-back rebuilds.
+        if (m_hwnd)
+        {
+            PostMessageW (m_hwnd, Application::WM_APP_DEVICE_LOST, 0, 0);
         }
+
+        step.keepRunning = false;
+        return step;
+    }
+
+    std::optional<std::chrono::microseconds> idleInterval = PausedRedrawInterval (snapshot.isPaused, OverlaysActive(), snapshot.colorScheme);
+
+    if (idleInterval)
+    {
+        step.idleUntil = currentTime + *idleInterval;
+    }
+
+    // A capped display is serviced off its vblank grid, so only an
+    // uncapped one reports its vblanks for the worker to lock onto
+    if (reportVBlank && !m_frameLimiter)
+    {
+        step.vblank = m_renderSystem->GetLastVBlankTime();
     }
+
+    return step;
 }
 
 
@@ -472,7 +806,31 @@ void MonitorRenderContext::RenderThreadProc()
 
 void MonitorRenderContext::Update (const SharedState::Snapshot & snapshot, float deltaTime)
 {
-    if (m_animationSystem && !snapshot.isPaused)
+    TraceZone zone ("Update");
+
+
+    if (m_desktopSimulation)
+    {
+        // The primary steps the shared simulation; every context then
+        // renders its own monitor's part of the newest frame
+        if (m_isPrimary && !snapshot.isPaused)
+        {
+            m_desktopSimulation->Step (deltaTime, m_densityController->GetPercentage(), snapshot.animationSpeedPercent);
+        }
+
+        VirtualDesktopSimulation::CullToRegion (*m_desktopSimulation->GetLatestFrame(),
+                                                m_desktopRegion,
+                                                m_desktopSimulation->GetCharacterScale(),
+                                                m_regionStreaks);
+
+        m_animationSystem->SwapStreaks (m_regionStreaks);
+    }
+    else if (m_pipeline)
+    {
+        // Simulated on the pipeline's thread; draw its newest step
+        m_pipeline->AdoptNewestFrame (*m_presentedAnimation);
+    }
+    else if (m_animationSystem && !snapshot.isPaused)
     {
         m_animationSystem->Update (deltaTime);
     }
@@ -485,9 +843,7 @@ void MonitorRenderContext::Update (const SharedState::Snapshot & snapshot, float
 
     OverlayState & overlays = *m_overlays;
 
-    if ((overlays.helpOverlay   && overlays.helpOverlay->IsActive())   ||
-        (overlays.hotkeyOverlay && overlays.hotkeyOverlay->IsActive()) ||
-        (overlays.usageOverlay  && overlays.usageOverlay->IsActive()))
+    if (OverlaysActive())
     {
         Color4 scheme;
 
@@ -529,6 +885,27 @@ void MonitorRenderContext::Update (const SharedState::Snapshot & snapshot, float
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+//
+//  MonitorRenderContext::OverlaysActive
+//
+////////////////////////////////////////////////////////////////////////////////
+
+bool MonitorRenderContext::OverlaysActive() const
+{
+    if (!m_overlays)
+    {
+        return false;
+    }
+
+    return (m_overlays->helpOverlay   && m_overlays->helpOverlay->IsActive())   ||
+           (m_overlays->hotkeyOverlay && m_overlays->hotkeyOverlay->IsActive()) ||
+           (m_overlays->usageOverlay  && m_overlays->usageOverlay->IsActive());
+}
+
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 //  MonitorRenderContext::Render
@@ -537,18 +914,25 @@ void MonitorRenderContext::Update (const SharedState::Snapshot & snapshot, float
 
 void MonitorRenderContext::Render (const SharedState::Snapshot & snapshot)
 {
+    TraceZone zone ("Render");
+
+
     if (!(m_renderSystem && m_animationSystem && m_viewport))
     {
         return;
     }
 
 
+    // With a simulation thread, draw the step adopted from it; the
+    // simulated AnimationSystem belongs to that thread
+    const AnimationSystem & rain = m_presentedAnimation ? *m_presentedAnimation : *m_animationSystem;
+
     // Only pass fps value if statistics are enabled
     float       fps                = (snapshot.showStatistics && m_fpsCounter) ? m_fpsCounter->GetFPS() : 0.0f;
     ColorScheme scheme             = snapshot.colorScheme;
     int         rainPercentage     = snapshot.densityPercent;
-    int         streakCount        = static_cast<int> (m_animationSystem->GetActiveStreakCount());
-    int         activeHeadCount    = static_cast<int> (m_animationSystem->GetActiveHeadCount());
+    int         streakCount        = static_cast<int> (rain.GetActiveStreakCount());
+    int         activeHeadCount    = static_cast<int> (rain.GetActiveHeadCount());
     float       elapsedTime        = snapshot.elapsedTime;
 
     // Overlay pointers — only the primary context owns an OverlayState
@@ -583,7 +967,8 @@ void MonitorRenderContext::Render (const SharedState::Snapshot & snapshot)
         .scanlinesIntensity = static_cast<float> (snapshot.scanlinesIntensity) / 100.0f,
         .scanlinesLineCount = ScanlineLineCount (snapshot.scanlinesStyle),
         .customColor        = static_cast<COLORREF> (snapshot.customColor),
+        .frameTime          = m_frameTiming.GetLastWindow().Summarize (FrameTimingMetric::Frame),
     };
 
-    m_renderSystem->Render (*m_animationSystem, *m_viewport, renderParams);
+    m_renderSystem->Render (rain, *m_viewport, renderParams);
 }
@@ -1,6 +1,11 @@
 #pragma once
 
+#include "FrameClock.h"
 #include "FrameLimiter.h"
+#include "FrameTiming.h"
+#include "MonitorLayout.h"
+#include "QualityGovernor.h"
+#include "SharedRenderWorker.h"
 #include "SharedState.h"
 
 
@@ -8,10 +13,13 @@
 
 class Viewport;
 class AnimationSystem;
+class CharacterStreak;
 class RenderSystem;
 class DensityController;
 class FPSCounter;
 class ApplicationState;
+class SimulationPipeline;
+class VirtualDesktopSimulation;
 struct OverlayState;
 
 
@@ -36,7 +44,8 @@ struct OverlayState;
 class MonitorRenderContext
 {
 public:
-    explicit MonitorRenderContext (bool isPrimary);
+    // `monitorIndex` identifies this context's monitor in frame traces
+    explicit MonitorRenderContext (bool isPrimary, int monitorIndex = 0);
     ~MonitorRenderContext();
 
     // Construction — called on the UI thread before the render thread starts
@@ -52,11 +61,35 @@ public:
     void    RequestStop();
     void    Join();
 
+    // Shared-worker scheduling (RenderThreadModel::SharedWorker): bind the
+    // inputs without starting a thread, then hand the target to a worker.
+    // The context counts as rendering from MakeScheduledTarget until
+    // DetachFromWorker, to be called once the worker has joined.
+    void                  BindRenderInputs    (SharedState      & sharedState,
+                                               OverlayState     * overlays,
+                                               ApplicationState * primaryClock,
+                                               std::atomic<bool> & inTransition);
+    ScheduledRenderTarget MakeScheduledTarget();
+    void                  DetachFromWorker();
+
+    // Shared simulation (ScreenSaverSettings::m_sharedSimulation): render
+    // this monitor's region of `simulation` instead of simulating alone.
+    // The primary context also steps it.  Before InitializeAnimation.
+    void    BindDesktopSimulation (VirtualDesktopSimulation & simulation, const RainRegion & region);
+
+    // Simulation thread (ScreenSaverSettings::m_simulationThread): simulate
+    // on a SimulationPipeline and render its newest frame.  Use before
+    // InitializeAnimation; StartSimulationThread after the render inputs
+    // are bound (a no-op without it).  RequestStop/Join cover both threads.
+    void    UseSimulationThread  ();
+    void    StartSimulationThread();
+
     // UI-thread window events — serialized against the render thread
     void    Resize       (UINT width, UINT height, bool rescaleStreaks);
     void    OnDpiChanged (UINT dpi);
 
-    // Pre-thread-start accessors used by Application to wire up subsystems
+    // Accessors used by Application to wire up subsystems while neither a
+    // render thread nor a shared worker is driving the context
     RenderSystem      & Renderer();
     AnimationSystem   & Animation();
     DensityController & Density();
@@ -96,13 +129,34 @@ public:
         return m_hasPublishedFps.load (std::memory_order_relaxed);
     }
 
-private:
-    void RenderThreadProc();
-    void Update (const SharedState::Snapshot & snapshot, float deltaTime);
-    void Render (const SharedState::Snapshot & snapshot);
+    ////////////////////////////////////////////////////////////////////////////
+    //
+    //  Frame-timing publisher
+    //
+    //  Frame, simulation, instance-build and present times recorded by the
+    //  render thread into one-second histogram windows.  Any thread may
+    //  copy the latest completed window; false until the first one closes.
+    //  See FrameTimingPublisher for the protocol.
+    //
+    ////////////////////////////////////////////////////////////////////////////
+
+    bool   GetFrameTiming    (FrameTimingStats & stats) const
+    {
+        return m_frameTiming.TryGetPublished (stats);
+    }
 
-    bool m_isPrimary;
-    HWND m_hwnd { nullptr };
+private:
+    void       RenderThreadProc();
+    RenderStep RenderFrame (FrameClock::time_point currentTime, bool reportVBlank);
+    void       Update (const SharedState::Snapshot & snapshot, float deltaTime);
+    void       Render (const SharedState::Snapshot & snapshot);
+    bool       OverlaysActive() const;
+    unsigned   GetFrameRate()   const;
+
+    bool     m_isPrimary;
+    int      m_monitorIndex;
+    HWND     m_hwnd      { nullptr };
+    unsigned m_refreshHz { 0 };         // 0 = unknown
 
     std::unique_ptr<Viewport>          m_viewport;
     std::unique_ptr<AnimationSystem>   m_animationSystem;
@@ -110,10 +164,31 @@ private:
     std::unique_ptr<DensityController> m_densityController;
     std::unique_ptr<FPSCounter>        m_fpsCounter;
     std::optional<FrameLimiter>        m_frameLimiter;
-
-    std::mutex        m_renderMutex;
-    std::thread       m_renderThread;
-    std::atomic<bool> m_shouldStop { false };
+    FrameTimingRecorder                m_frameTiming;
+    QualityGovernor                    m_qualityGovernor;
+
+    std::mutex                            m_renderMutex;
+    std::thread                           m_renderThread;
+    std::atomic<bool>                     m_shouldStop    { false };
+    FrameClock::time_point                m_lastFrameTime;
+
+    // Set while a SharedRenderWorker holds this context's target; read and
+    // written on the UI thread only
+    bool                                  m_attachedToWorker { false };
+
+    // Shared simulation, if bound: where this monitor sits in it, and the
+    // culled streaks handed to m_animationSystem (swapped back each frame)
+    VirtualDesktopSimulation   * m_desktopSimulation { nullptr };
+    RainRegion                   m_desktopRegion;
+    std::vector<CharacterStreak> m_regionStreaks;
+
+    // Simulation thread, if used: the pipeline owns m_animationSystem and
+    // m_densityController while it runs, and the render thread draws the
+    // streaks it adopts into m_presentedAnimation.  Resize and OnDpiChanged
+    // take the pipeline's mutex before m_renderMutex.
+    bool                                m_useSimulationThread { false };
+    std::unique_ptr<SimulationPipeline> m_pipeline;
+    std::unique_ptr<AnimationSystem>    m_presentedAnimation;
 
     // Observer pointers — valid only while the render thread is running
     SharedState       * m_sharedState  { nullptr };
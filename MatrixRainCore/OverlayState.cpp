@@ -0,0 +1,127 @@
+#include "pch.h"
+
+#include "OverlayState.h"
+
+#include "Overlay.h"
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  OverlayState::Post
+//
+////////////////////////////////////////////////////////////////////////////////
+
+bool OverlayState::Post (const OverlayCommand & command)
+{
+    bool queued = commands.TryPush (command);
+
+
+
+    if (queued && wake)
+    {
+        wake->Notify();
+    }
+
+    return queued;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  OverlayState::ApplyPendingCommands
+//
+////////////////////////////////////////////////////////////////////////////////
+
+size_t OverlayState::ApplyPendingCommands()
+{
+    OverlayCommand command;
+    size_t         count   = 0;
+
+
+
+    while (commands.TryPop (command))
+    {
+        Apply (command);
+        count++;
+    }
+
+    return count;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  OverlayState::Apply
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void OverlayState::Apply (const OverlayCommand & command)
+{
+    Overlay * overlay = Get (command.target);
+
+
+
+    if (!overlay)
+    {
+        return;
+    }
+
+    switch (command.type)
+    {
+        case OverlayCommandType::Show:
+            overlay->Show();
+            break;
+
+        case OverlayCommandType::Dismiss:
+            overlay->Dismiss();
+            break;
+
+        case OverlayCommandType::Hide:
+            if (overlay->IsActive())
+            {
+                overlay->Hide();
+            }
+            break;
+
+        case OverlayCommandType::Toggle:
+            if (overlay->GetPhase() == OverlayPhase::Holding ||
+                overlay->GetPhase() == OverlayPhase::Revealing)
+            {
+                overlay->Dismiss();
+            }
+            else
+            {
+                overlay->Show();
+            }
+            break;
+
+        case OverlayCommandType::SetDpiScale:
+            overlay->SetDpiScale (command.dpiScale);
+            break;
+    }
+}
+
+
+
+
+
+Overlay * OverlayState::Get (OverlayTarget target) const
+{
+    switch (target)
+    {
+        case OverlayTarget::Help:   return helpOverlay.get();
+        case OverlayTarget::Hotkey: return hotkeyOverlay.get();
+        case OverlayTarget::Usage:  return usageOverlay.get();
+    }
+
+    return nullptr;
+}
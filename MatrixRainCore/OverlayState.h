@@ -0,0 +1,102 @@
+#pragma once
+
+#include "RenderWakeSignal.h"
+#include "SpscQueue.h"
+
+
+
+
+
+class Overlay;
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  OverlayCommand — One UI-thread request for the render thread's overlays
+//
+//  Dismiss and Hide are no-ops on an overlay that is not showing.  Toggle
+//  dismisses a revealing or holding overlay and (re)shows any other, so the
+//  UI thread can act on a keypress without reading the overlay's phase.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+enum class OverlayTarget : uint8_t
+{
+    Help,
+    Hotkey,
+    Usage
+};
+
+
+
+enum class OverlayCommandType : uint8_t
+{
+    Show,
+    Dismiss,
+    Hide,
+    Toggle,
+    SetDpiScale
+};
+
+
+
+struct OverlayCommand
+{
+    OverlayCommandType type     = OverlayCommandType::Show;
+    OverlayTarget      target   = OverlayTarget::Help;
+    float              dpiScale = 1.0f;    // SetDpiScale only
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  OverlayState — Overlay objects owned by the primary render thread
+//
+//  The overlays are created and first shown on the UI thread before any
+//  render thread starts; from then on only the primary render thread
+//  touches them.  The UI thread Post()s commands, which never block, and
+//  the render thread applies everything pending with ApplyPendingCommands
+//  at the top of each frame before Update/Render.  A keypress therefore
+//  takes effect on the next frame and the UI thread never waits out a
+//  frame of simulation and draw calls.
+//
+//  Post is single-producer (the UI thread).  ApplyPendingCommands is
+//  single-consumer: the render thread that owns the primary context, or
+//  the UI thread itself while every render thread is joined (context
+//  rebuilds).
+//
+//  When `wake` is set, Post notifies it so a render thread idling while
+//  paused draws the overlay at once instead of at its next redraw.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+struct OverlayState
+{
+    static constexpr size_t s_kCommandCapacity = 64;
+
+    std::unique_ptr<Overlay> helpOverlay;
+    std::unique_ptr<Overlay> hotkeyOverlay;
+    std::unique_ptr<Overlay> usageOverlay;
+
+    SpscQueue<OverlayCommand, s_kCommandCapacity> commands;
+    RenderWakeSignal                            * wake = nullptr;
+
+
+    // UI thread.  Returns false if the render thread has fallen a full queue
+    // behind, in which case the command is dropped.
+    bool   Post (const OverlayCommand & command);
+
+    // Render thread.  Returns the number of commands applied.
+    size_t ApplyPendingCommands();
+
+    // Applies one command immediately on the calling thread
+    void   Apply (const OverlayCommand & command);
+
+    Overlay * Get (OverlayTarget target) const;
+};
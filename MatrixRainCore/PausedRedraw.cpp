@@ -0,0 +1,31 @@
+#include "pch.h"
+
+#include "PausedRedraw.h"
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  PausedRedrawInterval
+//
+////////////////////////////////////////////////////////////////////////////////
+
+const int                       kPausedColorStepLevels   = 2;
+const std::chrono::milliseconds kPausedKeepAliveInterval { 1000 };
+
+
+std::optional<std::chrono::microseconds> PausedRedrawInterval (bool isPaused, bool overlaysActive, ColorScheme scheme)
+{
+    if (!isPaused || overlaysActive)
+    {
+        return std::nullopt;
+    }
+
+    if (scheme == ColorScheme::ColorCycle)
+    {
+        return std::chrono::microseconds (static_cast<int64_t> (GetColorCycleRedrawInterval (kPausedColorStepLevels) * 1'000'000.0f));
+    }
+
+    return kPausedKeepAliveInterval;
+}
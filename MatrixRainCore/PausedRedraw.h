@@ -0,0 +1,23 @@
+#pragma once
+
+#include <chrono>
+
+#include "ColorScheme.h"
+
+
+
+
+// Paused low-power mode: how long a paused render thread may wait before
+// its next redraw, or nullopt to keep rendering every frame.  Paused rain
+// is frozen, so only overlays and the color cycle still move:
+//   - An active overlay animates, so it gets every frame.
+//   - ColorCycle is redrawn whenever its fastest channel has moved
+//     kPausedColorStepLevels levels (GetColorCycleRedrawInterval).
+//   - Anything else is a still picture; the thread sleeps for
+//     kPausedKeepAliveInterval, which only refreshes the statistics line.
+// State changes (resume, settings, overlay keys) wake the thread through
+// RenderWakeSignal, so none of these intervals delays them.
+std::optional<std::chrono::microseconds> PausedRedrawInterval (bool isPaused, bool overlaysActive, ColorScheme scheme);
+
+extern const int                       kPausedColorStepLevels;
+extern const std::chrono::milliseconds kPausedKeepAliveInterval;
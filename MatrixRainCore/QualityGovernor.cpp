@@ -0,0 +1,500 @@
+#include "pch.h"
+
+#include "QualityGovernor.h"
+
+
+
+
+// A raise undone within this many windows of landing is treated as having
+// failed, and backs off the next attempt
+static constexpr int s_kUpshiftProbationWindows = 2;
+
+static constexpr QualityKnob s_kLadder[] =
+{
+    QualityKnob::BlurPasses,
+    QualityKnob::BlurTaps,
+    QualityKnob::BloomResolution,
+    QualityKnob::Density
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  QualityLevel equality
+//
+////////////////////////////////////////////////////////////////////////////////
+
+bool operator== (const QualityLevel & a, const QualityLevel & b)
+{
+    return a.graphics       == b.graphics       &&
+           a.densityPercent == b.densityPercent &&
+           a.glowEnabled    == b.glowEnabled;
+}
+
+
+bool operator!= (const QualityLevel & a, const QualityLevel & b)
+{
+    return !(a == b);
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  QualityKnobName
+//
+////////////////////////////////////////////////////////////////////////////////
+
+const wchar_t * QualityKnobName (QualityKnob knob)
+{
+    switch (knob)
+    {
+        case QualityKnob::BlurPasses:      return L"blur passes";
+        case QualityKnob::BlurTaps:        return L"blur taps";
+        case QualityKnob::BloomResolution: return L"bloom resolution divisor";
+        case QualityKnob::Density:         return L"density";
+    }
+
+    return L"?";
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  FormatQualityDecision
+//
+////////////////////////////////////////////////////////////////////////////////
+
+static int KnobValue (const QualityLevel & level, QualityKnob knob)
+{
+    switch (knob)
+    {
+        case QualityKnob::BlurPasses:      return level.graphics.m_blurPasses;
+        case QualityKnob::BlurTaps:        return static_cast<int> (level.graphics.m_blurTaps);
+        case QualityKnob::BloomResolution: return static_cast<int> (level.graphics.m_bloomResolutionDivisor);
+        case QualityKnob::Density:         return level.densityPercent;
+    }
+
+    return 0;
+}
+
+
+std::wstring FormatQualityDecision (const QualityDecision & decision)
+{
+    return std::format (L"Quality governor: frame {}, p95 {:.1f} ms, target {:.1f} ms: {} {} {} -> {}\n",
+                        decision.frame,
+                        static_cast<double> (decision.p95Us)    / 1000.0,
+                        static_cast<double> (decision.targetUs) / 1000.0,
+                        decision.downshift ? L"lowered" : L"raised",
+                        QualityKnobName (decision.knob),
+                        KnobValue (decision.before, decision.knob),
+                        KnobValue (decision.after,  decision.knob));
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  QualityGovernor::QualityGovernor
+//
+////////////////////////////////////////////////////////////////////////////////
+
+QualityGovernor::QualityGovernor (QualityGovernorConfig config) :
+    m_config (config)
+{
+    Restart();
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  QualityGovernor::Configure
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void QualityGovernor::Configure (const QualityLevel & ceiling, int64_t targetFrameUs)
+{
+    if (ceiling == m_ceiling && targetFrameUs == m_config.targetFrameUs)
+    {
+        return;
+    }
+
+    m_ceiling              = ceiling;
+    m_config.targetFrameUs = targetFrameUs;
+
+    Restart();
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  QualityGovernor::Restart
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void QualityGovernor::Restart()
+{
+    m_level                  = m_ceiling;
+    m_settleRemaining        = m_config.settleFrames;
+    m_calmWindows            = 0;
+    m_upshiftWindowsRequired = m_config.upshiftWindows;
+    m_windowsSinceUpshift    = -1;
+
+    m_window.Reset();
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  QualityGovernor::RecordFrame
+//
+////////////////////////////////////////////////////////////////////////////////
+
+bool QualityGovernor::RecordFrame (int64_t costUs)
+{
+    int64_t target  = m_config.targetFrameUs;
+    int64_t p95Us   = 0;
+    bool    changed = false;
+
+
+
+    m_frame++;
+
+    if (target <= 0)
+    {
+        return false;
+    }
+
+    if (m_settleRemaining > 0)
+    {
+        m_settleRemaining--;
+        return false;
+    }
+
+    m_window.Record (costUs);
+
+    if (m_window.GetCount() < static_cast<uint64_t> (m_config.windowFrames))
+    {
+        return false;
+    }
+
+    p95Us = m_window.GetPercentile (95.0);
+    m_window.Reset();
+
+    if (m_windowsSinceUpshift >= 0)
+    {
+        m_windowsSinceUpshift++;
+    }
+
+    if (static_cast<double> (p95Us) > static_cast<double> (target) * m_config.downshiftRatio)
+    {
+        // Over budget.  If the last raise has not yet proven itself, it is
+        // what broke the budget: make the next attempt wait twice as long.
+        if (m_windowsSinceUpshift >= 0 && m_windowsSinceUpshift <= s_kUpshiftProbationWindows)
+        {
+            m_upshiftWindowsRequired = std::min (m_upshiftWindowsRequired * 2, m_config.maxUpshiftWindows);
+        }
+
+        m_windowsSinceUpshift = -1;
+        m_calmWindows         = 0;
+        changed               = Downshift (p95Us);
+    }
+    else
+    {
+        if (m_windowsSinceUpshift > s_kUpshiftProbationWindows)
+        {
+            m_windowsSinceUpshift    = -1;
+            m_upshiftWindowsRequired = m_config.upshiftWindows;
+        }
+
+        if (static_cast<double> (p95Us) < static_cast<double> (target) * m_config.upshiftRatio)
+        {
+            m_calmWindows++;
+        }
+        else
+        {
+            m_calmWindows = 0;
+        }
+
+        if (m_calmWindows >= m_upshiftWindowsRequired)
+        {
+            m_calmWindows = 0;
+            changed       = Upshift (p95Us);
+
+            if (changed)
+            {
+                m_windowsSinceUpshift = 0;
+            }
+        }
+    }
+
+    if (changed)
+    {
+        m_settleRemaining = m_config.settleFrames;
+    }
+
+    return changed;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  QualityGovernor::Downshift
+//
+//  Lowers the first knob on the ladder that still has somewhere to go.
+//  False when everything is already at its floor.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+bool QualityGovernor::Downshift (int64_t p95Us)
+{
+    for (QualityKnob knob : s_kLadder)
+    {
+        if (CanLower (knob))
+        {
+            QualityLevel before = m_level;
+
+            Lower (knob);
+            Log   (knob, true, p95Us, before);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  QualityGovernor::Upshift
+//
+//  Raises the last knob on the ladder that is below the ceiling, undoing
+//  the most recent downshift first.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+bool QualityGovernor::Upshift (int64_t p95Us)
+{
+    for (auto it = std::rbegin (s_kLadder); it != std::rend (s_kLadder); ++it)
+    {
+        if (CanRaise (*it))
+        {
+            QualityLevel before = m_level;
+
+            Raise (*it);
+            Log   (*it, false, p95Us, before);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  QualityGovernor::CanLower
+//
+//  A knob is only worth lowering if it costs something at the current
+//  level: none of the bloom knobs do while glow is off, and the dual
+//  filter ignores the tap count.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+bool QualityGovernor::CanLower (QualityKnob knob) const
+{
+    const AdvancedGraphicsValues & graphics = m_level.graphics;
+    bool                           bloomOn  = m_level.glowEnabled && graphics.m_glowIntensityPercent > 0;
+
+
+
+    switch (knob)
+    {
+        case QualityKnob::BlurPasses:
+            return bloomOn && graphics.m_blurPasses > 1;
+
+        case QualityKnob::BlurTaps:
+            return bloomOn && graphics.m_bloomAlgorithm == BloomAlgorithm::Gaussian && graphics.m_blurTaps != BlurTaps::Low;
+
+        case QualityKnob::BloomResolution:
+            return bloomOn && graphics.m_bloomResolutionDivisor != ResolutionDivisor::Eighth;
+
+        case QualityKnob::Density:
+            return m_level.densityPercent > m_config.minDensityPercent;
+    }
+
+    return false;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  QualityGovernor::CanRaise
+//
+////////////////////////////////////////////////////////////////////////////////
+
+bool QualityGovernor::CanRaise (QualityKnob knob) const
+{
+    const AdvancedGraphicsValues & level   = m_level.graphics;
+    const AdvancedGraphicsValues & ceiling = m_ceiling.graphics;
+
+
+
+    switch (knob)
+    {
+        case QualityKnob::BlurPasses:
+            return level.m_blurPasses < ceiling.m_blurPasses;
+
+        case QualityKnob::BlurTaps:
+            return static_cast<int> (level.m_blurTaps) < static_cast<int> (ceiling.m_blurTaps);
+
+        case QualityKnob::BloomResolution:
+            return static_cast<int> (level.m_bloomResolutionDivisor) > static_cast<int> (ceiling.m_bloomResolutionDivisor);
+
+        case QualityKnob::Density:
+            return m_level.densityPercent < m_ceiling.densityPercent;
+    }
+
+    return false;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  QualityGovernor::Lower
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void QualityGovernor::Lower (QualityKnob knob)
+{
+    AdvancedGraphicsValues & graphics = m_level.graphics;
+
+
+
+    switch (knob)
+    {
+        case QualityKnob::BlurPasses:
+            graphics.m_blurPasses--;
+            break;
+
+        case QualityKnob::BlurTaps:
+            graphics.m_blurTaps = graphics.m_blurTaps == BlurTaps::High ? BlurTaps::Medium : BlurTaps::Low;
+            break;
+
+        case QualityKnob::BloomResolution:
+            graphics.m_bloomResolutionDivisor = static_cast<ResolutionDivisor> (static_cast<int> (graphics.m_bloomResolutionDivisor) * 2);
+            break;
+
+        case QualityKnob::Density:
+            m_level.densityPercent = std::max (m_level.densityPercent - m_config.densityStep, m_config.minDensityPercent);
+            break;
+    }
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  QualityGovernor::Raise
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void QualityGovernor::Raise (QualityKnob knob)
+{
+    AdvancedGraphicsValues & graphics = m_level.graphics;
+
+
+
+    switch (knob)
+    {
+        case QualityKnob::BlurPasses:
+            graphics.m_blurPasses++;
+            break;
+
+        case QualityKnob::BlurTaps:
+            graphics.m_blurTaps = graphics.m_blurTaps == BlurTaps::Low ? BlurTaps::Medium : BlurTaps::High;
+            break;
+
+        case QualityKnob::BloomResolution:
+            graphics.m_bloomResolutionDivisor = static_cast<ResolutionDivisor> (static_cast<int> (graphics.m_bloomResolutionDivisor) / 2);
+            break;
+
+        case QualityKnob::Density:
+            m_level.densityPercent = std::min (m_level.densityPercent + m_config.densityStep, m_ceiling.densityPercent);
+            break;
+    }
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  QualityGovernor::Log
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void QualityGovernor::Log (QualityKnob knob, bool downshift, int64_t p95Us, const QualityLevel & before)
+{
+    QualityDecision decision
+    {
+        .frame     = m_frame,
+        .knob      = knob,
+        .downshift = downshift,
+        .p95Us     = p95Us,
+        .targetUs  = m_config.targetFrameUs,
+        .before    = before,
+        .after     = m_level,
+    };
+
+
+
+    m_decisions.push_back (decision);
+
+    if (m_decisions.size() > s_kDecisionLogCapacity)
+    {
+        m_decisions.pop_front();
+    }
+
+    if (m_sink)
+    {
+        m_sink (decision);
+    }
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "QualityPresets.h"
+#include "TimingHistogram.h"
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  QualityLevel — Everything the governor may trade for frame time
+//
+//  The advanced graphics values plus rain density.  glowEnabled is not a
+//  knob; it tells the governor whether the bloom knobs cost anything.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+struct QualityLevel
+{
+    AdvancedGraphicsValues graphics;
+    int                    densityPercent { 50   };
+    bool                   glowEnabled    { true };
+};
+
+
+bool operator== (const QualityLevel & a, const QualityLevel & b);
+bool operator!= (const QualityLevel & a, const QualityLevel & b);
+
+
+
+
+// The knobs in the order the governor lowers them: cheapest to give up
+// visually first, density only once the glow has nothing left to give.
+// Raising walks the same ladder in reverse.
+enum class QualityKnob
+{
+    BlurPasses,
+    BlurTaps,
+    BloomResolution,
+    Density
+};
+
+
+const wchar_t * QualityKnobName (QualityKnob knob);
+
+
+
+
+struct QualityGovernorConfig
+{
+    int64_t targetFrameUs     { 0    };     // 0 = governor off; the level stays at the ceiling
+    int     windowFrames      { 30   };     // frames per measurement window
+    int     settleFrames      { 10   };     // frames ignored after a change (resource rebuilds, caches)
+    double  downshiftRatio    { 1.0  };     // lower when window p95 > target * this
+    double  upshiftRatio      { 0.7  };     // raise when window p95 < target * this ...
+    int     upshiftWindows    { 4    };     // ... for this many windows in a row
+    int     maxUpshiftWindows { 64   };     // cap on the backoff after a failed raise
+    int     minDensityPercent { 20   };
+    int     densityStep       { 10   };
+};
+
+
+
+
+struct QualityDecision
+{
+    uint64_t     frame     { 0 };
+    QualityKnob  knob      { QualityKnob::BlurPasses };
+    bool         downshift { true };
+    int64_t      p95Us     { 0 };
+    int64_t      targetUs  { 0 };
+    QualityLevel before;
+    QualityLevel after;
+};
+
+
+// One line for the debugger log, e.g.
+//   "Quality governor: frame 1830, p95 19.4 ms, target 16.7 ms: lowered blur passes 3 -> 2"
+std::wstring FormatQualityDecision (const QualityDecision & decision);
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  QualityGovernor — Closed-loop quality control toward a target frame time
+//
+//  Fed one cost sample per frame (the render thread's CPU work or the
+//  GPU's time for the frame, whichever is larger), it steps the quality
+//  level one notch at a time to hold the p95 of each window of frames
+//  under the target:
+//
+//   - A window whose p95 exceeds the target lowers the next knob on the
+//     ladder that can still go down and does anything with the current
+//     level (taps do nothing under the dual filter; no bloom knob does
+//     while glow is off).
+//   - Only after upshiftWindows consecutive windows comfortably under the
+//     target (p95 < target * upshiftRatio) is the most recently lowered
+//     knob raised again, never past the ceiling.  The gap between the two
+//     thresholds is the hysteresis that keeps a level which just fits
+//     from flapping.
+//   - A raise that has to be undone within the next couple of windows
+//     doubles the calm windows required before the next one (up to
+//     maxUpshiftWindows), so a marginal level is probed ever more rarely
+//     instead of on a fixed beat.  A raise that holds resets the backoff.
+//   - The frames right after any change are discarded before measuring
+//     again, so one-off costs such as reallocating bloom targets are not
+//     mistaken for the new level's steady cost.
+//
+//  The ceiling is the user's chosen level; changing it (or the target)
+//  starts over from the new ceiling.  Each change is recorded as a
+//  QualityDecision in a bounded log and handed to the optional sink.
+//
+//  Not thread-safe: owned and driven by one render thread.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class QualityGovernor
+{
+public:
+    static constexpr size_t s_kDecisionLogCapacity = 64;
+
+    using DecisionSink = std::function<void (const QualityDecision &)>;
+
+    explicit QualityGovernor (QualityGovernorConfig config = {});
+
+    // Call each frame before using GetLevel; a no-op unless something changed
+    void Configure (const QualityLevel & ceiling, int64_t targetFrameUs);
+
+    // True when the frame completed a window that changed the level
+    bool RecordFrame (int64_t costUs);
+
+    const QualityLevel                & GetLevel()                  const { return m_level;                  }
+    const QualityLevel                & GetCeiling()                const { return m_ceiling;                }
+    const QualityGovernorConfig       & GetConfig()                 const { return m_config;                 }
+    const std::deque<QualityDecision> & GetDecisions()              const { return m_decisions;              }
+    int                                 GetUpshiftWindowsRequired() const { return m_upshiftWindowsRequired; }
+
+    void SetDecisionSink (DecisionSink sink) { m_sink = std::move (sink); }
+
+private:
+    void Restart();
+    bool Downshift (int64_t p95Us);
+    bool Upshift   (int64_t p95Us);
+    void Log       (QualityKnob knob, bool downshift, int64_t p95Us, const QualityLevel & before);
+
+    bool CanLower (QualityKnob knob) const;
+    bool CanRaise (QualityKnob knob) const;
+    void Lower    (QualityKnob knob);
+    void Raise    (QualityKnob knob);
+
+    QualityGovernorConfig       m_config;
+    QualityLevel                m_ceiling;
+    QualityLevel                m_level;
+    TimingHistogram             m_window;
+    uint64_t                    m_frame                  { 0 };
+    int                         m_settleRemaining        { 0 };
+    int                         m_calmWindows            { 0 };
+    int                         m_upshiftWindowsRequired { 0 };
+    int                         m_windowsSinceUpshift    { -1 };    // -1 = no raise on probation
+    std::deque<QualityDecision> m_decisions;
+    DecisionSink                m_sink;
+};
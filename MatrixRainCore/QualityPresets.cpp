@@ -13,6 +13,20 @@ const uint64_t     kHeavyTotalPixelsThreshold = 16'000'000ull;
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+//
+//  DualFilterLevelCount
+//
+////////////////////////////////////////////////////////////////////////////////
+
+int DualFilterLevelCount (int blurPasses)
+{
+    return std::clamp (blurPasses, 1, 4) + 1;
+}
+
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 //  AdvancedGraphicsValues equality
@@ -24,7 +38,8 @@ bool operator== (const AdvancedGraphicsValues & a, const AdvancedGraphicsValues
     return a.m_glowIntensityPercent    == b.m_glowIntensityPercent &&
            a.m_blurPasses              == b.m_blurPasses &&
            a.m_bloomResolutionDivisor  == b.m_bloomResolutionDivisor &&
-           a.m_blurTaps                == b.m_blurTaps;
+           a.m_blurTaps                == b.m_blurTaps &&
+           a.m_bloomAlgorithm          == b.m_bloomAlgorithm;
 }
 
 
@@ -47,19 +62,19 @@ AdvancedGraphicsValues LookupPresetValues (QualityPreset preset)
     switch (preset)
     {
         case QualityPreset::Low:
-            return AdvancedGraphicsValues { 75,  1, ResolutionDivisor::Quarter, BlurTaps::Low    };
+            return AdvancedGraphicsValues { 75,  1, ResolutionDivisor::Quarter, BlurTaps::Low,    BloomAlgorithm::Gaussian };
 
         case QualityPreset::Medium:
-            return AdvancedGraphicsValues { 100, 2, ResolutionDivisor::Half,    BlurTaps::Medium };
+            return AdvancedGraphicsValues { 100, 2, ResolutionDivisor::Half,    BlurTaps::Medium, BloomAlgorithm::Gaussian };
 
         case QualityPreset::High:
-            return AdvancedGraphicsValues { 100, 3, ResolutionDivisor::Half,    BlurTaps::High   };
+            return AdvancedGraphicsValues { 100, 3, ResolutionDivisor::Half,    BlurTaps::High,   BloomAlgorithm::Gaussian };
 
         case QualityPreset::Custom:
         default:
             // Caller precondition violation; return High as a safe default.
             ASSERT (false);
-            return AdvancedGraphicsValues { 100, 3, ResolutionDivisor::Half,    BlurTaps::High   };
+            return AdvancedGraphicsValues { 100, 3, ResolutionDivisor::Half,    BlurTaps::High,   BloomAlgorithm::Gaussian };
     }
 }
 
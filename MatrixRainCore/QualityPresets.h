@@ -55,12 +55,50 @@ enum class BlurTaps : int
 
 
 
+// Blur used for the glow.  Gaussian is the tap-based blur selected by
+// BlurTaps and repeated per blur pass; IteratedBox replaces the whole
+// chain with three running-sum box filters of matching variance, so its
+// cost does not grow with glow size or pass count.  Software renderer
+// only for now; the GPU path always uses Gaussian.
+enum class GlowKernel : int
+{
+    Gaussian    = 0,
+    IteratedBox = 1
+};
+
+
+
+
+// How the glow is blurred.  Gaussian runs the separable blur (BlurTaps,
+// blurPasses times) at the bloom resolution.  DualFilter instead builds a
+// mip chain from the bloom buffer with 4-tap downsamples and walks back up
+// with tent upsamples, blending each level in, so the glow reaches much
+// further for far fewer texel reads; blurPasses sets the chain depth and
+// BlurTaps is unused.
+enum class BloomAlgorithm : int
+{
+    Gaussian   = 0,
+    DualFilter = 1
+};
+
+
+
+
+// Levels the dual filter downsamples below the bloom buffer: one more than
+// the blur pass count, so the default preset's glow reaches about as far
+// as its Gaussian.
+int DualFilterLevelCount (int blurPasses);
+
+
+
+
 struct AdvancedGraphicsValues
 {
     int                m_glowIntensityPercent { 100                       };  // 0..200; 0 = glow disabled
     int                m_blurPasses           { 3                         };  // 1..4
     ResolutionDivisor  m_bloomResolutionDivisor { ResolutionDivisor::Half };
     BlurTaps           m_blurTaps             { BlurTaps::High            };
+    BloomAlgorithm     m_bloomAlgorithm       { BloomAlgorithm::Gaussian  };
 };
 
 
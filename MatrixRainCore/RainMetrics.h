@@ -0,0 +1,56 @@
+#pragma once
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  Rain glyph metrics
+//
+//  Base quad size of a rain character and the viewport-driven scale applied
+//  on top of it.  Shared by the GPU and software renderers so both place
+//  identical quads for the same frame.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+static constexpr float s_kRainCharWidth      = 24.0f;
+static constexpr float s_kRainCharHeight     = 36.0f;
+static constexpr float s_kReferenceHeight    = 1080.0f;   // Viewport height at which scale = 1 (per DPI unit)
+static constexpr float s_kMinViewportScale   = 0.5f;      // Keeps preview-mode characters legible
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  ComputeRainCharacterScale
+//
+//  Scale down proportionally for preview mode so the whole effect fits,
+//  clamped so characters stay visible.  The base quad is in physical
+//  pixels, so the result is multiplied by the DPI scale to keep a constant
+//  logical size; the reference height is DPI-adjusted for the same reason.
+//  An explicit override (e.g. UsageDialog forcing full-size characters)
+//  bypasses both — the caller handles its own DPI scaling.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+inline float ComputeRainCharacterScale (float viewportHeight, float dpiScale, std::optional<float> overrideScale)
+{
+    float referenceHeight   = s_kReferenceHeight * dpiScale;
+    float viewportBaseScale = 1.0f;
+
+
+
+    if (overrideScale.has_value())
+    {
+        return overrideScale.value();
+    }
+
+    if (viewportHeight < referenceHeight)
+    {
+        viewportBaseScale = std::max (viewportHeight / referenceHeight, s_kMinViewportScale);
+    }
+
+    return viewportBaseScale * dpiScale;
+}
@@ -105,6 +105,18 @@ HRESULT RegistrySettingsProvider::Load (ScreenSaverSettings & settings)
                 default: v.m_blurTaps = BlurTaps::High;
             }
 
+            // Added after the four values above, so it is optional: keys
+            // written before it existed load as the Gaussian blur.
+            {
+                int bloomAlgorithm = 0;
+
+                if (ReadInt (hKey, VALUE_LASTCUSTOM_BLOOM_ALGORITHM, bloomAlgorithm) == S_OK &&
+                    bloomAlgorithm == static_cast<int> (BloomAlgorithm::DualFilter))
+                {
+                    v.m_bloomAlgorithm = BloomAlgorithm::DualFilter;
+                }
+            }
+
             settings.m_lastCustom = v;
         }
     }
@@ -121,6 +133,21 @@ HRESULT RegistrySettingsProvider::Load (ScreenSaverSettings & settings)
         settings.m_advancedValues = LookupPresetValues (settings.m_qualityPreset);
     }
 
+    // Adaptive quality target (REG_DWORD, microseconds); absent = off
+    ReadInt (hKey, VALUE_ADAPTIVE_QUALITY_TARGET_US, settings.m_adaptiveQualityTargetUs);
+
+    // Render workers (REG_DWORD); absent = one render thread per monitor
+    ReadInt (hKey, VALUE_RENDER_WORKERS, settings.m_renderWorkers);
+
+    // Shared simulation (REG_DWORD bool); absent = one simulation per monitor
+    ReadBool (hKey, VALUE_SHARED_SIMULATION, settings.m_sharedSimulation);
+
+    // Simulation thread (REG_DWORD bool); absent = simulate on the render thread
+    ReadBool (hKey, VALUE_SIMULATION_THREAD, settings.m_simulationThread);
+
+    // Frame trace output (REG_SZ path); absent or empty = tracing off
+    ReadString (hKey, VALUE_TRACE_FILE, settings.m_traceFile);
+
     // v1.5 US5 (T061, FR-030, FR-031, FR-035, contracts/registry-schema.md):
     // CustomColor (REG_DWORD) — absent means the chooser falls back to
     // ScreenSaverSettings::DEFAULT_CUSTOM_COLOR on first invocation.
@@ -289,8 +316,26 @@ HRESULT RegistrySettingsProvider::Save (const ScreenSaverSettings & settings)
 
         hr = WriteInt (hKey, VALUE_LASTCUSTOM_SMOOTHNESS,     static_cast<int> (settings.m_lastCustom->m_blurTaps));
         CHR (hr);
+
+        hr = WriteInt (hKey, VALUE_LASTCUSTOM_BLOOM_ALGORITHM, static_cast<int> (settings.m_lastCustom->m_bloomAlgorithm));
+        CHR (hr);
     }
 
+    hr = WriteInt (hKey, VALUE_ADAPTIVE_QUALITY_TARGET_US, settings.m_adaptiveQualityTargetUs);
+    CHR (hr);
+
+    hr = WriteInt (hKey, VALUE_RENDER_WORKERS, settings.m_renderWorkers);
+    CHR (hr);
+
+    hr = WriteBool (hKey, VALUE_SHARED_SIMULATION, settings.m_sharedSimulation);
+    CHR (hr);
+
+    hr = WriteBool (hKey, VALUE_SIMULATION_THREAD, settings.m_simulationThread);
+    CHR (hr);
+
+    hr = WriteString (hKey, VALUE_TRACE_FILE, settings.m_traceFile);
+    CHR (hr);
+
     // v1.5 US5 (T061, FR-030, FR-031, FR-035): CustomColor + palette.
     // Both are written unconditionally on every Save (not gated on
     // colorScheme == Custom or palette non-empty) so a freshly-edited
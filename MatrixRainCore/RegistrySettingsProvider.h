@@ -33,14 +33,20 @@ private:
     static constexpr LPCWSTR VALUE_SCANLINES_STYLE        = L"ScanlinesStyle";
     static constexpr LPCWSTR VALUE_START_FULLSCREEN       = L"StartFullscreen";
     static constexpr LPCWSTR VALUE_SHOW_DEBUG_STATS       = L"ShowDebugStats";
-    static constexpr LPCWSTR VALUE_MULTIMONITOR              = L"MultiMonitor";
-    static constexpr LPCWSTR VALUE_GPU_ADAPTER               = L"GpuAdapter";
-    static constexpr LPCWSTR VALUE_QUALITY_PRESET            = L"QualityPreset";
-    static constexpr LPCWSTR VALUE_LASTCUSTOM_GLOW_INTENSITY = L"LastCustom_GlowIntensity";
-    static constexpr LPCWSTR VALUE_LASTCUSTOM_PASSES         = L"LastCustom_Passes";
-    static constexpr LPCWSTR VALUE_LASTCUSTOM_RESOLUTION     = L"LastCustom_Resolution";
-    static constexpr LPCWSTR VALUE_LASTCUSTOM_SMOOTHNESS     = L"LastCustom_Smoothness";
-    static constexpr LPCWSTR VALUE_LAST_SAVED                = L"LastSaved";
+    static constexpr LPCWSTR VALUE_MULTIMONITOR               = L"MultiMonitor";
+    static constexpr LPCWSTR VALUE_GPU_ADAPTER                = L"GpuAdapter";
+    static constexpr LPCWSTR VALUE_QUALITY_PRESET             = L"QualityPreset";
+    static constexpr LPCWSTR VALUE_LASTCUSTOM_GLOW_INTENSITY  = L"LastCustom_GlowIntensity";
+    static constexpr LPCWSTR VALUE_LASTCUSTOM_PASSES          = L"LastCustom_Passes";
+    static constexpr LPCWSTR VALUE_LASTCUSTOM_RESOLUTION      = L"LastCustom_Resolution";
+    static constexpr LPCWSTR VALUE_LASTCUSTOM_SMOOTHNESS      = L"LastCustom_Smoothness";
+    static constexpr LPCWSTR VALUE_LASTCUSTOM_BLOOM_ALGORITHM = L"LastCustom_BloomAlgorithm";
+    static constexpr LPCWSTR VALUE_ADAPTIVE_QUALITY_TARGET_US = L"AdaptiveQualityTargetUs";
+    static constexpr LPCWSTR VALUE_RENDER_WORKERS             = L"RenderWorkers";
+    static constexpr LPCWSTR VALUE_SHARED_SIMULATION          = L"SharedSimulation";
+    static constexpr LPCWSTR VALUE_SIMULATION_THREAD          = L"SimulationThread";
+    static constexpr LPCWSTR VALUE_TRACE_FILE                 = L"TraceFile";
+    static constexpr LPCWSTR VALUE_LAST_SAVED                 = L"LastSaved";
 
     // v1.5 US5 (T061, FR-030, FR-031, FR-035, contracts/registry-schema.md):
     // CustomColor (REG_DWORD) is the user-picked streak color (COLORREF).
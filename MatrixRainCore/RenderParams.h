@@ -1,6 +1,7 @@
 #pragma once
 
 #include "ColorScheme.h"
+#include "FrameTiming.h"
 
 
 
@@ -41,4 +42,8 @@ struct RenderParams
     float           scanlinesIntensity = 0.30f;     // normalised [0..1] from settings 1..100
     float           scanlinesLineCount = 150.0f;    // ScanlineStyleMapping::ComputeLineCount(style)
     COLORREF        customColor        = RGB (0, 255, 0);
+
+    // Frame-time percentiles of this context's last completed timing
+    // window, for the statistics line (count == 0 until the first window)
+    FrameTimingPercentiles frameTime   = {};
 };
@@ -5,8 +5,10 @@
 #include "CharacterConstants.h"
 #include "CharacterSet.h"
 #include "ColorScheme.h"
+#include "FrameTrace.h"
 #include "Overlay.h"
 #include "OverlayColor.h"
+#include "RainMetrics.h"
 
 #pragma comment(lib, "pdh.lib")
 
@@ -320,7 +322,10 @@ HRESULT RenderSystem::Initialize (HWND hwnd, UINT width, UINT height, std::optio
     hr = CreateDummyVertexBuffer();
     CHR (hr);
 
-    hr = CreateInstanceBuffer();
+    hr = CreateRainStaticBuffer();
+    CHR (hr);
+
+    hr = CreateRainStreamBuffer();
     CHR (hr);
 
     hr = CreateConstantBuffer();
@@ -338,6 +343,9 @@ HRESULT RenderSystem::Initialize (HWND hwnd, UINT width, UINT height, std::optio
     hr = CreateSamplerState();
     CHR (hr);
 
+    hr = CreateGpuTimerQueries();
+    CHR (hr);
+
     // Compute DPI scale BEFORE creating D2D resources so font sizes are correct
     UpdateDpiScale();
 
@@ -622,6 +630,74 @@ static const char* s_kszVertexShaderSource = R"(
         }
     )";
 
+static const char * s_kszRainVertexShaderSource = R"(
+        cbuffer Constants : register(b0)
+        {
+            float4x4 projection;
+            float characterScale;  // Global scale for preview mode
+            float charWidth;       // Base quad width in pixels
+            float charHeight;      // Base quad height in pixels
+            float reserved;
+            float4 schemeColor;    // Trail tint for slots with schemeTint = 1
+        };
+
+        // Persistent per-slot record (matches RainInstanceStatic)
+        struct RainInstance
+        {
+            float2 position;
+            float2 scale;
+            float2 uvMin;
+            float2 uvMax;
+            float4 color;
+            float  schemeTint;
+            float3 padding;
+        };
+
+        StructuredBuffer<RainInstance> rainInstances : register(t0);
+
+        struct VSInput
+        {
+            uint  slot       : SLOT;
+            float brightness : BRIGHTNESS;
+        };
+
+        struct PSInput
+        {
+            float4 position : SV_POSITION;
+            float2 uv : TEXCOORD;
+            float4 color : COLOR;
+            float brightness : BRIGHTNESS;
+        };
+
+        static const float2 quadVertices[6] = {
+            float2(0.0, 0.0),
+            float2(1.0, 0.0),
+            float2(0.0, 1.0),
+            float2(1.0, 0.0),
+            float2(1.0, 1.0),
+            float2(0.0, 1.0)
+        };
+
+        PSInput main(VSInput input, uint vertexID : SV_VertexID)
+        {
+            PSInput      output;
+            RainInstance inst    = rainInstances[input.slot];
+            float2       quadPos = quadVertices[vertexID % 6];
+
+            float2 charSize = float2(charWidth, charHeight) * inst.scale * characterScale;
+            float2 worldPos = inst.position + quadPos * charSize;
+
+            // No depth test: draw order comes from the instance stream, so
+            // every quad sits on the near plane
+            output.position   = mul(projection, float4(worldPos, 0.0, 1.0));
+            output.uv         = lerp(inst.uvMin, inst.uvMax, quadPos);
+            output.color      = float4(lerp(inst.color.rgb, schemeColor.rgb, inst.schemeTint), inst.color.a);
+            output.brightness = input.brightness;
+
+            return output;
+        }
+    )";
+
 static const char* s_kszPixelShaderSource = R"(
         Texture2D atlasTexture : register(t0);
         SamplerState samplerState : register(s0);
@@ -686,6 +762,11 @@ static const D3D11_INPUT_ELEMENT_DESC s_krgInputLayout[] = {
     { "SCALEY",     0, DXGI_FORMAT_R32_FLOAT,          1, 52, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
 };
 
+static const D3D11_INPUT_ELEMENT_DESC s_krgRainInputLayout[] = {
+    { "SLOT",       0, DXGI_FORMAT_R32_UINT,           1, 0,  D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+    { "BRIGHTNESS", 0, DXGI_FORMAT_R32_FLOAT,          1, 4,  D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+};
+
 
 
 
@@ -766,10 +847,12 @@ HRESULT RenderSystem::CompileCharacterShaders()
 {
     HRESULT             hr            = S_OK;
     ComPtr<ID3DBlob>    vsBlob;
+    ComPtr<ID3DBlob>    rainVsBlob;
     ComPtr<ID3DBlob>    psBlob;
     ComPtr<ID3DBlob>    overlayPsBlob;
     ShaderCompileEntry  shaderTable[] = {
         { s_kszVertexShaderSource,        "VS",        "main", "vs_5_0",  L"D3DCompile failed for vertex shader",         vsBlob.GetAddressOf(),        nullptr                },
+        { s_kszRainVertexShaderSource,    "RainVS",    "main", "vs_5_0",  L"D3DCompile failed for rain vertex shader",    rainVsBlob.GetAddressOf(),    nullptr                },
         { s_kszPixelShaderSource,         "PS",        "main", "ps_5_0",  L"D3DCompile failed for pixel shader",          psBlob.GetAddressOf(),        &m_pixelShader         },
         { s_kszOverlayPixelShaderSource,  "OverlayPS", "main", "ps_5_0",  L"D3DCompile failed for overlay pixel shader",  overlayPsBlob.GetAddressOf(), &m_overlayPixelShader  }
     };
@@ -795,6 +878,19 @@ HRESULT RenderSystem::CompileCharacterShaders()
                                         &m_inputLayout);
     CHRA (hr);
 
+    // Rain path: slot-indexed structured buffer + thin instance stream
+    hr = m_device->CreateVertexShader (rainVsBlob->GetBufferPointer(),
+                                        rainVsBlob->GetBufferSize(),
+                                        nullptr,
+                                        &m_rainVertexShader);
+    CHRA (hr);
+
+    hr = m_device->CreateInputLayout (s_krgRainInputLayout,
+                                        _countof (s_krgRainInputLayout),
+                                        rainVsBlob->GetBufferPointer(),
+                                        rainVsBlob->GetBufferSize(),
+                                        &m_rainInputLayout);
+    CHRA (hr);
 
 Error:
     return hr;
@@ -832,19 +928,62 @@ Error:
 
 
 
-HRESULT RenderSystem::CreateInstanceBuffer()
+////////////////////////////////////////////////////////////////////////////////
+//
+//  RenderSystem::CreateRainStaticBuffer
+//
+//  DEFAULT-usage structured buffer holding one RainInstanceStatic per slot.
+//  Only dirty spans are written (UpdateSubresource with a byte box), so
+//  unchanged characters cost nothing after their first frame.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+HRESULT RenderSystem::CreateRainStaticBuffer()
+{
+    HRESULT                         hr         = S_OK;
+    D3D11_BUFFER_DESC               bufferDesc = {};
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc    = {};
+
+
+
+    bufferDesc.ByteWidth           = sizeof (RainInstanceStatic) * m_rainStaticCapacity;
+    bufferDesc.Usage               = D3D11_USAGE_DEFAULT;
+    bufferDesc.BindFlags           = D3D11_BIND_SHADER_RESOURCE;
+    bufferDesc.MiscFlags           = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+    bufferDesc.StructureByteStride = sizeof (RainInstanceStatic);
+
+    hr = m_device->CreateBuffer (&bufferDesc, nullptr, &m_rainStaticBuffer);
+    CHRA (hr);
+
+    srvDesc.Format              = DXGI_FORMAT_UNKNOWN;
+    srvDesc.ViewDimension       = D3D11_SRV_DIMENSION_BUFFER;
+    srvDesc.Buffer.FirstElement = 0;
+    srvDesc.Buffer.NumElements  = m_rainStaticCapacity;
+
+    hr = m_device->CreateShaderResourceView (m_rainStaticBuffer.Get(), &srvDesc, &m_rainStaticSRV);
+    CHRA (hr);
+
+Error:
+    return hr;
+}
+
+
+
+
+
+HRESULT RenderSystem::CreateRainStreamBuffer()
 {
     HRESULT           hr         = S_OK;
     D3D11_BUFFER_DESC bufferDesc = {};
 
 
 
-    bufferDesc.ByteWidth      = sizeof (CharacterInstanceData) * m_instanceBufferCapacity;
+    bufferDesc.ByteWidth      = sizeof (RainInstanceStream) * m_rainStreamCapacity;
     bufferDesc.Usage          = D3D11_USAGE_DYNAMIC;
     bufferDesc.BindFlags      = D3D11_BIND_VERTEX_BUFFER;
     bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
 
-    hr = m_device->CreateBuffer (&bufferDesc, nullptr, &m_instanceBuffer);
+    hr = m_device->CreateBuffer (&bufferDesc, nullptr, &m_rainStreamBuffer);
     CHRA (hr);
 
 Error:
@@ -970,6 +1109,85 @@ Error:
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+//
+//  RenderSystem::UploadScanlineRows
+//
+//  Brings the per-row scanline table up to date for this frame's line
+//  count, intensity and render height, and mirrors it into the R32_FLOAT
+//  buffer the fused composite shader reads at t2.  A steady frame does
+//  nothing; a changed setting rewrites render-height floats; a resize
+//  also recreates the buffer.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+HRESULT RenderSystem::UploadScanlineRows (const RenderParams & params)
+{
+    HRESULT hr      = S_OK;
+    bool    rebuilt = false;
+
+
+
+    CBREx (m_renderHeight > 0, E_UNEXPECTED);
+
+    rebuilt = m_scanlineRows.Update (m_renderHeight, params.scanlinesLineCount, params.scanlinesIntensity);
+
+    if (m_scanlineRowBuffer)
+    {
+        D3D11_BUFFER_DESC existingDesc = {};
+
+
+        m_scanlineRowBuffer->GetDesc (&existingDesc);
+
+        if (existingDesc.ByteWidth != m_scanlineRows.GetHeight() * sizeof (float))
+        {
+            m_scanlineRowSRV.Reset();
+            m_scanlineRowBuffer.Reset();
+        }
+    }
+
+    if (!m_scanlineRowBuffer)
+    {
+        D3D11_BUFFER_DESC                bufferDesc = {};
+        D3D11_SUBRESOURCE_DATA           initData   = {};
+        D3D11_SHADER_RESOURCE_VIEW_DESC  srvDesc    = {};
+
+
+        bufferDesc.ByteWidth = m_scanlineRows.GetHeight() * sizeof (float);
+        bufferDesc.Usage     = D3D11_USAGE_DEFAULT;
+        bufferDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+        initData.pSysMem = m_scanlineRows.GetRows().data();
+
+        hr = m_device->CreateBuffer (&bufferDesc, &initData, &m_scanlineRowBuffer);
+        CHRA (hr);
+
+        srvDesc.Format              = DXGI_FORMAT_R32_FLOAT;
+        srvDesc.ViewDimension       = D3D11_SRV_DIMENSION_BUFFER;
+        srvDesc.Buffer.FirstElement = 0;
+        srvDesc.Buffer.NumElements  = m_scanlineRows.GetHeight();
+
+        hr = m_device->CreateShaderResourceView (m_scanlineRowBuffer.Get(), &srvDesc, &m_scanlineRowSRV);
+        CHRA (hr);
+    }
+    else if (rebuilt)
+    {
+        m_context->UpdateSubresource (m_scanlineRowBuffer.Get(), 0, nullptr, m_scanlineRows.GetRows().data(), 0, 0);
+    }
+
+Error:
+    if (FAILED (hr))
+    {
+        m_scanlineRowSRV.Reset();
+        m_scanlineRowBuffer.Reset();
+    }
+
+    return hr;
+}
+
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 //  RenderSystem::ApplyScanlinePass (T051, contracts/scanline-shader.md)
@@ -987,6 +1205,7 @@ HRESULT RenderSystem::ApplyScanlinePass()
     HRESULT                    hr      = S_OK;
     ID3D11Buffer       * const nullCB  = nullptr;
     ID3D11ShaderResourceView * srv[1]  = {};
+    TraceZone                  zone ("ScanlinePass");
 
 
 
@@ -1018,6 +1237,67 @@ Error:
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+//
+//  RenderSystem::CreatePostBloomTarget (T051, contracts/scanline-shader.md)
+//
+//  Post-bloom intermediate target for the separate scanline pass, created
+//  the first time that pass runs.  With the fused composite + scanline
+//  shader nothing reads it, so it is never allocated.
+//
+//  Backbuffer dimensions + the same R8G8B8A8 format as the scene and bloom
+//  intermediates so the scanline PS can sample it at native resolution and
+//  write 1:1 to the swapchain backbuffer.  (The backbuffer is B8G8R8A8 for
+//  D2D interop; the channel-order difference is irrelevant because the
+//  scanline pass is a shader draw — sampler in, output-merger out, see
+//  ApplyScanlinePass — not a CopyResource, so the GPU handles the swizzle
+//  transparently.)  Released with the bloom resources on Resize, so the
+//  next frame that needs it reallocates it at the new size.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+HRESULT RenderSystem::CreatePostBloomTarget()
+{
+    HRESULT              hr            = S_OK;
+    D3D11_TEXTURE2D_DESC postBloomDesc = {};
+
+
+
+    BAIL_OUT_IF (m_postBloomRTV && m_postBloomSRV, S_OK);
+    CBREx (m_device && m_renderWidth > 0 && m_renderHeight > 0, E_UNEXPECTED);
+
+    postBloomDesc.Width             = m_renderWidth;
+    postBloomDesc.Height            = m_renderHeight;
+    postBloomDesc.MipLevels         = 1;
+    postBloomDesc.ArraySize         = 1;
+    postBloomDesc.Format            = DXGI_FORMAT_R8G8B8A8_UNORM;
+    postBloomDesc.SampleDesc.Count  = 1;
+    postBloomDesc.Usage             = D3D11_USAGE_DEFAULT;
+    postBloomDesc.BindFlags         = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
+
+    hr = m_device->CreateTexture2D (&postBloomDesc, nullptr, &m_postBloomTexture);
+    CHRA (hr);
+
+    hr = m_device->CreateRenderTargetView (m_postBloomTexture.Get(), nullptr, &m_postBloomRTV);
+    CHRA (hr);
+
+    hr = m_device->CreateShaderResourceView (m_postBloomTexture.Get(), nullptr, &m_postBloomSRV);
+    CHRA (hr);
+
+Error:
+    if (FAILED (hr))
+    {
+        m_postBloomSRV.Reset();
+        m_postBloomRTV.Reset();
+        m_postBloomTexture.Reset();
+    }
+
+    return hr;
+}
+
+
+
+
 HRESULT RenderSystem::CreateBlendState()
 {
     HRESULT          hr        = S_OK;
@@ -1081,6 +1361,36 @@ Error:
 
 
 
+HRESULT RenderSystem::CreateGpuTimerQueries()
+{
+    HRESULT          hr            = S_OK;
+    D3D11_QUERY_DESC disjointDesc  = { D3D11_QUERY_TIMESTAMP_DISJOINT, 0 };
+    D3D11_QUERY_DESC timestampDesc = { D3D11_QUERY_TIMESTAMP,          0 };
+
+
+
+    for (GpuTimerQueries & timer : m_gpuTimers)
+    {
+        hr = m_device->CreateQuery (&disjointDesc, &timer.disjoint);
+        CHRA (hr);
+
+        hr = m_device->CreateQuery (&timestampDesc, &timer.begin);
+        CHRA (hr);
+
+        hr = m_device->CreateQuery (&timestampDesc, &timer.end);
+        CHRA (hr);
+
+        timer.pending = false;
+    }
+
+Error:
+    return hr;
+}
+
+
+
+
+
 HRESULT RenderSystem::CreateDirect2DResources()
 {
     HRESULT              hr         = S_OK;
@@ -1500,6 +1810,121 @@ static const char * s_kszBlurVerticalShader5TapSource = R"(
         }
     )";
 
+// Dual-filter bloom (BloomAlgorithm::DualFilter).  The downsample reads
+// four bilinear taps glowSize source texels out on the diagonals; the
+// upsample is a tent over the coarser level (axis taps glowSize / 2 texels
+// out, weight 1; diagonal taps half that, weight 2; of 12), averaged with
+// the downsample already at the target size.  The final upsample into the
+// bloom texture has no such level to blend.  SoftwareBloom mirrors these.
+static const char * s_kszDualDownsampleShaderSource = R"(
+        cbuffer BloomConstants : register(b0)
+        {
+            float bloomIntensity;
+            float glowSize;
+            float2 padding;
+        };
+
+        Texture2D inputTexture : register(t0);
+        SamplerState samplerState : register(s0);
+
+        struct PSInput
+        {
+            float4 position : SV_POSITION;
+            float2 uv : TEXCOORD;
+        };
+
+        float4 main(PSInput input) : SV_TARGET
+        {
+            uint width, height;
+            inputTexture.GetDimensions(width, height);
+            float2 offset = glowSize / float2(width, height);
+
+            float4 color = inputTexture.Sample(samplerState, input.uv + float2(-offset.x, -offset.y))
+                         + inputTexture.Sample(samplerState, input.uv + float2( offset.x, -offset.y))
+                         + inputTexture.Sample(samplerState, input.uv + float2(-offset.x,  offset.y))
+                         + inputTexture.Sample(samplerState, input.uv + float2( offset.x,  offset.y));
+
+            return float4(color.rgb * 0.25, 1.0);
+        }
+    )";
+
+static const char * s_kszDualUpsampleShaderSource = R"(
+        cbuffer BloomConstants : register(b0)
+        {
+            float bloomIntensity;
+            float glowSize;
+            float2 padding;
+        };
+
+        Texture2D coarseTexture : register(t0);
+        Texture2D fineTexture : register(t1);
+        SamplerState samplerState : register(s0);
+
+        struct PSInput
+        {
+            float4 position : SV_POSITION;
+            float2 uv : TEXCOORD;
+        };
+
+        float4 main(PSInput input) : SV_TARGET
+        {
+            uint width, height;
+            coarseTexture.GetDimensions(width, height);
+            float2 offset = 0.5 * glowSize / float2(width, height);
+            float2 half   = 0.5 * offset;
+
+            float4 axis = coarseTexture.Sample(samplerState, input.uv + float2(-offset.x, 0))
+                        + coarseTexture.Sample(samplerState, input.uv + float2( offset.x, 0))
+                        + coarseTexture.Sample(samplerState, input.uv + float2(0, -offset.y))
+                        + coarseTexture.Sample(samplerState, input.uv + float2(0,  offset.y));
+            float4 diag = coarseTexture.Sample(samplerState, input.uv + float2(-half.x, -half.y))
+                        + coarseTexture.Sample(samplerState, input.uv + float2( half.x, -half.y))
+                        + coarseTexture.Sample(samplerState, input.uv + float2(-half.x,  half.y))
+                        + coarseTexture.Sample(samplerState, input.uv + float2( half.x,  half.y));
+            float3 tent = axis.rgb * (1.0 / 12.0) + diag.rgb * (2.0 / 12.0);
+            float3 fine = fineTexture.Sample(samplerState, input.uv).rgb;
+
+            return float4(0.5 * (tent + fine), 1.0);
+        }
+    )";
+
+static const char * s_kszDualUpsampleFinalShaderSource = R"(
+        cbuffer BloomConstants : register(b0)
+        {
+            float bloomIntensity;
+            float glowSize;
+            float2 padding;
+        };
+
+        Texture2D coarseTexture : register(t0);
+        SamplerState samplerState : register(s0);
+
+        struct PSInput
+        {
+            float4 position : SV_POSITION;
+            float2 uv : TEXCOORD;
+        };
+
+        float4 main(PSInput input) : SV_TARGET
+        {
+            uint width, height;
+            coarseTexture.GetDimensions(width, height);
+            float2 offset = 0.5 * glowSize / float2(width, height);
+            float2 half   = 0.5 * offset;
+
+            float4 axis = coarseTexture.Sample(samplerState, input.uv + float2(-offset.x, 0))
+                        + coarseTexture.Sample(samplerState, input.uv + float2( offset.x, 0))
+                        + coarseTexture.Sample(samplerState, input.uv + float2(0, -offset.y))
+                        + coarseTexture.Sample(samplerState, input.uv + float2(0,  offset.y));
+            float4 diag = coarseTexture.Sample(samplerState, input.uv + float2(-half.x, -half.y))
+                        + coarseTexture.Sample(samplerState, input.uv + float2( half.x, -half.y))
+                        + coarseTexture.Sample(samplerState, input.uv + float2(-half.x,  half.y))
+                        + coarseTexture.Sample(samplerState, input.uv + float2( half.x,  half.y));
+
+            return float4(axis.rgb * (1.0 / 12.0) + diag.rgb * (2.0 / 12.0), 1.0);
+        }
+    )";
+
 static const char * s_kszBloomExtractShaderSource = R"(
         Texture2D inputTexture : register(t0);
         SamplerState samplerState : register(s0);
@@ -1571,6 +1996,43 @@ static const char * s_kszBloomCompositeShaderSource = R"(
         }
     )";
 
+// Composite with the scanline darkening folded in: the same math as the
+// composite above, then one multiply by the row's factor from the table
+// RenderSystem::UploadScanlineRows builds (ScanlineAttenuationTable, the
+// per-row form of the scanline shader).  Replaces the composite + separate
+// scanline pass pair when scanlines are on.
+static const char * s_kszBloomCompositeScanlineShaderSource = R"(
+        cbuffer BloomConstants : register(b0)
+        {
+            float bloomIntensity;
+            float glowSize;
+            float2 padding;
+        };
+
+        Texture2D sceneTexture : register(t0);
+        Texture2D bloomTexture : register(t1);
+        Buffer<float> rowAttenuation : register(t2);
+        SamplerState samplerState : register(s0);
+
+        struct PSInput
+        {
+            float4 position : SV_POSITION;
+            float2 uv : TEXCOORD;
+        };
+
+        float4 main(PSInput input) : SV_TARGET
+        {
+            float4 scene = sceneTexture.Sample(samplerState, input.uv);
+            float4 bloom = bloomTexture.Sample(samplerState, input.uv);
+
+            float3 bloomContrib = bloom.rgb * bloomIntensity;
+            float3 softBloom   = 1.0 - exp(-bloomContrib);
+            float3 color       = scene.rgb + softBloom * (1.0 - scene.rgb);
+
+            return float4(color * rowAttenuation.Load((int) input.position.y), 1.0);
+        }
+    )";
+
 static constexpr int MAX_HALO_ROWS = 16;  // Must match rowRects[] size in halo shader
 
 static const char * s_kszHaloShaderSource = R"(
@@ -1708,6 +2170,9 @@ HRESULT RenderSystem::CompileBloomShaders()
     ComPtr<ID3DBlob>       blurVPSBlob;
     ComPtr<ID3DBlob>       blurV9PSBlob;
     ComPtr<ID3DBlob>       blurV5PSBlob;
+    ComPtr<ID3DBlob>       dualDownPSBlob;
+    ComPtr<ID3DBlob>       dualUpPSBlob;
+    ComPtr<ID3DBlob>       dualFinalPSBlob;
     ComPtr<ID3DBlob>       compositePSBlob;
     ComPtr<ID3DBlob>       haloPSBlob;
     QuadVertex             quadVertices[]     = {
@@ -1729,6 +2194,9 @@ HRESULT RenderSystem::CompileBloomShaders()
         { s_kszBlurVerticalShaderSource,           "BlurV13",   "main", "ps_5_0", L"D3DCompile failed for vertical blur 13-tap",       blurVPSBlob.GetAddressOf(),     &m_blurVerticalPS      },
         { s_kszBlurVerticalShader9TapSource,       "BlurV9",    "main", "ps_5_0", L"D3DCompile failed for vertical blur 9-tap",        blurV9PSBlob.GetAddressOf(),    &m_blurVerticalPS9     },
         { s_kszBlurVerticalShader5TapSource,       "BlurV5",    "main", "ps_5_0", L"D3DCompile failed for vertical blur 5-tap",        blurV5PSBlob.GetAddressOf(),    &m_blurVerticalPS5     },
+        { s_kszDualDownsampleShaderSource,         "DualDown",  "main", "ps_5_0", L"D3DCompile failed for dual downsample",            dualDownPSBlob.GetAddressOf(),  &m_dualDownsamplePS    },
+        { s_kszDualUpsampleShaderSource,           "DualUp",    "main", "ps_5_0", L"D3DCompile failed for dual upsample",              dualUpPSBlob.GetAddressOf(),    &m_dualUpsamplePS      },
+        { s_kszDualUpsampleFinalShaderSource,      "DualFinal", "main", "ps_5_0", L"D3DCompile failed for dual final upsample",        dualFinalPSBlob.GetAddressOf(), &m_dualUpsampleFinalPS },
         { s_kszBloomCompositeShaderSource,         "Composite", "main", "ps_5_0", L"D3DCompile failed for composite shader",           compositePSBlob.GetAddressOf(), &m_compositePS         },
         { s_kszHaloShaderSource,                   "Halo",      "main", "ps_5_0", L"D3DCompile failed for halo shader",                haloPSBlob.GetAddressOf(),      &m_haloPS              }
     };
@@ -1775,42 +2243,61 @@ HRESULT RenderSystem::CompileBloomShaders()
     // through to skipping the scanline pass entirely.  Per the analyze
     // decision, the dialog's Scanline controls stay enabled and there's
     // no UI surface for this error (user just doesn't see scanlines).
+    //
+    // The fused composite + scanline shader is optional the same way: if
+    // it fails, Render falls back to the separate scanline pass.
     {
-        ComPtr<ID3DBlob>  scanlinePSBlob;
-        ComPtr<ID3DBlob>  scanlineErrorBlob;
-        HRESULT           hrScanline = S_OK;
-
+        auto compileOptionalShader = [this] (const char                 * pszSource,
+                                             const char                 * pszName,
+                                             ComPtr<ID3D11PixelShader>  & shader,
+                                             const wchar_t              * pszFailure)
+        {
+            ComPtr<ID3DBlob>  psBlob;
+            ComPtr<ID3DBlob>  errorBlob;
+            HRESULT           hrCompile = S_OK;
 
-        hrScanline = D3DCompile (s_kszScanlineShaderSource,
-                                  strlen (s_kszScanlineShaderSource),
-                                  "Scanlines",
-                                  nullptr,
-                                  nullptr,
-                                  "main",
-                                  "ps_5_0",
-                                  D3DCOMPILE_ENABLE_STRICTNESS,
-                                  0,
-                                  &scanlinePSBlob,
-                                  &scanlineErrorBlob);
 
-        if (SUCCEEDED (hrScanline))
-        {
-            hrScanline = m_device->CreatePixelShader (scanlinePSBlob->GetBufferPointer(),
-                                                      scanlinePSBlob->GetBufferSize(),
-                                                      nullptr,
-                                                      &m_scanlinePS);
-        }
+            hrCompile = D3DCompile (pszSource,
+                                    strlen (pszSource),
+                                    pszName,
+                                    nullptr,
+                                    nullptr,
+                                    "main",
+                                    "ps_5_0",
+                                    D3DCOMPILE_ENABLE_STRICTNESS,
+                                    0,
+                                    &psBlob,
+                                    &errorBlob);
+
+            if (SUCCEEDED (hrCompile))
+            {
+                hrCompile = m_device->CreatePixelShader (psBlob->GetBufferPointer(),
+                                                         psBlob->GetBufferSize(),
+                                                         nullptr,
+                                                         &shader);
+            }
 
-        if (FAILED (hrScanline))
-        {
-            if (scanlineErrorBlob)
+            if (FAILED (hrCompile))
             {
-                OutputDebugStringA (static_cast<char *> (scanlineErrorBlob->GetBufferPointer()));
+                if (errorBlob)
+                {
+                    OutputDebugStringA (static_cast<char *> (errorBlob->GetBufferPointer()));
+                }
+
+                OutputDebugStringW (pszFailure);
+                shader.Reset();
             }
+        };
 
-            OutputDebugStringW (L"MatrixRain: scanline shader init failed; scanlines bypassed for this session.\n");
-            m_scanlinePS.Reset();
-        }
+        compileOptionalShader (s_kszScanlineShaderSource,
+                               "Scanlines",
+                               m_scanlinePS,
+                               L"MatrixRain: scanline shader init failed; scanlines bypassed for this session.\n");
+
+        compileOptionalShader (s_kszBloomCompositeScanlineShaderSource,
+                               "CompositeScanlines",
+                               m_compositeScanlinePS,
+                               L"MatrixRain: fused composite + scanline shader init failed; using the separate scanline pass.\n");
     }
 
 Error:
@@ -1889,38 +2376,16 @@ HRESULT RenderSystem::CreateBloomResources (UINT width, UINT height)
     hr = m_device->CreateShaderResourceView (m_blurTempTexture.Get(), nullptr, &m_blurTempSRV);
     CHRA (hr);
 
-    // v1.5 (T051, contracts/scanline-shader.md): post-bloom intermediate
-    // target.  Backbuffer dimensions + the same R8G8B8A8 format as the scene
-    // and bloom intermediates so the scanline PS can sample it at native
-    // resolution and write 1:1 to the swapchain backbuffer.  (The backbuffer
-    // is B8G8R8A8 for D2D interop; the channel-order difference is irrelevant
-    // because the scanline pass is a shader draw — sampler in, output-merger
-    // out, see RenderScanlinePass — not a CopyResource, so the GPU handles
-    // the swizzle transparently.)
-    // Recreated alongside the bloom resources on Resize (Release+Create
-    // pair in RenderSystem::Resize), so a window-size change automatically
-    // reallocates this too.
-    {
-        D3D11_TEXTURE2D_DESC postBloomDesc = {};
-
-
-        postBloomDesc.Width             = width;
-        postBloomDesc.Height            = height;
-        postBloomDesc.MipLevels         = 1;
-        postBloomDesc.ArraySize         = 1;
-        postBloomDesc.Format            = DXGI_FORMAT_R8G8B8A8_UNORM;
-        postBloomDesc.SampleDesc.Count  = 1;
-        postBloomDesc.Usage             = D3D11_USAGE_DEFAULT;
-        postBloomDesc.BindFlags         = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
-
-        hr = m_device->CreateTexture2D (&postBloomDesc, nullptr, &m_postBloomTexture);
-        CHRA (hr);
+    // The post-bloom intermediate is created on first use by
+    // CreatePostBloomTarget; only the separate scanline pass needs it.
 
-        hr = m_device->CreateRenderTargetView (m_postBloomTexture.Get(), nullptr, &m_postBloomRTV);
-        CHRA (hr);
+    // Dual-filter mip chain, only while that algorithm is selected
+    ReleaseDualFilterResources();
 
-        hr = m_device->CreateShaderResourceView (m_postBloomTexture.Get(), nullptr, &m_postBloomSRV);
-        CHRA (hr);
+    if (m_bloomAlgorithm == BloomAlgorithm::DualFilter)
+    {
+        hr = CreateDualFilterResources (bloomWidth, bloomHeight);
+        CHR (hr);
     }
 
     // Compile bloom shaders and create fullscreen quad resources (only on first call)
@@ -1938,6 +2403,72 @@ Error:
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+//
+//  RenderSystem::CreateDualFilterResources
+//
+//  One render target per level below the bloom texture, each half the size
+//  of the one above, plus an upsample target for every level but the
+//  coarsest.  Same format as the bloom texture.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+HRESULT RenderSystem::CreateDualFilterResources (UINT bloomWidth, UINT bloomHeight)
+{
+    HRESULT              hr      = S_OK;
+    D3D11_TEXTURE2D_DESC texDesc = { };
+
+
+
+    texDesc.MipLevels        = 1;
+    texDesc.ArraySize        = 1;
+    texDesc.Format           = DXGI_FORMAT_R8G8B8A8_UNORM;
+    texDesc.SampleDesc.Count = 1;
+    texDesc.Usage            = D3D11_USAGE_DEFAULT;
+    texDesc.BindFlags        = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
+
+    for (int level = 0; level < MAX_DUAL_FILTER_LEVELS; level++)
+    {
+        BloomLevel * targets[2] = { &m_dualFilterDown[level], level < MAX_DUAL_FILTER_LEVELS - 1 ? &m_dualFilterUp[level] : nullptr };
+
+        texDesc.Width  = std::max (1u, bloomWidth  >> (level + 1));
+        texDesc.Height = std::max (1u, bloomHeight >> (level + 1));
+
+        for (BloomLevel * target : targets)
+        {
+            if (!target)
+            {
+                continue;
+            }
+
+            hr = m_device->CreateTexture2D (&texDesc, nullptr, &target->texture);
+            CHRA (hr);
+
+            hr = m_device->CreateRenderTargetView (target->texture.Get(), nullptr, &target->rtv);
+            CHRA (hr);
+
+            hr = m_device->CreateShaderResourceView (target->texture.Get(), nullptr, &target->srv);
+            CHRA (hr);
+
+            target->width  = texDesc.Width;
+            target->height = texDesc.Height;
+        }
+    }
+
+Error:
+    if (FAILED (hr))
+    {
+        // ApplyBloom falls back to the Gaussian blur without the chain
+        ReleaseDualFilterResources();
+    }
+
+    return hr;
+}
+
+
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 //  RenderSystem::SetRenderPipelineState
@@ -2039,16 +2570,19 @@ void RenderSystem::SetViewport(UINT width, UINT height)
 
 
 
-HRESULT RenderSystem::ApplyBloom (ID3D11RenderTargetView * pCompositeTarget)
+HRESULT RenderSystem::ApplyBloom (ID3D11RenderTargetView * pCompositeTarget, bool fuseScanlines)
 {
     HRESULT                    hr              = S_OK;
-    ID3D11ShaderResourceView * srvs[2];
+    ID3D11ShaderResourceView * srvs[3];
     ID3D11Buffer             * nullCB          = nullptr;
     D3D11_MAPPED_SUBRESOURCE   mappedBloomCB;
     int                        viewportDivisor = 0;
     ID3D11PixelShader        * blurH           = nullptr;
     ID3D11PixelShader        * blurV           = nullptr;
     int                        passCount       = 0;
+    UINT                       bloomWidth      = 0;
+    UINT                       bloomHeight     = 0;
+    TraceZone                  zone ("Bloom");
 
 
 
@@ -2057,8 +2591,9 @@ HRESULT RenderSystem::ApplyBloom (ID3D11RenderTargetView * pCompositeTarget)
     
     // Bloom viewport matches the bloom buffer size (resolution-divisor scaled).
     viewportDivisor = std::clamp (static_cast<int> (m_bloomResolutionDivisor), 1, 8);
-    SetViewport (std::max (1u, m_renderWidth  / static_cast<UINT> (viewportDivisor)),
-                 std::max (1u, m_renderHeight / static_cast<UINT> (viewportDivisor)));
+    bloomWidth      = std::max (1u, m_renderWidth  / static_cast<UINT> (viewportDivisor));
+    bloomHeight     = std::max (1u, m_renderHeight / static_cast<UINT> (viewportDivisor));
+    SetViewport (bloomWidth, bloomHeight);
     
     // EXTRACTION PASS: Extract only bright pixels from scene to bloom texture
     SetRenderPipelineState (m_fullscreenQuadInputLayout.Get(),
@@ -2070,7 +2605,11 @@ HRESULT RenderSystem::ApplyBloom (ID3D11RenderTargetView * pCompositeTarget)
                             nullptr);
     m_context->PSSetSamplers (0, 1, m_samplerState.GetAddressOf());
     
-    RenderFullscreenPass (m_bloomRTV.Get(), m_bloomExtractPS.Get(), m_sceneSRV.GetAddressOf(), 1);
+    {
+        TraceZone extractZone ("BloomExtract");
+
+        RenderFullscreenPass (m_bloomRTV.Get(), m_bloomExtractPS.Get(), m_sceneSRV.GetAddressOf(), 1);
+    }
     
     // Update bloom constant buffer (shared by blur and composite shaders)
     hr = m_context->Map (m_bloomConstantBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedBloomCB);
@@ -2090,44 +2629,55 @@ HRESULT RenderSystem::ApplyBloom (ID3D11RenderTargetView * pCompositeTarget)
     // Bind constant buffer for blur shaders (glowSize controls spread)
     m_context->PSSetConstantBuffers (0, 1, m_bloomConstantBuffer.GetAddressOf());
 
-    // Select the blur shader variant matching the user's current smoothness
-    // setting.  Low/Medium variants use cheaper 5-tap / 9-tap kernels; High
-    // uses the canonical 13-tap kernel.
-    blurH = m_blurHorizontalPS.Get();
-    blurV = m_blurVerticalPS.Get();
-
-    if (m_blurTaps == BlurTaps::Low && m_blurHorizontalPS5 && m_blurVerticalPS5)
+    if (m_bloomAlgorithm == BloomAlgorithm::DualFilter && m_dualFilterDown[0].rtv && m_dualDownsamplePS)
     {
-        blurH = m_blurHorizontalPS5.Get();
-        blurV = m_blurVerticalPS5.Get();
+        ApplyDualFilterBlur (bloomWidth, bloomHeight);
     }
-    else if (m_blurTaps == BlurTaps::Medium && m_blurHorizontalPS9 && m_blurVerticalPS9)
+    else
     {
-        blurH = m_blurHorizontalPS9.Get();
-        blurV = m_blurVerticalPS9.Get();
-    }
+        // Select the blur shader variant matching the user's current smoothness
+        // setting.  Low/Medium variants use cheaper 5-tap / 9-tap kernels; High
+        // uses the canonical 13-tap kernel.
+        blurH = m_blurHorizontalPS.Get();
+        blurV = m_blurVerticalPS.Get();
+
+        if (m_blurTaps == BlurTaps::Low && m_blurHorizontalPS5 && m_blurVerticalPS5)
+        {
+            blurH = m_blurHorizontalPS5.Get();
+            blurV = m_blurVerticalPS5.Get();
+        }
+        else if (m_blurTaps == BlurTaps::Medium && m_blurHorizontalPS9 && m_blurVerticalPS9)
+        {
+            blurH = m_blurHorizontalPS9.Get();
+            blurV = m_blurVerticalPS9.Get();
+        }
 
-    // Multiple blur passes: each H+V pass blurs the previous result,
-    // creating an exponentially wider and softer glow.  Pass count and
-    // smoothness are both runtime-configurable via the Quality preset.
-    passCount = std::clamp (m_blurPasses, 1, 4);
+        // Multiple blur passes: each H+V pass blurs the previous result,
+        // creating an exponentially wider and softer glow.  Pass count and
+        // smoothness are both runtime-configurable via the Quality preset.
+        passCount = std::clamp (m_blurPasses, 1, 4);
 
-    for (int pass = 0; pass < passCount; ++pass)
-    {
-        // Horizontal blur pass (bloom → temp)
-        RenderFullscreenPass (m_blurTempRTV.Get(), blurH, m_bloomSRV.GetAddressOf(), 1);
+        for (int pass = 0; pass < passCount; ++pass)
+        {
+            TraceZone passZone ("BlurPass");
+
+            // Horizontal blur pass (bloom → temp)
+            RenderFullscreenPass (m_blurTempRTV.Get(), blurH, m_bloomSRV.GetAddressOf(), 1);
 
-        // Vertical blur pass (temp → bloom)
-        RenderFullscreenPass (m_bloomRTV.Get(), blurV, m_blurTempSRV.GetAddressOf(), 1);
+            // Vertical blur pass (temp → bloom)
+            RenderFullscreenPass (m_bloomRTV.Get(), blurV, m_blurTempSRV.GetAddressOf(), 1);
+        }
     }
     
     // Restore full viewport
     SetViewport (m_renderWidth, m_renderHeight);
     
-    // Composite to the caller-supplied target.  When the scanline pass is
-    // about to run, Render passes m_postBloomRTV here so the scanline PS
-    // can sample the composited result and write the final image into the
-    // swapchain backbuffer; otherwise this is the backbuffer RTV directly.
+    // Composite to the caller-supplied target.  When the separate scanline
+    // pass is about to run, Render passes m_postBloomRTV here so the
+    // scanline PS can sample the composited result and write the final
+    // image into the swapchain backbuffer; otherwise this is the backbuffer
+    // RTV directly, and with fuseScanlines the composite darkens each row
+    // itself.
     m_context->OMSetRenderTargets (1, &pCompositeTarget, nullptr);
     
     // Disable blending for composite (we want to replace, not blend)
@@ -2138,17 +2688,30 @@ HRESULT RenderSystem::ApplyBloom (ID3D11RenderTargetView * pCompositeTarget)
     
     srvs[0] = m_sceneSRV.Get();
     srvs[1] = m_bloomSRV.Get();
-    RenderFullscreenPass (pCompositeTarget, m_compositePS.Get(), srvs, 2);
+    srvs[2] = m_scanlineRowSRV.Get();
+
+    {
+        TraceZone compositeZone ("BloomComposite");
+
+        if (fuseScanlines)
+        {
+            RenderFullscreenPass (pCompositeTarget, m_compositeScanlinePS.Get(), srvs, 3);
+        }
+        else
+        {
+            RenderFullscreenPass (pCompositeTarget, m_compositePS.Get(), srvs, 2);
+        }
+    }
     
     // Unbind constant buffer from pixel shader
     m_context->PSSetConstantBuffers (0, 1, &nullCB);
     
     // Restore render state
-    SetRenderPipelineState (m_inputLayout.Get(),
+    SetRenderPipelineState (m_rainInputLayout.Get(),
                             D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST,
-                            m_instanceBuffer.Get(),
-                            sizeof (CharacterInstanceData),
-                            m_vertexShader.Get(),
+                            m_rainStreamBuffer.Get(),
+                            sizeof (RainInstanceStream),
+                            m_rainVertexShader.Get(),
                             m_constantBuffer.Get(),
                             m_pixelShader.Get());
 
@@ -2160,179 +2723,149 @@ Error:
 
 
 
-void RenderSystem::ClearRenderTarget()
+////////////////////////////////////////////////////////////////////////////////
+//
+//  RenderSystem::ApplyDualFilterBlur
+//
+//  Replaces the Gaussian passes: downsample the extracted bloom texture
+//  level by level, then upsample back, averaging each level's downsample
+//  in, and finish with a plain upsample into the bloom texture.  Expects
+//  the fullscreen quad, sampler and bloom constant buffer to be bound.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void RenderSystem::ApplyDualFilterBlur (UINT bloomWidth, UINT bloomHeight)
 {
-    // Clear to black
-    constexpr float clearColor[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+    int                        levelCount = DualFilterLevelCount (m_blurPasses);
+    ID3D11ShaderResourceView * srvs[2];
 
 
 
-    if (!m_renderTargetView)
+    for (int level = 0; level < levelCount; level++)
     {
-        return;  // Skip if render target is being recreated during resize
-    }
-    
-    m_context->ClearRenderTargetView (m_renderTargetView.Get(), clearColor);
-}
+        TraceZone passZone ("DualFilterDown");
 
+        srvs[0] = level == 0 ? m_bloomSRV.Get() : m_dualFilterDown[level - 1].srv.Get();
 
+        SetViewport (m_dualFilterDown[level].width, m_dualFilterDown[level].height);
+        RenderFullscreenPass (m_dualFilterDown[level].rtv.Get(), m_dualDownsamplePS.Get(), srvs, 1);
+    }
 
+    for (int level = levelCount - 2; level >= 0; level--)
+    {
+        TraceZone passZone ("DualFilterUp");
 
+        srvs[0] = level == levelCount - 2 ? m_dualFilterDown[level + 1].srv.Get() : m_dualFilterUp[level + 1].srv.Get();
+        srvs[1] = m_dualFilterDown[level].srv.Get();
 
-void RenderSystem::SortStreaksByDepth (std::vector<const CharacterStreak*>& streaks)
-{
-    // Sort back-to-front (far to near) for proper alpha blending
-    std::stable_sort (streaks.begin(), streaks.end(),
-        [](const CharacterStreak * a, const CharacterStreak * b)
-        {
-            return a->GetPosition().z > b->GetPosition().z;
-        });
-}
+        SetViewport (m_dualFilterUp[level].width, m_dualFilterUp[level].height);
+        RenderFullscreenPass (m_dualFilterUp[level].rtv.Get(), m_dualUpsamplePS.Get(), srvs, 2);
+    }
 
+    srvs[0] = levelCount > 1 ? m_dualFilterUp[0].srv.Get() : m_dualFilterDown[0].srv.Get();
 
+    TraceZone finalZone ("DualFilterUp");
 
+    SetViewport (bloomWidth, bloomHeight);
+    RenderFullscreenPass (m_bloomRTV.Get(), m_dualUpsampleFinalPS.Get(), srvs, 1);
+}
 
 
-////////////////////////////////////////////////////////////////////////////////
-//
-//  RenderSystem::BuildCharacterInstanceData
-//
-//  Builds instance data for a single character.
-//
-////////////////////////////////////////////////////////////////////////////////
 
-void RenderSystem::BuildCharacterInstanceData (const CharacterInstance & character, const Vector3 & streakPos, const Color4 & schemeColor, RenderSystem::CharacterInstanceData & data)
-{
-    CharacterSet & charSet = CharacterSet::GetInstance();
 
 
+void RenderSystem::ClearRenderTarget()
+{
+    // Clear to black
+    constexpr float clearColor[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
 
-    // Position - character stores its absolute Y, streak provides X and Z
-    data.position[0] = streakPos.x + character.positionOffset.x;
-    data.position[1] = character.positionOffset.y; // Absolute Y position
-    data.position[2] = streakPos.z;
 
-    // Get UV coordinates from glyph
-    const GlyphInfo & glyph = charSet.GetGlyph (character.glyphIndex);
-    data.uvMin[0] = glyph.uvMin.x;
-    data.uvMin[1] = glyph.uvMin.y;
-    data.uvMax[0] = glyph.uvMax.x;
-    data.uvMax[1] = glyph.uvMax.y;
 
-    // Color and brightness - apply color scheme to trailing characters
-    // White characters (lead) should stay white regardless of color scheme
-    bool isWhite = (character.color.r > 0.9f && character.color.g > 0.9f && character.color.b > 0.9f);
-    
-    if (isWhite)
-    {
-        // Keep white characters white (lead character)
-        data.color[0] = character.color.r;
-        data.color[1] = character.color.g;
-        data.color[2] = character.color.b;
-    }
-    else
+    if (!m_renderTargetView)
     {
-        // Replace trail color with current color scheme
-        data.color[0] = schemeColor.r;
-        data.color[1] = schemeColor.g;
-        data.color[2] = schemeColor.b;
+        return;  // Skip if render target is being recreated during resize
     }
     
-    data.color[3]   = character.color.a;
-    data.brightness = character.brightness;
-    data.scaleX     = character.scale;
-    data.scaleY     = character.scale;
+    m_context->ClearRenderTargetView (m_renderTargetView.Get(), clearColor);
 }
 
 
 
 
 
-HRESULT RenderSystem::UpdateInstanceBuffer (const AnimationSystem& animationSystem, ColorScheme colorScheme, float elapsedTime, COLORREF customColor)
-{
-    HRESULT                  hr             = S_OK;
-    Color4                   schemeColor    = GetColorRGB (colorScheme, elapsedTime);
-    D3D11_MAPPED_SUBRESOURCE mappedResource;
-    size_t                   bytesToCopy;
-
+////////////////////////////////////////////////////////////////////////////////
+//
+//  RenderSystem::UploadRainInstances
+//
+//  Reconciles the instance store with this frame's streaks, patches only the
+//  static slots that changed, and rewrites the thin {slot, brightness}
+//  stream.  A frame in which characters only fade uploads 8 bytes per
+//  character instead of a full 64-byte instance.
+//
+////////////////////////////////////////////////////////////////////////////////
 
+HRESULT RenderSystem::UploadRainInstances (const AnimationSystem & animationSystem)
+{
+    HRESULT                                 hr        = S_OK;
+    const std::vector<RainInstanceStatic> & slots     = m_instanceStore.GetSlots();
+    const std::vector<RainInstanceStream> & stream    = m_instanceStore.GetStream();
+    bool                                    uploadAll = false;
+    D3D11_BOX                               box       = { 0, 0, 0, 0, 1, 1 };
+    D3D11_MAPPED_SUBRESOURCE                mappedResource;
 
-    // v1.5 US5 (T062, FR-033, FR-034): when the user picks ColorScheme::
-    // Custom, override the static-palette lookup with their persisted RGB.
-    // COLORREF is 0x00BBGGRR, normalise each channel to [0..1] for Color4.
-    if (colorScheme == ColorScheme::Custom)
-    {
-        schemeColor = Color4 (static_cast<float> (GetRValue (customColor)) / 255.0f,
-                              static_cast<float> (GetGValue (customColor)) / 255.0f,
-                              static_cast<float> (GetBValue (customColor)) / 255.0f);
-    }
 
-    // Clear working data from previous frame (reuse allocated capacity)
-    m_instanceData.clear();
-    m_streakPtrs.clear();
 
-    // Get streaks sorted by depth
-    for (const auto& streak : animationSystem.GetStreaks())
-    {
-        m_streakPtrs.push_back (&streak);
-    }
+    m_instanceStore.Update (animationSystem);
 
-    SortStreaksByDepth (m_streakPtrs);
+    BAIL_OUT_IF (stream.empty(), S_OK);
 
-    // Build instance data
-    for (const CharacterStreak* streak : m_streakPtrs)
+    // Grow the static buffer (double capacity to reduce reallocations).  A
+    // new buffer starts empty, so every slot goes up this frame.
+    if (slots.size() > m_rainStaticCapacity)
     {
-        const auto & characters = streak->GetCharacters();
-        Vector3      streakPos  = streak->GetPosition();
-
-        // Render all characters (they manage their own fading/removal)
-        for (const auto & character : characters)
-        {
-            CharacterInstanceData data;
-
+        m_rainStaticSRV.Reset();
+        m_rainStaticBuffer.Reset();
+        m_rainStaticCapacity = static_cast<UINT> (slots.size() * 2);
 
+        hr = CreateRainStaticBuffer();
+        CHR (hr);
 
-            BuildCharacterInstanceData (character, streakPos, schemeColor, data);
-            m_instanceData.push_back (data);
-        }
+        uploadAll = true;
     }
 
-    // Render overlay characters (standalone characters not attached to any streak,
-    // such as horizontal tracer animations in the help dialog)
-    for (const auto & overlay : animationSystem.GetOverlayCharacters())
+    if (uploadAll)
     {
-        CharacterInstanceData data;
-
+        box.left  = 0;
+        box.right = static_cast<UINT> (slots.size() * sizeof (RainInstanceStatic));
 
-
-        BuildCharacterInstanceData (overlay.character, overlay.position, schemeColor, data);
-        m_instanceData.push_back (data);
+        m_context->UpdateSubresource (m_rainStaticBuffer.Get(), 0, &box, slots.data(), 0, 0);
     }
+    else
+    {
+        for (const InstanceSlotSpan & span : m_instanceStore.GetDirtySpans())
+        {
+            box.left  = static_cast<UINT> (span.first * sizeof (RainInstanceStatic));
+            box.right = static_cast<UINT> ((span.first + span.count) * sizeof (RainInstanceStatic));
 
-    BAIL_OUT_IF (m_instanceData.empty(), S_OK);
+            m_context->UpdateSubresource (m_rainStaticBuffer.Get(), 0, &box, &slots[span.first], 0, 0);
+        }
+    }
 
-    // Resize buffer if needed (double capacity each time to reduce allocations)
-    if (m_instanceData.size() > m_instanceBufferCapacity)
+    if (stream.size() > m_rainStreamCapacity)
     {
-        UINT newCapacity = static_cast<UINT> (m_instanceData.size() * 2);
-        
+        m_rainStreamBuffer.Reset();
+        m_rainStreamCapacity = static_cast<UINT> (stream.size() * 2);
 
-        
-        m_instanceBuffer.Reset();
-        m_instanceBufferCapacity = newCapacity;
-        
-        hr = CreateInstanceBuffer();
-        CHRA (hr);
+        hr = CreateRainStreamBuffer();
+        CHR (hr);
     }
 
-    // Map instance buffer and upload data
-    hr = m_context->Map (m_instanceBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+    hr = m_context->Map (m_rainStreamBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
     CHRA (hr);
 
-    bytesToCopy = sizeof (CharacterInstanceData) * m_instanceData.size();
-    memcpy (mappedResource.pData, m_instanceData.data(), bytesToCopy);
-    
-    m_context->Unmap (m_instanceBuffer.Get(), 0);
+    memcpy (mappedResource.pData, stream.data(), sizeof (RainInstanceStream) * stream.size());
+
+    m_context->Unmap (m_rainStreamBuffer.Get(), 0);
 
 Error:
     return hr;
@@ -2349,6 +2882,8 @@ void RenderSystem::Render (const AnimationSystem & animationSystem, const Viewpo
         return;
     }
 
+    BeginGpuTimer();
+
     // Clear render target
     ClearRenderTarget();
 
@@ -2365,68 +2900,57 @@ void RenderSystem::Render (const AnimationSystem & animationSystem, const Viewpo
         memcpy (cbData->projection, projection.m, sizeof (projection.m));
 
         // Rain characters use the standard 24x36 base quad dimensions
-        cbData->charWidth  = 24.0f;
-        cbData->charHeight = 36.0f;
+        cbData->charWidth  = s_kRainCharWidth;
+        cbData->charHeight = s_kRainCharHeight;
 
-        // Calculate character scale based on viewport height
-        // Scale down proportionally for preview mode to fit the entire effect
-        // Minimum scale ensures characters remain visible (12px tall minimum)
-        //
-        // DPI scaling: The base character size (32×48 in the shader) is in physical pixels.
-        // We multiply by m_dpiScale so characters maintain a consistent logical size
-        // regardless of the monitor's DPI setting.
-        // The reference viewport height (1080) is also DPI-adjusted so that the
-        // same logical viewport produces the same scale across DPI levels.
-        if (m_characterScaleOverride.has_value())
-        {
-            // Use explicit override (e.g., UsageDialog forcing full-size characters)
-            // UsageDialog handles its own DPI scaling — do NOT multiply by m_dpiScale
-            cbData->characterScale = m_characterScaleOverride.value();
-        }
-        else
-        {
-            float viewportHeight    = static_cast<float> (viewport.GetHeight());
-            float referenceHeight   = 1080.0f * m_dpiScale;
-            float viewportBaseScale = 1.0f;
-
-            if (viewportHeight < referenceHeight)
-            {
-                // Scale linearly based on viewport height (reference = 1.0)
-                viewportBaseScale = viewportHeight / referenceHeight;
+        // Trail tint lives in the constant buffer so a scheme change or a
+        // ColorCycle sweep never dirties the persistent instance slots
+        Color4 schemeColor = ResolveSchemeColor (params.colorScheme, params.elapsedTime, params.customColor);
 
-                // Clamp to minimum 0.5 (24px tall from 48px base at 96 DPI)
-                if (viewportBaseScale < 0.5f)
-                    viewportBaseScale = 0.5f;
-            }
+        cbData->schemeColor[0] = schemeColor.r;
+        cbData->schemeColor[1] = schemeColor.g;
+        cbData->schemeColor[2] = schemeColor.b;
+        cbData->schemeColor[3] = schemeColor.a;
 
-            cbData->characterScale = viewportBaseScale * m_dpiScale;
-        }
+        // Viewport/DPI-driven scale (see RainMetrics.h); shared with the
+        // software renderer so both place identical quads
+        cbData->characterScale = ComputeRainCharacterScale (static_cast<float> (viewport.GetHeight()), m_dpiScale, m_characterScaleOverride);
 
         m_context->Unmap (m_constantBuffer.Get(), 0);
     }
 
-    // Update instance buffer with character data
-    (void) UpdateInstanceBuffer (animationSystem, params.colorScheme, params.elapsedTime, params.customColor);
+    // Patch changed instance slots and upload this frame's brightness stream
+    {
+        TraceZone zone ("UploadRainInstances");
+        uint64_t  buildStart = Timestamp::Read();
+
+        hr = UploadRainInstances (animationSystem);
+
+        m_lastInstanceBuildUs = ToMicroseconds (ElapsedSince (buildStart));
+    }
+
+    UINT instanceCount = static_cast<UINT> (m_instanceStore.GetStream().size());
 
-    if (m_instanceData.empty())
+    if (FAILED (hr) || instanceCount == 0)
     {
         return;
     }
 
     // Set render state
-    m_context->IASetInputLayout (m_inputLayout.Get());
+    m_context->IASetInputLayout (m_rainInputLayout.Get());
     m_context->IASetPrimitiveTopology (D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
-    // Set vertex buffers: slot 0 = dummy (for vertex count), slot 1 = instance data
-    ID3D11Buffer* buffers[2]     = { m_dummyVertexBuffer.Get(), m_instanceBuffer.Get() };
-    UINT          strides[2]     = { 4, sizeof (CharacterInstanceData) };
+    // Set vertex buffers: slot 0 = dummy (for vertex count), slot 1 = {slot, brightness} stream
+    ID3D11Buffer* buffers[2]     = { m_dummyVertexBuffer.Get(), m_rainStreamBuffer.Get() };
+    UINT          strides[2]     = { 4, sizeof (RainInstanceStream) };
     UINT          offsets[2]     = { 0, 0 };
     
     
     m_context->IASetVertexBuffers (0, 2, buffers, strides, offsets);
 
-    m_context->VSSetShader (m_vertexShader.Get(), nullptr, 0);
+    m_context->VSSetShader (m_rainVertexShader.Get(), nullptr, 0);
     m_context->VSSetConstantBuffers (0, 1, m_constantBuffer.GetAddressOf());
+    m_context->VSSetShaderResources (0, 1, m_rainStaticSRV.GetAddressOf());
 
     m_context->PSSetShader (m_pixelShader.Get(), nullptr, 0);
     m_context->PSSetSamplers (0, 1, m_samplerState.GetAddressOf());
@@ -2457,7 +2981,7 @@ void RenderSystem::Render (const AnimationSystem & animationSystem, const Viewpo
         m_context->ClearRenderTargetView (m_sceneRTV.Get(), clearColor);
         
         m_context->OMSetRenderTargets (1, m_sceneRTV.GetAddressOf(), nullptr);
-        m_context->DrawInstanced (6, static_cast<UINT> (m_instanceData.size()), 0, 0);
+        m_context->DrawInstanced (6, instanceCount, 0, 0);
 
         // Render overlays to scene texture (before bloom so they get glow for free)
         // Render overlays to scene texture (before bloom so they get glow for free)
@@ -2486,17 +3010,24 @@ void RenderSystem::Render (const AnimationSystem & animationSystem, const Viewpo
         // re-enabling is instant.  See ShouldRunBloomPass in RenderSystem.h
         // for the unit-tested decision predicate.
         //
-        // v1.5 (T051, T052, FR-028b): when the scanline pass is active, the
+        // Scanlines normally ride along in the composite: the fused shader
+        // multiplies each row by its entry in the per-row table, in both
+        // the glow and no-glow branches, and writes the backbuffer directly.
+        //
+        // v1.5 (T051, T052, FR-028b): without the fused shader, the
         // composite (or the direct scene copy in the glow-off branch) writes
         // into m_postBloomTarget instead of the swapchain backbuffer; the
         // scanline PS then samples it and writes the final image to the
         // backbuffer.  Scanlines run independently of glow now — the no-glow
         // branch routes through m_postBloomTarget too so scanlines always
         // have a populated SRV.
+        bool                     fuseScanlines    = ShouldRunScanlinePass (params)
+                                                    && m_compositeScanlinePS
+                                                    && SUCCEEDED (UploadScanlineRows (params));
         bool                     wantScanlines    = ShouldRunScanlinePass (params)
+                                                    && !fuseScanlines
                                                     && m_scanlinePS
-                                                    && m_postBloomRTV
-                                                    && m_postBloomSRV;
+                                                    && SUCCEEDED (CreatePostBloomTarget());
         ID3D11RenderTargetView * pCompositeTarget = wantScanlines
                                                     ? m_postBloomRTV.Get()
                                                     : m_renderTargetView.Get();
@@ -2511,7 +3042,7 @@ void RenderSystem::Render (const AnimationSystem & animationSystem, const Viewpo
 
         if (ShouldRunBloomPass (params))
         {
-            (void)ApplyBloom (pCompositeTarget);
+            (void)ApplyBloom (pCompositeTarget, fuseScanlines);
         }
         else
         {
@@ -2525,7 +3056,7 @@ void RenderSystem::Render (const AnimationSystem & animationSystem, const Viewpo
             m_context->OMSetRenderTargets (1, &pCompositeTarget, nullptr);
             m_context->OMSetBlendState (nullptr, nullptr, 0xffffffff);
 
-            ID3D11ShaderResourceView * srvs[] = { m_sceneSRV.Get(), nullptr };
+            ID3D11ShaderResourceView * srvs[] = { m_sceneSRV.Get(), nullptr, m_scanlineRowSRV.Get() };
 
             SetRenderPipelineState (m_fullscreenQuadInputLayout.Get(),
                                     D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST,
@@ -2535,7 +3066,14 @@ void RenderSystem::Render (const AnimationSystem & animationSystem, const Viewpo
                                     nullptr,
                                     nullptr);
             m_context->PSSetSamplers (0, 1, m_samplerState.GetAddressOf());
-            RenderFullscreenPass (pCompositeTarget, m_compositePS.Get(), srvs, 2);
+            if (fuseScanlines)
+            {
+                RenderFullscreenPass (pCompositeTarget, m_compositeScanlinePS.Get(), srvs, 3);
+            }
+            else
+            {
+                RenderFullscreenPass (pCompositeTarget, m_compositePS.Get(), srvs, 2);
+            }
         }
 
         if (wantScanlines)
@@ -2547,7 +3085,7 @@ void RenderSystem::Render (const AnimationSystem & animationSystem, const Viewpo
     {
         // Fallback: render directly to backbuffer if bloom not available
         m_context->OMSetRenderTargets (1, m_renderTargetView.GetAddressOf(), nullptr);
-        m_context->DrawInstanced (6, static_cast<UINT> (m_instanceData.size()), 0, 0);
+        m_context->DrawInstanced (6, instanceCount, 0, 0);
     }
 
     // Render FPS counter overlay if fps > 0
@@ -2556,7 +3094,7 @@ void RenderSystem::Render (const AnimationSystem & animationSystem, const Viewpo
         double gpuLoad      = SharedGpuLoadMonitor().GetLoadPercent();
         bool   gpuLoadValid = gpuLoad >= 0.0;
 
-        RenderFPSCounter (params.fps, params.rainPercentage, params.streakCount, params.activeHeadCount, gpuLoad, gpuLoadValid);
+        RenderFPSCounter (params.fps, params.rainPercentage, params.streakCount, params.activeHeadCount, gpuLoad, gpuLoadValid, params.frameTime);
     }
 }
 
@@ -2566,11 +3104,16 @@ void RenderSystem::Render (const AnimationSystem & animationSystem, const Viewpo
 
 HRESULT RenderSystem::Present()
 {
+    TraceZone zone ("Present");
+
+
     if (!m_swapChain)
     {
         return S_OK;
     }
 
+    EndGpuTimer();
+
     return m_swapChain->Present (1, 0); // VSync enabled
 }
 
@@ -2578,11 +3121,176 @@ HRESULT RenderSystem::Present()
 
 
 
-void RenderSystem::RenderFPSCounter (float fps, int rainPercentage, int streakCount, int activeHeadCount, double gpuLoadPercent, bool gpuLoadValid)
+////////////////////////////////////////////////////////////////////////////////
+//
+//  RenderSystem::GetLastVBlankTime
+//
+//  FrameClock time points are steady_clock's, which is QueryPerformanceCounter
+//  scaled to nanoseconds, so the statistics' QPC timestamp converts directly.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+std::optional<FrameClock::time_point> RenderSystem::GetLastVBlankTime() const
+{
+    DXGI_FRAME_STATISTICS stats     = {};
+    LARGE_INTEGER         frequency = {};
+
+
+
+    if (!m_swapChain || FAILED (m_swapChain->GetFrameStatistics (&stats)) || stats.SyncQPCTime.QuadPart == 0)
+    {
+        return std::nullopt;
+    }
+
+    QueryPerformanceFrequency (&frequency);
+
+    int64_t whole = stats.SyncQPCTime.QuadPart / frequency.QuadPart;
+    int64_t part  = stats.SyncQPCTime.QuadPart % frequency.QuadPart;
+
+    return FrameClock::time_point (std::chrono::nanoseconds (whole * 1'000'000'000 + part * 1'000'000'000 / frequency.QuadPart));
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  RenderSystem::SetGpuTimingEnabled
+//
+//  Turning timing off forgets the last result, so a governor enabled later
+//  does not act on a stale frame time.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void RenderSystem::SetGpuTimingEnabled (bool enabled)
+{
+    m_gpuTimingOn = enabled;
+
+    if (!enabled)
+    {
+        m_lastGpuFrameUs = -1;
+    }
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  RenderSystem::BeginGpuTimer
+//
+//  Brackets the frame's GPU work with timestamps (closed by EndGpuTimer in
+//  Present) while timing is enabled.  The slot is skipped if its previous results have not come
+//  back yet rather than waiting for them.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void RenderSystem::BeginGpuTimer()
+{
+    if (!m_gpuTimingOn)
+    {
+        return;
+    }
+
+    CollectGpuTimers();
+
+    GpuTimerQueries & timer = m_gpuTimers[m_gpuTimerNext];
+
+    if (!timer.disjoint || timer.pending)
+    {
+        return;
+    }
+
+    m_context->Begin (timer.disjoint.Get());
+    m_context->End   (timer.begin.Get());
+
+    m_gpuTimerOpen = true;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  RenderSystem::EndGpuTimer
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void RenderSystem::EndGpuTimer()
+{
+    if (!m_gpuTimerOpen)
+    {
+        return;
+    }
+
+    GpuTimerQueries & timer = m_gpuTimers[m_gpuTimerNext];
+
+    m_context->End (timer.end.Get());
+    m_context->End (timer.disjoint.Get());
+
+    timer.pending  = true;
+    m_gpuTimerOpen = false;
+    m_gpuTimerNext = (m_gpuTimerNext + 1) % s_kGpuTimerCount;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  RenderSystem::CollectGpuTimers
+//
+//  Walks the in-flight slots oldest first and publishes each one whose
+//  results are ready.  Stops at the first that is not: the GPU finishes
+//  frames in order, so nothing newer is ready either.  A disjoint interval
+//  (clock change mid-frame, e.g. power state) is dropped.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void RenderSystem::CollectGpuTimers()
+{
+    for (size_t i = 0; i < s_kGpuTimerCount; i++)
+    {
+        GpuTimerQueries                     & timer    = m_gpuTimers[(m_gpuTimerNext + i) % s_kGpuTimerCount];
+        D3D11_QUERY_DATA_TIMESTAMP_DISJOINT   disjoint = {};
+        UINT64                                begin    = 0;
+        UINT64                                end      = 0;
+
+        if (!timer.pending)
+        {
+            continue;
+        }
+
+        if (m_context->GetData (timer.disjoint.Get(), &disjoint, sizeof (disjoint), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK ||
+            m_context->GetData (timer.begin.Get(),    &begin,    sizeof (begin),    D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK ||
+            m_context->GetData (timer.end.Get(),      &end,      sizeof (end),      D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+        {
+            break;
+        }
+
+        timer.pending = false;
+
+        if (!disjoint.Disjoint && disjoint.Frequency > 0 && end >= begin)
+        {
+            m_lastGpuFrameUs = static_cast<int64_t> ((end - begin) * 1000000ull / disjoint.Frequency);
+        }
+    }
+}
+
+
+
+
+
+void RenderSystem::RenderFPSCounter (float fps, int rainPercentage, int streakCount, int activeHeadCount, double gpuLoadPercent, bool gpuLoadValid, const FrameTimingPercentiles & frameTime)
 {
     HRESULT                   hr           = S_OK;
     bool                      drawing      = false;
-    wchar_t                   fpsText[128];
+    wchar_t                   fpsText[192];
+    wchar_t                   frameText[64] = L"";
     D2D1_SIZE_F               size         = { 0 };
     ComPtr<IDWriteTextLayout> textLayout;
     UINT32                    textLength   = 0; 
@@ -2597,17 +3305,25 @@ void RenderSystem::RenderFPSCounter (float fps, int rainPercentage, int streakCo
     m_d2dContext->BeginDraw();
     drawing = true;
 
-    // Format FPS text with rain density info and GPU load:
-    //   "Rain xxx% (yyy heads / zzz total), ww FPS, GPU vv%"
+    // Frame-time percentiles from the last completed timing window, once
+    // there is one: "a/b/c/d ms p50/95/99/max"
+    if (frameTime.count > 0)
+    {
+        swprintf_s (frameText, L", %.1f/%.1f/%.1f/%.1f ms p50/95/99/max",
+                    frameTime.p50Us / 1000.0, frameTime.p95Us / 1000.0, frameTime.p99Us / 1000.0, frameTime.maxUs / 1000.0);
+    }
+
+    // Format FPS text with rain density info, frame times and GPU load:
+    //   "Rain xxx% (yyy heads / zzz total), ww FPS[, frame times], GPU vv%"
     if (gpuLoadValid)
     {
-        swprintf_s (fpsText, L"Rain %d%% (%d heads / %d total), %.0f fps, %.0f%% GPU",
-                    rainPercentage, activeHeadCount, streakCount, fps, gpuLoadPercent);
+        swprintf_s (fpsText, L"Rain %d%% (%d heads / %d total), %.0f fps%ls, %.0f%% GPU",
+                    rainPercentage, activeHeadCount, streakCount, fps, frameText, gpuLoadPercent);
     }
     else
     {
-        swprintf_s (fpsText, L"Rain %d%% (%d heads / %d total), %.0f fps, --%% GPU",
-                    rainPercentage, activeHeadCount, streakCount, fps);
+        swprintf_s (fpsText, L"Rain %d%% (%d heads / %d total), %.0f fps%ls, --%% GPU",
+                    rainPercentage, activeHeadCount, streakCount, fps, frameText);
     }
 
     // Get render target size for positioning
@@ -3497,6 +4213,31 @@ void RenderSystem::ReleaseBloomResources()
     m_postBloomSRV.Reset();
     m_postBloomRTV.Reset();
     m_postBloomTexture.Reset();
+
+    ReleaseDualFilterResources();
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  RenderSystem::ReleaseDualFilterResources
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void RenderSystem::ReleaseDualFilterResources()
+{
+    for (BloomLevel & level : m_dualFilterDown)
+    {
+        level = BloomLevel {};
+    }
+
+    for (BloomLevel & level : m_dualFilterUp)
+    {
+        level = BloomLevel {};
+    }
 }
 
 
@@ -3554,16 +4295,33 @@ void RenderSystem::ReleaseDirectXResources()
     m_bloomExtractPS.Reset();
     m_blurHorizontalPS.Reset();
     m_blurVerticalPS.Reset();
+    m_dualDownsamplePS.Reset();
+    m_dualUpsamplePS.Reset();
+    m_dualUpsampleFinalPS.Reset();
     m_compositePS.Reset();
+    m_compositeScanlinePS.Reset();
+    m_scanlineRowSRV.Reset();
+    m_scanlineRowBuffer.Reset();
     m_haloPS.Reset();
     m_haloConstantBuffer.Reset();
     m_bloomConstantBuffer.Reset();
     m_glyphAtlas.Reset();
     m_samplerState.Reset();
+
+    for (GpuTimerQueries & timer : m_gpuTimers)
+    {
+        timer = {};
+    }
+
+    m_gpuTimerOpen = false;
     m_premultipliedBlendState.Reset();
     m_blendState.Reset();
     m_constantBuffer.Reset();
-    m_instanceBuffer.Reset();
+    m_rainStreamBuffer.Reset();
+    m_rainStaticSRV.Reset();
+    m_rainStaticBuffer.Reset();
+    m_rainInputLayout.Reset();
+    m_rainVertexShader.Reset();
     m_inputLayout.Reset();
     m_fullscreenQuadInputLayout.Reset();
     m_pixelShader.Reset();
@@ -3657,7 +4415,8 @@ void RenderSystem::SetGlowSize (int sizePercent)
 
 ////////////////////////////////////////////////////////////////////////////////
 //
-//  RenderSystem::SetBlurPasses / SetBloomResolution / SetBlurTaps
+//  RenderSystem::SetBlurPasses / SetBloomResolution / SetBlurTaps /
+//  SetBloomAlgorithm
 //
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -3711,6 +4470,25 @@ void RenderSystem::SetBlurTaps (int taps)
 }
 
 
+void RenderSystem::SetBloomAlgorithm (int algorithm)
+{
+    BloomAlgorithm newAlgorithm = algorithm == static_cast<int> (BloomAlgorithm::DualFilter) ? BloomAlgorithm::DualFilter
+                                                                                            : BloomAlgorithm::Gaussian;
+
+    if (newAlgorithm != m_bloomAlgorithm)
+    {
+        m_bloomAlgorithm = newAlgorithm;
+
+        // The dual-filter chain is only allocated while selected; recreate
+        // like SetBloomResolution does.
+        if (m_device && m_renderWidth > 0 && m_renderHeight > 0)
+        {
+            (void)CreateBloomResources (m_renderWidth, m_renderHeight);
+        }
+    }
+}
+
+
 
 
 
@@ -6,11 +6,14 @@
 
 #include "AnimationSystem.h"
 #include "CharacterInstance.h"
+#include "FrameClock.h"
 #include "GlyphAtlas.h"
+#include "InstanceStore.h"
 #include "IRenderSystem.h"
 #include "Overlay.h"
 #include "QualityPresets.h"
 #include "RenderParams.h"
+#include "ScanlineAttenuation.h"
 #include "Viewport.h"
 #include "ColorScheme.h"
 
@@ -68,8 +71,9 @@ inline bool ShouldRunBloomPass (const RenderParams & params) noexcept
 //  ShouldRunScanlinePass — pure helper consulted by RenderSystem::Render and
 //  unit-tested in RenderSystemScanlineBypassTests.cpp.  Returns true when
 //  scanlines are enabled — independently of the glow toggle.  The Render
-//  path routes the no-glow direct-scene-to-target write into m_postBloomTarget
-//  when scanlines are wanted so the scanline PS still has an SRV to sample.
+//  path applies them in the fused composite shader, or, without it, routes
+//  the no-glow direct-scene-to-target write into m_postBloomTarget so the
+//  scanline PS still has an SRV to sample.
 //
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -135,9 +139,10 @@ public:
 
     void SetGlowSize (int sizePercent) override;
 
-    void SetBlurPasses     (int passes)  override;
-    void SetBloomResolution (int divisor) override;
-    void SetBlurTaps       (int taps)    override;
+    void SetBlurPasses      (int passes)    override;
+    void SetBloomResolution (int divisor)   override;
+    void SetBlurTaps        (int taps)      override;
+    void SetBloomAlgorithm  (int algorithm) override;
 
     void SetCharacterScaleOverride (float scale) override;
 
@@ -145,6 +150,22 @@ public:
 
     float GetDpiScale() const override { return m_dpiScale; }
 
+    // Time the last Render() spent patching and uploading rain instances
+    int64_t GetLastInstanceBuildMicroseconds() const { return m_lastInstanceBuildUs; }
+
+    // GPU frame timing issues timestamp queries every frame, so it runs
+    // only while something reads it (the quality governor); off by default
+    void SetGpuTimingEnabled (bool enabled);
+
+    // GPU time from the start of Render() to Present() for the newest frame
+    // whose timestamps have come back (typically one or two frames behind);
+    // -1 until the first one does, and while timing is off
+    int64_t GetLastGpuFrameMicroseconds() const { return m_lastGpuFrameUs; }
+
+    // When the most recent vblank on this swap chain's output happened,
+    // from DXGI frame statistics; nullopt until DXGI has reported one
+    std::optional<FrameClock::time_point> GetLastVBlankTime() const;
+
     // Accessors
     ID3D11Device        * GetDevice()        const { return m_device.Get();        }
     ID3D11DeviceContext * GetContext()       const { return m_context.Get();       }
@@ -186,13 +207,17 @@ private:
         float characterScale;   // Global character scale (1.0 = normal, <1.0 for preview)
         float charWidth;        // Base quad width in pixels (24.0 for rain, cell width for overlay)
         float charHeight;       // Base quad height in pixels (36.0 for rain, cell height for overlay)
-        float padding[45];      // Padding to 256 bytes for optimal GPU alignment
+        float reserved;         // Keeps schemeColor on a 16-byte register boundary
+        float schemeColor[4];   // Rain trail tint; slots with schemeTint = 0 keep their own color
+        float padding[40];      // Padding to 256 bytes for optimal GPU alignment
 
         ConstantBufferData() :
             projection     { 1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1 },
             characterScale ( 1.0f ),
             charWidth      ( 24.0f ),
             charHeight     ( 36.0f ),
+            reserved       ( 0.0f ),
+            schemeColor    { 0.0f, 1.0f, 0.0f, 1.0f },
             padding        {}
         {
         }
@@ -204,42 +229,50 @@ private:
     HRESULT CompileCharacterShaders();
     HRESULT CompileBloomShaders();
     HRESULT CreateDummyVertexBuffer();
-    HRESULT CreateInstanceBuffer();
+    HRESULT CreateRainStaticBuffer();
+    HRESULT CreateRainStreamBuffer();
     HRESULT CreateConstantBuffer();
     HRESULT CreateBloomConstantBuffer();
     HRESULT CreateScanlineConstantBuffer();
     HRESULT UploadScanlineConstants     (const RenderParams & params);
+    HRESULT UploadScanlineRows          (const RenderParams & params);
+    HRESULT CreatePostBloomTarget();
     HRESULT ApplyScanlinePass();
     HRESULT CreateBlendState();
     HRESULT CreateSamplerState();
+    HRESULT CreateGpuTimerQueries();
     HRESULT CreateDirect2DResources();
     HRESULT CreateFpsTextFormat();
     void    UpdateDpiScale();
     HRESULT CreateBloomResources       (UINT width, UINT height);
+    HRESULT CreateDualFilterResources  (UINT bloomWidth, UINT bloomHeight);
 
     // Rendering helpers
-    void    SortStreaksByDepth       (std::vector<const CharacterStreak *> & streaks);
-    HRESULT UpdateInstanceBuffer     (const AnimationSystem & animationSystem, ColorScheme colorScheme, float elapsedTime, COLORREF customColor);
+    HRESULT UploadRainInstances      (const AnimationSystem & animationSystem);
     void    ClearRenderTarget();
-    void    RenderFPSCounter         (float fps, int rainPercentage, int streakCount, int activeHeadCount, double gpuLoadPercent, bool gpuLoadValid);
+    void    BeginGpuTimer();
+    void    EndGpuTimer();
+    void    CollectGpuTimers();
+    void    RenderFPSCounter         (float fps, int rainPercentage, int streakCount, int activeHeadCount, double gpuLoadPercent, bool gpuLoadValid, const FrameTimingPercentiles & frameTime);
     void    DrawFeatheredGlow        (const wchar_t * fpsText, UINT32 textLength, const D2D1_RECT_F & textRect);
     void    DrawFeatheredBackground  (std::span<const HintCharacter> chars, std::span<const float> xPositions, float advanceScale, float baseY, float cellHeight, int numRows, float padding, float opacityScale);
     void    ComputeRowRects          (std::span<const HintCharacter> chars, std::span<const float> xPositions, float advanceScale, float baseY, float cellHeight, int numRows, float hPad, float vPad);
     void    BuildOverlayInstances    (std::span<const HintCharacter> chars, float charScale, float baseY, float cellHeight, std::span<const float> xPositions, float advanceScale);
     void    RenderOverlayInstances   ();
     void    RenderTwoColumnOverlay   (std::span<const HintCharacter> chars, int marginCols, int keyColChars, int gapChars, int numRows, float cellHeight, float padding);
-    HRESULT ApplyBloom (ID3D11RenderTargetView * pCompositeTarget);
+    HRESULT ApplyBloom               (ID3D11RenderTargetView * pCompositeTarget, bool fuseScanlines);
+    void    ApplyDualFilterBlur      (UINT bloomWidth, UINT bloomHeight);
     void    RenderFullscreenPass     (ID3D11RenderTargetView * pRenderTarget, ID3D11PixelShader * pPixelShader, ID3D11ShaderResourceView * const * ppShaderResources, UINT numResources);
     void    SetRenderPipelineState   (ID3D11InputLayout * pInputLayout, D3D11_PRIMITIVE_TOPOLOGY topology, ID3D11Buffer * pVertexBuffer, UINT stride, ID3D11VertexShader * pVertexShader, ID3D11Buffer * pConstantBuffer, ID3D11PixelShader * pPixelShader);
     void    SetViewport              (UINT width, UINT height);
     
     static int  CodepointToUtf16                    (uint32_t codepoint, wchar_t * glyphStr);
-    static void BuildCharacterInstanceData          (const CharacterInstance & character, const Vector3 & streakPos, const Color4 & schemeColor, CharacterInstanceData & data);
     void        ComputeOverlayLayout                (std::span<const HintCharacter> chars, int marginCols, int keyColChars, int gapChars, int numRows, float cellHeight, float padding, std::vector<float> & xPositions, D2D1_RECT_F & bounds, float & baseY, float & advanceScale);
     void        CalculateColumnAlignedTextPositions (std::span<const HintCharacter> chars, int marginCols, int keyColChars, int descColStart, float maxKeyWidth, const std::vector<float> & keyColWidths, float gapWidth, float advScaled, std::vector<float> & positions);
 
     // Resource cleanup helpers
     void ReleaseBloomResources();
+    void ReleaseDualFilterResources();
     void ReleaseDirect2DResources();
     void ReleaseRenderTargetResources();
     void ReleaseDirectXResources();
@@ -269,15 +302,36 @@ private:
     ComPtr<ID3D11ShaderResourceView>  m_blurTempSRV;
 
     // v1.5 (T051, contracts/scanline-shader.md): post-bloom intermediate
-    // backbuffer-sized render target.  When the scanline pass is active,
-    // the bloom composite (or, for the glow-off bypass branch, the
-    // direct scene copy) writes here instead of the swapchain backbuffer;
-    // the scanline PS then samples this SRV and writes to the swapchain
-    // backbuffer.  Recreated alongside the bloom resources on Resize.
+    // backbuffer-sized render target, allocated by CreatePostBloomTarget
+    // only when the separate scanline pass runs (the fused composite
+    // shader is unavailable).  The bloom composite (or, for the glow-off
+    // bypass branch, the direct scene copy) then writes here instead of
+    // the swapchain backbuffer; the scanline PS samples this SRV and
+    // writes to the swapchain backbuffer.  Released with the bloom
+    // resources on Resize.
     ComPtr<ID3D11Texture2D>           m_postBloomTexture;
     ComPtr<ID3D11RenderTargetView>    m_postBloomRTV;
     ComPtr<ID3D11ShaderResourceView>  m_postBloomSRV;
 
+    // Dual-filter bloom mip chain (BloomAlgorithm::DualFilter only): level
+    // k + 1 below the bloom texture, halving it each time.  Down holds the
+    // 4-tap downsample, Up the upsample blended back at the same size (the
+    // coarsest level has none).  Sized for the deepest chain so changing
+    // the pass count needs no reallocation.
+    struct BloomLevel
+    {
+        ComPtr<ID3D11Texture2D>          texture;
+        ComPtr<ID3D11RenderTargetView>   rtv;
+        ComPtr<ID3D11ShaderResourceView> srv;
+        UINT                             width  { 0 };
+        UINT                             height { 0 };
+    };
+
+    static constexpr int MAX_DUAL_FILTER_LEVELS = 5;  // DualFilterLevelCount at 4 blur passes
+
+    BloomLevel                        m_dualFilterDown[MAX_DUAL_FILTER_LEVELS];
+    BloomLevel                        m_dualFilterUp[MAX_DUAL_FILTER_LEVELS - 1];
+
     ComPtr<ID3D11PixelShader>         m_bloomExtractPS;
     ComPtr<ID3D11PixelShader>         m_blurHorizontalPS;
     ComPtr<ID3D11PixelShader>         m_blurHorizontalPS9;
@@ -285,6 +339,9 @@ private:
     ComPtr<ID3D11PixelShader>         m_blurVerticalPS;
     ComPtr<ID3D11PixelShader>         m_blurVerticalPS9;
     ComPtr<ID3D11PixelShader>         m_blurVerticalPS5;
+    ComPtr<ID3D11PixelShader>         m_dualDownsamplePS;
+    ComPtr<ID3D11PixelShader>         m_dualUpsamplePS;
+    ComPtr<ID3D11PixelShader>         m_dualUpsampleFinalPS;
     ComPtr<ID3D11PixelShader>         m_compositePS;
     ComPtr<ID3D11PixelShader>         m_haloPS;
 
@@ -294,6 +351,16 @@ private:
     // disabling the user-facing controls (FR-028b: silent bypass).
     ComPtr<ID3D11PixelShader>         m_scanlinePS;
     ComPtr<ID3D11Buffer>              m_scanlineConstantBuffer;
+
+    // Per-row scanline darken factors (t2 of the fused composite shader),
+    // rebuilt from m_scanlineRows only when the line count, intensity or
+    // render height changes.  With these the composite applies scanlines
+    // itself, so the separate scanline pass and its m_postBloomTexture
+    // round trip are only the fallback when the fused shader is missing.
+    ComPtr<ID3D11PixelShader>         m_compositeScanlinePS;
+    ComPtr<ID3D11Buffer>              m_scanlineRowBuffer;
+    ComPtr<ID3D11ShaderResourceView>  m_scanlineRowSRV;
+    ScanlineAttenuationTable          m_scanlineRows;
     ComPtr<ID3D11Buffer>              m_fullscreenQuadVB;
     ComPtr<ID3D11Buffer>              m_haloConstantBuffer;
     ComPtr<ID3D11Buffer>              m_bloomConstantBuffer;
@@ -313,14 +380,44 @@ private:
     ComPtr<ID3D11PixelShader>  m_pixelShader;
     ComPtr<ID3D11PixelShader>  m_overlayPixelShader;
     ComPtr<ID3D11InputLayout>  m_inputLayout;
+    ComPtr<ID3D11VertexShader> m_rainVertexShader;
+    ComPtr<ID3D11InputLayout>  m_rainInputLayout;
     ComPtr<ID3D11InputLayout>  m_fullscreenQuadInputLayout;
     ComPtr<ID3D11VertexShader> m_fullscreenQuadVS;
 
     // Buffers
     ComPtr<ID3D11Buffer> m_dummyVertexBuffer;
-    ComPtr<ID3D11Buffer> m_instanceBuffer;
     ComPtr<ID3D11Buffer> m_constantBuffer;
-    UINT                 m_instanceBufferCapacity { INITIAL_INSTANCE_CAPACITY };
+
+    // Rain instances: persistent per-slot records in a structured buffer
+    // that is patched one dirty span at a time, plus a thin per-frame
+    // {slot, brightness} stream drawn back-to-front.  See InstanceStore.
+    ComPtr<ID3D11Buffer>             m_rainStaticBuffer;
+    ComPtr<ID3D11ShaderResourceView> m_rainStaticSRV;
+    ComPtr<ID3D11Buffer>             m_rainStreamBuffer;
+    UINT                             m_rainStaticCapacity { INITIAL_INSTANCE_CAPACITY };
+    UINT                             m_rainStreamCapacity { INITIAL_INSTANCE_CAPACITY };
+    InstanceStore                    m_instanceStore;
+    int64_t                          m_lastInstanceBuildUs { 0 };
+
+    // GPU frame timing: a small ring of timestamp queries read back with
+    // DONOTFLUSH, so collecting a result never waits on the GPU.  A frame
+    // whose slot is still in flight is simply not timed.
+    struct GpuTimerQueries
+    {
+        ComPtr<ID3D11Query> disjoint;
+        ComPtr<ID3D11Query> begin;
+        ComPtr<ID3D11Query> end;
+        bool                pending { false };
+    };
+
+    static constexpr size_t s_kGpuTimerCount = 4;
+
+    std::array<GpuTimerQueries, s_kGpuTimerCount> m_gpuTimers;
+    size_t                                        m_gpuTimerNext   { 0 };
+    bool                                          m_gpuTimerOpen   { false };
+    bool                                          m_gpuTimingOn    { false };
+    int64_t                                       m_lastGpuFrameUs { -1 };
 
     // Overlay GPU rendering
     ComPtr<ID3D11Buffer>                   m_overlayInstanceBuffer;
@@ -361,14 +458,11 @@ private:
     int               m_blurPasses              { 3 };
     ResolutionDivisor m_bloomResolutionDivisor  { ResolutionDivisor::Half };
     BlurTaps          m_blurTaps                { BlurTaps::High };
+    BloomAlgorithm    m_bloomAlgorithm          { BloomAlgorithm::Gaussian };
 
     // Character scale override (bypasses viewport-based scaling when set)
     std::optional<float> m_characterScaleOverride;
 
-    // Per-frame working data (reused to avoid allocations)
-    std::vector<CharacterInstanceData>   m_instanceData;
-    std::vector<const CharacterStreak *> m_streakPtrs;
-
     static constexpr UINT INITIAL_INSTANCE_CAPACITY = 10000; // Max characters per frame
 };
 
@@ -0,0 +1,138 @@
+#include "pch.h"
+
+#include "RenderWakeSignal.h"
+
+
+
+
+namespace
+{
+    // What a thread blocks on in a timed WaitUntil, created on its first:
+    // an auto-reset event Notify sets, and a timer armed for the deadline
+    struct WaiterHandles
+    {
+        WaiterHandles() :
+            hWake (CreateEventW (nullptr, FALSE, FALSE, nullptr))
+        {
+        }
+
+        ~WaiterHandles()
+        {
+            if (hWake != nullptr)
+            {
+                CloseHandle (hWake);
+            }
+        }
+
+        bool IsValid() const { return hWake != nullptr && timer.IsValid(); }
+
+        HANDLE        hWake;
+        DeadlineTimer timer;
+    };
+
+
+    thread_local WaiterHandles t_waiter;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  RenderWakeSignal::Notify
+//
+//  The generation is advanced under the mutex so it cannot slip in
+//  between a waiter's generation check and its block on the condition
+//  variable or its wake event.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void RenderWakeSignal::Notify()
+{
+    {
+        std::lock_guard<std::mutex> lock (m_mutex);
+
+        m_generation.fetch_add (1, std::memory_order_acq_rel);
+
+        for (HANDLE hWake : m_waiterEvents)
+        {
+            SetEvent (hWake);
+        }
+    }
+
+    m_wake.notify_all();
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  RenderWakeSignal::WaitUntil
+//
+//  The thread's event is registered under the mutex after the generation
+//  check, so a Notify either lands before the check or sets the event.  A
+//  Notify that sets the event just after a timer wake leaves it signaled;
+//  the next wait then returns early, finds nothing new and waits again.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+bool RenderWakeSignal::WaitUntil (uint64_t generation, Clock::time_point deadline)
+{
+    WaiterHandles              & waiter = t_waiter;
+    std::unique_lock<std::mutex> lock (m_mutex);
+    DWORD                        result = WAIT_OBJECT_0;
+
+
+
+    while (waiter.IsValid() && result != WAIT_FAILED)
+    {
+        if (IsNotifiedSince (generation))
+        {
+            return true;
+        }
+
+        if (Clock::now() >= deadline)
+        {
+            return false;
+        }
+
+        if (!waiter.timer.Arm (deadline))
+        {
+            break;
+        }
+
+        HANDLE handles[] = { waiter.hWake, waiter.timer.GetHandle() };
+
+        m_waiterEvents.push_back (waiter.hWake);
+        lock.unlock();
+
+        result = WaitForMultipleObjects (ARRAYSIZE (handles), handles, FALSE, INFINITE);
+
+        lock.lock();
+        std::erase (m_waiterEvents, waiter.hWake);
+    }
+
+    return m_wake.wait_until (lock, deadline, [&] { return IsNotifiedSince (generation); });
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  RenderWakeSignal::Wait
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void RenderWakeSignal::Wait (uint64_t generation)
+{
+    std::unique_lock<std::mutex> lock (m_mutex);
+
+
+
+    m_wake.wait (lock, [&] { return IsNotifiedSince (generation); });
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "DeadlineTimer.h"
+#include "FrameClock.h"
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  RenderWakeSignal — Blocks idle render threads until something changes
+//
+//  Render threads that have nothing to draw (a display-mode transition in
+//  progress, or paused with a static picture) wait here instead of
+//  polling.  Anything that should end the wait — a stop request, the end
+//  of a transition, a settings change, an overlay command — calls Notify
+//  after making its change visible.
+//
+//  Lost wakeups are avoided with a generation count: a render thread
+//  reads GetGeneration() BEFORE looking at the state it is about to act
+//  on, and passes that generation to Wait.  A Notify that lands anywhere
+//  after the read — including between the state check and the wait —
+//  has already advanced the generation, so the wait returns at once.
+//
+//  Notify is cheap enough to call from any thread on every state change;
+//  waiters wake in microseconds rather than on the next poll.
+//
+//  WaitUntil's deadline is a frame deadline (a shared worker's next vblank,
+//  a paused ColorCycle redraw), which a condition variable would round to
+//  the 15.6 ms default Windows timer tick.  Each waiting thread therefore
+//  blocks on its own wake event and DeadlineTimer together; Notify sets
+//  the events of every thread waiting that way.  Without a high-resolution
+//  timer (before Windows 10 1803) WaitUntil uses the condition variable.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class RenderWakeSignal
+{
+public:
+    using Clock = FrameClock;
+
+    // Any thread
+    void     Notify();
+    uint64_t GetGeneration() const { return m_generation.load (std::memory_order_acquire); }
+
+    // Returns true when woken by a Notify since `generation`, false on
+    // reaching the deadline
+    bool     WaitUntil (uint64_t generation, Clock::time_point deadline);
+    void     Wait      (uint64_t generation);
+
+private:
+    bool IsNotifiedSince (uint64_t generation) const { return m_generation.load (std::memory_order_acquire) != generation; }
+
+    std::mutex              m_mutex;
+    std::condition_variable m_wake;
+    std::vector<HANDLE>     m_waiterEvents;     // under m_mutex: events of threads in a timed WaitUntil
+    std::atomic<uint64_t>   m_generation { 0 };
+};
@@ -0,0 +1,62 @@
+#include "pch.h"
+
+#include "ScanlineAttenuation.h"
+
+
+
+
+static constexpr float s_kPi = 3.14159265f;
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  ScanlineAttenuationTable::Update
+//
+////////////////////////////////////////////////////////////////////////////////
+
+bool ScanlineAttenuationTable::Update (UINT renderHeight, float linesPerHeight, float intensity)
+{
+    if (renderHeight   == m_rows.size()    &&
+        linesPerHeight == m_linesPerHeight &&
+        intensity      == m_intensity)
+    {
+        return false;
+    }
+
+    m_rows.resize (renderHeight);
+    m_linesPerHeight = linesPerHeight;
+    m_intensity      = intensity;
+
+    for (UINT row = 0; row < renderHeight; row++)
+    {
+        m_rows[row] = ComputeRow (row, renderHeight, linesPerHeight, intensity);
+    }
+
+    return true;
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  ScanlineAttenuationTable::ComputeRow
+//
+//  Shaders/scanlines.hlsl evaluated at the row's pixel center: uv.y is
+//  (row + 0.5) / height, and ddy(linePos) across a 2x2 quad is one row's
+//  worth of lines.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+float ScanlineAttenuationTable::ComputeRow (UINT row, UINT renderHeight, float linesPerHeight, float intensity) noexcept
+{
+    float linePos = (static_cast<float> (row) + 0.5f) / static_cast<float> (renderHeight) * linesPerHeight;
+    float perPix  = std::max (linesPerHeight / static_cast<float> (renderHeight), 1e-6f);
+    float rolloff = std::max (std::sin (s_kPi * perPix) / (s_kPi * perPix), 0.0f);
+    float bright  = 0.5f - 0.5f * std::cos (2.0f * s_kPi * linePos) * rolloff;
+
+
+    return (1.0f - intensity) + intensity * bright;
+}
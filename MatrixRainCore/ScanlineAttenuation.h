@@ -0,0 +1,37 @@
+#pragma once
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  ScanlineAttenuationTable
+//
+//  The scanline darken factor for every row of the render target.  The
+//  scanline shader's factor depends only on the row, the intensity and the
+//  line count: uv.y is constant along a row, and ddy(linePos) is the same
+//  linesPerHeight / renderHeight everywhere.  So the per-pixel sin, cos and
+//  sinc rolloff collapse into one table lookup and a multiply per pixel.
+//
+//  Update rebuilds the table only when one of its three inputs changed, so
+//  a steady frame costs three compares.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class ScanlineAttenuationTable
+{
+public:
+    // Returns true when the table was rebuilt
+    bool Update (UINT renderHeight, float linesPerHeight, float intensity);
+
+    std::span<const float> GetRows()   const { return m_rows;                          }
+    UINT                   GetHeight() const { return static_cast<UINT> (m_rows.size()); }
+
+    // Darken factor of one row, in the scanline shader's closed form
+    static float ComputeRow (UINT row, UINT renderHeight, float linesPerHeight, float intensity) noexcept;
+
+private:
+    std::vector<float> m_rows;
+    float              m_linesPerHeight { -1.0f };
+    float              m_intensity      { -1.0f };
+};
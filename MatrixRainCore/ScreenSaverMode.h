@@ -13,5 +13,6 @@ enum class ScreenSaverMode
     PasswordChangeUnsupported,
     HelpRequested,
     Install,
-    Uninstall
+    Uninstall,
+    Record
 };
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "HeadlessRecorder.h"
 #include "ScreenSaverMode.h"
 
 
@@ -8,14 +9,15 @@
 
 struct ScreenSaverModeContext
 {
-    ScreenSaverMode  m_mode              { ScreenSaverMode::Normal };
-    HWND             m_previewParentHwnd { nullptr                 };
-    bool             m_enableHotkeys     { false                   };
-    bool             m_hideCursor        { false                   };
-    bool             m_exitOnInput       { false                   };
-    bool             m_suppressDebug     { false                   };
-    bool             m_spanAllDisplays   { false                   };
-    bool             m_forceInstall      { false                   };
-    std::wstring     m_switchPrefix      { L"/"                    };
-    std::wstring     m_errorMessage;
+    ScreenSaverMode       m_mode              { ScreenSaverMode::Normal };
+    HWND                  m_previewParentHwnd { nullptr                 };
+    bool                  m_enableHotkeys     { false                   };
+    bool                  m_hideCursor        { false                   };
+    bool                  m_exitOnInput       { false                   };
+    bool                  m_suppressDebug     { false                   };
+    bool                  m_spanAllDisplays   { false                   };
+    bool                  m_forceInstall      { false                   };
+    std::wstring          m_switchPrefix      { L"/"                    };
+    std::wstring          m_errorMessage;
+    HeadlessRecordOptions m_record;                     // /record output file and options
 };
@@ -44,6 +44,17 @@ struct ScreenSaverSettings
     // written to the registry until the user actually clicks OK.
     static constexpr COLORREF DEFAULT_CUSTOM_COLOR           = RGB (0, 255, 0);
 
+    // Adaptive quality (QualityGovernor): the per-frame cost, in
+    // microseconds, the governor lowers quality to stay under.  0 (the
+    // default) turns it off; anything else is clamped to [1 ms, 100 ms].
+    static constexpr int MIN_ADAPTIVE_QUALITY_TARGET_US = 1000;
+    static constexpr int MAX_ADAPTIVE_QUALITY_TARGET_US = 100000;
+
+    // Render workers (SharedRenderWorker): 0 (the default) gives every
+    // monitor its own render thread; N > 0 drives all monitors from at
+    // most N shared workers.  Read whenever the render threads start.
+    static constexpr int MAX_RENDER_WORKERS             = 8;
+
     int                                 m_densityPercent        { DEFAULT_DENSITY_PERCENT         };
     std::wstring                        m_colorSchemeKey        { L"cycle" };
     int                                 m_animationSpeedPercent { DEFAULT_ANIMATION_SPEED_PERCENT };
@@ -73,6 +84,11 @@ struct ScreenSaverSettings
     QualityPreset                          m_qualityPreset         { QualityPreset::High };
     AdvancedGraphicsValues                 m_advancedValues;                          // Defaults to High row
     std::optional<AdvancedGraphicsValues>  m_lastCustom;                              // Last user-customized set
+    int                                    m_adaptiveQualityTargetUs { 0 };           // 0 = adaptive quality off
+    int                                    m_renderWorkers           { 0 };           // 0 = one render thread per monitor
+    bool                                   m_sharedSimulation        { false };       // One VirtualDesktopSimulation across all monitors
+    bool                                   m_simulationThread        { false };       // Simulate on a SimulationPipeline thread per monitor
+    std::wstring                           m_traceFile;                               // Empty (default) = frame tracing off
 
     std::optional<SystemClockTimePoint> m_lastSavedTimestamp;
 
@@ -94,6 +110,13 @@ inline void ScreenSaverSettings::Clamp()
     m_glowSizePercent       = ClampPercent        (m_glowSizePercent, MIN_GLOW_SIZE_PERCENT, MAX_GLOW_SIZE_PERCENT);
     m_scanlinesIntensity    = ClampPercent        (m_scanlinesIntensity, MIN_SCANLINES_INTENSITY_PERCENT, MAX_SCANLINES_INTENSITY_PERCENT);
     m_scanlinesStyle        = ClampPercent        (m_scanlinesStyle,     MIN_SCANLINES_STYLE,             MAX_SCANLINES_STYLE);
+
+    if (m_adaptiveQualityTargetUs != 0)
+    {
+        m_adaptiveQualityTargetUs = std::clamp (m_adaptiveQualityTargetUs, MIN_ADAPTIVE_QUALITY_TARGET_US, MAX_ADAPTIVE_QUALITY_TARGET_US);
+    }
+
+    m_renderWorkers = std::clamp (m_renderWorkers, 0, MAX_RENDER_WORKERS);
 }
 
 
@@ -0,0 +1,307 @@
+#include "pch.h"
+
+#include "SdfGlyphAtlas.h"
+
+
+
+
+
+namespace
+{
+    constexpr float s_kFar = 1e20f;
+
+
+
+    ////////////////////////////////////////////////////////////////////////////
+    //
+    //  DistanceTransform1D
+    //
+    //  Squared Euclidean distance transform of one line (Felzenszwalb and
+    //  Huttenlocher): the lower envelope of the parabolas rooted at each
+    //  sample.  f and d may not alias; v and z are scratch of n and n + 1.
+    //
+    ////////////////////////////////////////////////////////////////////////////
+
+    void DistanceTransform1D (const float * f, float * d, int n, int * v, float * z)
+    {
+        int k = 0;
+
+
+
+        v[0] = 0;
+        z[0] = -INFINITY;
+        z[1] =  INFINITY;
+
+        for (int q = 1; q < n; q++)
+        {
+            float s = 0.0f;
+
+            for (;;)
+            {
+                int r = v[k];
+
+                s = ((f[q] + float (q) * q) - (f[r] + float (r) * r)) / float (2 * (q - r));
+
+                if (s > z[k])
+                {
+                    break;
+                }
+
+                k--;
+            }
+
+            k++;
+            v[k]     = q;
+            z[k]     = s;
+            z[k + 1] = INFINITY;
+        }
+
+        k = 0;
+
+        for (int q = 0; q < n; q++)
+        {
+            while (z[k + 1] < float (q))
+            {
+                k++;
+            }
+
+            float dq = float (q - v[k]);
+
+            d[q] = dq * dq + f[v[k]];
+        }
+    }
+
+
+
+    // Distance from each pixel center to the nearest pixel center on the
+    // given side of the 50% coverage threshold, in pixels
+    std::vector<float> DistanceToSet (UINT width, UINT height, std::span<const uint8_t> coverage, bool inside)
+    {
+        UINT               n    = std::max (width, height);
+        std::vector<float> grid (size_t (width) * height);
+        std::vector<float> line (n);
+        std::vector<float> out  (n);
+        std::vector<int>   v    (n);
+        std::vector<float> z    (n + 1);
+
+
+
+        for (size_t i = 0; i < grid.size(); i++)
+        {
+            bool isInside = coverage[i] >= 128;
+
+            grid[i] = (isInside == inside) ? 0.0f : s_kFar;
+        }
+
+        for (UINT x = 0; x < width; x++)
+        {
+            for (UINT y = 0; y < height; y++)
+            {
+                line[y] = grid[size_t (y) * width + x];
+            }
+
+            DistanceTransform1D (line.data(), out.data(), static_cast<int> (height), v.data(), z.data());
+
+            for (UINT y = 0; y < height; y++)
+            {
+                grid[size_t (y) * width + x] = out[y];
+            }
+        }
+
+        for (UINT y = 0; y < height; y++)
+        {
+            float * row = grid.data() + size_t (y) * width;
+
+            std::copy (row, row + width, line.data());
+            DistanceTransform1D (line.data(), row, static_cast<int> (width), v.data(), z.data());
+        }
+
+        for (float & d : grid)
+        {
+            d = sqrtf (d);
+        }
+
+        return grid;
+    }
+}
+
+
+
+
+
+uint8_t SdfGlyphAtlas::EncodeDistance (float distance, float spread)
+{
+    float normalized = 0.5f + std::clamp (distance, -spread, spread) / (2.0f * spread);
+
+
+
+    return static_cast<uint8_t> (normalized * 255.0f + 0.5f);
+}
+
+
+
+
+
+float SdfGlyphAtlas::DecodeDistance (uint8_t value, float spread)
+{
+    return (static_cast<float> (value) - s_kEdgeValue) * (2.0f * spread / 255.0f);
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SdfGlyphAtlas::Generate
+//
+//  Source pixels are classified inside (coverage >= 50%) or outside.  A
+//  fully covered or empty pixel is half a pixel further from the edge than
+//  the nearest pixel center of the other set; an anti-aliased pixel is
+//  placed by its coverage, which is exact for a straight edge.  The field
+//  is then averaged over each downsample x downsample block, whose mean
+//  pixel center is the output texel center.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+HRESULT SdfGlyphAtlas::Generate (UINT                     srcWidth,
+                                 UINT                     srcHeight,
+                                 std::span<const uint8_t> coverage,
+                                 UINT                     downsample,
+                                 float                    spread)
+{
+    HRESULT            hr          = S_OK;
+    std::vector<float> toInside;
+    std::vector<float> toOutside;
+    std::vector<float> signedDistance;
+    float              blockScale  = 0.0f;
+
+
+
+    CBREx (srcWidth > 0 && srcHeight > 0 && coverage.size() == size_t (srcWidth) * srcHeight, E_INVALIDARG);
+    CBREx (downsample > 0 && srcWidth % downsample == 0 && srcHeight % downsample == 0,      E_INVALIDARG);
+    CBREx (spread > 0.0f,                                                                    E_INVALIDARG);
+
+    toInside  = DistanceToSet (srcWidth, srcHeight, coverage, true);
+    toOutside = DistanceToSet (srcWidth, srcHeight, coverage, false);
+
+    signedDistance.resize (coverage.size());
+
+    for (size_t i = 0; i < coverage.size(); i++)
+    {
+        uint8_t c = coverage[i];
+
+        if (c > 0 && c < 255)
+        {
+            signedDistance[i] = static_cast<float> (c) / 255.0f - 0.5f;
+        }
+        else if (c >= 128)
+        {
+            signedDistance[i] = toOutside[i] - 0.5f;
+        }
+        else
+        {
+            signedDistance[i] = 0.5f - toInside[i];
+        }
+    }
+
+    m_width      = srcWidth  / downsample;
+    m_height     = srcHeight / downsample;
+    m_spread     = spread;
+    blockScale   = 1.0f / (static_cast<float> (downsample) * static_cast<float> (downsample) * static_cast<float> (downsample));
+    m_distances.assign (size_t (m_width) * m_height, 0);
+
+    for (UINT ty = 0; ty < m_height; ty++)
+    {
+        for (UINT tx = 0; tx < m_width; tx++)
+        {
+            float sum = 0.0f;
+
+            for (UINT sy = ty * downsample; sy < (ty + 1) * downsample; sy++)
+            {
+                const float * row = signedDistance.data() + size_t (sy) * srcWidth;
+
+                for (UINT sx = tx * downsample; sx < (tx + 1) * downsample; sx++)
+                {
+                    sum += row[sx];
+                }
+            }
+
+            // Mean over the block, then source pixels to output texels
+            m_distances[size_t (ty) * m_width + tx] = EncodeDistance (sum * blockScale, spread);
+        }
+    }
+
+Error:
+    return hr;
+}
+
+
+
+
+
+HRESULT SdfGlyphAtlas::Load (UINT width, UINT height, float spread, std::span<const uint8_t> distances)
+{
+    HRESULT hr = S_OK;
+
+
+
+    CBREx (width > 0 && height > 0 && distances.size() == size_t (width) * height, E_INVALIDARG);
+    CBREx (spread > 0.0f,                                                           E_INVALIDARG);
+
+    m_width  = width;
+    m_height = height;
+    m_spread = spread;
+    m_distances.assign (distances.begin(), distances.end());
+
+Error:
+    return hr;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SdfGlyphAtlas::SampleDistance
+//
+//  Same texel-center convention and clamp addressing as
+//  SoftwareGlyphAtlas::SampleBilinear.  Interpolating the encoded bytes and
+//  decoding once is exact because the encoding is linear.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+float SdfGlyphAtlas::SampleDistance (float u, float v) const
+{
+    float           tx     = u * static_cast<float> (m_width)  - 0.5f;
+    float           ty     = v * static_cast<float> (m_height) - 0.5f;
+    float           fx     = tx - floorf (tx);
+    float           fy     = ty - floorf (ty);
+    int             x0     = static_cast<int> (floorf (tx));
+    int             y0     = static_cast<int> (floorf (ty));
+    int             maxX   = static_cast<int> (m_width)  - 1;
+    int             maxY   = static_cast<int> (m_height) - 1;
+    int             xa     = std::clamp (x0,     0, maxX);
+    int             xb     = std::clamp (x0 + 1, 0, maxX);
+    int             ya     = std::clamp (y0,     0, maxY);
+    int             yb     = std::clamp (y0 + 1, 0, maxY);
+    const uint8_t * rowA   = m_distances.data() + size_t (ya) * m_width;
+    const uint8_t * rowB   = m_distances.data() + size_t (yb) * m_width;
+    float           top    = rowA[xa] + (float (rowA[xb]) - rowA[xa]) * fx;
+    float           bottom = rowB[xa] + (float (rowB[xb]) - rowB[xa]) * fx;
+    float           value  = top + (bottom - top) * fy;
+
+
+
+    return (value - s_kEdgeValue) * (2.0f * m_spread / 255.0f);
+}
+
+
+
+
+
+float SdfGlyphAtlas::SampleCoverage (float u, float v, float screenPixelsPerTexel) const
+{
+    return std::clamp (SampleDistance (u, v) * screenPixelsPerTexel + 0.5f, 0.0f, 1.0f);
+}
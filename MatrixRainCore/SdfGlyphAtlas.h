@@ -0,0 +1,75 @@
+#pragma once
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SdfGlyphAtlas
+//
+//  Single-channel signed-distance-field atlas.  Each texel stores the
+//  distance from its center to the nearest glyph edge, so one small image
+//  reconstructs sharp edges at any on-screen size: the overlay can use the
+//  same atlas on every monitor and at every DPI instead of rasterizing a
+//  new one per scale.
+//
+//  Format: one byte per texel, row-major, no padding between rows.
+//
+//      byte = round (255 * (0.5 + distance / (2 * spread)))
+//
+//  where distance is in atlas texels, positive inside the glyph, and clamped
+//  to [-spread, +spread].  The edge is at 127.5.  The texel grid keeps the
+//  source atlas layout scaled by 1 / downsample, so UVs computed for the
+//  source atlas address the same glyph here.
+//
+//  Generate builds the field offline from a coverage atlas rendered at
+//  downsample x the target resolution (the 2048x2048 rain atlas, say):
+//  exact Euclidean distance transforms of the inside and outside sets,
+//  anti-aliased edge pixels placed by their coverage, then box-filtered
+//  down.  A single channel rounds sharp corners at about one texel; a
+//  multi-channel field would keep them but needs the glyph outlines, which
+//  a coverage image does not have.
+//
+//  SampleCoverage is the reference the GPU shader has to match: bilinear
+//  distance, scaled to screen pixels, with a one-pixel linear edge.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class SdfGlyphAtlas
+{
+public:
+    static constexpr float s_kEdgeValue = 127.5f;
+
+    static uint8_t EncodeDistance (float distance, float spread);
+    static float   DecodeDistance (uint8_t value,  float spread);
+
+    // coverage is srcWidth x srcHeight, one byte per pixel; both sizes must
+    // be multiples of downsample.  spread is in output texels.
+    HRESULT Generate (UINT                     srcWidth,
+                      UINT                     srcHeight,
+                      std::span<const uint8_t> coverage,
+                      UINT                     downsample,
+                      float                    spread);
+
+    // Adopt an existing field (e.g. from a cache file)
+    HRESULT Load (UINT width, UINT height, float spread, std::span<const uint8_t> distances);
+
+    // Bilinear sample with clamp addressing; signed distance in texels
+    float SampleDistance (float u, float v) const;
+
+    // Coverage in [0,1] when one atlas texel covers screenPixelsPerTexel
+    // screen pixels
+    float SampleCoverage (float u, float v, float screenPixelsPerTexel) const;
+
+    bool                     IsValid()     const { return !m_distances.empty(); }
+    UINT                     GetWidth()    const { return m_width;              }
+    UINT                     GetHeight()   const { return m_height;             }
+    float                    GetSpread()   const { return m_spread;             }
+    std::span<const uint8_t> Distances()   const { return m_distances;          }
+
+private:
+    std::vector<uint8_t> m_distances;
+    UINT                 m_width  { 0 };
+    UINT                 m_height { 0 };
+    float                m_spread { 0.0f };
+};
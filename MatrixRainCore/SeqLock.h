@@ -0,0 +1,109 @@
+#pragma once
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SeqLock<T>
+//
+//  Single-writer sequence lock around a small trivially copyable value.
+//  Readers never block and never write shared memory, so any number of
+//  render threads can take a copy every frame without contending with each
+//  other or with the writer; a reader that overlaps a write simply copies
+//  again.
+//
+//  Store must be serialized by the caller (SharedState holds its mutex).
+//  The sequence is odd while a store is in progress and advances by two per
+//  store, so Version() / 2 counts published values.
+//
+//  The payload lives in relaxed atomic words rather than a plain T: the
+//  copy a reader discards after a torn read is still not a data race, and
+//  race detectors see none.  The fences order the payload against the
+//  sequence (Boehm, "Can Seqlocks Get Along With Programming Language
+//  Memory Models?").
+//
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+class SeqLock
+{
+    static_assert (std::is_trivially_copyable_v<T>, "SeqLock payload must be trivially copyable");
+
+public:
+    SeqLock()
+    {
+        Store (T {});
+    }
+
+    SeqLock (const SeqLock &)             = delete;
+    SeqLock & operator= (const SeqLock &) = delete;
+
+    void Store (const T & value)
+    {
+        uint64_t words[s_kWordCount] = {};
+        uint64_t sequence            = m_sequence.load (std::memory_order_relaxed);
+
+
+
+        memcpy (words, &value, sizeof (T));
+
+        m_sequence.store (sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence (std::memory_order_release);
+
+        for (size_t i = 0; i < s_kWordCount; i++)
+        {
+            m_words[i].store (words[i], std::memory_order_relaxed);
+        }
+
+        m_sequence.store (sequence + 2, std::memory_order_release);
+    }
+
+    T Load() const
+    {
+        uint64_t words[s_kWordCount] = {};
+        uint64_t before              = 0;
+        uint64_t after               = 0;
+        T        value;
+
+
+
+        for (;;)
+        {
+            before = m_sequence.load (std::memory_order_acquire);
+
+            if (before & 1)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            for (size_t i = 0; i < s_kWordCount; i++)
+            {
+                words[i] = m_words[i].load (std::memory_order_relaxed);
+            }
+
+            std::atomic_thread_fence (std::memory_order_acquire);
+            after = m_sequence.load (std::memory_order_relaxed);
+
+            if (before == after)
+            {
+                break;
+            }
+        }
+
+        memcpy (&value, words, sizeof (T));
+        return value;
+    }
+
+    uint64_t Version() const
+    {
+        return m_sequence.load (std::memory_order_acquire);
+    }
+
+private:
+    static constexpr size_t s_kWordCount = (sizeof (T) + sizeof (uint64_t) - 1) / sizeof (uint64_t);
+
+    std::atomic<uint64_t>                           m_sequence { 0 };
+    std::array<std::atomic<uint64_t>, s_kWordCount> m_words    {};
+};
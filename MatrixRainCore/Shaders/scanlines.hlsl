@@ -37,6 +37,12 @@
 // Cost: 11 -> 18 instruction slots (fxc /T ps_5_0 /O3) -- one extra sincos,
 // one divide, one coarse derivative. The pass still issues a single texture
 // sample and no branches, and it is bound by that fetch, not by ALU.
+//
+// Everything above depends only on the row: uv.y is constant along it and
+// ddy(linePos) is linesPerHeight / height everywhere. RenderSystem therefore
+// normally evaluates this per row on the CPU (ScanlineAttenuationTable) and
+// multiplies it in during the bloom composite; this pass is the fallback
+// when that fused composite shader is unavailable. Keep the two in sync.
 
 cbuffer ScanlineCb : register(b0)
 {
@@ -0,0 +1,223 @@
+#include "pch.h"
+
+#include "SharedRenderWorker.h"
+
+#include "FrameTrace.h"
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  RenderThreadModelForWorkerCount
+//
+////////////////////////////////////////////////////////////////////////////////
+
+RenderThreadModel RenderThreadModelForWorkerCount (int renderWorkers)
+{
+    return renderWorkers > 0 ? RenderThreadModel::SharedWorker : RenderThreadModel::PerMonitor;
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  AssignContextsToWorkers
+//
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<std::vector<size_t>> AssignContextsToWorkers (size_t contextCount, int renderWorkers)
+{
+    size_t                           workers = std::min (contextCount, static_cast<size_t> (std::max (renderWorkers, 1)));
+    std::vector<std::vector<size_t>> assignment (workers);
+
+
+
+    for (size_t context = 0; context < contextCount; context++)
+    {
+        assignment[context % workers].push_back (context);
+    }
+
+    return assignment;
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SharedRenderWorker::SharedRenderWorker
+//
+////////////////////////////////////////////////////////////////////////////////
+
+SharedRenderWorker::SharedRenderWorker (std::vector<ScheduledRenderTarget> targets,
+                                        RenderWakeSignal                 & wake,
+                                        std::atomic<bool>                * inTransition) :
+    m_targets      (std::move (targets)),
+    m_wake         (wake),
+    m_inTransition (inTransition)
+{
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SharedRenderWorker::~SharedRenderWorker
+//
+////////////////////////////////////////////////////////////////////////////////
+
+SharedRenderWorker::~SharedRenderWorker()
+{
+    RequestStop();
+    Join();
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SharedRenderWorker::Start
+//
+//  Every target's first deadline is now; the grids settle onto the real
+//  vblanks as targets report them.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void SharedRenderWorker::Start()
+{
+    Clock::time_point now = Clock::now();
+
+
+
+    for (const ScheduledRenderTarget & target : m_targets)
+    {
+        m_scheduler.AddDisplay (target.period, now);
+    }
+
+    m_shouldStop = false;
+    m_thread     = std::thread (&SharedRenderWorker::ThreadProc, this);
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SharedRenderWorker::RequestStop
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void SharedRenderWorker::RequestStop()
+{
+    m_shouldStop = true;
+    m_wake.Notify();
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SharedRenderWorker::Join
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void SharedRenderWorker::Join()
+{
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SharedRenderWorker::ThreadProc
+//
+//  As in MonitorRenderContext::RenderThreadProc, the wake generation is
+//  read before the transition flag and the deadline wait, so a Notify
+//  landing in between ends the wait at once.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void SharedRenderWorker::ThreadProc()
+{
+    FrameTrace::SetThreadName (std::format ("Render worker ({} monitors)", m_targets.size()));
+
+    while (!m_shouldStop)
+    {
+        uint64_t generation = m_wake.GetGeneration();
+        bool     woken      = false;
+
+        if (m_inTransition && m_inTransition->load())
+        {
+            m_wake.Wait (generation);
+            m_scheduler.Expedite (Clock::now());
+            continue;
+        }
+
+        size_t            next     = m_scheduler.GetNext();
+        Clock::time_point deadline;
+        bool              early    = false;
+
+        if (next == VBlankScheduler::s_kNone)
+        {
+            // Every target has lost its device; the UI thread rebuilds them
+            break;
+        }
+
+        deadline = m_scheduler.GetDeadline (next);
+        early    = Clock::now() < deadline;
+
+        {
+            TraceZone zone ("DeadlineWait");
+
+            woken = m_wake.WaitUntil (generation, deadline);
+        }
+
+        // Something changed while waiting: parked targets may have something
+        // new to draw, so bring them back and pick again
+        if (woken)
+        {
+            m_scheduler.Expedite (Clock::now());
+            continue;
+        }
+
+        // A deadline already past when the wait began is the worker running
+        // behind, not the wait waking late
+        Clock::time_point now = Clock::now();
+
+        if (early)
+        {
+            m_wakeLateness.Record (ToMicroseconds (now - deadline));
+        }
+
+        RenderStep step = m_targets[next].renderFrame (now);
+
+        if (!step.keepRunning)
+        {
+            m_scheduler.Retire (next);
+            continue;
+        }
+
+        if (step.vblank)
+        {
+            m_scheduler.Resync (next, *step.vblank);
+        }
+
+        m_scheduler.Complete (next, Clock::now());
+
+        if (step.idleUntil)
+        {
+            m_scheduler.DeferUntil (next, *step.idleUntil);
+        }
+    }
+}
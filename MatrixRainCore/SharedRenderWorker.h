@@ -0,0 +1,132 @@
+#pragma once
+
+#include "RenderWakeSignal.h"
+#include "TimingHistogram.h"
+#include "VBlankScheduler.h"
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  RenderThreadModel — How render threads map onto monitors
+//
+//  PerMonitor    One thread per MonitorRenderContext, each paced by its
+//                own Present/VBlank.  The default.
+//
+//  SharedWorker  A few workers (ScreenSaverSettings::m_renderWorkers) each
+//                drive several contexts in earliest-vblank-first order.
+//                For machines with many displays and few cores, where N
+//                threads blocking on N VBlanks contend for the CPU and
+//                wake at staggered times.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+enum class RenderThreadModel
+{
+    PerMonitor,
+    SharedWorker
+};
+
+
+RenderThreadModel RenderThreadModelForWorkerCount (int renderWorkers);
+
+
+// Splits `contextCount` contexts across at most `renderWorkers` workers,
+// round-robin by index.  Never creates an empty worker.
+std::vector<std::vector<size_t>> AssignContextsToWorkers (size_t contextCount, int renderWorkers);
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  RenderStep — What one frame of a render target reports back
+//
+////////////////////////////////////////////////////////////////////////////////
+
+struct RenderStep
+{
+    using Clock = FrameClock;
+
+    bool                             keepRunning { true };  // false: device lost; stop driving this target
+    std::optional<Clock::time_point> idleUntil;             // paused low-power mode: nothing to draw before this
+    std::optional<Clock::time_point> vblank;                // a vblank observed on the display, to re-anchor its grid
+};
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  ScheduledRenderTarget — One display as seen by a SharedRenderWorker
+//
+//  `period` is the interval between the frames the worker owes the
+//  display: its refresh period, or a longer one when the display's frame
+//  rate is capped.  `renderFrame` simulates, renders and presents one
+//  frame, and must not block waiting for a VBlank: the worker has already
+//  waited for the deadline, so the display's previous flip has retired
+//  and Present only queues the next one.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+struct ScheduledRenderTarget
+{
+    VBlankScheduler::Clock::duration                                    period;
+    std::function<RenderStep (VBlankScheduler::Clock::time_point now)> renderFrame;
+};
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SharedRenderWorker — One thread driving several displays round-robin
+//
+//  Waits for the soonest vblank deadline among its targets (VBlankScheduler),
+//  renders that target's frame, and reschedules it.  Everything else
+//  mirrors the per-monitor render thread: while a display-mode transition
+//  is in progress it blocks on the wake signal, targets in paused
+//  low-power mode are parked until their next redraw, and any Notify
+//  (a stop request, a state change) ends the current wait and brings
+//  parked targets back at once.
+//
+//  Deadline waits go through RenderWakeSignal::WaitUntil, which blocks on
+//  a high-resolution timer, so the worker wakes within a fraction of a
+//  millisecond of each deadline rather than on the next 15.6 ms Windows
+//  timer tick.  GetWakeLateness records, in microseconds, how late each
+//  wait that began before its deadline and reached it returned.
+//
+//  The scheduler and histogram are owned by the worker thread; read
+//  GetScheduler and GetWakeLateness only after Join.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class SharedRenderWorker
+{
+public:
+    using Clock = VBlankScheduler::Clock;
+
+    SharedRenderWorker (std::vector<ScheduledRenderTarget> targets,
+                        RenderWakeSignal                 & wake,
+                        std::atomic<bool>                * inTransition = nullptr);
+    ~SharedRenderWorker();
+
+    void Start();
+    void RequestStop();
+    void Join();
+
+    const VBlankScheduler & GetScheduler()    const { return m_scheduler;    }
+    const TimingHistogram & GetWakeLateness() const { return m_wakeLateness; }
+
+private:
+    void ThreadProc();
+
+    std::vector<ScheduledRenderTarget> m_targets;
+    VBlankScheduler                    m_scheduler;
+    TimingHistogram                    m_wakeLateness;
+    RenderWakeSignal                 & m_wake;
+    std::atomic<bool>                * m_inTransition;
+    std::atomic<bool>                  m_shouldStop { false };
+    std::thread                        m_thread;
+};
@@ -2,7 +2,9 @@
 
 #include "ColorScheme.h"
 #include "QualityPresets.h"
+#include "RenderWakeSignal.h"
 #include "ScreenSaverSettings.h"
+#include "SeqLock.h"
 
 
 
@@ -13,28 +15,35 @@
 //  SharedState — Thread-safe shared state between UI and render threads
 //
 //  All fields in this struct are written by the UI thread (hotkeys, config
-//  dialog) and read by the render thread (Update/Render).  Access must be
-//  protected by the embedded mutex.
+//  dialog) and read by the render threads (Update/Render).  Writers are
+//  serialized by the embedded mutex and publish a new versioned snapshot
+//  when their WriteLock goes out of scope; readers copy the latest
+//  snapshot through a seqlock and never block, so N render threads cost
+//  the UI thread nothing and each other nothing.
 //
 //  UI thread pattern:
 //      {
-//          std::lock_guard<std::mutex> lock (m_sharedState.mutex);
+//          SharedState::WriteLock lock (m_sharedState);
 //          m_sharedState.colorScheme = newScheme;
 //      }
 //
-//  Render thread pattern (snapshot to minimize lock hold time):
-//      SharedState::Snapshot snapshot;
-//      {
-//          std::lock_guard<std::mutex> lock (m_sharedState.mutex);
-//          snapshot = m_sharedState.GetSnapshot();
-//      }
+//  Render thread pattern:
+//      SharedState::Snapshot snapshot = m_sharedState.GetSnapshot();
 //      Update (snapshot, deltaTime);
 //      Render (snapshot);
 //
+//  elapsedTime and the live* fields change every frame or from the dialog
+//  thread without a WriteLock; they are atomics merged into each snapshot.
+//
+//  Every Publish also notifies `wake`, so a render thread idling in paused
+//  low-power mode redraws as soon as anything it displays changes.  Writers
+//  of the live* atomics notify it themselves.
+//
 ////////////////////////////////////////////////////////////////////////////////
 
 struct SharedState
 {
+    // Serializes writers (see WriteLock); readers never take it
     mutable std::mutex mutex;
 
 
@@ -57,6 +66,11 @@ struct SharedState
     int               blurPasses             = 3;
     ResolutionDivisor bloomResolutionDivisor = ResolutionDivisor::Half;
     BlurTaps          blurTaps               = BlurTaps::High;
+    BloomAlgorithm    bloomAlgorithm         = BloomAlgorithm::Gaussian;
+
+    // Per-frame cost the render threads' QualityGovernor holds quality
+    // under, in microseconds; 0 = adaptive quality off
+    int               qualityTargetFrameUs   = 0;
 
     // Debug/statistics display
     bool        showStatistics        = false;
@@ -68,8 +82,8 @@ struct SharedState
 
     // Monotonic seconds since start, used to cycle colors.  Advanced by the
     // owning (primary) render thread and read by every monitor so all displays
-    // cycle color in sync.
-    float       elapsedTime           = 0.0f;
+    // cycle color in sync.  Stored once per frame, so it bypasses the mutex.
+    std::atomic<float>    elapsedTime            { 0.0f };
 
     // v1.5 live fields (data-model.md §4, FR-044): dialog thread writes,
     // render thread reads.  Atomics are lock-free on all supported archs.
@@ -88,6 +102,10 @@ struct SharedState
     int       snapshotScanlinesStyle     { ScreenSaverSettings::DEFAULT_SCANLINES_STYLE             };
     DWORD     snapshotCustomColor        { static_cast<DWORD> (ScreenSaverSettings::DEFAULT_CUSTOM_COLOR) };
 
+    // Wakes idle render threads: published changes, stop requests, the end
+    // of a display-mode transition, overlay commands
+    RenderWakeSignal wake;
+
 
     ////////////////////////////////////////////////////////////////////////////
     //
@@ -105,12 +123,14 @@ struct SharedState
         int               blurPasses             = 3;
         ResolutionDivisor bloomResolutionDivisor = ResolutionDivisor::Half;
         BlurTaps           blurTaps              = BlurTaps::High;
+        BloomAlgorithm    bloomAlgorithm         = BloomAlgorithm::Gaussian;
+        int               qualityTargetFrameUs   = 0;
         bool              showStatistics         = false;
         bool              isPaused               = false;
         float             elapsedTime            = 0.0f;
 
         // v1.5 (data-model.md §4): lock-free snapshot of the live atomics
-        // copied once per frame by the render thread under m_sharedState.mutex.
+        // copied once per frame by the render thread.
         bool              glowEnabled            = true;
         bool              scanlinesEnabled       = true;
         int               scanlinesIntensity     = ScreenSaverSettings::DEFAULT_SCANLINES_INTENSITY_PERCENT;
@@ -119,10 +139,32 @@ struct SharedState
     };
 
 
-    // Must be called while holding the mutex
-    Snapshot GetSnapshot () const
+    ////////////////////////////////////////////////////////////////////////////
+    //
+    //  WriteLock — holds the writer mutex and publishes on release
+    //
+    ////////////////////////////////////////////////////////////////////////////
+
+    class WriteLock
+    {
+    public:
+        explicit WriteLock (SharedState & state) : m_state (state), m_lock (state.mutex) { }
+        ~WriteLock() { m_state.Publish(); }
+
+        WriteLock (const WriteLock &)             = delete;
+        WriteLock & operator= (const WriteLock &) = delete;
+
+    private:
+        SharedState                 & m_state;
+        std::lock_guard<std::mutex>   m_lock;
+    };
+
+
+    // Copies the mutex-protected fields into a new published version.
+    // Must be called while holding the mutex (WriteLock does).
+    void Publish ()
     {
-        return Snapshot
+        m_published.Store (Snapshot
         {
             .densityPercent         = densityPercent,
             .colorScheme            = colorScheme,
@@ -132,14 +174,39 @@ struct SharedState
             .blurPasses             = blurPasses,
             .bloomResolutionDivisor = bloomResolutionDivisor,
             .blurTaps               = blurTaps,
+            .bloomAlgorithm         = bloomAlgorithm,
+            .qualityTargetFrameUs   = qualityTargetFrameUs,
             .showStatistics         = showStatistics,
             .isPaused               = isPaused,
-            .elapsedTime            = elapsedTime,
-            .glowEnabled            = liveGlowEnabled       .load (std::memory_order_relaxed),
-            .scanlinesEnabled       = liveScanlinesEnabled  .load (std::memory_order_relaxed),
-            .scanlinesIntensity     = liveScanlinesIntensity.load (std::memory_order_relaxed),
-            .scanlinesStyle         = liveScanlinesStyle    .load (std::memory_order_relaxed),
-            .customColor            = liveCustomColor       .load (std::memory_order_relaxed),
-        };
+        });
+
+        wake.Notify();
+    }
+
+
+    // Lock-free; safe from any thread
+    Snapshot GetSnapshot () const
+    {
+        Snapshot snapshot = m_published.Load();
+
+        snapshot.elapsedTime        = elapsedTime           .load (std::memory_order_relaxed);
+        snapshot.glowEnabled        = liveGlowEnabled       .load (std::memory_order_relaxed);
+        snapshot.scanlinesEnabled   = liveScanlinesEnabled  .load (std::memory_order_relaxed);
+        snapshot.scanlinesIntensity = liveScanlinesIntensity.load (std::memory_order_relaxed);
+        snapshot.scanlinesStyle     = liveScanlinesStyle    .load (std::memory_order_relaxed);
+        snapshot.customColor        = liveCustomColor       .load (std::memory_order_relaxed);
+
+        return snapshot;
+    }
+
+
+    // Advances by two per Publish
+    uint64_t GetVersion () const
+    {
+        return m_published.Version();
     }
+
+
+private:
+    SeqLock<Snapshot> m_published;
 };
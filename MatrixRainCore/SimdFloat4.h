@@ -0,0 +1,276 @@
+#pragma once
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SimdFloat4
+//
+//  Minimal four-lane float vector used by the software renderer to process
+//  one RGBA pixel per operation.  SSE2 on x64 (always available), NEON on
+//  ARM64, plain floats elsewhere.  All three backends round identically
+//  (truncate after +0.5) so software output does not depend on the CPU.
+//
+//  RGBA8 pixels are packed R in the low byte, matching the memory order of
+//  DXGI_FORMAT_R8G8B8A8_UNORM used by the GPU scene texture.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#if defined(_M_ARM64) || defined(__aarch64__)
+    #define MATRIXRAIN_SIMD_NEON 1
+#elif defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__)
+    #define MATRIXRAIN_SIMD_SSE2 1
+#else
+    #define MATRIXRAIN_SIMD_SCALAR 1
+#endif
+
+
+
+
+
+struct SimdFloat4
+{
+#if defined(MATRIXRAIN_SIMD_SSE2)
+    __m128      v;
+#elif defined(MATRIXRAIN_SIMD_NEON)
+    float32x4_t v;
+#else
+    float       v[4];
+#endif
+};
+
+
+
+
+
+inline SimdFloat4 SimdSplat (float f)
+{
+#if defined(MATRIXRAIN_SIMD_SSE2)
+    return { _mm_set1_ps (f) };
+#elif defined(MATRIXRAIN_SIMD_NEON)
+    return { vdupq_n_f32 (f) };
+#else
+    return { { f, f, f, f } };
+#endif
+}
+
+
+
+
+
+inline SimdFloat4 SimdSet (float r, float g, float b, float a)
+{
+#if defined(MATRIXRAIN_SIMD_SSE2)
+    return { _mm_setr_ps (r, g, b, a) };
+#elif defined(MATRIXRAIN_SIMD_NEON)
+    float lanes[4] = { r, g, b, a };
+
+    return { vld1q_f32 (lanes) };
+#else
+    return { { r, g, b, a } };
+#endif
+}
+
+
+
+
+
+// Unaligned load / store of four consecutive floats
+inline SimdFloat4 SimdLoad (const float * p)
+{
+#if defined(MATRIXRAIN_SIMD_SSE2)
+    return { _mm_loadu_ps (p) };
+#elif defined(MATRIXRAIN_SIMD_NEON)
+    return { vld1q_f32 (p) };
+#else
+    return { { p[0], p[1], p[2], p[3] } };
+#endif
+}
+
+
+
+
+
+inline void SimdStore (float * p, SimdFloat4 a)
+{
+#if defined(MATRIXRAIN_SIMD_SSE2)
+    _mm_storeu_ps (p, a.v);
+#elif defined(MATRIXRAIN_SIMD_NEON)
+    vst1q_f32 (p, a.v);
+#else
+    p[0] = a.v[0];
+    p[1] = a.v[1];
+    p[2] = a.v[2];
+    p[3] = a.v[3];
+#endif
+}
+
+
+
+
+
+inline SimdFloat4 SimdAdd (SimdFloat4 a, SimdFloat4 b)
+{
+#if defined(MATRIXRAIN_SIMD_SSE2)
+    return { _mm_add_ps (a.v, b.v) };
+#elif defined(MATRIXRAIN_SIMD_NEON)
+    return { vaddq_f32 (a.v, b.v) };
+#else
+    return { { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] } };
+#endif
+}
+
+
+
+
+
+inline SimdFloat4 SimdSub (SimdFloat4 a, SimdFloat4 b)
+{
+#if defined(MATRIXRAIN_SIMD_SSE2)
+    return { _mm_sub_ps (a.v, b.v) };
+#elif defined(MATRIXRAIN_SIMD_NEON)
+    return { vsubq_f32 (a.v, b.v) };
+#else
+    return { { a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3] } };
+#endif
+}
+
+
+
+
+
+inline SimdFloat4 SimdMul (SimdFloat4 a, SimdFloat4 b)
+{
+#if defined(MATRIXRAIN_SIMD_SSE2)
+    return { _mm_mul_ps (a.v, b.v) };
+#elif defined(MATRIXRAIN_SIMD_NEON)
+    return { vmulq_f32 (a.v, b.v) };
+#else
+    return { { a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3] } };
+#endif
+}
+
+
+
+
+
+inline SimdFloat4 SimdMin (SimdFloat4 a, SimdFloat4 b)
+{
+#if defined(MATRIXRAIN_SIMD_SSE2)
+    return { _mm_min_ps (a.v, b.v) };
+#elif defined(MATRIXRAIN_SIMD_NEON)
+    return { vminq_f32 (a.v, b.v) };
+#else
+    return { { std::min (a.v[0], b.v[0]), std::min (a.v[1], b.v[1]), std::min (a.v[2], b.v[2]), std::min (a.v[3], b.v[3]) } };
+#endif
+}
+
+
+
+
+
+inline SimdFloat4 SimdMax (SimdFloat4 a, SimdFloat4 b)
+{
+#if defined(MATRIXRAIN_SIMD_SSE2)
+    return { _mm_max_ps (a.v, b.v) };
+#elif defined(MATRIXRAIN_SIMD_NEON)
+    return { vmaxq_f32 (a.v, b.v) };
+#else
+    return { { std::max (a.v[0], b.v[0]), std::max (a.v[1], b.v[1]), std::max (a.v[2], b.v[2]), std::max (a.v[3], b.v[3]) } };
+#endif
+}
+
+
+
+
+
+inline SimdFloat4 SimdSaturate (SimdFloat4 a)
+{
+    return SimdMin (SimdMax (a, SimdSplat (0.0f)), SimdSplat (1.0f));
+}
+
+
+
+
+
+inline float SimdLane (SimdFloat4 a, int lane)
+{
+#if defined(MATRIXRAIN_SIMD_SSE2)
+    alignas(16) float lanes[4];
+
+    _mm_store_ps (lanes, a.v);
+    return lanes[lane];
+#elif defined(MATRIXRAIN_SIMD_NEON)
+    float lanes[4];
+
+    vst1q_f32 (lanes, a.v);
+    return lanes[lane];
+#else
+    return a.v[lane];
+#endif
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SimdUnpackRgba8 / SimdPackRgba8
+//
+//  UNORM8 <-> [0,1] float conversion for one packed RGBA pixel.  Packing
+//  saturates first, like an R8G8B8A8_UNORM render target write.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+inline SimdFloat4 SimdUnpackRgba8 (uint32_t pixel)
+{
+#if defined(MATRIXRAIN_SIMD_SSE2)
+    __m128i zero  = _mm_setzero_si128();
+    __m128i bytes = _mm_cvtsi32_si128 (static_cast<int> (pixel));
+    __m128i words = _mm_unpacklo_epi8 (bytes, zero);
+    __m128i dw    = _mm_unpacklo_epi16 (words, zero);
+
+    return { _mm_mul_ps (_mm_cvtepi32_ps (dw), _mm_set1_ps (1.0f / 255.0f)) };
+#elif defined(MATRIXRAIN_SIMD_NEON)
+    uint8x8_t  bytes = vreinterpret_u8_u32 (vdup_n_u32 (pixel));
+    uint16x8_t words = vmovl_u8 (bytes);
+    uint32x4_t dw    = vmovl_u16 (vget_low_u16 (words));
+
+    return { vmulq_n_f32 (vcvtq_f32_u32 (dw), 1.0f / 255.0f) };
+#else
+    return { { static_cast<float> ( pixel        & 0xFF) * (1.0f / 255.0f),
+               static_cast<float> ((pixel >>  8) & 0xFF) * (1.0f / 255.0f),
+               static_cast<float> ((pixel >> 16) & 0xFF) * (1.0f / 255.0f),
+               static_cast<float> ((pixel >> 24) & 0xFF) * (1.0f / 255.0f) } };
+#endif
+}
+
+
+
+
+
+inline uint32_t SimdPackRgba8 (SimdFloat4 color)
+{
+    SimdFloat4 scaled = SimdAdd (SimdMul (SimdSaturate (color), SimdSplat (255.0f)), SimdSplat (0.5f));
+
+#if defined(MATRIXRAIN_SIMD_SSE2)
+    __m128i dw    = _mm_cvttps_epi32 (scaled.v);
+    __m128i words = _mm_packs_epi32 (dw, dw);
+    __m128i bytes = _mm_packus_epi16 (words, words);
+
+    return static_cast<uint32_t> (_mm_cvtsi128_si32 (bytes));
+#elif defined(MATRIXRAIN_SIMD_NEON)
+    uint32x4_t dw    = vcvtq_u32_f32 (scaled.v);
+    uint16x4_t words = vmovn_u32 (dw);
+    uint8x8_t  bytes = vmovn_u16 (vcombine_u16 (words, words));
+
+    return vget_lane_u32 (vreinterpret_u32_u8 (bytes), 0);
+#else
+    return  static_cast<uint32_t> (scaled.v[0])
+         | (static_cast<uint32_t> (scaled.v[1]) << 8)
+         | (static_cast<uint32_t> (scaled.v[2]) << 16)
+         | (static_cast<uint32_t> (scaled.v[3]) << 24);
+#endif
+}
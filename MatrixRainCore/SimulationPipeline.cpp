@@ -0,0 +1,239 @@
+#include "pch.h"
+
+#include "SimulationPipeline.h"
+
+#include "AnimationSystem.h"
+#include "DensityController.h"
+#include "FrameLimiter.h"
+#include "FrameTrace.h"
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SimulationPipeline::SimulationPipeline
+//
+////////////////////////////////////////////////////////////////////////////////
+
+SimulationPipeline::SimulationPipeline (AnimationSystem & animation, DensityController & density, int monitorIndex) :
+    m_animation    (animation),
+    m_density      (density),
+    m_monitorIndex (monitorIndex)
+{
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SimulationPipeline::~SimulationPipeline
+//
+////////////////////////////////////////////////////////////////////////////////
+
+SimulationPipeline::~SimulationPipeline()
+{
+    RequestStop();
+    Join();
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SimulationPipeline::Start
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void SimulationPipeline::Start (SharedState & sharedState, std::atomic<bool> * inTransition, unsigned stepRate)
+{
+    m_sharedState  = &sharedState;
+    m_inTransition = inTransition;
+    m_stepRate     = stepRate ? stepRate : 60;
+    m_shouldStop   = false;
+
+    m_thread = std::thread (&SimulationPipeline::ThreadProc, this);
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SimulationPipeline::RequestStop
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void SimulationPipeline::RequestStop()
+{
+    m_shouldStop = true;
+
+    if (m_sharedState)
+    {
+        m_sharedState->wake.Notify();
+    }
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SimulationPipeline::Join
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void SimulationPipeline::Join()
+{
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SimulationPipeline::Step
+//
+//  Copy-assigning into the back slot reuses the streak storage it held
+//  the last time round, so publishing allocates nothing once warm.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void SimulationPipeline::Step (float deltaTime, int densityPercent, int animationSpeedPercent)
+{
+    TraceZone                   zone ("SimulationStep", m_monitorIndex);
+    std::lock_guard<std::mutex> lock (m_mutex);
+
+    SimulationFrame & frame = m_mailbox.Back();
+
+
+
+    m_density.SetPercentage       (densityPercent);
+    m_animation.SetAnimationSpeed (animationSpeedPercent);
+    m_animation.Update            (deltaTime);
+
+    frame.streaks = m_animation.GetStreaks();
+    frame.stamp   = SimulationFrameStamp
+                    {
+                        .sequence         = ++m_sequence,
+                        .layoutGeneration = m_layoutGeneration.load (std::memory_order_relaxed),
+                    };
+
+    m_mailbox.Publish();
+    m_stepCount.fetch_add (1, std::memory_order_relaxed);
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SimulationPipeline::AdoptNewestFrame
+//
+//  Swapping hands the frame's streaks to `presented` and the ones it drew
+//  last back to the slot, which the simulation overwrites in place.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+std::optional<SimulationFrameStamp> SimulationPipeline::AdoptNewestFrame (AnimationSystem & presented)
+{
+    if (!m_mailbox.Acquire())
+    {
+        return std::nullopt;
+    }
+
+    SimulationFrame & frame = m_mailbox.Front();
+
+    if (frame.stamp.layoutGeneration != m_layoutGeneration.load (std::memory_order_acquire))
+    {
+        return std::nullopt;
+    }
+
+    presented.SwapStreaks (frame.streaks);
+
+    return frame.stamp;
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SimulationPipeline::InvalidateLayout
+//
+//  The caller holds m_mutex, so no step is in flight: every frame stamped
+//  with the old generation was published before this, and is dropped.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void SimulationPipeline::InvalidateLayout()
+{
+    m_layoutGeneration.fetch_add (1, std::memory_order_acq_rel);
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SimulationPipeline::ThreadProc
+//
+//  Steps sit on an absolute schedule (FrameLimiter, precision pacing), so
+//  the cadence does not depend on how long the render thread's frames or
+//  presents take.  The wake generation is read before the stop flag and
+//  the snapshot, so a Notify that lands in between ends the next wait
+//  immediately.  Time spent waiting is not simulated: the first step
+//  after a pause or a transition advances by one step period.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void SimulationPipeline::ThreadProc()
+{
+    FrameLimiter           limiter        (m_stepRate, FramePacingMode::Precision);
+    FrameClock::duration   period         = PeriodForRate (m_stepRate);
+    FrameClock::time_point lastStep       = FrameClock::now() - period;
+    uint64_t               wakeGeneration = 0;
+
+
+
+    FrameTrace::SetThreadName (std::format ("Simulation (monitor {})", m_monitorIndex));
+
+    for (;;)
+    {
+        wakeGeneration = m_sharedState->wake.GetGeneration();
+
+        if (m_shouldStop)
+        {
+            break;
+        }
+
+        SharedState::Snapshot snapshot = m_sharedState->GetSnapshot();
+
+        if (snapshot.isPaused || (m_inTransition && m_inTransition->load()))
+        {
+            m_sharedState->wake.Wait (wakeGeneration);
+            lastStep = FrameClock::now() - period;
+            continue;
+        }
+
+        {
+            TraceZone zone ("StepWait", m_monitorIndex);
+
+            limiter.WaitForNextFrame();
+        }
+
+        FrameClock::time_point now            = FrameClock::now();
+        float                  deltaTime      = std::min (static_cast<float> (ToSeconds (now - lastStep)), 0.1f);
+        int                    densityPercent = m_densityPercent.load (std::memory_order_relaxed);
+
+        lastStep = now;
+
+        Step (deltaTime, densityPercent >= 0 ? densityPercent : snapshot.densityPercent, snapshot.animationSpeedPercent);
+    }
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "CharacterStreak.h"
+#include "FrameClock.h"
+#include "FrameMailbox.h"
+#include "SharedState.h"
+
+
+
+
+class AnimationSystem;
+class DensityController;
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SimulationFrame — One simulation step, as handed to the render thread
+//
+////////////////////////////////////////////////////////////////////////////////
+
+struct SimulationFrameStamp
+{
+    uint64_t sequence         { 0 };    // 1 for the first frame published
+    uint64_t layoutGeneration { 0 };    // SimulationPipeline::InvalidateLayout count it was simulated under
+};
+
+
+struct SimulationFrame
+{
+    std::vector<CharacterStreak> streaks;
+    SimulationFrameStamp         stamp;
+};
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SimulationPipeline — A monitor's simulation on its own thread
+//
+//  Normally a MonitorRenderContext simulates and renders on one thread, so
+//  a Present that blocks on the VBlank (or on a busy GPU) holds back the
+//  next simulation step with it.  With ScreenSaverSettings::m_simulationThread
+//  set, this thread steps the context's AnimationSystem at the display's
+//  rate instead and publishes each step into a FrameMailbox.  The render
+//  thread adopts the newest completed step whenever it starts a frame and
+//  never waits for the simulation, nor the simulation for it.
+//
+//  The simulation thread owns the AnimationSystem and DensityController
+//  it was given.  Anything else that touches them while it runs (Resize,
+//  OnDpiChanged) holds GetMutex(), and calls InvalidateLayout if the
+//  change moves streaks: frames simulated before it are then dropped
+//  rather than shown in the new layout.
+//
+//  Like the render thread, it blocks on SharedState::wake while paused or
+//  during a display-mode transition.  RequestStop ends any wait at once,
+//  and a running thread finishes within one step period, so Join always
+//  returns promptly.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class SimulationPipeline
+{
+public:
+    // `monitorIndex` identifies the monitor in frame traces
+    SimulationPipeline (AnimationSystem & animation, DensityController & density, int monitorIndex = 0);
+    ~SimulationPipeline();
+
+    // `stepRate` steps per second, normally the display's refresh rate
+    void Start       (SharedState & sharedState, std::atomic<bool> * inTransition, unsigned stepRate);
+    void RequestStop ();
+    void Join        ();
+
+    // Simulating thread (or, before Start, any one thread): one step,
+    // published.  Takes GetMutex.
+    void Step (float deltaTime, int densityPercent, int animationSpeedPercent);
+
+    // Render thread: moves the newest frame's streaks into `presented` if
+    // one has been published since the last call and was simulated under
+    // the current layout.  Returns its stamp, or nullopt if nothing was
+    // adopted (keep drawing what `presented` holds).
+    std::optional<SimulationFrameStamp> AdoptNewestFrame (AnimationSystem & presented);
+
+    // Render thread: density for the next steps (the quality governor's
+    // level), or -1 to follow SharedState's
+    void SetDensityPercent (int densityPercent) { m_densityPercent.store (densityPercent, std::memory_order_relaxed); }
+
+    // UI thread, holding GetMutex
+    std::mutex & GetMutex() { return m_mutex; }
+    void         InvalidateLayout();
+
+    uint64_t GetStepCount()        const { return m_stepCount.load (std::memory_order_relaxed);        }
+    uint64_t GetLayoutGeneration() const { return m_layoutGeneration.load (std::memory_order_acquire); }
+
+private:
+    void ThreadProc();
+
+    AnimationSystem              & m_animation;
+    DensityController            & m_density;
+    int                            m_monitorIndex;
+    FrameMailbox<SimulationFrame>  m_mailbox;
+
+    std::mutex                     m_mutex;
+    std::thread                    m_thread;
+    std::atomic<bool>              m_shouldStop       { false };
+    SharedState                  * m_sharedState      { nullptr };
+    std::atomic<bool>            * m_inTransition     { nullptr };
+    unsigned                       m_stepRate         { 60 };
+
+    uint64_t                       m_sequence         { 0 };        // Simulating thread only
+    std::atomic<uint64_t>          m_stepCount        { 0 };
+    std::atomic<uint64_t>          m_layoutGeneration { 0 };
+    std::atomic<int>               m_densityPercent   { -1 };
+};
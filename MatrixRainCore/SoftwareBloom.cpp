@@ -0,0 +1,984 @@
+#include "pch.h"
+
+#include "SoftwareBloom.h"
+#include "FrameClock.h"
+#include "SimdFloat4.h"
+
+
+
+
+
+// Same tables as the blur pixel shaders in RenderSystem.cpp
+static constexpr float s_kBlurWeights5[5]   = { 0.10f, 0.24f, 0.32f, 0.24f, 0.10f };
+static constexpr float s_kBlurWeights9[9]   = { 0.05f, 0.09f, 0.12f, 0.15f, 0.18f, 0.15f, 0.12f, 0.09f, 0.05f };
+static constexpr float s_kBlurWeights13[13] = { 0.02f, 0.04f, 0.06f, 0.08f, 0.10f, 0.12f, 0.16f, 0.12f, 0.10f, 0.08f, 0.06f, 0.04f, 0.02f };
+
+// Intervals in the soft-bloom table; linear interpolation between entries
+// keeps the error far below one UNORM step for any intensity the UI allows
+static constexpr int   s_kSoftBloomLutSize  = 1024;
+
+// Iterated box: three boxes per axis get within a few percent of a
+// Gaussian; strips keep each vertical sweep's running sums in cache
+static constexpr int   s_kBoxPasses         = 3;
+static constexpr UINT  s_kBoxStripWidth     = 64;
+
+// Dual filter upsample tent: axis taps weigh 1 and diagonal taps 2, of 12
+static constexpr float s_kTentAxisWeight     = 1.0f / 12.0f;
+static constexpr float s_kTentDiagonalWeight = 2.0f / 12.0f;
+
+// Extract: smoothstep(threshold, threshold + 0.5, brightness)
+static constexpr float s_kExtractThreshold  = 0.1f;
+static constexpr float s_kExtractRamp       = 0.5f;
+
+
+
+
+
+static double MillisecondsSince (uint64_t startTicks)
+{
+    return ToMilliseconds (ElapsedSince (startTicks));
+}
+
+
+
+
+
+static SimdFloat4 Lerp (SimdFloat4 a, SimdFloat4 b, float t)
+{
+    return SimdAdd (a, SimdMul (SimdSub (b, a), SimdSplat (t)));
+}
+
+
+
+
+
+template <typename Tap>
+static SimdFloat4 SampleBilinear (const SoftwareSurface & texture, const Tap & column, const Tap & row)
+{
+    const uint32_t * rowA   = texture.Row (static_cast<UINT> (row.index0));
+    const uint32_t * rowB   = texture.Row (static_cast<UINT> (row.index1));
+    SimdFloat4       top    = Lerp (SimdUnpackRgba8 (rowA[column.index0]), SimdUnpackRgba8 (rowA[column.index1]), column.weight1);
+    SimdFloat4       bottom = Lerp (SimdUnpackRgba8 (rowB[column.index0]), SimdUnpackRgba8 (rowB[column.index1]), column.weight1);
+
+    return Lerp (top, bottom, row.weight1);
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SoftwareBloom::Apply
+//
+//  Runs the whole chain and records per-stage wall time.  The bloom
+//  buffers are resized (not reallocated) when the scene size or divisor
+//  changes.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void SoftwareBloom::Apply (WorkerPool & pool, const SoftwareSurface & scene, SoftwareSurface & output, const SoftwareBloomSettings & settings)
+{
+    int    divisor     = std::clamp (static_cast<int> (settings.resolutionDivisor), 1, 8);
+    UINT   bloomWidth  = std::max (1u, scene.GetWidth()  / static_cast<UINT> (divisor));
+    UINT   bloomHeight = std::max (1u, scene.GetHeight() / static_cast<UINT> (divisor));
+    int    passCount   = std::clamp (settings.blurPasses, 1, 4);
+    auto   start       = Timestamp::Read();
+
+
+
+    if (m_bloom.GetWidth() != bloomWidth || m_bloom.GetHeight() != bloomHeight)
+    {
+        m_bloom.Resize    (bloomWidth, bloomHeight);
+        m_blurTemp.Resize (bloomWidth, bloomHeight);
+    }
+
+    if (output.GetWidth() != scene.GetWidth() || output.GetHeight() != scene.GetHeight())
+    {
+        output.Resize (scene.GetWidth(), scene.GetHeight());
+    }
+
+    if (m_scratch.size() < pool.GetThreadCount())
+    {
+        m_scratch.resize (pool.GetThreadCount());
+    }
+
+    BuildSampleTaps (bloomWidth,        scene.GetWidth(),  m_extractColumns);
+    BuildSampleTaps (bloomHeight,       scene.GetHeight(), m_extractRows);
+    BuildSampleTaps (scene.GetWidth(),  bloomWidth,        m_compositeColumns);
+    BuildSampleTaps (scene.GetHeight(), bloomHeight,       m_compositeRows);
+    BuildKernel (settings.blurTaps, settings.glowSize);
+    BuildSoftBloomLut (settings.intensity);
+
+    Extract (pool, scene);
+    m_lastTimings.extractMs = MillisecondsSince (start);
+
+    start = Timestamp::Read();
+
+    if (settings.algorithm == BloomAlgorithm::DualFilter)
+    {
+        BlurDualFilter (pool, DualFilterLevelCount (passCount), settings.glowSize);
+    }
+    else if (settings.glowKernel == GlowKernel::IteratedBox)
+    {
+        BuildBoxKernel (passCount);
+        BlurIteratedBox (pool);
+    }
+    else
+    {
+        for (int pass = 0; pass < passCount; pass++)
+        {
+            BlurHorizontal (pool, m_bloom,    m_blurTemp);
+            BlurVertical   (pool, m_blurTemp, m_bloom);
+        }
+    }
+
+    m_lastTimings.blurMs = MillisecondsSince (start);
+
+    start = Timestamp::Read();
+    Composite (pool, scene, output, settings.scanlineRows);
+    m_lastTimings.compositeMs = MillisecondsSince (start);
+}
+
+
+
+
+
+std::span<const float> SoftwareBloom::GetBlurWeights (BlurTaps taps)
+{
+    switch (taps)
+    {
+        case BlurTaps::Low:    return s_kBlurWeights5;
+        case BlurTaps::Medium: return s_kBlurWeights9;
+        case BlurTaps::High:
+        default:               return s_kBlurWeights13;
+    }
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SoftwareBloom::CountBlurFetches
+//
+//  Gaussian: taps per pixel, horizontal and vertical, per pass.  Dual
+//  filter: 4 per downsample pixel; 8 tent taps per upsample pixel plus one
+//  read of the level being blended in, except on the final upsample into
+//  the bloom buffer.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+uint64_t SoftwareBloom::CountBlurFetches (UINT bloomWidth, UINT bloomHeight, const SoftwareBloomSettings & settings)
+{
+    uint64_t pixels = uint64_t (bloomWidth) * bloomHeight;
+    uint64_t total  = 0;
+
+
+
+    if (settings.algorithm != BloomAlgorithm::DualFilter)
+    {
+        return pixels * GetBlurWeights (settings.blurTaps).size() * 2 * std::clamp (settings.blurPasses, 1, 4);
+    }
+
+    int levelCount = DualFilterLevelCount (settings.blurPasses);
+
+    for (int level = 1; level <= levelCount; level++)
+    {
+        uint64_t levelPixels = uint64_t (std::max (1u, bloomWidth >> level)) * std::max (1u, bloomHeight >> level);
+
+        total += levelPixels * 4;
+
+        if (level < levelCount)
+        {
+            total += levelPixels * 9;
+        }
+    }
+
+    return total + pixels * 8;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SoftwareBloom::CountPassTraffic
+//
+//  RGBA8 targets throughout, 4 bytes a texel; the scanline table is one
+//  float per row.  GlowKernel is software-only, so the blur is always the
+//  GPU's Gaussian or dual-filter chain.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<PassTraffic> SoftwareBloom::CountPassTraffic (UINT width, UINT height, const SoftwareBloomSettings & settings, bool separateScanlinePass)
+{
+    constexpr uint64_t kBytesPerTexel = 4;
+
+    int                      divisor     = std::clamp (static_cast<int> (settings.resolutionDivisor), 1, 8);
+    UINT                     bloomWidth  = std::max (1u, width  / static_cast<UINT> (divisor));
+    UINT                     bloomHeight = std::max (1u, height / static_cast<UINT> (divisor));
+    uint64_t                 frameBytes  = uint64_t (width) * height * kBytesPerTexel;
+    uint64_t                 bloomBytes  = uint64_t (bloomWidth) * bloomHeight * kBytesPerTexel;
+    bool                     fused       = !separateScanlinePass && !settings.scanlineRows.empty();
+    std::vector<PassTraffic> passes;
+
+    auto levelBytes = [&] (int level)
+    {
+        return uint64_t (std::max (1u, bloomWidth >> level)) * std::max (1u, bloomHeight >> level) * kBytesPerTexel;
+    };
+
+
+
+    passes.push_back ({ "Extract", frameBytes, bloomBytes });
+
+    if (settings.algorithm == BloomAlgorithm::DualFilter)
+    {
+        int levelCount = DualFilterLevelCount (settings.blurPasses);
+
+        for (int level = 1; level <= levelCount; level++)
+        {
+            passes.push_back ({ "DualDown", levelBytes (level - 1), levelBytes (level) });
+        }
+
+        // The coarsest level feeds the first upsample as is
+        for (int level = levelCount - 1; level >= 1; level--)
+        {
+            passes.push_back ({ "DualUp", levelBytes (level + 1) + levelBytes (level), levelBytes (level) });
+        }
+
+        passes.push_back ({ "DualFinal", levelBytes (1), bloomBytes });
+    }
+    else
+    {
+        for (int pass = 0; pass < std::clamp (settings.blurPasses, 1, 4); pass++)
+        {
+            passes.push_back ({ "BlurH", bloomBytes, bloomBytes });
+            passes.push_back ({ "BlurV", bloomBytes, bloomBytes });
+        }
+    }
+
+    passes.push_back ({ "Composite", frameBytes + bloomBytes + (fused ? height * sizeof (float) : 0), frameBytes });
+
+    if (separateScanlinePass)
+    {
+        passes.push_back ({ "Scanlines", frameBytes, frameBytes });
+    }
+
+    return passes;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SoftwareBloom::ComputeGlowReach
+//
+//  Sums the support of every stage in bloom texels, then scales to scene
+//  pixels.  Extract and composite each add one texel of bilinear
+//  footprint.  A Gaussian pass reaches one texel past its outermost tap.
+//  The iterated box stays within three boxes whose radius is below
+//  sqrt(passes) times that, since its variance matches the chain's.  The
+//  dual filter's taps land glowSize texels out at each level (half that
+//  on the way up), plus a texel of bilinear footprint, scaled by the
+//  level's size.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+int SoftwareBloom::ComputeGlowReach (const SoftwareBloomSettings & settings)
+{
+    int   divisor   = std::clamp (static_cast<int> (settings.resolutionDivisor), 1, 8);
+    int   passCount = std::clamp (settings.blurPasses, 1, 4);
+    float glowSize  = std::max (0.0f, settings.glowSize);
+    float tapReach  = floorf (static_cast<float> (GetBlurWeights (settings.blurTaps).size() / 2) * glowSize) + 1.0f;
+    float reach     = 2.0f;
+
+
+
+    if (settings.algorithm == BloomAlgorithm::DualFilter)
+    {
+        int levelCount = DualFilterLevelCount (settings.blurPasses);
+
+        for (int level = 1; level <= levelCount; level++)
+        {
+            float sourceScale = static_cast<float> (1 << (level - 1));
+
+            reach += (glowSize + 1.0f) * sourceScale;                   // Downsample into this level
+            reach += (0.5f * glowSize + 1.0f) * 2.0f * sourceScale;     // Upsample out of it
+        }
+    }
+    else if (settings.glowKernel == GlowKernel::IteratedBox)
+    {
+        reach += s_kBoxPasses * (ceilf (sqrtf (static_cast<float> (passCount)) * tapReach) + 1.0f);
+    }
+    else
+    {
+        reach += passCount * tapReach;
+    }
+
+    return static_cast<int> (ceilf (reach)) * divisor;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SoftwareBloom::BuildSampleTaps
+//
+//  Where a linear sampler lands when a fullscreen pass of destinationSize
+//  pixels reads a texture of sourceSize texels: uv = (d + 0.5) / dst, so
+//  the texel-space coordinate is uv * src - 0.5, clamped at the edges.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void SoftwareBloom::BuildSampleTaps (UINT destinationSize, UINT sourceSize, std::vector<SampleTap> & taps, float offset)
+{
+    float scale   = static_cast<float> (sourceSize) / static_cast<float> (destinationSize);
+    int   lastTap = static_cast<int> (sourceSize) - 1;
+
+
+
+    taps.resize (destinationSize);
+
+    for (UINT d = 0; d < destinationSize; d++)
+    {
+        float position = (static_cast<float> (d) + 0.5f) * scale - 0.5f + offset;
+        float base     = floorf (position);
+        int   index    = static_cast<int> (base);
+
+        taps[d].index0  = std::clamp (index,     0, lastTap);
+        taps[d].index1  = std::clamp (index + 1, 0, lastTap);
+        taps[d].weight1 = position - base;
+    }
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SoftwareBloom::BuildKernel
+//
+//  Tap i of the shader samples at i * glowSize texels.  Split each tap
+//  across the two texels its bilinear footprint covers and merge taps that
+//  share a texel; with clamp addressing the result is the same sum the
+//  sampler computes, with fewer reads whenever glowSize < 1.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void SoftwareBloom::BuildKernel (BlurTaps taps, float glowSize)
+{
+    std::span<const float> weights = GetBlurWeights (taps);
+    int                    radius  = static_cast<int> (weights.size()) / 2;
+    float                  spacing = std::max (0.0f, glowSize);
+    int                    lowest  = static_cast<int> (floorf (-radius * spacing));
+    int                    highest = static_cast<int> (floorf ( radius * spacing)) + 1;
+    std::vector<float>     merged (size_t (highest - lowest + 1), 0.0f);
+
+
+
+    for (int i = -radius; i <= radius; i++)
+    {
+        float position = static_cast<float> (i) * spacing;
+        float base     = floorf (position);
+        float fraction = position - base;
+        int   slot     = static_cast<int> (base) - lowest;
+        float weight   = weights[size_t (i + radius)];
+
+        merged[size_t (slot)]     += weight * (1.0f - fraction);
+        merged[size_t (slot + 1)] += weight * fraction;
+    }
+
+    m_kernelOffsets.clear();
+    m_kernelWeights.clear();
+    m_kernelReach = 0;
+
+    for (size_t slot = 0; slot < merged.size(); slot++)
+    {
+        if (merged[slot] > 0.0f)
+        {
+            int offset = static_cast<int> (slot) + lowest;
+
+            m_kernelOffsets.push_back (offset);
+            m_kernelWeights.push_back (merged[slot]);
+            m_kernelReach = std::max (m_kernelReach, abs (offset));
+        }
+    }
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SoftwareBloom::BuildBoxKernel
+//
+//  Sizes the box so s_kBoxPasses of them have the variance of passCount
+//  runs of the Gaussian kernel (variances add under convolution).  A box
+//  of radius r has weight 1 on [-r, r]; adding a fractional weight a on
+//  the two texels just outside gives
+//
+//      variance = (r(r+1)(2r+1)/3 + 2a(r+1)^2) / (2r+1+2a)
+//
+//  which is continuous in glow size, unlike odd integer widths.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void SoftwareBloom::BuildBoxKernel (int passCount)
+{
+    float chainVariance = 0.0f;
+    float boxVariance   = 0.0f;
+    int   radius        = 0;
+
+
+
+    for (size_t k = 0; k < m_kernelOffsets.size(); k++)
+    {
+        chainVariance += m_kernelWeights[k] * static_cast<float> (m_kernelOffsets[k] * m_kernelOffsets[k]);
+    }
+
+    boxVariance = chainVariance * passCount / s_kBoxPasses;
+
+    // Widest whole box that does not exceed the target: r(r+1)/3 <= v
+    while (static_cast<float> ((radius + 1) * (radius + 2)) / 3.0f <= boxVariance)
+    {
+        radius++;
+    }
+
+    float inner     = static_cast<float> (radius * (radius + 1) * (2 * radius + 1)) / 3.0f;
+    float width     = static_cast<float> (2 * radius + 1);
+    float outerStep = static_cast<float> ((radius + 1) * (radius + 1));
+
+    m_boxRadius   = radius;
+    m_boxFraction = std::clamp ((boxVariance * width - inner) / (2.0f * (outerStep - boxVariance)), 0.0f, 1.0f);
+    m_boxScale    = 1.0f / (width + 2.0f * m_boxFraction);
+}
+
+
+
+
+
+void SoftwareBloom::BuildSoftBloomLut (float intensity)
+{
+    if (intensity == m_softBloomIntensity && !m_softBloomLut.empty())
+    {
+        return;
+    }
+
+    // One extra entry so interpolation at x == 1 reads in bounds
+    m_softBloomLut.resize (s_kSoftBloomLutSize + 2);
+
+    for (size_t i = 0; i < m_softBloomLut.size(); i++)
+    {
+        float x = static_cast<float> (i) / s_kSoftBloomLutSize;
+
+        m_softBloomLut[i] = 1.0f - expf (-x * intensity);
+    }
+
+    m_softBloomIntensity = intensity;
+}
+
+
+
+
+
+std::vector<float> & SoftwareBloom::Scratch (UINT threadIndex, size_t floats)
+{
+    std::vector<float> & scratch = m_scratch[threadIndex];
+
+
+
+    if (scratch.size() < floats)
+    {
+        scratch.resize (floats);
+    }
+
+    return scratch;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SoftwareBloom::Extract
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void SoftwareBloom::Extract (WorkerPool & pool, const SoftwareSurface & scene)
+{
+    pool.ParallelFor (m_bloom.GetHeight(), [&] (UINT y, UINT)
+    {
+        const SampleTap & rowTap = m_extractRows[y];
+        const uint32_t  * rowA   = scene.Row (static_cast<UINT> (rowTap.index0));
+        const uint32_t  * rowB   = scene.Row (static_cast<UINT> (rowTap.index1));
+        uint32_t        * out    = m_bloom.Row (y);
+
+        for (UINT x = 0; x < m_bloom.GetWidth(); x++)
+        {
+            const SampleTap & colTap = m_extractColumns[x];
+            SimdFloat4        top    = Lerp (SimdUnpackRgba8 (rowA[colTap.index0]), SimdUnpackRgba8 (rowA[colTap.index1]), colTap.weight1);
+            SimdFloat4        bottom = Lerp (SimdUnpackRgba8 (rowB[colTap.index0]), SimdUnpackRgba8 (rowB[colTap.index1]), colTap.weight1);
+            float             rgba[4];
+
+            SimdStore (rgba, Lerp (top, bottom, rowTap.weight1));
+
+            float bright = std::max (0.2126f * rgba[0] + 0.7152f * rgba[1] + 0.0722f * rgba[2], std::max (std::max (rgba[0], rgba[1]), rgba[2]));
+            float t      = std::clamp ((bright - s_kExtractThreshold) / s_kExtractRamp, 0.0f, 1.0f);
+            float amount = t * t * (3.0f - 2.0f * t);
+
+            out[x] = SimdPackRgba8 (SimdSet (rgba[0] * amount, rgba[1] * amount, rgba[2] * amount, 1.0f));
+        }
+    });
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SoftwareBloom::BlurHorizontal
+//
+//  Each row is unpacked once into a float scratch row padded by the
+//  kernel reach on both sides (edge texels repeated, i.e. clamp
+//  addressing), so the tap loop has no bounds checks.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void SoftwareBloom::BlurHorizontal (WorkerPool & pool, const SoftwareSurface & source, SoftwareSurface & destination)
+{
+    int width = static_cast<int> (source.GetWidth());
+
+
+
+    pool.ParallelFor (source.GetHeight(), [&] (UINT y, UINT threadIndex)
+    {
+        std::vector<float> & padded = Scratch (threadIndex, size_t (width + 2 * m_kernelReach) * 4);
+        const uint32_t     * in     = source.Row (y);
+        uint32_t           * out    = destination.Row (y);
+
+        for (int i = -m_kernelReach; i < width + m_kernelReach; i++)
+        {
+            SimdStore (&padded[size_t (i + m_kernelReach) * 4], SimdUnpackRgba8 (in[std::clamp (i, 0, width - 1)]));
+        }
+
+        for (int x = 0; x < width; x++)
+        {
+            SimdFloat4    sum  = SimdSplat (0.0f);
+            const float * base = &padded[size_t (x + m_kernelReach) * 4];
+
+            for (size_t k = 0; k < m_kernelOffsets.size(); k++)
+            {
+                sum = SimdAdd (sum, SimdMul (SimdLoad (base + m_kernelOffsets[k] * 4), SimdSplat (m_kernelWeights[k])));
+            }
+
+            out[x] = SimdPackRgba8 (sum);
+        }
+    });
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SoftwareBloom::BlurVertical
+//
+//  Accumulates whole source rows into a float scratch row, one tap at a
+//  time, so reads stay sequential.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void SoftwareBloom::BlurVertical (WorkerPool & pool, const SoftwareSurface & source, SoftwareSurface & destination)
+{
+    UINT width   = source.GetWidth();
+    int  lastRow = static_cast<int> (source.GetHeight()) - 1;
+
+
+
+    pool.ParallelFor (source.GetHeight(), [&] (UINT y, UINT threadIndex)
+    {
+        std::vector<float> & sum = Scratch (threadIndex, size_t (width) * 4);
+        uint32_t           * out = destination.Row (y);
+
+        std::fill_n (sum.begin(), size_t (width) * 4, 0.0f);
+
+        for (size_t k = 0; k < m_kernelOffsets.size(); k++)
+        {
+            const uint32_t * in     = source.Row (static_cast<UINT> (std::clamp (static_cast<int> (y) + m_kernelOffsets[k], 0, lastRow)));
+            SimdFloat4       weight = SimdSplat (m_kernelWeights[k]);
+
+            for (UINT x = 0; x < width; x++)
+            {
+                float * acc = &sum[size_t (x) * 4];
+
+                SimdStore (acc, SimdAdd (SimdLoad (acc), SimdMul (SimdUnpackRgba8 (in[x]), weight)));
+            }
+        }
+
+        for (UINT x = 0; x < width; x++)
+        {
+            out[x] = SimdPackRgba8 (SimdLoad (&sum[size_t (x) * 4]));
+        }
+    });
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SoftwareBloom::BlurIteratedBox
+//
+//  Horizontal: each row is unpacked into a padded float scratch row and
+//  boxed s_kBoxPasses times in place (ping-ponging two scratch rows), then
+//  stored to a float image.  Vertical: the image is split into column
+//  strips and each strip is swept top to bottom s_kBoxPasses times with a
+//  running sum per column, then packed into the bloom buffer.  Edges
+//  repeat the border texel, like clamp addressing.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void SoftwareBloom::BlurIteratedBox (WorkerPool & pool)
+{
+    int        width     = static_cast<int> (m_bloom.GetWidth());
+    int        height    = static_cast<int> (m_bloom.GetHeight());
+    int        radius    = m_boxRadius;
+    int        pad       = radius + 1;
+    size_t     rowFloats = size_t (width) * 4;
+    UINT       strips    = (static_cast<UINT> (width) + s_kBoxStripWidth - 1) / s_kBoxStripWidth;
+    SimdFloat4 fraction  = SimdSplat (m_boxFraction);
+    SimdFloat4 scale     = SimdSplat (m_boxScale);
+
+
+
+    m_boxImage.resize (rowFloats * height);
+    m_boxTemp.resize  (rowFloats * height);
+
+    pool.ParallelFor (static_cast<UINT> (height), [&] (UINT y, UINT threadIndex)
+    {
+        size_t               paddedFloats = size_t (width + 2 * pad) * 4;
+        std::vector<float> & scratch      = Scratch (threadIndex, paddedFloats * 2);
+        float              * source       = scratch.data()                + size_t (pad) * 4;
+        float              * target       = scratch.data() + paddedFloats + size_t (pad) * 4;
+        const uint32_t     * in           = m_bloom.Row (y);
+
+        for (int x = 0; x < width; x++)
+        {
+            SimdStore (source + size_t (x) * 4, SimdUnpackRgba8 (in[x]));
+        }
+
+        for (int pass = 0; pass < s_kBoxPasses; pass++)
+        {
+            SimdFloat4 first = SimdLoad (source);
+            SimdFloat4 last  = SimdLoad (source + size_t (width - 1) * 4);
+            SimdFloat4 sum   = SimdSplat (0.0f);
+
+            for (int i = 1; i <= pad; i++)
+            {
+                SimdStore (source - i * 4,                      first);
+                SimdStore (source + size_t (width - 1 + i) * 4, last);
+            }
+
+            for (int k = -radius; k <= radius; k++)
+            {
+                sum = SimdAdd (sum, SimdLoad (source + k * 4));
+            }
+
+            for (int x = 0; x < width; x++)
+            {
+                const float * center   = source + size_t (x) * 4;
+                SimdFloat4    leaving  = SimdLoad (center - radius * 4);
+                SimdFloat4    outside  = SimdAdd (SimdLoad (center - pad * 4), SimdLoad (center + pad * 4));
+                SimdFloat4    entering = SimdLoad (center + pad * 4);
+
+                SimdStore (target + size_t (x) * 4, SimdMul (SimdAdd (sum, SimdMul (outside, fraction)), scale));
+                sum = SimdAdd (sum, SimdSub (entering, leaving));
+            }
+
+            std::swap (source, target);
+        }
+
+        std::copy_n (source, rowFloats, m_boxImage.data() + rowFloats * y);
+    });
+
+    pool.ParallelFor (strips, [&] (UINT strip, UINT threadIndex)
+    {
+        int                  x0      = static_cast<int> (strip * s_kBoxStripWidth);
+        int                  columns = std::min (static_cast<int> (s_kBoxStripWidth), width - x0);
+        std::vector<float> & sums    = Scratch (threadIndex, size_t (columns) * 4);
+        float              * source  = m_boxImage.data();
+        float              * target  = m_boxTemp.data();
+
+        auto row = [&] (float * image, int y)
+        {
+            return image + rowFloats * std::clamp (y, 0, height - 1) + size_t (x0) * 4;
+        };
+
+        for (int pass = 0; pass < s_kBoxPasses; pass++)
+        {
+            std::fill_n (sums.begin(), size_t (columns) * 4, 0.0f);
+
+            for (int k = -radius; k <= radius; k++)
+            {
+                const float * in = row (source, k);
+
+                for (int c = 0; c < columns * 4; c += 4)
+                {
+                    SimdStore (&sums[c], SimdAdd (SimdLoad (&sums[c]), SimdLoad (in + c)));
+                }
+            }
+
+            for (int y = 0; y < height; y++)
+            {
+                const float * leaving  = row (source, y - radius);
+                const float * entering = row (source, y + pad);
+                const float * above    = row (source, y - pad);
+                float       * out      = target + rowFloats * y + size_t (x0) * 4;
+
+                for (int c = 0; c < columns * 4; c += 4)
+                {
+                    SimdFloat4 sum     = SimdLoad (&sums[c]);
+                    SimdFloat4 outside = SimdAdd (SimdLoad (above + c), SimdLoad (entering + c));
+
+                    SimdStore (out + c,  SimdMul (SimdAdd (sum, SimdMul (outside, fraction)), scale));
+                    SimdStore (&sums[c], SimdAdd (sum, SimdSub (SimdLoad (entering + c), SimdLoad (leaving + c))));
+                }
+            }
+
+            std::swap (source, target);
+        }
+
+        for (int y = 0; y < height; y++)
+        {
+            const float * in  = source + rowFloats * y + size_t (x0) * 4;
+            uint32_t    * out = m_bloom.Row (static_cast<UINT> (y)) + x0;
+
+            for (int c = 0; c < columns; c++)
+            {
+                out[c] = SimdPackRgba8 (SimdLoad (in + size_t (c) * 4));
+            }
+        }
+    });
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SoftwareBloom::BlurDualFilter
+//
+//  Level 0 is the extracted bloom buffer; each level below halves it.
+//  Down the chain every level is a 4-tap downsample of the one above.
+//  Back up, each level is the tent upsample of the level below averaged
+//  with its own downsample, so coarser (wider) levels weigh half as much
+//  as the one above them; the last upsample lands in the bloom buffer.
+//  Every level is RGBA8, like the GPU chain.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void SoftwareBloom::BlurDualFilter (WorkerPool & pool, int levelCount, float glowSize)
+{
+    auto fitLevel = [] (SoftwareSurface & surface, UINT width, UINT height)
+    {
+        if (surface.GetWidth() != width || surface.GetHeight() != height)
+        {
+            surface.Resize (width, height);
+        }
+    };
+
+
+
+    m_dualDown.resize (levelCount);
+    m_dualUp.resize   (levelCount - 1);
+
+    for (int level = 0; level < levelCount; level++)
+    {
+        UINT width  = std::max (1u, m_bloom.GetWidth()  >> (level + 1));
+        UINT height = std::max (1u, m_bloom.GetHeight() >> (level + 1));
+
+        fitLevel (m_dualDown[level], width, height);
+
+        if (level < levelCount - 1)
+        {
+            fitLevel (m_dualUp[level], width, height);
+        }
+
+        DualDownsample (pool, level == 0 ? m_bloom : m_dualDown[level - 1], m_dualDown[level], glowSize);
+    }
+
+    for (int level = levelCount - 2; level >= 0; level--)
+    {
+        const SoftwareSurface & coarse = level == levelCount - 2 ? m_dualDown[level + 1] : m_dualUp[level + 1];
+
+        DualUpsample (pool, coarse, &m_dualDown[level], m_dualUp[level], glowSize);
+    }
+
+    DualUpsample (pool, levelCount > 1 ? m_dualUp[0] : m_dualDown[0], nullptr, m_bloom, glowSize);
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SoftwareBloom::DualDownsample
+//
+//  Four bilinear taps glowSize source texels diagonally out from the
+//  destination pixel's centre; at 100% each tap averages a 2x2 block and
+//  together they cover 4x4.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void SoftwareBloom::DualDownsample (WorkerPool & pool, const SoftwareSurface & source, SoftwareSurface & destination, float glowSize)
+{
+    SimdFloat4 quarter = SimdSplat (0.25f);
+
+
+
+    BuildSampleTaps (destination.GetWidth(),  source.GetWidth(),  m_dualColumns[0], -glowSize);
+    BuildSampleTaps (destination.GetWidth(),  source.GetWidth(),  m_dualColumns[1],  glowSize);
+    BuildSampleTaps (destination.GetHeight(), source.GetHeight(), m_dualRows[0],    -glowSize);
+    BuildSampleTaps (destination.GetHeight(), source.GetHeight(), m_dualRows[1],     glowSize);
+
+    pool.ParallelFor (destination.GetHeight(), [&] (UINT y, UINT)
+    {
+        const SampleTap & above = m_dualRows[0][y];
+        const SampleTap & below = m_dualRows[1][y];
+        uint32_t        * out   = destination.Row (y);
+
+        for (UINT x = 0; x < destination.GetWidth(); x++)
+        {
+            const SampleTap & left  = m_dualColumns[0][x];
+            const SampleTap & right = m_dualColumns[1][x];
+            SimdFloat4        sum   = SimdAdd (SimdAdd (SampleBilinear (source, left, above), SampleBilinear (source, right, above)),
+                                               SimdAdd (SampleBilinear (source, left, below), SampleBilinear (source, right, below)));
+
+            out[x] = SimdPackRgba8 (SimdMul (sum, quarter)) | SoftwareSurface::s_kOpaqueBlack;
+        }
+    });
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SoftwareBloom::DualUpsample
+//
+//  Tent over the coarse level: four taps glowSize / 2 coarse texels out
+//  along the axes and four at half that on the diagonals, weighted 1 and 2
+//  of 12.  With a fine level the result is averaged with it.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void SoftwareBloom::DualUpsample (WorkerPool & pool, const SoftwareSurface & coarse, const SoftwareSurface * fine, SoftwareSurface & destination, float glowSize)
+{
+    float      reach       = 0.5f * glowSize;
+    float      offsets[5]  = { -reach, -0.5f * reach, 0.0f, 0.5f * reach, reach };
+    SimdFloat4 axisWeight  = SimdSplat (s_kTentAxisWeight);
+    SimdFloat4 diagWeight  = SimdSplat (s_kTentDiagonalWeight);
+    SimdFloat4 half        = SimdSplat (0.5f);
+
+
+
+    for (int i = 0; i < 5; i++)
+    {
+        BuildSampleTaps (destination.GetWidth(),  coarse.GetWidth(),  m_dualColumns[i], offsets[i]);
+        BuildSampleTaps (destination.GetHeight(), coarse.GetHeight(), m_dualRows[i],    offsets[i]);
+    }
+
+    pool.ParallelFor (destination.GetHeight(), [&] (UINT y, UINT)
+    {
+        const uint32_t * fineRow = fine ? fine->Row (y) : nullptr;
+        uint32_t       * out     = destination.Row (y);
+
+        for (UINT x = 0; x < destination.GetWidth(); x++)
+        {
+            auto tap = [&] (int column, int row)
+            {
+                return SampleBilinear (coarse, m_dualColumns[column][x], m_dualRows[row][y]);
+            };
+
+            SimdFloat4 axis = SimdAdd (SimdAdd (tap (0, 2), tap (4, 2)), SimdAdd (tap (2, 0), tap (2, 4)));
+            SimdFloat4 diag = SimdAdd (SimdAdd (tap (1, 1), tap (3, 1)), SimdAdd (tap (1, 3), tap (3, 3)));
+            SimdFloat4 tent = SimdAdd (SimdMul (axis, axisWeight), SimdMul (diag, diagWeight));
+
+            if (fineRow)
+            {
+                tent = SimdMul (SimdAdd (tent, SimdUnpackRgba8 (fineRow[x])), half);
+            }
+
+            out[x] = SimdPackRgba8 (tent) | SoftwareSurface::s_kOpaqueBlack;
+        }
+    });
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SoftwareBloom::Composite
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void SoftwareBloom::Composite (WorkerPool & pool, const SoftwareSurface & scene, SoftwareSurface & output, std::span<const float> scanlineRows)
+{
+    const float * lut = m_softBloomLut.data();
+
+    auto softBloom = [lut] (float x)
+    {
+        float position = std::clamp (x, 0.0f, 1.0f) * s_kSoftBloomLutSize;
+        int   index    = static_cast<int> (position);
+        float fraction = position - static_cast<float> (index);
+
+        return lut[index] + (lut[index + 1] - lut[index]) * fraction;
+    };
+
+
+
+    pool.ParallelFor (scene.GetHeight(), [&] (UINT y, UINT)
+    {
+        const SampleTap & rowTap = m_compositeRows[y];
+        const uint32_t  * bloomA = m_bloom.Row (static_cast<UINT> (rowTap.index0));
+        const uint32_t  * bloomB = m_bloom.Row (static_cast<UINT> (rowTap.index1));
+        const uint32_t  * in     = scene.Row (y);
+        uint32_t        * out    = output.Row (y);
+        float             darken = scanlineRows.empty() ? 1.0f : scanlineRows[y];
+        SimdFloat4        rowMul = SimdSet (darken, darken, darken, 1.0f);
+
+        for (UINT x = 0; x < scene.GetWidth(); x++)
+        {
+            const SampleTap & colTap = m_compositeColumns[x];
+            SimdFloat4        top    = Lerp (SimdUnpackRgba8 (bloomA[colTap.index0]), SimdUnpackRgba8 (bloomA[colTap.index1]), colTap.weight1);
+            SimdFloat4        bottom = Lerp (SimdUnpackRgba8 (bloomB[colTap.index0]), SimdUnpackRgba8 (bloomB[colTap.index1]), colTap.weight1);
+            SimdFloat4        color  = SimdUnpackRgba8 (in[x]);
+            float             bloom[4];
+
+            SimdStore (bloom, Lerp (top, bottom, rowTap.weight1));
+
+            SimdFloat4 soft = SimdSet (softBloom (bloom[0]), softBloom (bloom[1]), softBloom (bloom[2]), 1.0f);
+
+            // Alpha lane: a + 1 * (1 - a) = 1, as the shader writes
+            out[x] = SimdPackRgba8 (SimdMul (SimdAdd (color, SimdMul (soft, SimdSub (SimdSplat (1.0f), color))), rowMul));
+        }
+    });
+}
@@ -0,0 +1,185 @@
+#pragma once
+
+#include "QualityPresets.h"
+#include "SoftwareSurface.h"
+#include "WorkerPool.h"
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SoftwareBloomSettings
+//
+//  The knobs RenderSystem::ApplyBloom reads, in the same units:
+//  intensity is the composite multiplier (m_glowIntensity, 2.5 at 100%),
+//  glowSize the blur tap spacing in bloom texels (m_glowSize, 1.0 at 100%).
+//  scanlineRows, when set, holds one darken factor per output row
+//  (ScanlineAttenuationTable) for the composite to apply, as the fused
+//  composite + scanline shader does.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+struct SoftwareBloomSettings
+{
+    float                  intensity         { 2.5f };
+    float                  glowSize          { 1.0f };
+    int                    blurPasses        { 3 };
+    ResolutionDivisor      resolutionDivisor { ResolutionDivisor::Half };
+    BlurTaps               blurTaps          { BlurTaps::High };
+    GlowKernel             glowKernel        { GlowKernel::Gaussian };
+    BloomAlgorithm         algorithm         { BloomAlgorithm::Gaussian };
+    std::span<const float> scanlineRows;
+};
+
+
+
+
+
+struct BloomStageTimings
+{
+    double extractMs   { 0.0 };
+    double blurMs      { 0.0 };      // All passes, horizontal + vertical
+    double compositeMs { 0.0 };
+};
+
+
+
+
+
+// Memory traffic of one GPU post-process pass, counting every texture it
+// samples read once and its render target written once
+struct PassTraffic
+{
+    const char * name;
+    uint64_t     bytesRead;
+    uint64_t     bytesWritten;
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SoftwareBloom
+//
+//  CPU port of RenderSystem::ApplyBloom:
+//
+//  1. Extract   — scene sampled bilinearly into the reduced-resolution bloom
+//                 buffer; brightness = max(luminance, max channel), scaled
+//                 by smoothstep(0.1, 0.6, brightness).
+//  2. Blur      — 5/9/13-tap separable Gaussian, taps glowSize texels
+//                 apart, horizontal then vertical, blurPasses times.
+//                 GlowKernel::IteratedBox instead runs three box filters
+//                 per axis whose combined variance matches that whole
+//                 chain, each a running sum, so the cost per pixel is
+//                 the same at any glow size or pass count.
+//               BloomAlgorithm::DualFilter replaces this step: 4-tap
+//               downsamples to blurPasses + 1 levels below the bloom
+//               buffer, then tent upsamples back to it, averaging each
+//               level's downsample in on the way up.
+//  3. Composite — full-resolution scene + (1 - exp(-bloom * intensity)) *
+//                 (1 - scene), alpha 1, times the row's scanline factor
+//                 when scanlineRows is set.
+//
+//  Intermediates are RGBA8 like the GPU textures, so rounding between
+//  passes matches.  Fractional tap spacing is folded into an integer
+//  kernel (each bilinear tap split across its two texels), which samples
+//  exactly what the clamp-addressed linear sampler would.
+//
+//  Every pass is row-parallel over a WorkerPool, one RGBA pixel per
+//  SimdFloat4 operation, with per-thread scratch rows.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class SoftwareBloom
+{
+public:
+    void Apply (WorkerPool & pool, const SoftwareSurface & scene, SoftwareSurface & output, const SoftwareBloomSettings & settings);
+
+    // Weights of the GPU blur shaders for a BlurTaps setting
+    static std::span<const float> GetBlurWeights (BlurTaps taps);
+
+    // Bilinear fetches the GPU blur passes issue for a bloom buffer of this
+    // size: the cost the two algorithms are compared on without a GPU
+    static uint64_t CountBlurFetches (UINT bloomWidth, UINT bloomHeight, const SoftwareBloomSettings & settings);
+
+    // Per-pass traffic of RenderSystem's bloom chain at this render size.
+    // Scanlines ride in the composite when settings.scanlineRows is set;
+    // separateScanlinePass instead models the composite into
+    // m_postBloomTexture followed by the standalone scanline pass.
+    static std::vector<PassTraffic> CountPassTraffic (UINT width, UINT height, const SoftwareBloomSettings & settings, bool separateScanlinePass);
+
+    // How far, in scene pixels, glow can spread from a lit pixel: every
+    // kernel here has finite support, so nothing beyond this is touched
+    static int ComputeGlowReach (const SoftwareBloomSettings & settings);
+
+    const SoftwareSurface   & GetBloomSurface() const { return m_bloom;       }
+    const BloomStageTimings & GetLastTimings()  const { return m_lastTimings; }
+
+private:
+    // Bilinear footprint of one destination column or row in the source
+    struct SampleTap
+    {
+        int   index0;
+        int   index1;
+        float weight1;
+    };
+
+    // offset moves every tap by that many source texels
+    static void BuildSampleTaps (UINT destinationSize, UINT sourceSize, std::vector<SampleTap> & taps, float offset = 0.0f);
+
+    void BuildKernel       (BlurTaps taps, float glowSize);
+    void BuildBoxKernel    (int passCount);
+    void BuildSoftBloomLut (float intensity);
+
+    void Extract         (WorkerPool & pool, const SoftwareSurface & scene);
+    void BlurHorizontal  (WorkerPool & pool, const SoftwareSurface & source, SoftwareSurface & destination);
+    void BlurVertical    (WorkerPool & pool, const SoftwareSurface & source, SoftwareSurface & destination);
+    void BlurIteratedBox (WorkerPool & pool);
+    void BlurDualFilter  (WorkerPool & pool, int levelCount, float glowSize);
+    void DualDownsample  (WorkerPool & pool, const SoftwareSurface & source, SoftwareSurface & destination, float glowSize);
+    void DualUpsample    (WorkerPool & pool, const SoftwareSurface & coarse, const SoftwareSurface * fine, SoftwareSurface & destination, float glowSize);
+    void Composite       (WorkerPool & pool, const SoftwareSurface & scene, SoftwareSurface & output, std::span<const float> scanlineRows);
+
+    std::vector<float> & Scratch (UINT threadIndex, size_t floats);
+
+    SoftwareSurface                 m_bloom;
+    SoftwareSurface                 m_blurTemp;
+    BloomStageTimings               m_lastTimings;
+
+    // Blur kernel at integer texel offsets
+    std::vector<int>                m_kernelOffsets;
+    std::vector<float>              m_kernelWeights;
+    int                             m_kernelReach { 0 };    // max |offset|
+
+    // Iterated box: weight 1 out to m_boxRadius, m_boxFraction one texel
+    // further, normalized by m_boxScale.  Runs on float images so only the
+    // final result is rounded to RGBA8.
+    int                             m_boxRadius   { 0 };
+    float                           m_boxFraction { 0.0f };
+    float                           m_boxScale    { 1.0f };
+    std::vector<float>              m_boxImage;
+    std::vector<float>              m_boxTemp;
+
+    // Dual filter mip chain: m_dualDown[k] is level k + 1 below the bloom
+    // buffer, m_dualUp[k] the upsample written back at the same size.
+    // Footprints for the taps of the current pass, one per offset.
+    std::vector<SoftwareSurface>    m_dualDown;
+    std::vector<SoftwareSurface>    m_dualUp;
+    std::vector<SampleTap>          m_dualColumns[5];
+    std::vector<SampleTap>          m_dualRows[5];
+
+    // Resampling footprints for extract (scene -> bloom) and composite (bloom -> scene)
+    std::vector<SampleTap>          m_extractColumns;
+    std::vector<SampleTap>          m_extractRows;
+    std::vector<SampleTap>          m_compositeColumns;
+    std::vector<SampleTap>          m_compositeRows;
+
+    // 1 - exp(-x * intensity) over x in [0, 1]
+    std::vector<float>              m_softBloomLut;
+    float                           m_softBloomIntensity { -1.0f };
+
+    std::vector<std::vector<float>> m_scratch;              // Per pool thread
+};
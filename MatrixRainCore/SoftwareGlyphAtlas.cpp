@@ -0,0 +1,197 @@
+#include "pch.h"
+
+#include "SoftwareGlyphAtlas.h"
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SoftwareGlyphAtlas::BuildProcedural
+//
+//  Each cell gets three to six axis-aligned strokes chosen by a per-cell
+//  hash.  Coverage comes from the distance to each stroke's box, giving a
+//  one-pixel anti-aliased edge like D2D grayscale text.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void SoftwareGlyphAtlas::BuildProcedural()
+{
+    struct Stroke
+    {
+        float minX;
+        float minY;
+        float maxX;
+        float maxY;
+    };
+
+    m_width  = s_kAtlasSize;
+    m_height = s_kAtlasSize;
+    m_coverage.assign (size_t (m_width) * m_height + s_kSampleSlack, 0);
+
+    for (UINT cell = 0; cell < s_kGridCols * s_kGridRows; cell++)
+    {
+        uint32_t            hash        = cell * 2654435761u + 0x9E3779B9u;
+        UINT                cellX       = (cell % s_kGridCols) * s_kCellWidth;
+        UINT                cellY       = (cell / s_kGridCols) * s_kCellHeight;
+        float               glyphMinX   = static_cast<float> (cellX + s_kGlyphPadding);
+        float               glyphMinY   = static_cast<float> (cellY + s_kGlyphPadding);
+        float               glyphWidth  = static_cast<float> (s_kCellWidth  - 2 * s_kGlyphPadding);
+        float               glyphHeight = static_cast<float> (s_kCellHeight - 2 * s_kGlyphPadding);
+        std::vector<Stroke> strokes;
+
+        auto nextRandom = [&hash] () -> float
+        {
+            hash ^= hash << 13;
+            hash ^= hash >> 17;
+            hash ^= hash << 5;
+            return static_cast<float> (hash & 0xFFFF) / 65535.0f;
+        };
+
+        int strokeCount = 3 + static_cast<int> (nextRandom() * 3.99f);
+
+        for (int i = 0; i < strokeCount; i++)
+        {
+            bool   horizontal = nextRandom() < 0.5f;
+            float  thickness  = 10.0f + nextRandom() * 6.0f;
+            float  along0     = nextRandom() * 0.5f;
+            float  along1     = 0.5f + nextRandom() * 0.5f;
+            float  across     = 0.15f + nextRandom() * 0.7f;
+            Stroke stroke;
+
+            if (horizontal)
+            {
+                stroke.minX = glyphMinX + along0 * glyphWidth;
+                stroke.maxX = glyphMinX + along1 * glyphWidth;
+                stroke.minY = glyphMinY + across * glyphHeight - thickness * 0.5f;
+                stroke.maxY = stroke.minY + thickness;
+            }
+            else
+            {
+                stroke.minY = glyphMinY + along0 * glyphHeight;
+                stroke.maxY = glyphMinY + along1 * glyphHeight;
+                stroke.minX = glyphMinX + across * glyphWidth - thickness * 0.5f;
+                stroke.maxX = stroke.minX + thickness;
+            }
+
+            strokes.push_back (stroke);
+        }
+
+        for (UINT y = cellY + s_kGlyphPadding; y < cellY + s_kCellHeight - s_kGlyphPadding; y++)
+        {
+            uint8_t * row = m_coverage.data() + size_t (y) * m_width;
+
+            for (UINT x = cellX + s_kGlyphPadding; x < cellX + s_kCellWidth - s_kGlyphPadding; x++)
+            {
+                float px       = static_cast<float> (x) + 0.5f;
+                float py       = static_cast<float> (y) + 0.5f;
+                float coverage = 0.0f;
+
+                for (const Stroke & stroke : strokes)
+                {
+                    float dx = std::max ({ stroke.minX - px, px - stroke.maxX, 0.0f });
+                    float dy = std::max ({ stroke.minY - py, py - stroke.maxY, 0.0f });
+                    float d  = std::max (dx, dy);
+
+                    coverage = std::max (coverage, std::clamp (1.0f - d, 0.0f, 1.0f));
+                }
+
+                row[x] = static_cast<uint8_t> (coverage * 255.0f + 0.5f);
+            }
+        }
+    }
+}
+
+
+
+
+
+HRESULT SoftwareGlyphAtlas::LoadCoverage (UINT width, UINT height, std::span<const uint8_t> coverage)
+{
+    HRESULT hr = S_OK;
+
+
+
+    CBREx (width > 0 && height > 0, E_INVALIDARG);
+    CBREx (coverage.size() == size_t (width) * height, E_INVALIDARG);
+
+    m_width  = width;
+    m_height = height;
+    m_coverage.assign (coverage.begin(), coverage.end());
+    m_coverage.resize (coverage.size() + s_kSampleSlack, 0);
+
+Error:
+    return hr;
+}
+
+
+
+
+
+HRESULT SoftwareGlyphAtlas::LoadPremultipliedBgra (UINT width, UINT height, const uint8_t * pPixels, UINT pitchBytes)
+{
+    HRESULT hr = S_OK;
+
+
+
+    CBREx (pPixels != nullptr, E_POINTER);
+    CBREx (width > 0 && height > 0 && pitchBytes >= width * 4, E_INVALIDARG);
+
+    m_width  = width;
+    m_height = height;
+    m_coverage.assign (size_t (width) * height + s_kSampleSlack, 0);
+
+    for (UINT y = 0; y < height; y++)
+    {
+        const uint8_t * src = pPixels + size_t (y) * pitchBytes;
+        uint8_t       * dst = m_coverage.data() + size_t (y) * width;
+
+        for (UINT x = 0; x < width; x++)
+        {
+            dst[x] = src[x * 4 + 3];
+        }
+    }
+
+Error:
+    return hr;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SoftwareGlyphAtlas::SampleBilinear
+//
+//  D3D texel-center convention: texel i covers [i, i+1) and its center is
+//  at i + 0.5, so the sample point in texel space is u * width - 0.5.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+float SoftwareGlyphAtlas::SampleBilinear (float u, float v) const
+{
+    float tx = u * static_cast<float> (m_width)  - 0.5f;
+    float ty = v * static_cast<float> (m_height) - 0.5f;
+    float fx = tx - floorf (tx);
+    float fy = ty - floorf (ty);
+    int   x0 = static_cast<int> (floorf (tx));
+    int   y0 = static_cast<int> (floorf (ty));
+    int   maxX = static_cast<int> (m_width)  - 1;
+    int   maxY = static_cast<int> (m_height) - 1;
+    int   xa = std::clamp (x0,     0, maxX);
+    int   xb = std::clamp (x0 + 1, 0, maxX);
+    int   ya = std::clamp (y0,     0, maxY);
+    int   yb = std::clamp (y0 + 1, 0, maxY);
+    float c00 = Row (ya)[xa];
+    float c10 = Row (ya)[xb];
+    float c01 = Row (yb)[xa];
+    float c11 = Row (yb)[xb];
+    float top    = c00 + (c10 - c00) * fx;
+    float bottom = c01 + (c11 - c01) * fx;
+
+
+
+    return (top + (bottom - top) * fy) * (1.0f / 255.0f);
+}
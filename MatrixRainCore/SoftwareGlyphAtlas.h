@@ -0,0 +1,61 @@
+#pragma once
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SoftwareGlyphAtlas
+//
+//  CPU copy of the rain glyph atlas for the software renderer.  The GPU atlas
+//  is D2D-rendered white text with premultiplied alpha, so every channel of
+//  a texel equals its coverage; one byte per texel is all the CPU path needs.
+//
+//  The texel grid mirrors the layout CharacterSet::Initialize assigns UVs
+//  for (2048x2048, 16x17 cells of 128x120 with 8px padding), so the UVs in
+//  GlyphInfo address the same glyph here as on the GPU.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class SoftwareGlyphAtlas
+{
+public:
+    static constexpr UINT s_kAtlasSize    = 2048;
+    static constexpr UINT s_kGridCols     = 16;
+    static constexpr UINT s_kGridRows     = 17;
+    static constexpr UINT s_kCellWidth    = s_kAtlasSize / s_kGridCols;   // 128
+    static constexpr UINT s_kCellHeight   = s_kAtlasSize / s_kGridRows;   // 120
+    static constexpr UINT s_kGlyphPadding = 8;
+
+    // Zero bytes kept past the last texel so vector kernels can load a
+    // whole 32-bit word at any texel index without running off the end
+    static constexpr UINT s_kSampleSlack  = 4;
+
+    // Deterministic stroke patterns in every cell.  Lets the software path
+    // (and its tests) run with no font stack; the shapes have the same
+    // coverage statistics as real glyphs — mostly empty, thick strokes,
+    // anti-aliased edges.
+    void BuildProcedural();
+
+    // Adopt an existing single-channel coverage image.
+    HRESULT LoadCoverage (UINT width, UINT height, std::span<const uint8_t> coverage);
+
+    // Adopt a premultiplied BGRA image (e.g. a GPU atlas readback); the
+    // alpha channel becomes the coverage.
+    HRESULT LoadPremultipliedBgra (UINT width, UINT height, const uint8_t * pPixels, UINT pitchBytes);
+
+    // Bilinear sample with clamp addressing, matching the rain sampler
+    // (MIN_MAG_MIP_LINEAR, CLAMP, single mip).  Returns coverage in [0,1].
+    float SampleBilinear (float u, float v) const;
+
+    bool                     IsValid()    const { return !m_coverage.empty(); }
+    UINT                     GetWidth()   const { return m_width;             }
+    UINT                     GetHeight()  const { return m_height;            }
+    const uint8_t          * Row (UINT y) const { return m_coverage.data() + size_t (y) * m_width; }
+    std::span<const uint8_t> Coverage()   const { return std::span<const uint8_t> (m_coverage.data(), size_t (m_width) * m_height); }
+
+private:
+    std::vector<uint8_t> m_coverage;
+    UINT                 m_width  { 0 };
+    UINT                 m_height { 0 };
+};
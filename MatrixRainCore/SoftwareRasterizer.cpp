@@ -0,0 +1,125 @@
+#include "pch.h"
+
+#include "SoftwareRasterizer.h"
+#include "SimdFloat4.h"
+#include "SoftwareGlyphAtlas.h"
+#include "SoftwareSurface.h"
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  BlendPixel
+//
+//  src is the saturated shader output.  The result is saturated again on
+//  pack, matching a UNORM render target write.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+static SimdFloat4 BlendPixel (SimdFloat4 src, SimdFloat4 dst, GlyphBlendMode mode)
+{
+    float      srcAlpha = SimdLane (src, 3);
+    SimdFloat4 invAlpha = SimdSplat (1.0f - srcAlpha);
+    SimdFloat4 result;
+    SimdFloat4 srcTerm;
+
+
+
+    switch (mode)
+    {
+        case GlyphBlendMode::Alpha:
+            srcTerm = SimdMul (src, SimdSet (srcAlpha, srcAlpha, srcAlpha, 1.0f));
+            result  = SimdAdd (srcTerm, SimdMul (dst, invAlpha));
+            return SimdSet (SimdLane (result, 0), SimdLane (result, 1), SimdLane (result, 2), srcAlpha);
+
+        case GlyphBlendMode::Premultiplied:
+            result = SimdAdd (src, SimdMul (dst, invAlpha));
+            return SimdSet (SimdLane (result, 0), SimdLane (result, 1), SimdLane (result, 2), srcAlpha);
+
+        case GlyphBlendMode::Additive:
+        default:
+            return SimdAdd (src, dst);
+    }
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  ComputeQuadPixelBounds
+//
+////////////////////////////////////////////////////////////////////////////////
+
+bool ComputeQuadPixelBounds (const GlyphQuad & quad, const PixelRect & clip, PixelRect & bounds)
+{
+    bounds.left   = std::max (clip.left,   static_cast<int> (ceilf (quad.x0 - 0.5f)));
+    bounds.top    = std::max (clip.top,    static_cast<int> (ceilf (quad.y0 - 0.5f)));
+    bounds.right  = std::min (clip.right,  static_cast<int> (ceilf (quad.x1 - 0.5f)));
+    bounds.bottom = std::min (clip.bottom, static_cast<int> (ceilf (quad.y1 - 0.5f)));
+
+    return bounds.left < bounds.right && bounds.top < bounds.bottom;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  RasterizeGlyphQuadReference
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void RasterizeGlyphQuadReference (SoftwareSurface          & target,
+                                  const SoftwareGlyphAtlas & atlas,
+                                  const GlyphQuad          & quad,
+                                  GlyphBlendMode             mode)
+{
+    // Top-left rule: a pixel is covered when its center lies in [x0, x1)
+    int        xStart     = std::max (0, static_cast<int> (ceilf (quad.x0 - 0.5f)));
+    int        yStart     = std::max (0, static_cast<int> (ceilf (quad.y0 - 0.5f)));
+    int        xEnd       = std::min (static_cast<int> (target.GetWidth()),  static_cast<int> (ceilf (quad.x1 - 0.5f)));
+    int        yEnd       = std::min (static_cast<int> (target.GetHeight()), static_cast<int> (ceilf (quad.y1 - 0.5f)));
+    float      quadWidth  = quad.x1 - quad.x0;
+    float      quadHeight = quad.y1 - quad.y0;
+    float      glowScale  = 1.0f + 0.3f * quad.brightness;
+    SimdFloat4 shade      = SimdSet (quad.color[0] * quad.brightness * glowScale,
+                                     quad.color[1] * quad.brightness * glowScale,
+                                     quad.color[2] * quad.brightness * glowScale,
+                                     quad.color[3] * quad.brightness);
+
+
+
+    if (xStart >= xEnd || yStart >= yEnd || quadWidth <= 0.0f || quadHeight <= 0.0f || !atlas.IsValid())
+    {
+        return;
+    }
+
+    for (int y = yStart; y < yEnd; y++)
+    {
+        uint32_t * row = target.Row (static_cast<UINT> (y));
+        float      ty  = (static_cast<float> (y) + 0.5f - quad.y0) / quadHeight;
+        float      v   = quad.v0 + (quad.v1 - quad.v0) * ty;
+
+        for (int x = xStart; x < xEnd; x++)
+        {
+            float tx       = (static_cast<float> (x) + 0.5f - quad.x0) / quadWidth;
+            float u        = quad.u0 + (quad.u1 - quad.u0) * tx;
+            float coverage = atlas.SampleBilinear (u, v);
+
+            if (coverage <= 0.0f)
+            {
+                continue;
+            }
+
+            SimdFloat4 src = SimdSaturate (SimdMul (shade, SimdSplat (coverage)));
+            SimdFloat4 dst = SimdUnpackRgba8 (row[x]);
+
+            row[x] = SimdPackRgba8 (BlendPixel (src, dst, mode));
+        }
+    }
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+
+
+
+class SoftwareGlyphAtlas;
+class SoftwareSurface;
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  GlyphBlendMode
+//
+//  The output-merger configurations the GPU path uses, reproduced on the
+//  CPU.  Alpha channel handling follows the D3D blend descs: the two
+//  "over" modes write src.a (SrcBlendAlpha ONE, DestBlendAlpha ZERO).
+//
+////////////////////////////////////////////////////////////////////////////////
+
+enum class GlyphBlendMode
+{
+    Alpha,              // SrcAlpha / InvSrcAlpha   — rain characters (m_blendState)
+    Premultiplied,      // One      / InvSrcAlpha   — overlay text (m_premultipliedBlendState)
+    Additive            // One      / One           — glow accumulation
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  GlyphQuad
+//
+//  One rain glyph in pixel space, i.e. what the rain vertex shader emits
+//  after projection: an axis-aligned rectangle, its atlas UV rectangle,
+//  the resolved (already scheme-tinted) color and the per-frame brightness.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+struct GlyphQuad
+{
+    float x0;
+    float y0;
+    float x1;
+    float y1;
+    float u0;
+    float v0;
+    float u1;
+    float v1;
+    float color[4];
+    float brightness;
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  PixelRect / ComputeQuadPixelBounds
+//
+//  Half-open pixel rectangle [left, right) x [top, bottom).  The bounds of
+//  a quad are the pixels whose centers it covers under the D3D top-left
+//  fill rule, intersected with a clip rectangle (the target, or one tile
+//  of it).  Returns false when nothing is covered.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+struct PixelRect
+{
+    int left;
+    int top;
+    int right;
+    int bottom;
+};
+
+bool ComputeQuadPixelBounds (const GlyphQuad & quad, const PixelRect & clip, PixelRect & bounds);
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  RasterizeGlyphQuadReference
+//
+//  Straightforward per-pixel reference for one glyph quad.  Covers pixels
+//  using the D3D top-left fill rule, interpolates UVs at pixel centers,
+//  samples the atlas bilinearly and evaluates the rain pixel shader:
+//
+//      src      = color * coverage * brightness
+//      src.rgb += src.rgb * 0.3 * brightness
+//
+//  then saturates (UNORM render target) and blends per mode.  Pixels with
+//  zero coverage are skipped; blending them is a no-op in every mode.
+//
+//  Kept deliberately simple: it is the oracle faster kernels are tested
+//  against, not the production path.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void RasterizeGlyphQuadReference (SoftwareSurface          & target,
+                                  const SoftwareGlyphAtlas & atlas,
+                                  const GlyphQuad          & quad,
+                                  GlyphBlendMode             mode);
@@ -0,0 +1,382 @@
+#include "pch.h"
+
+#include "SoftwareRenderSystem.h"
+#include "AnimationSystem.h"
+#include "ColorScheme.h"
+#include "RainMetrics.h"
+#include "SimdFloat4.h"
+#include "Viewport.h"
+
+
+
+
+
+SoftwareRenderSystem::SoftwareRenderSystem (UINT width, UINT height) :
+    m_workerPool (std::make_unique<WorkerPool> (1))
+{
+    Resize (width, height);
+}
+
+
+
+
+
+void SoftwareRenderSystem::BuildGlyphAtlas()
+{
+    m_atlas.BuildProcedural();
+}
+
+
+
+
+
+HRESULT SoftwareRenderSystem::SetGlyphAtlas (UINT width, UINT height, std::span<const uint8_t> coverage)
+{
+    HRESULT hr = S_OK;
+
+
+
+    hr = m_atlas.LoadCoverage (width, height, coverage);
+    CHR (hr);
+
+Error:
+    return hr;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SoftwareRenderSystem::Render
+//
+//  Draws the scene the way the GPU fills its scene texture (clear to
+//  opaque black, every rain quad back to front with the rain blend state,
+//  serially or across tiles), then runs the bloom chain into the back
+//  surface, or copies the scene across when glow is off.  Either way the
+//  back surface ends up with alpha 1, as the composite shader writes, and
+//  scanlines are applied in that same pass, one darken factor per row, as
+//  the fused composite + scanline shader does.  The clear only touches
+//  the damaged tiles (see UpdateDamage); the result is identical to a full
+//  clear.  Overlays are GPU-only for now.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void SoftwareRenderSystem::Render (const AnimationSystem & animationSystem, const Viewport & viewport, const RenderParams & params)
+{
+    SoftwareBloomSettings  settings;
+    std::span<const float> scanlineRows;
+
+
+
+    settings.intensity         = m_glowIntensity;
+    settings.glowSize          = m_glowSize;
+    settings.blurPasses        = m_blurPasses;
+    settings.resolutionDivisor = m_bloomResolutionDivisor;
+    settings.blurTaps          = m_blurTaps;
+    settings.glowKernel        = m_glowKernel;
+    settings.algorithm         = m_bloomAlgorithm;
+
+    // Same predicate as ShouldRunScanlinePass
+    if (params.scanlinesEnabled)
+    {
+        m_scanlineRows.Update (m_backSurface.GetHeight(), params.scanlinesLineCount, params.scanlinesIntensity);
+        scanlineRows          = m_scanlineRows.GetRows();
+        settings.scanlineRows = scanlineRows;
+    }
+
+    m_quads.clear();
+
+    if (m_atlas.IsValid())
+    {
+        m_instanceStore.Update (animationSystem);
+
+        BuildQuads (viewport, params);
+    }
+
+    UpdateDamage (params.glowEnabled ? SoftwareBloom::ComputeGlowReach (settings) : 0);
+
+    if (m_workerPool->GetThreadCount() > 1)
+    {
+        m_tileRasterizer.Rasterize (*m_workerPool, m_sceneSurface, m_atlas, m_quads, GlyphBlendMode::Alpha);
+    }
+    else
+    {
+        for (const GlyphQuad & quad : m_quads)
+        {
+            m_blitter.Blit (m_sceneSurface, m_atlas, quad, GlyphBlendMode::Alpha);
+        }
+    }
+
+    // Same predicate as ShouldRunBloomPass
+    if (params.glowEnabled)
+    {
+        m_bloom.Apply (*m_workerPool, m_sceneSurface, m_backSurface, settings);
+    }
+    else if (scanlineRows.empty())
+    {
+        std::ranges::transform (m_sceneSurface.Pixels(), m_backSurface.Pixels().begin(), [] (uint32_t pixel)
+        {
+            return pixel | SoftwareSurface::s_kOpaqueBlack;
+        });
+    }
+    else
+    {
+        m_workerPool->ParallelFor (m_sceneSurface.GetHeight(), [&] (UINT y, UINT)
+        {
+            const uint32_t * in     = m_sceneSurface.Row (y);
+            uint32_t       * out    = m_backSurface.Row (y);
+            SimdFloat4       rowMul = SimdSet (scanlineRows[y], scanlineRows[y], scanlineRows[y], 1.0f);
+
+            for (UINT x = 0; x < m_sceneSurface.GetWidth(); x++)
+            {
+                out[x] = SimdPackRgba8 (SimdMul (SimdUnpackRgba8 (in[x] | SoftwareSurface::s_kOpaqueBlack), rowMul));
+            }
+        });
+    }
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SoftwareRenderSystem::UpdateDamage
+//
+//  Feeds this frame's glyph rectangles to the damage tracker and clears
+//  the scene only under the damaged tiles.  Everything else is still the
+//  opaque black it was cleared to, because the last frame's glyphs are
+//  inside the damage too.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void SoftwareRenderSystem::UpdateDamage (int reach)
+{
+    PixelRect target = { 0, 0, static_cast<int> (m_sceneSurface.GetWidth()), static_cast<int> (m_sceneSurface.GetHeight()) };
+
+
+
+    m_glyphRects.clear();
+
+    for (const GlyphQuad & quad : m_quads)
+    {
+        PixelRect bounds;
+
+        if (ComputeQuadPixelBounds (quad, target, bounds))
+        {
+            m_glyphRects.push_back (bounds);
+        }
+    }
+
+    m_damage.Update (m_glyphRects, reach);
+
+    for (const PixelRect & rect : m_damage.GetDirtyRects())
+    {
+        for (int y = rect.top; y < rect.bottom; y++)
+        {
+            uint32_t * row = m_sceneSurface.Row (static_cast<UINT> (y));
+
+            std::fill (row + rect.left, row + rect.right, SoftwareSurface::s_kOpaqueBlack);
+        }
+    }
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SoftwareRenderSystem::BuildQuads
+//
+//  CPU version of the rain vertex shader: resolves each stream entry's
+//  slot, applies the scheme tint, scales the base quad and projects its
+//  corners to render-target pixels.  The projection is a 2D orthographic
+//  transform, so projecting the two opposite corners is exact.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void SoftwareRenderSystem::BuildQuads (const Viewport & viewport, const RenderParams & params)
+{
+    const Matrix4x4                        & projection     = viewport.GetProjectionMatrix();
+    const std::vector<RainInstanceStatic>  & slots          = m_instanceStore.GetSlots();
+    Color4                                   schemeColor    = ResolveSchemeColor (params.colorScheme, params.elapsedTime, params.customColor);
+    float                                    characterScale = ComputeRainCharacterScale (viewport.GetHeight(), m_dpiScale, m_characterScaleOverride);
+    float                                    targetWidth    = static_cast<float> (m_backSurface.GetWidth());
+    float                                    targetHeight   = static_cast<float> (m_backSurface.GetHeight());
+    float                                    scheme[4]      = { schemeColor.r, schemeColor.g, schemeColor.b, schemeColor.a };
+
+    auto toPixelX = [&] (float x, float y)
+    {
+        float ndcX = projection.m[0][0] * x + projection.m[1][0] * y + projection.m[3][0];
+
+        return (ndcX + 1.0f) * 0.5f * targetWidth;
+    };
+
+    auto toPixelY = [&] (float x, float y)
+    {
+        float ndcY = projection.m[0][1] * x + projection.m[1][1] * y + projection.m[3][1];
+
+        return (1.0f - ndcY) * 0.5f * targetHeight;
+    };
+
+
+
+    m_quads.clear();
+    m_quads.reserve (m_instanceStore.GetStream().size());
+
+    for (const RainInstanceStream & entry : m_instanceStore.GetStream())
+    {
+        const RainInstanceStatic & record = slots[entry.slot];
+        float                      left   = record.position[0];
+        float                      top    = record.position[1];
+        float                      right  = left + s_kRainCharWidth  * record.scale[0] * characterScale;
+        float                      bottom = top  + s_kRainCharHeight * record.scale[1] * characterScale;
+        GlyphQuad                  quad;
+
+
+
+        quad.x0         = toPixelX (left,  top);
+        quad.y0         = toPixelY (left,  top);
+        quad.x1         = toPixelX (right, bottom);
+        quad.y1         = toPixelY (right, bottom);
+        quad.u0         = record.uvMin[0];
+        quad.v0         = record.uvMin[1];
+        quad.u1         = record.uvMax[0];
+        quad.v1         = record.uvMax[1];
+        quad.brightness = entry.brightness;
+
+        for (int i = 0; i < 3; i++)
+        {
+            quad.color[i] = record.color[i] + (scheme[i] - record.color[i]) * record.schemeTint;
+        }
+
+        quad.color[3] = record.color[3];
+
+        m_quads.push_back (quad);
+    }
+}
+
+
+
+
+
+HRESULT SoftwareRenderSystem::Present()
+{
+    m_frontSurface.Swap (m_backSurface);
+    m_presentCount++;
+
+    return S_OK;
+}
+
+
+
+
+
+void SoftwareRenderSystem::Resize (UINT width, UINT height)
+{
+    m_sceneSurface.Resize (width, height);
+    m_backSurface.Resize  (width, height);
+    m_frontSurface.Resize (width, height);
+    m_damage.Resize       (width, height);
+}
+
+
+
+
+
+void SoftwareRenderSystem::OnDpiChanged (UINT dpi)
+{
+    m_dpiScale = static_cast<float> (dpi) / 96.0f;
+}
+
+
+
+
+
+void SoftwareRenderSystem::SetGlowIntensity (int intensityPercent)
+{
+    // Same mapping as RenderSystem: 100% = 2.5 multiplier
+    m_glowIntensity = (intensityPercent / 100.0f) * 2.5f;
+}
+
+
+
+
+
+void SoftwareRenderSystem::SetGlowSize (int sizePercent)
+{
+    m_glowSize = sizePercent / 100.0f;
+}
+
+
+
+
+
+void SoftwareRenderSystem::SetBlurPasses (int passes)
+{
+    m_blurPasses = passes;
+}
+
+
+void SoftwareRenderSystem::SetBloomResolution (int divisor)
+{
+    switch (divisor)
+    {
+        case 1:  m_bloomResolutionDivisor = ResolutionDivisor::Full;    break;
+        case 4:  m_bloomResolutionDivisor = ResolutionDivisor::Quarter; break;
+        case 8:  m_bloomResolutionDivisor = ResolutionDivisor::Eighth;  break;
+        case 2:
+        default: m_bloomResolutionDivisor = ResolutionDivisor::Half;    break;
+    }
+}
+
+
+void SoftwareRenderSystem::SetBlurTaps (int taps)
+{
+    switch (taps)
+    {
+        case 5:  m_blurTaps = BlurTaps::Low;    break;
+        case 9:  m_blurTaps = BlurTaps::Medium; break;
+        case 13:
+        default: m_blurTaps = BlurTaps::High;   break;
+    }
+}
+
+
+void SoftwareRenderSystem::SetBloomAlgorithm (int algorithm)
+{
+    switch (algorithm)
+    {
+        case 1:  m_bloomAlgorithm = BloomAlgorithm::DualFilter; break;
+        case 0:
+        default: m_bloomAlgorithm = BloomAlgorithm::Gaussian;   break;
+    }
+}
+
+
+
+
+
+void SoftwareRenderSystem::SetCharacterScaleOverride (float scale)
+{
+    m_characterScaleOverride = scale;
+}
+
+
+
+
+
+void SoftwareRenderSystem::SetRasterThreadCount (UINT threadCount)
+{
+    UINT threads = std::max (1u, threadCount);
+
+
+
+    if (m_workerPool->GetThreadCount() != threads)
+    {
+        m_workerPool = std::make_unique<WorkerPool> (threads);
+    }
+}
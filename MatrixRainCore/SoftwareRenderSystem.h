@@ -0,0 +1,130 @@
+#pragma once
+
+#include "DamageTracker.h"
+#include "GlyphBlitter.h"
+#include "IRenderSystem.h"
+#include "InstanceStore.h"
+#include "QualityPresets.h"
+#include "ScanlineAttenuation.h"
+#include "SoftwareBloom.h"
+#include "SoftwareGlyphAtlas.h"
+#include "SoftwareRasterizer.h"
+#include "SoftwareSurface.h"
+#include "TileRasterizer.h"
+#include "WorkerPool.h"
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SoftwareRenderSystem
+//
+//  CPU implementation of IRenderSystem.  Rasterizes the same instanced rain
+//  quads as RenderSystem into an in-memory RGBA8 framebuffer, so frames can
+//  be inspected and render cost measured on machines with no GPU (headless
+//  build agents, tests).
+//
+//  Quads come from the same InstanceStore the GPU path uploads from and are
+//  placed with the same projection and RainMetrics scale, so the scene
+//  surface lines up pixel for pixel with the GPU scene texture.  Bloom
+//  (SoftwareBloom) then composites it into the back surface.
+//
+//  Present() swaps the back surface to the front; the presented frame is
+//  readable through GetPresentedSurface().
+//
+//  SetRasterThreadCount() > 1 gives rasterization (tile-binned, via
+//  TileRasterizer) and bloom a worker pool; the frame is bit-identical
+//  either way.
+//
+//  GetDamage() reports the 64x64 tiles each frame could have changed (this
+//  and the last frame's glyphs, grown by the glow reach); the scene clear
+//  is limited to them.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class SoftwareRenderSystem : public IRenderSystem
+{
+public:
+    SoftwareRenderSystem (UINT width, UINT height);
+
+    // Procedural atlas; no font stack required
+    void BuildGlyphAtlas();
+
+    // Replace the atlas with real glyph coverage (e.g. a GPU atlas readback)
+    HRESULT SetGlyphAtlas (UINT width, UINT height, std::span<const uint8_t> coverage);
+
+    void Render (const AnimationSystem & animationSystem, const Viewport & viewport, const RenderParams & params) override;
+
+    HRESULT Present() override;
+
+    void Resize (UINT width, UINT height) override;
+
+    void OnDpiChanged (UINT dpi) override;
+
+    void SetGlowIntensity (int intensityPercent) override;
+
+    void SetGlowSize (int sizePercent) override;
+
+    void SetBlurPasses      (int passes)    override;
+    void SetBloomResolution (int divisor)   override;
+    void SetBlurTaps        (int taps)      override;
+    void SetBloomAlgorithm  (int algorithm) override;
+
+    void SetCharacterScaleOverride (float scale) override;
+
+    // Threads used to render a frame, including the render thread
+    void SetRasterThreadCount (UINT threadCount);
+
+    void SetGlowKernel (GlowKernel kernel) { m_glowKernel = kernel; }
+
+    float GetDpiScale() const override { return m_dpiScale; }
+
+    // Accessors
+    const SoftwareSurface    & GetSceneSurface()      const { return m_sceneSurface;  }
+    const SoftwareSurface    & GetPresentedSurface()  const { return m_frontSurface;  }
+    const SoftwareSurface    & GetBackSurface()       const { return m_backSurface;   }
+    const SoftwareGlyphAtlas & GetGlyphAtlas()        const { return m_atlas;         }
+    const InstanceStore      & GetInstanceStore()     const { return m_instanceStore; }
+    const SoftwareBloom      & GetBloom()             const { return m_bloom;         }
+    const DamageTracker      & GetDamage()            const { return m_damage;        }
+    BlitPath                   GetBlitPath()          const { return m_blitter.GetPath(); }
+    std::span<const GlyphQuad> GetQuads()             const { return m_quads;         }
+    uint64_t                   GetPresentCount()      const { return m_presentCount;  }
+    UINT                       GetRasterThreadCount() const { return m_workerPool->GetThreadCount(); }
+
+private:
+    void BuildQuads   (const Viewport & viewport, const RenderParams & params);
+    void UpdateDamage (int reach);
+
+    InstanceStore               m_instanceStore;
+    GlyphBlitter                m_blitter;
+    TileRasterizer              m_tileRasterizer;
+    SoftwareBloom               m_bloom;
+    std::unique_ptr<WorkerPool> m_workerPool;
+    SoftwareGlyphAtlas          m_atlas;
+    SoftwareSurface             m_sceneSurface;
+    SoftwareSurface             m_backSurface;
+    SoftwareSurface             m_frontSurface;
+    std::vector<GlyphQuad>      m_quads;
+    ScanlineAttenuationTable    m_scanlineRows;
+    DamageTracker               m_damage;
+    std::vector<PixelRect>      m_glyphRects;
+    uint64_t                    m_presentCount { 0 };
+
+    // DPI scale factor (1.0 at 96 DPI / 100%)
+    float m_dpiScale { 1.0f };
+
+    // Post-processing settings, mirrored from RenderSystem so the software
+    // path tracks the same shared-state broadcasts
+    float             m_glowIntensity           { 2.5f };
+    float             m_glowSize                { 1.0f };
+    int               m_blurPasses              { 3 };
+    ResolutionDivisor m_bloomResolutionDivisor  { ResolutionDivisor::Half };
+    BlurTaps          m_blurTaps                { BlurTaps::High };
+    GlowKernel        m_glowKernel              { GlowKernel::Gaussian };
+    BloomAlgorithm    m_bloomAlgorithm          { BloomAlgorithm::Gaussian };
+
+    // Character scale override (bypasses viewport-based scaling when set)
+    std::optional<float> m_characterScaleOverride;
+};
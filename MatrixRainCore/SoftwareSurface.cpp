@@ -0,0 +1,35 @@
+#include "pch.h"
+
+#include "SoftwareSurface.h"
+
+
+
+
+
+void SoftwareSurface::Resize (UINT width, UINT height)
+{
+    m_width  = width;
+    m_height = height;
+
+    m_pixels.assign (size_t (width) * height, s_kOpaqueBlack);
+}
+
+
+
+
+
+void SoftwareSurface::Clear (uint32_t rgba)
+{
+    std::fill (m_pixels.begin(), m_pixels.end(), rgba);
+}
+
+
+
+
+
+void SoftwareSurface::Swap (SoftwareSurface & other) noexcept
+{
+    std::swap (m_pixels, other.m_pixels);
+    std::swap (m_width,  other.m_width);
+    std::swap (m_height, other.m_height);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SoftwareSurface
+//
+//  In-memory RGBA8 render target for the software renderer.  One packed
+//  uint32_t per pixel, R in the low byte (R8G8B8A8_UNORM memory order),
+//  rows tightly packed top to bottom.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class SoftwareSurface
+{
+public:
+    static constexpr uint32_t s_kOpaqueBlack = 0xFF000000;
+
+    void Resize (UINT width, UINT height);
+    void Clear  (uint32_t rgba);
+    void Swap   (SoftwareSurface & other) noexcept;
+
+    UINT                      GetWidth()              const { return m_width;                          }
+    UINT                      GetHeight()             const { return m_height;                         }
+    uint32_t                * Row (UINT y)                  { return m_pixels.data() + size_t (y) * m_width; }
+    const uint32_t          * Row (UINT y)            const { return m_pixels.data() + size_t (y) * m_width; }
+    uint32_t                  GetPixel (UINT x, UINT y) const { return Row (y)[x];                       }
+    std::span<const uint32_t> Pixels()                const { return m_pixels;                         }
+    std::span<uint32_t>       Pixels()                      { return m_pixels;                         }
+
+private:
+    std::vector<uint32_t> m_pixels;
+    UINT                  m_width  { 0 };
+    UINT                  m_height { 0 };
+};
@@ -0,0 +1,111 @@
+#pragma once
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  SpscQueue<T, Capacity>
+//
+//  Bounded lock-free single-producer / single-consumer ring.  Exactly one
+//  thread may call TryPush and exactly one (other) thread may call TryPop;
+//  neither ever blocks or takes a lock, so a UI thread can hand work to a
+//  render thread without waiting out a frame.
+//
+//  Head and tail are free-running counters masked into the ring, so full
+//  and empty are distinguished without a spare slot.  Each side keeps a
+//  private copy of the other side's index and only re-reads the shared one
+//  when that copy says the ring is full (producer) or empty (consumer),
+//  which keeps the two cache lines from bouncing on every call.
+//
+//  Capacity must be a power of two.  A consumer handoff (e.g. the render
+//  thread being joined and restarted) is safe as long as the old consumer
+//  has finished before the new one starts.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma warning(push)
+#pragma warning(disable: 4324)  // structure was padded due to alignment specifier
+
+template <typename T, size_t Capacity>
+class SpscQueue
+{
+    static_assert (Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+    static_assert (std::is_trivially_copyable_v<T>,                    "SpscQueue element must be trivially copyable");
+
+public:
+    SpscQueue() = default;
+
+    SpscQueue (const SpscQueue &)             = delete;
+    SpscQueue & operator= (const SpscQueue &) = delete;
+
+    // Producer only.  Returns false (and drops nothing) when the ring is full.
+    bool TryPush (const T & value)
+    {
+        size_t tail = m_tail.load (std::memory_order_relaxed);
+
+
+
+        if (tail - m_producerHead == Capacity)
+        {
+            m_producerHead = m_head.load (std::memory_order_acquire);
+
+            if (tail - m_producerHead == Capacity)
+            {
+                return false;
+            }
+        }
+
+        m_slots[tail & s_kMask] = value;
+        m_tail.store (tail + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // Consumer only.  Returns false when the ring is empty.
+    bool TryPop (T & value)
+    {
+        size_t head = m_head.load (std::memory_order_relaxed);
+
+
+
+        if (head == m_consumerTail)
+        {
+            m_consumerTail = m_tail.load (std::memory_order_acquire);
+
+            if (head == m_consumerTail)
+            {
+                return false;
+            }
+        }
+
+        value = m_slots[head & s_kMask];
+        m_head.store (head + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // Approximate from any thread other than the consumer; exact on it
+    bool IsEmpty() const
+    {
+        return m_head.load (std::memory_order_acquire) == m_tail.load (std::memory_order_acquire);
+    }
+
+    static constexpr size_t GetCapacity() { return Capacity; }
+
+private:
+    static constexpr size_t s_kMask      = Capacity - 1;
+    static constexpr size_t s_kCacheLine = 64;
+
+    // Consumer-owned line
+    alignas (s_kCacheLine) std::atomic<size_t> m_head         { 0 };
+    size_t                                     m_consumerTail { 0 };
+
+    // Producer-owned line
+    alignas (s_kCacheLine) std::atomic<size_t> m_tail         { 0 };
+    size_t                                     m_producerHead { 0 };
+
+    alignas (s_kCacheLine) std::array<T, Capacity> m_slots {};
+};
+
+#pragma warning(pop)
@@ -0,0 +1,116 @@
+#include "pch.h"
+
+#include "TileBinner.h"
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  TileBinner::Bin
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void TileBinner::Bin (std::span<const GlyphQuad> quads, UINT width, UINT height)
+{
+    PixelRect tiles;
+
+
+
+    m_width  = width;
+    m_height = height;
+    m_tilesX = (width  + s_kTileSize - 1) / s_kTileSize;
+    m_tilesY = (height + s_kTileSize - 1) / s_kTileSize;
+
+    m_tileOffsets.assign (size_t (GetTileCount()) + 1, 0);
+
+    // Count references per tile (offset by one for the prefix sum)
+    for (const GlyphQuad & quad : quads)
+    {
+        if (!ComputeTileRange (quad, tiles))
+        {
+            continue;
+        }
+
+        for (int ty = tiles.top; ty < tiles.bottom; ty++)
+        {
+            for (int tx = tiles.left; tx < tiles.right; tx++)
+            {
+                m_tileOffsets[size_t (ty) * m_tilesX + tx + 1]++;
+            }
+        }
+    }
+
+    for (size_t i = 1; i < m_tileOffsets.size(); i++)
+    {
+        m_tileOffsets[i] += m_tileOffsets[i - 1];
+    }
+
+    // Scatter in quad order so every bin stays back to front
+    m_tileCursor.assign (m_tileOffsets.begin(), m_tileOffsets.end() - 1);
+    m_quadIndices.resize (m_tileOffsets.back());
+
+    for (uint32_t i = 0; i < quads.size(); i++)
+    {
+        if (!ComputeTileRange (quads[i], tiles))
+        {
+            continue;
+        }
+
+        for (int ty = tiles.top; ty < tiles.bottom; ty++)
+        {
+            for (int tx = tiles.left; tx < tiles.right; tx++)
+            {
+                m_quadIndices[m_tileCursor[size_t (ty) * m_tilesX + tx]++] = i;
+            }
+        }
+    }
+}
+
+
+
+
+
+bool TileBinner::ComputeTileRange (const GlyphQuad & quad, PixelRect & tiles) const
+{
+    PixelRect target = { 0, 0, static_cast<int> (m_width), static_cast<int> (m_height) };
+    PixelRect pixels;
+
+
+
+    if (!ComputeQuadPixelBounds (quad, target, pixels))
+    {
+        return false;
+    }
+
+    tiles.left   = pixels.left / s_kTileSize;
+    tiles.top    = pixels.top  / s_kTileSize;
+    tiles.right  = (pixels.right  - 1) / s_kTileSize + 1;
+    tiles.bottom = (pixels.bottom - 1) / s_kTileSize + 1;
+
+    return true;
+}
+
+
+
+
+
+PixelRect TileBinner::GetTileRect (UINT tile) const
+{
+    int left = static_cast<int> (tile % m_tilesX) * s_kTileSize;
+    int top  = static_cast<int> (tile / m_tilesX) * s_kTileSize;
+
+
+
+    return { left, top, std::min (left + s_kTileSize, static_cast<int> (m_width)), std::min (top + s_kTileSize, static_cast<int> (m_height)) };
+}
+
+
+
+
+
+std::span<const uint32_t> TileBinner::GetTileQuads (UINT tile) const
+{
+    return std::span<const uint32_t> (m_quadIndices.data() + m_tileOffsets[tile], m_tileOffsets[tile + 1] - m_tileOffsets[tile]);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "SoftwareRasterizer.h"
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  TileBinner
+//
+//  Sorts a frame's glyph quads into 64x64 screen tiles.  Each tile gets the
+//  indices of every quad whose covered pixels touch it, in the original
+//  (back-to-front) order, so a tile can be rasterized on its own and still
+//  blend exactly as a serial pass over the whole frame would.
+//
+//  Bins are stored as one flat index array plus per-tile offsets, built
+//  with a count / prefix-sum / scatter pass, so binning allocates nothing
+//  once the arrays have grown to the frame's size.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class TileBinner
+{
+public:
+    static constexpr int s_kTileSize = 64;
+
+    void Bin (std::span<const GlyphQuad> quads, UINT width, UINT height);
+
+    UINT                      GetTilesX()     const { return m_tilesX;          }
+    UINT                      GetTilesY()     const { return m_tilesY;          }
+    UINT                      GetTileCount()  const { return m_tilesX * m_tilesY; }
+    PixelRect                 GetTileRect (UINT tile) const;
+    std::span<const uint32_t> GetTileQuads (UINT tile) const;
+
+    // Total tile references; quads straddling tile edges count once per tile
+    size_t                    GetBinnedCount() const { return m_quadIndices.size(); }
+
+private:
+    // Tile range a quad touches, or false when it covers no pixels
+    bool ComputeTileRange (const GlyphQuad & quad, PixelRect & tiles) const;
+
+    UINT                  m_width  { 0 };
+    UINT                  m_height { 0 };
+    UINT                  m_tilesX { 0 };
+    UINT                  m_tilesY { 0 };
+    std::vector<uint32_t> m_tileOffsets;      // GetTileCount() + 1 entries
+    std::vector<uint32_t> m_tileCursor;       // Scatter write positions
+    std::vector<uint32_t> m_quadIndices;
+};
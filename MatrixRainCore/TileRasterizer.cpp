@@ -0,0 +1,47 @@
+#include "pch.h"
+
+#include "TileRasterizer.h"
+#include "SoftwareGlyphAtlas.h"
+#include "SoftwareSurface.h"
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  TileRasterizer::Rasterize
+//
+//  Bins the frame, then rasterizes it one tile per pool item.  Tiles are
+//  claimed one at a time so a dense band of rain does not leave the other
+//  threads idle.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void TileRasterizer::Rasterize (WorkerPool & pool, SoftwareSurface & target, const SoftwareGlyphAtlas & atlas, std::span<const GlyphQuad> quads, GlyphBlendMode mode)
+{
+    m_binner.Bin (quads, target.GetWidth(), target.GetHeight());
+
+    if (m_blitters.size() < pool.GetThreadCount())
+    {
+        m_blitters.resize (pool.GetThreadCount());
+    }
+
+    pool.ParallelFor (m_binner.GetTileCount(), [&] (UINT tile, UINT threadIndex)
+    {
+        std::span<const uint32_t> bin = m_binner.GetTileQuads (tile);
+
+        if (bin.empty())
+        {
+            return;
+        }
+
+        PixelRect      clip    = m_binner.GetTileRect (tile);
+        GlyphBlitter & blitter = m_blitters[threadIndex];
+
+        for (uint32_t index : bin)
+        {
+            blitter.Blit (target, atlas, quads[index], mode, clip);
+        }
+    });
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "GlyphBlitter.h"
+#include "SoftwareRasterizer.h"
+#include "TileBinner.h"
+#include "WorkerPool.h"
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  TileRasterizer
+//
+//  Parallel front end for GlyphBlitter.  Each frame the quads are binned
+//  into 64x64 tiles, then the threads of a WorkerPool claim whole tiles and
+//  draw every quad in the tile's bin, clipped to the tile.
+//
+//  A tile is only ever touched by the thread that claimed it and its bin is
+//  in back-to-front order, so no framebuffer locks are needed and the
+//  result is bit-identical to a serial pass.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class TileRasterizer
+{
+public:
+    void Rasterize (WorkerPool & pool, SoftwareSurface & target, const SoftwareGlyphAtlas & atlas, std::span<const GlyphQuad> quads, GlyphBlendMode mode);
+
+    const TileBinner & GetBinner() const { return m_binner; }
+
+private:
+    TileBinner                m_binner;
+    std::vector<GlyphBlitter> m_blitters;      // One per pool thread
+};
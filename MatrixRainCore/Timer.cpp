@@ -8,11 +8,6 @@
 
 Timer::Timer()
 {
-    // Query the performance counter frequency (ticks per second)
-    LARGE_INTEGER freq;
-    QueryPerformanceFrequency(&freq);
-    m_frequency = freq.QuadPart;
-
     // Initialize start time
     Start();
 }
@@ -23,7 +18,7 @@ Timer::Timer()
 
 void Timer::Start()
 {
-    m_startTime = GetCurrentTime();
+    m_startTicks = Timestamp::Read();
 }
 
 
@@ -32,10 +27,7 @@ void Timer::Start()
 
 double Timer::GetElapsedSeconds() const
 {
-    long long currentTime = GetCurrentTime();
-    long long elapsed     = currentTime - m_startTime;
-
-    return static_cast<double> (elapsed) / static_cast<double> (m_frequency);
+    return ToSeconds (GetElapsed());
 }
 
 
@@ -44,27 +36,23 @@ double Timer::GetElapsedSeconds() const
 
 double Timer::GetElapsedMilliseconds() const
 {
-    return GetElapsedSeconds() * 1000.0;
+    return ToMilliseconds (GetElapsed());
 }
 
 
 
 
 
-void Timer::Reset()
+FrameClock::duration Timer::GetElapsed() const
 {
-    m_startTime = GetCurrentTime();
+    return ElapsedSince (m_startTicks);
 }
 
 
 
 
 
-long long Timer::GetCurrentTime() const
+void Timer::Reset()
 {
-    LARGE_INTEGER counter;
-
-    QueryPerformanceCounter (&counter);
-    
-    return counter.QuadPart;
+    m_startTicks = Timestamp::Read();
 }
@@ -1,10 +1,12 @@
 #pragma once
 
+#include "FrameClock.h"
 
 
 
 
-// Timer: High-resolution timer utility using QueryPerformanceCounter
+
+// Timer: High-resolution timer utility using Timestamp (portable; the TSC when enabled)
 // Provides precise timing for animation delta times and performance measurement
 class Timer
 {
@@ -20,15 +22,14 @@ public:
     // Get elapsed time in milliseconds since Start() was called
     double GetElapsedMilliseconds() const;
 
+    // Get elapsed time since Start() was called
+    FrameClock::duration GetElapsed() const;
+
     // Reset the timer to zero
     void Reset();
 
     
 
 private:
-    long long m_startTime { 0 };
-    long long m_frequency { 0 };
-
-    // Get current high-resolution timestamp
-    long long GetCurrentTime() const;
+    uint64_t m_startTicks { 0 };
 };
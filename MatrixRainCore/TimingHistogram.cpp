@@ -0,0 +1,175 @@
+#include "pch.h"
+
+#include "TimingHistogram.h"
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  TimingHistogram::BucketIndex
+//
+//  Below s_kLinearLimit the value is its own index.  Above it, shift is
+//  chosen so value >> shift lands in [32, 64): the shift selects the
+//  power-of-two band and the shifted value the sub-bucket within it.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+size_t TimingHistogram::BucketIndex (int64_t microseconds)
+{
+    uint64_t value = static_cast<uint64_t> (std::max<int64_t> (microseconds, 0));
+    uint32_t shift = 0;
+
+
+
+    if (value < s_kLinearLimit)
+    {
+        return static_cast<size_t> (value);
+    }
+
+    // [64, 128) -> 1, [128, 256) -> 2, ...
+    shift = static_cast<uint32_t> (std::bit_width (value / s_kLinearLimit));
+
+    if (shift > s_kShiftCount)
+    {
+        return s_kBucketCount - 1;
+    }
+
+    return s_kLinearLimit + (shift - 1) * s_kSubBucketCount + static_cast<size_t> ((value >> shift) - s_kSubBucketCount);
+}
+
+
+
+
+
+int64_t TimingHistogram::BucketLowerBound (size_t index)
+{
+    size_t   band = 0;
+    uint64_t sub  = 0;
+
+
+
+    if (index < s_kLinearLimit)
+    {
+        return static_cast<int64_t> (index);
+    }
+
+    band = (index - s_kLinearLimit) / s_kSubBucketCount;
+    sub  = (index - s_kLinearLimit) % s_kSubBucketCount + s_kSubBucketCount;
+
+    return static_cast<int64_t> (sub << (band + 1));
+}
+
+
+
+
+
+int64_t TimingHistogram::BucketUpperBound (size_t index)
+{
+    if (index < s_kLinearLimit)
+    {
+        return static_cast<int64_t> (index);
+    }
+
+    return BucketLowerBound (index + 1) - 1;
+}
+
+
+
+
+
+void TimingHistogram::Record (int64_t microseconds)
+{
+    int64_t value = std::max<int64_t> (microseconds, 0);
+
+
+
+    m_counts[BucketIndex (value)]++;
+
+    m_min    = m_count ? std::min (m_min, value) : value;
+    m_max    = std::max (m_max, value);
+    m_total += value;
+    m_count++;
+}
+
+
+
+
+
+void TimingHistogram::Merge (const TimingHistogram & other)
+{
+    if (other.m_count == 0)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < s_kBucketCount; i++)
+    {
+        m_counts[i] += other.m_counts[i];
+    }
+
+    m_min    = m_count ? std::min (m_min, other.m_min) : other.m_min;
+    m_max    = std::max (m_max, other.m_max);
+    m_total += other.m_total;
+    m_count += other.m_count;
+}
+
+
+
+
+
+void TimingHistogram::Reset()
+{
+    *this = TimingHistogram {};
+}
+
+
+
+
+
+double TimingHistogram::GetMean() const
+{
+    return m_count ? static_cast<double> (m_total) / static_cast<double> (m_count) : 0.0;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  TimingHistogram::GetPercentile
+//
+//  Nearest-rank: the smallest bucket whose cumulative count reaches
+//  ceil (percentile / 100 * count), reported as that bucket's upper bound.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+int64_t TimingHistogram::GetPercentile (double percentile) const
+{
+    uint64_t rank       = 0;
+    uint64_t cumulative = 0;
+
+
+
+    if (m_count == 0)
+    {
+        return 0;
+    }
+
+    rank = static_cast<uint64_t> (ceil (std::clamp (percentile, 0.0, 100.0) / 100.0 * static_cast<double> (m_count)));
+    rank = std::max<uint64_t> (rank, 1);
+
+    for (size_t i = 0; i < s_kBucketCount; i++)
+    {
+        cumulative += m_counts[i];
+
+        if (cumulative >= rank)
+        {
+            return std::clamp (BucketUpperBound (i), m_min, m_max);
+        }
+    }
+
+    return m_max;
+}
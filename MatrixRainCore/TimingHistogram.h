@@ -0,0 +1,58 @@
+#pragma once
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  TimingHistogram
+//
+//  Fixed-size log-linear histogram of durations in microseconds, in the
+//  style of HdrHistogram: values below 64 us get one bucket each; above
+//  that every power of two is split into 32 equal sub-buckets, so any
+//  recorded value is reported to within 1/32 (about 3%) of itself.  The
+//  top bucket ends at about 67 s; larger values are clamped into it.
+//
+//  Recording is a handful of integer operations with no allocation, so a
+//  render thread can record several timings per frame.  The histogram is
+//  trivially copyable, so a snapshot is a plain copy.  Not thread-safe:
+//  one thread records, and anything else works on a copy.
+//
+//  Percentiles report the highest value that shares the bucket of the
+//  ranked sample, capped at the exact recorded maximum: never an
+//  underestimate, and never more than one sub-bucket high.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class TimingHistogram
+{
+public:
+    static constexpr uint32_t s_kLinearLimit    = 64;
+    static constexpr uint32_t s_kSubBucketCount = 32;
+    static constexpr uint32_t s_kShiftCount     = 20;
+    static constexpr size_t   s_kBucketCount    = s_kLinearLimit + s_kShiftCount * s_kSubBucketCount;
+
+    static size_t  BucketIndex      (int64_t microseconds);
+    static int64_t BucketLowerBound (size_t index);
+    static int64_t BucketUpperBound (size_t index);
+
+    void Record (int64_t microseconds);
+    void Merge  (const TimingHistogram & other);
+    void Reset();
+
+    // percentile in [0, 100]; 0 when nothing has been recorded
+    int64_t GetPercentile (double percentile) const;
+
+    uint64_t GetCount()                    const { return m_count;             }
+    int64_t  GetMin()                      const { return m_count ? m_min : 0; }
+    int64_t  GetMax()                      const { return m_max;               }
+    uint32_t GetBucketCount (size_t index) const { return m_counts[index];     }
+    double   GetMean()                     const;
+
+private:
+    std::array<uint32_t, s_kBucketCount> m_counts {};
+    uint64_t                             m_count  { 0 };
+    int64_t                              m_total  { 0 };
+    int64_t                              m_min    { 0 };
+    int64_t                              m_max    { 0 };
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  Uniform draws from a seeded generator
+//
+//  std::mt19937 is fully specified, but std::uniform_real_distribution and
+//  std::uniform_int_distribution are not: MSVC's STL and libstdc++ turn
+//  the same engine output into different values.  The simulation draws
+//  through these instead, so a seed (--seed, AnimationSystem::Seed) gives
+//  the same rain under every standard library, and the golden references
+//  hold whichever toolchain runs the suite.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+// Float in [minValue, maxValue): the top 24 bits of one draw, which is
+// exactly a float's precision
+inline float UniformReal (std::mt19937 & generator, float minValue, float maxValue)
+{
+    float unit = static_cast<float> (generator() >> 8) * (1.0f / 16777216.0f);
+
+
+
+    return minValue + (maxValue - minValue) * unit;
+}
+
+
+
+
+// Integer in [minValue, maxValue], by multiply-shift of one draw.  The bias
+// is under range / 2^32, far below anything the rain could show.
+inline size_t UniformIndex (std::mt19937 & generator, size_t minValue, size_t maxValue)
+{
+    uint64_t range = static_cast<uint64_t> (maxValue - minValue) + 1;
+
+
+
+    return minValue + static_cast<size_t> ((static_cast<uint64_t> (generator()) * range) >> 32);
+}
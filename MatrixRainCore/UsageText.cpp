@@ -27,10 +27,16 @@ UsageText::UsageText (std::wstring_view switchPrefix) :
 
     m_switches =
     {
-        { L'?',  L"",          L"", L"Display this help message"                   },
-        { L'\0', L"install",   L"", L"Install MatrixRain as system screensaver"    },
-        { L'\0', L"uninstall", L"", L"Uninstall MatrixRain screensaver"            },
-        { L'\0', L"force",     L"", L"Skip policy checks during install"           },
+        { L'?',  L"",          L"",        L"Display this help message"                   },
+        { L'\0', L"install",   L"",        L"Install MatrixRain as system screensaver"    },
+        { L'\0', L"uninstall", L"",        L"Uninstall MatrixRain screensaver"            },
+        { L'\0', L"force",     L"",        L"Skip policy checks during install"           },
+        { L'\0', L"record",    L"<file>",  L"Render headlessly to a .y4m or .ppm file"    },
+        { L'\0', L"size",      L"<W>x<H>", L"Recording size (default 1920x1080)"          },
+        { L'\0', L"frames",    L"<N>",     L"Frames to record (default 600)"              },
+        { L'\0', L"fps",       L"<N>",     L"Recording frame rate (default 60)"           },
+        { L'\0', L"seed",      L"<N>",     L"Random seed; same seed, same frames"         },
+        { L'\0', L"density",   L"<0-100>", L"Rain density for recording (default 50)"     },
     };
 
     BuildFormattedLines();
@@ -99,7 +105,7 @@ void UsageText::BuildFormattedLines ()
             switchStr += L" " + sw.argument;
         }
 
-        while (switchStr.size() < 18)
+        while (switchStr.size() < 20)
         {
             switchStr += L' ';
         }
@@ -0,0 +1,187 @@
+#include "pch.h"
+
+#include "VBlankScheduler.h"
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  VBlankScheduler::AddDisplay
+//
+////////////////////////////////////////////////////////////////////////////////
+
+size_t VBlankScheduler::AddDisplay (Clock::duration period, Clock::time_point firstVBlank)
+{
+    assert (period > Clock::duration::zero());
+
+    m_displays.push_back (Display { .period = period, .anchor = firstVBlank, .deadline = firstVBlank });
+
+    return m_displays.size() - 1;
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  VBlankScheduler::GetNext
+//
+////////////////////////////////////////////////////////////////////////////////
+
+size_t VBlankScheduler::GetNext() const
+{
+    size_t next = s_kNone;
+
+
+
+    for (size_t i = 0; i < m_displays.size(); i++)
+    {
+        if (m_displays[i].retired)
+        {
+            continue;
+        }
+
+        if (next == s_kNone || m_displays[i].deadline < m_displays[next].deadline)
+        {
+            next = i;
+        }
+    }
+
+    return next;
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  VBlankScheduler::Complete
+//
+//  The frame serviced at `now` was meant for the vblank at the current
+//  deadline.  Any vblank between that one and the next one due after `now`
+//  passed without a frame.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void VBlankScheduler::Complete (size_t display, Clock::time_point now)
+{
+    Display         & d    = m_displays[display];
+    Clock::time_point next = VBlankAfter (d, now);
+
+
+
+    if (next > d.deadline)
+    {
+        int64_t periods = (next - d.deadline + d.period / 2) / d.period;
+
+        d.missed += static_cast<uint64_t> (std::max<int64_t> (periods - 1, 0));
+    }
+
+    d.serviced++;
+    d.deadline = next;
+    d.deferred = false;
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  VBlankScheduler::DeferUntil
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void VBlankScheduler::DeferUntil (size_t display, Clock::time_point time)
+{
+    Display & d = m_displays[display];
+
+
+
+    d.deadline = std::max (d.deadline, VBlankAfter (d, time - Clock::duration (1)));
+    d.deferred = true;
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  VBlankScheduler::Expedite
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void VBlankScheduler::Expedite (Clock::time_point now)
+{
+    for (Display & d : m_displays)
+    {
+        if (d.deferred && !d.retired)
+        {
+            d.deadline = std::min (d.deadline, VBlankAfter (d, now));
+            d.deferred = false;
+        }
+    }
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  VBlankScheduler::Resync
+//
+//  Moves the grid onto the observed vblank and the pending deadline to
+//  the grid point nearest where it was.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void VBlankScheduler::Resync (size_t display, Clock::time_point vblank)
+{
+    Display & d = m_displays[display];
+
+
+
+    d.anchor   = vblank;
+    d.deadline = VBlankAfter (d, d.deadline - d.period / 2);
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  VBlankScheduler::Retire
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void VBlankScheduler::Retire (size_t display)
+{
+    m_displays[display].retired = true;
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  VBlankScheduler::VBlankAfter
+//
+////////////////////////////////////////////////////////////////////////////////
+
+VBlankScheduler::Clock::time_point VBlankScheduler::VBlankAfter (const Display & display, Clock::time_point time)
+{
+    Clock::duration sinceAnchor = time - display.anchor;
+    int64_t         periods     = sinceAnchor / display.period;
+
+
+
+    // Integer division truncates toward zero; step back to the floor for
+    // times before the anchor
+    if (sinceAnchor < Clock::duration::zero() && sinceAnchor % display.period != Clock::duration::zero())
+    {
+        periods--;
+    }
+
+    return display.anchor + (periods + 1) * display.period;
+}
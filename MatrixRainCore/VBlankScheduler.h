@@ -0,0 +1,79 @@
+#pragma once
+
+#include "FrameClock.h"
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  VBlankScheduler — Earliest-vblank-first ordering of several displays
+//
+//  Tracks, for each display one render worker drives, the vblank grid it
+//  refreshes on (a period and the time of one known vblank) and the next
+//  vblank at which it should be serviced.  GetNext always names the live
+//  display whose deadline is soonest, so a single thread can interleave
+//  monitors with different refresh rates and phases without any of them
+//  waiting on another's VBlank.
+//
+//  Deadlines always sit on the display's grid:
+//
+//   - Complete moves a serviced display to its first vblank after `now`;
+//     every vblank it slid past on the way is counted as missed.
+//   - DeferUntil parks a display that has nothing new to show (paused
+//     low-power mode) until the first vblank at or after a time;
+//     Expedite brings every parked display back to its next vblank when
+//     something changes.
+//   - Resync re-anchors the grid on a vblank actually observed on the
+//     display, so drift between the nominal refresh rate and the real one
+//     never accumulates.
+//
+//  Not thread-safe: owned and driven by one render worker.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class VBlankScheduler
+{
+public:
+    using Clock = FrameClock;
+
+    static constexpr size_t s_kNone = static_cast<size_t> (-1);
+
+    // Returns the new display's index.  `firstVBlank` anchors its grid and
+    // is its first deadline.
+    size_t AddDisplay (Clock::duration period, Clock::time_point firstVBlank);
+
+    // The live display with the soonest deadline (lowest index on a tie),
+    // or s_kNone once every display has been retired
+    size_t GetNext() const;
+
+    void Complete   (size_t display, Clock::time_point now);
+    void DeferUntil (size_t display, Clock::time_point time);
+    void Expedite   (Clock::time_point now);
+    void Resync     (size_t display, Clock::time_point vblank);
+    void Retire     (size_t display);
+
+    size_t            GetDisplayCount()              const { return m_displays.size();            }
+    Clock::time_point GetDeadline  (size_t display)  const { return m_displays[display].deadline; }
+    Clock::duration   GetPeriod    (size_t display)  const { return m_displays[display].period;   }
+    uint64_t          GetServiced  (size_t display)  const { return m_displays[display].serviced; }
+    uint64_t          GetMissed    (size_t display)  const { return m_displays[display].missed;   }
+    bool              IsRetired    (size_t display)  const { return m_displays[display].retired;  }
+
+private:
+    struct Display
+    {
+        Clock::duration   period;
+        Clock::time_point anchor;                   // a vblank on this display's grid
+        Clock::time_point deadline;
+        bool              deferred { false };
+        bool              retired  { false };
+        uint64_t          serviced { 0 };
+        uint64_t          missed   { 0 };
+    };
+
+    // First vblank on the display's grid strictly after `time`
+    static Clock::time_point VBlankAfter (const Display & display, Clock::time_point time);
+
+    std::vector<Display> m_displays;
+};
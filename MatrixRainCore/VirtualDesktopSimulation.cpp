@@ -0,0 +1,207 @@
+#include "pch.h"
+
+#include "VirtualDesktopSimulation.h"
+
+#include "RainMetrics.h"
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  VirtualDesktopSimulation::VirtualDesktopSimulation
+//
+//  Horizontal streak spacing and the DPI scale match a MonitorRenderContext's
+//  own simulation; the character size comes from the shortest monitor so
+//  it is never larger than that monitor would pick on its own.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+VirtualDesktopSimulation::VirtualDesktopSimulation (const VirtualDesktopLayout & layout, float dpiScale) :
+    m_layout            (layout),
+    m_densityController (m_viewport, 16.0f)
+{
+    float shortest = static_cast<float> (layout.size.cy);
+
+
+
+    for (const RainRegion & region : layout.regions)
+    {
+        shortest = std::min (shortest, region.height);
+    }
+
+    m_characterScale = ComputeRainCharacterScale (shortest, dpiScale, std::nullopt);
+
+    m_viewport.Resize (static_cast<float> (layout.size.cx), static_cast<float> (layout.size.cy));
+
+    m_densityController.SetDpiScale       (dpiScale);
+    m_densityController.SetColumnCoverage (layout.columnCoverage);
+
+    // AnimationSystem's base spacing is 24 px at scale 1
+    m_animationSystem.SetDpiScale                 (dpiScale);
+    m_animationSystem.SetCharacterSpacingOverride (24.0f * m_characterScale);
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  VirtualDesktopSimulation::Initialize
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void VirtualDesktopSimulation::Initialize()
+{
+    m_animationSystem.Initialize (m_viewport, m_densityController);
+
+    Publish();
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  VirtualDesktopSimulation::Step
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void VirtualDesktopSimulation::Step (float deltaTime, int densityPercent, int animationSpeedPercent)
+{
+    m_densityController.SetPercentage   (densityPercent);
+    m_animationSystem.SetAnimationSpeed (animationSpeedPercent);
+    m_animationSystem.Update            (deltaTime);
+
+    Publish();
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  VirtualDesktopSimulation::GetLatestFrame
+//
+////////////////////////////////////////////////////////////////////////////////
+
+std::shared_ptr<const RainFrame> VirtualDesktopSimulation::GetLatestFrame() const
+{
+    std::lock_guard<std::mutex> lock (m_latestMutex);
+
+
+
+    return m_latest;
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  VirtualDesktopSimulation::Publish
+//
+//  A pooled frame only the pool references is neither the latest frame nor
+//  held by any reader, and no reader can reach it again, so it is safe to
+//  overwrite.  Readers drop their reference with a release decrement; the
+//  acquire fence orders their last reads before our writes.  Copying into
+//  a recycled frame reuses every streak's character storage.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void VirtualDesktopSimulation::Publish()
+{
+    std::shared_ptr<RainFrame> frame;
+
+
+
+    for (const std::shared_ptr<RainFrame> & candidate : m_framePool)
+    {
+        if (candidate.use_count() == 1)
+        {
+            std::atomic_thread_fence (std::memory_order_acquire);
+            frame = candidate;
+            break;
+        }
+    }
+
+    if (!frame)
+    {
+        m_framePool.push_back (std::make_shared<RainFrame>());
+        frame = m_framePool.back();
+    }
+
+    frame->streaks  = m_animationSystem.GetStreaks();
+    frame->sequence = ++m_sequence;
+
+    {
+        std::lock_guard<std::mutex> lock (m_latestMutex);
+
+        m_latest = std::move (frame);
+    }
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  VirtualDesktopSimulation::CullToRegion
+//
+//  Streaks are columns (every character sits at the streak's X), so one
+//  X test accepts or rejects a whole streak.  Characters are stored tail
+//  to head in ascending Y, so the ones inside the region are a single run
+//  found by two binary searches.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void VirtualDesktopSimulation::CullToRegion (const RainFrame               & frame,
+                                             const RainRegion              & region,
+                                             float                           characterScale,
+                                             std::vector<CharacterStreak>  & out)
+{
+    float  charWidth  = s_kRainCharWidth  * characterScale;
+    float  charHeight = s_kRainCharHeight * characterScale;
+    float  right      = region.left + region.width;
+    float  bottom     = region.top  + region.height;
+    size_t count      = 0;
+
+
+
+    for (const CharacterStreak & streak : frame.streaks)
+    {
+        const std::vector<CharacterInstance> & characters = streak.GetCharacters();
+        float                                  x          = streak.GetPosition().x;
+
+
+
+        if (x + charWidth <= region.left || x >= right)
+        {
+            continue;
+        }
+
+        auto first = std::partition_point (characters.begin(), characters.end(),
+            [&] (const CharacterInstance & character) { return character.positionOffset.y + charHeight <= region.top; });
+
+        auto last  = std::partition_point (first, characters.end(),
+            [&] (const CharacterInstance & character) { return character.positionOffset.y < bottom; });
+
+        if (first == last)
+        {
+            continue;
+        }
+
+        if (count == out.size())
+        {
+            out.emplace_back();
+        }
+
+        out[count++].AssignSlice (streak,
+                                  static_cast<size_t> (first - characters.begin()),
+                                  static_cast<size_t> (last  - characters.begin()),
+                                  -region.left,
+                                  -region.top);
+    }
+
+    out.resize (count);
+}
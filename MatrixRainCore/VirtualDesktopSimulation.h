@@ -0,0 +1,95 @@
+#pragma once
+
+#include "AnimationSystem.h"
+#include "DensityController.h"
+#include "MonitorLayout.h"
+#include "Viewport.h"
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  RainFrame — One published step of a VirtualDesktopSimulation
+//
+//  Immutable once published; streak positions are in union-rectangle
+//  coordinates.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+struct RainFrame
+{
+    std::vector<CharacterStreak> streaks;
+    uint64_t                     sequence { 0 };    // 1 for the first frame published
+};
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  VirtualDesktopSimulation — One rain simulation spanning every monitor
+//
+//  In fullscreen multimon every MonitorRenderContext normally simulates
+//  its own monitor.  With ScreenSaverSettings::m_sharedSimulation set, one
+//  simulation runs over the union rectangle of the monitors instead: one
+//  spawn pass, one RNG and one set of streaks, whose cost follows the
+//  pixels covered rather than the number of monitors, and streaks fall
+//  straight across the bezel between stacked monitors.
+//
+//  One thread (the primary context's) calls Step, which advances the
+//  simulation and publishes the result as a RainFrame.  Every context,
+//  the primary included, takes the latest frame and renders what
+//  CullToRegion cuts out of it for its monitor.  Frames are recycled once
+//  no reader holds them, so the steady state allocates nothing.
+//
+//  Characters are sized once for the whole desktop, from the primary's
+//  DPI and the shortest monitor; contexts render at GetCharacterScale.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class VirtualDesktopSimulation
+{
+public:
+    VirtualDesktopSimulation (const VirtualDesktopLayout & layout, float dpiScale);
+
+    // Spawns the initial streaks and publishes the first frame.  Runs
+    // after CharacterSet::Initialize and before any render thread starts.
+    void Initialize();
+
+    // Simulating thread only
+    void Step (float deltaTime, int densityPercent, int animationSpeedPercent);
+
+    // Any thread.  Never null after Initialize.
+    std::shared_ptr<const RainFrame> GetLatestFrame() const;
+
+    // Fills `out` with the characters of `frame` whose quads overlap
+    // `region`, moved into the region's own coordinates.  Streaks wholly
+    // outside it are skipped; ones crossing its edge keep only the
+    // characters inside.  Reuses `out`'s storage.
+    static void CullToRegion (const RainFrame               & frame,
+                              const RainRegion              & region,
+                              float                           characterScale,
+                              std::vector<CharacterStreak>  & out);
+
+    const VirtualDesktopLayout & GetLayout()         const { return m_layout;         }
+    float                        GetCharacterScale() const { return m_characterScale; }
+
+    // Before Initialize, or on the simulating thread (tests seed it here)
+    AnimationSystem   & Animation() { return m_animationSystem;   }
+    DensityController & Density()   { return m_densityController; }
+
+private:
+    void Publish();
+
+    VirtualDesktopLayout                    m_layout;
+    float                                   m_characterScale { 1.0f };
+    Viewport                                m_viewport;
+    DensityController                       m_densityController;
+    AnimationSystem                         m_animationSystem;
+    std::vector<std::shared_ptr<RainFrame>> m_framePool;            // Simulating thread only
+    uint64_t                                m_sequence       { 0 };
+
+    mutable std::mutex                      m_latestMutex;
+    std::shared_ptr<const RainFrame>        m_latest;
+};
@@ -0,0 +1,148 @@
+#include "pch.h"
+
+#include "WorkerPool.h"
+
+
+
+
+
+WorkerPool::WorkerPool (UINT threadCount)
+{
+    UINT threads = std::max (1u, threadCount);
+
+
+
+    m_workers.reserve (threads - 1);
+
+    for (UINT i = 1; i < threads; i++)
+    {
+        m_workers.emplace_back (&WorkerPool::WorkerThreadProc, this, i);
+    }
+}
+
+
+
+
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock (m_mutex);
+
+        m_shutdown = true;
+    }
+
+    m_batchReady.notify_all();
+
+    for (std::thread & worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  WorkerPool::ParallelFor
+//
+//  Batches too small to share are run inline; waking the pool would cost
+//  more than the work.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void WorkerPool::ParallelFor (UINT itemCount, const Job & job)
+{
+    if (m_workers.empty() || itemCount <= 1)
+    {
+        for (UINT item = 0; item < itemCount; item++)
+        {
+            job (item, 0);
+        }
+
+        return;
+    }
+
+    m_job       = &job;
+    m_itemCount = itemCount;
+    m_nextItem.store (0, std::memory_order_relaxed);
+
+    {
+        std::lock_guard<std::mutex> lock (m_mutex);
+
+        m_workersActive = static_cast<UINT> (m_workers.size());
+        m_batchSerial++;
+    }
+
+    m_batchReady.notify_all();
+
+    RunItems (0);
+
+    {
+        std::unique_lock<std::mutex> lock (m_mutex);
+
+        m_batchDone.wait (lock, [this] { return m_workersActive == 0; });
+    }
+
+    m_job = nullptr;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  WorkerPool::WorkerThreadProc
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void WorkerPool::WorkerThreadProc (UINT threadIndex)
+{
+    uint64_t lastBatch = 0;
+
+
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock (m_mutex);
+
+            m_batchReady.wait (lock, [&] { return m_shutdown || m_batchSerial != lastBatch; });
+
+            if (m_shutdown)
+            {
+                return;
+            }
+
+            lastBatch = m_batchSerial;
+        }
+
+        RunItems (threadIndex);
+
+        {
+            std::lock_guard<std::mutex> lock (m_mutex);
+
+            if (--m_workersActive == 0)
+            {
+                m_batchDone.notify_one();
+            }
+        }
+    }
+}
+
+
+
+
+
+void WorkerPool::RunItems (UINT threadIndex)
+{
+    for (UINT item = m_nextItem.fetch_add (1, std::memory_order_relaxed);
+         item < m_itemCount;
+         item = m_nextItem.fetch_add (1, std::memory_order_relaxed))
+    {
+        (*m_job) (item, threadIndex);
+    }
+}
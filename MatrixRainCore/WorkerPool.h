@@ -0,0 +1,57 @@
+#pragma once
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//  WorkerPool
+//
+//  Persistent threads for the software renderer's data-parallel passes
+//  (raster tiles, bloom rows).  ParallelFor hands a batch of independent
+//  items to the pool; the calling thread works alongside the workers, every
+//  thread claims items one at a time from a shared atomic counter, and the
+//  call returns once the whole batch is done.
+//
+//  The job receives the index of the thread running it (0 is the caller),
+//  so passes can keep per-thread scratch without locking.  The mutex only
+//  publishes a batch and waits for it to drain; items never contend on it.
+//
+//  threadCount includes the calling thread; 1 runs every batch inline.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class WorkerPool
+{
+public:
+    using Job = std::function<void (UINT item, UINT threadIndex)>;
+
+    explicit WorkerPool (UINT threadCount);
+    ~WorkerPool();
+
+    WorkerPool (const WorkerPool &)             = delete;
+    WorkerPool & operator= (const WorkerPool &) = delete;
+
+    void ParallelFor (UINT itemCount, const Job & job);
+
+    UINT GetThreadCount() const { return static_cast<UINT> (m_workers.size()) + 1; }
+
+private:
+    void WorkerThreadProc (UINT threadIndex);
+    void RunItems         (UINT threadIndex);
+
+    std::vector<std::thread> m_workers;
+
+    // Current batch — written before the batch is published under m_mutex
+    const Job               * m_job       { nullptr };
+    UINT                      m_itemCount { 0 };
+    std::atomic<UINT>         m_nextItem  { 0 };
+
+    // Batch hand-off
+    std::mutex              m_mutex;
+    std::condition_variable m_batchReady;
+    std::condition_variable m_batchDone;
+    uint64_t                m_batchSerial   { 0 };
+    UINT                    m_workersActive { 0 };
+    bool                    m_shutdown      { false };
+};
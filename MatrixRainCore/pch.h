@@ -13,8 +13,13 @@
 #include <algorithm>
 #include <array>
 #include <atomic>
+#include <bit>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
 #include <format>
+#include <fstream>
 #include <functional>
 #include <map>
 #include <memory>
@@ -30,6 +35,16 @@
 
 
 
+// SIMD and CPU intrinsics (software renderer, Timestamp)
+#if defined(_M_ARM64) || defined(__aarch64__)
+#include <arm_neon.h>
+#else
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+
+
 // Windows headers
 #define WIN32_LEAN_AND_MEAN
 #define NOMINMAX
@@ -0,0 +1,327 @@
+#include "Pch_MatrixRainTests.h"
+#include "GoldenImage.h"
+
+
+
+
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+
+
+
+
+namespace UnitTest
+{
+    static int Channel (uint32_t rgba, int channel)
+    {
+        return static_cast<int> ((rgba >> (8 * channel)) & 0xFF);
+    }
+
+
+
+
+    static double Luma (uint32_t rgba)
+    {
+        return 0.299 * Channel (rgba, 0) + 0.587 * Channel (rgba, 1) + 0.114 * Channel (rgba, 2);
+    }
+
+
+
+
+    static std::filesystem::path GetGoldenDirectory()
+    {
+        wchar_t szOverride[MAX_PATH] = {};
+        DWORD   cch                  = GetEnvironmentVariableW (L"MATRIXRAIN_GOLDEN_DIR", szOverride, MAX_PATH);
+
+        if (cch > 0 && cch < MAX_PATH)
+        {
+            return std::filesystem::path (szOverride);
+        }
+
+        return std::filesystem::path (__FILE__).parent_path() / L"golden";
+    }
+
+
+
+
+    static bool IsGoldenUpdateRequested()
+    {
+        return GetEnvironmentVariableW (L"MATRIXRAIN_UPDATE_GOLDEN", nullptr, 0) > 0;
+    }
+
+
+
+
+    ImageDifference CompareImages (const SoftwareSurface & expected, const SoftwareSurface & actual, int channelDelta)
+    {
+        ImageDifference           result;
+        std::span<const uint32_t> expectedPixels = expected.Pixels();
+        std::span<const uint32_t> actualPixels   = actual.Pixels();
+        uint64_t                  deltaSum       = 0;
+
+        Assert::IsTrue (expected.GetWidth() == actual.GetWidth() && expected.GetHeight() == actual.GetHeight(), L"CompareImages needs equal sizes");
+
+        for (size_t i = 0; i < expectedPixels.size(); i++)
+        {
+            int pixelDelta = 0;
+
+            for (int channel = 0; channel < 3; channel++)
+            {
+                int delta = std::abs (Channel (expectedPixels[i], channel) - Channel (actualPixels[i], channel));
+
+                pixelDelta  = std::max (pixelDelta, delta);
+                deltaSum   += static_cast<uint64_t> (delta);
+            }
+
+            result.maxChannelDelta = std::max (result.maxChannelDelta, pixelDelta);
+
+            if (pixelDelta > channelDelta)
+            {
+                result.pixelsOverTolerance++;
+            }
+        }
+
+        if (!expectedPixels.empty())
+        {
+            result.meanChannelDelta = static_cast<double> (deltaSum) / (3.0 * static_cast<double> (expectedPixels.size()));
+        }
+
+        result.ssim = ComputeLumaSsim (expected, actual);
+
+        return result;
+    }
+
+
+
+
+    // Standard SSIM constants for 8-bit data.  Windows that are flat and
+    // equal in both images (almost all of a black rain frame) score exactly
+    // 1 and say nothing about structure, so they are skipped rather than
+    // allowed to dilute the mean.
+    double ComputeLumaSsim (const SoftwareSurface & expected, const SoftwareSurface & actual)
+    {
+        constexpr int    kWindow = 8;
+        constexpr int    kStride = 4;
+        constexpr double kC1     = (0.01 * 255.0) * (0.01 * 255.0);
+        constexpr double kC2     = (0.03 * 255.0) * (0.03 * 255.0);
+
+        int    width   = static_cast<int> (expected.GetWidth());
+        int    height  = static_cast<int> (expected.GetHeight());
+        int    windowW = std::min (kWindow, width);
+        int    windowH = std::min (kWindow, height);
+        double ssimSum = 0.0;
+        int    windows = 0;
+
+        for (int y0 = 0; y0 + windowH <= height; y0 += kStride)
+        {
+            for (int x0 = 0; x0 + windowW <= width; x0 += kStride)
+            {
+                double sumA  = 0.0;
+                double sumB  = 0.0;
+                double sumAA = 0.0;
+                double sumBB = 0.0;
+                double sumAB = 0.0;
+                double n     = static_cast<double> (windowW * windowH);
+
+                for (int y = y0; y < y0 + windowH; y++)
+                {
+                    for (int x = x0; x < x0 + windowW; x++)
+                    {
+                        double a = Luma (expected.GetPixel (static_cast<UINT> (x), static_cast<UINT> (y)));
+                        double b = Luma (actual.GetPixel   (static_cast<UINT> (x), static_cast<UINT> (y)));
+
+                        sumA  += a;
+                        sumB  += b;
+                        sumAA += a * a;
+                        sumBB += b * b;
+                        sumAB += a * b;
+                    }
+                }
+
+                double meanA      = sumA / n;
+                double meanB      = sumB / n;
+                double varianceA  = std::max (0.0, sumAA / n - meanA * meanA);
+                double varianceB  = std::max (0.0, sumBB / n - meanB * meanB);
+                double covariance = sumAB / n - meanA * meanB;
+
+                if (varianceA == 0.0 && varianceB == 0.0 && meanA == meanB)
+                {
+                    continue;
+                }
+
+                ssimSum += ((2.0 * meanA * meanB + kC1) * (2.0 * covariance + kC2)) /
+                           ((meanA * meanA + meanB * meanB + kC1) * (varianceA + varianceB + kC2));
+                windows++;
+            }
+        }
+
+        return windows > 0 ? ssimSum / windows : 1.0;
+    }
+
+
+
+
+    void BuildDiffImage (const SoftwareSurface & expected, const SoftwareSurface & actual, int channelDelta, SoftwareSurface & diff)
+    {
+        std::span<const uint32_t> expectedPixels = expected.Pixels();
+        std::span<const uint32_t> actualPixels   = actual.Pixels();
+
+        diff.Resize (expected.GetWidth(), expected.GetHeight());
+
+        for (size_t i = 0; i < expectedPixels.size(); i++)
+        {
+            int pixelDelta = 0;
+
+            for (int channel = 0; channel < 3; channel++)
+            {
+                pixelDelta = std::max (pixelDelta, std::abs (Channel (expectedPixels[i], channel) - Channel (actualPixels[i], channel)));
+            }
+
+            if (pixelDelta > channelDelta)
+            {
+                diff.Pixels()[i] = 0xFF000000 | static_cast<uint32_t> (std::min (255, 96 + 2 * pixelDelta));
+            }
+            else
+            {
+                uint32_t grey = static_cast<uint32_t> (Luma (expectedPixels[i]) / 4.0);
+
+                diff.Pixels()[i] = 0xFF000000 | (grey << 16) | (grey << 8) | grey;
+            }
+        }
+    }
+
+
+
+
+    bool WritePpm (const std::filesystem::path & path, const SoftwareSurface & surface)
+    {
+        std::ofstream        file (path, std::ios::binary);
+        std::vector<uint8_t> rgb;
+
+        rgb.reserve (surface.Pixels().size() * 3);
+
+        for (uint32_t pixel : surface.Pixels())
+        {
+            rgb.push_back (static_cast<uint8_t> (Channel (pixel, 0)));
+            rgb.push_back (static_cast<uint8_t> (Channel (pixel, 1)));
+            rgb.push_back (static_cast<uint8_t> (Channel (pixel, 2)));
+        }
+
+        file << "P6\n" << surface.GetWidth() << ' ' << surface.GetHeight() << "\n255\n";
+        file.write (reinterpret_cast<const char *> (rgb.data()), static_cast<std::streamsize> (rgb.size()));
+
+        return file.good();
+    }
+
+
+
+
+    bool ReadPpm (const std::filesystem::path & path, SoftwareSurface & surface)
+    {
+        std::ifstream        file (path, std::ios::binary);
+        std::string          magic;
+        UINT                 width    = 0;
+        UINT                 height   = 0;
+        UINT                 maxValue = 0;
+        std::vector<uint8_t> rgb;
+
+        file >> magic >> width >> height >> maxValue;
+
+        if (!file || magic != "P6" || maxValue != 255 || width == 0 || height == 0)
+        {
+            return false;
+        }
+
+        // Exactly one whitespace byte separates the header from the data
+        file.get();
+
+        rgb.resize (size_t (width) * height * 3);
+        file.read (reinterpret_cast<char *> (rgb.data()), static_cast<std::streamsize> (rgb.size()));
+
+        if (!file)
+        {
+            return false;
+        }
+
+        surface.Resize (width, height);
+
+        for (size_t i = 0; i < surface.Pixels().size(); i++)
+        {
+            surface.Pixels()[i] = 0xFF000000 | (uint32_t (rgb[3 * i + 2]) << 16) | (uint32_t (rgb[3 * i + 1]) << 8) | rgb[3 * i];
+        }
+
+        return true;
+    }
+
+
+
+
+    void CheckGoldenImage (std::wstring_view name, const SoftwareSurface & actual, const GoldenTolerance & tolerance)
+    {
+        std::filesystem::path referencePath = GetGoldenDirectory() / (std::wstring (name) + L".ppm");
+        std::filesystem::path outputDir     = std::filesystem::temp_directory_path() / L"MatrixRainGolden";
+        std::filesystem::path actualPath    = outputDir / (std::wstring (name) + L".actual.ppm");
+        std::filesystem::path diffPath      = outputDir / (std::wstring (name) + L".diff.ppm");
+        SoftwareSurface       expected;
+        SoftwareSurface       diff;
+        ImageDifference       difference;
+        double                overFraction  = 0.0;
+        std::wstring          report;
+
+        // References are only ever written on request, so a checkout that
+        // lost one fails rather than quietly re-recording it
+        if (IsGoldenUpdateRequested())
+        {
+            std::filesystem::create_directories (referencePath.parent_path());
+            Assert::IsTrue (WritePpm (referencePath, actual), L"Could not record the golden image");
+
+            Logger::WriteMessage (std::format (L"Recorded golden image {}\n", referencePath.wstring()).c_str());
+            return;
+        }
+
+        std::filesystem::create_directories (outputDir);
+
+        if (!std::filesystem::exists (referencePath))
+        {
+            WritePpm (actualPath, actual);
+            report = std::format (L"Golden {}: no reference at {}; actual frame in {} (set MATRIXRAIN_UPDATE_GOLDEN=1 to record it)",
+                                  name,
+                                  referencePath.wstring(),
+                                  actualPath.wstring());
+            Assert::Fail (report.c_str());
+        }
+
+        if (!ReadPpm (referencePath, expected) || expected.GetWidth() != actual.GetWidth() || expected.GetHeight() != actual.GetHeight())
+        {
+            WritePpm (actualPath, actual);
+            report = std::format (L"Golden {}: reference {} is unreadable or a different size; actual frame in {}",
+                                  name,
+                                  referencePath.wstring(),
+                                  actualPath.wstring());
+            Assert::Fail (report.c_str());
+        }
+
+        difference   = CompareImages (expected, actual, tolerance.channelDelta);
+        overFraction = static_cast<double> (difference.pixelsOverTolerance) / static_cast<double> (actual.Pixels().size());
+        report       = std::format (L"Golden {}: max channel delta {}, mean {:.3f}, {:.3f}% of pixels over {}, SSIM {:.4f}",
+                                    name,
+                                    difference.maxChannelDelta,
+                                    difference.meanChannelDelta,
+                                    100.0 * overFraction,
+                                    tolerance.channelDelta,
+                                    difference.ssim);
+
+        Logger::WriteMessage ((report + L"\n").c_str());
+
+        if (overFraction > tolerance.maxOverFraction || difference.ssim < tolerance.minSsim)
+        {
+            BuildDiffImage (expected, actual, tolerance.channelDelta, diff);
+            WritePpm (actualPath, actual);
+            WritePpm (diffPath,   diff);
+
+            report += std::format (L"; see {} and {}", actualPath.wstring(), diffPath.wstring());
+            Assert::Fail (report.c_str());
+        }
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "..\MatrixRainCore\SoftwareSurface.h"
+
+
+
+
+
+namespace UnitTest
+{
+    /// <summary>
+    /// How far an image may drift from its reference before a golden check
+    /// fails.  A pixel is "over" when any channel differs by more than
+    /// channelDelta; SSIM is computed on luma and catches structural change
+    /// (moved or missing glyphs, a different blur shape) that a loose
+    /// per-channel limit would let through.
+    /// </summary>
+    struct GoldenTolerance
+    {
+        int    channelDelta     { 8 };
+        double maxOverFraction  { 0.002 };
+        double minSsim          { 0.98 };
+    };
+
+    struct ImageDifference
+    {
+        int      maxChannelDelta     { 0 };
+        double   meanChannelDelta    { 0.0 };
+        uint64_t pixelsOverTolerance { 0 };
+        double   ssim                { 1.0 };
+    };
+
+    /// <summary>
+    /// Per-channel statistics plus mean luma SSIM over 8x8 windows at a
+    /// stride of 4.  Both images must be the same size.
+    /// </summary>
+    ImageDifference CompareImages (const SoftwareSurface & expected, const SoftwareSurface & actual, int channelDelta);
+
+    double ComputeLumaSsim (const SoftwareSurface & expected, const SoftwareSurface & actual);
+
+    /// <summary>
+    /// Red where a pixel is over channelDelta (brighter for larger
+    /// differences), the expected image dimmed to grey everywhere else.
+    /// </summary>
+    void BuildDiffImage (const SoftwareSurface & expected, const SoftwareSurface & actual, int channelDelta, SoftwareSurface & diff);
+
+    /// <summary>
+    /// Binary PPM (P6) I/O.  Alpha is dropped on write and read back as
+    /// opaque, which is all the render targets ever hold.
+    /// </summary>
+    bool WritePpm (const std::filesystem::path & path, const SoftwareSurface & surface);
+    bool ReadPpm  (const std::filesystem::path & path, SoftwareSurface & surface);
+
+    /// <summary>
+    /// Compares actual against MatrixRainTests\golden\&lt;name&gt;.ppm and
+    /// fails the calling test if it is out of tolerance, leaving
+    /// &lt;name&gt;.actual.ppm and &lt;name&gt;.diff.ppm in
+    /// %TEMP%\MatrixRainGolden for inspection.
+    ///
+    /// A missing reference fails the test.  Only when MATRIXRAIN_UPDATE_GOLDEN
+    /// is set are references (re)recorded, into the reference directory,
+    /// instead of compared.  MATRIXRAIN_GOLDEN_DIR overrides that
+    /// directory.
+    /// </summary>
+    void CheckGoldenImage (std::wstring_view name, const SoftwareSurface & actual, const GoldenTolerance & tolerance = {});
+}
@@ -10,6 +10,8 @@
 
 // Additional C++ headers for testing
 #include <chrono>
+#include <filesystem>
+#include <fstream>
 #include <set>
 #include <thread>
 
@@ -28,6 +28,7 @@ public:
     int   m_blurPasses       = -1;
     int   m_bloomResolution  = -1;
     int   m_blurTaps         = -1;
+    int   m_bloomAlgorithm   = -1;
     float m_characterScale   = -1.0f;
     float m_dpiScale         = 1.0f;
 
@@ -107,6 +108,12 @@ public:
     }
 
 
+    void SetBloomAlgorithm (int algorithm) override
+    {
+        m_bloomAlgorithm = algorithm;
+    }
+
+
     void SetCharacterScaleOverride (float scale) override
     {
         m_characterScale = scale;
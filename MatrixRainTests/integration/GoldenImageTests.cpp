@@ -0,0 +1,228 @@
+#include "Pch_MatrixRainTests.h"
+
+#include "..\GoldenImage.h"
+#include "..\..\MatrixRainCore\AnimationSystem.h"
+#include "..\..\MatrixRainCore\CharacterSet.h"
+#include "..\..\MatrixRainCore\DensityController.h"
+#include "..\..\MatrixRainCore\SoftwareRenderSystem.h"
+#include "..\..\MatrixRainCore\Viewport.h"
+
+
+
+
+
+namespace MatrixRainTests
+{
+    struct GoldenScene
+    {
+        LPCWSTR     name;
+        bool        glowEnabled;
+        bool        scanlinesEnabled;
+        int         bloomAlgorithm;
+        ColorScheme colorScheme;
+    };
+
+
+
+
+    // A fixed-seed, fixed-step run of the CPU reference renderer: the
+    // same path HeadlessRecorder takes, small enough to keep references
+    // in the tree.  The frame is taken after two seconds of rain so
+    // streaks of every age are on screen.
+    static SoftwareSurface RenderGoldenFrame (const GoldenScene & scene)
+    {
+        constexpr UINT  kWidth    = 320;
+        constexpr UINT  kHeight   = 180;
+        constexpr int   kFrames   = 120;
+        constexpr float kTimeStep = 1.0f / 60.0f;
+
+        Viewport             viewport;
+        viewport.Resize (static_cast<float> (kWidth), static_cast<float> (kHeight));
+        DensityController    densityController (viewport, 16.0f);
+        AnimationSystem      animationSystem;
+        SoftwareRenderSystem renderSystem (kWidth, kHeight);
+        RenderParams         params;
+
+        densityController.SetPercentage (50);
+        animationSystem.Seed (20240601);
+        animationSystem.Initialize (viewport, densityController);
+        renderSystem.BuildGlyphAtlas();
+        renderSystem.SetBloomAlgorithm (scene.bloomAlgorithm);
+
+        params.colorScheme      = scene.colorScheme;
+        params.glowEnabled      = scene.glowEnabled;
+        params.scanlinesEnabled = scene.scanlinesEnabled;
+
+        for (int frame = 0; frame < kFrames; frame++)
+        {
+            animationSystem.Update (kTimeStep);
+
+            params.elapsedTime = static_cast<float> (frame) * kTimeStep;
+
+            renderSystem.Render (animationSystem, viewport, params);
+            Assert::AreEqual (S_OK, renderSystem.Present());
+        }
+
+        return renderSystem.GetPresentedSurface();
+    }
+
+
+
+
+    TEST_CLASS (GoldenImageTests)
+    {
+        public:
+            TEST_CLASS_INITIALIZE (ClassSetup)
+            {
+                CharacterSet::GetInstance().Initialize();
+            }
+
+
+
+
+            TEST_METHOD (Golden_RenderedScenesMatchReferences)
+            {
+                const GoldenScene scenes[] =
+                {
+                    { L"rain_plain",            false, false, 0, ColorScheme::Green },
+                    { L"rain_glow",             true,  false, 0, ColorScheme::Green },
+                    { L"rain_glow_scanlines",   true,  true,  0, ColorScheme::Green },
+                    { L"rain_dual_filter_glow", true,  false, 1, ColorScheme::Green },
+                    { L"rain_amber_scanlines",  false, true,  0, ColorScheme::Amber },
+                };
+
+                for (const GoldenScene & scene : scenes)
+                {
+                    UnitTest::CheckGoldenImage (scene.name, RenderGoldenFrame (scene));
+                }
+            }
+
+
+
+
+            TEST_METHOD (Golden_SameSceneRendersIdentically)
+            {
+                // The harness is only meaningful if a scene is reproducible
+                GoldenScene     scene  = { L"repeat", true, true, 0, ColorScheme::Green };
+                SoftwareSurface first  = RenderGoldenFrame (scene);
+                SoftwareSurface second = RenderGoldenFrame (scene);
+
+                Assert::IsTrue (std::ranges::equal (first.Pixels(), second.Pixels()));
+            }
+
+
+
+
+            TEST_METHOD (CompareImages_IdenticalImages_AreExact)
+            {
+                SoftwareSurface           frame      = RenderGoldenFrame ({ L"", true, false, 0, ColorScheme::Green });
+                UnitTest::ImageDifference difference = UnitTest::CompareImages (frame, frame, 0);
+
+                Assert::AreEqual (0,            difference.maxChannelDelta);
+                Assert::AreEqual (uint64_t (0), difference.pixelsOverTolerance);
+                Assert::AreEqual (1.0,          difference.ssim);
+            }
+
+
+
+
+            TEST_METHOD (CompareImages_SmallNoise_StaysWithinTolerance)
+            {
+                // Rounding-level drift (a different compiler's float
+                // contraction, say) must pass the default tolerance
+                SoftwareSurface expected = RenderGoldenFrame ({ L"", true, false, 0, ColorScheme::Green });
+                SoftwareSurface actual   = expected;
+                std::mt19937    generator (7);
+
+                for (uint32_t & pixel : actual.Pixels())
+                {
+                    int green = static_cast<int> ((pixel >> 8) & 0xFF) + static_cast<int> (generator() % 5) - 2;
+
+                    pixel = (pixel & 0xFFFF00FF) | (static_cast<uint32_t> (std::clamp (green, 0, 255)) << 8);
+                }
+
+                UnitTest::GoldenTolerance tolerance;
+                UnitTest::ImageDifference difference = UnitTest::CompareImages (expected, actual, tolerance.channelDelta);
+
+                Assert::IsTrue (difference.maxChannelDelta <= 2);
+                Assert::AreEqual (uint64_t (0), difference.pixelsOverTolerance);
+                Assert::IsTrue (difference.ssim >= tolerance.minSsim);
+            }
+
+
+
+
+            TEST_METHOD (CompareImages_ShiftedGlyphs_FailSsim)
+            {
+                // Moving everything two pixels right keeps the histogram but
+                // not the structure; SSIM must catch it
+                SoftwareSurface expected = RenderGoldenFrame ({ L"", false, false, 0, ColorScheme::Green });
+                SoftwareSurface actual;
+
+                actual.Resize (expected.GetWidth(), expected.GetHeight());
+                actual.Clear (SoftwareSurface::s_kOpaqueBlack);
+
+                for (UINT y = 0; y < expected.GetHeight(); y++)
+                {
+                    std::copy (expected.Row (y), expected.Row (y) + expected.GetWidth() - 2, actual.Row (y) + 2);
+                }
+
+                UnitTest::ImageDifference difference = UnitTest::CompareImages (expected, actual, UnitTest::GoldenTolerance().channelDelta);
+
+                Logger::WriteMessage (std::format ("Shifted by 2 px: SSIM {:.4f}, {} pixels over\n", difference.ssim, difference.pixelsOverTolerance).c_str());
+
+                Assert::IsTrue (difference.ssim < UnitTest::GoldenTolerance().minSsim);
+                Assert::IsTrue (difference.pixelsOverTolerance > 0);
+            }
+
+
+
+
+            TEST_METHOD (BuildDiffImage_MarksOnlyChangedPixels)
+            {
+                SoftwareSurface expected;
+                SoftwareSurface actual;
+                SoftwareSurface diff;
+
+                expected.Resize (4, 2);
+                expected.Clear (0xFF404040);
+                actual = expected;
+                actual.Pixels()[5] = 0xFF404080;
+
+                UnitTest::BuildDiffImage (expected, actual, 8, diff);
+
+                for (size_t i = 0; i < diff.Pixels().size(); i++)
+                {
+                    uint32_t pixel = diff.Pixels()[i];
+                    bool     red   = (pixel & 0xFF) > 0 && (pixel & 0x00FFFF00) == 0;
+
+                    Assert::AreEqual (i == 5, red);
+                }
+            }
+
+
+
+
+            TEST_METHOD (Ppm_RoundTripsOpaquePixels)
+            {
+                std::filesystem::path path = std::filesystem::temp_directory_path() / L"GoldenImageTests_roundtrip.ppm";
+                SoftwareSurface       written;
+                SoftwareSurface       read;
+
+                written.Resize (7, 3);
+
+                for (size_t i = 0; i < written.Pixels().size(); i++)
+                {
+                    written.Pixels()[i] = 0xFF000000 | static_cast<uint32_t> (i * 0x030507);
+                }
+
+                Assert::IsTrue (UnitTest::WritePpm (path, written));
+                Assert::IsTrue (UnitTest::ReadPpm  (path, read));
+                std::filesystem::remove (path);
+
+                Assert::AreEqual (7u, read.GetWidth());
+                Assert::AreEqual (3u, read.GetHeight());
+                Assert::IsTrue   (std::ranges::equal (written.Pixels(), read.Pixels()));
+            }
+    };
+}
@@ -0,0 +1,90 @@
+#include "Pch_MatrixRainTests.h"
+
+#include "..\..\MatrixRainCore\SoftwareRenderSystem.h"
+#include "..\..\MatrixRainCore\AnimationSystem.h"
+#include "..\..\MatrixRainCore\CharacterSet.h"
+#include "..\..\MatrixRainCore\DensityController.h"
+#include "..\..\MatrixRainCore\FPSCounter.h"
+#include "..\..\MatrixRainCore\Viewport.h"
+
+
+
+
+
+namespace MatrixRainTests
+{
+
+
+    TEST_CLASS (SoftwareRenderLoopTests)
+    {
+    public:
+        TEST_METHOD (TestSoftwareRenderLoopRunsWithoutGpu)
+        {
+            // Drives the same per-frame sequence MonitorRenderContext runs
+            // (animation update, Render, Present) against the software
+            // renderer, so the whole loop executes with no D3D device.
+
+            CharacterSet & charSet = CharacterSet::GetInstance();
+
+            charSet.Initialize();
+
+            Viewport viewport;
+
+            viewport.Resize (1920.0f, 1080.0f);
+
+            DensityController    densityController (viewport, 24.0f);
+            AnimationSystem      animationSystem;
+            SoftwareRenderSystem renderSystem (1920, 1080);
+            IRenderSystem      & renderer = renderSystem;
+            FPSCounter           fpsCounter;
+            RenderParams         params;
+
+            animationSystem.Initialize (viewport, densityController);
+            renderSystem.BuildGlyphAtlas();
+
+            constexpr int   WARMUP_FRAMES  = 120;
+            constexpr int   MEASURE_FRAMES = 120;
+            constexpr float TIME_STEP      = 1.0f / 60.0f;
+            double          renderSeconds  = 0.0;
+            size_t          totalQuads     = 0;
+
+
+            for (int frame = 0; frame < WARMUP_FRAMES + MEASURE_FRAMES; frame++)
+            {
+                animationSystem.Update (TIME_STEP);
+                fpsCounter.Update (TIME_STEP);
+
+                params.fps         = fpsCounter.GetFPS();
+                params.elapsedTime = frame * TIME_STEP;
+                params.streakCount = static_cast<int> (animationSystem.GetActiveStreakCount());
+
+                auto start = std::chrono::steady_clock::now();
+
+                renderer.Render (animationSystem, viewport, params);
+
+                renderSeconds += (frame < WARMUP_FRAMES) ? 0.0 : std::chrono::duration<double> (std::chrono::steady_clock::now() - start).count();
+                totalQuads    += (frame < WARMUP_FRAMES) ? 0   : renderSystem.GetQuads().size();
+
+                Assert::AreEqual (S_OK, renderer.Present());
+            }
+
+            size_t litPixels = 0;
+
+            for (uint32_t pixel : renderSystem.GetPresentedSurface().Pixels())
+            {
+                litPixels += (pixel != SoftwareSurface::s_kOpaqueBlack) ? 1 : 0;
+            }
+
+            Logger::WriteMessage (std::format ("SoftwareRenderSystem 1080p: {:.0f} quads/frame, {:.2f} ms/frame, {:.2f}% pixels lit\n",
+                                               double (totalQuads) / MEASURE_FRAMES,
+                                               1000.0 * renderSeconds / MEASURE_FRAMES,
+                                               100.0 * double (litPixels) / (1920.0 * 1080.0)).c_str());
+
+            Assert::AreEqual (uint64_t (WARMUP_FRAMES + MEASURE_FRAMES), renderSystem.GetPresentCount());
+            Assert::IsTrue   (totalQuads > 0, L"Rain should produce quads after warmup");
+            Assert::IsTrue   (litPixels > 0,  L"Presented frame should contain rain");
+
+            charSet.Shutdown();
+        }
+    };
+}
@@ -78,6 +78,50 @@ namespace MatrixRainTests
 
 
 
+        TEST_METHOD (CharacterStreak_Spawn_IDsAreUniqueAcrossThreads)
+        {
+            // Render and simulation threads spawn concurrently, and the ID
+            // keys the streak's InstanceStore slot
+            constexpr int            kThreads = 4;
+            constexpr int            kSpawns  = 20000;
+            std::vector<uint64_t>    ids[kThreads];
+            std::vector<std::thread> threads;
+
+            for (int t = 0; t < kThreads; t++)
+            {
+                threads.emplace_back ([&ids, t]
+                {
+                    CharacterStreak streak;
+
+                    for (int i = 0; i < kSpawns; i++)
+                    {
+                        streak.Spawn (Vector3 (0.0f, 0.0f, 50.0f));
+                        ids[t].push_back (streak.GetID());
+                    }
+                });
+            }
+
+            for (std::thread & thread : threads)
+            {
+                thread.join();
+            }
+
+            std::vector<uint64_t> all;
+
+            for (const std::vector<uint64_t> & threadIds : ids)
+            {
+                all.insert (all.end(), threadIds.begin(), threadIds.end());
+            }
+
+            std::sort (all.begin(), all.end());
+
+            Assert::IsTrue (std::adjacent_find (all.begin(), all.end()) == all.end(), L"No ID may be handed out twice");
+        }
+
+
+
+
+
         TEST_METHOD (CharacterStreak_VelocityScaling_FasterAtFarDepth)
         {
             // Note: Streaks use discrete cell-based positioning, not continuous velocity
@@ -703,5 +703,95 @@ namespace MatrixRainTests
                 Assert::AreEqual (E_INVALIDARG, hr, L"/install -force should fail (single dash not valid for multi-char)");
                 Assert::IsTrue (context.m_errorMessage.find (L"-force") != std::wstring::npos, L"error should show the invalid argument");
             }
+
+
+
+
+            TEST_METHOD (ParseCommandLine_Record_DefaultsWithPathOnly)
+            {
+                HRESULT                hr;
+                ScreenSaverModeContext context;
+
+
+                hr = CommandLine().Parse (L"/record out.y4m", context);
+
+
+
+                Assert::IsTrue  (SUCCEEDED (hr), L"/record out.y4m should succeed");
+                Assert::AreEqual (static_cast<int>(ScreenSaverMode::Record), static_cast<int>(context.m_mode), L"mode should be Record");
+                Assert::AreEqual (std::wstring (L"out.y4m"), context.m_record.outputPath);
+                Assert::AreEqual (1920u, context.m_record.width);
+                Assert::AreEqual (1080u, context.m_record.height);
+                Assert::IsFalse (context.m_enableHotkeys, L"hotkeys should be disabled");
+            }
+
+
+
+
+            TEST_METHOD (ParseCommandLine_Record_ParsesAllOptions)
+            {
+                HRESULT                hr;
+                ScreenSaverModeContext context;
+
+
+                hr = CommandLine().Parse (L"--record \"C:\\My Frames\\rain.PPM\" --size 3840x2160 /FPS 30 --frames 90 /seed 1234 /density 80", context);
+
+
+
+                Assert::IsTrue  (SUCCEEDED (hr), L"all record options should parse");
+                Assert::AreEqual (std::wstring (L"C:\\My Frames\\rain.PPM"), context.m_record.outputPath, L"quoted path should keep its spaces");
+                Assert::AreEqual (3840u, context.m_record.width);
+                Assert::AreEqual (2160u, context.m_record.height);
+                Assert::AreEqual (30u,   context.m_record.framesPerSecond);
+                Assert::AreEqual (90u,   context.m_record.frameCount);
+                Assert::AreEqual (1234u, static_cast<UINT>(context.m_record.seed));
+                Assert::AreEqual (80,    context.m_record.densityPercent);
+            }
+
+
+
+
+            TEST_METHOD (ParseCommandLine_Record_RejectsMissingOrUnknownExtension)
+            {
+                for (LPCWSTR pszCmdLine : { L"/record", L"/record out.avi", L"/record /size 640x480" })
+                {
+                    HRESULT                hr;
+                    ScreenSaverModeContext context;
+
+
+                    hr = CommandLine().Parse (pszCmdLine, context);
+
+
+
+                    Assert::AreEqual (E_INVALIDARG, hr, pszCmdLine);
+                    Assert::IsTrue (context.m_errorMessage.find (L".y4m") != std::wstring::npos, L"error should name the supported formats");
+                }
+            }
+
+
+
+
+            TEST_METHOD (ParseCommandLine_Record_RejectsBadOptions)
+            {
+                for (LPCWSTR pszCmdLine : { L"/record out.y4m /size 640",
+                                            L"/record out.y4m /size 0x480",
+                                            L"/record out.y4m /fps 0",
+                                            L"/record out.y4m /frames -5",
+                                            L"/record out.y4m /density 101",
+                                            L"/record out.y4m /seed 12ab",
+                                            L"/record out.y4m /force" })
+                {
+                    HRESULT                hr;
+                    ScreenSaverModeContext context;
+
+
+                    hr = CommandLine().Parse (pszCmdLine, context);
+
+
+
+                    Assert::AreEqual (E_INVALIDARG, hr, pszCmdLine);
+                    Assert::IsTrue (context.m_errorMessage.find (L"Invalid /record option") != std::wstring::npos, pszCmdLine);
+                }
+            }
     };
 }  // namespace MatrixRainTests
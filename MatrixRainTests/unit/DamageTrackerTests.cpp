@@ -0,0 +1,262 @@
+#include "Pch_MatrixRainTests.h"
+
+#include "..\..\MatrixRainCore\DamageTracker.h"
+#include "..\..\MatrixRainCore\AnimationSystem.h"
+#include "..\..\MatrixRainCore\CharacterSet.h"
+#include "..\..\MatrixRainCore\DensityController.h"
+#include "..\..\MatrixRainCore\SoftwareBloom.h"
+#include "..\..\MatrixRainCore\SoftwareRenderSystem.h"
+#include "..\..\MatrixRainCore\Viewport.h"
+
+
+
+
+namespace MatrixRainTests
+{
+    static uint64_t DirtyRectArea (const DamageTracker & tracker)
+    {
+        uint64_t area = 0;
+
+        for (const PixelRect & rect : tracker.GetDirtyRects())
+        {
+            area += uint64_t (rect.right - rect.left) * uint64_t (rect.bottom - rect.top);
+        }
+
+        return area;
+    }
+
+
+
+
+    TEST_CLASS (DamageTrackerTests)
+    {
+        public:
+            TEST_CLASS_INITIALIZE (ClassSetup)
+            {
+                CharacterSet::GetInstance().Initialize();
+            }
+
+
+
+
+            TEST_METHOD (Update_FirstFrameAfterResize_IsFullyDamaged)
+            {
+                DamageTracker tracker;
+
+                tracker.Resize (200, 100);
+                tracker.Update ({}, 0);
+
+                Assert::AreEqual (4u, tracker.GetTilesX());
+                Assert::AreEqual (2u, tracker.GetTilesY());
+                Assert::IsTrue   (tracker.IsFullyDamaged());
+                Assert::AreEqual (1.0, tracker.GetDamagedFraction());
+
+                tracker.Update ({}, 0);
+
+                Assert::AreEqual (0u, tracker.GetDamagedTileCount());
+                Assert::IsTrue   (tracker.GetDirtyRects().empty());
+            }
+
+
+
+
+            TEST_METHOD (Update_MovedGlyph_DamagesOldAndNewTiles)
+            {
+                DamageTracker tracker;
+                PixelRect     first[]  = { { 10, 10, 20, 20 } };
+                PixelRect     second[] = { { 140, 10, 150, 20 } };
+
+                tracker.Resize (256, 256);
+                tracker.Update (first, 0);
+                tracker.Update (first, 0);
+
+                Assert::AreEqual (1u, tracker.GetDamagedTileCount());
+                Assert::IsTrue   (tracker.IsTileDamaged (0, 0));
+
+                tracker.Update (second, 0);
+
+                Assert::AreEqual (2u, tracker.GetDamagedTileCount());
+                Assert::IsTrue   (tracker.IsTileDamaged (0, 0));
+                Assert::IsTrue   (tracker.IsTileDamaged (2, 0));
+
+                tracker.Update (second, 0);
+
+                Assert::AreEqual (1u, tracker.GetDamagedTileCount());
+                Assert::IsFalse  (tracker.IsTileDamaged (0, 0));
+            }
+
+
+
+
+            TEST_METHOD (Update_Reach_GrowsDamageAcrossTileEdges)
+            {
+                DamageTracker tracker;
+                PixelRect     glyph[] = { { 70, 70, 80, 80 } };
+
+                tracker.Resize (256, 256);
+                tracker.Update ({}, 0);
+
+                tracker.Update (glyph, 0);
+                Assert::AreEqual (1u, tracker.GetDamagedTileCount());
+
+                // 70 - 7 = 63 reaches back into the first tile column and row
+                tracker.Update (glyph, 7);
+                Assert::AreEqual (4u, tracker.GetDamagedTileCount());
+                Assert::IsTrue   (tracker.IsTileDamaged (0, 0));
+                Assert::IsTrue   (tracker.IsTileDamaged (1, 1));
+                Assert::IsFalse  (tracker.IsTileDamaged (2, 1));
+            }
+
+
+
+
+            TEST_METHOD (GetDirtyRects_CoverExactlyTheDamagedTiles)
+            {
+                DamageTracker tracker;
+                PixelRect     glyphs[] = { {  10,  10,  20, 140 },      // Column 0, rows 0..2
+                                           {  70,  10,  80, 140 },      // Column 1, rows 0..2
+                                           { 200, 200, 210, 210 },      // Column 3, row 3
+                                           { 300, 230, 330, 270 } };    // Edge tile (4, 3), clipped
+
+
+
+                tracker.Resize (320, 250);
+                tracker.Update ({}, 0);
+                tracker.Update (glyphs, 0);
+
+                std::vector<uint8_t> covered (size_t (tracker.GetTilesX()) * tracker.GetTilesY(), 0);
+
+                for (const PixelRect & rect : tracker.GetDirtyRects())
+                {
+                    Assert::IsTrue (rect.left % DamageTracker::s_kTileSize == 0 && rect.top % DamageTracker::s_kTileSize == 0);
+
+                    for (int y = rect.top; y < rect.bottom; y += DamageTracker::s_kTileSize)
+                    {
+                        for (int x = rect.left; x < rect.right; x += DamageTracker::s_kTileSize)
+                        {
+                            uint8_t & tile = covered[(y / DamageTracker::s_kTileSize) * tracker.GetTilesX() + x / DamageTracker::s_kTileSize];
+
+                            Assert::AreEqual (uint8_t (0), tile, L"Dirty rects overlap");
+                            tile = 1;
+                        }
+                    }
+                }
+
+                for (UINT tileY = 0; tileY < tracker.GetTilesY(); tileY++)
+                {
+                    for (UINT tileX = 0; tileX < tracker.GetTilesX(); tileX++)
+                    {
+                        Assert::AreEqual (tracker.IsTileDamaged (tileX, tileY), covered[tileY * tracker.GetTilesX() + tileX] != 0);
+                    }
+                }
+
+                // Columns 0..1 over rows 0..2 merge into one rectangle, and
+                // the bottom row's run stops at the clipped edge
+                Assert::AreEqual (size_t (2), tracker.GetDirtyRects().size());
+                Assert::AreEqual (uint64_t (128 * 192 + 128 * 58), DirtyRectArea (tracker));
+                Assert::AreEqual (static_cast<double> (DirtyRectArea (tracker)) / (320.0 * 250.0), tracker.GetDamagedFraction());
+            }
+
+
+
+
+            TEST_METHOD (Render_DamagedClear_MatchesFullClear)
+            {
+                // Renders a moving rain field frame after frame with glow on,
+                // then renders the same state into a fresh system, whose first
+                // frame clears everything.  Clearing only the damage must not
+                // leave anything behind.
+                constexpr UINT kWidth  = 640;
+                constexpr UINT kHeight = 360;
+
+                Viewport             viewport;
+                viewport.Resize (static_cast<float> (kWidth), static_cast<float> (kHeight));
+                DensityController    densityController (viewport, 24.0f);
+                AnimationSystem      animationSystem;
+                SoftwareRenderSystem damaged (kWidth, kHeight);
+                SoftwareRenderSystem full    (kWidth, kHeight);
+                RenderParams         params;
+
+                densityController.SetPercentage (25);
+                animationSystem.Initialize (viewport, densityController);
+                damaged.BuildGlyphAtlas();
+                full.BuildGlyphAtlas();
+                params.glowEnabled = true;
+
+                for (int frame = 0; frame < 30; frame++)
+                {
+                    animationSystem.Update (1.0f / 60.0f);
+                    damaged.Render (animationSystem, viewport, params);
+                }
+
+                full.Render (animationSystem, viewport, params);
+
+                Assert::IsFalse (damaged.GetDamage().IsFullyDamaged());
+                Assert::IsTrue  (full.GetDamage().IsFullyDamaged());
+                Assert::IsTrue  (std::ranges::equal (full.GetSceneSurface().Pixels(), damaged.GetSceneSurface().Pixels()));
+                Assert::IsTrue  (std::ranges::equal (full.GetBackSurface().Pixels(),  damaged.GetBackSurface().Pixels()));
+            }
+
+
+
+
+            TEST_METHOD (Benchmark_DamagedFractionAcrossDensities)
+            {
+                // Runs warmed-up 1080p rain at several densities and reports
+                // the share of pixels the damage tracker says each frame
+                // touched, with glow off (glyphs only) and on (default bloom
+                // settings, which SoftwareRenderSystem starts with).
+                constexpr UINT kWidth  = 1920;
+                constexpr UINT kHeight = 1080;
+                constexpr int  kFrames = 60;
+
+                for (int density : { 5, 10, 25, 50, 100 })
+                {
+                    for (bool glow : { false, true })
+                    {
+                        Viewport              viewport;
+                        viewport.Resize (static_cast<float> (kWidth), static_cast<float> (kHeight));
+                        DensityController     densityController (viewport, 24.0f);
+                        AnimationSystem       animationSystem;
+                        SoftwareRenderSystem  renderSystem (kWidth, kHeight);
+                        RenderParams          params;
+                        SoftwareBloomSettings defaults;
+                        double                fractionSum = 0.0;
+                        double                worst       = 0.0;
+
+                        densityController.SetPercentage (density);
+                        animationSystem.Initialize (viewport, densityController);
+                        renderSystem.BuildGlyphAtlas();
+                        params.glowEnabled = glow;
+
+                        for (int frame = 0; frame < 120; frame++)
+                        {
+                            animationSystem.Update (1.0f / 60.0f);
+                        }
+
+                        renderSystem.Render (animationSystem, viewport, params);
+
+                        for (int frame = 0; frame < kFrames; frame++)
+                        {
+                            animationSystem.Update (1.0f / 60.0f);
+                            renderSystem.Render (animationSystem, viewport, params);
+
+                            double fraction = renderSystem.GetDamage().GetDamagedFraction();
+
+                            fractionSum += fraction;
+                            worst        = std::max (worst, fraction);
+                        }
+
+                        Logger::WriteMessage (std::format ("Damage 1080p: density {:3}%, glow {:3} (reach {:3} px): {:5.1f}% of pixels/frame on average, {:5.1f}% worst\n",
+                                                           density,
+                                                           glow ? "on" : "off",
+                                                           glow ? SoftwareBloom::ComputeGlowReach (defaults) : 0,
+                                                           100.0 * fractionSum / kFrames,
+                                                           100.0 * worst).c_str());
+
+                        Assert::IsTrue (worst <= 1.0);
+                    }
+                }
+            }
+    };
+}
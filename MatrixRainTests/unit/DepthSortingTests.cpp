@@ -19,7 +19,7 @@ namespace MatrixRainTests
     			// T045: Test depth sorting back-to-front order
     			// 
     			// Given: Multiple character streaks at different Z depths
-    			// When: Sorted using the same algorithm as RenderSystem::SortStreaksByDepth
+    			// When: Sorted using the same algorithm as InstanceStore::Update
     			// Then: Streaks are ordered from farthest (highest Z) to nearest (lowest Z)
     			//
     			// This ensures proper painter's algorithm for rendering with alpha blending
@@ -36,7 +36,7 @@ namespace MatrixRainTests
     			streaks.push_back (&streak2);
     			streaks.push_back (&streak3);
 
-    			// Sort using the same algorithm as RenderSystem (back-to-front)
+    			// Sort using the same algorithm as InstanceStore (back-to-front)
     			std::stable_sort(streaks.begin(), streaks.end(),
     [](const CharacterStreak* a, const CharacterStreak* b)
     {
@@ -79,6 +79,24 @@ namespace MatrixRainTests
                 // After enough updates at 30 FPS, should converge to ~30
                 Assert::IsTrue (fps >= 25.0f && fps <= 35.0f, L"FPS should adapt to new frame rate");
             }
+
+            // FrameClock intervals accumulate exactly, so a stall the frame
+            // loop clamps for the animation still counts against the FPS
+            TEST_METHOD (TestFPSCounterDurationUpdateCountsStalls)
+            {
+                FPSCounter counter;
+
+                for (int i = 0; i < 30; i++)
+                {
+                    counter.Update (std::chrono::duration_cast<FrameClock::duration> (std::chrono::microseconds (16'667)));
+                }
+
+                counter.Update (std::chrono::milliseconds (500));
+
+                // 31 frames over 0.5 s of frames plus the 0.5 s stall
+                float fps = counter.GetFPS();
+                Assert::IsTrue (fps >= 30.5f && fps <= 31.5f, L"A stall should lower the average");
+            }
     };
 
 
@@ -0,0 +1,187 @@
+#include "Pch_MatrixRainTests.h"
+
+#include "..\..\MatrixRainCore\FrameClock.h"
+#include "..\..\MatrixRainCore\Timer.h"
+
+
+
+
+namespace MatrixRainTests
+{
+
+
+    TEST_CLASS (FrameClockTests)
+    {
+        public:
+
+            //
+            //  Conversion helpers
+            //
+
+            TEST_METHOD (Conversions_MatchChronoArithmetic)
+            {
+                using namespace std::chrono;
+
+                Assert::AreEqual (2.0,          ToSeconds      (seconds (2)));
+                Assert::AreEqual (1.5,          ToMilliseconds (microseconds (1500)));
+                Assert::AreEqual (int64_t (1),  ToMicroseconds (nanoseconds (1999)));
+                Assert::AreEqual (int64_t (-1), ToMicroseconds (nanoseconds (-1999)));
+
+                Assert::IsTrue (FromSeconds (0.25)      == milliseconds (250));
+                Assert::IsTrue (FromSeconds (1.0 / 3.0) == nanoseconds (333'333'333));
+                Assert::IsTrue (FromSeconds (2.0 / 3.0) == nanoseconds (666'666'667));
+                Assert::IsTrue (PeriodForRate (0)       == FrameClock::duration::zero());
+                Assert::IsTrue (PeriodForRate (60)      == nanoseconds (16'666'666));
+                Assert::IsTrue (PeriodForRate (144)     == nanoseconds (6'944'444));
+            }
+
+
+
+
+            //
+            //  FrameClock
+            //
+
+            TEST_METHOD (FrameClock_SharesSteadyClockTimePoints)
+            {
+                static_assert (std::is_same_v<FrameClock::time_point, std::chrono::steady_clock::time_point>);
+                static_assert (FrameClock::is_steady);
+
+                auto                   before = std::chrono::steady_clock::now();
+                FrameClock::time_point now    = FrameClock::now();
+                auto                   after  = std::chrono::steady_clock::now();
+
+                Assert::IsTrue (before <= now && now <= after);
+            }
+
+
+
+
+            //
+            //  Timestamp
+            //
+
+            TEST_METHOD (Timestamp_SteadyClockSource_IsFrameClockNanoseconds)
+            {
+                Timestamp::UseSteadyClock();
+
+                FrameClock::time_point start      = FrameClock::now();
+                uint64_t               startTicks = Timestamp::Read();
+
+                std::this_thread::sleep_for (std::chrono::milliseconds (20));
+
+                uint64_t               endTicks = Timestamp::Read();
+                FrameClock::time_point end      = FrameClock::now();
+
+                Assert::IsTrue (Timestamp::GetSource() == TimestampSource::SteadyClock);
+                Assert::AreEqual (1e9, Timestamp::GetTicksPerSecond());
+                Assert::IsTrue (Timestamp::ToDuration (endTicks - startTicks) >= std::chrono::milliseconds (20));
+                Assert::IsTrue (Timestamp::ToDuration (endTicks - startTicks) <= end - start);
+            }
+
+
+
+
+            TEST_METHOD (Timestamp_Tsc_MeasuresIntervalsLikeFrameClock)
+            {
+                // The calibrated TSC must agree with FrameClock on a 50 ms
+                // interval to within 1% (plus the bracketing reads)
+                if (!Timestamp::IsTscInvariant())
+                {
+                    Assert::IsFalse (Timestamp::EnableTsc());
+                    Assert::IsTrue  (Timestamp::GetSource() == TimestampSource::SteadyClock);
+
+                    Logger::WriteMessage ("No invariant TSC on this CPU; the steady clock stays the source\n");
+                    return;
+                }
+
+                bool enabled = Timestamp::EnableTsc();
+
+                FrameClock::time_point start      = FrameClock::now();
+                uint64_t               startTicks = Timestamp::Read();
+
+                std::this_thread::sleep_for (std::chrono::milliseconds (50));
+
+                FrameClock::duration   tscElapsed = ElapsedSince (startTicks);
+                FrameClock::duration   elapsed    = FrameClock::now() - start;
+                TimestampSource        source     = Timestamp::GetSource();
+                double                 ticksPerS  = Timestamp::GetTicksPerSecond();
+
+                Timestamp::UseSteadyClock();
+
+                Logger::WriteMessage (std::format ("TSC {:.3f} GHz; 50 ms sleep: TSC {} us, FrameClock {} us\n",
+                                                   ticksPerS / 1e9,
+                                                   ToMicroseconds (tscElapsed),
+                                                   ToMicroseconds (elapsed)).c_str());
+
+                Assert::IsTrue (enabled);
+                Assert::IsTrue (source == TimestampSource::Tsc);
+                Assert::IsTrue (std::llabs (ToMicroseconds (tscElapsed) - ToMicroseconds (elapsed)) <= ToMicroseconds (elapsed) / 100 + 50);
+            }
+
+
+
+
+            TEST_METHOD (Timer_ElapsedFollowsTimestamp)
+            {
+                Timer timer;
+
+                std::this_thread::sleep_for (std::chrono::milliseconds (10));
+
+                FrameClock::duration elapsed = timer.GetElapsed();
+
+                Assert::IsTrue (elapsed >= std::chrono::milliseconds (10));
+                Assert::AreEqual (ToSeconds (elapsed), timer.GetElapsedSeconds(), 0.005);
+            }
+
+
+
+
+            TEST_METHOD (Benchmark_TimestampReadOverhead)
+            {
+                // Cost of one read of each clock the timing path can use,
+                // averaged over a tight loop.  The sink keeps the reads from
+                // being optimized out.
+                constexpr int kReads = 2'000'000;
+
+                uint64_t sink = 0;
+
+                auto measure = [&] (const char * name, auto read)
+                {
+                    FrameClock::time_point start = FrameClock::now();
+
+                    for (int i = 0; i < kReads; i++)
+                    {
+                        sink += read();
+                    }
+
+                    double nanoseconds = static_cast<double> (std::chrono::duration_cast<std::chrono::nanoseconds> (FrameClock::now() - start).count()) / kReads;
+
+                    Logger::WriteMessage (std::format ("{:28}: {:6.2f} ns/read\n", name, nanoseconds).c_str());
+
+                    return nanoseconds;
+                };
+
+                double steady = measure ("std::chrono::steady_clock", [] { return static_cast<uint64_t> (std::chrono::steady_clock::now().time_since_epoch().count()); });
+                double frame  = measure ("FrameClock::now",           [] { return static_cast<uint64_t> (FrameClock::now().time_since_epoch().count()); });
+
+                Timestamp::UseSteadyClock();
+
+                double ticks  = measure ("Timestamp::Read (steady)",  [] { return Timestamp::Read(); });
+
+                if (Timestamp::EnableTsc())
+                {
+                    measure ("Timestamp::Read (TSC)", [] { return Timestamp::Read(); });
+                    measure ("Timer::GetElapsed (TSC)", [timer = Timer()] { return static_cast<uint64_t> (timer.GetElapsed().count()); });
+
+                    Timestamp::UseSteadyClock();
+                }
+
+                Logger::WriteMessage (std::format ("(sink {})\n", sink % 10).c_str());
+
+                Assert::IsTrue (steady > 0.0 && frame > 0.0 && ticks > 0.0);
+            }
+    };
+
+
+}
@@ -0,0 +1,222 @@
+#include "Pch_MatrixRainTests.h"
+
+#include "..\..\MatrixRainCore\FrameExporter.h"
+#include "..\..\MatrixRainCore\SoftwareSurface.h"
+
+
+
+
+namespace MatrixRainTests
+{
+    static std::string ReadFileBytes (const std::filesystem::path & path)
+    {
+        std::ifstream file (path, std::ios::binary);
+
+        return std::string (std::istreambuf_iterator<char> (file), std::istreambuf_iterator<char>());
+    }
+
+
+
+
+    // Fills the surface with a value derived from the frame index so each
+    // frame's bytes identify it
+    static void FillFrame (SoftwareSurface & surface, uint32_t frameIndex)
+    {
+        for (size_t i = 0; i < surface.Pixels().size(); i++)
+        {
+            surface.Pixels()[i] = 0xFF000000 | ((frameIndex & 0xFF) << 16) | ((uint32_t (i) & 0xFF) << 8) | 0x40;
+        }
+    }
+
+
+
+
+    TEST_CLASS (FrameExporterTests)
+    {
+        public:
+            TEST_METHOD (FormatFromPath_SelectsByExtension)
+            {
+                FrameExportFormat format = FrameExportFormat::PpmSequence;
+
+                Assert::AreEqual (S_OK, FrameExporter::FormatFromPath (L"rain.Y4M", format));
+                Assert::IsTrue   (format == FrameExportFormat::Y4m);
+
+                Assert::AreEqual (S_OK, FrameExporter::FormatFromPath (L"C:\\frames\\rain.ppm", format));
+                Assert::IsTrue   (format == FrameExportFormat::PpmSequence);
+
+                Assert::AreEqual (E_INVALIDARG, FrameExporter::FormatFromPath (L"rain.mp4", format));
+                Assert::AreEqual (E_INVALIDARG, FrameExporter::FormatFromPath (L".ppm",     format));
+                Assert::AreEqual (E_INVALIDARG, FrameExporter::FormatFromPath (L"",         format));
+            }
+
+
+
+
+            TEST_METHOD (GetSequenceFramePath_NumbersBeforeTheExtension)
+            {
+                Assert::AreEqual (std::wstring (L"out_000000.ppm"),      FrameExporter::GetSequenceFramePath (L"out.ppm", 0));
+                Assert::AreEqual (std::wstring (L"dir\\out_000123.PPM"), FrameExporter::GetSequenceFramePath (L"dir\\out.PPM", 123));
+            }
+
+
+
+
+            TEST_METHOD (ConvertToYuv444_MatchesFullRangeBt601)
+            {
+                // Opaque black, white, red, green, blue, mid grey
+                const uint32_t rgba[] = { 0xFF000000, 0xFFFFFFFF, 0xFF0000FF, 0xFF00FF00, 0xFFFF0000, 0xFF808080 };
+                uint8_t        y[6]   = {};
+                uint8_t        u[6]   = {};
+                uint8_t        v[6]   = {};
+
+                FrameExporter::ConvertToYuv444 (rgba, y, u, v);
+
+                const uint8_t expectedY[] = {   0, 255,  77, 149,  29, 128 };
+                const uint8_t expectedU[] = { 128, 128,  85,  43, 255, 128 };
+                const uint8_t expectedV[] = { 128, 128, 255,  21, 107, 128 };
+
+                for (size_t i = 0; i < std::size (rgba); i++)
+                {
+                    Assert::AreEqual (expectedY[i], y[i]);
+                    Assert::AreEqual (expectedU[i], u[i]);
+                    Assert::AreEqual (expectedV[i], v[i]);
+                }
+            }
+
+
+
+
+            TEST_METHOD (Y4m_WritesHeaderThenEveryFrameInOrder)
+            {
+                // Queue depth 1 makes the submitter and writer alternate,
+                // which is where an ordering or hand-off bug would show
+                constexpr UINT   kWidth  = 8;
+                constexpr UINT   kHeight = 4;
+                constexpr UINT   kFrames = 12;
+                constexpr size_t kPlane  = size_t (kWidth) * kHeight;
+
+                std::filesystem::path path = std::filesystem::temp_directory_path() / L"FrameExporterTests_order.y4m";
+                FrameExporter         exporter;
+                SoftwareSurface       surface;
+                std::string           header = "YUV4MPEG2 W8 H4 F30:1 Ip A1:1 C444 XCOLORRANGE=FULL\n";
+
+                surface.Resize (kWidth, kHeight);
+
+                Assert::AreEqual (S_OK, exporter.Open (path.wstring(), FrameExportFormat::Y4m, kWidth, kHeight, 30, 1));
+
+                for (uint32_t frame = 0; frame < kFrames; frame++)
+                {
+                    FillFrame (surface, frame);
+                    Assert::AreEqual (S_OK, exporter.Submit (surface));
+                }
+
+                Assert::AreEqual (S_OK, exporter.Close());
+                Assert::AreEqual (uint64_t (kFrames), exporter.GetFramesWritten());
+
+                std::string bytes = ReadFileBytes (path);
+
+                std::filesystem::remove (path);
+
+                Assert::AreEqual (header.size() + kFrames * (6 + 3 * kPlane), bytes.size());
+                Assert::AreEqual (header, bytes.substr (0, header.size()));
+
+                for (uint32_t frame = 0; frame < kFrames; frame++)
+                {
+                    size_t  offset = header.size() + frame * (6 + 3 * kPlane);
+                    uint8_t y[kPlane];
+                    uint8_t u[kPlane];
+                    uint8_t v[kPlane];
+
+                    FillFrame (surface, frame);
+                    FrameExporter::ConvertToYuv444 (surface.Pixels(), y, u, v);
+
+                    Assert::AreEqual (std::string ("FRAME\n"), bytes.substr (offset, 6));
+                    Assert::IsTrue   (memcmp (bytes.data() + offset + 6,              y, kPlane) == 0);
+                    Assert::IsTrue   (memcmp (bytes.data() + offset + 6 + kPlane,     u, kPlane) == 0);
+                    Assert::IsTrue   (memcmp (bytes.data() + offset + 6 + 2 * kPlane, v, kPlane) == 0);
+                }
+            }
+
+
+
+
+            TEST_METHOD (PpmSequence_WritesOneFilePerFrame)
+            {
+                constexpr UINT kWidth  = 5;
+                constexpr UINT kHeight = 3;
+
+                std::filesystem::path path = std::filesystem::temp_directory_path() / L"FrameExporterTests_seq.ppm";
+                FrameExporter         exporter;
+                SoftwareSurface       surface;
+
+                surface.Resize (kWidth, kHeight);
+
+                Assert::AreEqual (S_OK, exporter.Open (path.wstring(), FrameExportFormat::PpmSequence, kWidth, kHeight, 60));
+
+                for (uint32_t frame = 0; frame < 3; frame++)
+                {
+                    FillFrame (surface, frame);
+                    Assert::AreEqual (S_OK, exporter.Submit (surface));
+                }
+
+                Assert::AreEqual (S_OK, exporter.Close());
+
+                for (uint32_t frame = 0; frame < 3; frame++)
+                {
+                    std::filesystem::path framePath = FrameExporter::GetSequenceFramePath (path.wstring(), frame);
+                    std::string           bytes     = ReadFileBytes (framePath);
+                    std::string           header    = "P6\n5 3\n255\n";
+
+                    std::filesystem::remove (framePath);
+
+                    Assert::AreEqual (header.size() + 3 * kWidth * kHeight, bytes.size());
+                    Assert::AreEqual (header, bytes.substr (0, header.size()));
+
+                    FillFrame (surface, frame);
+
+                    for (size_t i = 0; i < surface.Pixels().size(); i++)
+                    {
+                        uint32_t pixel = surface.Pixels()[i];
+
+                        Assert::AreEqual (uint8_t ( pixel        & 0xFF), uint8_t (bytes[header.size() + 3 * i + 0]));
+                        Assert::AreEqual (uint8_t ((pixel >>  8) & 0xFF), uint8_t (bytes[header.size() + 3 * i + 1]));
+                        Assert::AreEqual (uint8_t ((pixel >> 16) & 0xFF), uint8_t (bytes[header.size() + 3 * i + 2]));
+                    }
+                }
+
+                Assert::IsFalse (std::filesystem::exists (FrameExporter::GetSequenceFramePath (path.wstring(), 3)));
+            }
+
+
+
+
+            TEST_METHOD (Open_MissingDirectory_Fails)
+            {
+                std::filesystem::path path = std::filesystem::temp_directory_path() / L"FrameExporterTests_missing" / L"out.y4m";
+                FrameExporter         exporter;
+
+                Assert::IsTrue  (FAILED (exporter.Open (path.wstring(), FrameExportFormat::Y4m, 4, 4, 60)));
+                Assert::AreEqual (S_OK, exporter.Close());
+            }
+
+
+
+
+            TEST_METHOD (Submit_WrongSizeOrNotOpen_Fails)
+            {
+                std::filesystem::path path = std::filesystem::temp_directory_path() / L"FrameExporterTests_size.y4m";
+                FrameExporter         exporter;
+                SoftwareSurface       surface;
+
+                surface.Resize (4, 4);
+
+                Assert::AreEqual (E_UNEXPECTED, exporter.Submit (surface));
+                Assert::AreEqual (S_OK,         exporter.Open (path.wstring(), FrameExportFormat::Y4m, 8, 8, 60));
+                Assert::AreEqual (E_INVALIDARG, exporter.Submit (surface));
+                Assert::AreEqual (S_OK,         exporter.Close());
+                Assert::AreEqual (uint64_t (0), exporter.GetFramesWritten());
+
+                std::filesystem::remove (path);
+            }
+    };
+}
@@ -85,6 +85,154 @@ namespace MatrixRainTests
                 Assert::IsTrue (elapsedMs >= 10, L"Second WaitForNextFrame should sleep at least ~10ms at 60 fps");
                 Assert::IsTrue (elapsedMs <= 50, L"Second WaitForNextFrame should not over-sleep beyond ~50ms");
             }
+
+
+
+
+            //
+            //  Precision pacing
+            //
+
+            TEST_METHOD (Precision_SecondCall_ReturnsAtDeadlineAndRecordsError)
+            {
+                using clock = std::chrono::steady_clock;
+
+                FrameLimiter      limiter (60, FramePacingMode::Precision);
+                clock::time_point t0;
+                clock::time_point t1;
+
+
+                limiter.WaitForNextFrame();
+                t0 = clock::now();
+                limiter.WaitForNextFrame();
+                t1 = clock::now();
+
+                auto elapsedUs = std::chrono::duration_cast<std::chrono::microseconds> (t1 - t0).count();
+
+                Assert::IsTrue   (elapsedUs >= 15000, L"Precision pacing must not return before the deadline");
+                Assert::IsTrue   (elapsedUs <= 50000, L"Second WaitForNextFrame should not over-sleep beyond ~50ms");
+                Assert::AreEqual (uint64_t (1),       limiter.GetPacingError().GetCount());
+            }
+
+
+
+
+            TEST_METHOD (Precision_AbsoluteSchedule_DoesNotAccumulateLateness)
+            {
+                // Uneven per-frame work well inside the budget: with deadlines
+                // on an absolute schedule, N frames take N intervals no matter
+                // how late individual wakes are.
+                using clock = std::chrono::steady_clock;
+
+                constexpr int     kFrames = 60;
+                FrameLimiter      limiter (120, FramePacingMode::Precision);
+                std::mt19937      rng     (42);
+                clock::time_point start;
+
+
+                limiter.WaitForNextFrame();
+                start = clock::now();
+
+                for (int frame = 0; frame < kFrames; frame++)
+                {
+                    std::this_thread::sleep_for (std::chrono::microseconds (rng() % 4000));
+                    limiter.WaitForNextFrame();
+                }
+
+                double elapsedMs  = std::chrono::duration<double, std::milli> (clock::now() - start).count();
+                double scheduleMs = kFrames * 1000.0 / 120.0;
+
+                Logger::WriteMessage (std::format ("{} frames at 120 fps: {:.2f} ms (schedule {:.2f} ms)\n", kFrames, elapsedMs, scheduleMs).c_str());
+
+                Assert::IsTrue (elapsedMs >= scheduleMs - 1000.0 / 120.0);
+                Assert::IsTrue (elapsedMs <= scheduleMs + 1000.0 / 120.0);
+            }
+
+
+
+
+            TEST_METHOD (Precision_AfterHitch_ResynchronizesInsteadOfBursting)
+            {
+                using clock = std::chrono::steady_clock;
+
+                FrameLimiter      limiter (120, FramePacingMode::Precision);
+                clock::time_point t0;
+
+
+                limiter.WaitForNextFrame();
+                std::this_thread::sleep_for (std::chrono::milliseconds (50));   // six frames' worth
+
+                // Late frame returns at once, and the next one still waits a
+                // full interval rather than catching up
+                limiter.WaitForNextFrame();
+                t0 = clock::now();
+                limiter.WaitForNextFrame();
+
+                auto elapsedUs = std::chrono::duration_cast<std::chrono::microseconds> (clock::now() - t0).count();
+
+                Assert::IsTrue (elapsedUs >= 7000, L"Frame after a hitch should wait about one interval");
+            }
+
+
+
+
+            TEST_METHOD (Precision_SleepMargin_NeverExceedsTheSpinCap)
+            {
+                // The yield loop runs for the sleep margin every frame, so
+                // the margin bounds how much CPU pacing burns
+                FrameLimiter limiter (144, FramePacingMode::Precision);
+
+
+                for (int frame = 0; frame <= 60; frame++)
+                {
+                    limiter.WaitForNextFrame();
+
+                    Assert::IsTrue (limiter.GetSleepMargin() <= FrameLimiter::s_kMaxSleepMargin);
+                }
+
+                Assert::IsTrue (limiter.GetMode() == FramePacingMode::Precision, L"The high-resolution timer should be available");
+            }
+
+
+
+
+            TEST_METHOD (Benchmark_PacingErrorBySleepAndPrecisionModes)
+            {
+                // How late each wait returns versus its deadline, at the
+                // common high-refresh caps.  Sleep-only pacing lands late by
+                // the timer's granularity; Precision blocks on the Win32
+                // high-resolution waitable timer and yields for the capped
+                // margin, so its numbers only mean anything on Windows.
+                constexpr int kFrames = 120;
+
+                for (unsigned fps : { 60u, 120u, 144u })
+                {
+                    for (FramePacingMode mode : { FramePacingMode::Sleep, FramePacingMode::Precision })
+                    {
+                        FrameLimiter limiter (fps, mode);
+
+                        for (int frame = 0; frame <= kFrames; frame++)
+                        {
+                            limiter.WaitForNextFrame();
+                        }
+
+                        const TimingHistogram & error  = limiter.GetPacingError();
+                        std::string             margin = mode == FramePacingMode::Precision
+                                                       ? std::format ("; sleep margin {} us", std::chrono::duration_cast<std::chrono::microseconds> (limiter.GetSleepMargin()).count())
+                                                       : std::string();
+
+                        Logger::WriteMessage (std::format ("{:3} fps {:9}: pacing error p50 {:5} us, p99 {:5} us, max {:5} us{}\n",
+                                                           fps,
+                                                           mode == FramePacingMode::Sleep ? "sleep" : "precision",
+                                                           error.GetPercentile (50.0),
+                                                           error.GetPercentile (99.0),
+                                                           error.GetMax(),
+                                                           margin).c_str());
+
+                        Assert::AreEqual (uint64_t (kFrames), error.GetCount());
+                    }
+                }
+            }
     };
 
 
@@ -0,0 +1,173 @@
+#include "Pch_MatrixRainTests.h"
+
+#include "..\..\MatrixRainCore\FrameTiming.h"
+
+
+
+
+namespace MatrixRainTests
+{
+    // Every metric holds the single value `generation`, so a window mixed
+    // from two publishes shows up as metrics that disagree
+    static FrameTimingStats MakeGeneration (uint64_t generation)
+    {
+        FrameTimingStats stats;
+
+        for (size_t metric = 0; metric < FrameTimingStats::s_kMetricCount; metric++)
+        {
+            stats.Record (static_cast<FrameTimingMetric> (metric), static_cast<int64_t> (generation));
+        }
+
+        stats.windowSeconds = static_cast<double> (generation);
+        return stats;
+    }
+
+
+
+
+    TEST_CLASS (FrameTimingTests)
+    {
+        public:
+            TEST_METHOD (Summarize_ReportsPercentilesOfTheRequestedMetric)
+            {
+                FrameTimingStats stats;
+
+                // 100 frames: 98 at ~16.7 ms, then a 25 ms and a 50 ms hitch
+                for (int frame = 0; frame < 98; frame++)
+                {
+                    stats.Record (FrameTimingMetric::Frame, 16667);
+                }
+
+                stats.Record (FrameTimingMetric::Frame,   25000);
+                stats.Record (FrameTimingMetric::Frame,   50000);
+                stats.Record (FrameTimingMetric::Present, 900);
+
+                FrameTimingPercentiles frame   = stats.Summarize (FrameTimingMetric::Frame);
+                FrameTimingPercentiles present = stats.Summarize (FrameTimingMetric::Present);
+
+                // Within one sub-bucket (1/32) above the true value
+                Assert::IsTrue   (frame.p50Us >= 16667 && frame.p50Us <= 16667 + 16667 / 32);
+                Assert::IsTrue   (frame.p95Us >= 16667 && frame.p95Us <= 16667 + 16667 / 32);
+                Assert::IsTrue   (frame.p99Us >= 25000 && frame.p99Us <= 25000 + 25000 / 32);
+                Assert::AreEqual (int64_t (50000),   frame.maxUs);
+                Assert::AreEqual (uint64_t (100),    frame.count);
+                Assert::AreEqual (uint64_t (1),      present.count);
+                Assert::AreEqual (uint64_t (0),      stats.Summarize (FrameTimingMetric::Simulation).count);
+            }
+
+
+
+
+            TEST_METHOD (Recorder_PublishesEachWindowThenStartsAfresh)
+            {
+                using clock = std::chrono::steady_clock;
+
+                FrameTimingRecorder recorder (std::chrono::seconds (1));
+                FrameTimingStats    published;
+                clock::time_point   t0 = clock::now();
+
+                Assert::IsFalse (recorder.EndFrame (t0));
+
+                for (int frame = 1; frame <= 59; frame++)
+                {
+                    recorder.Record (FrameTimingMetric::Frame, 16667);
+                    Assert::IsFalse (recorder.EndFrame (t0 + std::chrono::microseconds (frame * 16667)));
+                }
+
+                Assert::IsFalse (recorder.TryGetPublished (published));
+
+                recorder.Record (FrameTimingMetric::Frame, 16667);
+                Assert::IsTrue  (recorder.EndFrame (t0 + std::chrono::seconds (1)));
+
+                Assert::IsTrue   (recorder.TryGetPublished (published));
+                Assert::AreEqual (uint64_t (1),  recorder.GetPublishedGeneration());
+                Assert::AreEqual (uint64_t (60), published.Get (FrameTimingMetric::Frame).GetCount());
+                Assert::AreEqual (1.0,           published.windowSeconds, 1e-9);
+                Assert::AreEqual (uint64_t (60), recorder.GetLastWindow().Get (FrameTimingMetric::Frame).GetCount());
+
+                // The next window holds only its own frames
+                recorder.Record (FrameTimingMetric::Frame, 33333);
+                Assert::IsTrue (recorder.EndFrame (t0 + std::chrono::seconds (2)));
+
+                Assert::IsTrue   (recorder.TryGetPublished (published));
+                Assert::AreEqual (uint64_t (2),     recorder.GetPublishedGeneration());
+                Assert::AreEqual (uint64_t (1),     published.Get (FrameTimingMetric::Frame).GetCount());
+                Assert::AreEqual (int64_t (33333),  published.Get (FrameTimingMetric::Frame).GetMax());
+            }
+
+
+
+
+            TEST_METHOD (Publisher_Stress_ReadersNeverSeeTornOrOlderWindows)
+            {
+                // The writer publishes back to back (far faster than the real
+                // one-per-second) so readers are routinely lapped mid-copy
+                // and must retry.  Every window read must be one whole
+                // generation, and generations must never go backwards.
+                constexpr int            kReaders     = 4;
+                constexpr uint64_t       kGenerations = 20000;
+                FrameTimingPublisher     publisher;
+                std::atomic<bool>        done         { false };
+                std::atomic<int>         torn         { 0 };
+                std::atomic<int>         backwards    { 0 };
+                std::atomic<uint64_t>    reads        { 0 };
+                std::vector<std::thread> readers;
+                FrameTimingStats         latest;
+
+                Assert::IsFalse (publisher.TryGetLatest (latest));
+
+                for (int r = 0; r < kReaders; r++)
+                {
+                    readers.emplace_back ([&] ()
+                    {
+                        FrameTimingStats stats;
+                        double           last  = 0.0;
+                        uint64_t         count = 0;
+
+                        while (!done.load (std::memory_order_acquire))
+                        {
+                            if (!publisher.TryGetLatest (stats))
+                            {
+                                continue;
+                            }
+
+                            int64_t generation = static_cast<int64_t> (stats.windowSeconds);
+                            bool    whole      = true;
+
+                            for (const TimingHistogram & histogram : stats.histograms)
+                            {
+                                whole = whole && histogram.GetCount() == 1 && histogram.GetMax() == generation;
+                            }
+
+                            torn      += whole ? 0 : 1;
+                            backwards += stats.windowSeconds < last ? 1 : 0;
+                            last       = stats.windowSeconds;
+                            count++;
+                        }
+
+                        reads += count;
+                    });
+                }
+
+                for (uint64_t generation = 1; generation <= kGenerations; generation++)
+                {
+                    publisher.Publish (MakeGeneration (generation));
+                }
+
+                done.store (true, std::memory_order_release);
+
+                for (std::thread & reader : readers)
+                {
+                    reader.join();
+                }
+
+                Logger::WriteMessage (std::format ("{} windows published, {} read\n", kGenerations, reads.load()).c_str());
+
+                Assert::IsTrue   (publisher.TryGetLatest (latest));
+                Assert::AreEqual (static_cast<double> (kGenerations), latest.windowSeconds);
+                Assert::AreEqual (kGenerations,                      publisher.GetGeneration());
+                Assert::AreEqual (0,                                 torn.load());
+                Assert::AreEqual (0,                                 backwards.load());
+            }
+    };
+}
@@ -0,0 +1,309 @@
+#include "Pch_MatrixRainTests.h"
+
+#include "..\..\MatrixRainCore\FrameTrace.h"
+
+
+
+
+namespace MatrixRainTests
+{
+    using namespace std::chrono;
+
+
+
+
+    // Every field of pushed event `n` derives from n, so an event copied
+    // while the writer overwrote it shows up as mismatched fields
+    static TraceEvent MakeNumberedEvent (uint64_t n)
+    {
+        return TraceEvent
+               {
+                   .name       = "Numbered",
+                   .startTicks = n,
+                   .endTicks   = n * 3,
+                   .threadId   = static_cast<uint32_t> (n),
+                   .monitor    = static_cast<int32_t>  (n & 0x7fffffff),
+               };
+    }
+
+
+    static bool IsNumberedEventIntact (const TraceEvent & event)
+    {
+        uint64_t n = event.startTicks;
+
+        return event.endTicks == n * 3
+            && event.threadId == static_cast<uint32_t> (n)
+            && event.monitor  == static_cast<int32_t>  (n & 0x7fffffff);
+    }
+
+
+
+
+    // Every collected event named `name`
+    static std::vector<TraceEvent> CollectNamed (const char * name)
+    {
+        std::vector<TraceEvent> events = FrameTrace::CollectEvents();
+
+        std::erase_if (events, [name] (const TraceEvent & event) { return strcmp (event.name, name) != 0; });
+
+        return events;
+    }
+
+
+
+
+    TEST_CLASS (FrameTraceTests)
+    {
+        public:
+
+            TEST_METHOD_CLEANUP (Cleanup)
+            {
+                FrameTrace::Disable();
+                FrameTrace::Clear();
+            }
+
+
+
+
+            //
+            //  TraceRing
+            //
+
+            TEST_METHOD (TraceRing_KeepsTheNewestEventsOldestFirst)
+            {
+                TraceRing               ring (8);
+                std::vector<TraceEvent> events;
+
+                for (uint64_t n = 1; n <= 20; n++)
+                {
+                    ring.Push (MakeNumberedEvent (n));
+                }
+
+                ring.CopyTo (events);
+
+                Assert::AreEqual (size_t (8),    events.size());
+                Assert::AreEqual (uint64_t (20), ring.GetPushCount());
+
+                for (size_t i = 0; i < events.size(); i++)
+                {
+                    Assert::AreEqual (uint64_t (13 + i), events[i].startTicks);
+                    Assert::IsTrue   (IsNumberedEventIntact (events[i]));
+                }
+            }
+
+
+
+
+            TEST_METHOD (TraceRing_ConcurrentCopiesNeverReturnTornEvents)
+            {
+                // A small ring makes the writer lap the reader constantly
+                constexpr uint64_t kEvents = 2'000'000;
+                TraceRing          ring (64);
+                std::atomic<bool>  done    { false };
+                uint64_t           torn    = 0;
+                uint64_t           gaps    = 0;
+                uint64_t           copies  = 0;
+                uint64_t           copied  = 0;
+
+
+
+                std::thread writer ([&]
+                {
+                    for (uint64_t n = 1; n <= kEvents; n++)
+                    {
+                        ring.Push (MakeNumberedEvent (n));
+                    }
+
+                    done = true;
+                });
+
+                std::vector<TraceEvent> events;
+
+                for (;;)
+                {
+                    bool finished = done;
+
+                    events.clear();
+                    ring.CopyTo (events);
+
+                    for (size_t i = 0; i < events.size(); i++)
+                    {
+                        torn += IsNumberedEventIntact (events[i]) ? 0 : 1;
+                        gaps += i > 0 && events[i].startTicks != events[i - 1].startTicks + 1 ? 1 : 0;
+                    }
+
+                    copies++;
+                    copied += events.size();
+
+                    if (finished)
+                    {
+                        break;
+                    }
+                }
+
+                writer.join();
+
+                Logger::WriteMessage (std::format ("{} copies, {} events copied\n", copies, copied).c_str());
+
+                Assert::AreEqual (uint64_t (0), torn);
+                Assert::AreEqual (uint64_t (0), gaps, L"A copy is one contiguous run of events");
+                Assert::AreEqual (kEvents,      events.back().startTicks, L"The last copy ends at the last push");
+            }
+
+
+
+
+            //
+            //  FrameTrace
+            //
+
+            TEST_METHOD (Zones_RecordOnlyWhileEnabled)
+            {
+                {
+                    TraceZone zone ("DisabledZone");
+                }
+
+                FrameTrace::Enable();
+
+                {
+                    TraceZone zone ("EnabledZone");
+
+                    std::this_thread::sleep_for (milliseconds (2));
+                }
+
+                FrameTrace::Disable();
+
+                {
+                    TraceZone zone ("EnabledZone");
+                }
+
+                std::vector<TraceEvent> enabled = CollectNamed ("EnabledZone");
+
+                Assert::IsTrue   (CollectNamed ("DisabledZone").empty());
+                Assert::AreEqual (size_t (1), enabled.size());
+                Assert::IsTrue   (Timestamp::ToDuration (enabled[0].endTicks - enabled[0].startTicks) >= milliseconds (2));
+            }
+
+
+
+
+            TEST_METHOD (Zones_NestedInAMonitorZoneInheritItsMonitor)
+            {
+                FrameTrace::Enable();
+
+                {
+                    TraceZone frame ("OuterFrame", 2);
+
+                    {
+                        TraceZone inner ("InnerPass");
+                    }
+                }
+
+                {
+                    TraceZone after ("AfterFrame");
+                }
+
+                Assert::AreEqual (2,  CollectNamed ("OuterFrame")[0].monitor);
+                Assert::AreEqual (2,  CollectNamed ("InnerPass")[0].monitor);
+                Assert::AreEqual (-1, CollectNamed ("AfterFrame")[0].monitor, L"The monitor ends with its zone");
+            }
+
+
+
+
+            TEST_METHOD (Clear_DropsEventsRecordedBeforeIt)
+            {
+                FrameTrace::Enable();
+
+                {
+                    TraceZone zone ("BeforeClear");
+                }
+
+                FrameTrace::Clear();
+
+                {
+                    TraceZone zone ("AfterClear");
+                }
+
+                Assert::IsTrue   (CollectNamed ("BeforeClear").empty());
+                Assert::AreEqual (size_t (1), CollectNamed ("AfterClear").size());
+            }
+
+
+
+
+            TEST_METHOD (ChromeJson_HoldsEachThreadsZonesAndName)
+            {
+                FrameTrace::Enable();
+
+                std::thread worker ([]
+                {
+                    FrameTrace::SetThreadName ("Test \"worker\"");
+
+                    TraceZone zone ("WorkerZone", 1);
+                });
+
+                worker.join();
+
+                {
+                    TraceZone zone ("MainZone");
+                }
+
+                std::vector<TraceEvent> events = FrameTrace::CollectEvents();
+                std::string             json   = FrameTrace::FormatChromeJson (events);
+
+                Assert::AreEqual (size_t (2), events.size());
+                Assert::AreNotEqual (events[0].threadId, events[1].threadId);
+
+                Assert::IsTrue (json.starts_with ("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+                Assert::IsTrue (json.ends_with   ("]}\n"));
+                Assert::IsTrue (json.find ("\"name\":\"WorkerZone\",\"cat\":\"frame\",\"ph\":\"X\"") != std::string::npos);
+                Assert::IsTrue (json.find ("\"args\":{\"monitor\":1}")                                != std::string::npos);
+                Assert::IsTrue (json.find ("\"name\":\"MainZone\"")                                    != std::string::npos);
+                Assert::IsTrue (json.find ("\"args\":{\"name\":\"Test \\\"worker\\\"\"}")              != std::string::npos, L"Thread names are escaped");
+                Assert::AreEqual (std::count (json.begin(), json.end(), '{'), std::count (json.begin(), json.end(), '}'));
+            }
+
+
+
+
+            TEST_METHOD (Benchmark_DisabledZoneOverhead)
+            {
+                // The disabled path should cost next to nothing over an
+                // empty loop; the enabled path is two timestamps and a push
+                constexpr int kIterations = 5'000'000;
+                volatile int  sink        = 0;
+
+                auto measure = [&] (auto body)
+                {
+                    FrameClock::time_point start = FrameClock::now();
+
+                    for (int i = 0; i < kIterations; i++)
+                    {
+                        body();
+                        sink = i;
+                    }
+
+                    return ToMilliseconds (FrameClock::now() - start) * 1e6 / kIterations;
+                };
+
+                double baseline = measure ([] { });
+                double disabled = measure ([] { TraceZone zone ("BenchmarkZone"); });
+
+                FrameTrace::Enable();
+
+                double enabled  = measure ([] { TraceZone zone ("BenchmarkZone"); });
+
+                FrameTrace::Disable();
+
+                Logger::WriteMessage (std::format ("Empty loop {:.2f} ns, disabled zone {:.2f} ns, enabled zone {:.2f} ns per iteration\n",
+                                                   baseline,
+                                                   disabled,
+                                                   enabled).c_str());
+
+                Assert::AreEqual (FrameTrace::s_kEventsPerThread, CollectNamed ("BenchmarkZone").size(), L"Only the enabled pass records, and the ring keeps its newest events");
+            }
+    };
+
+
+}
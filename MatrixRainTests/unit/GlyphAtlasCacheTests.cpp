@@ -0,0 +1,317 @@
+#include "Pch_MatrixRainTests.h"
+
+#include "..\..\MatrixRainCore\GlyphAtlasCache.h"
+#include "..\..\MatrixRainCore\SoftwareGlyphAtlas.h"
+
+
+
+
+namespace MatrixRainTests
+{
+    static std::filesystem::path GetCacheTestPath (LPCWSTR name)
+    {
+        return std::filesystem::temp_directory_path() / L"GlyphAtlasCacheTests" / name;
+    }
+
+
+
+
+    // A small table in the rain layout: normal/mirrored pairs in a 16-wide grid
+    static std::vector<CachedGlyph> MakeGlyphTable (size_t count)
+    {
+        std::vector<CachedGlyph> glyphs (count);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            glyphs[i].codepoint    = 0x30A0 + static_cast<uint32_t> (i / 2);
+            glyphs[i].mirrored     = static_cast<uint32_t> (i % 2);
+            glyphs[i].uvMin[0]     = static_cast<float> (i % 16)     / 16.0f;
+            glyphs[i].uvMin[1]     = static_cast<float> (i / 16)     / 17.0f;
+            glyphs[i].uvMax[0]     = static_cast<float> (i % 16 + 1) / 16.0f;
+            glyphs[i].uvMax[1]     = static_cast<float> (i / 16 + 1) / 17.0f;
+            glyphs[i].advanceWidth = 0.5f + static_cast<float> (i % 7) * 0.01f;
+        }
+
+        return glyphs;
+    }
+
+
+
+
+    // White premultiplied BGRA from a coverage image, as D2D draws the atlas
+    static std::vector<uint32_t> CoverageToBgra (std::span<const uint8_t> coverage)
+    {
+        std::vector<uint32_t> pixels (coverage.size());
+
+        for (size_t i = 0; i < coverage.size(); i++)
+        {
+            pixels[i] = uint32_t (coverage[i]) * 0x01010101u;
+        }
+
+        return pixels;
+    }
+
+
+
+
+    TEST_CLASS (GlyphAtlasCacheTests)
+    {
+        public:
+            TEST_METHOD (Write_ThenOpen_RoundTripsTableAndPixels)
+            {
+                std::filesystem::path    path   = GetCacheTestPath (L"roundtrip.atlas");
+                std::vector<CachedGlyph> glyphs = MakeGlyphTable (11);
+                std::vector<uint32_t>    pixels (37 * 5);
+                GlyphAtlasCache          cache;
+
+                for (size_t i = 0; i < pixels.size(); i++)
+                {
+                    pixels[i] = static_cast<uint32_t> (i * 0x01020304u);
+                }
+
+                Assert::AreEqual (S_OK, GlyphAtlasCache::Write (path, 0x1234, glyphs, 0.27f, 37, 5, pixels));
+                Assert::AreEqual (S_OK, cache.Open (path, 0x1234));
+
+                Assert::IsTrue   (cache.IsOpen());
+                Assert::AreEqual (uint64_t (0x1234), cache.GetKey());
+                Assert::AreEqual (37u,               cache.GetWidth());
+                Assert::AreEqual (5u,                cache.GetHeight());
+                Assert::AreEqual (0.27f,             cache.GetSpaceAdvanceWidth());
+                Assert::AreEqual (glyphs.size(),     cache.GetGlyphs().size());
+                Assert::IsTrue   (std::ranges::equal (pixels, cache.GetPixels()));
+
+                for (size_t i = 0; i < glyphs.size(); i++)
+                {
+                    Assert::AreEqual (0, memcmp (&glyphs[i], &cache.GetGlyphs()[i], sizeof (CachedGlyph)));
+                }
+
+                // The pixel section must be usable in place as uint32_t
+                Assert::AreEqual (size_t (0), reinterpret_cast<uintptr_t> (cache.GetPixels().data()) % 64);
+
+                cache.Close();
+                Assert::IsFalse (cache.IsOpen());
+                Assert::IsTrue  (cache.GetPixels().empty());
+                std::filesystem::remove (path);
+            }
+
+
+
+
+            TEST_METHOD (Open_RejectsMissingStaleAndDamagedFiles)
+            {
+                std::filesystem::path    path   = GetCacheTestPath (L"damaged.atlas");
+                std::vector<CachedGlyph> glyphs = MakeGlyphTable (4);
+                std::vector<uint32_t>    pixels (16 * 16, 0xFFFFFFFF);
+                GlyphAtlasCache          cache;
+                std::fstream             file;
+
+                Assert::IsTrue (FAILED (cache.Open (GetCacheTestPath (L"missing.atlas"), 1)));
+
+                // Written for another font, size, or layout
+                Assert::AreEqual (S_OK, GlyphAtlasCache::Write (path, 1, glyphs, 0.25f, 16, 16, pixels));
+                Assert::AreEqual (HRESULT_FROM_WIN32 (ERROR_INVALID_DATA), cache.Open (path, 2));
+                Assert::IsFalse  (cache.IsOpen());
+
+                // Truncated, e.g. by a full disk
+                std::filesystem::resize_file (path, std::filesystem::file_size (path) - 4);
+                Assert::AreEqual (HRESULT_FROM_WIN32 (ERROR_INVALID_DATA), cache.Open (path, 1));
+
+                // Not a cache file at all
+                Assert::AreEqual (S_OK, GlyphAtlasCache::Write (path, 1, glyphs, 0.25f, 16, 16, pixels));
+                file.open (path, std::ios::binary | std::ios::in | std::ios::out);
+                file.write ("XXXX", 4);
+                file.close();
+                Assert::AreEqual (HRESULT_FROM_WIN32 (ERROR_INVALID_DATA), cache.Open (path, 1));
+
+                std::filesystem::remove (path);
+            }
+
+
+
+
+            TEST_METHOD (Write_RejectsPixelCountThatDoesNotMatchSize)
+            {
+                std::vector<uint32_t> pixels (10);
+
+                Assert::AreEqual (E_INVALIDARG, GlyphAtlasCache::Write (GetCacheTestPath (L"bad.atlas"), 1, {}, 0.25f, 4, 4, pixels));
+                Assert::IsFalse  (std::filesystem::exists (GetCacheTestPath (L"bad.atlas")));
+            }
+
+
+
+
+            TEST_METHOD (Write_ConcurrentWritersLeaveOneWholeFile)
+            {
+                // Writers sharing a fixed temporary name truncate each
+                // other's file before the rename; every writer's pixels
+                // carry its index, so a mix of two writes shows up
+                constexpr int            kWriters  = 8;
+                constexpr int            kRepeats  = 5;
+                std::filesystem::path    directory = GetCacheTestPath (L"concurrent");
+                std::filesystem::path    path      = directory / L"shared.atlas";
+                std::vector<CachedGlyph> glyphs    = MakeGlyphTable (4);
+                std::vector<std::thread> writers;
+                std::atomic<int>         written   { 0 };
+                GlyphAtlasCache          cache;
+                size_t                   leftovers = 0;
+
+                std::filesystem::remove_all (directory);
+
+                for (int writer = 0; writer < kWriters; writer++)
+                {
+                    writers.emplace_back ([&, writer]
+                    {
+                        std::vector<uint32_t> pixels (512 * 512, 0xFF000000u | static_cast<uint32_t> (writer));
+
+                        for (int repeat = 0; repeat < kRepeats; repeat++)
+                        {
+                            // The rename can lose to a reader or another
+                            // rename on Windows; that write is just dropped
+                            if (SUCCEEDED (GlyphAtlasCache::Write (path, 1, glyphs, 0.25f, 512, 512, pixels)))
+                            {
+                                written++;
+                            }
+                        }
+                    });
+                }
+
+                for (std::thread & writer : writers)
+                {
+                    writer.join();
+                }
+
+                Assert::IsTrue   (written > 0);
+                Assert::AreEqual (S_OK, cache.Open (path, 1));
+                Assert::IsTrue   (std::ranges::all_of (cache.GetPixels(), [&] (uint32_t pixel) { return pixel == cache.GetPixels()[0]; }));
+
+                cache.Close();
+
+                for (const std::filesystem::directory_entry & entry : std::filesystem::directory_iterator (directory))
+                {
+                    leftovers += entry.path() != path ? 1 : 0;
+                }
+
+                Assert::AreEqual (size_t (0), leftovers, L"Every temporary file is renamed or removed");
+                std::filesystem::remove_all (directory);
+            }
+
+
+
+
+            TEST_METHOD (ComputeKey_CoversLayoutButNotAdvanceWidths)
+            {
+                std::vector<CachedGlyph> glyphs = MakeGlyphTable (8);
+                uint64_t                 key    = GlyphAtlasCache::ComputeKey (L"Consolas", 80.0f, 1.0f, 2048, 2048, glyphs);
+                std::vector<CachedGlyph> moved  = glyphs;
+                std::vector<CachedGlyph> wider  = glyphs;
+
+                moved[3].uvMax[0]     += 1.0f / 2048.0f;
+                wider[3].advanceWidth += 0.1f;
+
+                Assert::AreEqual (key, GlyphAtlasCache::ComputeKey (L"Consolas", 80.0f, 1.0f, 2048, 2048, glyphs));
+                Assert::AreEqual (key, GlyphAtlasCache::ComputeKey (L"Consolas", 80.0f, 1.0f, 2048, 2048, wider));
+
+                Assert::AreNotEqual (key, GlyphAtlasCache::ComputeKey (L"Segoe UI", 80.0f, 1.0f,  2048, 2048, glyphs));
+                Assert::AreNotEqual (key, GlyphAtlasCache::ComputeKey (L"Consolas", 81.0f, 1.0f,  2048, 2048, glyphs));
+                Assert::AreNotEqual (key, GlyphAtlasCache::ComputeKey (L"Consolas", 80.0f, 1.25f, 2048, 2048, glyphs));
+                Assert::AreNotEqual (key, GlyphAtlasCache::ComputeKey (L"Consolas", 80.0f, 1.0f,  1024, 2048, glyphs));
+                Assert::AreNotEqual (key, GlyphAtlasCache::ComputeKey (L"Consolas", 80.0f, 1.0f,  2048, 2048, moved));
+                Assert::AreNotEqual (key, GlyphAtlasCache::ComputeKey (L"Consolas", 80.0f, 1.0f,  2048, 2048, std::span (glyphs).first (7)));
+            }
+
+
+
+
+            TEST_METHOD (GetDefaultPath_NamesFileByKey)
+            {
+                std::filesystem::path path = GlyphAtlasCache::GetDefaultPath (L"RainAtlas", 0x00AB);
+
+                Assert::IsFalse  (path.empty());
+                Assert::AreEqual (std::wstring (L"RainAtlas-00000000000000ab.atlas"), path.filename().wstring());
+                Assert::AreEqual (std::wstring (L"MatrixRain"),                       path.parent_path().filename().wstring());
+            }
+
+
+
+
+            TEST_METHOD (MappedPixels_LoadIntoSoftwareAtlas)
+            {
+                // The CPU renderer can take its atlas straight from the mapping
+                std::filesystem::path path = GetCacheTestPath (L"software.atlas");
+                SoftwareGlyphAtlas    built;
+                SoftwareGlyphAtlas    loaded;
+                GlyphAtlasCache       cache;
+
+                built.BuildProcedural();
+
+                Assert::AreEqual (S_OK, GlyphAtlasCache::Write (path, 7, {}, 0.25f, built.GetWidth(), built.GetHeight(), CoverageToBgra (built.Coverage())));
+                Assert::AreEqual (S_OK, cache.Open (path, 7));
+                Assert::AreEqual (S_OK, loaded.LoadPremultipliedBgra (cache.GetWidth(),
+                                                                      cache.GetHeight(),
+                                                                      reinterpret_cast<const uint8_t *> (cache.GetPixels().data()),
+                                                                      cache.GetWidth() * 4));
+
+                Assert::IsTrue (std::ranges::equal (built.Coverage(), loaded.Coverage()));
+
+                cache.Close();
+                std::filesystem::remove (path);
+            }
+
+
+
+
+            TEST_METHOD (Benchmark_ColdBuildVsWarmCache)
+            {
+                // Cold: build the 2048x2048 atlas, expand it to BGRA and
+                // write the cache (the D2D rasterizer stands in as the
+                // procedural build here, which is far cheaper than drawing
+                // 272 glyphs through DirectWrite, so the gap is a floor).
+                // Warm: map the cache and hand the pixels to the consumer.
+                using Clock = std::chrono::steady_clock;
+
+                constexpr int            kRuns  = 5;
+                std::filesystem::path    path   = GetCacheTestPath (L"benchmark.atlas");
+                std::vector<CachedGlyph> glyphs = MakeGlyphTable (273);
+                double                   coldMs = 1e9;
+                double                   openMs = 1e9;
+                double                   warmMs = 1e9;
+
+                for (int run = 0; run < kRuns; run++)
+                {
+                    Clock::time_point  start = Clock::now();
+                    SoftwareGlyphAtlas atlas;
+
+                    atlas.BuildProcedural();
+                    Assert::AreEqual (S_OK, GlyphAtlasCache::Write (path, 9, glyphs, 0.25f, atlas.GetWidth(), atlas.GetHeight(), CoverageToBgra (atlas.Coverage())));
+
+                    coldMs = std::min (coldMs, std::chrono::duration<double, std::milli> (Clock::now() - start).count());
+                }
+
+                for (int run = 0; run < kRuns; run++)
+                {
+                    Clock::time_point  start = Clock::now();
+                    GlyphAtlasCache    cache;
+                    SoftwareGlyphAtlas atlas;
+                    Clock::time_point  opened;
+
+                    Assert::AreEqual (S_OK, cache.Open (path, 9));
+                    opened = Clock::now();
+
+                    Assert::AreEqual (S_OK, atlas.LoadPremultipliedBgra (cache.GetWidth(),
+                                                                         cache.GetHeight(),
+                                                                         reinterpret_cast<const uint8_t *> (cache.GetPixels().data()),
+                                                                         cache.GetWidth() * 4));
+
+                    openMs = std::min (openMs, std::chrono::duration<double, std::milli> (opened       - start).count());
+                    warmMs = std::min (warmMs, std::chrono::duration<double, std::milli> (Clock::now() - start).count());
+                }
+
+                std::filesystem::remove (path);
+
+                Logger::WriteMessage (std::format ("Atlas 2048x2048: cold build+write {:.2f} ms, warm open {:.3f} ms, open+load {:.2f} ms\n",
+                                                   coldMs, openMs, warmMs).c_str());
+
+                Assert::IsTrue (warmMs < coldMs);
+            }
+    };
+}
@@ -0,0 +1,308 @@
+#include "Pch_MatrixRainTests.h"
+
+#include "..\..\MatrixRainCore\GlyphBlitter.h"
+#include "..\..\MatrixRainCore\AnimationSystem.h"
+#include "..\..\MatrixRainCore\CharacterSet.h"
+#include "..\..\MatrixRainCore\DensityController.h"
+#include "..\..\MatrixRainCore\SoftwareGlyphAtlas.h"
+#include "..\..\MatrixRainCore\SoftwareRenderSystem.h"
+#include "..\..\MatrixRainCore\SoftwareSurface.h"
+#include "..\..\MatrixRainCore\Viewport.h"
+
+
+
+
+namespace MatrixRainTests
+{
+
+
+    static const wchar_t * BlitPathName (BlitPath path)
+    {
+        switch (path)
+        {
+            case BlitPath::Avx2: return L"AVX2";
+            case BlitPath::Neon: return L"NEON";
+            default:             return L"Scalar";
+        }
+    }
+
+
+
+
+    // Random quads over and around a small target: subpixel positions,
+    // partial off-screen clipping, glyph-cell UVs and odd scales
+    static std::vector<GlyphQuad> MakeRandomQuads (uint32_t seed, size_t count, float targetWidth, float targetHeight)
+    {
+        std::mt19937                          rng (seed);
+        std::uniform_real_distribution<float> unit (0.0f, 1.0f);
+        std::vector<GlyphQuad>                quads;
+        constexpr float                       kCellU = float (SoftwareGlyphAtlas::s_kCellWidth)  / SoftwareGlyphAtlas::s_kAtlasSize;
+        constexpr float                       kCellV = float (SoftwareGlyphAtlas::s_kCellHeight) / SoftwareGlyphAtlas::s_kAtlasSize;
+        constexpr float                       kPadU  = float (SoftwareGlyphAtlas::s_kGlyphPadding) / SoftwareGlyphAtlas::s_kAtlasSize;
+
+        for (size_t i = 0; i < count; i++)
+        {
+            float     scale = 0.4f + unit (rng) * 2.0f;
+            int       cell  = static_cast<int> (unit (rng) * 271.0f);
+            GlyphQuad quad;
+
+            quad.x0         = -20.0f + unit (rng) * (targetWidth  + 20.0f);
+            quad.y0         = -30.0f + unit (rng) * (targetHeight + 30.0f);
+            quad.x1         = quad.x0 + 24.0f * scale;
+            quad.y1         = quad.y0 + 36.0f * scale;
+            quad.u0         = (cell % 16) * kCellU + kPadU;
+            quad.v0         = (cell / 16) * kCellV + kPadU;
+            quad.u1         = quad.u0 + kCellU - 2.0f * kPadU;
+            quad.v1         = quad.v0 + kCellV - 2.0f * kPadU;
+            quad.color[0]   = unit (rng);
+            quad.color[1]   = unit (rng);
+            quad.color[2]   = unit (rng);
+            quad.color[3]   = 0.5f + unit (rng) * 0.5f;
+            quad.brightness = unit (rng);
+
+            quads.push_back (quad);
+        }
+
+        return quads;
+    }
+
+
+
+
+    static int MaxChannelDifference (const SoftwareSurface & a, const SoftwareSurface & b)
+    {
+        int worst = 0;
+
+        for (size_t i = 0; i < a.Pixels().size(); i++)
+        {
+            for (int channel = 0; channel < 4; channel++)
+            {
+                int ca = static_cast<int> ((a.Pixels()[i] >> (channel * 8)) & 0xFF);
+                int cb = static_cast<int> ((b.Pixels()[i] >> (channel * 8)) & 0xFF);
+
+                worst = std::max (worst, abs (ca - cb));
+            }
+        }
+
+        return worst;
+    }
+
+
+
+
+    TEST_CLASS (GlyphBlitterTests)
+    {
+        public:
+
+            TEST_CLASS_INITIALIZE (ClassSetup)
+            {
+                CharacterSet::GetInstance().Initialize();
+            }
+
+
+
+
+            TEST_METHOD (EveryPath_MatchesReference_AllBlendModes)
+            {
+                SoftwareGlyphAtlas     atlas;
+                std::vector<GlyphQuad> quads = MakeRandomQuads (1234, 400, 160.0f, 120.0f);
+
+                atlas.BuildProcedural();
+
+                for (BlitPath path : { BlitPath::Scalar, BlitPath::Avx2, BlitPath::Neon })
+                {
+                    if (!GlyphBlitter::IsPathSupported (path))
+                    {
+                        continue;
+                    }
+
+                    for (GlyphBlendMode mode : { GlyphBlendMode::Alpha, GlyphBlendMode::Premultiplied, GlyphBlendMode::Additive })
+                    {
+                        GlyphBlitter    blitter (path);
+                        SoftwareSurface expected;
+                        SoftwareSurface actual;
+
+                        expected.Resize (160, 120);
+                        actual.Resize   (160, 120);
+
+                        // Mid-gray, half-alpha background exercises the destination terms
+                        expected.Clear (0x80808080);
+                        actual.Clear   (0x80808080);
+
+                        for (const GlyphQuad & quad : quads)
+                        {
+                            RasterizeGlyphQuadReference (expected, atlas, quad, mode);
+                            blitter.Blit (actual, atlas, quad, mode);
+                        }
+
+                        int worst = MaxChannelDifference (expected, actual);
+
+                        Assert::IsTrue (worst <= 1, std::format (L"{} path, blend mode {}: max channel difference {}", BlitPathName (path), static_cast<int> (mode), worst).c_str());
+                    }
+                }
+            }
+
+
+
+
+            TEST_METHOD (EveryPath_ClampsAtAtlasEdges)
+            {
+                // UVs that run off every side of a tiny atlas hit the clamp
+                // folding in PrepareQuad/ResolveRow
+                SoftwareGlyphAtlas   atlas;
+                std::vector<uint8_t> texels = { 10, 200, 30, 255, 90, 0, 60, 120, 180 };
+                GlyphQuad            quad   = { 0.0f, 0.0f, 16.0f, 16.0f, -0.5f, -0.5f, 1.5f, 1.5f, { 1.0f, 0.5f, 0.25f, 1.0f }, 0.9f };
+
+                atlas.LoadCoverage (3, 3, texels);
+
+                for (BlitPath path : { BlitPath::Scalar, BlitPath::Avx2, BlitPath::Neon })
+                {
+                    if (!GlyphBlitter::IsPathSupported (path))
+                    {
+                        continue;
+                    }
+
+                    GlyphBlitter    blitter (path);
+                    SoftwareSurface expected;
+                    SoftwareSurface actual;
+
+                    expected.Resize (16, 16);
+                    actual.Resize   (16, 16);
+
+                    RasterizeGlyphQuadReference (expected, atlas, quad, GlyphBlendMode::Alpha);
+                    blitter.Blit (actual, atlas, quad, GlyphBlendMode::Alpha);
+
+                    Assert::IsTrue (MaxChannelDifference (expected, actual) <= 1, BlitPathName (path));
+                }
+            }
+
+
+
+
+            TEST_METHOD (EmptyCoverage_LeavesDestinationBytesExact)
+            {
+                SoftwareGlyphAtlas   atlas;
+                std::vector<uint8_t> texels (64 * 64, 0);
+                GlyphQuad            quad = { 0.0f, 0.0f, 13.0f, 7.0f, 0.0f, 0.0f, 1.0f, 1.0f, { 1.0f, 1.0f, 1.0f, 1.0f }, 1.0f };
+
+                atlas.LoadCoverage (64, 64, texels);
+
+                for (BlitPath path : { BlitPath::Scalar, BlitPath::Avx2, BlitPath::Neon })
+                {
+                    if (!GlyphBlitter::IsPathSupported (path))
+                    {
+                        continue;
+                    }
+
+                    GlyphBlitter    blitter (path);
+                    SoftwareSurface surface;
+
+                    surface.Resize (16, 8);
+                    surface.Clear (0x12345678);
+                    blitter.Blit (surface, atlas, quad, GlyphBlendMode::Alpha);
+
+                    for (uint32_t pixel : surface.Pixels())
+                    {
+                        Assert::AreEqual (0x12345678u, pixel, BlitPathName (path));
+                    }
+                }
+            }
+
+
+
+
+            TEST_METHOD (UnsupportedPath_FallsBackToScalar)
+            {
+                for (BlitPath path : { BlitPath::Avx2, BlitPath::Neon })
+                {
+                    GlyphBlitter blitter (path);
+
+                    Assert::IsTrue (blitter.GetPath() == (GlyphBlitter::IsPathSupported (path) ? path : BlitPath::Scalar));
+                }
+
+                Assert::IsTrue (GlyphBlitter::IsPathSupported (GlyphBlitter::DetectBestPath()));
+            }
+
+
+
+
+            TEST_METHOD (Benchmark_GlyphsPerSecond)
+            {
+                // Blits the quads of a warmed-up rain frame (100% density) at
+                // each target size with the reference, the scalar kernel and
+                // the best SIMD kernel for this CPU.
+                struct Target
+                {
+                    const char * name;
+                    UINT         width;
+                    UINT         height;
+                };
+
+                const Target targets[] =
+                {
+                    { "1080p", 1920, 1080 },
+                    { "4K",    3840, 2160 },
+                    { "8K",    7680, 4320 },
+                };
+
+                for (const Target & target : targets)
+                {
+                    Viewport             viewport;
+                    viewport.Resize (static_cast<float> (target.width), static_cast<float> (target.height));
+                    DensityController    densityController (viewport, 24.0f);
+                    AnimationSystem      animationSystem;
+                    SoftwareRenderSystem renderSystem (target.width, target.height);
+                    RenderParams         params;
+                    SoftwareSurface      surface;
+
+                    densityController.SetPercentage (100);
+                    animationSystem.Initialize (viewport, densityController);
+                    renderSystem.BuildGlyphAtlas();
+
+                    for (int frame = 0; frame < 180; frame++)
+                    {
+                        animationSystem.Update (1.0f / 60.0f);
+                    }
+
+                    renderSystem.Render (animationSystem, viewport, params);
+                    surface.Resize (target.width, target.height);
+
+                    std::vector<GlyphQuad> quads (renderSystem.GetQuads().begin(), renderSystem.GetQuads().end());
+
+                    auto measure = [&] (auto && blitAll)
+                    {
+                        constexpr int kRepeats = 3;
+                        auto          start    = std::chrono::steady_clock::now();
+
+                        for (int i = 0; i < kRepeats; i++)
+                        {
+                            surface.Clear (SoftwareSurface::s_kOpaqueBlack);
+                            blitAll();
+                        }
+
+                        double seconds = std::chrono::duration<double> (std::chrono::steady_clock::now() - start).count();
+
+                        return double (quads.size()) * kRepeats / seconds;
+                    };
+
+                    GlyphBlitter scalarBlitter (BlitPath::Scalar);
+                    GlyphBlitter bestBlitter;
+
+                    double referenceRate = measure ([&] { for (const GlyphQuad & q : quads) RasterizeGlyphQuadReference (surface, renderSystem.GetGlyphAtlas(), q, GlyphBlendMode::Alpha); });
+                    double scalarRate    = measure ([&] { for (const GlyphQuad & q : quads) scalarBlitter.Blit (surface, renderSystem.GetGlyphAtlas(), q, GlyphBlendMode::Alpha); });
+                    double bestRate      = measure ([&] { for (const GlyphQuad & q : quads) bestBlitter.Blit   (surface, renderSystem.GetGlyphAtlas(), q, GlyphBlendMode::Alpha); });
+
+                    Logger::WriteMessage (std::format ("GlyphBlitter {} ({} glyphs/frame): reference {:.0f} K glyphs/s, scalar {:.0f} K glyphs/s, {} {:.0f} K glyphs/s ({:.1f}x reference)\n",
+                                                       target.name,
+                                                       quads.size(),
+                                                       referenceRate / 1e3,
+                                                       scalarRate    / 1e3,
+                                                       bestBlitter.GetPath() == BlitPath::Avx2 ? "AVX2" : bestBlitter.GetPath() == BlitPath::Neon ? "NEON" : "scalar",
+                                                       bestRate      / 1e3,
+                                                       bestRate / referenceRate).c_str());
+
+                    Assert::IsTrue (quads.size() > 0);
+                }
+            }
+    };
+}
@@ -0,0 +1,314 @@
+#include "Pch_MatrixRainTests.h"
+
+#include "..\..\MatrixRainCore\InstanceStore.h"
+#include "..\..\MatrixRainCore\AnimationSystem.h"
+#include "..\..\MatrixRainCore\CharacterSet.h"
+#include "..\..\MatrixRainCore\DensityController.h"
+#include "..\..\MatrixRainCore\Viewport.h"
+
+
+
+
+namespace MatrixRainTests
+{
+
+
+    static OverlayCharacter MakeOverlay (size_t glyphIndex, float x, float y, float brightness)
+    {
+        OverlayCharacter overlay;
+
+        overlay.character.glyphIndex     = glyphIndex;
+        overlay.character.color          = Color4 (0.0f, 1.0f, 0.0f, 1.0f);
+        overlay.character.brightness     = brightness;
+        overlay.character.positionOffset = Vector2 (0.0f, y);
+        overlay.position                 = Vector3 (x, 0.0f, 50.0f);
+        return overlay;
+    }
+
+
+
+
+    TEST_CLASS (InstanceStoreTests)
+    {
+        public:
+
+            TEST_CLASS_INITIALIZE (ClassSetup)
+            {
+                CharacterSet::GetInstance().Initialize();
+            }
+
+
+
+
+            TEST_METHOD (FirstUpdate_AllSlotsDirtyInOneSpan)
+            {
+                AnimationSystem animationSystem;
+                InstanceStore   store;
+
+                animationSystem.SetOverlayCharacters ({ MakeOverlay (0, 0, 0, 1.0f), MakeOverlay (1, 24, 0, 1.0f), MakeOverlay (2, 48, 0, 1.0f) });
+                store.Update (animationSystem);
+
+                Assert::AreEqual (size_t (3), store.GetStream().size());
+                Assert::AreEqual (size_t (1), store.GetDirtySpans().size());
+                Assert::AreEqual (0u,         store.GetDirtySpans()[0].first);
+                Assert::AreEqual (3u,         store.GetDirtySpans()[0].count);
+                Assert::AreEqual (size_t (3), store.GetUploadStats().dirtySlotCount);
+            }
+
+
+
+
+            TEST_METHOD (BrightnessOnlyChange_UploadsStreamOnly)
+            {
+                AnimationSystem animationSystem;
+                InstanceStore   store;
+
+                animationSystem.SetOverlayCharacters ({ MakeOverlay (0, 0, 0, 1.0f), MakeOverlay (1, 24, 0, 1.0f) });
+                store.Update (animationSystem);
+
+                animationSystem.SetOverlayCharacters ({ MakeOverlay (0, 0, 0, 0.5f), MakeOverlay (1, 24, 0, 0.25f) });
+                store.Update (animationSystem);
+
+                const InstanceUploadStats & stats = store.GetUploadStats();
+
+                Assert::IsTrue    (store.GetDirtySpans().empty());
+                Assert::AreEqual  (size_t (0), stats.staticBytes);
+                Assert::AreEqual  (2 * sizeof (RainInstanceStream), stats.streamBytes);
+                Assert::AreEqual  (0.5f,  store.GetStream()[0].brightness);
+                Assert::AreEqual  (0.25f, store.GetStream()[1].brightness);
+            }
+
+
+
+
+            TEST_METHOD (GlyphMutation_DirtiesOnlyThatSlot)
+            {
+                AnimationSystem animationSystem;
+                InstanceStore   store;
+
+                animationSystem.SetOverlayCharacters ({ MakeOverlay (0, 0, 0, 1.0f), MakeOverlay (1, 24, 0, 1.0f), MakeOverlay (2, 48, 0, 1.0f) });
+                store.Update (animationSystem);
+
+                uint32_t middleSlot = store.GetStream()[1].slot;
+
+                animationSystem.SetOverlayCharacters ({ MakeOverlay (0, 0, 0, 1.0f), MakeOverlay (5, 24, 0, 1.0f), MakeOverlay (2, 48, 0, 1.0f) });
+                store.Update (animationSystem);
+
+                Assert::AreEqual (size_t (1), store.GetDirtySpans().size());
+                Assert::AreEqual (middleSlot, store.GetDirtySpans()[0].first);
+                Assert::AreEqual (1u,         store.GetDirtySpans()[0].count);
+                Assert::AreEqual (middleSlot, store.GetStream()[1].slot, L"Slot must stay stable across a mutation");
+            }
+
+
+
+
+            TEST_METHOD (RemovedCharacter_SlotIsRecycled)
+            {
+                AnimationSystem animationSystem;
+                InstanceStore   store;
+
+                animationSystem.SetOverlayCharacters ({ MakeOverlay (0, 0, 0, 1.0f), MakeOverlay (1, 24, 0, 1.0f) });
+                store.Update (animationSystem);
+
+                uint32_t lastSlot = store.GetStream()[1].slot;
+
+                animationSystem.SetOverlayCharacters ({ MakeOverlay (0, 0, 0, 1.0f) });
+                store.Update (animationSystem);
+
+                Assert::AreEqual (size_t (1), store.GetFreeCount());
+
+                animationSystem.SetOverlayCharacters ({ MakeOverlay (0, 0, 0, 1.0f), MakeOverlay (7, 72, 0, 1.0f) });
+                store.Update (animationSystem);
+
+                Assert::AreEqual (size_t (2), store.GetSlotCount(), L"Freed slot should be reused instead of growing");
+                Assert::AreEqual (lastSlot,   store.GetStream()[1].slot);
+                Assert::AreEqual (size_t (1), store.GetUploadStats().dirtySlotCount, L"A reused slot is always re-uploaded");
+            }
+
+
+
+
+            TEST_METHOD (SpansMergeAcrossSmallCleanGaps)
+            {
+                AnimationSystem               animationSystem;
+                InstanceStore                 store;
+                std::vector<OverlayCharacter> overlays;
+
+                for (size_t i = 0; i < 20; i++)
+                {
+                    overlays.push_back (MakeOverlay (0, i * 24.0f, 0, 1.0f));
+                }
+
+                animationSystem.SetOverlayCharacters (overlays);
+                store.Update (animationSystem);
+
+                // Slots 0 and 3 (gap of 2) merge; slot 15 is too far away
+                overlays[0].character.glyphIndex  = 1;
+                overlays[3].character.glyphIndex  = 1;
+                overlays[15].character.glyphIndex = 1;
+
+                animationSystem.SetOverlayCharacters (overlays);
+                store.Update (animationSystem);
+
+                Assert::AreEqual (size_t (2), store.GetDirtySpans().size());
+                Assert::AreEqual (0u,  store.GetDirtySpans()[0].first);
+                Assert::AreEqual (4u,  store.GetDirtySpans()[0].count);
+                Assert::AreEqual (15u, store.GetDirtySpans()[1].first);
+                Assert::AreEqual (1u,  store.GetDirtySpans()[1].count);
+            }
+
+
+
+
+            TEST_METHOD (BuildStaticRecord_WhiteLeadKeepsColor_TrailTakesScheme)
+            {
+                CharacterInstance  lead;
+                CharacterInstance  trail;
+                RainInstanceStatic leadRecord;
+                RainInstanceStatic trailRecord;
+
+                lead.color  = Color4 (1.0f, 1.0f, 1.0f, 1.0f);
+                trail.color = Color4 (0.0f, 1.0f, 0.0f, 0.8f);
+
+                InstanceStore::BuildStaticRecord (lead,  Vector3 (10.0f, 0.0f, 40.0f), leadRecord);
+                InstanceStore::BuildStaticRecord (trail, Vector3 (10.0f, 0.0f, 40.0f), trailRecord);
+
+                Assert::AreEqual (0.0f, leadRecord.schemeTint);
+                Assert::AreEqual (1.0f, leadRecord.color[0]);
+                Assert::AreEqual (1.0f, trailRecord.schemeTint);
+                Assert::AreEqual (0.0f, trailRecord.color[1], L"Tinted rgb is zeroed so it never causes a spurious diff");
+                Assert::AreEqual (0.8f, trailRecord.color[3]);
+                Assert::AreEqual (10.0f, trailRecord.position[0]);
+            }
+
+
+
+
+            TEST_METHOD (StreaksKeepSlotsWhileFading)
+            {
+                // Real streaks: a character keeps its slot from drop until
+                // it fades out, even as the tail is erased from the front.
+                Viewport          viewport;
+                viewport.Resize (1920.0f, 1080.0f);
+                DensityController densityController (viewport, 24.0f);
+                AnimationSystem   animationSystem;
+                InstanceStore     store;
+
+                animationSystem.Initialize (viewport, densityController);
+
+                for (int i = 0; i < 180; i++)
+                {
+                    animationSystem.Update (1.0f / 60.0f);
+                }
+
+                store.Update (animationSystem);
+
+                Assert::IsFalse (store.GetStream().empty());
+
+                std::map<std::pair<uint64_t, uint64_t>, uint32_t> before;
+                size_t                                            index = 0;
+
+                // Stream order is the depth-sorted streak order; rebuild it
+                // the same way to map each entry back to its character.
+                std::vector<const CharacterStreak *> sorted;
+
+                for (const CharacterStreak & streak : animationSystem.GetStreaks())
+                {
+                    sorted.push_back (&streak);
+                }
+
+                std::stable_sort (sorted.begin(), sorted.end(),
+                    [](const CharacterStreak * a, const CharacterStreak * b) { return a->GetPosition().z > b->GetPosition().z; });
+
+                for (const CharacterStreak * streak : sorted)
+                {
+                    for (const CharacterInstance & character : streak->GetCharacters())
+                    {
+                        before[{ streak->GetID(), character.sequence }] = store.GetStream()[index++].slot;
+                    }
+                }
+
+                animationSystem.Update (1.0f / 60.0f);
+                store.Update (animationSystem);
+
+                sorted.clear();
+
+                for (const CharacterStreak & streak : animationSystem.GetStreaks())
+                {
+                    sorted.push_back (&streak);
+                }
+
+                std::stable_sort (sorted.begin(), sorted.end(),
+                    [](const CharacterStreak * a, const CharacterStreak * b) { return a->GetPosition().z > b->GetPosition().z; });
+
+                index = 0;
+
+                for (const CharacterStreak * streak : sorted)
+                {
+                    for (const CharacterInstance & character : streak->GetCharacters())
+                    {
+                        auto it = before.find ({ streak->GetID(), character.sequence });
+
+                        if (it != before.end())
+                        {
+                            Assert::AreEqual (it->second, store.GetStream()[index].slot);
+                        }
+
+                        index++;
+                    }
+                }
+            }
+
+
+
+
+            TEST_METHOD (Headless_BytesUploadedPerFrame)
+            {
+                // Headless harness: run the simulation at 60 fps for 10 s on
+                // a 1080p viewport and compare the incremental upload against
+                // rebuilding the whole 64-byte-per-character instance stream.
+                Viewport          viewport;
+                viewport.Resize (1920.0f, 1080.0f);
+                DensityController densityController (viewport, 24.0f);
+                AnimationSystem   animationSystem;
+                InstanceStore     store;
+                size_t            totalBytes      = 0;
+                size_t            totalFullBytes  = 0;
+                size_t            totalSpans      = 0;
+                size_t            totalInstances  = 0;
+                constexpr int     kWarmupFrames   = 120;
+                constexpr int     kMeasureFrames  = 600;
+
+                animationSystem.Initialize (viewport, densityController);
+
+                for (int frame = 0; frame < kWarmupFrames + kMeasureFrames; frame++)
+                {
+                    animationSystem.Update (1.0f / 60.0f);
+                    store.Update (animationSystem);
+
+                    if (frame < kWarmupFrames)
+                    {
+                        continue;
+                    }
+
+                    const InstanceUploadStats & stats = store.GetUploadStats();
+
+                    totalBytes     += stats.TotalBytes();
+                    totalFullBytes += stats.fullRebuildBytes;
+                    totalSpans     += stats.spanCount;
+                    totalInstances += stats.instanceCount;
+                }
+
+                Logger::WriteMessage (std::format ("InstanceStore 1080p: {:.0f} instances/frame, {:.0f} B/frame incremental vs {:.0f} B/frame full rebuild ({:.1f}%), {:.1f} spans/frame\n",
+                                                   double (totalInstances) / kMeasureFrames,
+                                                   double (totalBytes)     / kMeasureFrames,
+                                                   double (totalFullBytes) / kMeasureFrames,
+                                                   100.0 * double (totalBytes) / double (totalFullBytes),
+                                                   double (totalSpans)     / kMeasureFrames).c_str());
+
+                Assert::IsTrue (totalInstances > 0);
+                Assert::IsTrue (totalBytes < totalFullBytes / 2, L"Incremental upload should be well under half of a full rebuild");
+            }
+    };
+}
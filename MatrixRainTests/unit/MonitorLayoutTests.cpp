@@ -239,6 +239,59 @@ namespace MatrixRainTests
                 Assert::AreEqual (LONG (1920), placements[1].size.cx);
                 Assert::AreEqual (LONG (1080), placements[1].size.cy);
             }
+
+
+
+
+            TEST_METHOD (VirtualDesktop_UnionAndRegionsRelativeToItsTopLeft)
+            {
+                std::vector<MonitorInfo> monitors;
+                monitors.push_back (MakeMonitor (0, 0, 1920, 1080, 96, true));
+                monitors.push_back (MakeMonitor (-2560, -360, 0, 1080, 96, false));   // taller, left of and above primary
+
+                VirtualDesktopLayout layout = PlanVirtualDesktop (PlanFullscreenPlacements (monitors));
+
+                Assert::AreEqual (LONG (-2560), layout.origin.x);
+                Assert::AreEqual (LONG (-360),  layout.origin.y);
+                Assert::AreEqual (LONG (4480),  layout.size.cx);
+                Assert::AreEqual (LONG (1440),  layout.size.cy);
+                Assert::AreEqual (size_t (2),   layout.regions.size());
+                Assert::AreEqual (2560.0f,      layout.regions[0].left);
+                Assert::AreEqual (360.0f,       layout.regions[0].top);
+                Assert::AreEqual (1920.0f,      layout.regions[0].width);
+                Assert::AreEqual (1080.0f,      layout.regions[0].height);
+                Assert::AreEqual (0.0f,         layout.regions[1].left);
+                Assert::AreEqual (0.0f,         layout.regions[1].top);
+                Assert::AreEqual (1.0f,         layout.columnCoverage);
+            }
+
+
+
+
+            TEST_METHOD (VirtualDesktop_StackedMonitorsCoverEachColumnTwice)
+            {
+                std::vector<MonitorInfo> monitors;
+                monitors.push_back (MakeMonitor (0, 0,    1920, 1080, 96, true));
+                monitors.push_back (MakeMonitor (0, 1080, 1920, 2160, 96, false));
+
+                VirtualDesktopLayout layout = PlanVirtualDesktop (PlanFullscreenPlacements (monitors));
+
+                Assert::AreEqual (LONG (1920), layout.size.cx);
+                Assert::AreEqual (LONG (2160), layout.size.cy);
+                Assert::AreEqual (1080.0f,     layout.regions[1].top);
+                Assert::AreEqual (2.0f,        layout.columnCoverage);
+            }
+
+
+
+
+            TEST_METHOD (VirtualDesktop_NoPlacements_IsEmpty)
+            {
+                VirtualDesktopLayout layout = PlanVirtualDesktop (std::vector<MonitorPlacement>{});
+
+                Assert::AreEqual (LONG (0),   layout.size.cx);
+                Assert::AreEqual (size_t (0), layout.regions.size());
+            }
     };
 
 
@@ -0,0 +1,301 @@
+#include "Pch_MatrixRainTests.h"
+
+#include "..\..\MatrixRainCore\Overlay.h"
+#include "..\..\MatrixRainCore\OverlayState.h"
+#include "..\..\MatrixRainCore\SpscQueue.h"
+
+
+
+
+namespace MatrixRainTests
+{
+    static std::unique_ptr<Overlay> CreateOverlay()
+    {
+        auto overlay = std::make_unique<Overlay> (
+            OverlayTimingConfig {.revealDuration = 2.5f, .dismissDuration = 1.0f, .cycleInterval = 0.25f, .flashDuration = 1.0f, .holdDuration = 5.4f},
+            OverlayLayoutConfig {.marginCols = 2, .gapChars = 6});
+
+        overlay->Initialize ({{L"Space", L"Pause / Resume"}, {L"?", L"Help reference"}, {L"Esc", L"Exit"}});
+
+        return overlay;
+    }
+
+
+
+
+    static int64_t NowNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+
+
+
+    static double Percentile (std::vector<double> samples, double fraction)
+    {
+        std::sort (samples.begin(), samples.end());
+
+        return samples[static_cast<size_t> (fraction * static_cast<double> (samples.size() - 1))];
+    }
+
+
+
+
+    TEST_CLASS (OverlayCommandQueueTests)
+    {
+        public:
+            TEST_METHOD (SpscQueue_PreservesOrderAndRejectsWhenFull)
+            {
+                SpscQueue<int, 4> queue;
+                int               value = 0;
+
+                // Several laps so the free-running indices wrap the ring
+                for (int lap = 0; lap < 3; lap++)
+                {
+                    for (int i = 0; i < 4; i++)
+                    {
+                        Assert::IsTrue (queue.TryPush (lap * 10 + i));
+                    }
+
+                    Assert::IsFalse (queue.TryPush (99));
+
+                    for (int i = 0; i < 4; i++)
+                    {
+                        Assert::IsTrue   (queue.TryPop (value));
+                        Assert::AreEqual (lap * 10 + i, value);
+                    }
+
+                    Assert::IsFalse (queue.TryPop (value));
+                    Assert::IsTrue  (queue.IsEmpty());
+                }
+            }
+
+
+
+
+            TEST_METHOD (SpscQueue_Stress_DeliversEveryValueInOrder)
+            {
+                constexpr uint32_t      kCount     = 1000000;
+                SpscQueue<uint32_t, 64> queue;
+                std::atomic<uint32_t>   outOfOrder { 0 };
+                std::atomic<uint32_t>   received   { 0 };
+
+                std::thread consumer ([&] ()
+                {
+                    uint32_t expected = 0;
+                    uint32_t value    = 0;
+
+                    while (expected < kCount)
+                    {
+                        if (!queue.TryPop (value))
+                        {
+                            std::this_thread::yield();
+                            continue;
+                        }
+
+                        outOfOrder += value == expected ? 0 : 1;
+                        expected++;
+                    }
+
+                    received = expected;
+                });
+
+                for (uint32_t i = 0; i < kCount; i++)
+                {
+                    while (!queue.TryPush (i))
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+
+                consumer.join();
+
+                Assert::AreEqual (kCount, received.load());
+                Assert::AreEqual (0u,     outOfOrder.load());
+            }
+
+
+
+
+            TEST_METHOD (OverlayState_CommandsTakeEffectOnlyWhenApplied)
+            {
+                OverlayState overlays;
+
+                overlays.hotkeyOverlay = CreateOverlay();
+
+                // Posting from the UI thread leaves the overlay untouched
+                Assert::IsTrue  (overlays.Post ({ .type = OverlayCommandType::Toggle, .target = OverlayTarget::Hotkey }));
+                Assert::IsFalse (overlays.hotkeyOverlay->IsActive());
+
+                Assert::AreEqual (size_t (1), overlays.ApplyPendingCommands());
+                Assert::IsTrue (overlays.hotkeyOverlay->GetPhase() == OverlayPhase::Revealing);
+
+                // Toggle while revealing dismisses; a second Dismiss is a no-op
+                overlays.Post ({ .type = OverlayCommandType::Toggle,  .target = OverlayTarget::Hotkey });
+                overlays.Post ({ .type = OverlayCommandType::Dismiss, .target = OverlayTarget::Hotkey });
+
+                Assert::AreEqual (size_t (2), overlays.ApplyPendingCommands());
+                Assert::IsTrue (overlays.hotkeyOverlay->GetPhase() == OverlayPhase::Dissolving);
+
+                // Toggle while dissolving shows again; Hide drops it with no fade
+                overlays.Post ({ .type = OverlayCommandType::Toggle, .target = OverlayTarget::Hotkey });
+                overlays.ApplyPendingCommands();
+                Assert::IsTrue (overlays.hotkeyOverlay->GetPhase() == OverlayPhase::Revealing);
+
+                overlays.Post ({ .type = OverlayCommandType::Hide, .target = OverlayTarget::Hotkey });
+                overlays.ApplyPendingCommands();
+                Assert::IsTrue (overlays.hotkeyOverlay->GetPhase() == OverlayPhase::Hidden);
+            }
+
+
+
+
+            TEST_METHOD (OverlayState_IgnoresCommandsForAbsentOverlays)
+            {
+                OverlayState overlays;
+
+                // Screensaver mode: no overlays exist, but the UI thread may
+                // still post (e.g. Alt+Enter hides both unconditionally)
+                overlays.Post ({ .type = OverlayCommandType::Hide,        .target = OverlayTarget::Help });
+                overlays.Post ({ .type = OverlayCommandType::Show,        .target = OverlayTarget::Usage });
+                overlays.Post ({ .type = OverlayCommandType::SetDpiScale, .target = OverlayTarget::Hotkey, .dpiScale = 2.0f });
+
+                Assert::AreEqual (size_t (3), overlays.ApplyPendingCommands());
+                Assert::IsTrue   (overlays.commands.IsEmpty());
+            }
+
+
+
+
+            TEST_METHOD (Benchmark_KeypressToOverlayStateLatencyUnderLoad)
+            {
+                // A render-thread stand-in spends 8 ms per frame on simulation
+                // and draw calls while a UI-thread stand-in toggles the hotkey
+                // overlay at irregular intervals.  Measured per keypress:
+                //   blocked  — time the UI thread spends issuing the command
+                //   latency  — keypress until the overlay's phase has changed
+                // The previous design held OverlayState's mutex across
+                // Update and Render, so a keypress landing mid-frame blocked
+                // the UI thread for the rest of that frame.
+                constexpr int                       kPresses   = 150;
+                constexpr std::chrono::microseconds kFrameWork { 8000 };
+
+                struct Samples
+                {
+                    std::vector<double> blockedUs;
+                    std::vector<double> latencyUs;
+                    int                 phaseChanges = 0;
+                };
+
+                auto spinFor = [] (std::chrono::microseconds duration)
+                {
+                    auto stop = std::chrono::steady_clock::now() + duration;
+
+                    while (std::chrono::steady_clock::now() < stop)
+                    {
+                    }
+                };
+
+                auto run = [&] (bool useQueue) -> Samples
+                {
+                    OverlayState          overlays;
+                    std::mutex            overlayMutex;
+                    std::atomic<bool>     done       { false };
+                    std::atomic<int>      applied    { 0 };
+                    std::atomic<int64_t>  appliedAt  { 0 };
+                    std::atomic<int>      phaseAfter { 0 };
+                    OverlayPhase          last       = OverlayPhase::Hidden;
+                    Samples               samples;
+                    std::mt19937          rng        (7);
+
+                    overlays.hotkeyOverlay = CreateOverlay();
+
+                    std::thread renderThread ([&] ()
+                    {
+                        while (!done.load (std::memory_order_acquire))
+                        {
+                            std::unique_lock<std::mutex> lock;
+
+                            if (useQueue)
+                            {
+                                size_t count = overlays.ApplyPendingCommands();
+
+                                if (count > 0)
+                                {
+                                    appliedAt .store     (NowNs(), std::memory_order_relaxed);
+                                    phaseAfter.store     (static_cast<int> (overlays.hotkeyOverlay->GetPhase()), std::memory_order_relaxed);
+                                    applied   .fetch_add (static_cast<int> (count), std::memory_order_release);
+                                }
+                            }
+                            else
+                            {
+                                lock = std::unique_lock<std::mutex> (overlayMutex);
+                            }
+
+                            overlays.hotkeyOverlay->Update (0.008f, 0.0f, 1.0f, 0.0f);
+                            spinFor (kFrameWork);
+                        }
+                    });
+
+                    for (int press = 0; press < kPresses; press++)
+                    {
+                        std::this_thread::sleep_for (std::chrono::microseconds (2000 + rng() % 9000));
+
+                        int64_t pressedAt = NowNs();
+
+                        if (useQueue)
+                        {
+                            overlays.Post ({ .type = OverlayCommandType::Toggle, .target = OverlayTarget::Hotkey });
+                            samples.blockedUs.push_back (static_cast<double> (NowNs() - pressedAt) / 1000.0);
+
+                            while (applied.load (std::memory_order_acquire) <= press)
+                            {
+                                std::this_thread::yield();
+                            }
+
+                            OverlayPhase phase = static_cast<OverlayPhase> (phaseAfter.load (std::memory_order_relaxed));
+
+                            samples.latencyUs.push_back (static_cast<double> (appliedAt.load (std::memory_order_relaxed) - pressedAt) / 1000.0);
+                            samples.phaseChanges += phase != last ? 1 : 0;
+                            last                  = phase;
+                        }
+                        else
+                        {
+                            std::lock_guard<std::mutex> lock (overlayMutex);
+                            OverlayPhase                before = overlays.hotkeyOverlay->GetPhase();
+
+                            overlays.Apply ({ .type = OverlayCommandType::Toggle, .target = OverlayTarget::Hotkey });
+
+                            int64_t changedAt = NowNs();
+
+                            samples.blockedUs.push_back (static_cast<double> (changedAt - pressedAt) / 1000.0);
+                            samples.latencyUs.push_back (static_cast<double> (changedAt - pressedAt) / 1000.0);
+                            samples.phaseChanges += overlays.hotkeyOverlay->GetPhase() != before ? 1 : 0;
+                        }
+                    }
+
+                    done.store (true, std::memory_order_release);
+                    renderThread.join();
+
+                    return samples;
+                };
+
+                Samples queued = run (true);
+                Samples locked = run (false);
+
+                Logger::WriteMessage (std::format ("{} keypresses, 8 ms frames, {} hardware threads\n", kPresses, std::thread::hardware_concurrency()).c_str());
+                Logger::WriteMessage (std::format ("  command queue: UI blocked p50 {:.1f} us, max {:.1f} us; keypress-to-state p50 {:.0f} us, p99 {:.0f} us\n",
+                                                   Percentile (queued.blockedUs, 0.5), Percentile (queued.blockedUs, 1.0),
+                                                   Percentile (queued.latencyUs, 0.5), Percentile (queued.latencyUs, 0.99)).c_str());
+                Logger::WriteMessage (std::format ("  overlay mutex: UI blocked p50 {:.1f} us, max {:.1f} us; keypress-to-state p50 {:.0f} us, p99 {:.0f} us\n",
+                                                   Percentile (locked.blockedUs, 0.5), Percentile (locked.blockedUs, 1.0),
+                                                   Percentile (locked.latencyUs, 0.5), Percentile (locked.latencyUs, 0.99)).c_str());
+
+                // Every keypress changed the overlay, and the UI thread no
+                // longer waits on the render thread's frame
+                Assert::AreEqual (kPresses, queued.phaseChanges);
+                Assert::AreEqual (kPresses, locked.phaseChanges);
+                Assert::IsTrue   (Percentile (queued.blockedUs, 0.5) < Percentile (locked.blockedUs, 0.5));
+            }
+    };
+}
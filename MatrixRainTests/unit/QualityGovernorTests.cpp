@@ -0,0 +1,312 @@
+#include "Pch_MatrixRainTests.h"
+
+#include "..\..\MatrixRainCore\QualityGovernor.h"
+
+
+
+
+namespace MatrixRainTests
+{
+    // Synthetic per-frame cost: a fixed base, rain that scales with
+    // density, and a bloom chain whose cost scales with passes x taps and
+    // with the bloom buffer's area.  At load 1.0 the High preset at 50%
+    // density costs 16.75 ms; load scales everything, like a slower GPU.
+    static int64_t SyntheticCostUs (const QualityLevel & level, double load)
+    {
+        const AdvancedGraphicsValues & graphics = level.graphics;
+        double                         divisor  = static_cast<double> (graphics.m_bloomResolutionDivisor);
+        double                         taps     = graphics.m_bloomAlgorithm == BloomAlgorithm::Gaussian ? static_cast<double> (graphics.m_blurTaps) : 4.0;
+        double                         bloom    = 0.0;
+
+
+
+        if (level.glowEnabled)
+        {
+            bloom = (1000.0 + graphics.m_blurPasses * taps * 250.0) * 4.0 / (divisor * divisor);
+        }
+
+        return static_cast<int64_t> (load * (2000.0 + level.densityPercent * 80.0 + bloom));
+    }
+
+
+
+
+    static QualityLevel HighPresetLevel()
+    {
+        return QualityLevel { .graphics = LookupPresetValues (QualityPreset::High), .densityPercent = 50 };
+    }
+
+
+
+
+    // Feeds `frames` frames of the synthetic cost (with +-3% noise) at the
+    // governor's current level; returns how many cost more than `target`
+    static int RunFrames (QualityGovernor & governor, int frames, double load, std::mt19937 & rng)
+    {
+        std::uniform_real_distribution<double> noise (0.97, 1.03);
+        int                                    over = 0;
+
+
+
+        for (int frame = 0; frame < frames; frame++)
+        {
+            int64_t cost = static_cast<int64_t> (static_cast<double> (SyntheticCostUs (governor.GetLevel(), load)) * noise (rng));
+
+            over += cost > governor.GetConfig().targetFrameUs ? 1 : 0;
+            governor.RecordFrame (cost);
+        }
+
+        return over;
+    }
+
+
+
+
+    TEST_CLASS (QualityGovernorTests)
+    {
+        public:
+            TEST_METHOD (Disabled_NeverLeavesTheCeiling)
+            {
+                QualityGovernor governor;
+                std::mt19937    rng (1);
+
+                governor.Configure (HighPresetLevel(), 0);
+                RunFrames (governor, 2000, 3.0, rng);
+
+                Assert::IsTrue   (governor.GetLevel() == HighPresetLevel());
+                Assert::AreEqual (size_t (0), governor.GetDecisions().size());
+            }
+
+
+
+
+            TEST_METHOD (Downshift_WalksTheLadderInOrder_DensityLast)
+            {
+                // Even the floor misses the target, so the governor walks
+                // every notch: passes, taps, bloom divisor, then density
+                QualityGovernor           governor;
+                std::vector<std::wstring> logged;
+                std::mt19937              rng (2);
+
+                governor.SetDecisionSink ([&] (const QualityDecision & decision) { logged.push_back (FormatQualityDecision (decision)); });
+                governor.Configure       (HighPresetLevel(), 10000);
+                RunFrames                (governor, 2000, 3.0, rng);
+
+                const std::vector<std::pair<QualityKnob, int>> expected
+                {
+                    { QualityKnob::BlurPasses,      2 },
+                    { QualityKnob::BlurPasses,      1 },
+                    { QualityKnob::BlurTaps,        9 },
+                    { QualityKnob::BlurTaps,        5 },
+                    { QualityKnob::BloomResolution, 4 },
+                    { QualityKnob::BloomResolution, 8 },
+                    { QualityKnob::Density,         40 },
+                    { QualityKnob::Density,         30 },
+                    { QualityKnob::Density,         20 },
+                };
+
+                const std::deque<QualityDecision> & decisions = governor.GetDecisions();
+
+                Assert::AreEqual (expected.size(), decisions.size());
+                Assert::AreEqual (expected.size(), logged.size());
+
+                for (size_t i = 0; i < expected.size(); i++)
+                {
+                    const QualityDecision & decision = decisions[i];
+                    const QualityLevel    & after    = decision.after;
+                    int                     value    = 0;
+
+                    switch (decision.knob)
+                    {
+                        case QualityKnob::BlurPasses:      value = after.graphics.m_blurPasses;                                break;
+                        case QualityKnob::BlurTaps:        value = static_cast<int> (after.graphics.m_blurTaps);               break;
+                        case QualityKnob::BloomResolution: value = static_cast<int> (after.graphics.m_bloomResolutionDivisor); break;
+                        case QualityKnob::Density:         value = after.densityPercent;                                      break;
+                    }
+
+                    Assert::IsTrue   (decision.downshift);
+                    Assert::IsTrue   (decision.knob == expected[i].first);
+                    Assert::AreEqual (expected[i].second, value);
+                    Assert::IsTrue   (decision.p95Us > decision.targetUs);
+                }
+
+                Assert::IsTrue (logged[0].find (L"lowered blur passes 3 -> 2") != std::wstring::npos);
+                Logger::WriteMessage (logged[0].c_str());
+                Logger::WriteMessage (logged.back().c_str());
+            }
+
+
+
+
+            TEST_METHOD (Downshift_SkipsKnobsThatCostNothing)
+            {
+                QualityGovernor governor;
+                QualityLevel    glowOff = HighPresetLevel();
+                QualityLevel    dual    = HighPresetLevel();
+                std::mt19937    rng (3);
+
+                // Glow off: no bloom knob saves anything, so density goes first
+                glowOff.glowEnabled = false;
+
+                governor.Configure (glowOff, 3000);
+                RunFrames (governor, 500, 1.0, rng);
+
+                Assert::IsFalse (governor.GetDecisions().empty());
+
+                for (const QualityDecision & decision : governor.GetDecisions())
+                {
+                    Assert::IsTrue (decision.knob == QualityKnob::Density);
+                }
+
+                // Dual filter ignores taps, so they are never touched
+                dual.graphics.m_bloomAlgorithm = BloomAlgorithm::DualFilter;
+
+                QualityGovernor dualGovernor;
+
+                dualGovernor.Configure (dual, 3000);
+                RunFrames (dualGovernor, 2000, 1.0, rng);
+
+                Assert::IsFalse (dualGovernor.GetDecisions().empty());
+
+                for (const QualityDecision & decision : dualGovernor.GetDecisions())
+                {
+                    Assert::IsTrue (decision.knob != QualityKnob::BlurTaps);
+                }
+
+                Assert::IsTrue (dualGovernor.GetLevel().graphics.m_blurTaps == BlurTaps::High);
+            }
+
+
+
+
+            TEST_METHOD (Converges_ThenHoldsInsideTheHysteresisBand)
+            {
+                // At 1.5x load the ceiling costs ~25 ms against a 16.7 ms
+                // target.  Two notches down it costs ~15.4 ms: under the
+                // target but above the raise threshold, so it must settle
+                // there and stay put for the rest of the run.
+                QualityGovernor governor;
+                std::mt19937    rng (4);
+
+                governor.Configure (HighPresetLevel(), 16667);
+
+                RunFrames (governor, 1000, 1.5, rng);
+
+                size_t settledDecisions = governor.GetDecisions().size();
+                int    over             = RunFrames (governor, 10000, 1.5, rng);
+
+                Logger::WriteMessage (std::format ("{} decisions to converge; {} of 10000 later frames over target\n", settledDecisions, over).c_str());
+
+                Assert::AreEqual (size_t (2),  settledDecisions);
+                Assert::AreEqual (settledDecisions, governor.GetDecisions().size());
+                Assert::AreEqual (1,           governor.GetLevel().graphics.m_blurPasses);
+                Assert::AreEqual (50,          governor.GetLevel().densityPercent);
+                Assert::AreEqual (0,           over);
+            }
+
+
+
+
+            TEST_METHOD (Upshift_RestoresTheCeilingInReverseOrderWhenLoadDrops)
+            {
+                QualityGovernor governor;
+                std::mt19937    rng (5);
+
+                governor.Configure (HighPresetLevel(), 10000);
+                RunFrames (governor, 2000, 3.0, rng);
+
+                size_t down = governor.GetDecisions().size();
+
+                Assert::AreEqual (20, governor.GetLevel().densityPercent);
+
+                // Load drops tenfold: everything comes back, most recent
+                // first, and nothing goes past the user's ceiling
+                RunFrames (governor, 20000, 0.3, rng);
+
+                const std::deque<QualityDecision> & decisions = governor.GetDecisions();
+                const std::vector<QualityKnob>      expected
+                {
+                    QualityKnob::Density,         QualityKnob::Density,  QualityKnob::Density,
+                    QualityKnob::BloomResolution, QualityKnob::BloomResolution,
+                    QualityKnob::BlurTaps,        QualityKnob::BlurTaps,
+                    QualityKnob::BlurPasses,      QualityKnob::BlurPasses,
+                };
+
+                Assert::AreEqual (down + expected.size(), decisions.size());
+
+                for (size_t i = 0; i < expected.size(); i++)
+                {
+                    Assert::IsFalse (decisions[down + i].downshift);
+                    Assert::IsTrue  (decisions[down + i].knob == expected[i]);
+                }
+
+                Assert::IsTrue (governor.GetLevel() == HighPresetLevel());
+            }
+
+
+
+
+            TEST_METHOD (FailedUpshifts_BackOffExponentially)
+            {
+                // Full-resolution bloom costs 15 ms against a 12.5 ms
+                // target; half resolution costs 8.25 ms, under the raise
+                // threshold.  The governor keeps probing Full, but each
+                // failed probe doubles the wait before the next.
+                QualityGovernor       governor;
+                QualityLevel          ceiling = HighPresetLevel();
+                std::mt19937          rng (6);
+                std::vector<uint64_t> raisedAt;
+
+                ceiling.graphics.m_blurPasses             = 1;
+                ceiling.graphics.m_blurTaps               = BlurTaps::Low;
+                ceiling.graphics.m_bloomResolutionDivisor = ResolutionDivisor::Full;
+
+                governor.Configure (ceiling, 12500);
+
+                int over = RunFrames (governor, 20000, 1.0, rng);
+
+                for (const QualityDecision & decision : governor.GetDecisions())
+                {
+                    Assert::IsTrue (decision.knob == QualityKnob::BloomResolution);
+
+                    if (!decision.downshift)
+                    {
+                        raisedAt.push_back (decision.frame);
+                    }
+                }
+
+                Logger::WriteMessage (std::format ("{} probes; {} of 20000 frames over target; backoff now {} windows\n",
+                                                   raisedAt.size(), over, governor.GetUpshiftWindowsRequired()).c_str());
+
+                Assert::IsTrue (raisedAt.size() >= 4);
+
+                for (size_t i = 2; i < raisedAt.size(); i++)
+                {
+                    Assert::IsTrue (raisedAt[i] - raisedAt[i - 1] >= raisedAt[i - 1] - raisedAt[i - 2]);
+                }
+
+                Assert::AreEqual (governor.GetConfig().maxUpshiftWindows, governor.GetUpshiftWindowsRequired());
+                Assert::IsTrue   (over < 20000 / 20);
+            }
+
+
+
+
+            TEST_METHOD (Configure_NewCeilingStartsOver)
+            {
+                QualityGovernor governor;
+                QualityLevel    medium = { .graphics = LookupPresetValues (QualityPreset::Medium), .densityPercent = 70 };
+                std::mt19937    rng (7);
+
+                governor.Configure (HighPresetLevel(), 16667);
+                RunFrames (governor, 1000, 3.0, rng);
+
+                Assert::IsFalse (governor.GetLevel() == HighPresetLevel());
+
+                governor.Configure (medium, 16667);
+
+                Assert::IsTrue (governor.GetLevel()   == medium);
+                Assert::IsTrue (governor.GetCeiling() == medium);
+            }
+    };
+}
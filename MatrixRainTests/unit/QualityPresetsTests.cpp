@@ -102,6 +102,37 @@ namespace MatrixRainTests
 
 
 
+            TEST_METHOD (DetectActivePreset_PresetRowWithDualFilter_ReturnsCustom)
+            {
+                // Every named preset keeps the Gaussian blur, so switching a
+                // preset row to the dual filter makes it a Custom row.
+                for (QualityPreset preset : { QualityPreset::Low, QualityPreset::Medium, QualityPreset::High })
+                {
+                    AdvancedGraphicsValues v = LookupPresetValues (preset);
+
+                    Assert::IsTrue (v.m_bloomAlgorithm == BloomAlgorithm::Gaussian);
+
+                    v.m_bloomAlgorithm = BloomAlgorithm::DualFilter;
+
+                    Assert::IsTrue (DetectActivePreset (v) == QualityPreset::Custom);
+                }
+            }
+
+
+
+
+            TEST_METHOD (DualFilterLevelCount_OneMoreThanClampedPasses)
+            {
+                Assert::AreEqual (2, DualFilterLevelCount (0));
+                Assert::AreEqual (2, DualFilterLevelCount (1));
+                Assert::AreEqual (4, DualFilterLevelCount (3));
+                Assert::AreEqual (5, DualFilterLevelCount (4));
+                Assert::AreEqual (5, DualFilterLevelCount (9));
+            }
+
+
+
+
             //
             //  ApplyPresetSnap
             //
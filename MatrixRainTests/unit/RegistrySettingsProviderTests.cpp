@@ -331,6 +331,67 @@ namespace MatrixRainTests
 
 
 
+        TEST_METHOD (TestSaveLoadRoundTrip_LastCustom_PreservesDualFilter)
+        {
+            DeleteTestRegistryKey();
+
+            ScreenSaverSettings saveSettings;
+            saveSettings.m_qualityPreset  = QualityPreset::Custom;
+            saveSettings.m_lastCustom     = AdvancedGraphicsValues { 100, 2, ResolutionDivisor::Half, BlurTaps::Medium, BloomAlgorithm::DualFilter };
+            saveSettings.m_advancedValues = *saveSettings.m_lastCustom;
+
+
+            HRESULT hr = m_provider.Save (saveSettings);
+            Assert::AreEqual (S_OK, hr);
+
+
+            ScreenSaverSettings loadSettings;
+            hr = m_provider.Load (loadSettings);
+
+
+            Assert::AreEqual (S_OK, hr);
+            Assert::IsTrue   (loadSettings.m_lastCustom.has_value());
+            Assert::IsTrue   (loadSettings.m_lastCustom->m_bloomAlgorithm == BloomAlgorithm::DualFilter);
+            Assert::IsTrue   (loadSettings.m_advancedValues.m_bloomAlgorithm == BloomAlgorithm::DualFilter);
+        }
+
+
+
+
+        TEST_METHOD (TestLoadSettings_LastCustom_MissingBloomAlgorithm_DefaultsToGaussian)
+        {
+            DeleteTestRegistryKey();
+
+            // The four values written before the bloom algorithm existed.
+            HKEY    hKey   = nullptr;
+            LSTATUS status = RegCreateKeyExW (HKEY_CURRENT_USER, TEST_REGISTRY_KEY_PATH, 0, nullptr,
+                                              REG_OPTION_NON_VOLATILE, KEY_WRITE, nullptr, &hKey, nullptr);
+            Assert::AreEqual ((LONG)ERROR_SUCCESS, (LONG)status);
+
+            DWORD intensity  = 137;
+            DWORD passes     = 4;
+            DWORD resolution = 8;
+            DWORD smoothness = 5;
+
+            RegSetValueExW (hKey, L"LastCustom_GlowIntensity", 0, REG_DWORD, (const BYTE *)&intensity,  sizeof (DWORD));
+            RegSetValueExW (hKey, L"LastCustom_Passes",        0, REG_DWORD, (const BYTE *)&passes,     sizeof (DWORD));
+            RegSetValueExW (hKey, L"LastCustom_Resolution",    0, REG_DWORD, (const BYTE *)&resolution, sizeof (DWORD));
+            RegSetValueExW (hKey, L"LastCustom_Smoothness",    0, REG_DWORD, (const BYTE *)&smoothness, sizeof (DWORD));
+            RegCloseKey (hKey);
+
+
+            ScreenSaverSettings settings;
+            HRESULT             hr = m_provider.Load (settings);
+
+
+            Assert::AreEqual (S_OK, hr);
+            Assert::IsTrue   (settings.m_lastCustom.has_value());
+            Assert::IsTrue   (settings.m_lastCustom->m_bloomAlgorithm == BloomAlgorithm::Gaussian);
+        }
+
+
+
+
         TEST_METHOD (TestLoadSettings_LastCustom_MissingOneValue_IgnoresAll)
         {
             DeleteTestRegistryKey();
@@ -612,6 +673,106 @@ namespace MatrixRainTests
         }
 
 
+        TEST_METHOD (AdaptiveQualityTargetRoundTripsAndClamps)
+        {
+            DeleteTestRegistryKey();
+
+            ScreenSaverSettings save;
+            ScreenSaverSettings loaded;
+
+            m_provider.Load (loaded);
+            Assert::AreEqual (0, loaded.m_adaptiveQualityTargetUs, L"Absent AdaptiveQualityTargetUs means off");
+
+            save.m_adaptiveQualityTargetUs = 16667;
+            m_provider.Save (save);
+            m_provider.Load (loaded);
+            Assert::AreEqual (16667, loaded.m_adaptiveQualityTargetUs, L"AdaptiveQualityTargetUs round-trips");
+
+            save.m_adaptiveQualityTargetUs = 50;
+            m_provider.Save (save);
+            m_provider.Load (loaded);
+            Assert::AreEqual (ScreenSaverSettings::MIN_ADAPTIVE_QUALITY_TARGET_US, loaded.m_adaptiveQualityTargetUs, L"Non-zero targets clamp to the minimum");
+
+            save.m_adaptiveQualityTargetUs = 0;
+            m_provider.Save (save);
+            m_provider.Load (loaded);
+            Assert::AreEqual (0, loaded.m_adaptiveQualityTargetUs, L"Zero stays off");
+        }
+
+
+        TEST_METHOD (RenderWorkersRoundTripsAndClamps)
+        {
+            DeleteTestRegistryKey();
+
+            ScreenSaverSettings save;
+            ScreenSaverSettings loaded;
+
+            m_provider.Load (loaded);
+            Assert::AreEqual (0, loaded.m_renderWorkers, L"Absent RenderWorkers means one thread per monitor");
+
+            save.m_renderWorkers = 2;
+            m_provider.Save (save);
+            m_provider.Load (loaded);
+            Assert::AreEqual (2, loaded.m_renderWorkers, L"RenderWorkers round-trips");
+
+            save.m_renderWorkers = 100;
+            m_provider.Save (save);
+            m_provider.Load (loaded);
+            Assert::AreEqual (ScreenSaverSettings::MAX_RENDER_WORKERS, loaded.m_renderWorkers, L"RenderWorkers clamps to the maximum");
+        }
+
+
+        TEST_METHOD (SharedSimulationRoundTrips)
+        {
+            DeleteTestRegistryKey();
+
+            ScreenSaverSettings save;
+            ScreenSaverSettings loaded;
+
+            m_provider.Load (loaded);
+            Assert::IsFalse (loaded.m_sharedSimulation, L"Absent SharedSimulation means one simulation per monitor");
+
+            save.m_sharedSimulation = true;
+            m_provider.Save (save);
+            m_provider.Load (loaded);
+            Assert::IsTrue (loaded.m_sharedSimulation, L"SharedSimulation round-trips");
+        }
+
+
+        TEST_METHOD (SimulationThreadRoundTrips)
+        {
+            DeleteTestRegistryKey();
+
+            ScreenSaverSettings save;
+            ScreenSaverSettings loaded;
+
+            m_provider.Load (loaded);
+            Assert::IsFalse (loaded.m_simulationThread, L"Absent SimulationThread means simulating on the render thread");
+
+            save.m_simulationThread = true;
+            m_provider.Save (save);
+            m_provider.Load (loaded);
+            Assert::IsTrue (loaded.m_simulationThread, L"SimulationThread round-trips");
+        }
+
+
+        TEST_METHOD (TraceFileRoundTrips)
+        {
+            DeleteTestRegistryKey();
+
+            ScreenSaverSettings save;
+            ScreenSaverSettings loaded;
+
+            m_provider.Load (loaded);
+            Assert::IsTrue (loaded.m_traceFile.empty(), L"Absent TraceFile means tracing off");
+
+            save.m_traceFile = L"C:\\Temp\\MatrixRain.trace.json";
+            m_provider.Save (save);
+            m_provider.Load (loaded);
+            Assert::AreEqual (save.m_traceFile, loaded.m_traceFile, L"TraceFile round-trips");
+        }
+
+
         TEST_METHOD (ScanlinesIntensityClampedOnRead)
         {
             DeleteTestRegistryKey();
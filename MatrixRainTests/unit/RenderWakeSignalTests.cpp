@@ -0,0 +1,420 @@
+#include "Pch_MatrixRainTests.h"
+
+#include "..\..\MatrixRainCore\PausedRedraw.h"
+#include "..\..\MatrixRainCore\RenderWakeSignal.h"
+
+
+
+
+namespace MatrixRainTests
+{
+    using namespace std::chrono;
+
+
+
+
+    // The idle skeleton of MonitorRenderContext::RenderThreadProc: blocks on
+    // the wake signal during a transition and, while paused, until the next
+    // low-power redraw.  Each pass that gets past the waits is a "frame".
+    struct IdleLoop
+    {
+        RenderWakeSignal         wake;
+        std::atomic<bool>        stop         { false };
+        std::atomic<bool>        inTransition { false };
+        std::atomic<bool>        paused       { false };
+        std::atomic<ColorScheme> scheme       { ColorScheme::Green };
+        std::atomic<int>         frames       { 0 };
+        std::atomic<int>         idlePasses   { 0 };    // wakeups that found nothing to draw
+
+        void Run()
+        {
+            std::optional<steady_clock::time_point> idleUntil;
+            uint64_t                                generation = 0;
+
+
+            while (!stop)
+            {
+                if (idleUntil)
+                {
+                    wake.WaitUntil (generation, *idleUntil);
+                    idleUntil.reset();
+                    continue;
+                }
+
+                generation = wake.GetGeneration();
+
+                if (inTransition)
+                {
+                    idlePasses++;
+                    wake.Wait (generation);
+                    continue;
+                }
+
+                frames++;
+
+                std::optional<microseconds> interval = PausedRedrawInterval (paused, false, scheme);
+
+                if (interval)
+                {
+                    idleUntil = steady_clock::now() + *interval;
+                }
+                else
+                {
+                    std::this_thread::sleep_for (milliseconds (1));    // stands in for a VSync'd Present
+                }
+            }
+        }
+    };
+
+
+
+
+    // The loop this replaces: a 1 ms sleep per pass during a transition
+    static int PollThroughTransition (std::atomic<bool> & inTransition, std::atomic<bool> & stop)
+    {
+        int idlePasses = 0;
+
+
+
+        while (!stop)
+        {
+            if (inTransition)
+            {
+                idlePasses++;
+                std::this_thread::sleep_for (milliseconds (1));
+                continue;
+            }
+        }
+
+        return idlePasses;
+    }
+
+
+
+
+    static int64_t NowUs()
+    {
+        return duration_cast<microseconds> (steady_clock::now().time_since_epoch()).count();
+    }
+
+
+
+
+    static int64_t Percentile (std::vector<int64_t> samples, double percentile)
+    {
+        std::sort (samples.begin(), samples.end());
+
+        return samples[static_cast<size_t> (percentile / 100.0 * static_cast<double> (samples.size() - 1))];
+    }
+
+
+
+
+    // Largest change in any ColorCycle channel, in 8-bit levels, between
+    // samples `interval` seconds apart over one full cycle
+    static float MaxChannelChange (float interval)
+    {
+        float largest = 0.0f;
+
+
+
+        for (int sample = 0; static_cast<float> (sample) * interval < 12.0f; sample++)
+        {
+            float  elapsed = (static_cast<float> (sample) + 0.5f) * interval;
+            Color4 a       = GetColorRGB (ColorScheme::ColorCycle, elapsed);
+            Color4 b       = GetColorRGB (ColorScheme::ColorCycle, elapsed + interval);
+
+            for (float delta : { b.r - a.r, b.g - a.g, b.b - a.b })
+            {
+                largest = std::max (largest, fabsf (delta) * 255.0f);
+            }
+        }
+
+        return largest;
+    }
+
+
+
+
+    TEST_CLASS (RenderWakeSignalTests)
+    {
+        public:
+            TEST_METHOD (WaitUntil_TimesOutWithoutNotify_ReturnsAtOnceAfterOne)
+            {
+                RenderWakeSignal wake;
+                uint64_t         generation = wake.GetGeneration();
+                auto             start      = steady_clock::now();
+
+                Assert::IsFalse (wake.WaitUntil (generation, start + milliseconds (20)));
+                Assert::IsTrue  (steady_clock::now() - start >= milliseconds (20));
+
+                // A Notify between reading the generation and waiting is not lost
+                wake.Notify();
+                start = steady_clock::now();
+
+                Assert::IsTrue (wake.WaitUntil (generation, start + seconds (5)));
+                Assert::IsTrue (steady_clock::now() - start < seconds (1));
+            }
+
+
+
+
+            TEST_METHOD (WaitUntil_NotifiedFromAnotherThread_ReturnsBeforeTheDeadline)
+            {
+                RenderWakeSignal wake;
+                uint64_t         generation = wake.GetGeneration();
+                auto             start      = steady_clock::now();
+                std::thread      notifier ([&]
+                {
+                    std::this_thread::sleep_for (milliseconds (20));
+                    wake.Notify();
+                });
+
+                bool woken = wake.WaitUntil (generation, start + seconds (5));
+
+                notifier.join();
+
+                Assert::IsTrue (woken);
+                Assert::IsTrue (steady_clock::now() - start < seconds (1));
+            }
+
+
+
+
+            TEST_METHOD (WaitUntil_Deadline_WakesWithinAFractionOfATimerTick)
+            {
+                // Paused ColorCycle redraws and shared-worker vblanks are
+                // deadlines a few ms to a few tens of ms out; a wait rounded
+                // to the 15.6 ms default Windows tick would land up to a
+                // whole tick late
+                constexpr int kSamples = 60;
+
+                RenderWakeSignal     wake;
+                std::vector<int64_t> lateness;
+
+
+
+                for (int i = 0; i < kSamples; i++)
+                {
+                    auto deadline = steady_clock::now() + microseconds (2000 + 250 * (i % 20));
+
+                    Assert::IsFalse (wake.WaitUntil (wake.GetGeneration(), deadline));
+
+                    lateness.push_back (duration_cast<microseconds> (steady_clock::now() - deadline).count());
+                }
+
+                Logger::WriteMessage (std::format ("deadline wake lateness: p50 {} us, p99 {} us\n",
+                                                   Percentile (lateness, 50.0), Percentile (lateness, 99.0)).c_str());
+
+                Assert::IsTrue (Percentile (lateness, 0.0) >= 0, L"A deadline wait must not return early");
+                Assert::IsTrue (Percentile (lateness, 50.0) < 4000);
+            }
+
+
+
+
+            TEST_METHOD (Notify_WakeLatency_VersusOneMillisecondPolling)
+            {
+                // Time from the state change to the idle thread noticing it,
+                // for the wait and for the 1 ms poll it replaces
+                constexpr int kSamples = 200;
+
+                std::vector<int64_t> waitLatency;
+                std::vector<int64_t> pollLatency;
+                std::atomic<bool>    flag      { false };
+                std::atomic<int64_t> changedAt { 0 };
+                RenderWakeSignal     wake;
+
+
+
+                for (int i = 0; i < kSamples; i++)
+                {
+                    uint64_t    generation = wake.GetGeneration();
+                    std::thread waiter ([&]
+                    {
+                        wake.Wait (generation);
+                        waitLatency.push_back (NowUs() - changedAt);
+                    });
+
+                    std::this_thread::sleep_for (microseconds (500));
+                    changedAt = NowUs();
+                    wake.Notify();
+                    waiter.join();
+
+                    std::thread poller ([&]
+                    {
+                        while (!flag)
+                        {
+                            std::this_thread::sleep_for (milliseconds (1));
+                        }
+
+                        pollLatency.push_back (NowUs() - changedAt);
+                    });
+
+                    std::this_thread::sleep_for (microseconds (500));
+                    changedAt = NowUs();
+                    flag      = true;
+                    poller.join();
+                    flag      = false;
+                }
+
+                Logger::WriteMessage (std::format ("wake latency: wait p50 {} us, p99 {} us; 1 ms poll p50 {} us, p99 {} us\n",
+                                                   Percentile (waitLatency, 50.0), Percentile (waitLatency, 99.0),
+                                                   Percentile (pollLatency, 50.0), Percentile (pollLatency, 99.0)).c_str());
+
+                Assert::IsTrue (Percentile (waitLatency, 50.0) <= Percentile (pollLatency, 50.0));
+            }
+
+
+
+
+            TEST_METHOD (Transition_IdlesWithoutIterating)
+            {
+                IdleLoop loop;
+
+                loop.inTransition = true;
+
+                std::thread thread ([&] { loop.Run(); });
+
+                std::this_thread::sleep_for (milliseconds (200));
+                loop.inTransition = false;
+                loop.wake.Notify();
+                std::this_thread::sleep_for (milliseconds (20));
+                loop.stop = true;
+                loop.wake.Notify();
+                thread.join();
+
+                // The same 200 ms with the old 1 ms poll
+                std::atomic<bool> inTransition { true };
+                std::atomic<bool> stop         { false };
+                int               polled       = 0;
+                std::thread       poller ([&] { polled = PollThroughTransition (inTransition, stop); });
+
+                std::this_thread::sleep_for (milliseconds (200));
+                stop         = true;
+                inTransition = false;
+                poller.join();
+
+                Logger::WriteMessage (std::format ("200 ms transition: {} idle passes waiting, {} polling\n", loop.idlePasses.load(), polled).c_str());
+
+                Assert::IsTrue (loop.idlePasses <= 2);
+                Assert::IsTrue (loop.frames     >  0);
+                Assert::IsTrue (polled          >  50);
+            }
+
+
+
+
+            TEST_METHOD (Paused_StaticSchemeDrawsAtKeepAlive_ColorCycleAtItsStepRate)
+            {
+                IdleLoop loop;
+
+                loop.paused = true;
+
+                std::thread thread ([&] { loop.Run(); });
+
+                std::this_thread::sleep_for (milliseconds (1500));
+                int staticFrames = loop.frames;
+
+                // Switching to ColorCycle is a published change: it wakes
+                // the loop at once and the redraw rate rises to match
+                loop.scheme = ColorScheme::ColorCycle;
+                loop.wake.Notify();
+                loop.frames = 0;
+
+                std::this_thread::sleep_for (milliseconds (1000));
+                int cycleFrames = loop.frames;
+
+                // Resume: back to full rate without waiting out the interval
+                loop.paused = false;
+                loop.frames = 0;
+                loop.wake.Notify();
+                std::this_thread::sleep_for (milliseconds (100));
+                int resumedFrames = loop.frames;
+
+                loop.stop = true;
+                loop.wake.Notify();
+                thread.join();
+
+                Logger::WriteMessage (std::format ("paused: {} frames in 1.5 s static, {} in 1 s ColorCycle; {} in 100 ms after resume\n",
+                                                   staticFrames, cycleFrames, resumedFrames).c_str());
+
+                Assert::IsTrue (staticFrames  >= 2 && staticFrames <= 3);
+                Assert::IsTrue (cycleFrames   >= 25 && cycleFrames <= 50);
+                Assert::IsTrue (resumedFrames >  20);
+            }
+
+
+
+
+            TEST_METHOD (PausedRedrawInterval_Policy)
+            {
+                Assert::IsFalse (PausedRedrawInterval (false, false, ColorScheme::Green).has_value());
+                Assert::IsFalse (PausedRedrawInterval (true,  true,  ColorScheme::Green).has_value());
+                Assert::IsFalse (PausedRedrawInterval (true,  true,  ColorScheme::ColorCycle).has_value());
+
+                Assert::IsTrue (PausedRedrawInterval (true, false, ColorScheme::Green)  == microseconds (kPausedKeepAliveInterval));
+                Assert::IsTrue (PausedRedrawInterval (true, false, ColorScheme::Custom) == microseconds (kPausedKeepAliveInterval));
+
+                // ColorCycle never moves more than the step between redraws,
+                // and is never redrawn faster than its lookup table changes
+                microseconds cycle = *PausedRedrawInterval (true, false, ColorScheme::ColorCycle);
+
+                Assert::IsTrue (cycle >= milliseconds (16));
+                Assert::IsTrue (cycle <= milliseconds (50));
+
+                // The cycle comes from a lookup table, so a redraw can land
+                // one table entry further along than the clock alone would
+                // put it; allow the largest single-entry change on top
+                float tableStep = 12.0f / 720.0f;
+                float step      = static_cast<float> (cycle.count()) / 1'000'000.0f;
+                float entryMax  = MaxChannelChange (tableStep);
+                float redrawMax = MaxChannelChange (step);
+
+                Logger::WriteMessage (std::format ("ColorCycle paused redraw every {} us: at most {:.2f} levels per redraw ({:.2f} per table entry)\n",
+                                                   cycle.count(), redrawMax, entryMax).c_str());
+
+                Assert::IsTrue (redrawMax <= kPausedColorStepLevels + entryMax + 0.01f);
+            }
+
+
+
+
+            TEST_METHOD (Stress_NoLostWakeups)
+            {
+                // A consumer that reads the generation, checks a counter and
+                // waits must never sleep through an increment
+                constexpr int kIncrements = 20000;
+
+                RenderWakeSignal wake;
+                std::atomic<int> produced { 0 };
+                int              seen     = 0;
+
+                std::thread consumer ([&]
+                {
+                    while (seen < kIncrements)
+                    {
+                        uint64_t generation = wake.GetGeneration();
+
+                        if (produced.load() == seen)
+                        {
+                            wake.Wait (generation);
+                            continue;
+                        }
+
+                        seen = produced.load();
+                    }
+                });
+
+                for (int i = 0; i < kIncrements; i++)
+                {
+                    produced++;
+                    wake.Notify();
+                }
+
+                consumer.join();
+
+                Assert::AreEqual (kIncrements, seen);
+            }
+    };
+}
@@ -0,0 +1,105 @@
+#include "Pch_MatrixRainTests.h"
+
+#include "..\..\MatrixRainCore\ScanlineAttenuation.h"
+#include "..\..\MatrixRainCore\ScanlineStyleMapping.h"
+
+
+
+
+
+namespace MatrixRainTests
+{
+    // Shaders/scanlines.hlsl main() for the pixel centered at row y, with
+    // ddy taken the way the hardware does: the difference across the 2x2
+    // quad the pixel belongs to.
+    static float ShaderDarken (UINT y, UINT height, float linesPerHeight, float intensity)
+    {
+        constexpr float kPi = 3.14159265f;
+
+        auto linePosAt = [&] (UINT row)
+        {
+            return (static_cast<float> (row) + 0.5f) / static_cast<float> (height) * linesPerHeight;
+        };
+
+        float linePos = linePosAt (y);
+        float ddy     = linePosAt ((y & ~1u) + 1) - linePosAt (y & ~1u);
+        float perPix  = std::max (std::abs (ddy), 1e-6f);
+        float rolloff = std::max (std::sin (kPi * perPix) / (kPi * perPix), 0.0f);
+        float bright  = 0.5f - 0.5f * std::cos (2.0f * kPi * linePos) * rolloff;
+
+
+        return (1.0f - intensity) + (1.0f - (1.0f - intensity)) * bright;
+    }
+
+
+
+
+    TEST_CLASS (ScanlineAttenuationTests)
+    {
+        public:
+            TEST_METHOD (Table_MatchesShaderFormula_AcrossStylesIntensitiesAndHeights)
+            {
+                for (UINT height : { 37u, 720u, 1080u, 1440u, 2160u })
+                {
+                    for (int style : { 1, 25, 50, 75, 100 })
+                    {
+                        for (float intensity : { 0.0f, 0.3f, 1.0f })
+                        {
+                            ScanlineAttenuationTable table;
+                            float                    lines = ScanlineLineCount (style);
+                            float                    worst = 0.0f;
+
+                            table.Update (height, lines, intensity);
+
+                            Assert::AreEqual (height, table.GetHeight());
+
+                            for (UINT y = 0; y < height; y++)
+                            {
+                                worst = std::max (worst, std::abs (table.GetRows()[y] - ShaderDarken (y, height, lines, intensity)));
+                            }
+
+                            // Well under one RGBA8 step even on a white pixel
+                            Assert::IsTrue (worst < 1e-3f, std::format (L"height {}, style {}, intensity {}: max difference {}",
+                                                                        height,
+                                                                        style,
+                                                                        intensity,
+                                                                        worst).c_str());
+                        }
+                    }
+                }
+            }
+
+
+
+
+            TEST_METHOD (Table_ZeroIntensity_IsIdentity)
+            {
+                ScanlineAttenuationTable table;
+
+                table.Update (1080, ScanlineLineCount (50), 0.0f);
+
+                for (float row : table.GetRows())
+                {
+                    Assert::AreEqual (1.0f, row);
+                }
+            }
+
+
+
+
+            TEST_METHOD (Update_RebuildsOnlyWhenAnInputChanges)
+            {
+                ScanlineAttenuationTable table;
+
+                Assert::IsTrue  (table.Update (1080, 387.0f, 0.3f));
+                Assert::IsFalse (table.Update (1080, 387.0f, 0.3f));
+
+                Assert::IsTrue  (table.Update (1080, 241.0f, 0.3f));
+                Assert::IsTrue  (table.Update (1080, 241.0f, 0.5f));
+                Assert::IsTrue  (table.Update (2160, 241.0f, 0.5f));
+                Assert::AreEqual (2160u, table.GetHeight());
+
+                Assert::IsFalse (table.Update (2160, 241.0f, 0.5f));
+            }
+    };
+}
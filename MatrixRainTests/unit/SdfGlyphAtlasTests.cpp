@@ -0,0 +1,317 @@
+#include "Pch_MatrixRainTests.h"
+
+#include "..\..\MatrixRainCore\SdfGlyphAtlas.h"
+#include "..\..\MatrixRainCore\SoftwareGlyphAtlas.h"
+
+
+
+
+namespace MatrixRainTests
+{
+    // A disk rendered with 4x4 supersampling, like a grayscale-AA glyph
+    static std::vector<uint8_t> RenderDiskCoverage (UINT size, float centerX, float centerY, float radius)
+    {
+        std::vector<uint8_t> coverage (size_t (size) * size);
+
+        for (UINT y = 0; y < size; y++)
+        {
+            for (UINT x = 0; x < size; x++)
+            {
+                int hits = 0;
+
+                for (int sy = 0; sy < 4; sy++)
+                {
+                    for (int sx = 0; sx < 4; sx++)
+                    {
+                        float px = static_cast<float> (x) + (static_cast<float> (sx) + 0.5f) / 4.0f - centerX;
+                        float py = static_cast<float> (y) + (static_cast<float> (sy) + 0.5f) / 4.0f - centerY;
+
+                        hits += (px * px + py * py <= radius * radius) ? 1 : 0;
+                    }
+                }
+
+                coverage[size_t (y) * size + x] = static_cast<uint8_t> ((hits * 255 + 8) / 16);
+            }
+        }
+
+        return coverage;
+    }
+
+
+
+
+    // Box-filtered coverage: what a conventional atlas at the SDF's
+    // resolution would hold
+    static std::vector<uint8_t> DownsampleCoverage (std::span<const uint8_t> coverage, UINT size, UINT factor)
+    {
+        UINT                 outSize = size / factor;
+        std::vector<uint8_t> out (size_t (outSize) * outSize);
+
+        for (UINT y = 0; y < outSize; y++)
+        {
+            for (UINT x = 0; x < outSize; x++)
+            {
+                UINT sum = 0;
+
+                for (UINT sy = 0; sy < factor; sy++)
+                {
+                    for (UINT sx = 0; sx < factor; sx++)
+                    {
+                        sum += coverage[size_t (y * factor + sy) * size + x * factor + sx];
+                    }
+                }
+
+                out[size_t (y) * outSize + x] = static_cast<uint8_t> ((sum + factor * factor / 2) / (factor * factor));
+            }
+        }
+
+        return out;
+    }
+
+
+
+
+    TEST_CLASS (SdfGlyphAtlasTests)
+    {
+        public:
+            // Source: 1024x1024 with a disk of radius 300 px.  Field: 8x
+            // smaller (128x128), so the disk is 37.5 texels across.
+            static constexpr UINT  s_kSourceSize = 1024;
+            static constexpr UINT  s_kDownsample = 8;
+            static constexpr float s_kCenter     = 512.0f;
+            static constexpr float s_kRadius     = 300.0f;
+            static constexpr float s_kSpread     = 4.0f;
+
+
+
+
+            static float DiskDistanceInTexels (float u, float v)
+            {
+                float dx = u * s_kSourceSize - s_kCenter;
+                float dy = v * s_kSourceSize - s_kCenter;
+
+                return (s_kRadius - sqrtf (dx * dx + dy * dy)) / static_cast<float> (s_kDownsample);
+            }
+
+
+
+
+            TEST_METHOD (EncodeDistance_RoundTripsWithinOneStep)
+            {
+                for (float d = -s_kSpread; d <= s_kSpread; d += 0.01f)
+                {
+                    float decoded = SdfGlyphAtlas::DecodeDistance (SdfGlyphAtlas::EncodeDistance (d, s_kSpread), s_kSpread);
+
+                    Assert::IsTrue (fabsf (decoded - d) <= s_kSpread / 255.0f + 1e-5f);
+                }
+
+                // Out-of-range distances clamp to the ends of the byte range
+                Assert::AreEqual (uint8_t (255), SdfGlyphAtlas::EncodeDistance ( 100.0f, s_kSpread));
+                Assert::AreEqual (uint8_t (0),   SdfGlyphAtlas::EncodeDistance (-100.0f, s_kSpread));
+            }
+
+
+
+
+            TEST_METHOD (Generate_Disk_DistanceMatchesAnalytic)
+            {
+                std::vector<uint8_t> coverage = RenderDiskCoverage (s_kSourceSize, s_kCenter, s_kCenter, s_kRadius);
+                SdfGlyphAtlas        sdf;
+                float                maxError = 0.0f;
+
+                Assert::AreEqual (S_OK, sdf.Generate (s_kSourceSize, s_kSourceSize, coverage, s_kDownsample, s_kSpread));
+                Assert::AreEqual (s_kSourceSize / s_kDownsample, sdf.GetWidth());
+
+                // Off texel centers too, so interpolation is covered
+                for (UINT y = 0; y < 4 * sdf.GetHeight(); y++)
+                {
+                    for (UINT x = 0; x < 4 * sdf.GetWidth(); x++)
+                    {
+                        float u        = (static_cast<float> (x) + 0.5f) / (4.0f * sdf.GetWidth());
+                        float v        = (static_cast<float> (y) + 0.5f) / (4.0f * sdf.GetHeight());
+                        float expected = DiskDistanceInTexels (u, v);
+
+                        if (fabsf (expected) < s_kSpread - 1.0f)
+                        {
+                            maxError = std::max (maxError, fabsf (sdf.SampleDistance (u, v) - expected));
+                        }
+                    }
+                }
+
+                Logger::WriteMessage (std::format ("Disk SDF: max distance error {:.3f} texels inside the spread band\n", maxError).c_str());
+
+                Assert::IsTrue (maxError < 0.1f);
+            }
+
+
+
+
+            TEST_METHOD (SampleCoverage_Disk_MatchesAnalyticEdgeAtAnyScale)
+            {
+                // Each scale renders the disk at screenPixelsPerTexel x the
+                // field's size; the ideal is a one-pixel linear edge at the
+                // exact radius
+                std::vector<uint8_t> coverage = RenderDiskCoverage (s_kSourceSize, s_kCenter, s_kCenter, s_kRadius);
+                SdfGlyphAtlas        sdf;
+
+                Assert::AreEqual (S_OK, sdf.Generate (s_kSourceSize, s_kSourceSize, coverage, s_kDownsample, s_kSpread));
+
+                for (float scale : { 0.5f, 1.0f, 2.0f, 4.0f, 16.0f })
+                {
+                    UINT  screenSize = static_cast<UINT> (static_cast<float> (sdf.GetWidth()) * scale);
+                    float maxError   = 0.0f;
+
+                    for (UINT y = 0; y < screenSize; y++)
+                    {
+                        for (UINT x = 0; x < screenSize; x++)
+                        {
+                            float u        = (static_cast<float> (x) + 0.5f) / static_cast<float> (screenSize);
+                            float v        = (static_cast<float> (y) + 0.5f) / static_cast<float> (screenSize);
+                            float expected = std::clamp (DiskDistanceInTexels (u, v) * scale + 0.5f, 0.0f, 1.0f);
+
+                            maxError = std::max (maxError, fabsf (sdf.SampleCoverage (u, v, scale) - expected));
+                        }
+                    }
+
+                    Logger::WriteMessage (std::format ("Scale {:.1f}: max coverage error {:.3f}\n", scale, maxError).c_str());
+
+                    // 0.1 texel of distance error is 1.6 px at 16x; still
+                    // under one gray level in eight of the edge ramp at 1x
+                    Assert::IsTrue (maxError <= std::min (1.0f, 0.1f * scale + 1.0f / 64.0f));
+                }
+            }
+
+
+
+
+            TEST_METHOD (SampleCoverage_Magnified_EdgeStaysOnePixelWide)
+            {
+                // The point of the field: at 16x a bilinear coverage atlas
+                // of the same size smears the edge over ~16 pixels, the
+                // field keeps it to one or two
+                constexpr float      kScale     = 16.0f;
+                std::vector<uint8_t> coverage   = RenderDiskCoverage (s_kSourceSize, s_kCenter, s_kCenter, s_kRadius);
+                std::vector<uint8_t> small      = DownsampleCoverage (coverage, s_kSourceSize, s_kDownsample);
+                SdfGlyphAtlas        sdf;
+                SoftwareGlyphAtlas   bilinear;
+                UINT                 screenSize = static_cast<UINT> (static_cast<float> (s_kSourceSize / s_kDownsample) * kScale);
+                int                  sdfRamp    = 0;
+                int                  bilinRamp  = 0;
+
+                Assert::AreEqual (S_OK, sdf.Generate (s_kSourceSize, s_kSourceSize, coverage, s_kDownsample, s_kSpread));
+                Assert::AreEqual (S_OK, bilinear.LoadCoverage (s_kSourceSize / s_kDownsample, s_kSourceSize / s_kDownsample, small));
+
+                // Along the horizontal diameter, across the right-hand edge
+                for (UINT x = screenSize / 2; x < screenSize; x++)
+                {
+                    float u = (static_cast<float> (x) + 0.5f) / static_cast<float> (screenSize);
+                    float c = sdf.SampleCoverage (u, 0.5f, kScale);
+                    float b = bilinear.SampleBilinear (u, 0.5f);
+
+                    sdfRamp   += (c > 0.05f && c < 0.95f) ? 1 : 0;
+                    bilinRamp += (b > 0.05f && b < 0.95f) ? 1 : 0;
+                }
+
+                Logger::WriteMessage (std::format ("Edge ramp at {}x: SDF {} px, bilinear coverage {} px\n", kScale, sdfRamp, bilinRamp).c_str());
+
+                Assert::IsTrue (sdfRamp   <= 2);
+                Assert::IsTrue (bilinRamp >= 8);
+            }
+
+
+
+
+            TEST_METHOD (Generate_ProceduralAtlas_ReconstructsGlyphShapes)
+            {
+                // The rain atlas layout at 4x reduction (512x512).  Sampled
+                // back at source resolution, the field must reproduce the
+                // source's inside/outside classification.  A single channel
+                // rounds stroke corners by about a texel, so pixels right
+                // at an edge may flip; none further away may.
+                using Clock = std::chrono::steady_clock;
+
+                constexpr int      kEdgeReach  = 3;   // source pixels, under one texel
+                SoftwareGlyphAtlas source;
+                SdfGlyphAtlas      sdf;
+                uint64_t           inked       = 0;
+                uint64_t           mismatched  = 0;
+                uint64_t           farFromEdge = 0;
+
+                source.BuildProcedural();
+
+                Clock::time_point start = Clock::now();
+                Assert::AreEqual (S_OK, sdf.Generate (source.GetWidth(), source.GetHeight(), source.Coverage(), 4, s_kSpread));
+                double generateMs = std::chrono::duration<double, std::milli> (Clock::now() - start).count();
+
+                Assert::AreEqual (512u, sdf.GetWidth());
+                Assert::AreEqual (512u, sdf.GetHeight());
+
+                auto isInside = [&source] (int x, int y)
+                {
+                    int maxX = static_cast<int> (source.GetWidth())  - 1;
+                    int maxY = static_cast<int> (source.GetHeight()) - 1;
+
+                    return source.Row (static_cast<UINT> (std::clamp (y, 0, maxY)))[std::clamp (x, 0, maxX)] >= 128;
+                };
+
+                for (int y = 0; y < static_cast<int> (source.GetHeight()); y++)
+                {
+                    for (int x = 0; x < static_cast<int> (source.GetWidth()); x++)
+                    {
+                        float u        = (static_cast<float> (x) + 0.5f) / static_cast<float> (source.GetWidth());
+                        float v        = (static_cast<float> (y) + 0.5f) / static_cast<float> (source.GetHeight());
+                        bool  expected = isInside (x, y);
+                        bool  actual   = sdf.SampleCoverage (u, v, 4.0f) >= 0.5f;
+                        bool  nearEdge = false;
+
+                        inked += expected ? 1 : 0;
+
+                        if (expected == actual)
+                        {
+                            continue;
+                        }
+
+                        mismatched++;
+
+                        for (int dy = -kEdgeReach; dy <= kEdgeReach && !nearEdge; dy++)
+                        {
+                            for (int dx = -kEdgeReach; dx <= kEdgeReach && !nearEdge; dx++)
+                            {
+                                nearEdge = isInside (x + dx, y + dy) != expected;
+                            }
+                        }
+
+                        farFromEdge += nearEdge ? 0 : 1;
+                    }
+                }
+
+                double mismatchRatio = static_cast<double> (mismatched) / static_cast<double> (inked);
+
+                Logger::WriteMessage (std::format ("2048x2048 -> 512x512 SDF in {:.1f} ms; {} of {} inked pixels flipped ({:.2f}%), {} of them away from an edge\n",
+                                                   generateMs, mismatched, inked, mismatchRatio * 100.0, farFromEdge).c_str());
+
+                Assert::AreEqual (uint64_t (0), farFromEdge);
+                Assert::IsTrue   (mismatchRatio < 0.05);
+            }
+
+
+
+
+            TEST_METHOD (Generate_RejectsBadArguments)
+            {
+                std::vector<uint8_t> coverage (64 * 64, 0);
+                SdfGlyphAtlas        sdf;
+
+                Assert::AreEqual (E_INVALIDARG, sdf.Generate (64, 64, std::span (coverage).first (100), 4, s_kSpread));
+                Assert::AreEqual (E_INVALIDARG, sdf.Generate (64, 64, coverage, 0,  s_kSpread));
+                Assert::AreEqual (E_INVALIDARG, sdf.Generate (64, 64, coverage, 5,  s_kSpread));
+                Assert::AreEqual (E_INVALIDARG, sdf.Generate (64, 64, coverage, 4,  0.0f));
+                Assert::IsFalse  (sdf.IsValid());
+
+                // An empty image is all "far outside"
+                Assert::AreEqual (S_OK, sdf.Generate (64, 64, coverage, 4, s_kSpread));
+                Assert::AreEqual (0.0f, sdf.SampleCoverage (0.5f, 0.5f, 100.0f));
+                Assert::AreEqual (-s_kSpread, sdf.SampleDistance (0.5f, 0.5f), 0.02f);
+            }
+    };
+}
@@ -0,0 +1,442 @@
+#include "Pch_MatrixRainTests.h"
+
+#include "..\SpyRenderSystem.h"
+#include "..\..\MatrixRainCore\AnimationSystem.h"
+#include "..\..\MatrixRainCore\SharedRenderWorker.h"
+#include "..\..\MatrixRainCore\Viewport.h"
+
+
+
+
+namespace MatrixRainTests
+{
+    using namespace std::chrono;
+    using Clock = steady_clock;
+
+
+
+
+    // A SpyRenderSystem on a simulated display.  Vblanks fall every `period`
+    // from `phase`; Render spins for `renderCost` of CPU; Present models a
+    // one-deep flip queue: it queues the frame for the next vblank, first
+    // blocking until the previously queued flip has been shown.
+    class VBlankSpyRenderSystem : public SpyRenderSystem
+    {
+    public:
+        VBlankSpyRenderSystem (Clock::duration period, Clock::time_point phase, Clock::duration renderCost) :
+            m_period     (period),
+            m_phase      (phase),
+            m_renderCost (renderCost)
+        {
+        }
+
+
+        void Render (const AnimationSystem & animationSystem, const Viewport & viewport, const RenderParams & params) override
+        {
+            Clock::time_point start = Clock::now();
+
+            SpyRenderSystem::Render (animationSystem, viewport, params);
+
+            m_renderStartUs.push_back (duration_cast<microseconds> (start - LastVBlank (start)).count());
+
+            while (Clock::now() - start < m_renderCost)
+            {
+            }
+        }
+
+
+        HRESULT Present() override
+        {
+            if (m_pendingFlip && Clock::now() < *m_pendingFlip)
+            {
+                std::this_thread::sleep_until (*m_pendingFlip);
+                m_blockedPresents++;
+            }
+
+            Clock::time_point flip = LastVBlank (Clock::now()) + m_period;
+
+            if (flip != m_pendingFlip)
+            {
+                m_flips++;
+            }
+
+            m_pendingFlip = flip;
+
+            return SpyRenderSystem::Present();
+        }
+
+
+        Clock::time_point LastVBlank (Clock::time_point time) const
+        {
+            return m_phase + ((time - m_phase) / m_period) * m_period;
+        }
+
+
+        Clock::duration      m_period;
+        Clock::time_point    m_phase;
+        Clock::duration      m_renderCost;
+
+        std::optional<Clock::time_point> m_pendingFlip;
+        int                              m_flips           = 0;     // distinct vblanks that showed a new frame
+        int                              m_blockedPresents = 0;
+        std::vector<int64_t>             m_renderStartUs;           // render start after the latest vblank
+    };
+
+
+
+
+    struct SimulatedDisplays
+    {
+        std::vector<std::unique_ptr<VBlankSpyRenderSystem>> displays;
+        AnimationSystem                                     animationSystem;
+        Viewport                                            viewport;
+        RenderParams                                        params;
+    };
+
+
+    // Four displays at 60, 60 (4 ms out of phase), 75 and 144 Hz
+    static void AddDisplays (SimulatedDisplays & simulated, Clock::duration renderCost)
+    {
+        Clock::time_point phase = Clock::now();
+
+        for (auto [hz, offsetUs] : { std::pair { 60, 0 }, std::pair { 60, 4000 }, std::pair { 75, 2000 }, std::pair { 144, 1000 } })
+        {
+            simulated.displays.push_back (std::make_unique<VBlankSpyRenderSystem> (nanoseconds (1'000'000'000 / hz), phase + microseconds (offsetUs), renderCost));
+        }
+    }
+
+
+
+
+    static double ProcessCpuMilliseconds()
+    {
+        FILETIME creation = {};
+        FILETIME exit     = {};
+        FILETIME kernel   = {};
+        FILETIME user     = {};
+
+        GetProcessTimes (GetCurrentProcess(), &creation, &exit, &kernel, &user);
+
+        auto toMs = [] (const FILETIME & time) { return static_cast<double> ((static_cast<uint64_t> (time.dwHighDateTime) << 32) | time.dwLowDateTime) / 10'000.0; };
+
+        return toMs (kernel) + toMs (user);
+    }
+
+
+
+
+    static int64_t Percentile (std::vector<int64_t> samples, double percentile)
+    {
+        std::sort (samples.begin(), samples.end());
+
+        return samples.empty() ? 0 : samples[static_cast<size_t> (percentile / 100.0 * static_cast<double> (samples.size() - 1))];
+    }
+
+
+
+
+    // Logs and returns the fraction of vblanks, across all displays, that
+    // showed a new frame
+    static double Report (const char * label, const SimulatedDisplays & simulated, Clock::duration elapsed, double cpuMs)
+    {
+        std::vector<int64_t> renderStart;
+        int                  flips   = 0;
+        int64_t              vblanks = 0;
+
+        for (const auto & display : simulated.displays)
+        {
+            renderStart.insert (renderStart.end(), display->m_renderStartUs.begin(), display->m_renderStartUs.end());
+            flips   += display->m_flips;
+            vblanks += elapsed / display->m_period + 1;
+        }
+
+        double shown = static_cast<double> (flips) / static_cast<double> (vblanks);
+
+        Logger::WriteMessage (std::format ("{:14}: {:5.1f}% of vblanks got a new frame; render start after vblank p50 {:5} us, p99 {:5} us; CPU {:6.1f} ms\n",
+                                           label, shown * 100.0, Percentile (renderStart, 50.0), Percentile (renderStart, 99.0), cpuMs).c_str());
+
+        return shown;
+    }
+
+
+
+
+    TEST_CLASS (SharedRenderWorkerTests)
+    {
+        public:
+            TEST_METHOD (Scheduler_ServicesDisplaysInVBlankOrder)
+            {
+                VBlankScheduler   scheduler;
+                Clock::time_point t0 = Clock::time_point {} + seconds (100);
+
+                scheduler.AddDisplay (milliseconds (16), t0 + milliseconds (5));
+                scheduler.AddDisplay (milliseconds (10), t0 + milliseconds (2));
+                scheduler.AddDisplay (milliseconds (7),  t0 + milliseconds (3));
+
+                // Walk 50 ms of simulated time, servicing each display
+                // exactly at its deadline
+                std::vector<size_t>            order;
+                std::vector<Clock::time_point> when;
+
+                for (;;)
+                {
+                    size_t            next     = scheduler.GetNext();
+                    Clock::time_point deadline = scheduler.GetDeadline (next);
+
+                    if (deadline > t0 + milliseconds (50))
+                    {
+                        break;
+                    }
+
+                    order.push_back (next);
+                    when.push_back  (deadline);
+                    scheduler.Complete (next, deadline + microseconds (100));
+                }
+
+                // Deadlines come out in time order and every display hit
+                // every one of its vblanks
+                Assert::IsTrue (std::is_sorted (when.begin(), when.end()));
+
+                const std::vector<size_t> expected { 1, 2, 0, 2, 1, 2, 0, 1, 2, 2, 1, 0, 2, 1, 2 };
+
+                Assert::IsTrue (order == expected);
+
+                for (size_t display = 0; display < 3; display++)
+                {
+                    Assert::AreEqual (uint64_t (0), scheduler.GetMissed (display));
+                }
+            }
+
+
+
+
+            TEST_METHOD (Scheduler_CountsMissedVBlanksAndStaysOnTheGrid)
+            {
+                VBlankScheduler   scheduler;
+                Clock::time_point t0 = Clock::time_point {} + seconds (100);
+
+                scheduler.AddDisplay (milliseconds (10), t0);
+
+                // Serviced 25 ms late: the vblanks at +10 and +20 passed
+                // without a frame; the next deadline is back on the grid
+                scheduler.Complete (0, t0 + milliseconds (25));
+
+                Assert::AreEqual (uint64_t (2), scheduler.GetMissed (0));
+                Assert::IsTrue   (scheduler.GetDeadline (0) == t0 + milliseconds (30));
+
+                // Resync onto an observed vblank 3 ms later than nominal
+                scheduler.Resync (0, t0 + milliseconds (23));
+
+                Assert::IsTrue (scheduler.GetDeadline (0) == t0 + milliseconds (33));
+            }
+
+
+
+
+            TEST_METHOD (Scheduler_DeferredDisplaysComeBackOnExpedite)
+            {
+                VBlankScheduler   scheduler;
+                Clock::time_point t0 = Clock::time_point {} + seconds (100);
+
+                scheduler.AddDisplay (milliseconds (10), t0);
+                scheduler.AddDisplay (milliseconds (10), t0 + milliseconds (5));
+
+                // Display 0 is paused with a static picture: parked for a second
+                scheduler.Complete   (0, t0 + milliseconds (1));
+                scheduler.DeferUntil (0, t0 + milliseconds (1001));
+
+                Assert::IsTrue   (scheduler.GetDeadline (0) == t0 + milliseconds (1010));
+                Assert::AreEqual (size_t (1), scheduler.GetNext());
+
+                // A state change brings it back at its next vblank
+                scheduler.Expedite (t0 + milliseconds (42));
+
+                Assert::IsTrue (scheduler.GetDeadline (0) == t0 + milliseconds (50));
+
+                // Retired displays are never picked again
+                scheduler.Retire (1);
+
+                Assert::AreEqual (size_t (0), scheduler.GetNext());
+
+                scheduler.Retire (0);
+
+                Assert::AreEqual (VBlankScheduler::s_kNone, scheduler.GetNext());
+            }
+
+
+
+
+            TEST_METHOD (AssignContextsToWorkers_RoundRobinWithoutEmptyWorkers)
+            {
+                Assert::IsTrue (RenderThreadModelForWorkerCount (0) == RenderThreadModel::PerMonitor);
+                Assert::IsTrue (RenderThreadModelForWorkerCount (2) == RenderThreadModel::SharedWorker);
+
+                std::vector<std::vector<size_t>> two  = AssignContextsToWorkers (5, 2);
+                std::vector<std::vector<size_t>> many = AssignContextsToWorkers (3, 8);
+
+                Assert::IsTrue   (two == std::vector<std::vector<size_t>> { { 0, 2, 4 }, { 1, 3 } });
+                Assert::AreEqual (size_t (3), many.size());
+            }
+
+
+
+
+            TEST_METHOD (Worker_IdlesParkedTargetsAndRetiresLostOnes)
+            {
+                RenderWakeSignal  wake;
+                std::atomic<bool> paused   { true };
+                std::atomic<int>  frames[3] {};
+
+                std::vector<ScheduledRenderTarget> targets;
+
+                // 0: paused with a static picture, redrawn once a second
+                targets.push_back ({ milliseconds (10), [&] (Clock::time_point now)
+                {
+                    frames[0]++;
+
+                    RenderStep step;
+
+                    if (paused)
+                    {
+                        step.idleUntil = now + seconds (1);
+                    }
+
+                    return step;
+                } });
+
+                // 1: renders every vblank
+                targets.push_back ({ milliseconds (10), [&] (Clock::time_point) { frames[1]++; return RenderStep {}; } });
+
+                // 2: loses its device on the third frame
+                targets.push_back ({ milliseconds (10), [&] (Clock::time_point) { return RenderStep { .keepRunning = ++frames[2] < 3 }; } });
+
+                SharedRenderWorker worker (std::move (targets), wake);
+
+                worker.Start();
+                std::this_thread::sleep_for (milliseconds (300));
+
+                int parkedFrames = frames[0];
+
+                // Resume: the parked target is back within a vblank or two
+                paused = false;
+                wake.Notify();
+                std::this_thread::sleep_for (milliseconds (100));
+
+                worker.RequestStop();
+                worker.Join();
+
+                Logger::WriteMessage (std::format ("300 ms: parked {} frames, live {}; 100 ms after resume: {}\n",
+                                                   parkedFrames, frames[1].load(), frames[0] - parkedFrames).c_str());
+
+                Assert::AreEqual (1,    parkedFrames);
+                Assert::IsTrue   (frames[1] > 25);
+                Assert::IsTrue   (frames[0] - parkedFrames > 5);
+                Assert::AreEqual (3,    frames[2].load());
+                Assert::IsTrue   (worker.GetScheduler().IsRetired (2));
+            }
+
+
+
+
+            TEST_METHOD (Benchmark_PerMonitorThreadsVersusOneSharedWorker)
+            {
+                // Four simulated displays (60, 60 out of phase, 75, 144 Hz)
+                // with 1.5 ms of CPU per frame, driven for one second first
+                // by one thread each, then by a single SharedRenderWorker.
+                // Reports how many vblanks got a new frame, how long after
+                // its vblank each frame started (wake-up jitter) and the
+                // process CPU time, and for the worker how late its
+                // deadline waits woke.
+                constexpr auto kRun        = milliseconds (1000);
+                constexpr auto kRenderCost = microseconds (1500);
+
+                double  perMonitorShown = 0.0;
+                double  sharedShown     = 0.0;
+                int64_t sharedWakeP50   = 0;
+
+                {
+                    SimulatedDisplays        simulated;
+                    std::atomic<bool>        stop { false };
+                    std::vector<std::thread> threads;
+
+                    AddDisplays (simulated, kRenderCost);
+
+                    double            cpuStart = ProcessCpuMilliseconds();
+                    Clock::time_point start    = Clock::now();
+
+                    for (auto & display : simulated.displays)
+                    {
+                        threads.emplace_back ([&, spy = display.get()]
+                        {
+                            while (!stop)
+                            {
+                                spy->Render (simulated.animationSystem, simulated.viewport, simulated.params);
+                                spy->Present();
+                            }
+                        });
+                    }
+
+                    std::this_thread::sleep_for (kRun);
+                    stop = true;
+
+                    for (std::thread & thread : threads)
+                    {
+                        thread.join();
+                    }
+
+                    perMonitorShown = Report ("per-monitor", simulated, Clock::now() - start, ProcessCpuMilliseconds() - cpuStart);
+                }
+
+                {
+                    SimulatedDisplays                  simulated;
+                    RenderWakeSignal                   wake;
+                    std::vector<ScheduledRenderTarget> targets;
+
+                    AddDisplays (simulated, kRenderCost);
+
+                    for (auto & display : simulated.displays)
+                    {
+                        targets.push_back ({ display->m_period, [&, spy = display.get()] (Clock::time_point now)
+                        {
+                            spy->Render (simulated.animationSystem, simulated.viewport, simulated.params);
+                            spy->Present();
+
+                            return RenderStep { .vblank = spy->LastVBlank (now) };
+                        } });
+                    }
+
+                    SharedRenderWorker worker (std::move (targets), wake);
+
+                    double            cpuStart = ProcessCpuMilliseconds();
+                    Clock::time_point start    = Clock::now();
+
+                    worker.Start();
+                    std::this_thread::sleep_for (kRun);
+                    worker.RequestStop();
+                    worker.Join();
+
+                    sharedShown = Report ("shared worker", simulated, Clock::now() - start, ProcessCpuMilliseconds() - cpuStart);
+
+                    int blocked = 0;
+
+                    for (const auto & display : simulated.displays)
+                    {
+                        blocked += display->m_blockedPresents;
+                    }
+
+                    const TimingHistogram & lateness = worker.GetWakeLateness();
+
+                    Logger::WriteMessage (std::format ("shared worker: {} presents blocked on a pending flip; {} hardware threads\n",
+                                                       blocked, std::thread::hardware_concurrency()).c_str());
+                    Logger::WriteMessage (std::format ("shared worker: deadline wake lateness p50 {} us, p99 {} us, max {} us over {} waits\n",
+                                                       lateness.GetPercentile (50.0), lateness.GetPercentile (99.0), lateness.GetMax(), lateness.GetCount()).c_str());
+
+                    sharedWakeP50 = lateness.GetPercentile (50.0);
+                }
+
+                Assert::IsTrue (perMonitorShown > 0.5);
+                Assert::IsTrue (sharedShown     > 0.5);
+                Assert::IsTrue (sharedWakeP50   < 4000, L"Deadline waits should not round to the 15.6 ms timer tick");
+            }
+    };
+}
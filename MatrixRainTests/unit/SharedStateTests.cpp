@@ -0,0 +1,230 @@
+#include "Pch_MatrixRainTests.h"
+
+#include "..\..\MatrixRainCore\SharedState.h"
+
+
+
+
+namespace MatrixRainTests
+{
+    // Every mutex-protected int field set to the same value, so a torn
+    // snapshot shows up as fields that disagree
+    static void WriteGeneration (SharedState & state, int generation)
+    {
+        SharedState::WriteLock lock (state);
+
+        state.densityPercent        = generation;
+        state.animationSpeedPercent = generation;
+        state.glowIntensityPercent  = generation;
+        state.glowSizePercent       = generation;
+        state.blurPasses            = generation;
+        state.showStatistics        = (generation & 1) != 0;
+        state.isPaused              = (generation & 1) != 0;
+    }
+
+
+
+
+    static bool IsConsistent (const SharedState::Snapshot & snapshot)
+    {
+        int generation = snapshot.densityPercent;
+
+        return snapshot.animationSpeedPercent == generation               &&
+               snapshot.glowIntensityPercent  == generation               &&
+               snapshot.glowSizePercent       == generation               &&
+               snapshot.blurPasses            == generation               &&
+               snapshot.showStatistics        == ((generation & 1) != 0)  &&
+               snapshot.isPaused              == ((generation & 1) != 0);
+    }
+
+
+
+
+    TEST_CLASS (SharedStateTests)
+    {
+        public:
+            TEST_METHOD (GetSnapshot_SeesWritesWhenWriteLockReleases)
+            {
+                SharedState state;
+                uint64_t    version = state.GetVersion();
+
+                {
+                    SharedState::WriteLock lock (state);
+
+                    state.colorScheme    = ColorScheme::Amber;
+                    state.densityPercent = 42;
+
+                    // Not yet published
+                    Assert::IsTrue (state.GetSnapshot().colorScheme == ColorScheme::Green);
+                }
+
+                SharedState::Snapshot snapshot = state.GetSnapshot();
+
+                Assert::IsTrue   (snapshot.colorScheme == ColorScheme::Amber);
+                Assert::AreEqual (42,                  snapshot.densityPercent);
+                Assert::AreEqual (version + 2,         state.GetVersion());
+            }
+
+
+
+
+            TEST_METHOD (GetSnapshot_MergesAtomicsWithoutAWrite)
+            {
+                SharedState state;
+
+                state.elapsedTime    .store (12.5f, std::memory_order_relaxed);
+                state.liveGlowEnabled.store (false, std::memory_order_relaxed);
+                state.liveCustomColor.store (0x00123456, std::memory_order_relaxed);
+
+                SharedState::Snapshot snapshot = state.GetSnapshot();
+
+                Assert::AreEqual (12.5f,              snapshot.elapsedTime);
+                Assert::IsFalse  (snapshot.glowEnabled);
+                Assert::AreEqual (DWORD (0x00123456), snapshot.customColor);
+            }
+
+
+
+
+            TEST_METHOD (Stress_ReadersNeverSeeTornOrStaleSnapshots)
+            {
+                // One writer publishing as fast as it can against eight
+                // readers: every snapshot must be a whole generation, and
+                // each reader's generations must never go backwards.  All
+                // payload accesses are atomic, so this is also clean under
+                // ThreadSanitizer.
+                constexpr int            kReaders     = 8;
+                constexpr int            kGenerations = 20000;
+                SharedState              state;
+                std::atomic<bool>        done         { false };
+                std::atomic<int>         torn         { 0 };
+                std::atomic<int>         backwards    { 0 };
+                std::atomic<uint64_t>    reads        { 0 };
+                std::vector<std::thread> readers;
+                uint64_t                 version      = 0;
+
+                WriteGeneration (state, 0);
+                version = state.GetVersion();
+
+                for (int r = 0; r < kReaders; r++)
+                {
+                    readers.emplace_back ([&] ()
+                    {
+                        int      last  = -1;
+                        uint64_t count = 0;
+
+                        while (!done.load (std::memory_order_acquire))
+                        {
+                            SharedState::Snapshot snapshot = state.GetSnapshot();
+
+                            torn      += IsConsistent (snapshot) ? 0 : 1;
+                            backwards += snapshot.densityPercent < last ? 1 : 0;
+                            last       = snapshot.densityPercent;
+                            count++;
+                        }
+
+                        reads += count;
+                    });
+                }
+
+                for (int generation = 1; generation < kGenerations; generation++)
+                {
+                    WriteGeneration (state, generation);
+                }
+
+                done.store (true, std::memory_order_release);
+
+                for (std::thread & reader : readers)
+                {
+                    reader.join();
+                }
+
+                Logger::WriteMessage (std::format ("{} generations, {} snapshots read\n", kGenerations, reads.load()).c_str());
+
+                Assert::AreEqual (kGenerations - 1,                 state.GetSnapshot().densityPercent);
+                Assert::AreEqual (0,                                torn.load());
+                Assert::AreEqual (0,                                backwards.load());
+                Assert::AreEqual (version + 2 * (kGenerations - 1), state.GetVersion());
+            }
+
+
+
+
+            TEST_METHOD (Benchmark_SnapshotReadsUnderContention)
+            {
+                // Eight render-thread stand-ins read a snapshot in a loop
+                // while a UI-thread stand-in writes every 100 us; compares
+                // the seqlock against the previous lock-and-copy pattern.
+                constexpr int                       kReaders  = 8;
+                constexpr std::chrono::milliseconds kDuration { 300 };
+
+                auto run = [&] (auto readOnce) -> double
+                {
+                    SharedState              state;
+                    std::atomic<bool>        done       { false };
+                    std::atomic<uint64_t>    reads      { 0 };
+                    std::vector<std::thread> threads;
+                    int                      generation = 0;
+
+                    for (int r = 0; r < kReaders; r++)
+                    {
+                        threads.emplace_back ([&] ()
+                        {
+                            uint64_t count = 0;
+
+                            while (!done.load (std::memory_order_relaxed))
+                            {
+                                SharedState::Snapshot snapshot = readOnce (state);
+
+                                count += snapshot.densityPercent >= 0 ? 1 : 0;
+                            }
+
+                            reads += count;
+                        });
+                    }
+
+                    auto stop = std::chrono::steady_clock::now() + kDuration;
+
+                    while (std::chrono::steady_clock::now() < stop)
+                    {
+                        WriteGeneration (state, generation++);
+                        std::this_thread::sleep_for (std::chrono::microseconds (100));
+                    }
+
+                    done.store (true);
+
+                    for (std::thread & thread : threads)
+                    {
+                        thread.join();
+                    }
+
+                    return static_cast<double> (reads.load()) / std::chrono::duration<double> (kDuration).count();
+                };
+
+                double seqlockRate = run ([] (const SharedState & state)
+                {
+                    return state.GetSnapshot();
+                });
+
+                double mutexRate = run ([] (const SharedState & state)
+                {
+                    std::lock_guard<std::mutex> lock (state.mutex);
+
+                    return SharedState::Snapshot
+                    {
+                        .densityPercent        = state.densityPercent,
+                        .colorScheme           = state.colorScheme,
+                        .animationSpeedPercent = state.animationSpeedPercent,
+                        .glowIntensityPercent  = state.glowIntensityPercent,
+                        .glowSizePercent       = state.glowSizePercent,
+                        .blurPasses            = state.blurPasses,
+                    };
+                });
+
+                Logger::WriteMessage (std::format ("{} readers, {} hardware threads: seqlock {:.1f} M snapshots/s, mutex {:.1f} M snapshots/s\n",
+                                                   kReaders, std::thread::hardware_concurrency(), seqlockRate / 1e6, mutexRate / 1e6).c_str());
+
+                Assert::IsTrue (seqlockRate > 0.0 && mutexRate > 0.0);
+            }
+    };
+}
@@ -0,0 +1,364 @@
+#include "Pch_MatrixRainTests.h"
+
+#include "..\..\MatrixRainCore\AnimationSystem.h"
+#include "..\..\MatrixRainCore\CharacterSet.h"
+#include "..\..\MatrixRainCore\DensityController.h"
+#include "..\..\MatrixRainCore\SimulationPipeline.h"
+#include "..\..\MatrixRainCore\Viewport.h"
+
+
+
+
+namespace MatrixRainTests
+{
+    using namespace std::chrono;
+
+
+
+
+    // Order-sensitive digest of a step's streaks: identity, position and
+    // length of each, so a frame mixing two steps digests to neither
+    static uint64_t DigestStreaks (const std::vector<CharacterStreak> & streaks)
+    {
+        uint64_t digest = 1469598103934665603ull;
+
+        auto mix = [&digest] (uint64_t value)
+        {
+            digest = (digest ^ value) * 1099511628211ull;
+        };
+
+        for (const CharacterStreak & streak : streaks)
+        {
+            mix (streak.GetID());
+            mix (std::bit_cast<uint32_t> (streak.GetPosition().x));
+            mix (std::bit_cast<uint32_t> (streak.GetPosition().y));
+            mix (streak.GetCharacterCount());
+        }
+
+        return digest;
+    }
+
+
+
+
+    // A monitor's simulation, as MonitorRenderContext wires it: the pipeline
+    // steps `animation`, and the render side draws `presented`
+    struct PipelineFixture
+    {
+        Viewport                            viewport;
+        std::unique_ptr<DensityController>  density;
+        AnimationSystem                     animation;
+        AnimationSystem                     presented;
+        std::unique_ptr<SimulationPipeline> pipeline;
+        SharedState                         sharedState;
+        std::atomic<bool>                   inTransition { false };
+
+        PipelineFixture()
+        {
+            CharacterSet::GetInstance().Initialize();
+
+            viewport.Resize (1920.0f, 1080.0f);
+
+            density = std::make_unique<DensityController> (viewport, 24.0f);
+
+            animation.Initialize (viewport, *density);
+            presented.Initialize (viewport, *density);
+
+            pipeline = std::make_unique<SimulationPipeline> (animation, *density);
+        }
+
+        ~PipelineFixture()
+        {
+            pipeline.reset();
+            CharacterSet::GetInstance().Shutdown();
+        }
+    };
+
+
+
+
+    TEST_CLASS (SimulationPipelineTests)
+    {
+        public:
+
+            //
+            //  FrameMailbox
+            //
+
+            TEST_METHOD (FrameMailbox_ConcurrentFramesNeverTearAndOnlyMoveForward)
+            {
+                // Every word of a published frame holds its sequence number,
+                // so a slot the consumer reads while the producer writes it
+                // shows up as mixed words
+                struct Payload
+                {
+                    std::array<uint64_t, 64> words {};
+                };
+
+                constexpr uint64_t     kFrames = 200'000;
+                FrameMailbox<Payload>  mailbox;
+                std::atomic<bool>      done    { false };
+                uint64_t               torn    = 0;
+                uint64_t               regress = 0;
+                uint64_t               adopted = 0;
+                uint64_t               last    = 0;
+
+
+
+                std::thread producer ([&]
+                {
+                    for (uint64_t sequence = 1; sequence <= kFrames; sequence++)
+                    {
+                        mailbox.Back().words.fill (sequence);
+                        mailbox.Publish();
+                    }
+
+                    done = true;
+                });
+
+                for (;;)
+                {
+                    bool finished = done;
+
+                    if (mailbox.Acquire())
+                    {
+                        const Payload & frame = mailbox.Front();
+
+                        torn    += std::any_of (frame.words.begin(), frame.words.end(), [&] (uint64_t word) { return word != frame.words[0]; }) ? 1 : 0;
+                        regress += frame.words[0] <= last ? 1 : 0;
+                        last     = frame.words[0];
+                        adopted++;
+                    }
+                    else if (finished)
+                    {
+                        break;
+                    }
+                }
+
+                producer.join();
+
+                Logger::WriteMessage (std::format ("{} frames published, {} adopted\n", kFrames, adopted).c_str());
+
+                Assert::AreEqual (uint64_t (0), torn);
+                Assert::AreEqual (uint64_t (0), regress);
+                Assert::AreEqual (kFrames,      last, L"The newest frame is always the last one adopted");
+            }
+
+
+
+
+            TEST_METHOD (FrameMailbox_AcquireWithoutPublishKeepsFront)
+            {
+                FrameMailbox<int> mailbox;
+
+                Assert::IsFalse (mailbox.Acquire());
+
+                mailbox.Back() = 7;
+                mailbox.Publish();
+
+                Assert::IsTrue   (mailbox.Acquire());
+                Assert::AreEqual (7, mailbox.Front());
+                Assert::IsFalse  (mailbox.Acquire());
+                Assert::AreEqual (7, mailbox.Front());
+            }
+
+
+
+
+            //
+            //  SimulationPipeline
+            //
+
+            TEST_METHOD (AdoptedFrames_MatchTheStepThatProducedThem)
+            {
+                // A producer thread steps the pipeline by hand and records
+                // each step's digest; every frame the render side adopts
+                // must carry exactly the streaks of the step it is stamped
+                // with
+                constexpr int         kSteps = 600;
+                PipelineFixture       fixture;
+                std::vector<uint64_t> digests (kSteps + 1, 0);
+                std::atomic<bool>     done   { false };
+                int                   adopted = 0;
+                int                   wrong   = 0;
+                uint64_t              last    = 0;
+
+
+
+                std::thread producer ([&]
+                {
+                    for (int step = 1; step <= kSteps; step++)
+                    {
+                        // Only this thread touches the simulated streaks
+                        fixture.pipeline->Step (1.0f / 60.0f, 80, 100);
+                        digests[step] = DigestStreaks (fixture.animation.GetStreaks());
+                    }
+
+                    done = true;
+                });
+
+                // Compared against the recording once the producer is done
+                std::vector<std::pair<uint64_t, uint64_t>> seen;
+
+                for (;;)
+                {
+                    bool                                finished = done;
+                    std::optional<SimulationFrameStamp> stamp    = fixture.pipeline->AdoptNewestFrame (fixture.presented);
+
+                    if (stamp)
+                    {
+                        seen.emplace_back (stamp->sequence, DigestStreaks (fixture.presented.GetStreaks()));
+                        wrong += stamp->sequence <= last ? 1 : 0;
+                        last   = stamp->sequence;
+                        adopted++;
+                    }
+                    else if (finished)
+                    {
+                        break;
+                    }
+                }
+
+                producer.join();
+
+                for (const auto & [sequence, digest] : seen)
+                {
+                    wrong += digest != digests[sequence] ? 1 : 0;
+                }
+
+                Logger::WriteMessage (std::format ("{} steps, {} adopted\n", kSteps, adopted).c_str());
+
+                Assert::IsTrue   (adopted > 0);
+                Assert::AreEqual (0, wrong);
+                Assert::AreEqual (uint64_t (kSteps), last);
+                Assert::AreEqual (uint64_t (kSteps), fixture.pipeline->GetStepCount());
+            }
+
+
+
+
+            TEST_METHOD (SimulationThread_KeepsItsCadenceWhileRenderingStalls)
+            {
+                // The render side takes 20 ms a frame (a Present blocked
+                // behind a busy GPU); the simulation keeps stepping at its
+                // own 120 Hz and the render side just skips ahead
+                PipelineFixture fixture;
+
+                fixture.pipeline->Start (fixture.sharedState, &fixture.inTransition, 120);
+
+                FrameClock::time_point start    = FrameClock::now();
+                uint64_t               first    = fixture.pipeline->GetStepCount();
+                int                    frames   = 0;
+                uint64_t               last     = 0;
+                uint64_t               skipped  = 0;
+
+                while (FrameClock::now() - start < milliseconds (400))
+                {
+                    std::optional<SimulationFrameStamp> stamp = fixture.pipeline->AdoptNewestFrame (fixture.presented);
+
+                    if (stamp)
+                    {
+                        skipped += last ? stamp->sequence - last - 1 : 0;
+                        last     = stamp->sequence;
+                    }
+
+                    frames++;
+                    std::this_thread::sleep_for (milliseconds (20));
+                }
+
+                double   seconds = ToSeconds (FrameClock::now() - start);
+                uint64_t steps   = fixture.pipeline->GetStepCount() - first;
+
+                fixture.pipeline->RequestStop();
+                fixture.pipeline->Join();
+
+                Logger::WriteMessage (std::format ("{:.0f} ms: {} steps ({:.0f}/s), {} frames, {} steps never drawn\n",
+                                                   seconds * 1000.0,
+                                                   steps,
+                                                   steps / seconds,
+                                                   frames,
+                                                   skipped).c_str());
+
+                // 120 Hz over the window is ~48 steps; the render side's
+                // stalls cap it near 20 frames
+                Assert::IsTrue (steps >= 36,                    L"Simulation stalled with the render thread");
+                Assert::IsTrue (steps > static_cast<uint64_t> (frames));
+                Assert::IsTrue (skipped > 0);
+            }
+
+
+
+
+            TEST_METHOD (InvalidateLayout_DropsFramesSimulatedUnderTheOldLayout)
+            {
+                PipelineFixture fixture;
+
+                fixture.pipeline->Step (1.0f / 60.0f, 80, 100);
+
+                std::vector<CharacterStreak> before = fixture.presented.GetStreaks();
+
+                {
+                    std::lock_guard<std::mutex> lock (fixture.pipeline->GetMutex());
+
+                    fixture.pipeline->InvalidateLayout();
+                }
+
+                Assert::IsFalse  (fixture.pipeline->AdoptNewestFrame (fixture.presented).has_value());
+                Assert::AreEqual (DigestStreaks (before), DigestStreaks (fixture.presented.GetStreaks()), L"A dropped frame leaves the presented streaks alone");
+
+                fixture.pipeline->Step (1.0f / 60.0f, 80, 100);
+
+                std::optional<SimulationFrameStamp> stamp = fixture.pipeline->AdoptNewestFrame (fixture.presented);
+
+                Assert::IsTrue   (stamp.has_value());
+                Assert::AreEqual (uint64_t (2), stamp->sequence);
+                Assert::AreEqual (uint64_t (1), stamp->layoutGeneration);
+                Assert::AreEqual (DigestStreaks (fixture.animation.GetStreaks()), DigestStreaks (fixture.presented.GetStreaks()));
+            }
+
+
+
+
+            TEST_METHOD (Join_ReturnsPromptlyWhileRunningOrPaused)
+            {
+                // Running: the thread notices the stop within one step period
+                {
+                    PipelineFixture fixture;
+
+                    fixture.pipeline->Start (fixture.sharedState, &fixture.inTransition, 30);
+                    std::this_thread::sleep_for (milliseconds (50));
+
+                    FrameClock::time_point start = FrameClock::now();
+
+                    fixture.pipeline->RequestStop();
+                    fixture.pipeline->Join();
+
+                    Assert::IsTrue (fixture.pipeline->GetStepCount() > 0);
+                    Assert::IsTrue (FrameClock::now() - start < milliseconds (200));
+                }
+
+                // Paused: blocked on the wake signal, which RequestStop notifies
+                {
+                    PipelineFixture fixture;
+
+                    {
+                        SharedState::WriteLock lock (fixture.sharedState);
+
+                        fixture.sharedState.isPaused = true;
+                    }
+
+                    fixture.pipeline->Start (fixture.sharedState, &fixture.inTransition, 60);
+                    std::this_thread::sleep_for (milliseconds (50));
+
+                    FrameClock::time_point start = FrameClock::now();
+
+                    fixture.pipeline->RequestStop();
+                    fixture.pipeline->Join();
+
+                    Assert::AreEqual (uint64_t (0), fixture.pipeline->GetStepCount(), L"No steps while paused");
+                    Assert::IsTrue   (FrameClock::now() - start < milliseconds (200));
+                }
+            }
+    };
+
+
+}
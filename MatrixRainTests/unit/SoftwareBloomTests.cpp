@@ -0,0 +1,1222 @@
+#include "Pch_MatrixRainTests.h"
+
+#include "..\..\MatrixRainCore\SoftwareBloom.h"
+#include "..\..\MatrixRainCore\AnimationSystem.h"
+#include "..\..\MatrixRainCore\CharacterSet.h"
+#include "..\..\MatrixRainCore\DensityController.h"
+#include "..\..\MatrixRainCore\GlyphBlitter.h"
+#include "..\..\MatrixRainCore\ScanlineAttenuation.h"
+#include "..\..\MatrixRainCore\ScanlineStyleMapping.h"
+#include "..\..\MatrixRainCore\SimdFloat4.h"
+#include "..\..\MatrixRainCore\SoftwareGlyphAtlas.h"
+#include "..\..\MatrixRainCore\SoftwareRenderSystem.h"
+#include "..\..\MatrixRainCore\Viewport.h"
+
+
+
+
+namespace MatrixRainTests
+{
+
+
+    struct ShaderColor
+    {
+        float c[4];
+    };
+
+
+
+
+    static float ToUnorm (uint32_t pixel, int channel)
+    {
+        return static_cast<float> ((pixel >> (channel * 8)) & 0xFF) / 255.0f;
+    }
+
+
+
+
+    static uint32_t FromUnorm (const ShaderColor & color)
+    {
+        uint32_t pixel = 0;
+
+        for (int channel = 0; channel < 4; channel++)
+        {
+            float v = std::clamp (color.c[channel], 0.0f, 1.0f);
+
+            pixel |= static_cast<uint32_t> (v * 255.0f + 0.5f) << (channel * 8);
+        }
+
+        return pixel;
+    }
+
+
+
+
+    // Texture2D.Sample with a linear, clamp-addressed sampler
+    static ShaderColor SampleLinear (const SoftwareSurface & texture, float u, float v)
+    {
+        float       tx     = u * texture.GetWidth()  - 0.5f;
+        float       ty     = v * texture.GetHeight() - 0.5f;
+        float       fx     = tx - floorf (tx);
+        float       fy     = ty - floorf (ty);
+        int         maxX   = static_cast<int> (texture.GetWidth())  - 1;
+        int         maxY   = static_cast<int> (texture.GetHeight()) - 1;
+        UINT        x0     = static_cast<UINT> (std::clamp (static_cast<int> (floorf (tx)),     0, maxX));
+        UINT        x1     = static_cast<UINT> (std::clamp (static_cast<int> (floorf (tx)) + 1, 0, maxX));
+        UINT        y0     = static_cast<UINT> (std::clamp (static_cast<int> (floorf (ty)),     0, maxY));
+        UINT        y1     = static_cast<UINT> (std::clamp (static_cast<int> (floorf (ty)) + 1, 0, maxY));
+        ShaderColor result = {};
+
+        for (int channel = 0; channel < 4; channel++)
+        {
+            float top    = ToUnorm (texture.GetPixel (x0, y0), channel) * (1.0f - fx) + ToUnorm (texture.GetPixel (x1, y0), channel) * fx;
+            float bottom = ToUnorm (texture.GetPixel (x0, y1), channel) * (1.0f - fx) + ToUnorm (texture.GetPixel (x1, y1), channel) * fx;
+
+            result.c[channel] = top * (1.0f - fy) + bottom * fy;
+        }
+
+        return result;
+    }
+
+
+
+
+    // Literal transliteration of the ApplyBloom shader chain: one fullscreen
+    // pass at a time, every pass written to an RGBA8 texture.  bloom
+    // receives the blurred buffer the composite samples.
+    static void ReferenceBloom (const SoftwareSurface & scene, SoftwareSurface & bloom, SoftwareSurface & output, const SoftwareBloomSettings & settings)
+    {
+        int                    divisor = std::clamp (static_cast<int> (settings.resolutionDivisor), 1, 8);
+        UINT                   width   = std::max (1u, scene.GetWidth()  / static_cast<UINT> (divisor));
+        UINT                   height  = std::max (1u, scene.GetHeight() / static_cast<UINT> (divisor));
+        std::span<const float> weights = SoftwareBloom::GetBlurWeights (settings.blurTaps);
+        int                    radius  = static_cast<int> (weights.size()) / 2;
+        SoftwareSurface        temp;
+
+        bloom.Resize  (width, height);
+        temp.Resize   (width, height);
+        output.Resize (scene.GetWidth(), scene.GetHeight());
+
+        for (UINT y = 0; y < height; y++)
+        {
+            for (UINT x = 0; x < width; x++)
+            {
+                ShaderColor color      = SampleLinear (scene, (x + 0.5f) / width, (y + 0.5f) / height);
+                float       luminance  = 0.2126f * color.c[0] + 0.7152f * color.c[1] + 0.0722f * color.c[2];
+                float       maxComp    = std::max (std::max (color.c[0], color.c[1]), color.c[2]);
+                float       t          = std::clamp ((std::max (luminance, maxComp) - 0.1f) / 0.5f, 0.0f, 1.0f);
+                float       amount     = t * t * (3.0f - 2.0f * t);
+
+                bloom.Row (y)[x] = FromUnorm ({ { color.c[0] * amount, color.c[1] * amount, color.c[2] * amount, 1.0f } });
+            }
+        }
+
+        auto blur = [&] (const SoftwareSurface & source, SoftwareSurface & destination, float stepU, float stepV)
+        {
+            for (UINT y = 0; y < height; y++)
+            {
+                for (UINT x = 0; x < width; x++)
+                {
+                    ShaderColor sum = {};
+
+                    for (int i = -radius; i <= radius; i++)
+                    {
+                        ShaderColor tap = SampleLinear (source, (x + 0.5f) / width + i * stepU, (y + 0.5f) / height + i * stepV);
+
+                        for (int channel = 0; channel < 4; channel++)
+                        {
+                            sum.c[channel] += tap.c[channel] * weights[size_t (i + radius)];
+                        }
+                    }
+
+                    destination.Row (y)[x] = FromUnorm (sum);
+                }
+            }
+        };
+
+        // Dual filter: the downsample / upsample shaders, one level at a time
+        auto downsample = [&] (const SoftwareSurface & source, SoftwareSurface & destination)
+        {
+            float offsetU = settings.glowSize / source.GetWidth();
+            float offsetV = settings.glowSize / source.GetHeight();
+
+            for (UINT y = 0; y < destination.GetHeight(); y++)
+            {
+                for (UINT x = 0; x < destination.GetWidth(); x++)
+                {
+                    float       u   = (x + 0.5f) / destination.GetWidth();
+                    float       v   = (y + 0.5f) / destination.GetHeight();
+                    ShaderColor sum = { { 0.0f, 0.0f, 0.0f, 1.0f } };
+
+                    for (float du : { -offsetU, offsetU })
+                    {
+                        for (float dv : { -offsetV, offsetV })
+                        {
+                            ShaderColor tap = SampleLinear (source, u + du, v + dv);
+
+                            for (int channel = 0; channel < 3; channel++)
+                            {
+                                sum.c[channel] += tap.c[channel] * 0.25f;
+                            }
+                        }
+                    }
+
+                    destination.Row (y)[x] = FromUnorm (sum);
+                }
+            }
+        };
+
+        auto upsample = [&] (const SoftwareSurface & coarse, const SoftwareSurface * fine, SoftwareSurface & destination)
+        {
+            float offsetU = 0.5f * settings.glowSize / coarse.GetWidth();
+            float offsetV = 0.5f * settings.glowSize / coarse.GetHeight();
+
+            const float taps[8][3] =
+            {
+                { -offsetU, 0.0f, 1.0f }, { offsetU, 0.0f, 1.0f }, { 0.0f, -offsetV, 1.0f }, { 0.0f, offsetV, 1.0f },
+                { -0.5f * offsetU, -0.5f * offsetV, 2.0f }, { 0.5f * offsetU, -0.5f * offsetV, 2.0f },
+                { -0.5f * offsetU,  0.5f * offsetV, 2.0f }, { 0.5f * offsetU,  0.5f * offsetV, 2.0f },
+            };
+
+            for (UINT y = 0; y < destination.GetHeight(); y++)
+            {
+                for (UINT x = 0; x < destination.GetWidth(); x++)
+                {
+                    float       u   = (x + 0.5f) / destination.GetWidth();
+                    float       v   = (y + 0.5f) / destination.GetHeight();
+                    ShaderColor sum = { { 0.0f, 0.0f, 0.0f, 1.0f } };
+
+                    for (const auto & tap : taps)
+                    {
+                        ShaderColor color = SampleLinear (coarse, u + tap[0], v + tap[1]);
+
+                        for (int channel = 0; channel < 3; channel++)
+                        {
+                            sum.c[channel] += color.c[channel] * tap[2] / 12.0f;
+                        }
+                    }
+
+                    if (fine)
+                    {
+                        ShaderColor color = SampleLinear (*fine, u, v);
+
+                        for (int channel = 0; channel < 3; channel++)
+                        {
+                            sum.c[channel] = 0.5f * (sum.c[channel] + color.c[channel]);
+                        }
+                    }
+
+                    destination.Row (y)[x] = FromUnorm (sum);
+                }
+            }
+        };
+
+        if (settings.algorithm == BloomAlgorithm::DualFilter)
+        {
+            int                          levelCount = DualFilterLevelCount (settings.blurPasses);
+            std::vector<SoftwareSurface> down (levelCount);
+            std::vector<SoftwareSurface> up   (levelCount);
+
+            for (int level = 0; level < levelCount; level++)
+            {
+                down[level].Resize (std::max (1u, width >> (level + 1)), std::max (1u, height >> (level + 1)));
+                up[level].Resize   (down[level].GetWidth(), down[level].GetHeight());
+                downsample (level == 0 ? bloom : down[level - 1], down[level]);
+            }
+
+            up[levelCount - 1] = down[levelCount - 1];
+
+            for (int level = levelCount - 2; level >= 0; level--)
+            {
+                upsample (up[level + 1], &down[level], up[level]);
+            }
+
+            upsample (up[0], nullptr, bloom);
+        }
+        else
+        {
+            for (int pass = 0; pass < std::clamp (settings.blurPasses, 1, 4); pass++)
+            {
+                blur (bloom, temp,  settings.glowSize / width, 0.0f);
+                blur (temp,  bloom, 0.0f, settings.glowSize / height);
+            }
+        }
+
+        for (UINT y = 0; y < scene.GetHeight(); y++)
+        {
+            for (UINT x = 0; x < scene.GetWidth(); x++)
+            {
+                float       u          = (x + 0.5f) / scene.GetWidth();
+                float       v          = (y + 0.5f) / scene.GetHeight();
+                ShaderColor sceneColor = SampleLinear (scene, u, v);
+                ShaderColor glow       = SampleLinear (bloom, u, v);
+                ShaderColor result     = { { 0.0f, 0.0f, 0.0f, 1.0f } };
+
+                for (int channel = 0; channel < 3; channel++)
+                {
+                    float softBloom = 1.0f - expf (-glow.c[channel] * settings.intensity);
+
+                    result.c[channel] = sceneColor.c[channel] + softBloom * (1.0f - sceneColor.c[channel]);
+                }
+
+                output.Row (y)[x] = FromUnorm (result);
+            }
+        }
+    }
+
+
+
+
+    // A small rain-like scene: bright and dim glyphs, some overlapping
+    static void BuildTestScene (SoftwareSurface & scene, UINT width, UINT height)
+    {
+        SoftwareGlyphAtlas                    atlas;
+        GlyphBlitter                          blitter;
+        std::mt19937                          rng (2024);
+        std::uniform_real_distribution<float> unit (0.0f, 1.0f);
+        constexpr float                       kCellU = float (SoftwareGlyphAtlas::s_kCellWidth)  / SoftwareGlyphAtlas::s_kAtlasSize;
+        constexpr float                       kCellV = float (SoftwareGlyphAtlas::s_kCellHeight) / SoftwareGlyphAtlas::s_kAtlasSize;
+
+        atlas.BuildProcedural();
+        scene.Resize (width, height);
+        scene.Clear  (SoftwareSurface::s_kOpaqueBlack);
+
+        for (int i = 0; i < 60; i++)
+        {
+            int       cell = static_cast<int> (unit (rng) * 271.0f);
+            GlyphQuad quad = {};
+
+            quad.x0         = unit (rng) * width  - 8.0f;
+            quad.y0         = unit (rng) * height - 12.0f;
+            quad.x1         = quad.x0 + 16.0f;
+            quad.y1         = quad.y0 + 24.0f;
+            quad.u0         = (cell % 16) * kCellU;
+            quad.v0         = (cell / 16) * kCellV;
+            quad.u1         = quad.u0 + kCellU;
+            quad.v1         = quad.v0 + kCellV;
+            quad.color[0]   = 0.3f * unit (rng);
+            quad.color[1]   = 0.5f + 0.5f * unit (rng);
+            quad.color[2]   = 0.3f * unit (rng);
+            quad.color[3]   = 1.0f;
+            quad.brightness = 0.2f + 0.8f * unit (rng);
+
+            blitter.Blit (scene, atlas, quad, GlyphBlendMode::Alpha);
+        }
+    }
+
+
+
+
+    static int MaxChannelDifference (const SoftwareSurface & a, const SoftwareSurface & b)
+    {
+        int worst = 0;
+
+        for (size_t i = 0; i < a.Pixels().size(); i++)
+        {
+            for (int channel = 0; channel < 4; channel++)
+            {
+                int ca = static_cast<int> ((a.Pixels()[i] >> (channel * 8)) & 0xFF);
+                int cb = static_cast<int> ((b.Pixels()[i] >> (channel * 8)) & 0xFF);
+
+                worst = std::max (worst, abs (ca - cb));
+            }
+        }
+
+        return worst;
+    }
+
+
+
+
+    static double CountFetchesInMillions (const SoftwareSurface & bloom, const SoftwareBloomSettings & settings)
+    {
+        return static_cast<double> (SoftwareBloom::CountBlurFetches (bloom.GetWidth(), bloom.GetHeight(), settings)) / 1'000'000.0;
+    }
+
+
+
+
+    // RMS of the per-channel difference over the RGB channels, divided by
+    // the RMS of the reference, so it reads as a fraction of the glow
+    static double RelativeRmsError (const SoftwareSurface & reference, const SoftwareSurface & actual)
+    {
+        double errorSquared     = 0.0;
+        double referenceSquared = 0.0;
+
+        for (size_t i = 0; i < reference.Pixels().size(); i++)
+        {
+            for (int channel = 0; channel < 3; channel++)
+            {
+                double r = static_cast<double> ((reference.Pixels()[i] >> (channel * 8)) & 0xFF);
+                double a = static_cast<double> ((actual.Pixels()[i]    >> (channel * 8)) & 0xFF);
+
+                errorSquared     += (a - r) * (a - r);
+                referenceSquared += r * r;
+            }
+        }
+
+        return referenceSquared > 0.0 ? sqrt (errorSquared / referenceSquared) : 0.0;
+    }
+
+
+
+
+    TEST_CLASS (SoftwareBloomTests)
+    {
+        public:
+
+            TEST_CLASS_INITIALIZE (ClassSetup)
+            {
+                CharacterSet::GetInstance().Initialize();
+            }
+
+
+
+
+            TEST_METHOD (Apply_MatchesShaderMath_AllTapCountsDivisorsAndSizes)
+            {
+                SoftwareSurface scene;
+                WorkerPool      pool (1);
+
+                BuildTestScene (scene, 160, 96);
+
+                for (BlurTaps taps : { BlurTaps::Low, BlurTaps::Medium, BlurTaps::High })
+                {
+                    for (ResolutionDivisor divisor : { ResolutionDivisor::Full, ResolutionDivisor::Half, ResolutionDivisor::Quarter, ResolutionDivisor::Eighth })
+                    {
+                        for (float glowSize : { 0.5f, 1.0f, 1.7f, 2.0f })
+                        {
+                            SoftwareBloomSettings settings;
+                            SoftwareBloom         bloom;
+                            SoftwareSurface       expectedBloom;
+                            SoftwareSurface       expected;
+                            SoftwareSurface       actual;
+
+                            settings.blurTaps          = taps;
+                            settings.resolutionDivisor = divisor;
+                            settings.glowSize          = glowSize;
+                            settings.blurPasses        = glowSize > 1.0f ? 2 : 3;
+                            settings.intensity         = 2.5f * glowSize;
+
+                            ReferenceBloom (scene, expectedBloom, expected, settings);
+                            bloom.Apply (pool, scene, actual, settings);
+
+                            int worstBloom = MaxChannelDifference (expectedBloom, bloom.GetBloomSurface());
+                            int worst      = MaxChannelDifference (expected, actual);
+
+                            // Summation order differs from the shader's, so the
+                            // blurred buffer may round one step differently; the
+                            // composite's slope at zero is the intensity, which
+                            // scales that step in the final image
+                            int bloomTolerance  = 1;
+                            int outputTolerance = 1 + static_cast<int> (ceilf (settings.intensity));
+
+                            Assert::IsTrue (worstBloom <= bloomTolerance, std::format (L"{} taps, divisor {}, glow size {}: bloom buffer max channel difference {}",
+                                                                                       static_cast<int> (taps),
+                                                                                       static_cast<int> (divisor),
+                                                                                       glowSize,
+                                                                                       worstBloom).c_str());
+
+                            Assert::IsTrue (worst <= outputTolerance, std::format (L"{} taps, divisor {}, glow size {}: output max channel difference {}",
+                                                                                   static_cast<int> (taps),
+                                                                                   static_cast<int> (divisor),
+                                                                                   glowSize,
+                                                                                   worst).c_str());
+
+                        }
+                    }
+                }
+            }
+
+
+
+
+            TEST_METHOD (DualFilter_MatchesShaderMath_AllDivisorsPassesAndSizes)
+            {
+                SoftwareSurface scene;
+                WorkerPool      pool (1);
+
+                BuildTestScene (scene, 160, 96);
+
+                for (ResolutionDivisor divisor : { ResolutionDivisor::Full, ResolutionDivisor::Half, ResolutionDivisor::Quarter, ResolutionDivisor::Eighth })
+                {
+                    for (int passes : { 1, 2, 3, 4 })
+                    {
+                        for (float glowSize : { 0.5f, 1.0f, 1.7f })
+                        {
+                            SoftwareBloomSettings settings;
+                            SoftwareBloom         bloom;
+                            SoftwareSurface       expectedBloom;
+                            SoftwareSurface       expected;
+                            SoftwareSurface       actual;
+
+                            settings.algorithm         = BloomAlgorithm::DualFilter;
+                            settings.resolutionDivisor = divisor;
+                            settings.blurPasses        = passes;
+                            settings.glowSize          = glowSize;
+
+                            ReferenceBloom (scene, expectedBloom, expected, settings);
+                            bloom.Apply (pool, scene, actual, settings);
+
+                            // Every level is rounded to RGBA8, so a one-step
+                            // difference can carry through the chain
+                            int worstBloom = MaxChannelDifference (expectedBloom, bloom.GetBloomSurface());
+
+                            Assert::IsTrue (worstBloom <= 2, std::format (L"divisor {}, {} passes, glow size {}: bloom buffer max channel difference {}",
+                                                                          static_cast<int> (divisor),
+                                                                          passes,
+                                                                          glowSize,
+                                                                          worstBloom).c_str());
+                        }
+                    }
+                }
+            }
+
+
+
+
+            TEST_METHOD (DualFilter_EveryThreadCount_BitIdentical)
+            {
+                SoftwareSurface       scene;
+                SoftwareBloomSettings settings;
+                SoftwareBloom         serialBloom;
+                SoftwareSurface       expected;
+                WorkerPool            serialPool (1);
+
+                BuildTestScene (scene, 200, 120);
+                settings.algorithm = BloomAlgorithm::DualFilter;
+                serialBloom.Apply (serialPool, scene, expected, settings);
+
+                for (UINT threads = 2; threads <= 6; threads++)
+                {
+                    WorkerPool      pool (threads);
+                    SoftwareBloom   bloom;
+                    SoftwareSurface actual;
+
+                    bloom.Apply (pool, scene, actual, settings);
+
+                    Assert::IsTrue (std::ranges::equal (expected.Pixels(), actual.Pixels()), std::format (L"{} threads differ from serial", threads).c_str());
+                }
+            }
+
+
+
+
+            TEST_METHOD (DualFilter_FetchCountStaysFlatAsPassesGrow)
+            {
+                // 1080p at half resolution
+                constexpr UINT     kWidth  = 960;
+                constexpr UINT     kHeight = 540;
+                constexpr uint64_t kPixels = uint64_t (kWidth) * kHeight;
+
+                for (int passes = 1; passes <= 4; passes++)
+                {
+                    SoftwareBloomSettings settings;
+
+                    settings.blurPasses = passes;
+                    settings.algorithm  = BloomAlgorithm::DualFilter;
+
+                    // 8 taps for the final upsample plus at most 13/3 per
+                    // bloom pixel for the whole chain below it (each level
+                    // a quarter of the one above)
+                    uint64_t dual = SoftwareBloom::CountBlurFetches (kWidth, kHeight, settings);
+
+                    Assert::IsTrue (dual < 13 * kPixels, std::format (L"{} passes: {} dual filter fetches", passes, dual).c_str());
+                }
+
+                // The Gaussian chain grows with taps and passes; from the
+                // Medium preset up it costs more than the dual filter
+                for (QualityPreset preset : { QualityPreset::Low, QualityPreset::Medium, QualityPreset::High })
+                {
+                    AdvancedGraphicsValues values = LookupPresetValues (preset);
+                    SoftwareBloomSettings  settings;
+
+                    settings.blurPasses = values.m_blurPasses;
+                    settings.blurTaps   = values.m_blurTaps;
+
+                    uint64_t gaussian = SoftwareBloom::CountBlurFetches (kWidth, kHeight, settings);
+
+                    settings.algorithm = BloomAlgorithm::DualFilter;
+
+                    uint64_t dual = SoftwareBloom::CountBlurFetches (kWidth, kHeight, settings);
+
+                    Assert::AreEqual (kPixels * static_cast<int> (values.m_blurTaps) * 2 * values.m_blurPasses, gaussian);
+
+                    if (preset != QualityPreset::Low)
+                    {
+                        Assert::IsTrue (dual < gaussian, std::format (L"Preset {}: dual filter {} fetches, Gaussian {}", static_cast<int> (preset), dual, gaussian).c_str());
+                    }
+                }
+            }
+
+
+
+
+            TEST_METHOD (ComputeGlowReach_BoundsTheGlowOfALitBlock)
+            {
+                constexpr UINT kSize  = 1024;
+                constexpr int  kLeft  = 509;
+                constexpr int  kRight = 515;
+
+                SoftwareSurface scene;
+                WorkerPool      pool (1);
+
+
+
+                scene.Resize (kSize, kSize);
+                scene.Clear  (SoftwareSurface::s_kOpaqueBlack);
+
+                for (int y = kLeft; y < kRight; y++)
+                {
+                    for (int x = kLeft; x < kRight; x++)
+                    {
+                        scene.Row (y)[x] = 0xFFFFFFFFu;
+                    }
+                }
+
+                for (BloomAlgorithm algorithm : { BloomAlgorithm::Gaussian, BloomAlgorithm::DualFilter })
+                {
+                    for (GlowKernel kernel : { GlowKernel::Gaussian, GlowKernel::IteratedBox })
+                    {
+                        for (ResolutionDivisor divisor : { ResolutionDivisor::Full, ResolutionDivisor::Half, ResolutionDivisor::Quarter })
+                        {
+                            for (float glowSize : { 0.5f, 1.0f, 2.0f })
+                            {
+                                for (int passes : { 1, 3 })
+                                {
+                                    SoftwareBloomSettings settings;
+                                    SoftwareBloom         bloom;
+                                    SoftwareSurface       output;
+                                    int                   spread = 0;
+
+                                    settings.algorithm         = algorithm;
+                                    settings.glowKernel        = kernel;
+                                    settings.resolutionDivisor = divisor;
+                                    settings.glowSize          = glowSize;
+                                    settings.blurPasses        = passes;
+
+                                    int reach = SoftwareBloom::ComputeGlowReach (settings);
+
+                                    bloom.Apply (pool, scene, output, settings);
+
+                                    for (int y = 0; y < static_cast<int> (kSize); y++)
+                                    {
+                                        for (int x = 0; x < static_cast<int> (kSize); x++)
+                                        {
+                                            if ((output.GetPixel (x, y) & 0x00FFFFFFu) != 0)
+                                            {
+                                                int dx = std::max ({ kLeft - x, x - (kRight - 1), 0 });
+                                                int dy = std::max ({ kLeft - y, y - (kRight - 1), 0 });
+
+                                                spread = std::max ({ spread, dx, dy });
+                                            }
+                                        }
+                                    }
+
+                                    Assert::IsTrue (reach < kLeft);
+                                    Assert::IsTrue (spread <= reach, std::format (L"algorithm {}, kernel {}, divisor {}, size {}, passes {}: glow spreads {} px, reach {}",
+                                                                                  static_cast<int> (algorithm),
+                                                                                  static_cast<int> (kernel),
+                                                                                  static_cast<int> (divisor),
+                                                                                  glowSize,
+                                                                                  passes,
+                                                                                  spread,
+                                                                                  reach).c_str());
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+
+
+
+
+            TEST_METHOD (Composite_FusedScanlines_MatchesSeparatePass)
+            {
+                SoftwareSurface          scene;
+                SoftwareSurface          plain;
+                SoftwareSurface          fused;
+                SoftwareBloomSettings    settings;
+                SoftwareBloom            bloom;
+                ScanlineAttenuationTable table;
+                WorkerPool               pool (1);
+
+                BuildTestScene (scene, 160, 96);
+                table.Update (scene.GetHeight(), ScanlineLineCount (75), 0.5f);
+
+                bloom.Apply (pool, scene, plain, settings);
+
+                settings.scanlineRows = table.GetRows();
+                bloom.Apply (pool, scene, fused, settings);
+
+                // The separate pass darkens the RGBA8 composite; fused skips
+                // that rounding, so the two may differ by one step
+                for (UINT y = 0; y < scene.GetHeight(); y++)
+                {
+                    for (UINT x = 0; x < scene.GetWidth(); x++)
+                    {
+                        for (int channel = 0; channel < 3; channel++)
+                        {
+                            float separate = ((plain.GetPixel (x, y) >> (channel * 8)) & 0xFF) * table.GetRows()[y];
+                            int   actual   = (fused.GetPixel (x, y) >> (channel * 8)) & 0xFF;
+
+                            Assert::IsTrue (std::abs (actual - std::lround (separate)) <= 1, std::format (L"({}, {}) channel {}: {} vs {:.2f}", x, y, channel, actual, separate).c_str());
+                        }
+
+                        Assert::AreEqual (0xFFu, fused.GetPixel (x, y) >> 24);
+                    }
+                }
+            }
+
+
+
+
+            TEST_METHOD (CountPassTraffic_FusedScanlinesSaveAFrameRoundTrip)
+            {
+                constexpr UINT kWidth  = 1920;
+                constexpr UINT kHeight = 1080;
+
+                std::vector<float>    rows (kHeight, 1.0f);
+                SoftwareBloomSettings settings;
+                uint64_t              frameBytes = uint64_t (kWidth) * kHeight * 4;
+
+                settings.scanlineRows = rows;
+
+                auto total = [] (const std::vector<PassTraffic> & passes)
+                {
+                    uint64_t bytes = 0;
+
+                    for (const PassTraffic & pass : passes)
+                    {
+                        bytes += pass.bytesRead + pass.bytesWritten;
+                    }
+
+                    return bytes;
+                };
+
+                std::vector<PassTraffic> fused    = SoftwareBloom::CountPassTraffic (kWidth, kHeight, settings, false);
+                std::vector<PassTraffic> separate = SoftwareBloom::CountPassTraffic (kWidth, kHeight, settings, true);
+
+                Assert::AreEqual (fused.size() + 1, separate.size());
+                Assert::AreEqual (std::string ("Scanlines"), std::string (separate.back().name));
+
+                // One full-frame write + read saved, one row-table read added
+                Assert::AreEqual (total (separate) - 2 * frameBytes + kHeight * sizeof (float), total (fused));
+            }
+
+
+
+
+            TEST_METHOD (Apply_EveryThreadCount_BitIdentical)
+            {
+                SoftwareSurface       scene;
+                SoftwareBloomSettings settings;
+                SoftwareBloom         serialBloom;
+                SoftwareSurface       expected;
+                WorkerPool            serialPool (1);
+
+                BuildTestScene (scene, 200, 120);
+                serialBloom.Apply (serialPool, scene, expected, settings);
+
+                for (UINT threads = 2; threads <= 6; threads++)
+                {
+                    WorkerPool      pool (threads);
+                    SoftwareBloom   bloom;
+                    SoftwareSurface actual;
+
+                    bloom.Apply (pool, scene, actual, settings);
+
+                    Assert::IsTrue (std::ranges::equal (expected.Pixels(), actual.Pixels()), std::format (L"{} threads differ from serial", threads).c_str());
+                }
+            }
+
+
+
+
+            TEST_METHOD (Apply_BlackScene_StaysBlackWithOpaqueAlpha)
+            {
+                SoftwareSurface       scene;
+                SoftwareSurface       output;
+                SoftwareBloom         bloom;
+                SoftwareBloomSettings settings;
+                WorkerPool            pool (2);
+
+                scene.Resize (64, 48);
+                scene.Clear  (0x00000000);
+
+                bloom.Apply (pool, scene, output, settings);
+
+                for (uint32_t pixel : output.Pixels())
+                {
+                    Assert::AreEqual (SoftwareSurface::s_kOpaqueBlack, pixel);
+                }
+            }
+
+
+
+
+            TEST_METHOD (Apply_WiderGlowSpreadsFurther)
+            {
+                SoftwareSurface       scene;
+                SoftwareSurface       narrow;
+                SoftwareSurface       wide;
+                SoftwareBloom         bloom;
+                SoftwareBloomSettings settings;
+                WorkerPool            pool (1);
+
+                // One bright dot in the middle of a 128x128 scene
+                scene.Resize (128, 128);
+                scene.Clear  (SoftwareSurface::s_kOpaqueBlack);
+
+                for (UINT y = 62; y < 66; y++)
+                {
+                    for (UINT x = 62; x < 66; x++)
+                    {
+                        scene.Row (y)[x] = 0xFFFFFFFF;
+                    }
+                }
+
+                settings.glowSize = 0.5f;
+                bloom.Apply (pool, scene, narrow, settings);
+
+                settings.glowSize = 2.0f;
+                bloom.Apply (pool, scene, wide, settings);
+
+                Assert::IsTrue (((wide.GetPixel (64, 90) >> 8) & 0xFF) > ((narrow.GetPixel (64, 90) >> 8) & 0xFF));
+            }
+
+
+
+
+            TEST_METHOD (IteratedBox_TracksGaussianGlow)
+            {
+                // Three matched-variance boxes are a close approximation of
+                // a Gaussian: the glow should differ by a few percent of its
+                // energy, and by a handful of LSBs at worst.  Only sizes up
+                // to 100% are compared texel by texel; wider sizes space the
+                // GPU taps more than a texel apart, which combs the Gaussian
+                // (see IteratedBox_MatchesGaussianSpread).
+                SoftwareSurface scene;
+                WorkerPool      pool (2);
+
+                BuildTestScene (scene, 320, 200);
+
+                for (int passes : { 1, 3, 4 })
+                {
+                    for (float glowSize : { 0.5f, 1.0f })
+                    {
+                        SoftwareBloomSettings settings;
+                        SoftwareBloom         gaussian;
+                        SoftwareBloom         box;
+                        SoftwareSurface       output;
+
+                        settings.blurPasses = passes;
+                        settings.glowSize   = glowSize;
+                        gaussian.Apply (pool, scene, output, settings);
+
+                        settings.glowKernel = GlowKernel::IteratedBox;
+                        box.Apply (pool, scene, output, settings);
+
+                        double relativeRms = RelativeRmsError (gaussian.GetBloomSurface(), box.GetBloomSurface());
+                        int    worst       = MaxChannelDifference (gaussian.GetBloomSurface(), box.GetBloomSurface());
+
+                        Logger::WriteMessage (std::format ("IteratedBox vs Gaussian: {} passes, glow size {:.1f}: relative RMS {:.4f}, max {} LSB\n",
+                                                           passes,
+                                                           glowSize,
+                                                           relativeRms,
+                                                           worst).c_str());
+
+                        Assert::IsTrue (relativeRms < 0.1, std::format (L"{} passes, glow size {}: relative RMS {}", passes, glowSize, relativeRms).c_str());
+                        Assert::IsTrue (worst <= 8,        std::format (L"{} passes, glow size {}: max difference {}", passes, glowSize, worst).c_str());
+                    }
+                }
+            }
+
+
+
+
+            TEST_METHOD (IteratedBox_MatchesGaussianSpread)
+            {
+                // A bright square's glow profile through the middle row: the
+                // box chain must spread it as far (second moment) and keep
+                // its energy, at every glow size including the wide ones.
+                // Energy gets the looser bound: the Gaussian chain rounds to
+                // RGBA8 between passes and loses some of a wide, dim tail that
+                // the box chain keeps in float.
+                SoftwareSurface scene;
+                WorkerPool      pool (1);
+
+                scene.Resize (256, 256);
+                scene.Clear  (SoftwareSurface::s_kOpaqueBlack);
+
+                for (UINT y = 124; y < 132; y++)
+                {
+                    for (UINT x = 124; x < 132; x++)
+                    {
+                        scene.Row (y)[x] = 0xFFFFFFFF;
+                    }
+                }
+
+                auto measureProfile = [] (const SoftwareSurface & bloom, double & energy, double & variance)
+                {
+                    double center = (bloom.GetWidth() - 1) / 2.0;
+                    double moment = 0.0;
+
+                    energy = 0.0;
+
+                    for (UINT x = 0; x < bloom.GetWidth(); x++)
+                    {
+                        double green = static_cast<double> ((bloom.GetPixel (x, bloom.GetHeight() / 2) >> 8) & 0xFF);
+
+                        energy += green;
+                        moment += green * (x - center) * (x - center);
+                    }
+
+                    variance = moment / energy;
+                };
+
+                for (int passes : { 1, 3 })
+                {
+                    for (float glowSize : { 0.5f, 1.0f, 2.0f, 3.0f })
+                    {
+                        SoftwareBloomSettings settings;
+                        SoftwareBloom         gaussian;
+                        SoftwareBloom         box;
+                        SoftwareSurface       output;
+                        double                gaussianEnergy   = 0.0;
+                        double                gaussianVariance = 0.0;
+                        double                boxEnergy        = 0.0;
+                        double                boxVariance      = 0.0;
+
+                        settings.blurPasses = passes;
+                        settings.glowSize   = glowSize;
+                        gaussian.Apply (pool, scene, output, settings);
+
+                        settings.glowKernel = GlowKernel::IteratedBox;
+                        box.Apply (pool, scene, output, settings);
+
+                        measureProfile (gaussian.GetBloomSurface(), gaussianEnergy, gaussianVariance);
+                        measureProfile (box.GetBloomSurface(),      boxEnergy,      boxVariance);
+
+                        Logger::WriteMessage (std::format ("Glow spread, {} passes, glow size {:.1f}: Gaussian variance {:.2f} energy {:.0f}, box variance {:.2f} energy {:.0f}\n",
+                                                           passes,
+                                                           glowSize,
+                                                           gaussianVariance,
+                                                           gaussianEnergy,
+                                                           boxVariance,
+                                                           boxEnergy).c_str());
+
+                        Assert::AreEqual (gaussianVariance, boxVariance, gaussianVariance * 0.15, std::format (L"{} passes, glow size {}: variance", passes, glowSize).c_str());
+                        Assert::AreEqual (gaussianEnergy,   boxEnergy,   gaussianEnergy   * 0.2,  std::format (L"{} passes, glow size {}: energy",   passes, glowSize).c_str());
+                    }
+                }
+            }
+
+
+
+
+            TEST_METHOD (IteratedBox_EveryThreadCount_BitIdentical)
+            {
+                SoftwareSurface       scene;
+                SoftwareBloomSettings settings;
+                SoftwareBloom         serialBloom;
+                SoftwareSurface       expected;
+                WorkerPool            serialPool (1);
+
+                // Wider than two column strips, with a partial last strip
+                BuildTestScene (scene, 300, 120);
+                settings.glowKernel = GlowKernel::IteratedBox;
+                serialBloom.Apply (serialPool, scene, expected, settings);
+
+                for (UINT threads = 2; threads <= 6; threads++)
+                {
+                    WorkerPool      pool (threads);
+                    SoftwareBloom   bloom;
+                    SoftwareSurface actual;
+
+                    bloom.Apply (pool, scene, actual, settings);
+
+                    Assert::IsTrue (std::ranges::equal (expected.Pixels(), actual.Pixels()), std::format (L"{} threads differ from serial", threads).c_str());
+                }
+            }
+
+
+
+
+            TEST_METHOD (Benchmark_GlowKernelAcrossGlowSizes)
+            {
+                // Blur stage only, 4K scene, four passes at the High preset's
+                // 13 taps: the Gaussian chain grows with the glow size, the
+                // iterated box should not.
+                constexpr int kRepeats = 3;
+
+                SoftwareSurface scene;
+                SoftwareSurface output;
+                WorkerPool      pool (std::max (1u, std::thread::hardware_concurrency()));
+
+                BuildTestScene (scene, 3840, 2160);
+
+                for (int sizePercent : { 50, 100, 150, 200 })
+                {
+                    double blurMs[2] = {};
+
+                    for (GlowKernel kernel : { GlowKernel::Gaussian, GlowKernel::IteratedBox })
+                    {
+                        SoftwareBloom         bloom;
+                        SoftwareBloomSettings settings;
+
+                        settings.glowSize   = sizePercent / 100.0f;
+                        settings.blurPasses = 4;
+                        settings.glowKernel = kernel;
+
+                        for (int i = 0; i < kRepeats; i++)
+                        {
+                            bloom.Apply (pool, scene, output, settings);
+                            blurMs[static_cast<int> (kernel)] += bloom.GetLastTimings().blurMs / kRepeats;
+                        }
+                    }
+
+                    Logger::WriteMessage (std::format ("SoftwareBloom 4K blur at glow size {}%: Gaussian {:.2f} ms, iterated box {:.2f} ms ({:.2f}x)\n",
+                                                       sizePercent,
+                                                       blurMs[0],
+                                                       blurMs[1],
+                                                       blurMs[0] / blurMs[1]).c_str());
+                }
+            }
+
+
+
+
+            TEST_METHOD (Benchmark_BloomAlgorithmFetchesAndTimings)
+            {
+                // GPU-equivalent bilinear fetches and CPU blur time for the
+                // Gaussian and dual-filter blurs at each quality preset's
+                // pass count and taps, on a 100% density rain frame.  The
+                // fetch counts are what the GPU passes would issue; no GPU
+                // is needed to compare them.
+                constexpr int  kRepeats = 3;
+                constexpr UINT kWidth   = 1920;
+                constexpr UINT kHeight  = 1080;
+
+                Viewport             viewport;
+                viewport.Resize (static_cast<float> (kWidth), static_cast<float> (kHeight));
+                DensityController    densityController (viewport, 24.0f);
+                AnimationSystem      animationSystem;
+                SoftwareRenderSystem renderSystem (kWidth, kHeight);
+                RenderParams         params;
+                SoftwareSurface      output;
+                WorkerPool           pool (std::max (1u, std::thread::hardware_concurrency()));
+
+                densityController.SetPercentage (100);
+                animationSystem.Initialize (viewport, densityController);
+                renderSystem.BuildGlyphAtlas();
+
+                for (int frame = 0; frame < 180; frame++)
+                {
+                    animationSystem.Update (1.0f / 60.0f);
+                }
+
+                params.glowEnabled = false;
+                renderSystem.Render (animationSystem, viewport, params);
+
+                for (QualityPreset preset : { QualityPreset::Low, QualityPreset::Medium, QualityPreset::High })
+                {
+                    AdvancedGraphicsValues values = LookupPresetValues (preset);
+
+                    for (BloomAlgorithm algorithm : { BloomAlgorithm::Gaussian, BloomAlgorithm::DualFilter })
+                    {
+                        SoftwareBloom         bloom;
+                        SoftwareBloomSettings settings;
+                        double                blurMs = 0.0;
+
+                        settings.blurPasses        = values.m_blurPasses;
+                        settings.blurTaps          = values.m_blurTaps;
+                        settings.resolutionDivisor = values.m_bloomResolutionDivisor;
+                        settings.algorithm         = algorithm;
+
+                        for (int i = 0; i < kRepeats; i++)
+                        {
+                            bloom.Apply (pool, renderSystem.GetSceneSurface(), output, settings);
+                            blurMs += bloom.GetLastTimings().blurMs / kRepeats;
+                        }
+
+                        Logger::WriteMessage (std::format ("SoftwareBloom 1080p preset {} {}: {:.2f} M blur fetches/frame, blur {:.2f} ms\n",
+                                                           static_cast<int> (preset),
+                                                           algorithm == BloomAlgorithm::DualFilter ? "dual filter" : "Gaussian   ",
+                                                           CountFetchesInMillions (bloom.GetBloomSurface(), settings),
+                                                           blurMs).c_str());
+                    }
+                }
+            }
+
+
+
+
+            TEST_METHOD (Benchmark_PostProcessBandwidth)
+            {
+                // Per-pass memory traffic of the GPU post-process chain with
+                // scanlines on, fused into the composite vs. the separate
+                // scanline pass through m_postBloomTexture, plus the CPU
+                // cost of the same two shapes.
+                constexpr int kRepeats = 3;
+
+                struct Target
+                {
+                    const char * name;
+                    UINT         width;
+                    UINT         height;
+                };
+
+                const Target targets[] =
+                {
+                    { "1080p", 1920, 1080 },
+                    { "4K",    3840, 2160 },
+                };
+
+                for (const Target & target : targets)
+                {
+                    SoftwareSurface          scene;
+                    SoftwareSurface          output;
+                    SoftwareSurface          darkened;
+                    SoftwareBloom            bloom;
+                    SoftwareBloomSettings    settings;
+                    ScanlineAttenuationTable table;
+                    WorkerPool               pool (std::max (1u, std::thread::hardware_concurrency()));
+                    double                   fusedMs    = 0.0;
+                    double                   separateMs = 0.0;
+
+                    BuildTestScene (scene, target.width, target.height);
+                    darkened.Resize (target.width, target.height);
+                    table.Update (target.height, ScanlineLineCount (50), 0.3f);
+                    settings.scanlineRows = table.GetRows();
+
+                    for (bool separatePass : { false, true })
+                    {
+                        uint64_t totalBytes = 0;
+
+                        for (const PassTraffic & pass : SoftwareBloom::CountPassTraffic (target.width, target.height, settings, separatePass))
+                        {
+                            Logger::WriteMessage (std::format ("PostProcess {} {}: {:<9} read {:7.2f} MB, write {:7.2f} MB\n",
+                                                               target.name,
+                                                               separatePass ? "separate" : "fused   ",
+                                                               pass.name,
+                                                               pass.bytesRead    / 1'000'000.0,
+                                                               pass.bytesWritten / 1'000'000.0).c_str());
+
+                            totalBytes += pass.bytesRead + pass.bytesWritten;
+                        }
+
+                        Logger::WriteMessage (std::format ("PostProcess {} {}: total {:.2f} MB/frame\n",
+                                                           target.name,
+                                                           separatePass ? "separate" : "fused   ",
+                                                           totalBytes / 1'000'000.0).c_str());
+                    }
+
+                    for (int i = 0; i < kRepeats; i++)
+                    {
+                        bloom.Apply (pool, scene, output, settings);
+                        fusedMs += bloom.GetLastTimings().compositeMs / kRepeats;
+
+                        SoftwareBloomSettings plainSettings = settings;
+
+                        plainSettings.scanlineRows = {};
+                        bloom.Apply (pool, scene, output, plainSettings);
+
+                        auto start = std::chrono::steady_clock::now();
+
+                        pool.ParallelFor (target.height, [&] (UINT y, UINT)
+                        {
+                            const uint32_t * in     = output.Row (y);
+                            uint32_t       * out    = darkened.Row (y);
+                            float            darken = table.GetRows()[y];
+
+                            for (UINT x = 0; x < target.width; x++)
+                            {
+                                out[x] = SimdPackRgba8 (SimdMul (SimdUnpackRgba8 (in[x]), SimdSet (darken, darken, darken, 1.0f)));
+                            }
+                        });
+
+                        separateMs += (bloom.GetLastTimings().compositeMs +
+                                       std::chrono::duration<double, std::milli> (std::chrono::steady_clock::now() - start).count()) / kRepeats;
+                    }
+
+                    Logger::WriteMessage (std::format ("PostProcess {} CPU: fused composite {:.2f} ms, composite + scanline pass {:.2f} ms\n",
+                                                       target.name,
+                                                       fusedMs,
+                                                       separateMs).c_str());
+                }
+            }
+
+
+
+
+            TEST_METHOD (Benchmark_StageTimings)
+            {
+                // Bloom over a warmed-up 100% density rain frame at the
+                // default (High preset) settings, serial and on every
+                // hardware thread, reported per stage.
+                struct Target
+                {
+                    const char * name;
+                    UINT         width;
+                    UINT         height;
+                };
+
+                const Target targets[] =
+                {
+                    { "1080p", 1920, 1080 },
+                    { "4K",    3840, 2160 },
+                };
+
+                for (const Target & target : targets)
+                {
+                    Viewport             viewport;
+                    viewport.Resize (static_cast<float> (target.width), static_cast<float> (target.height));
+                    DensityController    densityController (viewport, 24.0f);
+                    AnimationSystem      animationSystem;
+                    SoftwareRenderSystem renderSystem (target.width, target.height);
+                    RenderParams         params;
+                    SoftwareSurface      output;
+
+                    densityController.SetPercentage (100);
+                    animationSystem.Initialize (viewport, densityController);
+                    renderSystem.BuildGlyphAtlas();
+
+                    for (int frame = 0; frame < 180; frame++)
+                    {
+                        animationSystem.Update (1.0f / 60.0f);
+                    }
+
+                    params.glowEnabled = false;
+                    renderSystem.Render (animationSystem, viewport, params);
+
+                    for (UINT threads : { 1u, std::max (2u, std::thread::hardware_concurrency()) })
+                    {
+                        constexpr int         kRepeats = 3;
+                        WorkerPool            pool (threads);
+                        SoftwareBloom         bloom;
+                        SoftwareBloomSettings settings;
+                        BloomStageTimings     total;
+
+                        for (int i = 0; i < kRepeats; i++)
+                        {
+                            bloom.Apply (pool, renderSystem.GetSceneSurface(), output, settings);
+
+                            total.extractMs   += bloom.GetLastTimings().extractMs;
+                            total.blurMs      += bloom.GetLastTimings().blurMs;
+                            total.compositeMs += bloom.GetLastTimings().compositeMs;
+                        }
+
+                        Logger::WriteMessage (std::format ("SoftwareBloom {} ({} threads): extract {:.2f} ms, blur {:.2f} ms, composite {:.2f} ms, total {:.2f} ms\n",
+                                                           target.name,
+                                                           threads,
+                                                           total.extractMs   / kRepeats,
+                                                           total.blurMs      / kRepeats,
+                                                           total.compositeMs / kRepeats,
+                                                           (total.extractMs + total.blurMs + total.compositeMs) / kRepeats).c_str());
+                    }
+                }
+            }
+    };
+}
@@ -0,0 +1,509 @@
+#include "Pch_MatrixRainTests.h"
+
+#include "..\..\MatrixRainCore\SoftwareRenderSystem.h"
+#include "..\..\MatrixRainCore\AnimationSystem.h"
+#include "..\..\MatrixRainCore\CharacterSet.h"
+#include "..\..\MatrixRainCore\ScanlineAttenuation.h"
+#include "..\..\MatrixRainCore\Viewport.h"
+
+
+
+
+namespace MatrixRainTests
+{
+
+
+    // Closed-form evaluation of the rain pixel shader followed by the
+    // SrcAlpha/InvSrcAlpha blend into an R8G8B8A8_UNORM target.
+    static uint32_t ExpectedAlphaBlend (const float color[4], float brightness, float coverage, uint32_t dst)
+    {
+        float    src[4];
+        uint32_t result = 0;
+
+        for (int i = 0; i < 4; i++)
+        {
+            src[i] = color[i] * coverage * brightness;
+
+            if (i < 3)
+            {
+                src[i] += src[i] * 0.3f * brightness;
+            }
+
+            src[i] = std::clamp (src[i], 0.0f, 1.0f);
+        }
+
+        for (int i = 0; i < 4; i++)
+        {
+            float d   = static_cast<float> ((dst >> (i * 8)) & 0xFF) / 255.0f;
+            float out = (i < 3) ? src[i] * src[3] + d * (1.0f - src[3]) : src[3];
+
+            result |= static_cast<uint32_t> (std::clamp (out, 0.0f, 1.0f) * 255.0f + 0.5f) << (i * 8);
+        }
+
+        return result;
+    }
+
+
+
+
+    static void AssertPixelNear (uint32_t expected, uint32_t actual, int tolerance = 1)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            int e = static_cast<int> ((expected >> (i * 8)) & 0xFF);
+            int a = static_cast<int> ((actual   >> (i * 8)) & 0xFF);
+
+            Assert::IsTrue (abs (e - a) <= tolerance, std::format (L"Channel {} expected {} got {}", i, e, a).c_str());
+        }
+    }
+
+
+
+
+    static SoftwareGlyphAtlas MakeSolidAtlas (UINT size, uint8_t coverage)
+    {
+        SoftwareGlyphAtlas   atlas;
+        std::vector<uint8_t> texels (size_t (size) * size, coverage);
+
+        atlas.LoadCoverage (size, size, texels);
+        return atlas;
+    }
+
+
+
+
+    static GlyphQuad MakeQuad (float x0, float y0, float x1, float y1, float r, float g, float b, float a, float brightness)
+    {
+        return { x0, y0, x1, y1, 0.0f, 0.0f, 1.0f, 1.0f, { r, g, b, a }, brightness };
+    }
+
+
+
+
+    TEST_CLASS (SoftwareRenderSystemTests)
+    {
+        public:
+
+            TEST_CLASS_INITIALIZE (ClassSetup)
+            {
+                CharacterSet::GetInstance().Initialize();
+            }
+
+
+
+
+            TEST_METHOD (Rasterizer_AlphaBlend_MatchesPixelShader)
+            {
+                SoftwareGlyphAtlas atlas = MakeSolidAtlas (4, 255);
+                SoftwareSurface    surface;
+                float              color[4] = { 0.0f, 1.0f, 0.0f, 1.0f };
+
+                surface.Resize (4, 4);
+
+                for (float brightness : { 0.1f, 0.5f, 0.8f, 1.0f })
+                {
+                    surface.Clear (SoftwareSurface::s_kOpaqueBlack);
+                    RasterizeGlyphQuadReference (surface, atlas, MakeQuad (0, 0, 4, 4, 0.0f, 1.0f, 0.0f, 1.0f, brightness), GlyphBlendMode::Alpha);
+
+                    AssertPixelNear (ExpectedAlphaBlend (color, brightness, 1.0f, SoftwareSurface::s_kOpaqueBlack), surface.GetPixel (2, 2));
+                }
+            }
+
+
+
+
+            TEST_METHOD (Rasterizer_PartialCoverage_ScalesSourceBeforeBlend)
+            {
+                SoftwareGlyphAtlas atlas = MakeSolidAtlas (4, 128);
+                SoftwareSurface    surface;
+                float              color[4] = { 0.2f, 0.6f, 1.0f, 0.9f };
+                uint32_t           dst      = 0xFF204060;
+
+                surface.Resize (4, 4);
+                surface.Clear (dst);
+
+                RasterizeGlyphQuadReference (surface, atlas, MakeQuad (0, 0, 4, 4, 0.2f, 0.6f, 1.0f, 0.9f, 0.7f), GlyphBlendMode::Alpha);
+
+                AssertPixelNear (ExpectedAlphaBlend (color, 0.7f, 128.0f / 255.0f, dst), surface.GetPixel (1, 1));
+            }
+
+
+
+
+            TEST_METHOD (Rasterizer_Overbright_SaturatesLikeUnormTarget)
+            {
+                SoftwareGlyphAtlas atlas = MakeSolidAtlas (4, 255);
+                SoftwareSurface    surface;
+
+                surface.Resize (4, 4);
+
+                // White lead at full brightness: rgb = 1.3 before the UNORM clamp
+                RasterizeGlyphQuadReference (surface, atlas, MakeQuad (0, 0, 4, 4, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f), GlyphBlendMode::Alpha);
+
+                Assert::AreEqual (0xFFFFFFFFu, surface.GetPixel (0, 0));
+            }
+
+
+
+
+            TEST_METHOD (Rasterizer_TopLeftRule_CoversPixelCentersInHalfOpenRange)
+            {
+                SoftwareGlyphAtlas atlas = MakeSolidAtlas (4, 255);
+                SoftwareSurface    surface;
+
+                surface.Resize (6, 6);
+
+                // Centers 1.5 and 2.5 are inside [1.5, 3.5); 3.5 is not
+                RasterizeGlyphQuadReference (surface, atlas, MakeQuad (1.5f, 1.5f, 3.5f, 3.5f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f), GlyphBlendMode::Alpha);
+
+                Assert::AreEqual (SoftwareSurface::s_kOpaqueBlack, surface.GetPixel (0, 1));
+                Assert::AreEqual (0xFFFFFFFFu,                     surface.GetPixel (1, 1));
+                Assert::AreEqual (0xFFFFFFFFu,                     surface.GetPixel (2, 2));
+                Assert::AreEqual (SoftwareSurface::s_kOpaqueBlack, surface.GetPixel (3, 2));
+                Assert::AreEqual (SoftwareSurface::s_kOpaqueBlack, surface.GetPixel (2, 3));
+            }
+
+
+
+
+            TEST_METHOD (Rasterizer_ZeroCoverage_LeavesTargetUntouched)
+            {
+                SoftwareGlyphAtlas atlas = MakeSolidAtlas (4, 0);
+                SoftwareSurface    surface;
+
+                surface.Resize (4, 4);
+                surface.Clear (0x80112233);
+
+                RasterizeGlyphQuadReference (surface, atlas, MakeQuad (0, 0, 4, 4, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f), GlyphBlendMode::Alpha);
+
+                Assert::AreEqual (0x80112233u, surface.GetPixel (2, 2));
+            }
+
+
+
+
+            TEST_METHOD (Rasterizer_OffscreenQuad_IsClipped)
+            {
+                SoftwareGlyphAtlas atlas = MakeSolidAtlas (4, 255);
+                SoftwareSurface    surface;
+
+                surface.Resize (4, 4);
+
+                RasterizeGlyphQuadReference (surface, atlas, MakeQuad (-2, -2, 1, 1, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f), GlyphBlendMode::Alpha);
+                RasterizeGlyphQuadReference (surface, atlas, MakeQuad (10, 10, 20, 20, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f), GlyphBlendMode::Alpha);
+
+                Assert::AreEqual (0xFFFFFFFFu,                     surface.GetPixel (0, 0));
+                Assert::AreEqual (SoftwareSurface::s_kOpaqueBlack, surface.GetPixel (1, 1));
+            }
+
+
+
+
+            TEST_METHOD (Rasterizer_AdditiveAndPremultiplied_FollowBlendEquations)
+            {
+                SoftwareGlyphAtlas atlas = MakeSolidAtlas (4, 255);
+                SoftwareSurface    surface;
+
+                surface.Resize (4, 4);
+
+                // Additive: dst + src on every channel
+                surface.Clear (0xFF404040);
+                RasterizeGlyphQuadReference (surface, atlas, MakeQuad (0, 0, 4, 4, 0.25f, 0.25f, 0.25f, 0.0f, 1.0f), GlyphBlendMode::Additive);
+
+                // 0.25 * 1.3 = 0.325 -> 83; 0x40 = 64
+                AssertPixelNear (0xFF939393, surface.GetPixel (0, 0));
+
+                // Premultiplied: src + dst * (1 - src.a), alpha = src.a
+                surface.Clear (0xFF808080);
+                RasterizeGlyphQuadReference (surface, atlas, MakeQuad (0, 0, 4, 4, 0.0f, 0.5f, 0.0f, 0.5f, 1.0f), GlyphBlendMode::Premultiplied);
+
+                // g = 0.65 + 0.502 * 0.5 = 0.901 -> 230; r = b = 0.251 -> 64; a = 0.5 -> 128
+                AssertPixelNear (0x8040E640, surface.GetPixel (0, 0));
+            }
+
+
+
+
+            TEST_METHOD (Atlas_SampleBilinear_InterpolatesBetweenTexelCenters)
+            {
+                SoftwareGlyphAtlas   atlas;
+                std::vector<uint8_t> texels = { 0, 255, 0, 255 };
+
+                atlas.LoadCoverage (2, 2, texels);
+
+                Assert::AreEqual (0.0f, atlas.SampleBilinear (0.25f, 0.25f), 1e-6f);
+                Assert::AreEqual (1.0f, atlas.SampleBilinear (0.75f, 0.25f), 1e-6f);
+                Assert::AreEqual (0.5f, atlas.SampleBilinear (0.5f,  0.5f),  1e-6f);
+
+                // Clamp addressing beyond the edge
+                Assert::AreEqual (1.0f, atlas.SampleBilinear (1.5f,  0.25f), 1e-6f);
+            }
+
+
+
+
+            TEST_METHOD (Atlas_LoadCoverage_RejectsSizeMismatch)
+            {
+                SoftwareGlyphAtlas   atlas;
+                std::vector<uint8_t> texels (7, 0);
+
+                Assert::AreEqual (E_INVALIDARG, atlas.LoadCoverage (2, 4, texels));
+                Assert::IsFalse  (atlas.IsValid());
+            }
+
+
+
+
+            TEST_METHOD (Atlas_BuildProcedural_IsDeterministicAndSparse)
+            {
+                SoftwareGlyphAtlas first;
+                SoftwareGlyphAtlas second;
+                size_t             covered = 0;
+
+                first.BuildProcedural();
+                second.BuildProcedural();
+
+                Assert::AreEqual (SoftwareGlyphAtlas::s_kAtlasSize, first.GetWidth());
+                Assert::IsTrue   (std::ranges::equal (first.Coverage(), second.Coverage()));
+
+                for (uint8_t texel : first.Coverage())
+                {
+                    covered += (texel > 0) ? 1 : 0;
+                }
+
+                Assert::IsTrue (covered > 0);
+                Assert::IsTrue (covered < first.Coverage().size() / 2);
+            }
+
+
+
+
+            TEST_METHOD (Render_PlacesQuadAtProjectedPosition)
+            {
+                SoftwareRenderSystem renderSystem (1920, 1080);
+                AnimationSystem      animationSystem;
+                Viewport             viewport;
+                OverlayCharacter     overlay;
+                RenderParams         params;
+                std::vector<uint8_t> solid (size_t (2048) * 2048, 255);
+
+                viewport.Resize (1920.0f, 1080.0f);
+                renderSystem.SetGlyphAtlas (2048, 2048, solid);
+
+                overlay.character.glyphIndex     = 0;
+                overlay.character.color          = Color4 (1.0f, 1.0f, 1.0f, 1.0f);
+                overlay.character.brightness     = 1.0f;
+                overlay.character.positionOffset = Vector2 (0.0f, 200.0f);
+                overlay.position                 = Vector3 (100.0f, 0.0f, 50.0f);
+                animationSystem.SetOverlayCharacters ({ overlay });
+
+                renderSystem.Render (animationSystem, viewport, params);
+
+                const SoftwareSurface & scene = renderSystem.GetSceneSurface();
+
+                // 24x36 base quad at scale 1 (1080p, 96 DPI)
+                Assert::AreEqual (0xFFFFFFFFu,                     scene.GetPixel (100, 200));
+                Assert::AreEqual (0xFFFFFFFFu,                     scene.GetPixel (123, 235));
+                Assert::AreEqual (SoftwareSurface::s_kOpaqueBlack, scene.GetPixel (99,  200));
+                Assert::AreEqual (SoftwareSurface::s_kOpaqueBlack, scene.GetPixel (124, 200));
+                Assert::AreEqual (SoftwareSurface::s_kOpaqueBlack, scene.GetPixel (100, 236));
+            }
+
+
+
+
+            TEST_METHOD (Render_TrailCharacters_TakeSchemeColor)
+            {
+                SoftwareRenderSystem renderSystem (64, 64);
+                AnimationSystem      animationSystem;
+                Viewport             viewport;
+                OverlayCharacter     overlay;
+                RenderParams         params;
+                std::vector<uint8_t> solid (size_t (2048) * 2048, 255);
+
+                viewport.Resize (64.0f, 64.0f);
+                renderSystem.SetCharacterScaleOverride (1.0f);
+                renderSystem.SetGlyphAtlas (2048, 2048, solid);
+
+                overlay.character.glyphIndex = 0;
+                overlay.character.color      = Color4 (0.0f, 1.0f, 0.0f, 1.0f);
+                overlay.character.brightness = 0.5f;
+                overlay.position             = Vector3 (0.0f, 0.0f, 50.0f);
+                animationSystem.SetOverlayCharacters ({ overlay });
+
+                params.colorScheme = ColorScheme::Blue;
+                renderSystem.Render (animationSystem, viewport, params);
+
+                uint32_t pixel = renderSystem.GetSceneSurface().GetPixel (4, 4);
+
+                Assert::IsTrue (((pixel >> 16) & 0xFF) > ((pixel >> 8) & 0xFF), L"Blue scheme should tint the green trail character");
+            }
+
+
+
+
+            TEST_METHOD (Render_GlowEnabled_BloomsAroundCharacters)
+            {
+                SoftwareRenderSystem renderSystem (128, 128);
+                AnimationSystem      animationSystem;
+                Viewport             viewport;
+                OverlayCharacter     overlay;
+                RenderParams         params;
+                std::vector<uint8_t> solid (size_t (2048) * 2048, 255);
+
+                viewport.Resize (128.0f, 128.0f);
+                renderSystem.SetCharacterScaleOverride (1.0f);
+                renderSystem.SetGlyphAtlas (2048, 2048, solid);
+
+                overlay.character.glyphIndex = 0;
+                overlay.character.color      = Color4 (0.0f, 1.0f, 0.0f, 1.0f);
+                overlay.character.brightness = 1.0f;
+                overlay.position             = Vector3 (40.0f, 0.0f, 50.0f);
+                animationSystem.SetOverlayCharacters ({ overlay });
+
+                params.glowEnabled = true;
+                renderSystem.Render (animationSystem, viewport, params);
+
+                uint32_t halo = renderSystem.GetBackSurface().GetPixel (36, 10);
+
+                // Dark in the scene, lit green by the glow
+                Assert::AreEqual (SoftwareSurface::s_kOpaqueBlack, renderSystem.GetSceneSurface().GetPixel (36, 10));
+                Assert::IsTrue   (((halo >> 8) & 0xFF) > 0);
+                Assert::AreEqual (0xFFu, halo >> 24);
+            }
+
+
+
+
+            TEST_METHOD (Render_GlowDisabled_CopiesSceneWithOpaqueAlpha)
+            {
+                SoftwareRenderSystem renderSystem (128, 128);
+                AnimationSystem      animationSystem;
+                Viewport             viewport;
+                OverlayCharacter     overlay;
+                RenderParams         params;
+                std::vector<uint8_t> solid (size_t (2048) * 2048, 255);
+
+                viewport.Resize (128.0f, 128.0f);
+                renderSystem.SetCharacterScaleOverride (1.0f);
+                renderSystem.SetGlyphAtlas (2048, 2048, solid);
+
+                // Half-alpha character leaves alpha < 1 in the scene
+                overlay.character.glyphIndex = 0;
+                overlay.character.color      = Color4 (0.0f, 1.0f, 0.0f, 0.5f);
+                overlay.character.brightness = 1.0f;
+                overlay.position             = Vector3 (40.0f, 0.0f, 50.0f);
+                animationSystem.SetOverlayCharacters ({ overlay });
+
+                params.glowEnabled      = false;
+                params.scanlinesEnabled = false;
+                renderSystem.Render (animationSystem, viewport, params);
+
+                const SoftwareSurface & scene = renderSystem.GetSceneSurface();
+                const SoftwareSurface & back  = renderSystem.GetBackSurface();
+
+                Assert::IsTrue ((scene.GetPixel (45, 10) >> 24) < 0xFF);
+
+                for (size_t i = 0; i < scene.Pixels().size(); i++)
+                {
+                    Assert::AreEqual (scene.Pixels()[i] | SoftwareSurface::s_kOpaqueBlack, back.Pixels()[i]);
+                }
+            }
+
+
+
+
+            TEST_METHOD (Render_GlowDisabled_ScanlinesDarkenEachRow)
+            {
+                SoftwareRenderSystem     renderSystem (128, 128);
+                AnimationSystem          animationSystem;
+                Viewport                 viewport;
+                OverlayCharacter         overlay;
+                RenderParams             params;
+                ScanlineAttenuationTable table;
+                std::vector<uint8_t>     solid (size_t (2048) * 2048, 255);
+
+                viewport.Resize (128.0f, 128.0f);
+                renderSystem.SetCharacterScaleOverride (1.0f);
+                renderSystem.SetGlyphAtlas (2048, 2048, solid);
+
+                overlay.character.glyphIndex = 0;
+                overlay.character.color      = Color4 (0.0f, 1.0f, 0.0f, 1.0f);
+                overlay.character.brightness = 1.0f;
+                overlay.position             = Vector3 (40.0f, 0.0f, 50.0f);
+                animationSystem.SetOverlayCharacters ({ overlay });
+
+                params.glowEnabled        = false;
+                params.scanlinesEnabled   = true;
+                params.scanlinesIntensity = 0.6f;
+                params.scanlinesLineCount = 40.0f;
+                renderSystem.Render (animationSystem, viewport, params);
+
+                table.Update (128, params.scanlinesLineCount, params.scanlinesIntensity);
+
+                const SoftwareSurface & scene = renderSystem.GetSceneSurface();
+                const SoftwareSurface & back  = renderSystem.GetBackSurface();
+                bool                    lit   = false;
+
+                for (UINT y = 0; y < scene.GetHeight(); y++)
+                {
+                    for (UINT x = 0; x < scene.GetWidth(); x++)
+                    {
+                        int sceneGreen = (scene.GetPixel (x, y) >> 8) & 0xFF;
+                        int backGreen  = (back.GetPixel (x, y)  >> 8) & 0xFF;
+                        int expected   = static_cast<int> (std::lround (sceneGreen * table.GetRows()[y]));
+
+                        Assert::IsTrue (std::abs (backGreen - expected) <= 1, std::format (L"({}, {}): {} vs {}", x, y, backGreen, expected).c_str());
+                        Assert::AreEqual (0xFFu, back.GetPixel (x, y) >> 24);
+
+                        lit |= sceneGreen > 0;
+                    }
+                }
+
+                Assert::IsTrue (lit);
+            }
+
+
+
+
+            TEST_METHOD (Present_SwapsBackToFront)
+            {
+                SoftwareRenderSystem renderSystem (32, 32);
+                AnimationSystem      animationSystem;
+                Viewport             viewport;
+                OverlayCharacter     overlay;
+                RenderParams         params;
+
+                viewport.Resize (32.0f, 32.0f);
+                renderSystem.BuildGlyphAtlas();
+                renderSystem.SetCharacterScaleOverride (1.0f);
+
+                overlay.character.glyphIndex = 0;
+                overlay.character.color      = Color4 (1.0f, 1.0f, 1.0f, 1.0f);
+                overlay.character.brightness = 1.0f;
+                overlay.position             = Vector3 (0.0f, 0.0f, 50.0f);
+                animationSystem.SetOverlayCharacters ({ overlay });
+
+                renderSystem.Render (animationSystem, viewport, params);
+
+                std::vector<uint32_t> rendered (renderSystem.GetBackSurface().Pixels().begin(), renderSystem.GetBackSurface().Pixels().end());
+
+                Assert::AreEqual (S_OK, renderSystem.Present());
+                Assert::AreEqual (uint64_t (1), renderSystem.GetPresentCount());
+                Assert::IsTrue   (std::ranges::equal (rendered, renderSystem.GetPresentedSurface().Pixels()));
+            }
+
+
+
+
+            TEST_METHOD (Resize_ResizesBothSurfaces)
+            {
+                SoftwareRenderSystem renderSystem (32, 32);
+
+                renderSystem.Resize (640, 360);
+
+                Assert::AreEqual (640u, renderSystem.GetBackSurface().GetWidth());
+                Assert::AreEqual (360u, renderSystem.GetPresentedSurface().GetHeight());
+            }
+    };
+}
@@ -0,0 +1,304 @@
+#include "Pch_MatrixRainTests.h"
+
+#include "..\..\MatrixRainCore\TileRasterizer.h"
+#include "..\..\MatrixRainCore\AnimationSystem.h"
+#include "..\..\MatrixRainCore\CharacterSet.h"
+#include "..\..\MatrixRainCore\DensityController.h"
+#include "..\..\MatrixRainCore\SoftwareGlyphAtlas.h"
+#include "..\..\MatrixRainCore\SoftwareRenderSystem.h"
+#include "..\..\MatrixRainCore\SoftwareSurface.h"
+#include "..\..\MatrixRainCore\Viewport.h"
+
+
+
+
+namespace MatrixRainTests
+{
+
+
+    static GlyphQuad MakeQuad (float x0, float y0, float x1, float y1)
+    {
+        constexpr float kCellU = float (SoftwareGlyphAtlas::s_kCellWidth)  / SoftwareGlyphAtlas::s_kAtlasSize;
+        constexpr float kCellV = float (SoftwareGlyphAtlas::s_kCellHeight) / SoftwareGlyphAtlas::s_kAtlasSize;
+        GlyphQuad       quad   = {};
+
+        quad.x0         = x0;
+        quad.y0         = y0;
+        quad.x1         = x1;
+        quad.y1         = y1;
+        quad.u1         = kCellU;
+        quad.v1         = kCellV;
+        quad.color[0]   = 0.2f;
+        quad.color[1]   = 1.0f;
+        quad.color[2]   = 0.4f;
+        quad.color[3]   = 1.0f;
+        quad.brightness = 1.0f;
+
+        return quad;
+    }
+
+
+
+
+    // Heavily overlapping quads, many straddling tile edges, on a target
+    // whose size is not a multiple of the tile size
+    static std::vector<GlyphQuad> MakeOverlappingQuads (uint32_t seed, size_t count, float targetWidth, float targetHeight)
+    {
+        std::mt19937                          rng (seed);
+        std::uniform_real_distribution<float> unit (0.0f, 1.0f);
+        std::vector<GlyphQuad>                quads;
+        constexpr float                       kCellU = float (SoftwareGlyphAtlas::s_kCellWidth)  / SoftwareGlyphAtlas::s_kAtlasSize;
+        constexpr float                       kCellV = float (SoftwareGlyphAtlas::s_kCellHeight) / SoftwareGlyphAtlas::s_kAtlasSize;
+
+        for (size_t i = 0; i < count; i++)
+        {
+            float     scale = 0.5f + unit (rng) * 3.0f;
+            int       cell  = static_cast<int> (unit (rng) * 271.0f);
+            GlyphQuad quad  = MakeQuad (0.0f, 0.0f, 0.0f, 0.0f);
+
+            quad.x0         = -40.0f + unit (rng) * (targetWidth  + 40.0f);
+            quad.y0         = -60.0f + unit (rng) * (targetHeight + 60.0f);
+            quad.x1         = quad.x0 + 24.0f * scale;
+            quad.y1         = quad.y0 + 36.0f * scale;
+            quad.u0         = (cell % 16) * kCellU;
+            quad.v0         = (cell / 16) * kCellV;
+            quad.u1         = quad.u0 + kCellU;
+            quad.v1         = quad.v0 + kCellV;
+            quad.color[0]   = unit (rng);
+            quad.color[1]   = unit (rng);
+            quad.color[2]   = unit (rng);
+            quad.color[3]   = 0.3f + unit (rng) * 0.7f;
+            quad.brightness = unit (rng);
+
+            quads.push_back (quad);
+        }
+
+        return quads;
+    }
+
+
+
+
+    TEST_CLASS (TileRasterizerTests)
+    {
+        public:
+
+            TEST_CLASS_INITIALIZE (ClassSetup)
+            {
+                CharacterSet::GetInstance().Initialize();
+            }
+
+
+
+
+            TEST_METHOD (Binner_QuadLandsInEveryTileItCovers)
+            {
+                TileBinner             binner;
+                std::vector<GlyphQuad> quads;
+
+                // Straddles the corner shared by tiles (0,0), (1,0), (0,1), (1,1)
+                quads.push_back (MakeQuad (50.0f, 50.0f, 80.0f, 80.0f));
+
+                // Ends exactly on a tile edge: pixel 63 is its last column
+                quads.push_back (MakeQuad (10.0f, 10.0f, 64.0f, 20.0f));
+
+                // Entirely off screen
+                quads.push_back (MakeQuad (-50.0f, -50.0f, -10.0f, -10.0f));
+
+                binner.Bin (quads, 200, 130);
+
+                Assert::AreEqual (4u, binner.GetTilesX());
+                Assert::AreEqual (3u, binner.GetTilesY());
+                Assert::AreEqual (size_t (5), binner.GetBinnedCount());
+
+                Assert::AreEqual (size_t (2), binner.GetTileQuads (0).size());
+                Assert::AreEqual (size_t (1), binner.GetTileQuads (1).size());
+                Assert::AreEqual (size_t (1), binner.GetTileQuads (4).size());
+                Assert::AreEqual (size_t (1), binner.GetTileQuads (5).size());
+                Assert::AreEqual (0u, binner.GetTileQuads (1)[0]);
+
+                // Edge tiles are trimmed to the target
+                PixelRect corner = binner.GetTileRect (11);
+
+                Assert::AreEqual (192, corner.left);
+                Assert::AreEqual (128, corner.top);
+                Assert::AreEqual (200, corner.right);
+                Assert::AreEqual (130, corner.bottom);
+            }
+
+
+
+
+            TEST_METHOD (Binner_PreservesBackToFrontOrderWithinTiles)
+            {
+                TileBinner             binner;
+                std::vector<GlyphQuad> quads = MakeOverlappingQuads (77, 2000, 300.0f, 200.0f);
+
+                binner.Bin (quads, 300, 200);
+
+                for (UINT tile = 0; tile < binner.GetTileCount(); tile++)
+                {
+                    std::span<const uint32_t> bin = binner.GetTileQuads (tile);
+
+                    Assert::IsTrue (std::is_sorted (bin.begin(), bin.end()), std::format (L"Tile {} out of order", tile).c_str());
+                    Assert::IsTrue (std::adjacent_find (bin.begin(), bin.end()) == bin.end(), std::format (L"Tile {} has a duplicate", tile).c_str());
+                }
+            }
+
+
+
+
+            TEST_METHOD (EveryThreadCount_MatchesSerialBitExact)
+            {
+                SoftwareGlyphAtlas     atlas;
+                std::vector<GlyphQuad> quads = MakeOverlappingQuads (4321, 3000, 300.0f, 200.0f);
+
+                atlas.BuildProcedural();
+
+                for (GlyphBlendMode mode : { GlyphBlendMode::Alpha, GlyphBlendMode::Premultiplied, GlyphBlendMode::Additive })
+                {
+                    GlyphBlitter    blitter;
+                    SoftwareSurface expected;
+
+                    expected.Resize (300, 200);
+                    expected.Clear  (SoftwareSurface::s_kOpaqueBlack);
+
+                    for (const GlyphQuad & quad : quads)
+                    {
+                        blitter.Blit (expected, atlas, quad, mode);
+                    }
+
+                    for (UINT threads = 1; threads <= 8; threads++)
+                    {
+                        WorkerPool      pool (threads);
+                        TileRasterizer  rasterizer;
+                        SoftwareSurface actual;
+
+                        actual.Resize (300, 200);
+
+                        // Two frames through the same pool: workers must pick up the second
+                        for (int frame = 0; frame < 2; frame++)
+                        {
+                            actual.Clear (SoftwareSurface::s_kOpaqueBlack);
+                            rasterizer.Rasterize (pool, actual, atlas, quads, mode);
+                        }
+
+                        Assert::IsTrue (std::equal (expected.Pixels().begin(), expected.Pixels().end(), actual.Pixels().begin()),
+                                        std::format (L"{} threads, blend mode {}: tiled frame differs from serial", threads, static_cast<int> (mode)).c_str());
+                    }
+                }
+            }
+
+
+
+
+            TEST_METHOD (RenderSystem_TiledFrame_MatchesSerialFrame)
+            {
+                Viewport             viewport;
+                viewport.Resize (640.0f, 360.0f);
+                DensityController    densityController (viewport, 24.0f);
+                AnimationSystem      animationSystem;
+                SoftwareRenderSystem serial (640, 360);
+                SoftwareRenderSystem tiled  (640, 360);
+                RenderParams         params;
+
+                densityController.SetPercentage (100);
+                animationSystem.Initialize (viewport, densityController);
+                serial.BuildGlyphAtlas();
+                tiled.BuildGlyphAtlas();
+                tiled.SetRasterThreadCount (4);
+
+                Assert::AreEqual (1u, serial.GetRasterThreadCount());
+                Assert::AreEqual (4u, tiled.GetRasterThreadCount());
+
+                for (int frame = 0; frame < 120; frame++)
+                {
+                    animationSystem.Update (1.0f / 60.0f);
+                }
+
+                serial.Render (animationSystem, viewport, params);
+                tiled.Render  (animationSystem, viewport, params);
+
+                Assert::IsTrue (serial.GetQuads().size() > 0);
+                Assert::IsTrue (std::equal (serial.GetSceneSurface().Pixels().begin(), serial.GetSceneSurface().Pixels().end(), tiled.GetSceneSurface().Pixels().begin()));
+                Assert::IsTrue (std::equal (serial.GetBackSurface().Pixels().begin(),  serial.GetBackSurface().Pixels().end(),  tiled.GetBackSurface().Pixels().begin()));
+
+                tiled.SetRasterThreadCount (1);
+
+                Assert::AreEqual (1u, tiled.GetRasterThreadCount());
+            }
+
+
+
+
+            TEST_METHOD (Benchmark_CoreScaling4K)
+            {
+                // Rasterizes a warmed-up 4K rain frame at 100% density with
+                // 1..N threads (N = hardware threads, at least 4) and reports
+                // ms/frame and speedup over the serial blitter.
+                constexpr UINT kWidth   = 3840;
+                constexpr UINT kHeight  = 2160;
+                constexpr int  kRepeats = 5;
+
+                Viewport             viewport;
+                viewport.Resize (static_cast<float> (kWidth), static_cast<float> (kHeight));
+                DensityController    densityController (viewport, 24.0f);
+                AnimationSystem      animationSystem;
+                SoftwareRenderSystem renderSystem (kWidth, kHeight);
+                RenderParams         params;
+                SoftwareSurface      surface;
+                GlyphBlitter         blitter;
+                UINT                 maxThreads = std::max (4u, std::thread::hardware_concurrency());
+
+                densityController.SetPercentage (100);
+                animationSystem.Initialize (viewport, densityController);
+                renderSystem.BuildGlyphAtlas();
+
+                for (int frame = 0; frame < 180; frame++)
+                {
+                    animationSystem.Update (1.0f / 60.0f);
+                }
+
+                renderSystem.Render (animationSystem, viewport, params);
+                surface.Resize (kWidth, kHeight);
+
+                std::vector<GlyphQuad>     quads (renderSystem.GetQuads().begin(), renderSystem.GetQuads().end());
+                const SoftwareGlyphAtlas & atlas = renderSystem.GetGlyphAtlas();
+
+                auto measure = [&] (auto && rasterizeFrame)
+                {
+                    auto start = std::chrono::steady_clock::now();
+
+                    for (int i = 0; i < kRepeats; i++)
+                    {
+                        surface.Clear (SoftwareSurface::s_kOpaqueBlack);
+                        rasterizeFrame();
+                    }
+
+                    return std::chrono::duration<double, std::milli> (std::chrono::steady_clock::now() - start).count() / kRepeats;
+                };
+
+                double serialMs = measure ([&] { for (const GlyphQuad & q : quads) blitter.Blit (surface, atlas, q, GlyphBlendMode::Alpha); });
+
+                Logger::WriteMessage (std::format ("TileRasterizer 4K ({} glyphs/frame, {} hardware threads): serial {:.2f} ms/frame\n",
+                                                   quads.size(),
+                                                   std::thread::hardware_concurrency(),
+                                                   serialMs).c_str());
+
+                for (UINT threads = 1; threads <= maxThreads; threads++)
+                {
+                    WorkerPool     pool (threads);
+                    TileRasterizer rasterizer;
+                    double         tiledMs = measure ([&] { rasterizer.Rasterize (pool, surface, atlas, quads, GlyphBlendMode::Alpha); });
+
+                    Logger::WriteMessage (std::format ("TileRasterizer 4K: {} threads {:.2f} ms/frame ({:.2f}x serial, {:.2f} tile refs/glyph)\n",
+                                                       threads,
+                                                       tiledMs,
+                                                       serialMs / tiledMs,
+                                                       double (rasterizer.GetBinner().GetBinnedCount()) / double (quads.size())).c_str());
+                }
+
+                Assert::IsTrue (quads.size() > 0);
+            }
+    };
+}
@@ -161,7 +161,7 @@ namespace MatrixRainTests
             double elapsed = timer.GetElapsedMilliseconds();
 
             // Should be able to measure time
-            // (QueryPerformanceCounter should provide high precision)
+            // (Timestamp should provide high precision)
             Assert::IsTrue (elapsed > 0.0);
             Assert::IsTrue (elapsed < 50.0); // Should be less than 50ms (generous for Windows scheduling)
         }
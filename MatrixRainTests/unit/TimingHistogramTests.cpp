@@ -0,0 +1,137 @@
+#include "Pch_MatrixRainTests.h"
+
+#include "..\..\MatrixRainCore\TimingHistogram.h"
+
+
+
+
+namespace MatrixRainTests
+{
+    TEST_CLASS (TimingHistogramTests)
+    {
+        public:
+            TEST_METHOD (BucketIndex_BelowLinearLimit_IsExact)
+            {
+                for (int64_t value = 0; value < TimingHistogram::s_kLinearLimit; value++)
+                {
+                    size_t index = TimingHistogram::BucketIndex (value);
+
+                    Assert::AreEqual (size_t (value), index);
+                    Assert::AreEqual (value,          TimingHistogram::BucketLowerBound (index));
+                    Assert::AreEqual (value,          TimingHistogram::BucketUpperBound (index));
+                }
+            }
+
+
+
+
+            TEST_METHOD (Buckets_AreContiguousAndWithinOneSubBucket)
+            {
+                // Each bucket starts one past the previous bucket's end, and
+                // no bucket is wider than 1/32 of its lower bound
+                for (size_t index = 1; index < TimingHistogram::s_kBucketCount; index++)
+                {
+                    int64_t lower = TimingHistogram::BucketLowerBound (index);
+                    int64_t upper = TimingHistogram::BucketUpperBound (index);
+
+                    Assert::AreEqual (TimingHistogram::BucketUpperBound (index - 1) + 1, lower);
+                    Assert::IsTrue   (upper >= lower);
+                    Assert::IsTrue   ((upper - lower + 1) * TimingHistogram::s_kSubBucketCount <= std::max<int64_t> (lower, TimingHistogram::s_kSubBucketCount));
+                    Assert::AreEqual (index, TimingHistogram::BucketIndex (lower));
+                    Assert::AreEqual (index, TimingHistogram::BucketIndex (upper));
+                }
+            }
+
+
+
+
+            TEST_METHOD (BucketIndex_ClampsOutOfRangeValues)
+            {
+                size_t last = TimingHistogram::s_kBucketCount - 1;
+
+                Assert::AreEqual (size_t (0), TimingHistogram::BucketIndex (-5));
+                Assert::AreEqual (last,       TimingHistogram::BucketIndex (TimingHistogram::BucketUpperBound (last) + 1));
+                Assert::AreEqual (last,       TimingHistogram::BucketIndex (INT64_MAX));
+            }
+
+
+
+
+            TEST_METHOD (Percentiles_MatchNearestRankWithinOneSubBucket)
+            {
+                TimingHistogram histogram;
+
+                // 1..10000 us: the p-th percentile is p * 100
+                for (int64_t value = 1; value <= 10000; value++)
+                {
+                    histogram.Record (value);
+                }
+
+                for (double percentile : { 1.0, 50.0, 95.0, 99.0, 99.9 })
+                {
+                    int64_t exact    = static_cast<int64_t> (ceil (percentile * 100.0));
+                    int64_t reported = histogram.GetPercentile (percentile);
+
+                    Assert::IsTrue (reported >= exact);
+                    Assert::IsTrue (reported <= exact + exact / 32 + 1);
+                }
+
+                Assert::AreEqual (uint64_t (10000), histogram.GetCount());
+                Assert::AreEqual (int64_t (1),      histogram.GetMin());
+                Assert::AreEqual (int64_t (10000),  histogram.GetMax());
+                Assert::AreEqual (int64_t (10000),  histogram.GetPercentile (100.0));
+                Assert::AreEqual (5000.5,           histogram.GetMean(), 1e-9);
+            }
+
+
+
+
+            TEST_METHOD (Merge_EqualsRecordingEverythingInOne)
+            {
+                TimingHistogram first;
+                TimingHistogram second;
+                TimingHistogram combined;
+
+                for (int64_t value = 0; value < 5000; value += 7)
+                {
+                    first   .Record (value);
+                    combined.Record (value);
+                }
+
+                for (int64_t value = 3; value < 90000; value += 131)
+                {
+                    second  .Record (value);
+                    combined.Record (value);
+                }
+
+                first.Merge (second);
+
+                Assert::AreEqual (combined.GetCount(), first.GetCount());
+                Assert::AreEqual (combined.GetMin(),   first.GetMin());
+                Assert::AreEqual (combined.GetMax(),   first.GetMax());
+                Assert::AreEqual (combined.GetMean(),  first.GetMean(), 1e-9);
+
+                for (size_t index = 0; index < TimingHistogram::s_kBucketCount; index++)
+                {
+                    Assert::AreEqual (combined.GetBucketCount (index), first.GetBucketCount (index));
+                }
+            }
+
+
+
+
+            TEST_METHOD (Empty_ReportsZeros)
+            {
+                TimingHistogram histogram;
+
+                histogram.Record (250);
+                histogram.Reset();
+
+                Assert::AreEqual (uint64_t (0), histogram.GetCount());
+                Assert::AreEqual (int64_t (0),  histogram.GetMin());
+                Assert::AreEqual (int64_t (0),  histogram.GetMax());
+                Assert::AreEqual (int64_t (0),  histogram.GetPercentile (99.0));
+                Assert::AreEqual (0.0,          histogram.GetMean());
+            }
+    };
+}
@@ -0,0 +1,57 @@
+#include "Pch_MatrixRainTests.h"
+
+#include "..\..\MatrixRainCore\UniformRandom.h"
+
+
+
+
+namespace MatrixRainTests
+{
+    TEST_CLASS (UniformRandomTests)
+    {
+        public:
+
+            TEST_METHOD (Draws_AreTheSameOnEveryStandardLibrary)
+            {
+                // std::mt19937's first output for the default seed is fixed
+                // by the standard (3499211612); both draws are pure
+                // arithmetic on it, so these values hold under any STL
+                std::mt19937 realGenerator;
+                std::mt19937 indexGenerator;
+
+                Assert::AreEqual (13668795.0f / 16777216.0f, UniformReal  (realGenerator, 0.0f, 1.0f));
+                Assert::AreEqual (size_t (8),                UniformIndex (indexGenerator, 0, 9));
+            }
+
+
+
+
+            TEST_METHOD (Draws_StayInRangeAndReachBothEnds)
+            {
+                std::mt19937 generator (42);
+                size_t       counts[6] = {};
+                float        lowest    = 1.0f;
+                float        highest   = -1.0f;
+
+                for (int i = 0; i < 60000; i++)
+                {
+                    size_t index = UniformIndex (generator, 15, 20);
+                    float  value = UniformReal  (generator, -16.0f, 16.0f);
+
+                    Assert::IsTrue (index >= 15 && index <= 20);
+                    Assert::IsTrue (value >= -16.0f && value < 16.0f);
+
+                    counts[index - 15]++;
+                    lowest  = std::min (lowest,  value);
+                    highest = std::max (highest, value);
+                }
+
+                for (size_t count : counts)
+                {
+                    Assert::IsTrue (count > 9000 && count < 11000, L"Each of six values should come up about 10000 times");
+                }
+
+                Assert::IsTrue (lowest < -15.9f && highest > 15.9f);
+            }
+    };
+}
@@ -0,0 +1,389 @@
+#include "Pch_MatrixRainTests.h"
+
+#include "..\..\MatrixRainCore\AnimationSystem.h"
+#include "..\..\MatrixRainCore\CharacterSet.h"
+#include "..\..\MatrixRainCore\InstanceStore.h"
+#include "..\..\MatrixRainCore\RainMetrics.h"
+#include "..\..\MatrixRainCore\VirtualDesktopSimulation.h"
+
+
+
+
+namespace MatrixRainTests
+{
+    using namespace std::chrono;
+
+
+    static constexpr float s_kFrameSeconds = 1.0f / 60.0f;
+
+
+
+
+    static MonitorPlacement MakePlacement (LONG x, LONG y, LONG width, LONG height, bool isPrimary = false)
+    {
+        MonitorPlacement placement;
+
+        placement.position  = { x, y };
+        placement.size      = { width, height };
+        placement.isPrimary = isPrimary;
+
+        return placement;
+    }
+
+
+
+
+    // `columns` x `rows` 1920x1080 monitors, edge to edge
+    static std::vector<MonitorPlacement> MakeGrid (int columns, int rows)
+    {
+        std::vector<MonitorPlacement> placements;
+
+        for (int row = 0; row < rows; row++)
+        {
+            for (int column = 0; column < columns; column++)
+            {
+                placements.push_back (MakePlacement (column * 1920, row * 1080, 1920, 1080, placements.empty()));
+            }
+        }
+
+        return placements;
+    }
+
+
+
+
+    static size_t CountCharacters (const std::vector<CharacterStreak> & streaks)
+    {
+        size_t count = 0;
+
+        for (const CharacterStreak & streak : streaks)
+        {
+            count += streak.GetCharacterCount();
+        }
+
+        return count;
+    }
+
+
+
+
+    // Characters of `streaks` whose quad overlaps `region`
+    static size_t CountCharactersInRegion (const std::vector<CharacterStreak> & streaks, const RainRegion & region, float characterScale)
+    {
+        float  charWidth  = s_kRainCharWidth  * characterScale;
+        float  charHeight = s_kRainCharHeight * characterScale;
+        size_t count      = 0;
+
+        for (const CharacterStreak & streak : streaks)
+        {
+            float x = streak.GetPosition().x;
+
+            if (x + charWidth <= region.left || x >= region.left + region.width)
+            {
+                continue;
+            }
+
+            for (const CharacterInstance & character : streak.GetCharacters())
+            {
+                float y = character.positionOffset.y;
+
+                if (y + charHeight > region.top && y < region.top + region.height)
+                {
+                    count++;
+                }
+            }
+        }
+
+        return count;
+    }
+
+
+
+
+    struct SimulationCost
+    {
+        double charactersPerMegapixel = 0.0;
+        double stepUsPerMegapixel     = 0.0;
+    };
+
+
+    // Runs a seeded shared simulation over `placements` for 10 s to fill
+    // the desktop, then averages characters alive and Step time per
+    // megapixel of the union over the next 10 s
+    static SimulationCost MeasureSimulationCost (const std::vector<MonitorPlacement> & placements)
+    {
+        VirtualDesktopLayout     layout     = PlanVirtualDesktop (placements);
+        VirtualDesktopSimulation simulation (layout, 1.0f);
+        double                   megapixels = static_cast<double> (layout.size.cx) * layout.size.cy / 1e6;
+        size_t                   characters = 0;
+        int64_t                  stepUs     = 0;
+        const int                frames     = 600;
+
+        simulation.Animation().Seed (47);
+        simulation.Initialize();
+
+        for (int frame = 0; frame < frames; frame++)
+        {
+            simulation.Step (s_kFrameSeconds, 50, 100);
+        }
+
+        for (int frame = 0; frame < frames; frame++)
+        {
+            auto start = steady_clock::now();
+
+            simulation.Step (s_kFrameSeconds, 50, 100);
+
+            stepUs     += duration_cast<microseconds> (steady_clock::now() - start).count();
+            characters += CountCharacters (simulation.GetLatestFrame()->streaks);
+        }
+
+        return SimulationCost
+        {
+            .charactersPerMegapixel = static_cast<double> (characters) / frames / megapixels,
+            .stepUsPerMegapixel     = static_cast<double> (stepUs)     / frames / megapixels,
+        };
+    }
+
+
+
+
+    TEST_CLASS (VirtualDesktopSimulationTests)
+    {
+    public:
+        TEST_CLASS_INITIALIZE (ClassSetup)
+        {
+            CharacterSet::GetInstance().Initialize();
+        }
+
+
+
+
+        TEST_METHOD (SimulationCostPerPixel_IsConstantAcrossMonitorCounts)
+        {
+            // Adding monitors beside the existing ones must not change the
+            // work per pixel.  Stacking them does change the rain itself
+            // (streaks run on through the bezel, so trails are longer on
+            // average), so each row count is compared with one column of
+            // the same height.
+            for (int rows = 1; rows <= 2; rows++)
+            {
+                SimulationCost single = MeasureSimulationCost (MakeGrid (1, rows));
+
+                for (int columns = 1; columns <= 4; columns++)
+                {
+                    SimulationCost cost  = MeasureSimulationCost (MakeGrid (columns, rows));
+                    double         ratio = cost.charactersPerMegapixel / single.charactersPerMegapixel;
+
+                    Logger::WriteMessage (std::format ("{}x{} monitors: {:.0f} characters/MP ({:.2f}x one column), Step {:.1f} us/MP\n",
+                                                       columns, rows, cost.charactersPerMegapixel, ratio, cost.stepUsPerMegapixel).c_str());
+
+                    Assert::IsTrue (ratio > 0.9 && ratio < 1.1, L"Simulated characters per pixel stay within 10% of one column's");
+                }
+            }
+        }
+
+
+
+
+        TEST_METHOD (CullToRegion_EachMonitorReceivesOnlyInstancesInItsRegion)
+        {
+            // A 1080p primary, a taller 1440p monitor to its right and a
+            // 1080p monitor below the primary: the union has a dead corner
+            std::vector<MonitorPlacement> placements =
+            {
+                MakePlacement (0,    0,    1920, 1080, true),
+                MakePlacement (1920, 0,    2560, 1440),
+                MakePlacement (0,    1080, 1920, 1080),
+            };
+
+            VirtualDesktopLayout     layout = PlanVirtualDesktop (placements);
+            VirtualDesktopSimulation simulation (layout, 1.0f);
+            float                    scale  = simulation.GetCharacterScale();
+            float                    width  = s_kRainCharWidth  * scale;
+            float                    height = s_kRainCharHeight * scale;
+
+            simulation.Animation().Seed (1047);
+            simulation.Initialize();
+
+            for (int frame = 0; frame < 300; frame++)
+            {
+                simulation.Step (s_kFrameSeconds, 80, 100);
+            }
+
+            std::shared_ptr<const RainFrame> frame = simulation.GetLatestFrame();
+
+            for (const RainRegion & region : layout.regions)
+            {
+                std::vector<CharacterStreak> culled;
+                AnimationSystem              monitorAnimation;
+                InstanceStore                store;
+
+                VirtualDesktopSimulation::CullToRegion (*frame, region, scale, culled);
+
+                size_t expected = CountCharactersInRegion (frame->streaks, region, scale);
+
+                Assert::IsTrue   (expected > 0, L"The region has rain in it");
+                Assert::AreEqual (expected, CountCharacters (culled), L"Every character overlapping the region is handed over");
+
+                monitorAnimation.SwapStreaks (culled);
+                store.Update (monitorAnimation);
+
+                Assert::AreEqual (expected, store.GetStream().size());
+
+                for (const RainInstanceStream & instance : store.GetStream())
+                {
+                    const RainInstanceStatic & record = store.GetSlots()[instance.slot];
+
+                    Assert::IsTrue (record.position[0] + width  > 0.0f && record.position[0] < region.width,  L"Instance overlaps the monitor horizontally");
+                    Assert::IsTrue (record.position[1] + height > 0.0f && record.position[1] < region.height, L"Instance overlaps the monitor vertically");
+                }
+            }
+        }
+
+
+
+
+        TEST_METHOD (CullToRegion_StreakCrossingBezelIsSplitBetweenStackedMonitors)
+        {
+            VirtualDesktopLayout     layout = PlanVirtualDesktop (MakeGrid (1, 2));
+            VirtualDesktopSimulation simulation (layout, 1.0f);
+            std::vector<CharacterStreak> upper;
+            std::vector<CharacterStreak> lower;
+            int                      splitStreaks = 0;
+
+            simulation.Animation().Seed (2047);
+            simulation.Initialize();
+
+            for (int frame = 0; frame < 300; frame++)
+            {
+                simulation.Step (s_kFrameSeconds, 50, 100);
+            }
+
+            std::shared_ptr<const RainFrame> frame = simulation.GetLatestFrame();
+
+            VirtualDesktopSimulation::CullToRegion (*frame, layout.regions[0], simulation.GetCharacterScale(), upper);
+            VirtualDesktopSimulation::CullToRegion (*frame, layout.regions[1], simulation.GetCharacterScale(), lower);
+
+            for (const CharacterStreak & streak : frame->streaks)
+            {
+                auto top    = std::find_if (upper.begin(), upper.end(), [&] (const CharacterStreak & s) { return s.GetID() == streak.GetID(); });
+                auto bottom = std::find_if (lower.begin(), lower.end(), [&] (const CharacterStreak & s) { return s.GetID() == streak.GetID(); });
+
+                if (top == upper.end() || bottom == lower.end())
+                {
+                    continue;
+                }
+
+                const CharacterInstance & lastAbove  = top->GetCharacters().back();
+                const CharacterInstance & firstBelow = bottom->GetCharacters().front();
+
+                splitStreaks++;
+
+                // Both halves keep the streak's column and continue each
+                // other across the bezel, in each monitor's coordinates
+                Assert::AreEqual (streak.GetPosition().x, top->GetPosition().x);
+                Assert::AreEqual (streak.GetPosition().x, bottom->GetPosition().x);
+                Assert::IsTrue   (firstBelow.sequence <= lastAbove.sequence + 1, L"No character is lost at the bezel");
+                Assert::IsTrue   (lastAbove.positionOffset.y  > 1080.0f - s_kRainCharHeight * simulation.GetCharacterScale() - 1.0f);
+                Assert::IsTrue   (firstBelow.positionOffset.y < 1.0f);
+            }
+
+            Logger::WriteMessage (std::format ("{} of {} streaks cross the bezel\n", splitStreaks, frame->streaks.size()).c_str());
+
+            Assert::IsTrue (splitStreaks > 0, L"Some streak falls from the upper monitor into the lower one");
+        }
+
+
+
+
+        TEST_METHOD (Publish_HeldFrameIsNeverOverwritten)
+        {
+            VirtualDesktopSimulation simulation (PlanVirtualDesktop (MakeGrid (2, 1)), 1.0f);
+
+            simulation.Animation().Seed (3047);
+            simulation.Initialize();
+
+            std::shared_ptr<const RainFrame> held       = simulation.GetLatestFrame();
+            uint64_t                         sequence   = held->sequence;
+            size_t                           characters = CountCharacters (held->streaks);
+            const RainFrame                * previous   = nullptr;
+            const RainFrame                * recycled   = nullptr;
+
+            for (int frame = 0; frame < 10; frame++)
+            {
+                simulation.Step (s_kFrameSeconds, 50, 100);
+
+                const RainFrame * latest = simulation.GetLatestFrame().get();
+
+                Assert::IsTrue (latest != held.get(), L"A frame a reader holds is not reused");
+
+                recycled = (latest == previous) ? latest : recycled;
+                previous = latest;
+            }
+
+            Assert::AreEqual (sequence,   held->sequence);
+            Assert::AreEqual (characters, CountCharacters (held->streaks));
+            Assert::AreEqual (uint64_t (11), simulation.GetLatestFrame()->sequence);
+            Assert::IsNull   (recycled, L"The latest frame is never overwritten in place");
+        }
+
+
+
+
+        TEST_METHOD (Publish_ConcurrentReadersSeeCompleteFrames)
+        {
+            VirtualDesktopLayout     layout = PlanVirtualDesktop (MakeGrid (3, 1));
+            VirtualDesktopSimulation simulation (layout, 1.0f);
+            std::atomic<bool>        done   { false };
+            std::atomic<int>         torn   { 0 };
+            std::vector<std::thread> readers;
+
+            simulation.Animation().Seed (4047);
+            simulation.Initialize();
+
+            // Each reader culls its monitor out of whatever frame is newest,
+            // as the render threads do, and checks the frame did not change
+            // underneath it
+            for (const RainRegion & region : layout.regions)
+            {
+                readers.emplace_back ([&, region]
+                {
+                    std::vector<CharacterStreak> culled;
+                    uint64_t                     lastSequence = 0;
+
+                    while (!done)
+                    {
+                        std::shared_ptr<const RainFrame> frame      = simulation.GetLatestFrame();
+                        uint64_t                         sequence   = frame->sequence;
+                        size_t                           characters = CountCharacters (frame->streaks);
+
+                        VirtualDesktopSimulation::CullToRegion (*frame, region, simulation.GetCharacterScale(), culled);
+
+                        if (frame->sequence != sequence || CountCharacters (frame->streaks) != characters || sequence < lastSequence)
+                        {
+                            torn++;
+                        }
+
+                        lastSequence = sequence;
+                    }
+                });
+            }
+
+            for (int frame = 0; frame < 600; frame++)
+            {
+                simulation.Step (s_kFrameSeconds, 50, 100);
+            }
+
+            done = true;
+
+            for (std::thread & reader : readers)
+            {
+                reader.join();
+            }
+
+            Assert::AreEqual (0, torn.load());
+        }
+    };
+
+
+}